@@ -70,7 +70,9 @@ constexpr const char* SpoutTag = "Spout";
 constexpr const char* OpenVRTag = "OpenVR";
 
 sgct::Engine* SgctEngine;
-sgct::SharedVector<char> _synchronizationBuffer;
+sgct::SharedUInt32 _synchronizationSize;
+// Only used on the slaves, retains its capacity between frames
+std::vector<char> _synchronizationBuffer;
 
 #ifdef OPENVR_SUPPORT
 sgct::SGCTWindow* FirstOpenVRWindow = nullptr;
@@ -585,9 +587,14 @@ void mainCharCallback(unsigned int codepoint, int mods) {
 
 void mainEncodeFun() {
     LTRACE("main::mainEncodeFun(begin)");
-    std::vector<char> data = openspace::global::openSpaceEngine.encode();
-    _synchronizationBuffer.setVal(std::move(data));
-    sgct::SharedData::instance()->writeVector(&_synchronizationBuffer);
+    // Hand the frame to SGCT straight from the SyncEngine's buffer without copying it
+    const std::vector<char>& data = openspace::global::openSpaceEngine.encode();
+    _synchronizationSize.setVal(static_cast<uint32_t>(data.size()));
+    sgct::SharedData::instance()->writeUInt32(&_synchronizationSize);
+    sgct::SharedData::instance()->writeUCharArray(
+        reinterpret_cast<unsigned char*>(const_cast<char*>(data.data())),
+        data.size()
+    );
     LTRACE("main::mainEncodeFun(end)");
 }
 
@@ -595,9 +602,13 @@ void mainEncodeFun() {
 
 void mainDecodeFun() {
     LTRACE("main::mainDecodeFun(begin)");
-    sgct::SharedData::instance()->readVector(&_synchronizationBuffer);
-    std::vector<char> data = _synchronizationBuffer.getVal();
-    openspace::global::openSpaceEngine.decode(std::move(data));
+    sgct::SharedData::instance()->readUInt32(&_synchronizationSize);
+    _synchronizationBuffer.resize(_synchronizationSize.getVal());
+    sgct::SharedData::instance()->readUCharArray(
+        reinterpret_cast<unsigned char*>(_synchronizationBuffer.data()),
+        _synchronizationBuffer.size()
+    );
+    openspace::global::openSpaceEngine.decode(_synchronizationBuffer);
     LTRACE("main::mainDecodeFun(end)");
 }
 
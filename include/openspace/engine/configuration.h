@@ -66,6 +66,7 @@ struct Configuration {
     DocumentationInfo documentation;
 
     bool useMultithreadedInitialization = false;
+    std::string startupTrace = "";
 
     struct LoadingScreen {
         bool isShowingMessages = true;
@@ -92,6 +93,8 @@ struct Configuration {
 
     std::string renderingMethod = "Framebuffer";
 
+    std::string syncProtocol = "Full";
+
     struct OpenGLDebugContext {
         bool isActive = false;
         bool isSynchronous = true;
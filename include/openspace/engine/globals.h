@@ -44,9 +44,11 @@ class ParallelPeer;
 class RaycasterManager;
 class RenderEngine;
 class ScreenSpaceRenderable;
+class StartupTrace;
 class SyncEngine;
 class TimeManager;
 class VirtualPropertyManager;
+class WorkStealingThreadPool;
 struct WindowDelegate;
 namespace configuration { struct Configuration; }
 namespace interaction {
@@ -79,10 +81,12 @@ ParallelPeer& gParallelPeer();
 RaycasterManager& gRaycasterManager();
 RenderEngine& gRenderEngine();
 std::vector<std::unique_ptr<ScreenSpaceRenderable>>& gScreenspaceRenderables();
+StartupTrace& gStartupTrace();
 SyncEngine& gSyncEngine();
 TimeManager& gTimeManager();
 VirtualPropertyManager& gVirtualPropertyManager();
 WindowDelegate& gWindowDelegate();
+WorkStealingThreadPool& gThreadPool();
 configuration::Configuration& gConfiguration();
 interaction::JoystickInputStates& gJoystickInputStates();
 interaction::KeybindingManager& gKeybindingManager();
@@ -110,10 +114,12 @@ static RaycasterManager& raycasterManager = detail::gRaycasterManager();
 static RenderEngine& renderEngine = detail::gRenderEngine();
 static std::vector<std::unique_ptr<ScreenSpaceRenderable>>& screenSpaceRenderables =
     detail::gScreenspaceRenderables();
+static StartupTrace& startupTrace = detail::gStartupTrace();
 static SyncEngine& syncEngine = detail::gSyncEngine();
 static TimeManager& timeManager = detail::gTimeManager();
 static VirtualPropertyManager& virtualPropertyManager = detail::gVirtualPropertyManager();
 static WindowDelegate& windowDelegate = detail::gWindowDelegate();
+static WorkStealingThreadPool& threadPool = detail::gThreadPool();
 static configuration::Configuration& configuration = detail::gConfiguration();
 static interaction::JoystickInputStates& joystickInputStates =
     detail::gJoystickInputStates();
@@ -80,8 +80,8 @@ public:
     void mousePositionCallback(double x, double y);
     void mouseScrollWheelCallback(double posX, double posY);
     void externalControlCallback(const char* receivedChars, int size, int clientId);
-    std::vector<char> encode();
-    void decode(std::vector<char> data);
+    const std::vector<char>& encode();
+    void decode(const std::vector<char>& data);
 
     void scheduleLoadSingleAsset(std::string assetPath);
     void toggleShutdownMode();
@@ -38,11 +38,23 @@ class Syncable;
 /**
  * Manages a collection of <code>Syncable</code>s and ensures they are synchronized
  * over SGCT nodes. Encoding/Decoding order is handles internally.
+ *
+ * Each frame starts with a header that describes which Syncables are contained in it.
+ * Depending on the Protocol, either all Syncables are encoded every frame, or only the
+ * ones that report that they have changed since the previous frame. In the latter case
+ * a key frame containing all Syncables is still sent periodically and whenever the set
+ * of Syncables changes.
  */
 class SyncEngine {
 public:
     BooleanType(IsMaster);
 
+    enum class Protocol {
+        Full = 0,       ///< All Syncables are encoded every frame
+        Delta,          ///< Only changed Syncables are encoded
+        DeltaCompressed ///< Only changed Syncables are encoded and the frame is LZ4'ed
+    };
+
     /**
      * Creates a new SyncEngine which a buffer size of \p syncBufferSize
      * \pre syncBufferSize must be bigger than 0
@@ -51,15 +63,29 @@ public:
 
     /**
      * Encodes all added Syncables in the injected <code>SyncBuffer</code>.
-     * This method is only called on the SGCT master node
+     * This method is only called on the SGCT master node. The returned reference stays
+     * valid until the next call to this function.
+     */
+    const std::vector<char>& encodeSyncables();
+
+    /**
+     * Decodes the <code>SyncBuffer</code> into the added Syncables without copying
+     * \p data. This method is only called on the SGCT slave nodes
      */
-    std::vector<char> encodeSyncables();
+    void decodeSyncables(const std::vector<char>& data);
 
     /**
-     * Decodes the <code>SyncBuffer</code> into the added Syncables.
-     * This method is only called on the SGCT slave nodes
+     * Sets the protocol that is used to encode the following frames. Only the master
+     * node's protocol is relevant as each frame describes how it has been encoded.
      */
-    void decodeSyncables(std::vector<char> data);
+    void setProtocol(Protocol protocol);
+
+    /**
+     * Sets the maximum number of frames between two key frames if a delta protocol is
+     * used.
+     * \pre interval must be bigger than 0
+     */
+    void setKeyFrameInterval(unsigned int interval);
 
     /**
      * Invokes the presync method of all added Syncables
@@ -103,6 +129,17 @@ private:
      * Databuffer used in encoding/decoding
      */
     SyncBuffer _syncBuffer;
+
+    /**
+     * Buffer for compressed frames on the master and decompressed frames on the slaves
+     */
+    std::vector<char> _compressionBuffer;
+
+    Protocol _protocol = Protocol::Full;
+    unsigned int _keyFrameInterval = 60;
+    unsigned int _framesSinceKeyFrame = 0;
+    bool _needsKeyFrame = true;
+    bool _hasDecodedKeyFrame = false;
 };
 
 } // namespace openspace
@@ -31,6 +31,7 @@
 #include <openspace/scripting/lualibrary.h>
 #include <ghoul/io/socket/tcpsocket.h>
 
+#include <cstdint>
 #include <vector>
 #include <fstream>
 #include <iomanip>
@@ -109,12 +110,47 @@ public:
     */
     void stopPlayback();
 
+    /**
+    * Moves the playback in progress to \p time, which is interpreted in the time
+    * reference mode of the playback: seconds since the start of the recording,
+    * application time, or simulation time in J2000 seconds. Keyframes between the
+    * current playback position and \p time are skipped. For recordings in the indexed
+    * binary format only the keyframes around \p time are read from disk.
+    * \param time the time to continue the playback from
+    * \returns true if the playback was moved without errors.
+    */
+    bool seekPlayback(double time);
+
+    /**
+    * Converts the recording \p inFilename, which can be in either the ASCII or any
+    * of the binary formats, into the indexed binary format that supports streaming
+    * playback and seeking. Must not be called while recording or playing back.
+    * \param inFilename file containing the recorded keyframes to convert
+    * \param outFilename file that the converted recording is saved to
+    * \returns true if the conversion finished without errors.
+    */
+    bool convertToIndexedFormat(const std::string& inFilename,
+        const std::string& outFilename);
+
     /**
     * Used to check if a session playback is in progress.
     * \returns true if playback is in progress.
     */
     bool isPlayingBack() const;
 
+    /**
+    * Used to check how much of a playback is kept in memory. For recordings in the
+    * indexed binary format this is only a window around the playback position.
+    * \returns the number of keyframes of the playback that are currently in memory.
+    */
+    size_t nKeyframesInMemory() const;
+
+    /**
+    * \returns the timestamp of the next keyframe of the playback in progress that has
+    * not been played back yet, in the time reference mode of the playback.
+    */
+    double nextKeyframeTimestamp() const;
+
     /**
     * Used to trigger a save of the camera states (position, rotation, focus node,
     * whether it is following the rotation of a node, and timestamp). The data will
@@ -158,6 +194,31 @@ private:
         unsigned int idxIntoKeyframeTypeArray;
         double timestamp;
     };
+    // A keyframe as it is stored in a recording file, before it is converted to the
+    // time reference mode of the playback
+    struct RecordedKeyframe {
+        RecordedType type = RecordedType::Invalid;
+        double timeOs = 0.0;
+        double timeRec = 0.0;
+        double timeSim = 0.0;
+        datamessagestructures::CameraKeyframe camera;
+        datamessagestructures::TimeKeyframe time;
+        std::string script;
+    };
+    enum class ReadResult {
+        Keyframe = 0,
+        Skipped,
+        EndOfFile,
+        Error
+    };
+    // Every IndexInterval-th keyframe of an indexed binary recording is listed in the
+    // index footer at the end of the file, together with its position in the file
+    struct IndexEntry {
+        double timeOs;
+        double timeRec;
+        double timeSim;
+        uint64_t fileOffset;
+    };
     ExternInteraction _externInteract;
     bool _isRecording = false;
     double _timestampRecordStarted = 0.0;
@@ -170,9 +231,14 @@ private:
     double equivalentApplicationTime(double timeOs, double timeRec, double timeSim);
     double currentTime() const;
 
-    void playbackCamera();
-    void playbackTimeChange();
-    void playbackScript();
+    bool openPlaybackFile(const std::string& filename);
+    void writeFileHeader();
+    ReadResult readNextKeyframe(RecordedKeyframe& keyframe);
+    bool readCameraKeyframe(RecordedKeyframe& keyframe);
+    bool readTimeKeyframe(RecordedKeyframe& keyframe);
+    bool readScriptKeyframe(RecordedKeyframe& keyframe);
+    void addKeyframeToTimeline(RecordedKeyframe keyframe);
+    void saveKeyframeBinary(const RecordedKeyframe& keyframe);
     bool playbackAddEntriesToTimeline();
     void signalPlaybackFinishedForComponent(RecordedType type);
     void writeToFileBuffer(const double src);
@@ -182,6 +248,14 @@ private:
     void saveStringToFile(const std::string& s);
     void saveKeyframeToFileBinary(unsigned char* bufferSource, size_t size);
     void findFirstCameraKeyframeInTimeline();
+    void addRecordIndexEntry(double timeOs, double timeRec, double timeSim);
+    void writeIndexFooter();
+    bool readIndexFooter();
+    void streamNextBlock();
+    void streamKeyframes();
+    bool hasStreamedAllKeyframes() const;
+    void discardTimelineEntries(unsigned int nEntries);
+    void clearTimeline();
     std::string readHeaderElement(size_t readLen_chars);
     void readFromPlayback(unsigned char& result);
     void readFromPlayback(double& result);
@@ -209,7 +283,7 @@ private:
 
     RecordedType getNextKeyframeType();
     RecordedType getPrevKeyframeType();
-    double getNextTimestamp();
+    double getNextTimestamp() const;
     double getPrevTimestamp();
     void cleanUpPlayback();
 
@@ -217,12 +291,17 @@ private:
     const std::string _fileHeaderTitle = "OpenSpace_record/playback";
     static const size_t _fileHeaderVersionLength = 5;
     const char _fileHeaderVersion[_fileHeaderVersionLength] = { '0', '0', '.', '8', '5' };
+    // Binary recordings with an index footer
+    const char _fileHeaderVersionIndexed[_fileHeaderVersionLength] = {
+        '0', '1', '.', '0', '0'
+    };
     const char dataFormatAsciiTag = 'A';
     const char dataFormatBinaryTag = 'B';
 
     RecordedDataMode _recordingDataMode = RecordedDataMode::Binary;
     SessionState _state = SessionState::Idle;
     std::string _playbackFilename;
+    std::string _playbackFileVersion;
     std::ifstream _playbackFile;
     std::string _playbackLineParsing;
     std::ofstream _recordFile;
@@ -260,6 +339,21 @@ private:
 
     unsigned int _idxTimeline_cameraFirstInTimeline = 0;
     double _cameraFirstInTimeline_timestamp = 0;
+
+    // Index of the binary recording in progress
+    std::vector<IndexEntry> _recordIndex;
+    uint64_t _nRecordedKeyframes = 0;
+
+    // If the playback file is indexed, only a window of keyframes around the current
+    // playback position is kept in the timeline, which is streamed one index block at
+    // a time. _playbackIndexOffset is where the keyframes end and the index starts
+    bool _isStreamingPlayback = false;
+    std::vector<IndexEntry> _playbackIndex;
+    uint64_t _playbackIndexOffset = 0;
+    size_t _nextBlockToStream = 0;
+
+    // Offset that is added to the current time to seek in non-simulation time modes
+    double _playbackSeekOffset = 0.0;
 };
 
 } // namespace openspace
@@ -49,6 +49,12 @@ public:
 
     void storeIndividualPerformanceMeasurement(const std::string& identifier,
         long long microseconds);
+
+    /**
+     * Stores an arbitrary per-frame \p value, such as a number of bytes, alongside the
+     * individual performance measurements.
+     */
+    void storeIndividualValue(const std::string& identifier, float value);
     void storeScenePerformanceMeasurements(
         const std::vector<SceneGraphNode*>& sceneNodes);
 
@@ -64,7 +64,18 @@ public:
     Renderable(const ghoul::Dictionary& dictionary);
     virtual ~Renderable() = default;
 
+    /**
+     * Called on a worker thread if the scene is initialized with multiple threads. All
+     * preparations that do not need an OpenGL context, such as reading and parsing data
+     * files or building geometry, belong here so that they do not block the rendering.
+     */
     virtual void initialize();
+
+    /**
+     * Called on the main thread after #initialize has finished. The OpenGL
+     * initialization of the scene is spread over several frames, so this should only
+     * create the OpenGL objects and upload the data that was prepared in #initialize.
+     */
     virtual void initializeGL();
     virtual void deinitialize();
     virtual void deinitializeGL();
@@ -77,6 +88,14 @@ public:
 
     virtual void render(const RenderData& data, RendererTasks& rendererTask);
     virtual void update(const UpdateData& data);
+
+    /**
+     * Returns whether the #update function issues OpenGL calls or otherwise has to be
+     * executed on the main thread. Renderables that only perform CPU work in their
+     * update can return \c false, which allows the Scene to update them concurrently
+     * with other scene graph nodes.
+     */
+    virtual bool isUpdateGLBound() const;
     virtual SurfacePositionHandle calculateSurfacePositionHandle(
                                                 const glm::dvec3& targetModelSpace) const;
 
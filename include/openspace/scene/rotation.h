@@ -52,6 +52,12 @@ public:
     virtual glm::dmat3 matrix(const UpdateData& time) const = 0;
     void update(const UpdateData& data);
 
+    /**
+     * Returns whether #matrix can be called from a thread other than the main thread
+     * while other Rotation%s are updated concurrently.
+     */
+    virtual bool isThreadSafe() const;
+
     static documentation::Documentation Documentation();
 
 protected:
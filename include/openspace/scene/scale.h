@@ -52,6 +52,12 @@ public:
     virtual double scaleValue(const UpdateData& data) const = 0;
     virtual void update(const UpdateData& data);
 
+    /**
+     * Returns whether #scaleValue can be called from a thread other than the main thread
+     * while other Scale%s are updated concurrently.
+     */
+    virtual bool isThreadSafe() const;
+
     static documentation::Documentation Documentation();
 
 protected:
@@ -27,10 +27,15 @@
 
 #include <openspace/properties/propertyowner.h>
 
+#include <openspace/properties/scalar/boolproperty.h>
+#include <openspace/properties/scalar/floatproperty.h>
 #include <openspace/scene/scenegraphnode.h>
 #include <openspace/scene/scenelicense.h>
 #include <ghoul/misc/easing.h>
 #include <ghoul/misc/exception.h>
+#include <atomic>
+#include <deque>
+#include <memory>
 #include <mutex>
 #include <set>
 #include <unordered_map>
@@ -45,6 +50,7 @@ namespace documentation { struct Documentation; }
 namespace scripting { struct LuaLibrary; }
 
 class SceneInitializer;
+class WorkStealingThreadPool;
 
 // Notifications:
 // SceneGraphFinishedLoading
@@ -99,7 +105,12 @@ public:
     Camera* camera() const;
 
     /**
-     * Updates all SceneGraphNodes relative positions
+     * Initializes pending nodes for OpenGL within the budget of a frame (see
+     * #initializeGLPendingNodes) and updates all SceneGraphNodes relative positions. If
+     * the ParallelUpdate property is enabled, independent nodes are updated concurrently
+     * on a thread pool, while nodes whose transformations or renderables are not
+     * thread-safe are updated on the calling thread. In both cases a node is only updated
+     * after its parent and all of its dependencies.
      */
     void update(const UpdateData& data);
 
@@ -174,6 +185,22 @@ public:
      */
     bool isInitializing() const;
 
+    /**
+     * Calls SceneGraphNode::initializeGL for the nodes that have finished their
+     * initialization, in the order in which they finished, until the time set by the
+     * InitializeGLBudget property has passed. At least one node is initialized in every
+     * call, so that a single slow node cannot stall the initialization. A node is not
+     * rendered before its OpenGL initialization has finished.
+     */
+    void initializeGLPendingNodes();
+
+    /**
+     * Returns true if there are nodes that have finished their initialization but have
+     * not been initialized for OpenGL yet. Nodes that have finished their initialization
+     * since the last call to #initializeGLPendingNodes are not included.
+     */
+    bool hasPendingGLNodes() const;
+
     /**
      * Adds an interpolation request for the passed \p prop that will run for
      * \p durationSeconds seconds. Every time the #updateInterpolations method is called
@@ -251,6 +278,36 @@ private:
 
     void sortTopologically();
 
+    /**
+     * Builds the task graph used by #updateParallel from the topologically sorted nodes.
+     */
+    void buildUpdateGraph();
+
+    void updateSerial(const UpdateData& data);
+    void updateParallel(const UpdateData& data);
+
+    /**
+     * The task graph that is derived from the scene graph. Each node can be updated as
+     * soon as the transformations of its parent and the full update of each of its
+     * dependencies have finished
+     */
+    struct UpdateGraph {
+        std::vector<SceneGraphNode*> nodes;
+        /// Indices of the nodes that are released when the transformation of a node has
+        /// been updated
+        std::vector<std::vector<size_t>> children;
+        /// Indices of the nodes that are released when a node is fully updated
+        std::vector<std::vector<size_t>> dependents;
+        std::vector<int> inDegree;
+        std::unique_ptr<std::atomic<int>[]> remainingInDegree;
+    };
+    UpdateGraph _updateGraph;
+    std::unique_ptr<WorkStealingThreadPool> _updateThreadPool;
+
+    properties::BoolProperty _parallelUpdate;
+    properties::FloatProperty _parallelUpdateEfficiency;
+    properties::FloatProperty _initializeGLBudget;
+
     std::unique_ptr<Camera> _camera;
     std::vector<SceneGraphNode*> _topologicallySortedNodes;
     std::vector<SceneGraphNode*> _circularNodes;
@@ -258,6 +315,8 @@ private:
     bool _dirtyNodeRegistry = false;
     SceneGraphNode _rootDummy;
     std::unique_ptr<SceneInitializer> _initializer;
+    // Nodes that have finished their initialization and wait for their initializeGL
+    std::deque<SceneGraphNode*> _pendingGLNodes;
 
     std::vector<InterestingTime> _interestingTimes;
 
@@ -95,6 +95,27 @@ public:
     void traversePreOrder(const std::function<void(SceneGraphNode*)>& fn);
     void traversePostOrder(const std::function<void(SceneGraphNode*)>& fn);
     void update(const UpdateData& data);
+
+    /**
+     * Updates the Translation, Rotation, and Scale of this node and computes the cached
+     * world transformation. The world transformation of the parent must already have
+     * been updated. Returns \c false if the node is not initialized or is outside of its
+     * time frame, in which case #updateRenderable must not be called.
+     */
+    bool updateTransforms(const UpdateData& data);
+
+    /**
+     * Updates the Renderable of this node using the world transformation computed in the
+     * last call to #updateTransforms.
+     */
+    void updateRenderable(const UpdateData& data);
+
+    /// Returns whether #updateTransforms can be called from a worker thread
+    bool isTransformUpdateThreadSafe() const;
+
+    /// Returns whether #updateRenderable can be called from a worker thread
+    bool isRenderableUpdateThreadSafe() const;
+
     void render(const RenderData& data, RendererTasks& tasks);
 
     void attachChild(std::unique_ptr<SceneGraphNode> child);
@@ -146,9 +167,14 @@ public:
     static documentation::Documentation Documentation();
 
 private:
-    glm::dvec3 calculateWorldPosition() const;
-    glm::dmat3 calculateWorldRotation() const;
-    double calculateWorldScale() const;
+    /**
+     * Computes the cached world transformation from the local transformation of this
+     * node and the cached world transformation of the parent, which therefore has to be
+     * updated first. If neither the local transformation nor the parent's world
+     * transformation have changed since the last call, the cached values are kept.
+     * \return \c true if the world transformation has changed
+     */
+    bool updateWorldTransform();
 
     std::atomic<State> _state = State::Loaded;
     std::vector<std::unique_ptr<SceneGraphNode>> _children;
@@ -182,6 +208,18 @@ private:
     glm::dmat3 _worldRotationCached;
     double _worldScaleCached = 1.0;
 
+    // The local transformation from which the cached world transformation was computed
+    glm::dvec3 _localPositionCached;
+    glm::dmat3 _localRotationCached;
+    double _localScaleCached = 1.0;
+
+    // Incremented every time the world transformation of this node changes. Children
+    // compare this against the value they last saw to find out whether they have to
+    // recompute their own world transformation
+    unsigned long long _worldTransformVersion = 0;
+    unsigned long long _parentWorldTransformVersion = 0;
+    bool _isWorldTransformDirty = true;
+
     float _fixedBoundingSphere = 0.f;
 
     glm::dmat4 _modelTransformCached;
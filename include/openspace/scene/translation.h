@@ -54,6 +54,13 @@ public:
 
     virtual glm::dvec3 position(const UpdateData& data) const = 0;
 
+    /**
+     * Returns whether #position can be called from a thread other than the main thread
+     * while other Translation%s are updated concurrently. Implementations that call into
+     * non-reentrant libraries (for example SPICE or Lua) must return \c false.
+     */
+    virtual bool isThreadSafe() const;
+
     // Registers a callback that gets called when a significant change has been made that
     // invalidates potentially stored points, for example in trails
     void onParameterChange(std::function<void()> callback);
@@ -87,6 +87,7 @@ public:
     bool writeLog(const std::string& script);
 
     virtual void preSync(bool isMaster) override;
+    virtual bool hasChanged() override;
     virtual void encode(SyncBuffer* syncBuffer) override;
     virtual void decode(SyncBuffer* syncBuffer) override;
     virtual void postSync(bool isMaster) override;
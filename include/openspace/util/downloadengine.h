@@ -0,0 +1,196 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_CORE___DOWNLOADENGINE___H__
+#define __OPENSPACE_CORE___DOWNLOADENGINE___H__
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * Downloads files, or data into memory, over HTTP. All transfers are driven by a single
+ * thread through one curl multi handle. At most the number of transfers that is passed
+ * to the constructor run at the same time; additional transfers wait in a queue until
+ * one of the running transfers is finished. The multi handle keeps the connections of
+ * finished transfers alive, so that subsequent transfers to the same host reuse the
+ * TCP and TLS connection instead of opening a new one for each file.
+ *
+ * A file transfer can be resumed: if a part of the file already exists at the
+ * destination, only the missing part is requested with a Range header and appended to
+ * the file. While a file is downloaded, the ETag or Last-Modified value of the response
+ * is stored next to it in a file with the ValidatorExtension, which is removed when the
+ * download succeeds. A resumed request sends this value in an If-Range header, so that
+ * the server only sends the missing part if the file has not changed since the partial
+ * file was written. The whole file is downloaded again if there is no stored value, if
+ * the file on the server has changed, or if the server does not support ranges.
+ *
+ * The progress of several transfers can be aggregated into one Progress object, which
+ * is updated by the amount that changed with every progress report of a transfer. The
+ * cost of reading or updating the aggregated progress therefore does not depend on the
+ * number of transfers.
+ */
+class DownloadEngine {
+public:
+    /// The extension of the file that stores the validator of a partial file
+    static constexpr const char* ValidatorExtension = ".validator";
+
+    struct Progress {
+        std::atomic<size_t> downloadedBytes = 0;
+        std::atomic<size_t> totalBytes = 0;
+        // The number of transfers whose size is not known yet. The total is only known
+        // when this is 0
+        std::atomic<int> nUnknownSizes = 0;
+    };
+
+    struct Request {
+        std::string url;
+        // The file that the data is written to. If this is empty, the data is kept in
+        // memory instead
+        std::string destination;
+        // If true, an existing file at the destination is assumed to be the beginning of
+        // the data and only the rest is downloaded, provided that the server confirms
+        // that the file has not changed
+        bool resume = false;
+        // 0 for no timeout
+        int timeoutSeconds = 0;
+        // The progress of this transfer is added to this object if it is not nullptr
+        std::shared_ptr<Progress> progress;
+    };
+
+    class Transfer {
+    public:
+        enum class State {
+            Queued,
+            Running,
+            Succeeded,
+            Failed,
+            Cancelled
+        };
+
+        explicit Transfer(Request request);
+
+        const std::string& url() const;
+        const std::string& destination() const;
+        State state() const;
+        bool isFinished() const;
+
+        /// Blocks until the transfer has succeeded, failed, or was cancelled
+        void wait();
+
+        /// Cancels the transfer, which is finished with the Cancelled state
+        void cancel();
+
+        /// The data of a transfer into memory. Only valid after the transfer succeeded
+        const std::vector<char>& data() const;
+
+    private:
+        friend class DownloadEngine;
+
+        void finish(State state);
+
+        // Both values include the resume offset; a totalBytes of 0 means unknown
+        void reportProgress(size_t downloadedBytes, size_t totalBytes);
+
+        // Removes everything this transfer has added to the progress so far
+        void resetProgress();
+
+        const Request _request;
+        std::atomic<State> _state = State::Queued;
+        std::atomic_bool _shouldCancel = false;
+        mutable std::mutex _mutex;
+        std::condition_variable _finishCondition;
+
+        // These are only used by the thread of the DownloadEngine
+        void* _handle = nullptr;
+        std::ofstream _file;
+        std::vector<char> _data;
+        size_t _resumeOffset = 0;
+        bool _isResumeAllowed = false;
+        // The ETag or Last-Modified value of the current response, empty if the server
+        // sent neither
+        std::string _validator;
+        // The list of additional request headers, a curl_slist
+        void* _headers = nullptr;
+        bool _hasCheckedResponse = false;
+        bool _isSizeKnown = false;
+        size_t _reportedBytes = 0;
+        size_t _reportedTotalBytes = 0;
+    };
+
+    /**
+     * Creates the engine and starts its thread, which runs at most
+     * \p maxConcurrentTransfers transfers at the same time.
+     */
+    explicit DownloadEngine(int maxConcurrentTransfers = 8);
+
+    /// Cancels all transfers that are queued or running and stops the thread
+    ~DownloadEngine();
+
+    /// Queues the transfer described by the \p request and returns its handle
+    std::shared_ptr<Transfer> enqueue(Request request);
+
+    /// Returns the number of connections that were opened since the engine was created
+    int nOpenedConnections() const;
+
+private:
+    void run();
+    bool startTransfer(const std::shared_ptr<Transfer>& transfer);
+    void finishTransfer(void* handle, int result);
+
+    static size_t headerCallback(char* buffer, size_t size, size_t nItems,
+        void* userData);
+    static size_t writeCallback(char* ptr, size_t size, size_t nmemb, void* userData);
+    static int progressCallback(void* userData, int64_t nTotalDownloadBytes,
+        int64_t nDownloadedBytes, int64_t nTotalUploadBytes, int64_t nUploadBytes);
+
+    const int _maxConcurrentTransfers;
+    void* _multiHandle = nullptr;
+    // Easy handles of finished transfers that are reused for the next transfers
+    std::vector<void*> _idleHandles;
+    std::vector<std::shared_ptr<Transfer>> _runningTransfers;
+    std::atomic<int> _nOpenedConnections = 0;
+
+    std::mutex _queueMutex;
+    std::condition_variable _queueCondition;
+    std::deque<std::shared_ptr<Transfer>> _queue;
+    bool _shouldStop = false;
+
+    // The thread is started last, after all the members it uses have been initialized
+    std::thread _thread;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___DOWNLOADENGINE___H__
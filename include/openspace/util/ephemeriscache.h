@@ -0,0 +1,169 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_CORE___EPHEMERISCACHE___H__
+#define __OPENSPACE_CORE___EPHEMERISCACHE___H__
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * Caches a smooth vector-valued function of time, such as the position of a SPICE target
+ * or the rotation between two reference frames, as piecewise Chebyshev polynomials. The
+ * time axis is divided into windows of #BaseWindowLength seconds that are halved until a
+ * polynomial of degree #Degree reproduces the function within the requested tolerance at
+ * the check points between its interpolation nodes. Pieces are fitted lazily by the
+ * first request that falls into them and are stored in a fixed-size, direct-mapped table.
+ *
+ * Lookups in the table are lock-free and can be done from any number of threads at the
+ * same time, only the fitting of new pieces is serialized. If the function cannot be
+ * approximated even by the shortest allowed piece, for example across the boundary of a
+ * kernel's coverage, the piece is marked as such and the function is evaluated directly
+ * for all times that fall into it.
+ */
+class EphemerisCache {
+public:
+    /// The cached function; it has to write #nComponents values into \c result
+    using Function = std::function<void(double time, double* result)>;
+
+    /// The degree of the polynomial in each piece
+    static constexpr const int Degree = 12;
+
+    /**
+     * The length of the coarsest pieces in seconds (about 12 days). It is a power of two
+     * so that the boundaries of all pieces are exactly representable
+     */
+    static constexpr const double BaseWindowLength = 1048576.0;
+
+    /// The number of times a window can be halved; the shortest pieces are 16 s long
+    static constexpr const int MaxLevel = 16;
+
+    /// The number of pieces that can be stored at the same time
+    static constexpr const int NumberSlots = 128;
+
+    struct Statistics {
+        /// The number of evaluations that were answered from a stored polynomial
+        uint64_t hits = 0;
+        /// The number of evaluations for which no piece was stored
+        uint64_t misses = 0;
+        /// The number of evaluations that fell into pieces that could not be fitted
+        uint64_t directEvaluations = 0;
+        /// The number of pieces that were fitted
+        uint64_t fits = 0;
+    };
+
+    /**
+     * Creates a cache for the \p function that returns \p nComponents values. A fitted
+     * component \c f' is accepted if it fulfills
+     * <code>|f' - f| <= absoluteTolerance + relativeTolerance * |f|</code> at all check
+     * points. As fits are done from the threads that call #evaluate, the \p function
+     * has to be thread-safe.
+     *
+     * \pre \p nComponents must be positive
+     * \pre \p function must not be empty
+     */
+    EphemerisCache(int nComponents, Function function, double absoluteTolerance,
+        double relativeTolerance = 0.0);
+    ~EphemerisCache();
+
+    /**
+     * Writes the value of the function at \p time into \p result. If a piece for
+     * \p time is stored, it is evaluated without taking any locks. Otherwise the
+     * function itself is evaluated and the piece is fitted once enough requests have
+     * missed it to amortize the cost of the fit. Exceptions thrown by the function are
+     * passed on to the caller.
+     */
+    void evaluate(double time, double* result);
+
+    /**
+     * Discards all stored pieces. This has to be called whenever the underlying
+     * function changes, for example when a kernel is loaded or unloaded.
+     */
+    void invalidate();
+
+    int nComponents() const;
+
+    Statistics statistics() const;
+
+private:
+    struct Slot;
+    struct Candidate;
+
+    /// Returns the slot that the piece \p index at \p level is stored in
+    Slot& slot(int level, int64_t index) const;
+
+    /**
+     * Evaluates the stored piece containing \p time, if there is one, and returns
+     * whether it was found.
+     */
+    bool lookup(double time, uint64_t generation, double* result);
+
+    /**
+     * Tries to evaluate a stored piece at \p level for \p time and returns
+     * <code>true</code> on success. \p isDirect is set if the stored piece is one that
+     * has to be evaluated directly.
+     */
+    bool evaluateStored(int level, double time, uint64_t generation, double* result,
+        bool& isDirect) const;
+
+    /// Fits and stores the piece containing \p time; must be called with _fitMutex
+    void fit(double time, uint64_t generation);
+
+    void store(int level, int64_t index, uint64_t generation, bool isDirect,
+        const double* coefficients);
+
+    const int _nComponents;
+    const Function _function;
+    const double _absoluteTolerance;
+    const double _relativeTolerance;
+
+    std::unique_ptr<Slot[]> _slots;
+    std::atomic<uint64_t> _generation = 1;
+    /// The level at which the last piece was found, which is probed first
+    std::atomic<int> _levelHint = 0;
+
+    /// Guards the fitting of pieces and the members below
+    std::mutex _fitMutex;
+    /// The level at which the next fit starts
+    int _fitLevel = 0;
+    /// The pieces that have been missed recently and how often
+    std::vector<Candidate> _candidates;
+    int _nextCandidate = 0;
+
+    std::atomic<uint64_t> _nHits = 0;
+    std::atomic<uint64_t> _nMisses = 0;
+    std::atomic<uint64_t> _nDirectEvaluations = 0;
+    std::atomic<uint64_t> _nFits = 0;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___EPHEMERISCACHE___H__
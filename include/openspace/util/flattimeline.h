@@ -0,0 +1,116 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_CORE___FLATTIMELINE___H__
+#define __OPENSPACE_CORE___FLATTIMELINE___H__
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * A variant of the Timeline for large numbers of keyframes that are mostly added in
+ * temporal order and then queried at slowly changing times, for example the samples of
+ * a trajectory. The timestamps and the data are stored in two contiguous arrays and the
+ * keyframes are referred to by their index instead of an id.
+ *
+ * The queries optionally take a Cursor that remembers the result of the previous query.
+ * The search starts at the remembered position and expands exponentially, so that a
+ * query costs O(1) if the time only moved by a few keyframes and O(log d) for a jump
+ * across d keyframes. Each consumer, for example each Translation, should own a Cursor.
+ */
+template <typename T>
+class FlatTimeline {
+public:
+    /// The value returned by the queries if there is no matching keyframe
+    static constexpr const size_t NoKeyframe = static_cast<size_t>(-1);
+
+    /// Caches the position of the last query into one FlatTimeline
+    class Cursor {
+    private:
+        friend class FlatTimeline<T>;
+        size_t _index = 0;
+    };
+
+    void reserve(size_t nKeyframes);
+
+    /**
+     * Adds a keyframe with the \p data at the \p timestamp. Adding keyframes in
+     * temporal order takes constant time, otherwise the keyframe is inserted after all
+     * keyframes with the same or an earlier timestamp.
+     */
+    void addKeyframe(double timestamp, T data);
+    void clearKeyframes();
+    size_t nKeyframes() const;
+
+    double timestamp(size_t index) const;
+    const T& data(size_t index) const;
+    const std::vector<double>& timestamps() const;
+
+    /**
+     * Returns the index of the first keyframe after the \p timestamp, or at it if
+     * \p inclusive is \c true, or NoKeyframe if there is no such keyframe.
+     */
+    size_t firstKeyframeAfter(double timestamp, bool inclusive = false) const;
+    size_t firstKeyframeAfter(double timestamp, Cursor& cursor,
+        bool inclusive = false) const;
+
+    /**
+     * Returns the index of the last keyframe before the \p timestamp, or at it if
+     * \p inclusive is \c true, or NoKeyframe if there is no such keyframe.
+     */
+    size_t lastKeyframeBefore(double timestamp, bool inclusive = false) const;
+    size_t lastKeyframeBefore(double timestamp, Cursor& cursor,
+        bool inclusive = false) const;
+
+    /**
+     * Returns the range [first, last) of the indices of all keyframes between \p begin
+     * and \p end. The range is empty if there are no such keyframes.
+     */
+    std::pair<size_t, size_t> keyframesBetween(double begin, double end,
+        bool inclusiveBegin = true, bool inclusiveEnd = true) const;
+    std::pair<size_t, size_t> keyframesBetween(double begin, double end, Cursor& cursor,
+        bool inclusiveBegin = true, bool inclusiveEnd = true) const;
+
+private:
+    /**
+     * Returns the number of keyframes that are before the \p timestamp (or at it if
+     * \p inclusive is \c true), searching outwards from the position of \p cursor, and
+     * stores the result in the \p cursor.
+     */
+    size_t nKeyframesBefore(double timestamp, bool inclusive, Cursor& cursor) const;
+
+    std::vector<double> _timestamps;
+    std::vector<T> _data;
+};
+
+} // namespace openspace
+
+#include "flattimeline.inl"
+
+#endif // __OPENSPACE_CORE___FLATTIMELINE___H__
@@ -0,0 +1,172 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+namespace openspace {
+
+template <typename T>
+void FlatTimeline<T>::reserve(size_t nKeyframes) {
+    _timestamps.reserve(nKeyframes);
+    _data.reserve(nKeyframes);
+}
+
+template <typename T>
+void FlatTimeline<T>::addKeyframe(double timestamp, T data) {
+    if (_timestamps.empty() || _timestamps.back() <= timestamp) {
+        _timestamps.push_back(timestamp);
+        _data.push_back(std::move(data));
+        return;
+    }
+
+    const auto it = std::upper_bound(_timestamps.begin(), _timestamps.end(), timestamp);
+    const auto offset = it - _timestamps.begin();
+    _timestamps.insert(it, timestamp);
+    _data.insert(_data.begin() + offset, std::move(data));
+}
+
+template <typename T>
+void FlatTimeline<T>::clearKeyframes() {
+    _timestamps.clear();
+    _data.clear();
+}
+
+template <typename T>
+size_t FlatTimeline<T>::nKeyframes() const {
+    return _timestamps.size();
+}
+
+template <typename T>
+double FlatTimeline<T>::timestamp(size_t index) const {
+    return _timestamps[index];
+}
+
+template <typename T>
+const T& FlatTimeline<T>::data(size_t index) const {
+    return _data[index];
+}
+
+template <typename T>
+const std::vector<double>& FlatTimeline<T>::timestamps() const {
+    return _timestamps;
+}
+
+template <typename T>
+size_t FlatTimeline<T>::nKeyframesBefore(double timestamp, bool inclusive,
+                                         Cursor& cursor) const
+{
+    // The result is the partition point of the timestamps with respect to isBefore
+    auto isBefore = [timestamp, inclusive](double t) {
+        return inclusive ? (t <= timestamp) : (t < timestamp);
+    };
+
+    const double* ts = _timestamps.data();
+    const size_t n = _timestamps.size();
+    const size_t hint = std::min(cursor._index, n);
+
+    // Find a range [lo, hi) that contains the partition point by doubling the distance
+    // from the previous result until the range is bracketed
+    size_t lo = 0;
+    size_t hi = 0;
+    if (hint < n && isBefore(ts[hint])) {
+        // The partition point is behind the hint; all values before lo are before
+        lo = hint + 1;
+        size_t step = 1;
+        while (lo + step - 1 < n && isBefore(ts[lo + step - 1])) {
+            lo += step;
+            step *= 2;
+        }
+        hi = std::min(lo + step - 1, n);
+    }
+    else {
+        // The partition point is at or in front of the hint; no value from hi is before
+        hi = hint;
+        size_t step = 1;
+        while (hi >= step && !isBefore(ts[hi - step])) {
+            hi -= step;
+            step *= 2;
+        }
+        lo = (hi >= step) ? hi - step + 1 : 0;
+    }
+
+    const size_t result = std::partition_point(ts + lo, ts + hi, isBefore) - ts;
+    cursor._index = result;
+    return result;
+}
+
+template <typename T>
+size_t FlatTimeline<T>::firstKeyframeAfter(double timestamp, bool inclusive) const {
+    Cursor cursor;
+    cursor._index = _timestamps.size() / 2;
+    return firstKeyframeAfter(timestamp, cursor, inclusive);
+}
+
+template <typename T>
+size_t FlatTimeline<T>::firstKeyframeAfter(double timestamp, Cursor& cursor,
+                                           bool inclusive) const
+{
+    // The first keyframe after is the first one that is not before the timestamp
+    const size_t i = nKeyframesBefore(timestamp, !inclusive, cursor);
+    return (i < _timestamps.size()) ? i : NoKeyframe;
+}
+
+template <typename T>
+size_t FlatTimeline<T>::lastKeyframeBefore(double timestamp, bool inclusive) const {
+    Cursor cursor;
+    cursor._index = _timestamps.size() / 2;
+    return lastKeyframeBefore(timestamp, cursor, inclusive);
+}
+
+template <typename T>
+size_t FlatTimeline<T>::lastKeyframeBefore(double timestamp, Cursor& cursor,
+                                           bool inclusive) const
+{
+    const size_t i = nKeyframesBefore(timestamp, inclusive, cursor);
+    return (i > 0) ? i - 1 : NoKeyframe;
+}
+
+template <typename T>
+std::pair<size_t, size_t> FlatTimeline<T>::keyframesBetween(double begin, double end,
+                                                            bool inclusiveBegin,
+                                                            bool inclusiveEnd) const
+{
+    Cursor cursor;
+    cursor._index = _timestamps.size() / 2;
+    return keyframesBetween(begin, end, cursor, inclusiveBegin, inclusiveEnd);
+}
+
+template <typename T>
+std::pair<size_t, size_t> FlatTimeline<T>::keyframesBetween(double begin, double end,
+                                                            Cursor& cursor,
+                                                            bool inclusiveBegin,
+                                                            bool inclusiveEnd) const
+{
+    const size_t first = nKeyframesBefore(begin, !inclusiveBegin, cursor);
+    // Searching for the end starting from the beginning of the range costs O(log k) for
+    // a range of k keyframes
+    Cursor endCursor = cursor;
+    const size_t last = std::max(nKeyframesBefore(end, inclusiveEnd, endCursor), first);
+    return { first, last };
+}
+
+} // namespace openspace
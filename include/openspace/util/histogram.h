@@ -33,10 +33,10 @@ class Histogram {
 public:
     Histogram() = default;
     Histogram(float minValue, float maxValue, int numBins, float* data = nullptr);
-    Histogram(Histogram&& other) = default;
+    Histogram(Histogram&& other);
     ~Histogram();
 
-    Histogram& operator=(Histogram&& other) = default;
+    Histogram& operator=(Histogram&& other);
 
     int numBins() const;
     float minValue() const;
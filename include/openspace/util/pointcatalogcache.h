@@ -0,0 +1,144 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_CORE___POINTCATALOGCACHE___H__
+#define __OPENSPACE_CORE___POINTCATALOGCACHE___H__
+
+#include <openspace/util/memorymappedfile.h>
+
+#include <ghoul/glm.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * A columnar container for point catalogs, such as the stars and the Digital Universe
+ * datasets, that is used as their binary cache. The file consists of a header, a table
+ * describing each column (name, type, and the minimum and maximum value), the column
+ * data, a label table, and a string table. Each column is stored contiguously and
+ * aligned to 64 bytes, so that it can be read with vector instructions or handed to a
+ * buffer upload without copying it first.
+ *
+ * A catalog is either built in memory from the rows of a parsed file, in which case it
+ * can be saved, or it is loaded from a cache file, which is mapped into memory
+ * read-only. Loaded catalogs do not copy any of the column data onto the heap; their
+ * pages are loaded lazily by the operating system and can be evicted and shared
+ * between processes.
+ */
+class PointCatalogCache {
+public:
+    enum class ColumnType : uint32_t {
+        Float32 = 0
+    };
+
+    struct Column {
+        std::string_view name;
+        ColumnType type;
+        /// The smallest and largest value of the column, ignoring NaNs
+        float minimum;
+        float maximum;
+    };
+
+    /// Creates an empty catalog without any rows, columns, or labels
+    PointCatalogCache() = default;
+
+    /**
+     * Builds a catalog in memory from \p rows that are stored in row-major order with
+     * as many values per row as there are \p columnNames.
+     *
+     * \param contentVersion The version of the data layout of the calling code, which
+     *        has to match when the cache is loaded again. It is used to invalidate
+     *        caches when the meaning of the columns changes
+     * \param labels The labels that are stored alongside the rows, if any
+     */
+    PointCatalogCache(const std::vector<float>& rows,
+        const std::vector<std::string>& columnNames, uint32_t contentVersion,
+        const std::vector<std::pair<glm::vec3, std::string>>& labels = {});
+
+    /**
+     * Maps the cache file at \p path into memory and validates its structure.
+     *
+     * \throw ghoul::RuntimeError If the file could not be mapped, is not a point
+     *        catalog cache, was written with a different format or \p contentVersion,
+     *        or is truncated
+     */
+    static PointCatalogCache load(std::string path, uint32_t contentVersion);
+
+    /**
+     * Writes the catalog to \p path in the format that can be loaded by #load.
+     *
+     * \throw ghoul::RuntimeError If the file could not be written
+     */
+    void save(const std::string& path) const;
+
+    /// Returns true if the catalog was loaded from a memory-mapped file
+    bool isMapped() const;
+
+    size_t nRows() const;
+    int nColumns() const;
+    Column column(int index) const;
+
+    /// Returns the index of the column called \p name, or -1 if there is no such column
+    int columnIndex(std::string_view name) const;
+
+    /// Returns a pointer to the #nRows values of the column at \p index
+    const float* columnData(int index) const;
+
+    /// Returns the value of the column at \p column in the row at \p row
+    float value(size_t row, int column) const;
+
+    size_t nLabels() const;
+    glm::vec3 labelPosition(size_t index) const;
+    std::string_view labelText(size_t index) const;
+
+private:
+    struct Header;
+    struct ColumnDescriptor;
+    struct LabelDescriptor;
+
+    void setPointers();
+    void validate(uint32_t contentVersion) const;
+
+    std::unique_ptr<MemoryMappedFile> _file;
+    std::vector<std::byte> _buffer;
+
+    const std::byte* _data = nullptr;
+    size_t _size = 0;
+    const Header* _header = nullptr;
+    const ColumnDescriptor* _columns = nullptr;
+    const LabelDescriptor* _labels = nullptr;
+    const char* _strings = nullptr;
+    std::vector<const float*> _columnData;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___POINTCATALOGCACHE___H__
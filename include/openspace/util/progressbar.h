@@ -26,6 +26,7 @@
 #define __OPENSPACE_CORE___PROGRESSBAR___H__
 
 #include <iostream>
+#include <mutex>
 
 namespace openspace {
 
@@ -38,11 +39,17 @@ public:
 
     void print(int current);
 
+    /// Adds \p n to the progress and prints it. This function is thread-safe
+    void advance(int n = 1);
+
 private:
     int _width;
     int _previous = -1;
     int _end;
 
+    std::mutex _mutex;
+    int _current = 0;
+
     std::ostream& _stream;
 };
 
@@ -26,6 +26,7 @@
 #define __OPENSPACE_CORE___RESOURCESYNCHRONIZATION___H__
 
 #include <atomic>
+#include <chrono>
 #include <functional>
 #include <memory>
 #include <mutex>
@@ -87,6 +88,8 @@ private:
 
     std::string _name;
     std::atomic<State> _state = State::Unsynced;
+    // Used for the startup trace
+    std::chrono::steady_clock::time_point _syncBeginTime;
     std::mutex _callbackMutex;
     CallbackHandle _nextCallbackId = 0;
     std::unordered_map<CallbackHandle, StateChangeCallback> _stateChangeCallbacks;
@@ -0,0 +1,128 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___SPECKFILE___H__
+#define __OPENSPACE_CORE___SPECKFILE___H__
+
+#include <openspace/util/memorymappedfile.h>
+
+#include <ghoul/glm.h>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * Reader for the speck and label files of the Digital Universe catalogs. The file is
+ * mapped into memory and its header is parsed on construction. The header consists of
+ * comments (starting with '#') and lines starting with one of the keywords
+ * <code>datavar</code>, <code>texturevar</code>, <code>texture</code>,
+ * <code>polyorivar</code>, <code>maxcomment</code>, or <code>textcolor</code>; it ends
+ * at the first line that is none of these. The rest of the file is the body, whose rows
+ * are parsed in parallel in line-aligned chunks directly into the caller's buffer.
+ */
+class SpeckFile {
+public:
+    struct DataVariable {
+        /// The index of the variable as written in the file, not counting X Y Z
+        int index;
+        std::string name;
+    };
+
+    /**
+     * Maps the file at \p path into memory and parses its header.
+     *
+     * \throw ghoul::RuntimeError If the file does not exist or could not be mapped
+     */
+    explicit SpeckFile(std::string path);
+
+    const std::string& path() const;
+
+    /// Returns the keyword lines of the header in the order they appear in the file
+    const std::vector<std::string>& headerLines() const;
+
+    /// Returns all variables that are declared with a <code>datavar</code> line
+    const std::vector<DataVariable>& dataVariables() const;
+
+    /**
+     * Returns the number of values in each row as declared by the last
+     * <code>datavar</code> line, including the X Y Z coordinates that are not
+     * declared in the header.
+     */
+    int nValuesPerRow() const;
+
+    /**
+     * Returns the names of the #nValuesPerRow values in each row, which are
+     * <code>x</code>, <code>y</code>, <code>z</code>, followed by the names of the
+     * data variables at their declared index.
+     */
+    std::vector<std::string> columnNames() const;
+
+    /**
+     * Returns all non-empty lines of the body that are not comments, without their line
+     * endings. The returned views point into the mapped file and are valid for the
+     * lifetime of this object.
+     */
+    std::vector<std::string_view> bodyLines() const;
+
+    /**
+     * Parses all rows of the body into \p result, which is resized to hold
+     * \p nValuesPerRow floats for every row. Values that are missing at the end of a
+     * row are set to 0 and any additional values in a row are ignored.
+     *
+     * \param result The buffer the rows are written to in row-major order
+     * \param nValuesPerRow The number of values to read from each row
+     * \param skipNullRows If true, rows that only consist of zeros are not included
+     * \return The number of rows that were written to \p result
+     */
+    size_t readRows(std::vector<float>& result, int nValuesPerRow,
+        bool skipNullRows = false) const;
+
+    /**
+     * Parses the body as a label file, in which each row consists of a position, the
+     * keyword <code>text</code>, and the label that extends to the end of the line or to
+     * a trailing comment.
+     */
+    std::vector<std::pair<glm::vec3, std::string>> readLabels() const;
+
+    /**
+     * Parses up to \p nValues whitespace-separated floating point values from the
+     * beginning of \p line into \p values and returns the number of values that were
+     * parsed. Parsing stops at the first token that is not a number.
+     */
+    static int parseValues(std::string_view line, float* values, int nValues);
+
+private:
+    MemoryMappedFile _file;
+    std::vector<std::string> _headerLines;
+    std::vector<DataVariable> _dataVariables;
+    int _nValuesPerRow = 3;
+    size_t _bodyOffset = 0;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___SPECKFILE___H__
@@ -25,11 +25,15 @@
 #ifndef __OPENSPACE_CORE___SPICEMANAGER___H__
 #define __OPENSPACE_CORE___SPICEMANAGER___H__
 
+#include <openspace/util/ephemeriscache.h>
+
 #include <ghoul/glm.h>
 #include <ghoul/misc/boolean.h>
 #include <ghoul/misc/exception.h>
 #include <array>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 #include <set>
@@ -542,6 +546,23 @@ public:
         const std::string& observer, const std::string& referenceFrame,
         AberrationCorrection aberrationCorrection, double ephemerisTime) const;
 
+    /**
+     * Returns the EphemerisCache for the position of the \p target relative to the
+     * \p observer in the \p referenceFrame, which evaluates to the same value as
+     * #targetPosition within an error of 1 mm + 1e-12 times the distance. All callers
+     * requesting the same parameters share one cache, which stays valid for the lifetime
+     * of the SpiceManager and is invalidated whenever a kernel is loaded or unloaded.
+     * Stored pieces of the cache are evaluated without any locks, so the cache can be
+     * used from any thread; on a miss, #targetPosition is called.
+     *
+     * \pre \p target must not be empty.
+     * \pre \p observer must not be empty.
+     * \pre \p referenceFrame must not be empty.
+     */
+    EphemerisCache& targetPositionCache(const std::string& target,
+        const std::string& observer, const std::string& referenceFrame,
+        AberrationCorrection aberrationCorrection);
+
     /**
      * This method returns the transformation matrix that defines the transformation from
      * the reference frame \p from to the reference frame \p to. As both reference frames
@@ -771,6 +792,24 @@ public:
     glm::dmat3 positionTransformMatrix(const std::string& sourceFrame,
         const std::string& destinationFrame, double ephemerisTime) const;
 
+    /**
+     * Returns the EphemerisCache for the column-major elements of the matrix returned by
+     * #positionTransformMatrix, which are accurate to within 1e-10. The cache is shared
+     * in the same way as the one returned by #targetPositionCache.
+     *
+     * \pre \p sourceFrame must not be empty.
+     * \pre \p destinationFrame must not be empty.
+     */
+    EphemerisCache& positionTransformMatrixCache(const std::string& sourceFrame,
+        const std::string& destinationFrame);
+
+    /**
+     * Returns the statistics of all caches created by #targetPositionCache and
+     * #positionTransformMatrixCache together with the parameters they were created for.
+     */
+    std::vector<std::pair<std::string, EphemerisCache::Statistics>>
+        ephemerisCacheStatistics() const;
+
     /**
      * Returns the transformation matrix that transforms position vectors from the
      * \p sourceFrame at the time \p ephemerisTimeFrom to the \p destinationFrame at the
@@ -1040,6 +1079,9 @@ private:
     glm::dmat3 getEstimatedTransformMatrix(const std::string& fromFrame,
         const std::string& toFrame, double time) const;
 
+    /// Discards the stored pieces of all ephemeris caches after the kernels changed
+    void invalidateEphemerisCaches();
+
     /// A list of all loaded kernels
     std::vector<KernelInformation> _loadedKernels;
 
@@ -1057,6 +1099,14 @@ private:
     /// The last assigned kernel-id, used to determine the next free kernel id
     KernelHandle _lastAssignedKernel = KernelHandle(0);
 
+    /// Serializes all calls into CSPICE, which is not thread-safe, and the access to the
+    /// loaded kernels and their coverage
+    mutable std::recursive_mutex _spiceMutex;
+
+    /// The ephemeris caches by the parameters they were created for
+    std::map<std::string, std::unique_ptr<EphemerisCache>> _ephemerisCaches;
+    mutable std::mutex _ephemerisCacheMutex;
+
     static SpiceManager* _instance;
 };
 
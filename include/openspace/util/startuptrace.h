@@ -0,0 +1,126 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_CORE___STARTUPTRACE___H__
+#define __OPENSPACE_CORE___STARTUPTRACE___H__
+
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * Records timed events while the application starts up and writes them in the JSON
+ * format of the Chrome trace event profiler, which can be opened in
+ * <code>chrome://tracing</code> or in the Perfetto UI. Each event is shown on the row of
+ * the thread that recorded it, so the loading of assets, the initialization of the
+ * scene graph nodes on the worker threads, and the OpenGL initialization on the main
+ * thread can be compared on the same timeline. Events that are not bound to a thread,
+ * such as resource synchronizations, are recorded as asynchronous events.
+ *
+ * Nothing is recorded unless the trace is enabled. All methods are thread-safe.
+ */
+class StartupTrace {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Records an event for the lifetime of this object on the thread that created it.
+     * If the trace is disabled when the Scope is created, nothing is recorded.
+     */
+    class Scope {
+    public:
+        Scope(StartupTrace& trace, std::string category, std::string name);
+        ~Scope();
+
+    private:
+        StartupTrace& _trace;
+        const bool _isEnabled;
+        std::string _category;
+        std::string _name;
+        Clock::time_point _begin;
+    };
+
+    /**
+     * Enables or disables the recording of events. The thread that enables the trace is
+     * labeled as the main thread and the timestamps of the trace are relative to the
+     * time it was enabled.
+     */
+    void setEnabled(bool enabled);
+    bool isEnabled() const;
+
+    /// Records an event that ran from \p begin to \p end on the calling thread
+    void addEvent(std::string category, std::string name, Clock::time_point begin,
+        Clock::time_point end);
+
+    /// Records an event that ran from \p begin to \p end but is not bound to a thread
+    void addAsyncEvent(std::string category, std::string name, Clock::time_point begin,
+        Clock::time_point end);
+
+    /// Returns the number of events that have been recorded
+    size_t nEvents() const;
+
+    /// Returns the recorded events in the Chrome trace event format
+    std::string json() const;
+
+    /**
+     * Writes the recorded events in the Chrome trace event format to the file at
+     * \p path, overwriting the file if it already exists.
+     *
+     * \throw ghoul::RuntimeError If the file could not be written
+     */
+    void writeToFile(const std::string& path) const;
+
+    /// Removes all recorded events
+    void clear();
+
+private:
+    struct Event {
+        std::string category;
+        std::string name;
+        Clock::time_point begin;
+        Clock::time_point end;
+        // The index of the thread that recorded the event, or -1 for async events
+        int thread;
+    };
+
+    int threadIndex(std::thread::id id);
+
+    std::atomic_bool _isEnabled = false;
+    mutable std::mutex _mutex;
+    Clock::time_point _origin = Clock::now();
+    std::thread::id _mainThread;
+    std::vector<Event> _events;
+    std::unordered_map<std::thread::id, int> _threadIndices;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___STARTUPTRACE___H__
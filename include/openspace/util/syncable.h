@@ -44,6 +44,14 @@ protected:
     friend class SyncEngine;
 
     virtual void preSync(bool /*isMaster*/) {};
+
+    /**
+     * Returns whether this Syncable has changed since it was last encoded. If the
+     * SyncEngine uses delta encoding, only changed Syncables are encoded and decoded in
+     * a frame. Implementations that cannot track their changes always return
+     * <code>true</code>.
+     */
+    virtual bool hasChanged() { return true; };
     virtual void encode(SyncBuffer* /*syncBuffer*/) = 0;
     virtual void decode(SyncBuffer* /*syncBuffer*/) = 0;
     virtual void postSync(bool /*isMaster*/) {};
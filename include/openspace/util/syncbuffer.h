@@ -57,13 +57,33 @@ public:
     //void read();
 
     void setData(std::vector<char> data);
-    std::vector<char> data();
+
+    /**
+     * Sets \p data as the source for the following decode calls without copying it.
+     * The memory pointed to by \p data has to remain valid until the buffer is reset or
+     * new data is set.
+     */
+    void setData(const char* data, size_t size);
+
+    /**
+     * Returns all data that has been encoded since the last reset. The reference stays
+     * valid until the buffer is reset.
+     */
+    const std::vector<char>& data();
+
+    /// Returns the number of bytes that have been encoded since the last reset
+    size_t encodedSize() const;
 
 private:
     size_t _n;
     size_t _encodeOffset = 0;
     size_t _decodeOffset = 0;
     std::vector<char> _dataStream;
+
+    // The data that is decoded from. Points either into _dataStream or into externally
+    // owned memory that was passed to setData
+    const char* _decodeData = nullptr;
+    size_t _decodeSize = 0;
 };
 
 } // namespace openspace
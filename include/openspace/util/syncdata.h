@@ -27,6 +27,7 @@
 
 #include <openspace/util/syncable.h>
 
+#include <cstring>
 #include <mutex>
 
 namespace openspace {
@@ -76,12 +77,15 @@ public:
     const T& data() const;
 
 protected:
+    virtual bool hasChanged() override;
     virtual void encode(SyncBuffer* syncBuffer) override;
     virtual void decode(SyncBuffer* syncBuffer) override;
     virtual void postSync(bool isMaster) override;
 
     T _data;
     T _doubleBufferedData;
+    // The value of _data when it was last encoded, used to detect changes
+    T _lastEncodedData;
     std::mutex _mutex;
 };
 
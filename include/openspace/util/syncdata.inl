@@ -58,10 +58,18 @@ const T& SyncData<T>::data() const {
     return _data;
 }
 
+template<class T>
+bool SyncData<T>::hasChanged() {
+    // The data is transferred bitwise by the SyncBuffer, so compare it bitwise as well
+    std::lock_guard<std::mutex> guard(_mutex);
+    return std::memcmp(&_data, &_lastEncodedData, sizeof(T)) != 0;
+}
+
 template<class T>
 void SyncData<T>::encode(SyncBuffer* syncBuffer) {
     _mutex.lock();
     syncBuffer->encode(_data);
+    _lastEncodedData = _data;
     _mutex.unlock();
 }
 
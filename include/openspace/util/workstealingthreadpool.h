@@ -0,0 +1,98 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#ifndef __OPENSPACE_CORE___WORKSTEALINGTHREADPOOL___H__
+#define __OPENSPACE_CORE___WORKSTEALINGTHREADPOOL___H__
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * A thread pool in which every worker owns its own task queue. Tasks that are enqueued
+ * from a worker thread are put into that worker's queue, tasks from any other thread are
+ * distributed in a round-robin fashion. A worker that runs out of tasks steals from the
+ * front of the other workers' queues, which keeps all cores busy when a small number of
+ * tasks spawns a large number of follow-up tasks, for example when traversing a graph.
+ */
+class WorkStealingThreadPool {
+public:
+    explicit WorkStealingThreadPool(size_t numThreads);
+    ~WorkStealingThreadPool();
+
+    void enqueue(std::function<void()> f);
+
+    /**
+     * Executes one pending task on the calling thread, if any task is available. This
+     * lets a thread that waits for the completion of enqueued tasks help with the work
+     * instead of blocking. Exceptions thrown by an enqueued task are logged and do not
+     * propagate to the thread that happens to run the task.
+     *
+     * \return \c true if a task was executed, \c false if no task was pending
+     */
+    bool runPendingTask();
+
+    /**
+     * Calls \p func(begin, end) for \p nBlocks consecutive blocks that together cover
+     * the range [0, \p n) on the threads of this pool and returns when all blocks are
+     * done. The calling thread executes pending tasks while it waits, which means that
+     * this function can also be called from a task that is running on this pool. If any
+     * block throws an exception, the remaining blocks still run to completion and the
+     * first exception is rethrown on the calling thread.
+     */
+    void parallelFor(size_t n, size_t nBlocks,
+        const std::function<void(size_t, size_t)>& func);
+
+    size_t numThreads() const;
+
+private:
+    struct TaskQueue {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void workerLoop(size_t index);
+    void runTask(std::function<void()>& task);
+    bool popTask(size_t index, std::function<void()>& task);
+
+    std::vector<std::unique_ptr<TaskQueue>> _queues;
+    std::vector<std::thread> _workers;
+
+    std::mutex _sleepMutex;
+    std::condition_variable _condition;
+    std::atomic<size_t> _nPendingTasks = 0;
+    std::atomic<size_t> _nextQueue = 0;
+    bool _stop = false;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_CORE___WORKSTEALINGTHREADPOOL___H__
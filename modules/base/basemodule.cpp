@@ -58,6 +58,7 @@
 #include <modules/base/scale/luascale.h>
 #include <modules/base/scale/staticscale.h>
 #include <modules/base/scale/timedependentscale.h>
+#include <modules/base/tasks/convertrecordingformattask.h>
 #include <modules/base/translation/luatranslation.h>
 #include <modules/base/translation/statictranslation.h>
 #include <modules/base/timeframe/timeframeinterval.h>
@@ -67,6 +68,7 @@
 #include <openspace/rendering/screenspacerenderable.h>
 #include <openspace/scripting/lualibrary.h>
 #include <openspace/util/factorymanager.h>
+#include <openspace/util/task.h>
 #include <ghoul/misc/assert.h>
 #include <ghoul/misc/templatefactory.h>
 
@@ -164,6 +166,10 @@ void BaseModule::internalInitialize(const ghoul::Dictionary&) {
     auto fGeometry = FactoryManager::ref().factory<modelgeometry::ModelGeometry>();
     ghoul_assert(fGeometry, "Model geometry factory was not created");
     fGeometry->registerClass<modelgeometry::MultiModelGeometry>("MultiModelGeometry");
+
+    auto fTask = FactoryManager::ref().factory<Task>();
+    ghoul_assert(fTask, "No task factory existed");
+    fTask->registerClass<ConvertRecordingFormatTask>("ConvertRecordingFormatTask");
 }
 
 void BaseModule::internalDeinitializeGL() {
@@ -213,6 +219,8 @@ std::vector<documentation::Documentation> BaseModule::documentations() const {
         CameraLightSource::Documentation(),
 
         modelgeometry::ModelGeometry::Documentation(),
+
+        ConvertRecordingFormatTask::documentation()
     };
 }
 
@@ -26,9 +26,14 @@
 
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
+#include <openspace/engine/globals.h>
 #include <openspace/scene/translation.h>
 #include <openspace/util/updatestructures.h>
+#include <openspace/util/workstealingthreadpool.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
 #include <ghoul/opengl/programobject.h>
+#include <cstring>
 #include <numeric>
 
 // This class is using a VBO ring buffer + a constantly updated point as follows:
@@ -59,6 +64,11 @@
 // towards the upper areas of the array instead.
 // In both cases, only the values that have been changed will be uploaded to the GPU.
 //
+// The vertex buffer contains NBufferRegions copies of this array. Each frame in which
+// points have changed, the changed ranges are written into the region after the one that
+// was rendered last and the rendering switches to that region. The region is only
+// written after the fence placed by its last draw call has been signalled.
+//
 // For the rendering, this is achieved by using an index buffer that is twice the size of
 // the vertex buffer containing identical two sequences indexing the vertex array.
 // In an example of size 8:
@@ -79,6 +89,18 @@
 // items in memory as was shown to be much slower than the current system.   ---abock
 
 namespace {
+    constexpr const char* _loggerCat = "RenderableTrailOrbit";
+
+    // The time that a sampling job may spend on computing new points before it hands
+    // them to the render thread. Sampling the Translation can be expensive, so
+    // recomputing all points, for example after a large jump in time, is spread across
+    // multiple jobs and the trail grows over multiple frames
+    constexpr const std::chrono::microseconds SweepBudget(2000);
+
+    // The time in nanoseconds that a single wait for the GPU to finish drawing from a
+    // region of the vertex buffer takes at most before the wait is repeated
+    constexpr const GLuint64 FenceTimeout = 100000000;
+
     constexpr openspace::properties::Property::PropertyInfo PeriodInfo = {
         "Period",
         "Period (in days)",
@@ -138,6 +160,9 @@ RenderableTrailOrbit::RenderableTrailOrbit(const ghoul::Dictionary& dictionary)
     : RenderableTrail(dictionary)
     , _period(PeriodInfo, 0.0, 0.0, 1e9)
     , _resolution(ResolutionInfo, 10000, 1, 1000000)
+    , _sampler([this](double time) {
+        return _translation->position({ {}, time, 0.0, false });
+    })
 {
     documentation::testSpecificationAndThrow(
         Documentation(),
@@ -151,7 +176,7 @@ RenderableTrailOrbit::RenderableTrailOrbit(const ghoul::Dictionary& dictionary)
     using namespace std::chrono;
     const long long sph = duration_cast<seconds>(hours(24)).count();
     _period = dictionary.value<double>(PeriodInfo.identifier) * sph;
-    _period.onChange([&] { _needsFullSweep = true; _indexBufferDirty = true; });
+    _period.onChange([&] { _needsFullSweep = true; });
     addProperty(_period);
 
     _resolution = static_cast<int>(dictionary.value<double>(ResolutionInfo.identifier));
@@ -162,317 +187,290 @@ RenderableTrailOrbit::RenderableTrailOrbit(const ghoul::Dictionary& dictionary)
     _primaryRenderInformation.sorting = RenderInformation::VertexSorting::NewestFirst;
 }
 
+RenderableTrailOrbit::~RenderableTrailOrbit() {
+    // The sampling job accesses the sampler and the Translation
+    waitForSampling();
+}
+
 void RenderableTrailOrbit::initializeGL() {
     RenderableTrail::initializeGL();
 
     glGenVertexArrays(1, &_primaryRenderInformation._vaoID);
-    glGenBuffers(1, &_primaryRenderInformation._vBufferID);
     glGenBuffers(1, &_primaryRenderInformation._iBufferID);
+
+    // The buffers have to be recreated for the (potentially) new resolution
+    _indexBufferDirty = true;
+    _needsFullSweep = true;
 }
 
 void RenderableTrailOrbit::deinitializeGL() {
+    waitForSampling();
+    deleteVertexBuffer();
+
     glDeleteVertexArrays(1, &_primaryRenderInformation._vaoID);
-    glDeleteBuffers(1, &_primaryRenderInformation._vBufferID);
     glDeleteBuffers(1, &_primaryRenderInformation._iBufferID);
 
     RenderableTrail::deinitializeGL();
 }
 
+void RenderableTrailOrbit::render(const RenderData& data, RendererTasks& rendererTask) {
+    RenderableTrail::render(data, rendererTask);
+
+    // The current region must not be written again before this draw call has finished
+    GLsync& fence = _regions[_currentRegion].fence;
+    if (fence) {
+        glDeleteSync(fence);
+    }
+    fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, GL_NONE_BIT);
+}
+
 void RenderableTrailOrbit::update(const UpdateData& data) {
     // Overview:
-    // 1. Update trails
-    // 2. Update floating position
-    // 3. Determine which parts of the array to upload and upload the data
+    // 1. Wait for the last sampling job to finish
+    // 2. Recreate the buffers if the resolution has changed, or take over the points
+    //    that have been computed by the last sampling job
+    // 3. Start the next sampling job
+    // 4. Upload the parts of the array that have changed
 
     // 1
-    // Update the trails; the report contains whether any of the other values has been
-    // touched and if so, how many
-    const UpdateReport report = updateTrails(data);
-    _previousTime = data.time.j2000Seconds();
-
-    // Do not do anything if no point needs to be updated
-    if (!report.permanentPointsNeedUpdate && !report.floatingPointNeedsUpdate) {
-        return;
+    // The sampler is owned by the job until it has finished. In the meantime, the
+    // points that have been uploaded before continue to be rendered
+    {
+        std::lock_guard<std::mutex> lock(_samplingMutex);
+        if (_isSampling) {
+            return;
+        }
     }
 
     // 2
-    // Write the current location into the floating position
-    const glm::vec3 p = _translation->position({
-        {},
-        data.time.j2000Seconds(),
-        0.0,
-        false
-    });
-    _vertexArray[_primaryRenderInformation.first] = { p.x, p.y, p.z };
+    // If the last job did not change any points, the sampler has caught up with the time
+    // and another job is only necessary if the time or the parameters have changed
+    const bool hasChanged = _report.nRanges > 0;
 
-    glBindVertexArray(_primaryRenderInformation._vaoID);
-    glBindBuffer(GL_ARRAY_BUFFER, _primaryRenderInformation._vBufferID);
+    // The index buffer stays constant until we change the size of the array
+    if (_indexBufferDirty) {
+        // Create the index buffer and fill it with two ranges for [0, _resolution)
+        _indexArray.clear();
+        _indexArray.resize(_resolution * 2);
+        std::iota(_indexArray.begin(), _indexArray.begin() + _resolution, 0);
+        std::iota(_indexArray.begin() + _resolution, _indexArray.end(), 0);
 
-    // 3
-    if (!report.permanentPointsNeedUpdate) {
-        if (report.floatingPointNeedsUpdate) {
-            // If no other values have been touched, we only need to upload the
-            // floating value
-            glBufferSubData(
-                GL_ARRAY_BUFFER,
-                _primaryRenderInformation.first * sizeof(TrailVBOLayout),
-                sizeof(TrailVBOLayout),
-                _vertexArray.data() + _primaryRenderInformation.first
-            );
-        }
+        createBuffers();
+        _indexBufferDirty = false;
+
+        // The points of the last job were computed for the previous resolution. Nothing
+        // is rendered until the first points for the new resolution are available
+        _report = TrailOrbitSampler::UpdateReport();
+        _primaryRenderInformation.first = 0;
+        _primaryRenderInformation.count = 0;
     }
     else {
-        // Otherwise we need to check how many values have been changed
-        if (report.nUpdated == UpdateReport::All) {
-            // If all of the values have been invalidated, we need to upload the entire
-            // array
-            glBufferData(
-                GL_ARRAY_BUFFER,
-                _vertexArray.size() * sizeof(TrailVBOLayout),
-                _vertexArray.data(),
-                GL_STREAM_DRAW
-            );
-
-            if (_indexBufferDirty) {
-                // We only need to upload the index buffer if it has been invalidated
-                // by changing the number of values we want to represent
-                glBindBuffer(
-                    GL_ELEMENT_ARRAY_BUFFER,
-                    _primaryRenderInformation._iBufferID
-                );
-                glBufferData(
-                    GL_ELEMENT_ARRAY_BUFFER,
-                    _indexArray.size() * sizeof(unsigned int),
-                    _indexArray.data(),
-                    GL_STATIC_DRAW
-                );
-                _indexBufferDirty = false;
-            }
-        }
-        else {
-            // The lambda expression that will upload parts of the array starting at
-            // begin and containing length number of elements
-            auto upload = [this](int begin, int length) {
-                glBufferSubData(
-                    GL_ARRAY_BUFFER,
-                    begin * sizeof(TrailVBOLayout),
-                    sizeof(TrailVBOLayout) * length,
-                    _vertexArray.data() + begin
-                );
-            };
-
-            // Only update the changed ones
-            // Since we are using a ring buffer, the number of updated needed might be
-            // bigger than our current points, which means we have to split the upload
-            // into two calls.
-            if (report.nUpdated > 0) {
-                // deltaT is positive, so the pointer is moving backwards and update has
-                // to happen towards the front
-
-                // Starting index
-                const int i = _primaryRenderInformation.first;
-                // Number of values
-                const int n = report.nUpdated + 1; // +1 for the floating position
-                // Total size of the array
-                const int s = _primaryRenderInformation.count;
-
-                if (i + n <= s) {
-                    // The current index is small enough to just use one upload call
-                    upload(i, n);
-                }
-                else {
-                    // The current index is too close to the wrap around part, so we need
-                    // to split the upload into two parts:
-                    // 1. from the current index to the end of the array
-                    // 2. the rest starting from the beginning of the array
-                    const int first = s - i;
-                    const int second = n - first;
-                    upload(i, first);  // 1
-                    upload(0, second); // 2
-                }
-            }
-            else {
-                // deltaT is negative, so the pointer is moving forwards
-
-                // The current index
-                const int i = _primaryRenderInformation.first;
-                // Number of values
-                const int n = std::abs(report.nUpdated) + 1; // +1 for the floating pos
-                // Total size of the array
-                const int s = _primaryRenderInformation.count;
-
-                if (i + 1 >= n) {
-                    // The current index is big enough to fit everything into one call
-                    upload(i+1 - n, n);
-                }
-                else {
-                    // The current index is too close to the beginning of the array, so we
-                    // need to split the upload into two parts:
-                    // 1. from the beginning of the array to the current index
-                    // 2. filling the back of the array with the rest
-                    const int b = n - (i + 1);
-                    upload(0, i + 1); // 1
-                    upload(s-b, b);   // 2
-                }
-            }
-        }
+        publishSampledPoints();
     }
 
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+    // 3
+    const double time = data.time.j2000Seconds();
+    if (_needsFullSweep) {
+        _sampler.setPeriod(_period);
+        _sampler.setResolution(_resolution);
+        _needsFullSweep = false;
+        startSampling(time);
+    }
+    else if (hasChanged || time != _sampledTime) {
+        startSampling(time);
+    }
 
-    glBindVertexArray(0);
+    // 4
+    // The job only changes the sampler, so the upload can happen while it is running
+    uploadToNextRegion();
 }
 
-RenderableTrailOrbit::UpdateReport RenderableTrailOrbit::updateTrails(
-                                                                   const UpdateData& data)
-{
-    if (_needsFullSweep) {
-        fullSweep(data.time.j2000Seconds());
-        return { false, true, UpdateReport::All } ;
+void RenderableTrailOrbit::startSampling(double time) {
+    {
+        std::lock_guard<std::mutex> lock(_samplingMutex);
+        _isSampling = true;
     }
+    _sampledTime = time;
 
+    global::threadPool.enqueue([this, time]() {
+        using Clock = TrailOrbitSampler::Clock;
+        TrailOrbitSampler::UpdateReport report;
+        try {
+            report = _sampler.update(time, Clock::now() + SweepBudget);
+        }
+        catch (const ghoul::RuntimeError& e) {
+            LERRORC(e.component, e.message);
+            // The ring buffer might have been changed only partially
+            _sampler.invalidate();
+        }
+        catch (const std::exception& e) {
+            LERROR(e.what());
+            _sampler.invalidate();
+        }
 
-    constexpr const double Epsilon = 1e-7;
-    // When time stands still (at the iron hill), we don't need to perform any work
-    if (std::abs(data.time.j2000Seconds() - _previousTime) < Epsilon) {
-        return { false, false, 0 };
-    }
+        std::lock_guard<std::mutex> lock(_samplingMutex);
+        _report = report;
+        _isSampling = false;
+        _samplingFinished.notify_all();
+    });
+}
 
-    const double secondsPerPoint = _period / (_resolution - 1);
-    // How much time has passed since the last permanent point
-    const double delta = data.time.j2000Seconds() - _lastPointTime;
+void RenderableTrailOrbit::waitForSampling() {
+    std::unique_lock<std::mutex> lock(_samplingMutex);
+    _samplingFinished.wait(lock, [this]() { return !_isSampling; });
+}
 
-    // We'd like to test for equality with 0 here, but due to rounding issues, we won't
-    // get there. If this check is not here, we will trigger the positive or negative
-    // branch below even though we don't have to
-    //
-    // This might become a bigger issue if we are starting to look at very short time
-    // intervals
+void RenderableTrailOrbit::publishSampledPoints() {
+    static_assert(
+        sizeof(glm::vec3) == sizeof(TrailVBOLayout),
+        "The points are copied directly into the vertex array"
+    );
 
-    if (std::abs(delta) < Epsilon) {
-        return { false, false, 0 };
+    // Since we are using a ring buffer, the changed points might be split into multiple
+    // ranges. Each region receives the ranges when it is written the next time
+    const std::vector<glm::vec3>& points = _sampler.points();
+    for (int i = 0; i < _report.nRanges; ++i) {
+        const TrailOrbitSampler::Range& r = _report.ranges[i];
+        std::memcpy(
+            _vertexArray.data() + r.begin,
+            points.data() + r.begin,
+            r.length * sizeof(TrailVBOLayout)
+        );
+        for (BufferRegion& region : _regions) {
+            region.dirtyRanges.push_back(r);
+        }
     }
+    _report = TrailOrbitSampler::UpdateReport();
 
-    if (delta > 0.0) {
-        // Check whether we need to drop a new permanent point. This is only the case if
-        // enough (> secondsPerPoint) time has passed since the last permanent point
-        if (std::abs(delta) < secondsPerPoint) {
-            return { true, false, 0 };
-        }
+    _primaryRenderInformation.first = _sampler.first();
+    _primaryRenderInformation.count = _sampler.count();
+}
 
-        // See how many points we need to drop
-        const int nNewPoints = static_cast<int>(floor(delta / secondsPerPoint));
+void RenderableTrailOrbit::uploadToNextRegion() {
+    // Do not do anything if the region that is rendered is up to date. Every region is
+    // written at least every NBufferRegions uploads, which limits the number of ranges
+    // that can accumulate in a region
+    if (!_mappedVertices || _regions[_currentRegion].dirtyRanges.empty()) {
+        return;
+    }
 
-        // If we would need to generate more new points than there are total points in the
-        // array, it is faster to regenerate the entire array
-        if (nNewPoints >= _resolution) {
-            fullSweep(data.time.j2000Seconds());
-            return { false, true, UpdateReport::All };
-        }
+    const int next = (_currentRegion + 1) % NBufferRegions;
+    BufferRegion& region = _regions[next];
+    waitForRegion(region);
+
+    TrailVBOLayout* vertices = _mappedVertices + next * _regionSize;
+    for (const TrailOrbitSampler::Range& r : region.dirtyRanges) {
+        std::memcpy(
+            vertices + r.begin,
+            _vertexArray.data() + r.begin,
+            r.length * sizeof(TrailVBOLayout)
+        );
+    }
+    region.dirtyRanges.clear();
 
-        for (int i = 0; i < nNewPoints; ++i) {
-            _lastPointTime += secondsPerPoint;
-
-            // Get the new permanent point and write it into the (previously) floating
-            // location
-            const glm::vec3 p = _translation->position({
-                {},
-                _lastPointTime,
-                0.0,
-                false
-            });
-            _vertexArray[_primaryRenderInformation.first] = { p.x, p.y, p.z };
-
-            // Move the current pointer back one step to be used as the new floating
-            // location
-            --_primaryRenderInformation.first;
-            // And loop around if necessary
-            if (_primaryRenderInformation.first < 0) {
-                _primaryRenderInformation.first += _primaryRenderInformation.count;
-            }
-        }
+    // The buffer is mapped coherently, so the writes are visible to the following draw
+    // call without flushing them
+    glBindVertexArray(_primaryRenderInformation._vaoID);
+    glBindBuffer(GL_ARRAY_BUFFER, _primaryRenderInformation._vBufferID);
+    glVertexAttribPointer(
+        0,
+        3,
+        GL_FLOAT,
+        GL_FALSE,
+        0,
+        reinterpret_cast<void*>(next * _regionSize * sizeof(TrailVBOLayout))
+    );
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
 
-        // The previously oldest permanent point has been moved nNewPoints steps into the
-        // future
-        _firstPointTime += nNewPoints * secondsPerPoint;
+    _currentRegion = next;
+}
 
-        return { false, true, nNewPoints };
+void RenderableTrailOrbit::waitForRegion(BufferRegion& region) {
+    if (!region.fence) {
+        return;
     }
-    else {
-        // See how many new points needs to be generated. Delta is negative, so we need
-        // to invert the ratio
-        const int nNewPoints = -(static_cast<int>(floor(delta / secondsPerPoint)));
-
-        // If we would need to generate more new points than there are total points in the
-        // array, it is faster to regenerate the entire array
-        if (nNewPoints >= _resolution) {
-            fullSweep(data.time.j2000Seconds());
-            return { false, true, UpdateReport::All };
-        }
-
-        for (int i = 0; i < nNewPoints; ++i) {
-            _firstPointTime -= secondsPerPoint;
-
-            // Get the new permanent point and write it into the (previously) floating
-            // location
-            const glm::vec3 p = _translation->position({
-                {},
-                _firstPointTime,
-                0.0,
-                false
-            });
-            _vertexArray[_primaryRenderInformation.first] = { p.x, p.y, p.z };
-
-            // if we are on the upper bounds of the array, we start at 0
-            if (_primaryRenderInformation.first == _primaryRenderInformation.count - 1) {
-                // If it is at the beginning, set it to the end first
-                _primaryRenderInformation.first = 0;
-            }
-            else {
-                // Move the current pointer fowards one step  to be used as the new
-                // floating
-                ++_primaryRenderInformation.first;
-            }
-        }
 
-        // The previously youngest point has become nNewPoints steps older
-        _lastPointTime -= nNewPoints * secondsPerPoint;
+    GLenum status = GL_TIMEOUT_EXPIRED;
+    do {
+        status = glClientWaitSync(region.fence, GL_SYNC_FLUSH_COMMANDS_BIT, FenceTimeout);
+    } while (status == GL_TIMEOUT_EXPIRED);
 
-        return { false, true, -nNewPoints };
+    if (status == GL_WAIT_FAILED) {
+        // Without the fence, the only way to be sure that the GPU is done with the
+        // region is to wait for all commands
+        LERROR("Waiting for the rendering of the trail failed");
+        glFinish();
     }
+    glDeleteSync(region.fence);
+    region.fence = nullptr;
 }
 
-void RenderableTrailOrbit::fullSweep(double time) {
-    // Reserve the space for the vertices
-    _vertexArray.clear();
-    _vertexArray.resize(_resolution);
+void RenderableTrailOrbit::createBuffers() {
+    // The storage of the vertex buffer is immutable, so it has to be recreated
+    deleteVertexBuffer();
 
-    // The index buffer stays constant until we change the size of the array
-    if (_indexBufferDirty) {
-        // Create the index buffer and fill it with two ranges for [0, _resolution)
-        _indexArray.clear();
-        _indexArray.resize(_resolution * 2);
-        std::iota(_indexArray.begin(), _indexArray.begin() + _resolution, 0);
-        std::iota(_indexArray.begin() + _resolution, _indexArray.end(), 0);
+    _regionSize = _resolution;
+    _vertexArray.assign(_regionSize, { 0.f, 0.f, 0.f });
+    for (BufferRegion& region : _regions) {
+        region.dirtyRanges = { { 0, _regionSize } };
     }
+    _currentRegion = 0;
 
-    _lastPointTime = time;
-
-    const double secondsPerPoint = _period / (_resolution - 1);
-    // starting at 1 because the first position is a floating current one
-    for (int i = 1; i < _resolution; ++i) {
-        const glm::vec3 p = _translation->position({ {}, time, 0.0, false });
-        _vertexArray[i] = { p.x, p.y, p.z };
+    glBindVertexArray(_primaryRenderInformation._vaoID);
 
-        time -= secondsPerPoint;
+    const GLsizeiptr size = NBufferRegions * _regionSize * sizeof(TrailVBOLayout);
+    glGenBuffers(1, &_primaryRenderInformation._vBufferID);
+    glBindBuffer(GL_ARRAY_BUFFER, _primaryRenderInformation._vBufferID);
+    glBufferStorage(
+        GL_ARRAY_BUFFER,
+        size,
+        nullptr,
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT
+    );
+    _mappedVertices = reinterpret_cast<TrailVBOLayout*>(glMapBufferRange(
+        GL_ARRAY_BUFFER,
+        0,
+        size,
+        GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT
+    ));
+    if (!_mappedVertices) {
+        LERROR("Failed to map the vertex buffer");
     }
 
-    _primaryRenderInformation.first = 0;
-    _primaryRenderInformation.count = _resolution;
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _primaryRenderInformation._iBufferID);
+    glBufferData(
+        GL_ELEMENT_ARRAY_BUFFER,
+        _indexArray.size() * sizeof(unsigned int),
+        _indexArray.data(),
+        GL_STATIC_DRAW
+    );
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void RenderableTrailOrbit::deleteVertexBuffer() {
+    for (BufferRegion& region : _regions) {
+        if (region.fence) {
+            glDeleteSync(region.fence);
+            region.fence = nullptr;
+        }
+    }
 
-    _firstPointTime = time + secondsPerPoint;
-    _needsFullSweep = false;
+    if (_mappedVertices) {
+        glBindBuffer(GL_ARRAY_BUFFER, _primaryRenderInformation._vBufferID);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        _mappedVertices = nullptr;
+    }
+    if (_primaryRenderInformation._vBufferID != 0) {
+        glDeleteBuffers(1, &_primaryRenderInformation._vBufferID);
+        _primaryRenderInformation._vBufferID = 0;
+    }
 }
 
 } // namespace openspace
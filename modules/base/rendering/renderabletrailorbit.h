@@ -27,8 +27,14 @@
 
 #include <modules/base/rendering/renderabletrail.h>
 
+#include <modules/base/rendering/trailorbitsampler.h>
+
 #include <openspace/properties/scalar/doubleproperty.h>
 #include <openspace/properties/scalar/intproperty.h>
+#include <array>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
 
 namespace openspace {
 
@@ -43,65 +49,90 @@ namespace documentation { struct Documentation; }
  * are rendered. Each of these fixed points are fixed time steps apart, where as the most
  * current point is floating and updated every frame. The _period determines the length of
  * the trail (the distance between the newest and oldest point being _period days).
+ *
+ * The points are computed by a TrailOrbitSampler in a job on the global thread pool,
+ * which only samples the Translation for a limited time before it hands the changed
+ * ranges of the ring buffer to the render thread. The vertex buffer is persistently
+ * mapped and split into multiple regions, so that the changed ranges can be written
+ * into one region while the GPU might still be drawing from another.
  */
 class RenderableTrailOrbit : public RenderableTrail {
 public:
     explicit RenderableTrailOrbit(const ghoul::Dictionary& dictionary);
+    ~RenderableTrailOrbit();
 
     void initializeGL() override;
     void deinitializeGL() override;
 
+    void render(const RenderData& data, RendererTasks& rendererTask) override;
     void update(const UpdateData& data) override;
 
     static documentation::Documentation Documentation();
 
 private:
-    /**
-     * Performs a full sweep of the orbit and fills the entire vertex buffer object.
-     * \param time The current time up to which the full sweep should be performed
-     */
-    void fullSweep(double time);
-
-    /// This structure is returned from the #updateTrails method and gives information
-    /// about which parts of the vertex array to update
-    struct UpdateReport {
-        static const int All = 0; ///< The entire array was touched in the update
-        /// If \c true the floating point needs to be updated
-        bool floatingPointNeedsUpdate;
-        /// If \c true at least one of their permanent point were touched
-        bool permanentPointsNeedUpdate;
-        /// Returns the number of fixed points that were touched in the update method
-        /// If this value is negative, the newest values were replaced, if positive the
-        /// oldest
-        int nUpdated;
+    /// The number of copies of the trail in the vertex buffer
+    static constexpr const int NBufferRegions = 3;
+
+    /// One copy of the trail in the vertex buffer
+    struct BufferRegion {
+        /// Signalled when the GPU has finished the last draw call using this region
+        GLsync fence = nullptr;
+        /// The ranges of the ring buffer that have changed since the region was written
+        std::vector<TrailOrbitSampler::Range> dirtyRanges;
     };
-    /**
-     * Updates the trail based on the new incoming UpdateData information. This function
-     * might update an arbitrary number of values in the vertex buffer and returns an
-     * UpdateReport that will tell the #update method how many values were modified.
-     * \param data The UpdateData struct that comes from the #update method
-     * \return The UpdateReport containing information which array parts were touched
-     */
-    UpdateReport updateTrails(const UpdateData& data);
+
+    /// (Re)creates the vertex and index buffers for the current resolution
+    void createBuffers();
+    /// Unmaps and deletes the vertex buffer together with the fences of its regions
+    void deleteVertexBuffer();
+
+    /// Starts a job on the global thread pool that moves the sampler to the \p time
+    void startSampling(double time);
+    /// Blocks until the currently running sampling job has finished
+    void waitForSampling();
+    /// Copies the points that were changed by the last sampling job into _vertexArray
+    /// and marks them as dirty in all regions
+    void publishSampledPoints();
+
+    /// Writes the dirty ranges into the region following the current one and renders
+    /// from that region afterwards
+    void uploadToNextRegion();
+    /// Blocks until the GPU has finished drawing from the \p region
+    void waitForRegion(BufferRegion& region);
 
     /// The orbital period of the RenderableTrail in days
     properties::DoubleProperty _period;
     /// The number of points that should be sampled between _period and now
     properties::IntProperty _resolution;
 
-    /// A dirty flag that determines whether a full sweep (recomputing of all values)
-    /// is necessary
+    /// Computes the points of the trail and keeps track of the changed parts. While a
+    /// sampling job is running, it is only accessed by that job
+    TrailOrbitSampler _sampler;
+    /// Set when the period, resolution, or the Translation changes. The changes are
+    /// passed on to the _sampler before the next sampling job is started
     bool _needsFullSweep = true;
+
+    /// Protects _isSampling and _report, which are written by the sampling job
+    std::mutex _samplingMutex;
+    /// Notified when a sampling job has finished
+    std::condition_variable _samplingFinished;
+    bool _isSampling = false;
+    /// The ranges of the ring buffer that were changed by the last sampling job
+    TrailOrbitSampler::UpdateReport _report;
+    /// The time to which the last sampling job moved the trail
+    double _sampledTime = 0.0;
+
+    std::array<BufferRegion, NBufferRegions> _regions;
+    /// The region that is currently used for rendering
+    int _currentRegion = 0;
+    /// The number of vertices in each region
+    int _regionSize = 0;
+    /// The persistently mapped vertex buffer containing all regions
+    TrailVBOLayout* _mappedVertices = nullptr;
+
     /// A dirty flag to determine whether the index buffer needs to be regenerated and
     /// then reuploaded
     bool _indexBufferDirty = true;
-
-    /// The time stamp of the oldest point in the array
-    double _firstPointTime = 0.0;
-    /// The time stamp of the newest fixed point in the array
-    double _lastPointTime = 0.0;
-    /// The time stamp of when the last valid trail was generated.
-    double _previousTime = 0.0;
 };
 
 } // namespace openspace
@@ -0,0 +1,270 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <modules/base/rendering/trailorbitsampler.h>
+
+#include <cmath>
+
+namespace {
+    // We'd like to test for equality with 0, but due to rounding issues, we won't get
+    // there. This might become a bigger issue if we are starting to look at very short
+    // time intervals
+    constexpr const double Epsilon = 1e-7;
+} // namespace
+
+namespace openspace {
+
+TrailOrbitSampler::TrailOrbitSampler(PositionFunction position)
+    : _position(std::move(position))
+{}
+
+void TrailOrbitSampler::setPeriod(double period) {
+    _period = period;
+    _needsFullSweep = true;
+}
+
+void TrailOrbitSampler::setResolution(int resolution) {
+    _resolution = resolution;
+    _needsFullSweep = true;
+}
+
+void TrailOrbitSampler::invalidate() {
+    _needsFullSweep = true;
+}
+
+TrailOrbitSampler::UpdateReport TrailOrbitSampler::update(double time,
+                                                          Clock::time_point deadline)
+{
+    UpdateReport report;
+
+    if (_needsFullSweep) {
+        startSweep(time);
+    }
+
+    if (_isSweeping) {
+        // If the time has moved away by more than the length of the trail, the points
+        // that have been computed so far are no longer needed
+        if (std::abs(time - _lastPointTime) > _period) {
+            startSweep(time);
+        }
+
+        // During a full sweep, the floating point stays at the beginning of the array
+        // and the newly computed points are appended behind the valid ones
+        const int firstSweptPoint = _count;
+        continueSweep(deadline);
+        _points[_first] = _position(time);
+        report.ranges[report.nRanges++] = { 0, 1 };
+        if (_count > firstSweptPoint) {
+            const int nSwept = _count - firstSweptPoint;
+            report.ranges[report.nRanges++] = { firstSweptPoint, nSwept };
+        }
+        _previousTime = time;
+        return report;
+    }
+
+    const double secondsPerPoint = _period / (_resolution - 1);
+    // How much time has passed since the last permanent point
+    const double delta = time - _lastPointTime;
+
+    // When time stands still (at the iron hill), we don't need to perform any work,
+    // unless points are still missing because a previous update ran past its deadline
+    const bool isCaughtUp = delta > -Epsilon && delta < secondsPerPoint;
+    if (std::abs(time - _previousTime) < Epsilon && isCaughtUp) {
+        return report;
+    }
+    _previousTime = time;
+
+    if (std::abs(delta) < Epsilon) {
+        return report;
+    }
+
+    if (delta > 0.0) {
+        // Check whether we need to drop a new permanent point. This is only the case if
+        // enough (> secondsPerPoint) time has passed since the last permanent point
+        if (delta < secondsPerPoint) {
+            _points[_first] = _position(time);
+            report.ranges[report.nRanges++] = { _first, 1 };
+            return report;
+        }
+
+        // See how many points we need to drop
+        const int nNewPoints = static_cast<int>(std::floor(delta / secondsPerPoint));
+
+        // If we would need to generate more new points than there are total points in the
+        // array, it is faster to regenerate the entire array
+        if (nNewPoints >= _resolution) {
+            _needsFullSweep = true;
+            return update(time, deadline);
+        }
+
+        // If the deadline passes, the remaining points are added in the next calls
+        int nAdded = 0;
+        for (; nAdded < nNewPoints; ++nAdded) {
+            if (nAdded > 0 && Clock::now() > deadline) {
+                break;
+            }
+            _lastPointTime += secondsPerPoint;
+
+            // Write the new permanent point into the (previously) floating location and
+            // move the floating location back one step, looping around if necessary
+            _points[_first] = _position(_lastPointTime);
+            --_first;
+            if (_first < 0) {
+                _first += _count;
+            }
+        }
+
+        // The previously oldest permanent point has been moved nAdded steps into the
+        // future
+        _firstPointTime += nAdded * secondsPerPoint;
+
+        _points[_first] = _position(time);
+        addChangedRange(report, nAdded);
+    }
+    else {
+        // See how many new points needs to be generated. Delta is negative, so we need
+        // to invert the ratio
+        const int nNewPoints = -(static_cast<int>(std::floor(delta / secondsPerPoint)));
+
+        // If we would need to generate more new points than there are total points in the
+        // array, it is faster to regenerate the entire array
+        if (nNewPoints >= _resolution) {
+            _needsFullSweep = true;
+            return update(time, deadline);
+        }
+
+        // If the deadline passes, the remaining points are added in the next calls
+        int nAdded = 0;
+        for (; nAdded < nNewPoints; ++nAdded) {
+            if (nAdded > 0 && Clock::now() > deadline) {
+                break;
+            }
+            _firstPointTime -= secondsPerPoint;
+
+            // Write the new permanent point into the (previously) floating location and
+            // move the floating location forwards one step, looping around if necessary
+            _points[_first] = _position(_firstPointTime);
+            _first = (_first == _count - 1) ? 0 : _first + 1;
+        }
+
+        // The previously youngest point has become nAdded steps older
+        _lastPointTime -= nAdded * secondsPerPoint;
+
+        _points[_first] = _position(time);
+        addChangedRange(report, -nAdded);
+    }
+    return report;
+}
+
+void TrailOrbitSampler::addChangedRange(UpdateReport& report, int nUpdated) const {
+    // Since we are using a ring buffer, the range of changed points might wrap around
+    // the end of the array, in which case it is split into two ranges
+    const int s = _count;
+    if (nUpdated > 0) {
+        // The floating point moved backwards, so the changed points are the floating
+        // point and the ones following it
+        const int n = nUpdated + 1;
+        if (_first + n <= s) {
+            report.ranges[report.nRanges++] = { _first, n };
+        }
+        else {
+            report.ranges[report.nRanges++] = { _first, s - _first };
+            report.ranges[report.nRanges++] = { 0, n - (s - _first) };
+        }
+    }
+    else {
+        // The floating point moved forwards, so the changed points are the floating
+        // point and the ones preceding it
+        const int n = -nUpdated + 1;
+        if (_first + 1 >= n) {
+            report.ranges[report.nRanges++] = { _first + 1 - n, n };
+        }
+        else {
+            const int b = n - (_first + 1);
+            report.ranges[report.nRanges++] = { 0, _first + 1 };
+            report.ranges[report.nRanges++] = { s - b, b };
+        }
+    }
+}
+
+void TrailOrbitSampler::startSweep(double time) {
+    _points.assign(_resolution, glm::vec3(0.f));
+    _lastPointTime = time;
+
+    // Until the sweep is finished, only the floating position and the points that have
+    // been computed so far are valid
+    _first = 0;
+    _count = 1;
+
+    _needsFullSweep = false;
+    _isSweeping = true;
+}
+
+void TrailOrbitSampler::continueSweep(Clock::time_point deadline) {
+    const double secondsPerPoint = _period / (_resolution - 1);
+
+    // Starting at the newest point directly behind the floating one, which has the same
+    // time as the floating position had when the sweep was started
+    const int first = _count;
+    double time = _lastPointTime - (_count - 1) * secondsPerPoint;
+    for (; _count < _resolution; ++_count) {
+        // At least one point is computed per call so that the sweep always finishes
+        if (_count > first && Clock::now() > deadline) {
+            return;
+        }
+
+        _points[_count] = _position(time);
+        time -= secondsPerPoint;
+    }
+
+    _firstPointTime = time + secondsPerPoint;
+    _isSweeping = false;
+}
+
+const std::vector<glm::vec3>& TrailOrbitSampler::points() const {
+    return _points;
+}
+
+int TrailOrbitSampler::first() const {
+    return _first;
+}
+
+int TrailOrbitSampler::count() const {
+    return _count;
+}
+
+double TrailOrbitSampler::firstPointTime() const {
+    return _firstPointTime;
+}
+
+double TrailOrbitSampler::lastPointTime() const {
+    return _lastPointTime;
+}
+
+bool TrailOrbitSampler::isSweeping() const {
+    return _isSweeping;
+}
+
+} // namespace openspace
@@ -0,0 +1,136 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_MODULE_BASE___TRAILORBITSAMPLER___H__
+#define __OPENSPACE_MODULE_BASE___TRAILORBITSAMPLER___H__
+
+#include <ghoul/glm.h>
+#include <array>
+#include <chrono>
+#include <functional>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * Keeps the points of an orbit-like trail in a ring buffer and computes new points as
+ * the time changes. This is the part of the RenderableTrailOrbit that does not depend
+ * on OpenGL; the layout of the ring buffer is described in renderabletrailorbit.cpp.
+ *
+ * Computing a position can be expensive, so new points are only computed until a
+ * deadline has passed and the remaining points are computed in the following calls to
+ * #update. If the entire trail has to be recomputed, for example after a large jump in
+ * time, the trail is filled from the newest to the oldest point in a full sweep.
+ */
+class TrailOrbitSampler {
+public:
+    using Clock = std::chrono::high_resolution_clock;
+    using PositionFunction = std::function<glm::vec3(double)>;
+
+    /// A range of consecutive points in the ring buffer
+    struct Range {
+        int begin;
+        int length;
+    };
+
+    /// The ranges of the ring buffer that were changed by a call to #update
+    struct UpdateReport {
+        std::array<Range, 3> ranges;
+        int nRanges = 0;
+    };
+
+    /**
+     * \param position The function that returns the position of the object at a time
+     *        given in seconds past the J2000 epoch
+     */
+    explicit TrailOrbitSampler(PositionFunction position);
+
+    /// Sets the length of the trail in seconds and starts a full sweep
+    void setPeriod(double period);
+
+    /// Sets the number of points in the trail and starts a full sweep
+    void setResolution(int resolution);
+
+    /// Starts a full sweep in the next call to #update
+    void invalidate();
+
+    /**
+     * Moves the trail to the \p time. New points are computed until the \p deadline
+     * has passed, but at least one point is computed if any are missing.
+     * \return The ranges of the ring buffer that have changed and need to be uploaded
+     */
+    UpdateReport update(double time, Clock::time_point deadline);
+
+    /// The ring buffer of points; the size is equal to the resolution
+    const std::vector<glm::vec3>& points() const;
+
+    /// The index of the floating point in the ring buffer
+    int first() const;
+
+    /// The number of valid points, which is only smaller than the resolution while a
+    /// full sweep is in progress
+    int count() const;
+
+    /// The time of the oldest point
+    double firstPointTime() const;
+
+    /// The time of the newest fixed point
+    double lastPointTime() const;
+
+    /// Whether a full sweep has been started but not all points have been computed yet
+    bool isSweeping() const;
+
+private:
+    void startSweep(double time);
+    void continueSweep(Clock::time_point deadline);
+
+    /// Adds the range of the \p nUpdated fixed points that were touched together with
+    /// the floating point. A negative \p nUpdated denotes that the oldest points were
+    /// replaced, a positive one that the newest points were replaced
+    void addChangedRange(UpdateReport& report, int nUpdated) const;
+
+    PositionFunction _position;
+    double _period = 0.0;
+    int _resolution = 2;
+
+    std::vector<glm::vec3> _points;
+    int _first = 0;
+    int _count = 0;
+
+    /// A dirty flag that determines whether a full sweep is necessary
+    bool _needsFullSweep = true;
+    bool _isSweeping = false;
+
+    /// The time stamp of the oldest point in the array
+    double _firstPointTime = 0.0;
+    /// The time stamp of the newest fixed point in the array
+    double _lastPointTime = 0.0;
+    /// The time stamp of the last update
+    double _previousTime = 0.0;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_BASE___TRAILORBITSAMPLER___H__
@@ -93,4 +93,8 @@ glm::dmat3 StaticRotation::matrix(const UpdateData&) const {
     return _rotationMatrix;
 }
 
+bool StaticRotation::isThreadSafe() const {
+    return true;
+}
+
 } // namespace openspace
@@ -58,6 +58,10 @@ double StaticScale::scaleValue(const UpdateData&) const {
     return _scaleValue;
 }
 
+bool StaticScale::isThreadSafe() const {
+    return true;
+}
+
 StaticScale::StaticScale() : _scaleValue(ScaleInfo, 1.0, 1.0, 1e6) {
     addProperty(_scaleValue);
 
@@ -0,0 +1,99 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/base/tasks/convertrecordingformattask.h>
+
+#include <openspace/documentation/verifier.h>
+#include <openspace/interaction/sessionrecording.h>
+#include <ghoul/fmt.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/logging/logmanager.h>
+
+namespace {
+    constexpr const char* _loggerCat = "ConvertRecordingFormatTask";
+
+    constexpr const char* KeyInput = "Input";
+    constexpr const char* KeyOutput = "Output";
+} // namespace
+
+namespace openspace {
+
+ConvertRecordingFormatTask::ConvertRecordingFormatTask(
+                                                      const ghoul::Dictionary& dictionary)
+{
+    openspace::documentation::testSpecificationAndThrow(
+        documentation(),
+        dictionary,
+        "ConvertRecordingFormatTask"
+    );
+
+    _inputPath = absPath(dictionary.value<std::string>(KeyInput));
+    _outputPath = absPath(dictionary.value<std::string>(KeyOutput));
+}
+
+std::string ConvertRecordingFormatTask::description() {
+    return fmt::format(
+        "Convert session recording {} to the indexed binary format in {}",
+        _inputPath, _outputPath
+    );
+}
+
+void ConvertRecordingFormatTask::perform(const Task::ProgressCallback& progressCallback)
+{
+    interaction::SessionRecording recording;
+    if (!recording.convertToIndexedFormat(_inputPath, _outputPath)) {
+        LERROR(fmt::format("Errors occurred while converting {}", _inputPath));
+    }
+    progressCallback(1.f);
+}
+
+documentation::Documentation ConvertRecordingFormatTask::documentation() {
+    using namespace documentation;
+    return {
+        "ConvertRecordingFormatTask",
+        "convert_recording_format_task",
+        {
+            {
+                "Type",
+                new StringEqualVerifier("ConvertRecordingFormatTask"),
+                Optional::No,
+                "The type of this task"
+            },
+            {
+                KeyInput,
+                new StringAnnotationVerifier("A file path to a session recording"),
+                Optional::No,
+                "The session recording in the ASCII or binary format to convert"
+            },
+            {
+                KeyOutput,
+                new StringAnnotationVerifier("A valid filepath"),
+                Optional::No,
+                "The file that the recording in the indexed binary format is written to"
+            }
+        }
+    };
+}
+
+} // namespace openspace
@@ -0,0 +1,122 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <modules/digitaluniverse/rendering/billboardsdataslice.h>
+
+#include <openspace/util/workstealingthreadpool.h>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+
+namespace {
+    // The objects are only distributed across the threads of the pool if there are at
+    // least this many objects per block, as the work would otherwise take less time
+    // than the synchronization
+    constexpr const size_t MinimumObjectsPerBlock = 64 * 1024;
+
+    // Calls func(begin, end) for blocks of the range [0, nObjects), either directly or
+    // on the threads of the pool
+    template <typename Func>
+    void forEachBlock(size_t nObjects, openspace::WorkStealingThreadPool* pool,
+                      Func func)
+    {
+        const size_t nBlocks = pool ?
+            std::min(nObjects / MinimumObjectsPerBlock, pool->numThreads() + 1) :
+            1;
+        if (nBlocks <= 1) {
+            func(size_t(0), nObjects);
+        }
+        else {
+            pool->parallelFor(nObjects, nBlocks, func);
+        }
+    }
+} // namespace
+
+namespace openspace::digitaluniverse {
+
+int colorBin(float value, float binSize, int nColors) {
+    if (nColors <= 1 || !(value < binSize * static_cast<float>(nColors))) {
+        // NaN values are treated as outliers as well
+        return 0;
+    }
+    const float bin = std::floor(value / binSize);
+    return static_cast<int>(std::clamp(bin, 1.f, static_cast<float>(nColors - 1)));
+}
+
+float slicePositions(const float* xs, const float* ys, const float* zs, size_t nObjects,
+                     const glm::dmat4& transformation, float unit, float* result,
+                     WorkStealingThreadPool* pool)
+{
+    const glm::dmat4& m = transformation;
+
+    std::mutex biggestCoordMutex;
+    float biggestCoord = -1.f;
+    forEachBlock(nObjects, pool, [&](size_t begin, size_t end) {
+        float* out = result + 4 * begin;
+        float biggestBlockCoord = -1.f;
+        // The matrix multiplication is written out so that the loop does not contain
+        // any branches and can be vectorized by the compiler
+        for (size_t i = begin; i < end; ++i) {
+            const double x = xs[i];
+            const double y = ys[i];
+            const double z = zs[i];
+            const float px = static_cast<float>(
+                m[0][0] * x + m[1][0] * y + m[2][0] * z + m[3][0]
+            );
+            const float py = static_cast<float>(
+                m[0][1] * x + m[1][1] * y + m[2][1] * z + m[3][1]
+            );
+            const float pz = static_cast<float>(
+                m[0][2] * x + m[1][2] * y + m[2][2] * z + m[3][2]
+            );
+            out[0] = px;
+            out[1] = py;
+            out[2] = pz;
+            out[3] = unit;
+            out += 4;
+            biggestBlockCoord = std::max({ biggestBlockCoord, px, py, pz, unit });
+        }
+
+        std::lock_guard<std::mutex> lock(biggestCoordMutex);
+        biggestCoord = std::max(biggestCoord, biggestBlockCoord);
+    });
+    return biggestCoord;
+}
+
+void sliceColors(const float* values, size_t nObjects, float binSize,
+                 const std::vector<glm::vec4>& colorMap, float* result,
+                 WorkStealingThreadPool* pool)
+{
+    const int nColors = static_cast<int>(colorMap.size());
+    forEachBlock(nObjects, pool, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            const glm::vec4& color = colorMap[colorBin(values[i], binSize, nColors)];
+            std::memcpy(result + 4 * i, &color[0], sizeof(glm::vec4));
+        }
+    });
+}
+
+} // namespace openspace::digitaluniverse
@@ -0,0 +1,67 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_MODULE_DIGITALUNIVERSE___BILLBOARDSDATASLICE___H__
+#define __OPENSPACE_MODULE_DIGITALUNIVERSE___BILLBOARDSDATASLICE___H__
+
+#include <ghoul/glm.h>
+#include <cstddef>
+#include <vector>
+
+namespace openspace { class WorkStealingThreadPool; }
+
+namespace openspace::digitaluniverse {
+
+/**
+ * Returns the index of the color in the color map for the provided value. The color map
+ * is divided into \p nColors bins of size \p binSize, starting at 0, where the first
+ * color is used for outliers above the last bin and the second color is also used for
+ * all values below the first bin. Apart from values that fall exactly onto a bin
+ * boundary, this produces the same colors as searching through the bins.
+ */
+int colorBin(float value, float binSize, int nColors);
+
+/**
+ * Transforms the positions given by \p xs, \p ys, and \p zs with the \p transformation
+ * and writes them together with the \p unit as four floats per object into \p result.
+ * If a \p pool is provided, large numbers of objects are processed on its threads.
+ *
+ * \return The largest of all written values
+ */
+float slicePositions(const float* xs, const float* ys, const float* zs, size_t nObjects,
+    const glm::dmat4& transformation, float unit, float* result,
+    WorkStealingThreadPool* pool);
+
+/**
+ * Writes the color from the \p colorMap for each of the \p values as four floats into
+ * \p result, using the #colorBin of each value. If a \p pool is provided, large numbers
+ * of objects are processed on its threads.
+ */
+void sliceColors(const float* values, size_t nObjects, float binSize,
+    const std::vector<glm::vec4>& colorMap, float* result, WorkStealingThreadPool* pool);
+
+} // namespace openspace::digitaluniverse
+
+#endif // __OPENSPACE_MODULE_DIGITALUNIVERSE___BILLBOARDSDATASLICE___H__
@@ -25,15 +25,19 @@
 #include <modules/digitaluniverse/rendering/renderablebillboardscloud.h>
 
 #include <modules/digitaluniverse/digitaluniversemodule.h>
+#include <modules/digitaluniverse/rendering/billboardsdataslice.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
 #include <openspace/engine/globals.h>
 #include <openspace/engine/windowdelegate.h>
 #include <openspace/util/updatestructures.h>
 #include <openspace/rendering/renderengine.h>
+#include <openspace/util/pointcatalogcache.h>
+#include <openspace/util/speckfile.h>
 #include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/misc/crc32.h>
+#include <ghoul/misc/exception.h>
 #include <ghoul/misc/templatefactory.h>
 #include <ghoul/io/texture/texturereader.h>
 #include <ghoul/logging/logmanager.h>
@@ -45,7 +49,9 @@
 #include <ghoul/font/fontrenderer.h>
 #include <ghoul/glm.h>
 #include <glm/gtx/string_cast.hpp>
+#include <algorithm>
 #include <array>
+#include <cmath>
 #include <fstream>
 #include <cstdint>
 #include <locale>
@@ -53,6 +59,7 @@
 
 namespace {
     constexpr const char* _loggerCat = "RenderableBillboardsCloud";
+
     constexpr const char* ProgramObjectName = "RenderableBillboardsCloud";
     constexpr const char* RenderToPolygonProgram = "RenderableBillboardsCloud_Polygon";
 
@@ -75,7 +82,7 @@ namespace {
     constexpr const char* GigaparsecUnit = "Gpc";
     constexpr const char* GigalightyearUnit = "Gly";
 
-    constexpr int8_t CurrentCacheVersion = 1;
+    constexpr uint32_t CurrentCacheVersion = 2;
     constexpr double PARSEC = 0.308567756E17;
 
     constexpr openspace::properties::Property::PropertyInfo SpriteTextureInfo = {
@@ -499,7 +506,7 @@ RenderableBillboardsCloud::RenderableBillboardsCloud(const ghoul::Dictionary& di
             }
         }
         _colorOption.onChange([&] {
-            _dataIsDirty = true;
+            _colorDataIsDirty = true;
             _colorOptionString = _optionConversionMap[_colorOption.value()];
         });
         addProperty(_colorOption);
@@ -624,7 +631,7 @@ RenderableBillboardsCloud::RenderableBillboardsCloud(const ghoul::Dictionary& di
 }
 
 bool RenderableBillboardsCloud::isReady() const {
-    return ((_program != nullptr) && (!_fullData.empty())) || (!_labelData.empty());
+    return ((_program != nullptr) && (_catalog.nRows() > 0)) || (!_labelData.empty());
 }
 
 void RenderableBillboardsCloud::initialize() {
@@ -687,6 +694,8 @@ void RenderableBillboardsCloud::initializeGL() {
 void RenderableBillboardsCloud::deinitializeGL() {
     glDeleteBuffers(1, &_vbo);
     _vbo = 0;
+    glDeleteBuffers(1, &_colorVbo);
+    _colorVbo = 0;
     glDeleteVertexArrays(1, &_vao);
     _vao = 0;
 
@@ -792,8 +801,7 @@ void RenderableBillboardsCloud::renderBillboards(const RenderData& data,
     _program->setUniform(_uniformCache.hasColormap, _hasColorMapFile);
 
     glBindVertexArray(_vao);
-    const GLsizei nAstronomicalObjects = static_cast<GLsizei>(_fullData.size() /
-        _nValuesPerAstronomicalObject);
+    const GLsizei nAstronomicalObjects = static_cast<GLsizei>(_catalog.nRows());
     glDrawArrays(GL_POINTS, 0, nAstronomicalObjects);
 
     glBindVertexArray(0);
@@ -978,48 +986,27 @@ void RenderableBillboardsCloud::update(const UpdateData&) {
         glBufferData(
             GL_ARRAY_BUFFER,
             size * sizeof(float),
-            &_slicedData[0],
+            _slicedData.data(),
             GL_STATIC_DRAW
         );
         GLint positionAttrib = _program->attributeLocation("in_position");
+        glEnableVertexAttribArray(positionAttrib);
+        glVertexAttribPointer(positionAttrib, 4, GL_FLOAT, GL_FALSE, 0, nullptr);
 
         if (_hasColorMapFile) {
-            /*const size_t nAstronomicalObjects = _fullData.size() /
-            _nValuesPerAstronomicalObject;
-            const size_t nValues = _slicedData.size() / nAstronomicalObjects;
-            GLsizei stride = static_cast<GLsizei>(sizeof(float) * nValues);*/
-
-            glEnableVertexAttribArray(positionAttrib);
-            glVertexAttribPointer(
-                positionAttrib,
-                4,
-                GL_FLOAT,
-                GL_FALSE,
-                sizeof(float) * 8,
-                nullptr
-            );
-
+            // The colors are stored in a separate buffer so that they can be replaced
+            // without touching the positions when the color option changes
+            if (_colorVbo == 0) {
+                glGenBuffers(1, &_colorVbo);
+                LDEBUG(fmt::format(
+                    "Generating Vertex Buffer Object id '{}'", _colorVbo
+                ));
+            }
+            glBindBuffer(GL_ARRAY_BUFFER, _colorVbo);
             GLint colorMapAttrib = _program->attributeLocation("in_colormap");
             glEnableVertexAttribArray(colorMapAttrib);
-            glVertexAttribPointer(
-                colorMapAttrib,
-                4,
-                GL_FLOAT,
-                GL_FALSE,
-                sizeof(float) * 8,
-                reinterpret_cast<void*>(sizeof(float) * 4)
-            );
-        }
-        else {
-            glEnableVertexAttribArray(positionAttrib);
-            glVertexAttribPointer(
-                positionAttrib,
-                4,
-                GL_FLOAT,
-                GL_FALSE,
-                0,
-                nullptr
-            );
+            glVertexAttribPointer(colorMapAttrib, 4, GL_FLOAT, GL_FALSE, 0, nullptr);
+            _colorDataIsDirty = true;
         }
 
         glBindVertexArray(0);
@@ -1027,6 +1014,23 @@ void RenderableBillboardsCloud::update(const UpdateData&) {
         _dataIsDirty = false;
     }
 
+    if (_colorDataIsDirty && _hasSpeckFile && _hasColorMapFile && _colorVbo != 0) {
+        LDEBUG("Regenerating color data");
+
+        createColorDataSlice();
+
+        glBindBuffer(GL_ARRAY_BUFFER, _colorVbo);
+        glBufferData(
+            GL_ARRAY_BUFFER,
+            _slicedColorData.size() * sizeof(float),
+            _slicedColorData.data(),
+            GL_STATIC_DRAW
+        );
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        _colorDataIsDirty = false;
+    }
+
     if (_hasSpriteTexture && _spriteTextureIsDirty && !_spriteTexturePath.value().empty())
     {
         ghoul::opengl::Texture* t = _spriteTexture;
@@ -1071,174 +1075,153 @@ bool RenderableBillboardsCloud::loadData() {
 }
 
 bool RenderableBillboardsCloud::loadSpeckData() {
-    bool success = true;
-    if (_hasSpeckFile) {
-        const std::string& cachedFile = FileSys.cacheManager()->cachedFilename(
-            ghoul::filesystem::File(_speckFile),
-            "RenderableDUMeshes|" + identifier(),
-            ghoul::filesystem::CacheManager::Persistent::Yes
-        );
+    if (!_hasSpeckFile) {
+        return true;
+    }
 
-        const bool hasCachedFile = FileSys.fileExists(cachedFile);
-        if (hasCachedFile) {
-            LINFO(fmt::format(
-                "Cached file '{}' used for Speck file '{}'",
-                cachedFile, _speckFile
-            ));
+    const std::string& cachedFile = FileSys.cacheManager()->cachedFilename(
+        ghoul::filesystem::File(_speckFile),
+        "RenderableDUMeshes|" + identifier(),
+        ghoul::filesystem::CacheManager::Persistent::Yes
+    );
 
-            success = loadCachedFile(cachedFile);
-            if (success) {
-                return true;
-            }
-            else {
-                FileSys.cacheManager()->removeCacheFile(_speckFile);
-                // Intentional fall-through to the 'else' to generate the cache
-                // file for the next run
-            }
+    bool hasCachedFile = FileSys.fileExists(cachedFile);
+    if (hasCachedFile) {
+        LINFO(fmt::format(
+            "Cached file '{}' used for Speck file '{}'",
+            cachedFile, _speckFile
+        ));
+
+        try {
+            _catalog = PointCatalogCache::load(cachedFile, CurrentCacheVersion);
         }
-        else {
-            LINFO(fmt::format("Cache for Speck file '{}' not found", _speckFile));
+        catch (const ghoul::RuntimeError& e) {
+            LINFO(fmt::format("Deleting old cache: {}", e.message));
+            FileSys.cacheManager()->removeCacheFile(_speckFile);
+            // Intentional fall-through to the computation below to generate the cache
+            // file for the next run
+            hasCachedFile = false;
         }
+    }
+    else {
+        LINFO(fmt::format("Cache for Speck file '{}' not found", _speckFile));
+    }
+
+    if (!hasCachedFile) {
         LINFO(fmt::format("Loading Speck file '{}'", _speckFile));
 
-        success = readSpeckFile();
+        const bool success = readSpeckFile();
         if (!success) {
             return false;
         }
 
-        success &= saveCachedFile(cachedFile);
-    }
-    return success;
-}
-
-bool RenderableBillboardsCloud::loadLabelData() {
-    bool success = true;
-    if (!_labelFile.empty()) {
-        // I disabled the cache as it didn't work on Mac --- abock
-        const std::string& cachedFile = FileSys.cacheManager()->cachedFilename(
-            ghoul::filesystem::File(_labelFile),
-            ghoul::filesystem::CacheManager::Persistent::Yes
-        );
-        if (!_hasSpeckFile && !_hasColorMapFile) {
-            success = true;
+        if (_catalog.nRows() == 0) {
+            LERROR("Error writing cache: No values were loaded");
+            return false;
         }
-        const bool hasCachedFile = FileSys.fileExists(cachedFile);
-        if (hasCachedFile) {
-            LINFO(fmt::format(
-                "Cached file '{}' used for Label file '{}'",
-                cachedFile, _labelFile
-            ));
 
-            success &= loadCachedFile(cachedFile);
-            if (!success) {
-                FileSys.cacheManager()->removeCacheFile(_labelFile);
-                // Intentional fall-through to the 'else' to generate the cache
-                // file for the next run
-            }
+        try {
+            _catalog.save(cachedFile);
+            // Continue with the mapped cache so that the parsed values do not have to
+            // be kept on the heap
+            _catalog = PointCatalogCache::load(cachedFile, CurrentCacheVersion);
         }
-        else {
-            LINFO(fmt::format("Cache for Label file '{}' not found", _labelFile));
-            LINFO(fmt::format("Loading Label file '{}'", _labelFile));
-
-            success &= readLabelFile();
-            if (!success) {
-                return false;
-            }
+        catch (const ghoul::RuntimeError& e) {
+            LERROR(fmt::format("Error writing cache: {}", e.message));
+            return false;
         }
     }
 
-    return success;
+    // The first three columns are the position of the object, the data variables are
+    // indexed starting after them
+    for (int i = 3; i < _catalog.nColumns(); ++i) {
+        _variableDataPositionMap.insert({ std::string(_catalog.column(i).name), i - 3 });
+    }
+    return true;
 }
 
-bool RenderableBillboardsCloud::readSpeckFile() {
-    std::ifstream file(_speckFile);
-    if (!file.good()) {
-        LERROR(fmt::format("Failed to open Speck file '{}'", _speckFile));
-        return false;
+bool RenderableBillboardsCloud::loadLabelData() {
+    if (_labelFile.empty()) {
+        return true;
     }
 
-    _nValuesPerAstronomicalObject = 0;
-
-    // The beginning of the speck file has a header that either contains comments
-    // (signaled by a preceding '#') or information about the structure of the file
-    // (signaled by the keywords 'datavar', 'texturevar', and 'texture')
-    std::string line;
-    while (true) {
-        std::streampos position = file.tellg();
-        std::getline(file, line);
-
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() - 1);
-        }
+    const std::string& cachedFile = FileSys.cacheManager()->cachedFilename(
+        ghoul::filesystem::File(_labelFile),
+        ghoul::filesystem::CacheManager::Persistent::Yes
+    );
 
-        if (line.empty() || line[0] == '#') {
-            continue;
-        }
+    // The labels are cached before they are transformed, so that the cache stays valid
+    // when the transformation changes
+    PointCatalogCache labels;
+    bool hasCachedFile = FileSys.fileExists(cachedFile);
+    if (hasCachedFile) {
+        LINFO(fmt::format(
+            "Cached file '{}' used for Label file '{}'",
+            cachedFile, _labelFile
+        ));
 
-        if (line.substr(0, 7) != "datavar" &&
-            line.substr(0, 10) != "texturevar" &&
-            line.substr(0, 7) != "texture" &&
-            line.substr(0, 10) != "polyorivar" &&
-            line.substr(0, 10) != "maxcomment")
-        {
-            // we read a line that doesn't belong to the header, so we have to jump back
-            // before the beginning of the current line
-            file.seekg(position);
-            break;
+        try {
+            labels = PointCatalogCache::load(cachedFile, CurrentCacheVersion);
         }
-
-        if (line.substr(0, 7) == "datavar") {
-            // datavar lines are structured as follows:
-            // datavar # description
-            // where # is the index of the data variable; so if we repeatedly overwrite
-            // the 'nValues' variable with the latest index, we will end up with the total
-            // number of values (+3 since X Y Z are not counted in the Speck file index)
-            std::stringstream str(line);
-
-            std::string dummy;
-            str >> dummy; // command
-            str >> _nValuesPerAstronomicalObject; // variable index
-            dummy.clear();
-            str >> dummy; // variable name
-
-            _variableDataPositionMap.insert({ dummy, _nValuesPerAstronomicalObject });
-
-            // We want the number, but the index is 0 based
-            _nValuesPerAstronomicalObject += 1;
+        catch (const ghoul::RuntimeError& e) {
+            LINFO(fmt::format("Deleting old cache: {}", e.message));
+            FileSys.cacheManager()->removeCacheFile(_labelFile);
+            // Intentional fall-through to the computation below to generate the cache
+            // file for the next run
+            hasCachedFile = false;
         }
     }
+    else {
+        LINFO(fmt::format("Cache for Label file '{}' not found", _labelFile));
+    }
 
-    _nValuesPerAstronomicalObject += 3; // X Y Z are not counted in the Speck file indices
-
-    do {
-        std::vector<float> values(_nValuesPerAstronomicalObject);
-
-        std::getline(file, line);
+    if (!hasCachedFile) {
+        LINFO(fmt::format("Loading Label file '{}'", _labelFile));
 
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() - 1);
+        try {
+            SpeckFile file(_labelFile);
+            labels = PointCatalogCache({}, {}, CurrentCacheVersion, file.readLabels());
         }
-
-        if (line.empty()) {
-            continue;
+        catch (const ghoul::RuntimeError& e) {
+            LERROR(fmt::format(
+                "Failed to open Label file '{}': {}", _labelFile, e.message
+            ));
+            return false;
         }
 
-        std::stringstream str(line);
-
-        for (int i = 0; i < _nValuesPerAstronomicalObject; ++i) {
-            str >> values[i];
+        try {
+            labels.save(cachedFile);
         }
+        catch (const ghoul::RuntimeError& e) {
+            LERROR(fmt::format("Error writing cache: {}", e.message));
+        }
+    }
 
-        _fullData.insert(_fullData.end(), values.begin(), values.end());
-    } while (!file.eof());
-
+    _labelData.reserve(labels.nLabels());
+    for (size_t i = 0; i < labels.nLabels(); ++i) {
+        glm::vec3 transformedPos = glm::vec3(
+            _transformationMatrix * glm::dvec4(labels.labelPosition(i), 1.0)
+        );
+        _labelData.emplace_back(transformedPos, std::string(labels.labelText(i)));
+    }
     return true;
 }
 
+bool RenderableBillboardsCloud::readSpeckFile() {
+    try {
+        SpeckFile file(_speckFile);
+
+        std::vector<float> rows;
+        file.readRows(rows, file.nValuesPerRow());
+        _catalog = PointCatalogCache(rows, file.columnNames(), CurrentCacheVersion);
+        return true;
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(fmt::format("Failed to open Speck file '{}': {}", _speckFile, e.message));
+        return false;
+    }
+}
+
 bool RenderableBillboardsCloud::readColorMapFile() {
     std::string _file = _colorMapFile;
     std::ifstream file(_file);
@@ -1288,266 +1271,45 @@ bool RenderableBillboardsCloud::readColorMapFile() {
     return true;
 }
 
-bool RenderableBillboardsCloud::readLabelFile() {
-    std::string _file = _labelFile;
-    std::ifstream file(_file);
-    if (!file.good()) {
-        LERROR(fmt::format("Failed to open Label file '{}'", _file));
-        return false;
-    }
-
-    // The beginning of the speck file has a header that either contains comments
-    // (signaled by a preceding '#') or information about the structure of the file
-    // (signaled by the keywords 'datavar', 'texturevar', and 'texture')
-    std::string line;
-    while (true) {
-        std::streampos position = file.tellg();
-        std::getline(file, line);
-
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() - 1);
-        }
-
-        if (line.empty() || line[0] == '#') {
-            continue;
-        }
-
-        if (line.substr(0, 9) != "textcolor") {
-            // we read a line that doesn't belong to the header, so we have to jump back
-            // before the beginning of the current line
-            file.seekg(position);
-            continue;
-        }
-
-        if (line.substr(0, 9) == "textcolor") {
-            // textcolor lines are structured as follows:
-            // textcolor # description
-            // where # is color text defined in configuration file
-            std::stringstream str(line);
-
-            // TODO: handle cases of labels with different colors
-            break;
-        }
-    }
-
-
-    do {
-        std::vector<float> values(_nValuesPerAstronomicalObject);
-
-        std::getline(file, line);
-
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() - 1);
-        }
-
-        if (line.empty()) {
-            continue;
-        }
-
-        std::stringstream str(line);
-
-        glm::vec3 position;
-        for (auto j = 0; j < 3; ++j) {
-            str >> position[j];
-        }
-
-        std::string dummy;
-        str >> dummy; // text keyword
-
-        std::string label;
-        str >> label;
-        dummy.clear();
-
-        while (str >> dummy) {
-            if (dummy == "#") {
-                break;
-            }
-
-            label += " " + dummy;
-            dummy.clear();
-        }
-
-        glm::vec3 transformedPos = glm::vec3(
-            _transformationMatrix * glm::dvec4(position, 1.0)
-        );
-        _labelData.emplace_back(std::make_pair(transformedPos, label));
-    } while (!file.eof());
-
-    return true;
-}
-
-bool RenderableBillboardsCloud::loadCachedFile(const std::string& file) {
-    std::ifstream fileStream(file, std::ifstream::binary);
-    if (fileStream.good()) {
-        int8_t version = 0;
-        fileStream.read(reinterpret_cast<char*>(&version), sizeof(int8_t));
-        if (version != CurrentCacheVersion) {
-            LINFO("The format of the cached file has changed: deleting old cache");
-            fileStream.close();
-            FileSys.deleteFile(file);
-            return false;
-        }
-
-        int32_t nValues = 0;
-        fileStream.read(reinterpret_cast<char*>(&nValues), sizeof(int32_t));
-        fileStream.read(
-            reinterpret_cast<char*>(&_nValuesPerAstronomicalObject),
-            sizeof(int32_t)
-        );
-
-        _fullData.resize(nValues);
-        fileStream.read(reinterpret_cast<char*>(&_fullData[0]),
-            nValues * sizeof(_fullData[0]));
-
-        if (_hasColorMapFile) {
-            int32_t nItems = 0;
-            fileStream.read(reinterpret_cast<char*>(&nItems), sizeof(int32_t));
-
-            for (int i = 0; i < nItems; ++i) {
-                int32_t keySize = 0;
-                fileStream.read(reinterpret_cast<char*>(&keySize), sizeof(int32_t));
-                std::vector<char> buffer(keySize);
-                fileStream.read(buffer.data(), keySize);
-
-                std::string key(buffer.begin(), buffer.end());
-                int32_t value = 0;
-                fileStream.read(reinterpret_cast<char*>(&value), sizeof(int32_t));
-
-                _variableDataPositionMap.insert({ key, value });
-            }
-        }
-
-        bool success = fileStream.good();
-        return success;
-    }
-    else {
-        LERROR(fmt::format("Error opening file '{}' for loading cache file", file));
-        return false;
+void RenderableBillboardsCloud::createDataSlice() {
+    const size_t nObjects = _catalog.nRows();
+    _slicedData.resize(4 * nObjects);
+    if (nObjects == 0) {
+        return;
     }
-}
-
-bool RenderableBillboardsCloud::saveCachedFile(const std::string& file) const {
-    std::ofstream fileStream(file, std::ofstream::binary);
-    if (fileStream.good()) {
-        fileStream.write(reinterpret_cast<const char*>(&CurrentCacheVersion),
-            sizeof(int8_t));
-
-        int32_t nValues = static_cast<int32_t>(_fullData.size());
-        if (nValues == 0) {
-            LERROR("Error writing cache: No values were loaded");
-            return false;
-        }
-        fileStream.write(reinterpret_cast<const char*>(&nValues), sizeof(int32_t));
-
-        int32_t nValuesPerAstronomicalObject = static_cast<int32_t>(
-            _nValuesPerAstronomicalObject
-            );
-        fileStream.write(
-            reinterpret_cast<const char*>(&nValuesPerAstronomicalObject),
-            sizeof(int32_t)
-        );
 
-        size_t nBytes = nValues * sizeof(_fullData[0]);
-        fileStream.write(reinterpret_cast<const char*>(&_fullData[0]), nBytes);
-
-        if (_hasColorMapFile) {
-            int32_t nItems = static_cast<int32_t>(_variableDataPositionMap.size());
-            fileStream.write(reinterpret_cast<const char*>(&nItems), sizeof(int32_t));
-
-            for (const std::pair<const std::string, int>& pair :
-                 _variableDataPositionMap)
-            {
-                int32_t keySize = static_cast<int32_t>(pair.first.size());
-                fileStream.write(
-                    reinterpret_cast<const char*>(&keySize),
-                    sizeof(int32_t)
-                );
-                fileStream.write(pair.first.data(), keySize);
-                int32_t value = static_cast<int32_t>(pair.second);
-                fileStream.write(reinterpret_cast<const char*>(&value), sizeof(int32_t));
-            }
-        }
-
-        return fileStream.good();
-    }
-    else {
-        LERROR(fmt::format("Error opening file '{}' for save cache file", file));
-        return false;
-    }
+    const float biggestCoord = digitaluniverse::slicePositions(
+        _catalog.columnData(0),
+        _catalog.columnData(1),
+        _catalog.columnData(2),
+        nObjects,
+        _transformationMatrix,
+        static_cast<float>(_unit),
+        _slicedData.data(),
+        &global::threadPool
+    );
+    _fadeInDistance.setMaxValue(glm::vec2(10.0f * biggestCoord));
 }
 
-void RenderableBillboardsCloud::createDataSlice() {
-    _slicedData.clear();
-    if (_hasColorMapFile) {
-        _slicedData.reserve(8 * (_fullData.size() / _nValuesPerAstronomicalObject));
-    }
-    else {
-        _slicedData.reserve(4 * (_fullData.size() / _nValuesPerAstronomicalObject));
+void RenderableBillboardsCloud::createColorDataSlice() {
+    const size_t nObjects = _catalog.nRows();
+    _slicedColorData.resize(4 * nObjects);
+    if (nObjects == 0 || _colorMapData.empty()) {
+        return;
     }
 
-    // Generate the color bins for the colomap
-    int colorMapInUse = 0;
-    std::vector<float> colorBins;
-    if (_hasColorMapFile) {
-        colorMapInUse = _variableDataPositionMap[_colorOptionString];
-        glm::vec2 currentColorRange = _colorRangeData[_colorOption.value()];
-        float colorMapBinSize = (currentColorRange.y - currentColorRange.x) /
-            static_cast<float>(_colorMapData.size());
-        float bin = colorMapBinSize;
-        for (size_t i = 0; i < _colorMapData.size(); ++i) {
-            colorBins.push_back(bin);
-            bin += colorMapBinSize;
-        }
-    }
-
-    float biggestCoord = -1.0f;
-    for (size_t i = 0; i < _fullData.size(); i += _nValuesPerAstronomicalObject) {
-        glm::dvec4 transformedPos = _transformationMatrix * glm::dvec4(
-            _fullData[i + 0],
-            _fullData[i + 1],
-            _fullData[i + 2],
-            1.0
-        );
-        glm::vec4 position(glm::vec3(transformedPos), static_cast<float>(_unit));
-
-        if (_hasColorMapFile) {
-            for (auto j = 0; j < 4; ++j) {
-                _slicedData.push_back(position[j]);
-                biggestCoord = biggestCoord < position[j] ? position[j] : biggestCoord;
-            }
-            // Finds from which bin to get the color.
-            // Note: the first color in the colormap file
-            // is the outliers color.
-            glm::vec4 itemColor;
-            float variableColor = _fullData[i + 3 + colorMapInUse];
-            int c = static_cast<int>(colorBins.size() - 1);
-            while (variableColor < colorBins[c]) {
-                --c;
-                if (c == 0) {
-                    break;
-                }
-            }
-
-            int colorIndex =
-                c == static_cast<int>(colorBins.size() - 1) ?
-                0 :
-                c + 1;
-
-            for (auto j = 0; j < 4; ++j) {
-                _slicedData.push_back(_colorMapData[colorIndex][j]);
-            }
-        }
-        else {
-            for (auto j = 0; j < 4; ++j) {
-                _slicedData.push_back(position[j]);
-            }
-        }
-    }
-    _fadeInDistance.setMaxValue(glm::vec2(10.0f * biggestCoord));
+    const int colorMapInUse = _variableDataPositionMap[_colorOptionString];
+    const glm::vec2 currentColorRange = _colorRangeData[_colorOption.value()];
+    const float binSize = (currentColorRange.y - currentColorRange.x) /
+                          static_cast<float>(_colorMapData.size());
+    digitaluniverse::sliceColors(
+        _catalog.columnData(3 + colorMapInUse),
+        nObjects,
+        binSize,
+        _colorMapData,
+        _slicedColorData.data(),
+        &global::threadPool
+    );
 }
 
 void RenderableBillboardsCloud::createPolygonTexture() {
@@ -34,6 +34,7 @@
 #include <openspace/properties/vector/vec2property.h>
 #include <openspace/properties/vector/vec3property.h>
 #include <openspace/properties/vector/vec4property.h>
+#include <openspace/util/pointcatalogcache.h>
 #include <ghoul/opengl/ghoul_gl.h>
 #include <ghoul/opengl/uniformcache.h>
 #include <functional>
@@ -78,6 +79,7 @@ private:
     };
 
     void createDataSlice();
+    void createColorDataSlice();
     void createPolygonTexture();
     void renderToTexture(GLuint textureToRenderTo, GLuint textureWidth,
         GLuint textureHeight);
@@ -93,12 +95,10 @@ private:
     bool loadLabelData();
     bool readSpeckFile();
     bool readColorMapFile();
-    bool readLabelFile();
-    bool loadCachedFile(const std::string& file);
-    bool saveCachedFile(const std::string& file) const;
 
     bool _hasSpeckFile = false;
     bool _dataIsDirty = true;
+    bool _colorDataIsDirty = true;
     bool _textColorIsDirty = true;
     bool _hasSpriteTexture = false;
     bool _spriteTextureIsDirty = true;
@@ -151,19 +151,19 @@ private:
     Unit _unit = Parsec;
 
     std::vector<float> _slicedData;
-    std::vector<float> _fullData;
+    std::vector<float> _slicedColorData;
+    PointCatalogCache _catalog;
     std::vector<glm::vec4> _colorMapData;
     std::vector<std::pair<glm::vec3, std::string>> _labelData;
     std::unordered_map<std::string, int> _variableDataPositionMap;
     std::unordered_map<int, std::string> _optionConversionMap;
     std::vector<glm::vec2> _colorRangeData;
 
-    int _nValuesPerAstronomicalObject = 0;
-
     glm::dmat4 _transformationMatrix = glm::dmat4(1.0);
 
     GLuint _vao = 0;
     GLuint _vbo = 0;
+    GLuint _colorVbo = 0;
 
     // For polygons
     GLuint _polygonVao = 0;
@@ -31,16 +31,19 @@
 #include <openspace/engine/globals.h>
 #include <openspace/engine/windowdelegate.h>
 #include <openspace/rendering/renderengine.h>
+#include <openspace/util/speckfile.h>
 #include <ghoul/glm.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/font/fontmanager.h>
 #include <ghoul/font/fontrenderer.h>
+#include <ghoul/misc/exception.h>
 #include <ghoul/misc/templatefactory.h>
 #include <ghoul/io/texture/texturereader.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/texture.h>
 #include <ghoul/opengl/textureunit.h>
+#include <algorithm>
 #include <array>
 #include <fstream>
 #include <cstdint>
@@ -394,6 +397,13 @@ bool RenderableDUMeshes::isReady() const {
            (!_renderingMeshesMap.empty() || (!_labelData.empty()));
 }
 
+void RenderableDUMeshes::initialize() {
+    bool success = loadData();
+    if (!success) {
+        throw ghoul::RuntimeError("Error loading data");
+    }
+}
+
 void RenderableDUMeshes::initializeGL() {
     _program = DigitalUniverseModule::ProgramObjectManager.request(
         ProgramObjectName,
@@ -408,11 +418,6 @@ void RenderableDUMeshes::initializeGL() {
 
     ghoul::opengl::updateUniformLocations(*_program, _uniformCache, UniformNames);
 
-    bool success = loadData();
-    if (!success) {
-        throw ghoul::RuntimeError("Error loading data");
-    }
-
     createMeshes();
 
     if (_hasLabel) {
@@ -694,50 +699,25 @@ bool RenderableDUMeshes::loadData() {
 }
 
 bool RenderableDUMeshes::readSpeckFile() {
-    std::ifstream file(_speckFile);
-    if (!file.good()) {
-        LERROR(fmt::format("Failed to open Speck file '{}'", _speckFile));
-        return false;
-    }
-
-    int meshIndex = 0;
-
-    // The beginning of the speck file has a header that either contains comments
-    // (signaled by a preceding '#') or information about the structure of the file
-    // (signaled by the keywords 'datavar', 'texturevar', and 'texture')
-    std::string line;
-    while (true) {
-        std::streampos position = file.tellg();
-        std::getline(file, line);
-
-        if (file.eof()) {
-            break;
-        }
-
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() -1);
-        }
-
-        if (line.empty() || line[0] == '#') {
-            continue;
-        }
-
-        if (line.substr(0, 4) != "mesh") {
-            // we read a line that doesn't belong to the header, so we have to jump back
-            // before the beginning of the current line
-            file.seekg(position);
-            break;
-        }
+    try {
+        SpeckFile file(_speckFile);
+        const std::vector<std::string_view> lines = file.bodyLines();
+
+        int meshIndex = 0;
+        size_t i = 0;
+        while (i < lines.size()) {
+            const std::string_view line = lines[i++];
+            if (line.substr(0, 4) != "mesh") {
+                // we read a line that doesn't belong to a mesh, so we are done
+                break;
+            }
 
-        if (line.substr(0, 4) == "mesh") {
             // mesh lines are structured as follows:
             // mesh -t texnum -c colorindex -s style {
             // where textnum is the index of the texture;
             // colorindex is the index of the color for the mesh
             // and style is solid, wire or point (for now we support only wire)
-            std::stringstream str(line);
+            std::stringstream str = std::stringstream(std::string(line));
 
             RenderingMesh mesh;
             mesh.meshIndex = meshIndex;
@@ -774,135 +754,63 @@ bool RenderableDUMeshes::readSpeckFile() {
                 }
                 dummy.clear();
                 str >> dummy;
-            } while (dummy != "{");
+            } while (dummy != "{" && str);
 
-            std::getline(file, line);
-            std::stringstream dim(line);
+            if (i >= lines.size()) {
+                return false;
+            }
+            std::stringstream dim = std::stringstream(std::string(lines[i++]));
             dim >> mesh.numU; // numU
             dim >> mesh.numV; // numV
 
             // We can now read the vertices data:
-            for (int l = 0; l < mesh.numU * mesh.numV; ++l) {
-                std::getline(file, line);
-                if (line.substr(0, 1) != "}") {
-                    std::stringstream lineData(line);
-                    for (int i = 0; i < 7; ++i) {
-                        GLfloat value;
-                        lineData >> value;
-                        bool errorReading = lineData.rdstate() & std::ifstream::failbit;
-                        if (!errorReading) {
-                            mesh.vertices.push_back(value);
-                        }
-                        else {
-                            break;
-                        }
-                    }
-                }
-                else {
+            const int nVertices = mesh.numU * mesh.numV;
+            mesh.vertices.reserve(static_cast<size_t>(std::max(nVertices, 0)) * 7);
+            for (int l = 0; l < nVertices && i < lines.size(); ++l) {
+                if (lines[i].substr(0, 1) == "}") {
                     break;
                 }
+                std::array<GLfloat, 7> values;
+                const int nValues = SpeckFile::parseValues(lines[i++], values.data(), 7);
+                mesh.vertices.insert(
+                    mesh.vertices.end(),
+                    values.begin(),
+                    values.begin() + nValues
+                );
             }
 
-            std::getline(file, line);
-            if (line.substr(0, 1) == "}") {
-                _renderingMeshesMap.insert({ meshIndex++, mesh });
+            if (i < lines.size() && lines[i].substr(0, 1) == "}") {
+                ++i;
+                _renderingMeshesMap.insert({ meshIndex++, std::move(mesh) });
             }
             else {
                 return false;
             }
         }
+        return true;
     }
-
-    return true;
-}
-
-bool RenderableDUMeshes::readLabelFile() {
-    std::ifstream file(_labelFile);
-    if (!file.good()) {
-        LERROR(fmt::format("Failed to open Label file '{}'", _labelFile));
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(fmt::format("Failed to open Speck file '{}': {}", _speckFile, e.message));
         return false;
     }
+}
 
-    // The beginning of the speck file has a header that either contains comments
-    // (signaled by a preceding '#') or information about the structure of the file
-    // (signaled by the keywords 'datavar', 'texturevar', and 'texture')
-    std::string line;
-    while (true) {
-        std::streampos position = file.tellg();
-        std::getline(file, line);
-
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() -1);
-        }
-
-
-        if (line.empty() || line[0] == '#') {
-            continue;
-        }
-
-        if (line.substr(0, 9) != "textcolor") {
-            // we read a line that doesn't belong to the header, so we have to jump back
-            // before the beginning of the current line
-            file.seekg(position);
-            continue;
-        }
-
-        if (line.substr(0, 9) == "textcolor") {
-            // textcolor lines are structured as follows:
-            // textcolor # description
-            // where # is color text defined in configuration file
-            std::stringstream str(line);
+bool RenderableDUMeshes::readLabelFile() {
+    try {
+        SpeckFile file(_labelFile);
 
-            // TODO: handle cases of labels with different colors
-            break;
+        for (std::pair<glm::vec3, std::string>& label : file.readLabels()) {
+            glm::vec3 transformedPos = glm::vec3(
+                _transformationMatrix * glm::dvec4(label.first, 1.0)
+            );
+            _labelData.emplace_back(transformedPos, std::move(label.second));
         }
+        return true;
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(fmt::format("Failed to open Label file '{}': {}", _labelFile, e.message));
+        return false;
     }
-
-
-    do {
-        std::vector<float> values(_nValuesPerAstronomicalObject);
-
-        std::getline(file, line);
-
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() -1);
-        }
-
-        if (line.empty()) {
-            continue;
-        }
-
-        std::stringstream str(line);
-
-        glm::vec3 position;
-        for (int j = 0; j < 3; ++j) {
-            str >> position[j];
-        }
-
-        std::string dummy;
-        str >> dummy; // text keyword
-
-        std::string label;
-        str >> label;
-        dummy.clear();
-
-        while (str >> dummy) {
-            label += " " + dummy;
-            dummy.clear();
-        }
-
-        glm::vec3 transformedPos = glm::vec3(
-            _transformationMatrix * glm::dvec4(position, 1.0)
-        );
-        _labelData.emplace_back(std::make_pair(transformedPos, label));
-
-    } while (!file.eof());
-
-    return true;
 }
 
 bool RenderableDUMeshes::loadCachedFile(const std::string& file) {
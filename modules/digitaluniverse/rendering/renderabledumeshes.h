@@ -53,6 +53,7 @@ public:
     explicit RenderableDUMeshes(const ghoul::Dictionary& dictionary);
     ~RenderableDUMeshes() = default;
 
+    void initialize() override;
     void initializeGL() override;
     void deinitializeGL() override;
 
@@ -29,12 +29,14 @@
 #include <openspace/documentation/verifier.h>
 #include <openspace/engine/globals.h>
 #include <openspace/rendering/renderengine.h>
+#include <openspace/util/speckfile.h>
 #include <openspace/util/updatestructures.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/font/fontmanager.h>
 #include <ghoul/font/fontrenderer.h>
 #include <ghoul/io/texture/texturereader.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/texture.h>
 #include <ghoul/opengl/textureunit.h>
@@ -862,274 +864,130 @@ bool RenderablePlanesCloud::loadTextures() {
 }
 
 bool RenderablePlanesCloud::readSpeckFile() {
-    std::ifstream file(_speckFile);
-    if (!file.good()) {
-        LERROR(fmt::format("Failed to open Speck file '{}'", _speckFile));
-        return false;
-    }
-
-    _nValuesPerAstronomicalObject = 0;
-
-    // The beginning of the speck file has a header that either contains comments
-    // (signaled by a preceding '#') or information about the structure of the file
-    // (signaled by the keywords 'datavar', 'texturevar', and 'texture')
-    std::string line;
-    while (true) {
-        std::streampos position = file.tellg();
-        std::getline(file, line);
-
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() -1);
-        }
-
-        if (line.empty() || line[0] == '#') {
-            continue;
-        }
-
-        if (line.substr(0, 7) != "datavar" &&
-            line.substr(0, 10) != "texturevar" &&
-            line.substr(0, 7) != "texture" &&
-            line.substr(0, 10) != "polyorivar" &&
-            line.substr(0, 10) != "maxcomment")
-        {
-            // we read a line that doesn't belong to the header, so we have to jump back
-            // before the beginning of the current line
-            file.seekg(position);
-            break;
-        }
-
-        if (line.substr(0, 7) == "datavar") {
-            // datavar lines are structured as follows:
-            // datavar # description
-            // where # is the index of the data variable; so if we repeatedly overwrite
-            // the 'nValues' variable with the latest index, we will end up with the total
-            // number of values (+3 since X Y Z are not counted in the Speck file index)
-            std::stringstream str(line);
-
-            std::string dummy;
-            str >> dummy; // command
-            str >> _nValuesPerAstronomicalObject; // variable index
-            dummy.clear();
-            str >> dummy; // variable name
-
-            // +3 because of the x, y and z at the begining of each line.
-            _variableDataPositionMap.insert({ dummy, _nValuesPerAstronomicalObject + 3});
-
-            if ((dummy == "orientation") || (dummy == "ori")) { // 3d vectors u and v
-                // We want the number, but the index is 0 based
-                _nValuesPerAstronomicalObject += 6;
-            }
-            else {
-                // We want the number, but the index is 0 based
-                _nValuesPerAstronomicalObject += 1;
+    try {
+        SpeckFile file(_speckFile);
+
+        _nValuesPerAstronomicalObject = 0;
+
+        // The header contains information about the structure of the file (signaled by
+        // the keywords 'datavar', 'polyorivar', 'texturevar', and 'texture')
+        for (const std::string& line : file.headerLines()) {
+            if (line.substr(0, 7) == "datavar") {
+                // datavar lines are structured as follows:
+                // datavar # description
+                // where # is the index of the data variable; so if we repeatedly
+                // overwrite the 'nValues' variable with the latest index, we will end up
+                // with the total number of values (+3 since X Y Z are not counted in the
+                // Speck file index)
+                std::stringstream str(line);
+
+                std::string dummy;
+                str >> dummy; // command
+                str >> _nValuesPerAstronomicalObject; // variable index
+                dummy.clear();
+                str >> dummy; // variable name
+
+                // +3 because of the x, y and z at the begining of each line.
+                _variableDataPositionMap.insert({
+                    dummy,
+                    _nValuesPerAstronomicalObject + 3
+                });
+
+                if ((dummy == "orientation") || (dummy == "ori")) { // 3d vectors u and v
+                    // We want the number, but the index is 0 based
+                    _nValuesPerAstronomicalObject += 6;
+                }
+                else {
+                    // We want the number, but the index is 0 based
+                    _nValuesPerAstronomicalObject += 1;
+                }
             }
-        }
-
-        if (line.substr(0, 10) == "polyorivar") {
-            _planeStartingIndexPos = 0;
-            std::stringstream str(line);
 
-            std::string dummy;
-            str >> dummy; // command
-            str >> _planeStartingIndexPos;
-            _planeStartingIndexPos += 3; // 3 for xyz
-        }
-
-        if (line.substr(0, 10) == "texturevar") {
-            _textureVariableIndex = 0;
-            std::stringstream str(line);
-
-            std::string dummy;
-            str >> dummy; // command
-            str >> _textureVariableIndex;
-            _textureVariableIndex += 3; // 3 for xyz
-        }
-
-        if (line.substr(0, 8) == "texture ") {
-            std::stringstream str(line);
+            if (line.substr(0, 10) == "polyorivar") {
+                _planeStartingIndexPos = 0;
+                std::stringstream str(line);
 
-            std::size_t found = line.find('-');
-
-            int textureIndex = 0;
+                std::string dummy;
+                str >> dummy; // command
+                str >> _planeStartingIndexPos;
+                _planeStartingIndexPos += 3; // 3 for xyz
+            }
 
-            std::string dummy;
-            str >> dummy; // command
+            if (line.substr(0, 10) == "texturevar") {
+                _textureVariableIndex = 0;
+                std::stringstream str(line);
 
-            if (found != std::string::npos) {
-                std::string option; // Not being used right now.
-                str >> option;
+                std::string dummy;
+                str >> dummy; // command
+                str >> _textureVariableIndex;
+                _textureVariableIndex += 3; // 3 for xyz
             }
 
-            str >> textureIndex;
-            std::string fileName;
-            str >> fileName; // texture file name
-
-            std::string fullPath = absPath(_texturesPath + '/' + fileName);
-            std::string pngPath =
-                ghoul::filesystem::File(fullPath).fullBaseName() + ".png";
+            if (line.substr(0, 8) == "texture ") {
+                std::stringstream str(line);
 
-            if (FileSys.fileExists(fullPath)) {
-                _textureFileMap.insert({ textureIndex, fullPath });
+                std::size_t found = line.find('-');
 
-            }
-            else if (FileSys.fileExists(pngPath)) {
-                _textureFileMap.insert({ textureIndex, pngPath });
-            }
-            else {
-                LWARNING(fmt::format("Could not find image file {}", fileName));
-                _textureFileMap.insert({ textureIndex, "" });
-            }
-        }
-    }
+                int textureIndex = 0;
 
-    _nValuesPerAstronomicalObject += 3; // X Y Z are not counted in the Speck file indices
+                std::string dummy;
+                str >> dummy; // command
 
-    do {
-        std::vector<float> values(_nValuesPerAstronomicalObject);
+                if (found != std::string::npos) {
+                    std::string option; // Not being used right now.
+                    str >> option;
+                }
 
-        std::getline(file, line);
+                str >> textureIndex;
+                std::string fileName;
+                str >> fileName; // texture file name
 
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() -1);
-        }
+                std::string fullPath = absPath(_texturesPath + '/' + fileName);
+                std::string pngPath =
+                    ghoul::filesystem::File(fullPath).fullBaseName() + ".png";
 
-        if (line.empty()) {
-            continue;
-        }
+                if (FileSys.fileExists(fullPath)) {
+                    _textureFileMap.insert({ textureIndex, fullPath });
 
-        std::stringstream str(line);
-
-        glm::vec3 u(0.f);
-        glm::vec3 v(0.f);
-        int textureIndex = 0;
-
-        for (int i = 0; i < _nValuesPerAstronomicalObject; ++i) {
-            str >> values[i];
-            if ((i >= _planeStartingIndexPos) &&
-                (i <= _planeStartingIndexPos + 6)) { // vectors u and v
-                int index = i - _planeStartingIndexPos;
-                switch (index) {
-                    case 0:
-                        u.x = values[i];
-                        break;
-                    case 1:
-                        u.y = values[i];
-                        break;
-                    case 2:
-                        u.z = values[i];
-                        break;
-                    case 3:
-                        v.x = values[i];
-                        break;
-                    case 4:
-                        v.y = values[i];
-                        break;
-                    case 5:
-                        v.z = values[i];
-                        break;
                 }
-            }
-
-            // JCC: This should be moved to the RenderablePlanesCloud:
-            if (i == _textureVariableIndex) {
-                textureIndex = static_cast<int>(values[i]);
+                else if (FileSys.fileExists(pngPath)) {
+                    _textureFileMap.insert({ textureIndex, pngPath });
+                }
+                else {
+                    LWARNING(fmt::format("Could not find image file {}", fileName));
+                    _textureFileMap.insert({ textureIndex, "" });
+                }
             }
         }
-        _fullData.insert(_fullData.end(), values.begin(), values.end());
-    } while (!file.eof());
 
-    return true;
-}
+        // X Y Z are not counted in the Speck file indices
+        _nValuesPerAstronomicalObject += 3;
 
-bool RenderablePlanesCloud::readLabelFile() {
-    std::ifstream file(_labelFile);
-    if (!file.good()) {
-        LERROR(fmt::format("Failed to open Label file '{}'", _labelFile));
+        file.readRows(_fullData, _nValuesPerAstronomicalObject);
+        return true;
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(fmt::format("Failed to open Speck file '{}': {}", _speckFile, e.message));
         return false;
     }
+}
 
-    // The beginning of the speck file has a header that either contains comments
-    // (signaled by a preceding '#') or information about the structure of the file
-    // (signaled by the keywords 'datavar', 'texturevar', and 'texture')
-    std::string line;
-    while (true) {
-        std::streampos position = file.tellg();
-        std::getline(file, line);
-
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() -1);
-        }
-
-        if (line.empty() || line[0] == '#') {
-            continue;
-        }
-
-        if (line.substr(0, 9) != "textcolor") {
-            // we read a line that doesn't belong to the header, so we have to jump back
-            // before the beginning of the current line
-            file.seekg(position);
-            continue;
-        }
-
-        if (line.substr(0, 9) == "textcolor") {
-            // textcolor lines are structured as follows:
-            // textcolor # description
-            // where # is color text defined in configuration file
-            std::stringstream str(line);
+bool RenderablePlanesCloud::readLabelFile() {
+    try {
+        SpeckFile file(_labelFile);
 
-            // TODO: handle cases of labels with different colors
-            break;
+        for (std::pair<glm::vec3, std::string>& label : file.readLabels()) {
+            glm::vec3 transformedPos = glm::vec3(
+                _transformationMatrix * glm::dvec4(label.first, 1.0)
+            );
+            _labelData.emplace_back(transformedPos, std::move(label.second));
         }
+        return true;
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(fmt::format("Failed to open Label file '{}': {}", _labelFile, e.message));
+        return false;
     }
-
-    do {
-        std::vector<float> values(_nValuesPerAstronomicalObject);
-
-        std::getline(file, line);
-
-        // Guard against wrong line endings (copying files from Windows to Mac) causes
-        // lines to have a final \r
-        if (!line.empty() && line.back() == '\r') {
-            line = line.substr(0, line.length() -1);
-        }
-
-        if (line.empty()) {
-            continue;
-        }
-
-        std::stringstream str(line);
-
-        glm::vec3 position;
-        for (int j = 0; j < 3; ++j) {
-            str >> position[j];
-        }
-
-        std::string dummy;
-        str >> dummy; // text keyword
-
-        std::string label;
-        str >> label;
-        dummy.clear();
-
-        while (str >> dummy) {
-            label += " " + dummy;
-            dummy.clear();
-        }
-
-        glm::vec3 transformedPos = glm::vec3(
-            _transformationMatrix * glm::dvec4(position, 1.0)
-        );
-        _labelData.emplace_back(std::make_pair(transformedPos, label));
-
-    } while (!file.eof());
-
-    return true;
 }
 
 bool RenderablePlanesCloud::loadCachedFile(const std::string& file) {
@@ -38,8 +38,9 @@
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/textureunit.h>
+#include <algorithm>
+#include <cmath>
 #include <fstream>
-#include <thread>
 
 namespace {
     constexpr const char* _loggerCat = "RenderableFieldlinesSequence";
@@ -66,10 +67,15 @@ namespace {
     constexpr const char* KeyCdfExtraVariables = "ExtraVariables";
     // [STRING]
     constexpr const char* KeyCdfTracingVariable = "TracingVariable";
+    // [NUMBER] Megabytes of memory that the .cdf files that are traced at the same time
+    // may use together
+    constexpr const char* KeyCdfMemoryBudget = "MemoryBudget";
     // [STRING]
     constexpr const char* KeyJsonScalingFactor = "ScaleToMeters";
     // [BOOLEAN] If value False => Load in initializing step and store in RAM
     constexpr const char* KeyOslfsLoadAtRuntime = "LoadAtRuntime";
+    // [INT] Number of states that are loaded ahead of time if LoadAtRuntime is True
+    constexpr const char* KeyOslfsPrefetchStates = "PrefetchStates";
 
     // ---------------------------- OPTIONAL MODFILE KEYS  ---------------------------- //
     // [STRING ARRAY] Values should be paths to .txt files
@@ -82,6 +88,9 @@ namespace {
     // => osfls output & oslfs input => JSON output)
     constexpr const char* KeyOutputFolder = "OutputFolder";
 
+    // Used if KeyCdfMemoryBudget isn't specified
+    constexpr const float DefaultCdfMemoryBudget = 4096.f;
+
     // ------------- POSSIBLE STRING VALUES FOR CORRESPONDING MODFILE KEY ------------- //
     constexpr const char* ValueInputFileTypeCdf = "cdf";
     constexpr const char* ValueInputFileTypeJson = "json";
@@ -213,6 +222,17 @@ namespace {
         "Jump to Start Of Sequence",
         "Performs a time jump to the start of the sequence."
     };
+    constexpr openspace::properties::Property::PropertyInfo PrefetchHitRateInfo = {
+        "prefetchHitRate",
+        "Prefetch Hit Rate",
+        "The fraction of state changes for which the new state had already been loaded "
+        "from disk. If this value is low, the states are loaded slower than time passes."
+    };
+    constexpr openspace::properties::Property::PropertyInfo LoadLatencyInfo = {
+        "loadLatency",
+        "Load Latency (ms)",
+        "The average time it takes to load a state from disk, in milliseconds."
+    };
 
     enum class SourceFileType : int {
         Cdf = 0,
@@ -280,6 +300,9 @@ RenderableFieldlinesSequence::RenderableFieldlinesSequence(
     , _pMaskingQuantity(MaskingQuantityInfo, OptionProperty::DisplayType::Dropdown)
     , _pFocusOnOriginBtn(OriginButtonInfo)
     , _pJumpToStartBtn(TimeJumpButtonInfo)
+    , _pStreamingGroup({ "Streaming" })
+    , _pPrefetchHitRate(PrefetchHitRateInfo, 0.f, 0.f, 1.f)
+    , _pLoadLatency(LoadLatencyInfo, 0.f, 0.f, 100000.f)
 {
     _dictionary = std::make_unique<ghoul::Dictionary>(dictionary);
 }
@@ -355,10 +378,12 @@ void RenderableFieldlinesSequence::initializeGL() {
     );
 
     //------------------ Initialize OpenGL VBOs and VAOs-------------------------------//
-    glGenVertexArrays(1, &_vertexArrayObject);
-    glGenBuffers(1, &_vertexPositionBuffer);
-    glGenBuffers(1, &_vertexColorBuffer);
-    glGenBuffers(1, &_vertexMaskingBuffer);
+    for (GpuState& gpuState : _gpuStates) {
+        glGenVertexArrays(1, &gpuState.vertexArrayObject);
+        glGenBuffers(1, &gpuState.vertexPositionBuffer);
+        glGenBuffers(1, &gpuState.vertexColorBuffer);
+        glGenBuffers(1, &gpuState.vertexMaskingBuffer);
+    }
 
     // Needed for additive blending
     setRenderBin(Renderable::RenderBin::Overlay);
@@ -586,7 +611,10 @@ bool RenderableFieldlinesSequence::prepareForOsflsStreaming() {
     }
     _states.push_back(newState);
     _nStates = _startTimes.size();
-    _activeStateIndex = 0;
+    _prefetcher = std::make_unique<FieldlinesStatePrefetcher>(
+        _sourceFiles,
+        static_cast<size_t>(_nPrefetchedStates)
+    );
     return true;
 }
 
@@ -619,6 +647,12 @@ void RenderableFieldlinesSequence::extractOsflsInfoFromDictionary() {
             _identifier, KeyOslfsLoadAtRuntime
         ));
     }
+
+    float nPrefetchedStates;
+    if (_dictionary->getValue(KeyOslfsPrefetchStates, nPrefetchedStates)) {
+        // The state that is shown and the next one are always needed
+        _nPrefetchedStates = std::max(static_cast<int>(nPrefetchedStates), 2);
+    }
 }
 
 void RenderableFieldlinesSequence::setupProperties() {
@@ -634,6 +668,14 @@ void RenderableFieldlinesSequence::setupProperties() {
     addProperty(_pFocusOnOriginBtn);
     addProperty(_pJumpToStartBtn);
 
+    if (_loadingStatesDynamically) {
+        _pPrefetchHitRate.setReadOnly(true);
+        _pLoadLatency.setReadOnly(true);
+        addPropertySubOwner(_pStreamingGroup);
+        _pStreamingGroup.addProperty(_pPrefetchHitRate);
+        _pStreamingGroup.addProperty(_pLoadLatency);
+    }
+
     // ----------------------------- Add Property Groups ----------------------------- //
     addPropertySubOwner(_pColorGroup);
     addPropertySubOwner(_pDomainGroup);
@@ -879,24 +921,21 @@ bool RenderableFieldlinesSequence::getStatesFromCdfFiles(const std::string& outp
     std::vector<std::string> extraMagVars;
     extractMagnitudeVarsFromStrings(extraVars, extraMagVars);
 
-    // Load states into RAM!
-    for (const std::string& cdfPath : _sourceFiles) {
-        FieldlinesState newState;
-        bool isSuccessful = fls::convertCdfToFieldlinesState(
-            newState,
-            cdfPath,
-            seedPoints,
-            tracingVar,
-            extraVars,
-            extraMagVars
-        );
+    float memoryBudget = DefaultCdfMemoryBudget;
+    _dictionary->getValue(KeyCdfMemoryBudget, memoryBudget);
 
-        if (isSuccessful) {
-            addStateToSequence(newState);
-            if (!outputFolder.empty()) {
-                newState.saveStateToOsfls(outputFolder);
-            }
-        }
+    // Load states into RAM!
+    std::vector<FieldlinesState> states = fls::convertCdfsToFieldlinesStates(
+        _sourceFiles,
+        seedPoints,
+        tracingVar,
+        extraVars,
+        extraMagVars,
+        outputFolder,
+        static_cast<size_t>(memoryBudget) * 1024 * 1024
+    );
+    for (FieldlinesState& state : states) {
+        addStateToSequence(state);
     }
     return true;
 }
@@ -1014,32 +1053,21 @@ void RenderableFieldlinesSequence::extractMagnitudeVarsFromStrings(
 }
 
 void RenderableFieldlinesSequence::deinitializeGL() {
-    glDeleteVertexArrays(1, &_vertexArrayObject);
-    _vertexArrayObject = 0;
-
-    glDeleteBuffers(1, &_vertexPositionBuffer);
-    _vertexPositionBuffer = 0;
-
-    glDeleteBuffers(1, &_vertexColorBuffer);
-    _vertexColorBuffer = 0;
-
-    glDeleteBuffers(1, &_vertexMaskingBuffer);
-    _vertexMaskingBuffer = 0;
+    for (GpuState& gpuState : _gpuStates) {
+        glDeleteVertexArrays(1, &gpuState.vertexArrayObject);
+        glDeleteBuffers(1, &gpuState.vertexPositionBuffer);
+        glDeleteBuffers(1, &gpuState.vertexColorBuffer);
+        glDeleteBuffers(1, &gpuState.vertexMaskingBuffer);
+        gpuState = GpuState();
+    }
 
     if (_shaderProgram) {
         global::renderEngine.removeRenderProgram(_shaderProgram.get());
         _shaderProgram = nullptr;
     }
 
-    // Stall main thread until thread that's loading states is done!
-    bool printedWarning = false;
-    while (_isLoadingStateFromDisk) {
-        if (!printedWarning) {
-            LWARNING("Trying to destroy class when an active thread is still using it");
-            printedWarning = true;
-        }
-        std::this_thread::sleep_for(std::chrono::milliseconds(5));
-    }
+    // Waits for the state that is currently being loaded from disk
+    _prefetcher = nullptr;
 }
 
 bool RenderableFieldlinesSequence::isReady() const {
@@ -1047,7 +1075,8 @@ bool RenderableFieldlinesSequence::isReady() const {
 }
 
 void RenderableFieldlinesSequence::render(const RenderData& data, RendererTasks&) {
-    if (_activeTriggerTimeIndex != -1) {
+    const GpuState& gpuState = _gpuStates[_frontGpuState];
+    if (_activeTriggerTimeIndex != -1 && gpuState.state) {
         _shaderProgram->activate();
 
         // Calculate Model View MatrixProjection
@@ -1115,12 +1144,12 @@ void RenderableFieldlinesSequence::render(const RenderData& data, RendererTasks&
             }
         }
 
-        glBindVertexArray(_vertexArrayObject);
+        glBindVertexArray(gpuState.vertexArrayObject);
         glMultiDrawArrays(
             GL_LINE_STRIP, //_drawingOutputType,
-            _states[_activeStateIndex].lineStart().data(),
-            _states[_activeStateIndex].lineCount().data(),
-            static_cast<GLsizei>(_states[_activeStateIndex].lineStart().size())
+            gpuState.state->lineStart().data(),
+            gpuState.state->lineCount().data(),
+            static_cast<GLsizei>(gpuState.state->lineStart().size())
         );
 
         glBindVertexArray(0);
@@ -1138,6 +1167,11 @@ void RenderableFieldlinesSequence::update(const UpdateData& data) {
         _shaderProgram->rebuildFromFile();
     }
 
+    const double deltaTime = global::timeManager.deltaTime();
+    if (deltaTime != 0.0) {
+        _timeDirection = deltaTime > 0.0 ? 1 : -1;
+    }
+
     const double currentTime = data.time.j2000Seconds();
     const bool isInInterval = (currentTime >= _startTimes[0]) &&
                               (currentTime < _sequenceEndTime);
@@ -1154,57 +1188,74 @@ void RenderableFieldlinesSequence::update(const UpdateData& data) {
             (nextIdx < _nStates && currentTime >= _startTimes[nextIdx]))
         {
             updateActiveTriggerTimeIndex(currentTime);
-
-            if (_loadingStatesDynamically) {
-                _mustLoadNewStateFromDisk = true;
-            } else {
-                _needsUpdate = true;
-                _activeStateIndex = _activeTriggerTimeIndex;
-            }
+            _needsUpdate = true;
+            _isStateChangeCounted = false;
         } // else {we're still in same state as previous frame (no changes needed)}
     } else {
         // Not in interval => set everything to false
-        _activeTriggerTimeIndex   = -1;
-        _mustLoadNewStateFromDisk = false;
-        _needsUpdate              = false;
-    }
-
-    if (_mustLoadNewStateFromDisk) {
-        if (!_isLoadingStateFromDisk && !_newStateIsReady) {
-            _isLoadingStateFromDisk    = true;
-            _mustLoadNewStateFromDisk  = false;
-            std::string filePath = _sourceFiles[_activeTriggerTimeIndex];
-            std::thread readBinaryThread([this, f = std::move(filePath)] {
-                readNewState(f);
-            });
-            readBinaryThread.detach();
-        }
+        _activeTriggerTimeIndex = -1;
+        _needsUpdate            = false;
     }
 
-    if (_needsUpdate || _newStateIsReady) {
-        if (_loadingStatesDynamically) {
-            _states[0] = std::move(*_newState);
-        }
+    if (_prefetcher && _activeTriggerTimeIndex != -1) {
+        updatePrefetchWindow();
+    }
 
-        updateVertexPositionBuffer();
+    GpuState& back = _gpuStates[1 - _frontGpuState];
+    if (_needsUpdate) {
+        // The new state might already be in the back buffers; otherwise it is uploaded
+        // into them if it is available. For 'runtime-states' that are not loaded yet, the
+        // previous state is shown until they are
+        const bool isUploaded = back.stateIndex == _activeTriggerTimeIndex;
+        std::shared_ptr<const FieldlinesState> state;
+        if (!isUploaded) {
+            state = stateForIndex(_activeTriggerTimeIndex);
+        }
 
-        if (_states[_activeStateIndex].nExtraQuantities() > 0) {
-            _shouldUpdateColorBuffer = true;
-            _shouldUpdateMaskingBuffer = true;
+        if (_prefetcher && !_isStateChangeCounted) {
+            if (isUploaded || state) {
+                ++_nPrefetchHits;
+            }
+            else {
+                ++_nPrefetchMisses;
+            }
+            _isStateChangeCounted = true;
+            _pPrefetchHitRate = static_cast<float>(_nPrefetchHits) /
+                                static_cast<float>(_nPrefetchHits + _nPrefetchMisses);
         }
 
-        // Everything is set and ready for rendering!
-        _needsUpdate = false;
-        _newStateIsReady = false;
+        if (state) {
+            uploadState(back, _activeTriggerTimeIndex, std::move(state));
+        }
+        if (back.stateIndex == _activeTriggerTimeIndex) {
+            _frontGpuState = 1 - _frontGpuState;
+            _needsUpdate = false;
+        }
+    }
+    else if (_activeTriggerTimeIndex != -1) {
+        // Upload the state that comes next in the direction of time into the back
+        // buffers, so that they only have to be swapped when the state changes
+        const int next = _activeTriggerTimeIndex + _timeDirection;
+        const bool isValid = next >= 0 && next < static_cast<int>(_nStates);
+        if (isValid && back.stateIndex != next) {
+            std::shared_ptr<const FieldlinesState> state = stateForIndex(next);
+            if (state) {
+                uploadState(back, next, std::move(state));
+            }
+        }
     }
 
     if (_shouldUpdateColorBuffer) {
-        updateVertexColorBuffer();
+        for (const GpuState& gpuState : _gpuStates) {
+            updateVertexColorBuffer(gpuState);
+        }
         _shouldUpdateColorBuffer = false;
     }
 
     if (_shouldUpdateMaskingBuffer) {
-        updateVertexMaskingBuffer();
+        for (const GpuState& gpuState : _gpuStates) {
+            updateVertexMaskingBuffer(gpuState);
+        }
         _shouldUpdateMaskingBuffer = false;
     }
 }
@@ -1226,13 +1277,49 @@ void RenderableFieldlinesSequence::updateActiveTriggerTimeIndex(double currentTi
     }
 }
 
-// Reading state from disk. Must be thread safe!
-void RenderableFieldlinesSequence::readNewState(const std::string& filePath) {
-    _newState = std::make_unique<FieldlinesState>();
-    if (_newState->loadStateFromOsfls(filePath)) {
-        _newStateIsReady = true;
+std::shared_ptr<const FieldlinesState> RenderableFieldlinesSequence::stateForIndex(
+                                                                      int index) const
+{
+    if (_prefetcher) {
+        return _prefetcher->state(index);
+    }
+    else {
+        // The states in RAM outlive the buffers, so the pointer doesn't own the state
+        return std::shared_ptr<const FieldlinesState>(
+            std::shared_ptr<const FieldlinesState>(),
+            &_states[index]
+        );
+    }
+}
+
+// Asks the prefetcher for the states that will be needed before the next state could be
+// loaded from disk, given how fast simulation time is moving through the sequence
+void RenderableFieldlinesSequence::updatePrefetchWindow() {
+    const double sequenceDuration = _sequenceEndTime - _startTimes[0];
+    const double statesPerSecond = std::abs(global::timeManager.deltaTime()) *
+                                   static_cast<double>(_nStates) / sequenceDuration;
+    const double loadTime = _prefetcher->averageLoadTime();
+    // The prefetcher can't hold more states than its capacity, and for large delta
+    // times the number of states would not fit into an int
+    const double maxAhead = static_cast<double>(_prefetcher->capacity());
+    const double nStates = std::ceil(statesPerSecond * loadTime);
+    const int nAhead = static_cast<int>(std::min(maxAhead, nStates)) + 1;
+
+    _prefetcher->prefetch(_activeTriggerTimeIndex, _timeDirection, nAhead);
+    _pLoadLatency = static_cast<float>(loadTime * 1000.0);
+}
+
+void RenderableFieldlinesSequence::uploadState(GpuState& gpuState, int index,
+                                          std::shared_ptr<const FieldlinesState> state)
+{
+    gpuState.stateIndex = index;
+    gpuState.state = std::move(state);
+
+    updateVertexPositionBuffer(gpuState);
+    if (gpuState.state->nExtraQuantities() > 0) {
+        updateVertexColorBuffer(gpuState);
+        updateVertexMaskingBuffer(gpuState);
     }
-    _isLoadingStateFromDisk = false;
 }
 
 // Unbind buffers and arrays
@@ -1241,11 +1328,11 @@ inline void unbindGL() {
     glBindVertexArray(0);
 }
 
-void RenderableFieldlinesSequence::updateVertexPositionBuffer() {
-    glBindVertexArray(_vertexArrayObject);
-    glBindBuffer(GL_ARRAY_BUFFER, _vertexPositionBuffer);
+void RenderableFieldlinesSequence::updateVertexPositionBuffer(const GpuState& gpuState) {
+    glBindVertexArray(gpuState.vertexArrayObject);
+    glBindBuffer(GL_ARRAY_BUFFER, gpuState.vertexPositionBuffer);
 
-    const std::vector<glm::vec3>& vertPos = _states[_activeStateIndex].vertexPositions();
+    const std::vector<glm::vec3>& vertPos = gpuState.state->vertexPositions();
 
     glBufferData(
         GL_ARRAY_BUFFER,
@@ -1260,12 +1347,16 @@ void RenderableFieldlinesSequence::updateVertexPositionBuffer() {
     unbindGL();
 }
 
-void RenderableFieldlinesSequence::updateVertexColorBuffer() {
-    glBindVertexArray(_vertexArrayObject);
-    glBindBuffer(GL_ARRAY_BUFFER, _vertexColorBuffer);
+void RenderableFieldlinesSequence::updateVertexColorBuffer(const GpuState& gpuState) {
+    if (!gpuState.state) {
+        return;
+    }
+
+    glBindVertexArray(gpuState.vertexArrayObject);
+    glBindBuffer(GL_ARRAY_BUFFER, gpuState.vertexColorBuffer);
 
     bool isSuccessful;
-    const std::vector<float>& quantities = _states[_activeStateIndex].extraQuantity(
+    const std::vector<float>& quantities = gpuState.state->extraQuantity(
         _pColorQuantity,
         isSuccessful
     );
@@ -1285,12 +1376,16 @@ void RenderableFieldlinesSequence::updateVertexColorBuffer() {
     }
 }
 
-void RenderableFieldlinesSequence::updateVertexMaskingBuffer() {
-    glBindVertexArray(_vertexArrayObject);
-    glBindBuffer(GL_ARRAY_BUFFER, _vertexMaskingBuffer);
+void RenderableFieldlinesSequence::updateVertexMaskingBuffer(const GpuState& gpuState) {
+    if (!gpuState.state) {
+        return;
+    }
+
+    glBindVertexArray(gpuState.vertexArrayObject);
+    glBindBuffer(GL_ARRAY_BUFFER, gpuState.vertexMaskingBuffer);
 
     bool isSuccessful;
-    const std::vector<float>& maskings = _states[_activeStateIndex].extraQuantity(
+    const std::vector<float>& maskings = gpuState.state->extraQuantity(
         _pMaskingQuantity,
         isSuccessful
     );
@@ -28,14 +28,16 @@
 #include <openspace/rendering/renderable.h>
 
 #include <modules/fieldlinessequence/util/fieldlinesstate.h>
+#include <modules/fieldlinessequence/util/fieldlinesstateprefetcher.h>
 #include <openspace/properties/optionproperty.h>
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/triggerproperty.h>
+#include <openspace/properties/scalar/floatproperty.h>
 #include <openspace/properties/scalar/intproperty.h>
 #include <openspace/properties/vector/vec2property.h>
 #include <openspace/properties/vector/vec4property.h>
 #include <openspace/rendering/transferfunction.h>
-#include <atomic>
+#include <array>
 
 namespace { enum class SourceFileType; }
 
@@ -64,22 +66,36 @@ private:
     // ------------------------------------ STRINGS ------------------------------------//
     std::string _identifier;                               // Name of the Node!
 
+    // ------------------------------------ STRUCTS ------------------------------------//
+    // The OpenGL objects containing one state. There are two sets of these; one that is
+    // rendered and one into which the next state is uploaded before it is needed
+    struct GpuState {
+        // OpenGL Vertex Array Object
+        GLuint vertexArrayObject = 0;
+        // OpenGL Vertex Buffer Object containing the vertex positions
+        GLuint vertexPositionBuffer = 0;
+        // OpenGL Vertex Buffer Object containing the extraQuantity values used for
+        // coloring the lines
+        GLuint vertexColorBuffer = 0;
+        // OpenGL Vertex Buffer Object containing the extraQuantity values used for
+        // masking out segments of the lines
+        GLuint vertexMaskingBuffer = 0;
+        // Index of the state in the buffers. -1 => the buffers contain no state
+        int stateIndex = -1;
+        // The state in the buffers, kept alive for the line starts and counts
+        std::shared_ptr<const FieldlinesState> state;
+    };
+
     // ------------------------------------- FLAGS -------------------------------------//
-    // Used for 'runtime-states'. True when loading a new state from disk on another
-    // thread.
-    std::atomic_bool _isLoadingStateFromDisk = false;
     // False => states are stored in RAM (using 'in-RAM-states'), True => states are
     // loaded from disk during runtime (using 'runtime-states')
     bool _loadingStatesDynamically  = false;
-    // Used for 'runtime-states': True if new 'runtime-state' must be loaded from disk.
-    // False => the previous frame's state should still be shown
-    bool _mustLoadNewStateFromDisk  = false;
-    // Used for 'in-RAM-states' : True if new 'in-RAM-state'  must be loaded.
-    // False => the previous frame's state should still be shown
+    // True if the state to show has changed. False => the previous frame's state should
+    // still be shown. For 'runtime-states' this stays true until the state is loaded
     bool _needsUpdate = false;
-    // Used for 'runtime-states'. True when finished loading a new state from disk on
-    // another thread.
-    std::atomic_bool _newStateIsReady = false;
+    // Used for 'runtime-states': True if the current state change has been counted as
+    // either a prefetch hit or miss
+    bool _isStateChangeCounted = false;
     // True when new state is loaded or user change which quantity to color the lines by
     bool _shouldUpdateColorBuffer   = false;
     // True when new state is loaded or user change which quantity used for masking out
@@ -87,12 +103,19 @@ private:
     bool _shouldUpdateMaskingBuffer = false;
 
     // --------------------------------- NUMERICALS ----------------------------------- //
-    // Active index of _states. If(==-1)=>no state available for current time. Always the
-    // same as _activeTriggerTimeIndex if(_loadingStatesDynamically==true), else
-    // always = 0
-    int _activeStateIndex = -1;
     // Active index of _startTimes
     int _activeTriggerTimeIndex = -1;
+    // Index into _gpuStates of the buffers that are rendered
+    int _frontGpuState = 0;
+    // Used for 'runtime-states'. Number of states loaded from disk that the prefetcher
+    // should keep in memory
+    int _nPrefetchedStates = 8;
+    // Used for 'runtime-states'. Number of state changes for which the new state was
+    // already loaded (hits) or not (misses)
+    int _nPrefetchHits = 0;
+    int _nPrefetchMisses = 0;
+    // +1 if simulation time runs forward, -1 if it runs backwards
+    int _timeDirection = 1;
     // Number of states in the sequence
     size_t _nStates = 0;
     // In setup it is used to scale JSON coordinates. During runtime it is used to scale
@@ -100,22 +123,14 @@ private:
     float _scalingFactor = 1.f;
     // Estimated end of sequence.
     double _sequenceEndTime;
-    // OpenGL Vertex Array Object
-    GLuint _vertexArrayObject = 0;
-    // OpenGL Vertex Buffer Object containing the extraQuantity values used for coloring
-    // the lines
-    GLuint _vertexColorBuffer = 0;
-    // OpenGL Vertex Buffer Object containing the extraQuantity values used for masking
-    // out segments of the lines
-    GLuint _vertexMaskingBuffer = 0;
-    // OpenGL Vertex Buffer Object containing the vertex positions
-    GLuint _vertexPositionBuffer = 0;
+    // Front and back buffers. See GpuState
+    std::array<GpuState, 2> _gpuStates;
 
     // ----------------------------------- POINTERS ------------------------------------//
     // The Lua-Modfile-Dictionary used during initialization
     std::unique_ptr<ghoul::Dictionary> _dictionary;
-    // Used for 'runtime-states' when switching out current state to a new state
-    std::unique_ptr<FieldlinesState> _newState;
+    // Used for 'runtime-states'. Loads the upcoming states from disk in the background
+    std::unique_ptr<FieldlinesStatePrefetcher> _prefetcher;
     std::unique_ptr<ghoul::opengl::ProgramObject> _shaderProgram;
     // Transfer function used to color lines when _pColorMethod is set to BY_QUANTITY
     std::unique_ptr<TransferFunction> _transferFunction;
@@ -132,7 +147,7 @@ private:
     std::vector<std::string> _sourceFiles;
     // Contains the _triggerTimes for all FieldlineStates in the sequence
     std::vector<double> _startTimes;
-    // Stores the FieldlineStates
+    // Stores the FieldlineStates. Only contains the first state if using 'runtime-states'
     std::vector<FieldlinesState> _states;
 
     // ---------------------------------- Properties ---------------------------------- //
@@ -197,6 +212,13 @@ private:
     // Button which executes a time jump to start of sequence
     properties::TriggerProperty _pJumpToStartBtn;
 
+    // Group to hold the streaming statistics, only used for 'runtime-states'
+    properties::PropertyOwner _pStreamingGroup;
+    // Fraction of state changes for which the new state had already been loaded
+    properties::FloatProperty _pPrefetchHitRate;
+    // Average time it takes to load a state from disk, in milliseconds
+    properties::FloatProperty _pLoadLatency;
+
     // --------------------- FUNCTIONS USED DURING INITIALIZATION --------------------- //
     void addStateToSequence(FieldlinesState& STATE);
     void computeSequenceEndTime();
@@ -220,11 +242,14 @@ private:
     bool prepareForOsflsStreaming();
 
     // ------------------------- FUNCTIONS USED DURING RUNTIME ------------------------ //
-    void readNewState(const std::string& filePath);
+    std::shared_ptr<const FieldlinesState> stateForIndex(int index) const;
     void updateActiveTriggerTimeIndex(double currentTime);
-    void updateVertexPositionBuffer();
-    void updateVertexColorBuffer();
-    void updateVertexMaskingBuffer();
+    void updatePrefetchWindow();
+    void uploadState(GpuState& gpuState, int index,
+        std::shared_ptr<const FieldlinesState> state);
+    void updateVertexPositionBuffer(const GpuState& gpuState);
+    void updateVertexColorBuffer(const GpuState& gpuState);
+    void updateVertexMaskingBuffer(const GpuState& gpuState);
 };
 
 } // namespace openspace
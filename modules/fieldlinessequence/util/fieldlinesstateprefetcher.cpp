@@ -0,0 +1,169 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <modules/fieldlinessequence/util/fieldlinesstateprefetcher.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <algorithm>
+#include <chrono>
+
+namespace {
+    constexpr const char* _loggerCat = "FieldlinesStatePrefetcher";
+
+    // The average load time is a moving average over approximately this many states,
+    // so that it follows changes in the disk or system load
+    constexpr const size_t LoadTimeAverageWindow = 16;
+} // namespace
+
+namespace openspace {
+
+FieldlinesStatePrefetcher::FieldlinesStatePrefetcher(std::vector<std::string> files,
+                                                     size_t capacity)
+    : _files(std::move(files))
+    , _slots(std::max(capacity, size_t(2)))
+    , _thread([this]() { loadStates(); })
+{}
+
+FieldlinesStatePrefetcher::~FieldlinesStatePrefetcher() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _shouldStop = true;
+    }
+    _condition.notify_one();
+    _thread.join();
+}
+
+void FieldlinesStatePrefetcher::prefetch(int index, int direction, int nAhead) {
+    const int nFiles = static_cast<int>(_files.size());
+    const int n = std::clamp(nAhead, 0, static_cast<int>(_slots.size()) - 1);
+
+    std::vector<int> window;
+    window.reserve(n + 1);
+    for (int i = 0; i <= n; ++i) {
+        const int idx = index + i * direction;
+        if (idx < 0 || idx >= nFiles) {
+            break;
+        }
+        window.push_back(idx);
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (window == _window) {
+            return;
+        }
+        _window = std::move(window);
+    }
+    _condition.notify_one();
+}
+
+std::shared_ptr<const FieldlinesState> FieldlinesStatePrefetcher::state(int index) const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    for (const Slot& slot : _slots) {
+        if (slot.index == index) {
+            return slot.state;
+        }
+    }
+    return nullptr;
+}
+
+size_t FieldlinesStatePrefetcher::capacity() const {
+    return _slots.size();
+}
+
+double FieldlinesStatePrefetcher::averageLoadTime() const {
+    return _averageLoadTime;
+}
+
+bool FieldlinesStatePrefetcher::isWanted(int index) const {
+    return std::find(_window.begin(), _window.end(), index) != _window.end();
+}
+
+void FieldlinesStatePrefetcher::loadStates() {
+    // Returns the first state of the window that is neither loaded nor failed, or -1.
+    // Must be called with the mutex locked
+    auto nextMissingState = [this]() {
+        for (int index : _window) {
+            const bool isLoaded = std::any_of(
+                _slots.begin(),
+                _slots.end(),
+                [index](const Slot& slot) { return slot.index == index; }
+            );
+            const bool hasFailed =
+                std::find(_failed.begin(), _failed.end(), index) != _failed.end();
+            if (!isLoaded && !hasFailed) {
+                return index;
+            }
+        }
+        return -1;
+    };
+
+    while (true) {
+        int index = -1;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _condition.wait(lock, [&]() {
+                return _shouldStop || nextMissingState() != -1;
+            });
+            if (_shouldStop) {
+                return;
+            }
+            index = nextMissingState();
+        }
+
+        // The file is read without holding the lock so that the rendering thread can
+        // access the loaded states and change the window in the meantime
+        using namespace std::chrono;
+        const steady_clock::time_point start = steady_clock::now();
+        auto state = std::make_shared<FieldlinesState>();
+        const bool success = state->loadStateFromOsfls(_files[index]);
+        const double loadTime = duration<double>(steady_clock::now() - start).count();
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!success) {
+            LWARNING(fmt::format("Failed to load state from: {}", _files[index]));
+            _failed.push_back(index);
+            continue;
+        }
+
+        ++_nLoadedStates;
+        const double weight = 1.0 / std::min(_nLoadedStates, LoadTimeAverageWindow);
+        _averageLoadTime = _averageLoadTime + (loadTime - _averageLoadTime) * weight;
+
+        // Reuse an empty slot or the slot of a state that is no longer needed. If the
+        // window has moved on so far that all slots are needed, the state is dropped
+        auto it = std::find_if(
+            _slots.begin(),
+            _slots.end(),
+            [this](const Slot& slot) { return slot.index == -1 || !isWanted(slot.index); }
+        );
+        if (it != _slots.end()) {
+            it->index = index;
+            it->state = std::move(state);
+        }
+    }
+}
+
+} // namespace openspace
@@ -0,0 +1,105 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_MODULE_FIELDLINESSEQUENCE___FIELDLINESSTATEPREFETCHER___H__
+#define __OPENSPACE_MODULE_FIELDLINESSEQUENCE___FIELDLINESSTATEPREFETCHER___H__
+
+#include <modules/fieldlinessequence/util/fieldlinesstate.h>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * Loads the states of a fieldlines sequence from .osfls files on a single background
+ * thread into a ring of decoded states. Each frame, the owner tells the prefetcher
+ * which state is currently shown, in which direction time is moving, and how many of
+ * the following states should be available; the prefetcher then loads the missing
+ * states of this window in order, reusing the slots of states that have fallen out of
+ * it. Loaded states are handed out as shared pointers so that a state that is still in
+ * use is not destroyed when its slot is reused.
+ */
+class FieldlinesStatePrefetcher {
+public:
+    /**
+     * Starts the loading thread for the states in \p files, of which at most
+     * \p capacity are kept in memory at the same time.
+     */
+    FieldlinesStatePrefetcher(std::vector<std::string> files, size_t capacity);
+
+    /// Stops the loading thread after the state that is currently loaded is finished
+    ~FieldlinesStatePrefetcher();
+
+    /**
+     * Sets the window of states that should be loaded, which starts at \p index and
+     * continues for \p nAhead states in the \p direction (+1 or -1) of time. The
+     * window is clamped to the size of the ring and to the sequence.
+     */
+    void prefetch(int index, int direction, int nAhead);
+
+    /// Returns the state at \p index if it has been loaded, or nullptr otherwise
+    std::shared_ptr<const FieldlinesState> state(int index) const;
+
+    /// Returns the number of states that can be kept in memory at the same time
+    size_t capacity() const;
+
+    /// Returns the average time in seconds that it took to load a state
+    double averageLoadTime() const;
+
+private:
+    struct Slot {
+        // Index of the state in the sequence, -1 if the slot is unused
+        int index = -1;
+        std::shared_ptr<const FieldlinesState> state;
+    };
+
+    void loadStates();
+    bool isWanted(int index) const;
+
+    const std::vector<std::string> _files;
+    std::vector<Slot> _slots;
+    // The states that should be loaded, in the order in which they will be needed
+    std::vector<int> _window;
+    // Indices of the states that failed to load, which are not retried
+    std::vector<int> _failed;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _condition;
+    bool _shouldStop = false;
+
+    std::atomic<double> _averageLoadTime = 0.0;
+    size_t _nLoadedStates = 0;
+
+    std::thread _thread;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_FIELDLINESSEQUENCE___FIELDLINESSTATEPREFETCHER___H__
@@ -26,9 +26,15 @@
 
 #include <modules/fieldlinessequence/util/commons.h>
 #include <modules/fieldlinessequence/util/fieldlinesstate.h>
+#include <openspace/util/workstealingthreadpool.h>
 #include <ghoul/fmt.h>
 #include <ghoul/logging/logmanager.h>
+#include <algorithm>
+#include <atomic>
+#include <fstream>
 #include <memory>
+#include <mutex>
+#include <thread>
 
 #ifdef OPENSPACE_MODULE_KAMELEON_ENABLED
 
@@ -55,29 +61,47 @@ namespace {
     constexpr const char* JParallelB  = "Current: mag(J||B)";
     // [nPa]/[amu/cm^3] * ToKelvin => Temperature in Kelvin
     constexpr const float ToKelvin = 72429735.6984f;
+
+#ifdef OPENSPACE_MODULE_KAMELEON_ENABLED
+    // Seeds and vertices are split into this many blocks per thread, so that threads
+    // that finish early can take over the remaining work of the others
+    constexpr const size_t BlocksPerThread = 4;
+
+    size_t fileSize(const std::string& path) {
+        std::ifstream file(path, std::ifstream::binary | std::ifstream::ate);
+        return file.good() ? static_cast<size_t>(file.tellg()) : 0;
+    }
+#endif // OPENSPACE_MODULE_KAMELEON_ENABLED
 } // namespace
 
 namespace openspace::fls {
 
 // -------------------- DECLARE FUNCTIONS USED (ONLY) IN THIS FILE -------------------- //
 #ifdef OPENSPACE_MODULE_KAMELEON_ENABLED
+    bool convertCdfToFieldlinesState(FieldlinesState& state, const std::string& cdfPath,
+        const std::vector<glm::vec3>& seedPoints, const std::string& tracingVar,
+        std::vector<std::string>& extraVars, std::vector<std::string>& extraMagVars,
+        WorkStealingThreadPool& pool, std::mutex& fileMutex);
     bool addLinesToState(ccmc::Kameleon* kameleon, const std::vector<glm::vec3>& seeds,
-        const std::string& tracingVar, FieldlinesState& state);
+        const std::string& tracingVar, FieldlinesState& state,
+        WorkStealingThreadPool& pool);
     void addExtraQuantities(ccmc::Kameleon* kameleon,
         std::vector<std::string>& extraScalarVars, std::vector<std::string>& extraMagVars,
-        FieldlinesState& state);
+        FieldlinesState& state, WorkStealingThreadPool& pool);
     void prepareStateAndKameleonForExtras(ccmc::Kameleon* kameleon,
         std::vector<std::string>& extraScalarVars, std::vector<std::string>& extraMagVars,
         FieldlinesState& state);
 #endif // OPENSPACE_MODULE_KAMELEON_ENABLED
 // ------------------------------------------------------------------------------------ //
 
-/** Traces field lines from the provided cdf file using kameleon and stores the data in
- * the provided FieldlinesState.
- * Returns `false` if it fails to create a valid state. Requires the kameleon module to
- * be activated!
- * \param state, FieldlineState which should hold the extracted data
- * \param cdfPath, std::string of the absolute path to a .cdf file
+/**
+ * Traces field lines from all of the provided cdf files using kameleon and returns the
+ * states that could be created, in the order of the files. Requires the kameleon module
+ * to be activated!
+ * Several files are converted at the same time, as many as fit into the memory budget
+ * when estimating the memory needed for a file by its size. The seed points of each file
+ * and the extra quantities of each vertex are distributed over all cores.
+ * \param cdfPaths, absolute paths to the .cdf files
  * \param seedPoints, vector of seed points from which to trace field lines
  * \param tracingVar, which quantity to trace lines from. Typically "b" for magnetic field
  *        lines and "u" for velocity flow lines
@@ -86,19 +110,114 @@ namespace openspace::fls {
  * \param extraMagVars, variables which should be used for extracting magnitudes, must be
  *        a multiple of 3; e.g. "ux", "uy" & "uz" to get the magnitude of the velocity
  *        vector at each line vertex
+ * \param outputFolder, if not empty, each state is saved as an .osfls file in this
+ *        folder as soon as it has been traced
+ * \param memoryBudget, number of bytes that the open .cdf files may use together
+ */
+std::vector<FieldlinesState> convertCdfsToFieldlinesStates(
+                                                const std::vector<std::string>& cdfPaths,
+                                              const std::vector<glm::vec3>& seedPoints,
+                                                            const std::string& tracingVar,
+                                              const std::vector<std::string>& extraVars,
+                                           const std::vector<std::string>& extraMagVars,
+                                                          const std::string& outputFolder,
+                                                                      size_t memoryBudget)
+{
+#ifndef OPENSPACE_MODULE_KAMELEON_ENABLED
+    LERROR("CDF inputs provided but Kameleon module is deactivated");
+    return {};
+#else // OPENSPACE_MODULE_KAMELEON_ENABLED
+    const size_t nFiles = cdfPaths.size();
+    if (nFiles == 0) {
+        return {};
+    }
+
+    size_t largestFileSize = 1;
+    for (const std::string& path : cdfPaths) {
+        largestFileSize = std::max(largestFileSize, fileSize(path));
+    }
+
+    const size_t nThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    const size_t nConcurrentFiles = std::clamp(
+        memoryBudget / largestFileSize,
+        size_t(1),
+        std::min(nThreads, nFiles)
+    );
+    LINFO(fmt::format(
+        "Tracing field lines from {} files, {} at a time", nFiles, nConcurrentFiles
+    ));
+
+    WorkStealingThreadPool pool(nThreads);
+    // Neither the CDF library nor SPICE are thread safe, so only one file at a time can
+    // be read or written. The tracing runs in parallel with that
+    std::mutex fileMutex;
+
+    std::vector<FieldlinesState> states(nFiles);
+    std::vector<char> isConverted(nFiles, 0);
+    std::atomic<size_t> nextFile = 0;
+
+    // Each of these threads converts one file after the other, which bounds the number
+    // of files that are open at the same time. The threads run on their own instead of in
+    // the pool, as a file task could otherwise be started while another one waits for
+    // its tracing to finish
+    std::vector<std::thread> fileThreads;
+    fileThreads.reserve(nConcurrentFiles);
+    for (size_t t = 0; t < nConcurrentFiles; ++t) {
+        fileThreads.emplace_back([&]() {
+            for (size_t i = nextFile++; i < nFiles; i = nextFile++) {
+                // Every file validates and might alter its own copy of the variables
+                std::vector<std::string> vars = extraVars;
+                std::vector<std::string> magVars = extraMagVars;
+                isConverted[i] = convertCdfToFieldlinesState(
+                    states[i],
+                    cdfPaths[i],
+                    seedPoints,
+                    tracingVar,
+                    vars,
+                    magVars,
+                    pool,
+                    fileMutex
+                );
+
+                if (isConverted[i] && !outputFolder.empty()) {
+                    std::lock_guard<std::mutex> lock(fileMutex);
+                    states[i].saveStateToOsfls(outputFolder);
+                }
+            }
+        });
+    }
+    for (std::thread& thread : fileThreads) {
+        thread.join();
+    }
+
+    std::vector<FieldlinesState> result;
+    result.reserve(nFiles);
+    for (size_t i = 0; i < nFiles; ++i) {
+        if (isConverted[i]) {
+            result.push_back(std::move(states[i]));
+        }
+    }
+    return result;
+#endif // OPENSPACE_MODULE_KAMELEON_ENABLED
+}
+
+#ifdef OPENSPACE_MODULE_KAMELEON_ENABLED
+/**
+ * Traces field lines from the provided cdf file using kameleon and stores the data in
+ * the provided FieldlinesState.
+ * Returns `false` if it fails to create a valid state.
+ * The file is opened and its variables are loaded while holding \p fileMutex, while the
+ * tracing and the extra quantities are computed on the threads of \p pool.
  */
 bool convertCdfToFieldlinesState(FieldlinesState& state, const std::string& cdfPath,
                                  const std::vector<glm::vec3>& seedPoints,
                                  const std::string& tracingVar,
                                  std::vector<std::string>& extraVars,
-                                 std::vector<std::string>& extraMagVars)
+                                 std::vector<std::string>& extraMagVars,
+                                 WorkStealingThreadPool& pool, std::mutex& fileMutex)
 {
-
-#ifndef OPENSPACE_MODULE_KAMELEON_ENABLED
-    LERROR("CDF inputs provided but Kameleon module is deactivated");
-    return false;
-#else // OPENSPACE_MODULE_KAMELEON_ENABLED
     // Create Kameleon object and open CDF file!
+    std::unique_lock<std::mutex> lock(fileMutex);
     std::unique_ptr<ccmc::Kameleon> kameleon = kameleonHelper::createKameleonObject(
         cdfPath
     );
@@ -106,11 +225,20 @@ bool convertCdfToFieldlinesState(FieldlinesState& state, const std::string& cdfP
     state.setModel(fls::stringToModel(kameleon->getModelName()));
     state.setTriggerTime(kameleonHelper::getTime(kameleon.get()));
 
-    if (addLinesToState(kameleon.get(), seedPoints, tracingVar, state)) {
+    // ---------------------------- LOAD TRACING VARIABLE ---------------------------- //
+    if (!kameleon->loadVariable(tracingVar)) {
+        LERROR("Failed to load tracing variable: " + tracingVar);
+        return false;
+    }
+    prepareStateAndKameleonForExtras(kameleon.get(), extraVars, extraMagVars, state);
+    lock.unlock();
+
+    bool success = addLinesToState(kameleon.get(), seedPoints, tracingVar, state, pool);
+    if (success) {
         // The line points are in their RAW format (unscaled & maybe spherical)
         // Before we scale to meters (and maybe cartesian) we must extract
         // the extraQuantites, as the iterpolator needs the unaltered positions
-        addExtraQuantities(kameleon.get(), extraVars, extraMagVars, state);
+        addExtraQuantities(kameleon.get(), extraVars, extraMagVars, state, pool);
         switch (state.model()) {
             case fls::Model::Batsrus:
                 state.scalePositions(fls::ReToMeter);
@@ -121,15 +249,14 @@ bool convertCdfToFieldlinesState(FieldlinesState& state, const std::string& cdfP
             default:
                 break;
         }
-
-        return true;
     }
 
-    return false;
-#endif // OPENSPACE_MODULE_KAMELEON_ENABLED
+    // The file is closed when the Kameleon object is destroyed
+    lock.lock();
+    kameleon = nullptr;
+    return success;
 }
 
-#ifdef OPENSPACE_MODULE_KAMELEON_ENABLED
 /**
  * Traces and adds line vertices to state.
  * Vertices are not scaled to meters nor converted from spherical into cartesian
@@ -137,8 +264,9 @@ bool convertCdfToFieldlinesState(FieldlinesState& state, const std::string& cdfP
  * Note that extraQuantities will NOT be set!
  */
 bool addLinesToState(ccmc::Kameleon* kameleon, const std::vector<glm::vec3>& seedPoints,
-                     const std::string& tracingVar, FieldlinesState& state) {
-
+                     const std::string& tracingVar, FieldlinesState& state,
+                     WorkStealingThreadPool& pool)
+{
     float innerBoundaryLimit;
 
     switch (state.model()) {
@@ -156,41 +284,42 @@ bool addLinesToState(ccmc::Kameleon* kameleon, const std::vector<glm::vec3>& see
             return false;
     }
 
-    // ---------------------------- LOAD TRACING VARIABLE ---------------------------- //
-    if (!kameleon->loadVariable(tracingVar)) {
-        LERROR("Failed to load tracing variable: " + tracingVar);
-        return false;
-    }
-
-    bool success = false;
     LINFO("Tracing field lines!");
-    // LOOP THROUGH THE SEED POINTS, TRACE LINES, CONVERT POINTS TO glm::vec3 AND STORE //
-    for (const glm::vec3& seed : seedPoints) {
-        //--------------------------------------------------------------------------//
-        // We have to create a new tracer (or actually a new interpolator) for each //
-        // new line, otherwise some issues occur                                    //
-        //--------------------------------------------------------------------------//
-        std::unique_ptr<ccmc::Interpolator> interpolator =
-                std::make_unique<ccmc::KameleonInterpolator>(kameleon->model);
-        ccmc::Tracer tracer(kameleon, interpolator.get());
-        tracer.setInnerBoundary(innerBoundaryLimit); // TODO specify in Lua?
-        ccmc::Fieldline ccmcFieldline = tracer.bidirectionalTrace(
-            tracingVar,
-            seed.x,
-            seed.y,
-            seed.z
-        );
-        const std::vector<ccmc::Point3f>& positions = ccmcFieldline.getPositions();
-
-        const size_t nLinePoints = positions.size();
-
-        std::vector<glm::vec3> vertices;
-        vertices.reserve(nLinePoints);
-        for (const ccmc::Point3f& p : positions) {
-            vertices.emplace_back(p.component1, p.component2, p.component3);
+    // TRACE THE LINES FROM THE SEED POINTS IN PARALLEL & CONVERT POINTS TO glm::vec3 //
+    std::vector<std::vector<glm::vec3>> lines(seedPoints.size());
+    const size_t nBlocks = pool.numThreads() * BlocksPerThread;
+    pool.parallelFor(seedPoints.size(), nBlocks, [&](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            //----------------------------------------------------------------------//
+            // We have to create a new tracer (or actually a new interpolator) for  //
+            // each new line, otherwise some issues occur. The model itself is only //
+            // read, so the lines can be traced concurrently                        //
+            //----------------------------------------------------------------------//
+            std::unique_ptr<ccmc::Interpolator> interpolator =
+                    std::make_unique<ccmc::KameleonInterpolator>(kameleon->model);
+            ccmc::Tracer tracer(kameleon, interpolator.get());
+            tracer.setInnerBoundary(innerBoundaryLimit); // TODO specify in Lua?
+            ccmc::Fieldline ccmcFieldline = tracer.bidirectionalTrace(
+                tracingVar,
+                seedPoints[i].x,
+                seedPoints[i].y,
+                seedPoints[i].z
+            );
+            const std::vector<ccmc::Point3f>& positions = ccmcFieldline.getPositions();
+
+            std::vector<glm::vec3>& vertices = lines[i];
+            vertices.reserve(positions.size());
+            for (const ccmc::Point3f& p : positions) {
+                vertices.emplace_back(p.component1, p.component2, p.component3);
+            }
         }
+    });
+
+    // STORE THE LINES IN THE ORDER OF THE SEED POINTS //
+    bool success = false;
+    for (std::vector<glm::vec3>& vertices : lines) {
         state.addLine(vertices);
-        success |= (nLinePoints > 0);
+        success |= !vertices.empty();
     }
 
     return success;
@@ -216,59 +345,78 @@ bool addLinesToState(ccmc::Kameleon* kameleon, const std::vector<glm::vec3>& see
 void addExtraQuantities(ccmc::Kameleon* kameleon,
                         std::vector<std::string>& extraScalarVars,
                         std::vector<std::string>& extraMagVars,
-                        FieldlinesState& state)
+                        FieldlinesState& state, WorkStealingThreadPool& pool)
 {
-
-    prepareStateAndKameleonForExtras(kameleon, extraScalarVars, extraMagVars, state);
-
     const size_t nXtraScalars = extraScalarVars.size();
     const size_t nXtraMagnitudes = extraMagVars.size() / 3;
 
-    std::unique_ptr<ccmc::Interpolator> interpolator =
-            std::make_unique<ccmc::KameleonInterpolator>(kameleon->model);
+    const std::vector<glm::vec3>& positions = state.vertexPositions();
+    std::vector<std::vector<float>> extras(
+        nXtraScalars + nXtraMagnitudes,
+        std::vector<float>(positions.size())
+    );
 
     // ------ Extract all the extraQuantities from kameleon and store in state! ------ //
-    for (const glm::vec3& p : state.vertexPositions()) {
-        // Load the scalars!
-        for (size_t i = 0; i < nXtraScalars; i++) {
-            float val;
-            if (extraScalarVars[i] == TAsPOverRho) {
-                val = interpolator->interpolate("p", p.x, p.y, p.z);
-                val *= ToKelvin;
-                val /= interpolator->interpolate("rho", p.x, p.y, p.z);
-            } else {
-                val = interpolator->interpolate(extraScalarVars[i], p.x, p.y, p.z);
+    const size_t nBlocks = pool.numThreads() * BlocksPerThread;
+    pool.parallelFor(positions.size(), nBlocks, [&](size_t begin, size_t end) {
+        // Interpolators can't be shared between threads
+        std::unique_ptr<ccmc::Interpolator> interpolator =
+                std::make_unique<ccmc::KameleonInterpolator>(kameleon->model);
 
-                // When measuring density in ENLIL CCMC multiply by the radius^2
-                if (extraScalarVars[i] == "rho" && state.model() == fls::Model::Enlil) {
-                    val *= std::pow(p.x * fls::AuToMeter, 2.0f);
+        for (size_t v = begin; v < end; ++v) {
+            const glm::vec3& p = positions[v];
+            // Load the scalars!
+            for (size_t i = 0; i < nXtraScalars; i++) {
+                float val;
+                if (extraScalarVars[i] == TAsPOverRho) {
+                    val = interpolator->interpolate("p", p.x, p.y, p.z);
+                    val *= ToKelvin;
+                    val /= interpolator->interpolate("rho", p.x, p.y, p.z);
+                } else {
+                    val = interpolator->interpolate(extraScalarVars[i], p.x, p.y, p.z);
+
+                    // When measuring density in ENLIL CCMC multiply by the radius^2
+                    if (extraScalarVars[i] == "rho" &&
+                        state.model() == fls::Model::Enlil)
+                    {
+                        val *= std::pow(p.x * fls::AuToMeter, 2.0f);
+                    }
                 }
+                extras[i][v] = val;
+            }
+            // Calculate and store the magnitudes!
+            for (size_t i = 0; i < nXtraMagnitudes; ++i) {
+                const size_t idx = i*3;
+
+                const float x =
+                    interpolator->interpolate(extraMagVars[idx], p.x, p.y, p.z);
+                const float y =
+                    interpolator->interpolate(extraMagVars[idx + 1], p.x, p.y, p.z);
+                const float z =
+                    interpolator->interpolate(extraMagVars[idx + 2], p.x, p.y, p.z);
+                float val;
+                // When looking at the current's magnitude in Batsrus, CCMC staff are
+                // only interested in the magnitude parallel to the magnetic field
+                if (state.extraQuantityNames()[nXtraScalars + i] == JParallelB) {
+                    const glm::vec3 normMagnetic =  glm::normalize(glm::vec3(
+                            interpolator->interpolate("bx", p.x, p.y, p.z),
+                            interpolator->interpolate("by", p.x, p.y, p.z),
+                            interpolator->interpolate("bz", p.x, p.y, p.z)));
+                    // Magnitude of the part of the current vector that's parallel to
+                    // the magnetic field vector!
+                    val = glm::dot(glm::vec3(x,y,z), normMagnetic);
+
+                } else {
+                    val = std::sqrt(x*x + y*y + z*z);
+                }
+                extras[i + nXtraScalars][v] = val;
             }
-            state.appendToExtra(i, val);
         }
-        // Calculate and store the magnitudes!
-        for (size_t i = 0; i < nXtraMagnitudes; ++i) {
-            const size_t idx = i*3;
-
-            const float x = interpolator->interpolate(extraMagVars[idx]  , p.x, p.y, p.z);
-            const float y = interpolator->interpolate(extraMagVars[idx+1], p.x, p.y, p.z);
-            const float z = interpolator->interpolate(extraMagVars[idx+2], p.x, p.y, p.z);
-            float val;
-            // When looking at the current's magnitude in Batsrus, CCMC staff are
-            // only interested in the magnitude parallel to the magnetic field
-            if (state.extraQuantityNames()[nXtraScalars + i] == JParallelB) {
-                const glm::vec3 normMagnetic =  glm::normalize(glm::vec3(
-                        interpolator->interpolate("bx", p.x, p.y, p.z),
-                        interpolator->interpolate("by", p.x, p.y, p.z),
-                        interpolator->interpolate("bz", p.x, p.y, p.z)));
-                // Magnitude of the part of the current vector that's parallel to
-                // the magnetic field vector!
-                val = glm::dot(glm::vec3(x,y,z), normMagnetic);
+    });
 
-            } else {
-                val = std::sqrt(x*x + y*y + z*z);
-            }
-            state.appendToExtra(i + nXtraScalars, val);
+    for (size_t i = 0; i < extras.size(); ++i) {
+        for (float val : extras[i]) {
+            state.appendToExtra(i, val);
         }
     }
 }
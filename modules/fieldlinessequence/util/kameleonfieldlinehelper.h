@@ -35,9 +35,11 @@ class FieldlinesState;
 
 namespace fls {
 
-bool convertCdfToFieldlinesState(FieldlinesState& state, const std::string& cdfPath,
-    const std::vector<glm::vec3>& seedPoints, const std::string& tracingVar,
-    std::vector<std::string>& extraVars, std::vector<std::string>& extraMagVars);
+std::vector<FieldlinesState> convertCdfsToFieldlinesStates(
+    const std::vector<std::string>& cdfPaths, const std::vector<glm::vec3>& seedPoints,
+    const std::string& tracingVar, const std::vector<std::string>& extraVars,
+    const std::vector<std::string>& extraMagVars, const std::string& outputFolder,
+    size_t memoryBudget);
 
 } // namespace fls
 } // namespace openspace
@@ -25,11 +25,13 @@
 #include <modules/fitsfilereader/include/fitsfilereader.h>
 
 #include <openspace/util/distanceconversion.h>
+#include <openspace/util/speckfile.h>
 #include <ghoul/fmt.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/dictionary.h>
+#include <ghoul/misc/exception.h>
 #include <CCfits>
-#include <fstream>
+#include <algorithm>
 
 using namespace CCfits;
 
@@ -512,54 +514,25 @@ std::vector<float> FitsFileReader::readSpeckFile(const std::string& filePath,
 {
     std::vector<float> fullData;
 
-    std::ifstream fileStream(filePath);
-
-    if (!fileStream.good()) {
-        LERROR(fmt::format("Failed to open Speck file '{}'", filePath));
-        return fullData;
-    }
-
+    std::vector<float> readValues;
     int nValuesPerStar = 0;
-    int nNullArr = 0;
     size_t nStars = 0;
-
-    // The beginning of the speck file has a header that either contains comments
-    // (signaled by a preceding '#') or information about the structure of the file
-    // (signaled by the keywords 'datavar', 'texturevar', 'texture' and 'maxcomment')
-    std::string line;
-    while (true) {
-        std::streampos position = fileStream.tellg();
-        std::getline(fileStream, line);
-
-        if (line[0] == '#' || line.empty()) {
-            continue;
-        }
-
-        if (line.substr(0, 7) != "datavar" && line.substr(0, 10) != "texturevar" &&
-            line.substr(0, 7) != "texture" && line.substr(0, 10) != "maxcomment")
-        {
-            // We read a line that doesn't belong to the header, so we have to jump back
-            // before the beginning of the current line.
-            fileStream.seekg(position);
-            break;
-        }
-
-        if (line.substr(0, 7) == "datavar") {
-            // datavar lines are structured as follows:
-            // datavar # description
-            // where # is the index of the data variable; so if we repeatedly overwrite
-            // the 'nValues' variable with the latest index, we will end up with the total
-            // number of values (+3 since X Y Z are not counted in the Speck file index)
-            std::stringstream str(line);
-
-            std::string dummy;
-            str >> dummy;
-            str >> nValuesPerStar;
-            nValuesPerStar += 1; // We want the number, but the index is 0 based
+    try {
+        SpeckFile file(filePath);
+        nValuesPerStar = file.nValuesPerRow();
+        if (nValuesPerStar < 17) {
+            LERROR(fmt::format(
+                "Speck file '{}' has {} values per star, but at least 17 are needed",
+                filePath, nValuesPerStar
+            ));
+            return fullData;
         }
+        nStars = file.readRows(readValues, nValuesPerStar);
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(fmt::format("Failed to open Speck file '{}': {}", filePath, e.message));
+        return fullData;
     }
-
-    nValuesPerStar += 3; // X Y Z are not counted in the Speck file indices
 
     // Order in DR1 file:       DR2 - GaiaGroupMembers:
     // 0 BVcolor                0 color
@@ -578,60 +551,42 @@ std::vector<float> FitsFileReader::readSpeckFile(const std::string& filePath,
     // 13 texture               13 speed
     //                          14 texture
 
-    do {
-        std::vector<float> readValues(nValuesPerStar);
-        nStars++;
+    // Re-order data here because Octree expects the data in correct order when read.
+    // Default order for rendering:
+    // Position [X, Y, Z]
+    // Absolute Magnitude
+    // B-V Color
+    // Velocity [X, Y, Z]
+    nRenderValues = 8;
+    fullData.reserve(nStars * nRenderValues);
 
-        std::getline(fileStream, line);
-        std::stringstream str(line);
-
-        // Read values.
-        for (int i = 0; i < nValuesPerStar; ++i) {
-            str >> readValues[i];
-        }
+    int nNullArr = 0;
+    for (size_t i = 0; i < nStars; ++i) {
+        const float* values = readValues.data() + i * nValuesPerStar;
 
         // Check if star is a nullArray.
-        bool nullArray = true;
-        for (float f : readValues) {
-            if (f != 0.0) {
-                nullArray = false;
-                break;
-            }
-        }
-
-        // Insert to data if we found some values.
-        if (!nullArray) {
-            // Re-order data here because Octree expects the data in correct order when
-            // read.
-            // Default order for rendering:
-            // Position [X, Y, Z]
-            // Absolute Magnitude
-            // B-V Color
-            // Velocity [X, Y, Z]
-
-            nRenderValues = 8;
-            std::vector<float> renderValues(nRenderValues);
-
-            // Gaia DR1 data from AMNH measures positions in Parsec, but
-            // RenderableGaiaStars expects kiloParsec (because fits file from Vienna had
-            // in kPc).
-            // Thus we need to convert positions twice atm.
-            renderValues[0] = readValues[0] / 1000.0; // PosX
-            renderValues[1] = readValues[1] / 1000.0; // PosY
-            renderValues[2] = readValues[2] / 1000.0; // PosZ
-            renderValues[3] = readValues[6]; // AbsMag
-            renderValues[4] = readValues[3]; // color
-            renderValues[5] = readValues[13] * readValues[16]; // Vel X
-            renderValues[6] = readValues[14] * readValues[16]; // Vel Y
-            renderValues[7] = readValues[15] * readValues[16]; // Vel Z
-
-            fullData.insert(fullData.end(), renderValues.begin(), renderValues.end());
-        }
-        else {
+        const bool nullArray = std::all_of(
+            values,
+            values + nValuesPerStar,
+            [](float f) { return f == 0.f; }
+        );
+        if (nullArray) {
             nNullArr++;
+            continue;
         }
 
-    } while (!fileStream.eof());
+        // Gaia DR1 data from AMNH measures positions in Parsec, but RenderableGaiaStars
+        // expects kiloParsec (because fits file from Vienna had in kPc).
+        // Thus we need to convert positions twice atm.
+        fullData.push_back(values[0] / 1000.f); // PosX
+        fullData.push_back(values[1] / 1000.f); // PosY
+        fullData.push_back(values[2] / 1000.f); // PosZ
+        fullData.push_back(values[6]); // AbsMag
+        fullData.push_back(values[3]); // color
+        fullData.push_back(values[13] * values[16]); // Vel X
+        fullData.push_back(values[14] * values[16]); // Vel Y
+        fullData.push_back(values[15] * values[16]); // Vel Z
+    }
 
     LINFO(fmt::format("{} out of {} read stars were null arrays", nNullArr, nStars));
 
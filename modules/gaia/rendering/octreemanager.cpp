@@ -29,6 +29,12 @@
 #include <ghoul/fmt.h>
 #include <ghoul/glm.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <filesystem>
 #include <fstream>
 #include <thread>
 
@@ -54,7 +60,15 @@ void OctreeManager::initOctree(long long cpuRamBudget, int maxDist, int maxStars
     box.max = glm::vec3(1.f, 1.f, 1e2);
     _culler = std::make_unique<OctreeCuller>(box);
     _removedKeysInPrevCall = std::set<int>();
-    _leastRecentlyFetchedNodes = std::queue<unsigned long long>();
+    if (_fetchPool) {
+        _fetchPool->clearTasks();
+    }
+    {
+        std::lock_guard lock(_loadedNodesMutex);
+        _loadedNodes.clear();
+        _loadedNodesLookup.clear();
+    }
+    _packedFile = nullptr;
 
     // Reset default values when rebuilding the Octree during runtime.
     _numInnerNodes = 0;
@@ -64,6 +78,7 @@ void OctreeManager::initOctree(long long cpuRamBudget, int maxDist, int maxStars
     _maxCpuRamBudget = cpuRamBudget;
     _cpuRamBudget = cpuRamBudget;
     _parentNodeOfCamera = 8;
+    _parentNodeOfPrediction = 8;
 
     if (maxDist > 0) {
         MAX_DIST = static_cast<size_t>(maxDist);
@@ -117,9 +132,20 @@ void OctreeManager::initBufferIndexStack(long long maxNodes, bool useVBO,
 }
 
 void OctreeManager::insert(const std::vector<float>& starValues) {
-    size_t index = getChildIndex(starValues[0], starValues[1], starValues[2]);
+    insert(starValues.data());
+}
+
+void OctreeManager::insert(const float* starValues) {
+    insertInBranch(branchIndex(starValues), starValues);
+}
+
+size_t OctreeManager::branchIndex(const float* starValues) const {
+    return getChildIndex(starValues[0], starValues[1], starValues[2]);
+}
 
-    insertInNode(*_root->Children[index], starValues);
+void OctreeManager::insertInBranch(size_t branchIndex, const float* starValues) {
+    ghoul_assert(branchIndex < 8, "Branch index must be in [0, 7]");
+    insertInNode(*_root->Children[branchIndex], starValues);
 }
 
 void OctreeManager::sliceLodData(size_t branchIndex) {
@@ -127,7 +153,7 @@ void OctreeManager::sliceLodData(size_t branchIndex) {
         sliceNodeLodCache(*_root->Children[branchIndex]);
     }
     else {
-        for (int i = 0; i < 7; ++i) {
+        for (int i = 0; i < 8; ++i) {
             sliceNodeLodCache(*_root->Children[i]);
         }
     }
@@ -147,7 +173,7 @@ void OctreeManager::printStarsPerNode() const {
 }
 
 void OctreeManager::fetchSurroundingNodes(const glm::dvec3& cameraPos,
-                                          size_t chunkSizeInBytes,
+                                          const glm::dvec3& predictedCameraPos,
                                           const glm::ivec2& additionalNodes)
 {
 
@@ -165,45 +191,71 @@ void OctreeManager::fetchSurroundingNodes(const glm::dvec3& cameraPos,
                     continue;
                 }
 
-                // Use multithreading to load files and detach thread from main execution
-                // so it can execute independently. Thread will be destroyed when
-                // finished!
-                std::thread([this, n = _root->Children[i]]() {
+                // Load each branch in the background. Nodes will be rendered as soon as
+                // their data has been made available.
+                _fetchPool->enqueue([this, n = _root->Children[i]]() {
                     fetchChildrenNodes(*n, -1);
-                }).detach();
+                });
             }
             _parentNodeOfCamera = 0;
         }
         return;
     }
 
-    // Get leaf node in which the camera resides.
-    glm::vec3 fCameraPos = static_cast<glm::vec3>(
-        cameraPos / (1000.0 * distanceconstants::Parsec)
+    // Fetch the neighborhood of the camera, and of where the camera is predicted to be
+    // shortly, but only when either of them has moved to another parent node.
+    const unsigned long long leafId = leafIdAtPosition(cameraPos);
+    if (_parentNodeOfCamera != leafId / 10) {
+        _parentNodeOfCamera = leafId / 10;
+        fetchNeighborhood(leafId, additionalNodes);
+    }
+
+    const unsigned long long predictedLeafId = leafIdAtPosition(predictedCameraPos);
+    if (_parentNodeOfPrediction != predictedLeafId / 10) {
+        _parentNodeOfPrediction = predictedLeafId / 10;
+        if (_parentNodeOfPrediction != _parentNodeOfCamera) {
+            fetchNeighborhood(predictedLeafId, additionalNodes);
+        }
+    }
+
+    // Check if we should remove any nodes from RAM.
+    unloadLeastRecentlyUsedNodes();
+}
+
+OctreeManager::StreamingStatistics OctreeManager::takeStreamingStatistics() {
+    StreamingStatistics stats;
+    stats.nNodesFetched = _nNodesFetched.exchange(0);
+    stats.nBytesRead = _nBytesRead.exchange(0);
+    stats.nStalls = _nStalls.exchange(0);
+    return stats;
+}
+
+unsigned long long OctreeManager::leafIdAtPosition(const glm::dvec3& position) const {
+    // Get leaf node in which the position resides.
+    glm::vec3 fPos = static_cast<glm::vec3>(
+        position / (1000.0 * distanceconstants::Parsec)
     );
-    size_t idx = getChildIndex(fCameraPos.x, fCameraPos.y, fCameraPos.z);
+    size_t idx = getChildIndex(fPos.x, fPos.y, fPos.z);
     std::shared_ptr<OctreeNode> node = _root->Children[idx];
 
     while (!node->isLeaf) {
         idx = getChildIndex(
-            fCameraPos.x,
-            fCameraPos.y,
-            fCameraPos.z,
+            fPos.x,
+            fPos.y,
+            fPos.z,
             node->originX,
             node->originY,
             node->originZ
         );
         node = node->Children[idx];
     }
-    unsigned long long leafId = node->octreePositionIndex;
-    unsigned long long firstParentId = leafId / 10;
+    return node->octreePositionIndex;
+}
 
-    // Return early if camera resides in the same first parent as before!
-    // Otherwise camera has moved and may need to load more nodes!
-    if (_parentNodeOfCamera == firstParentId) {
-        return;
-    }
-    _parentNodeOfCamera = firstParentId;
+void OctreeManager::fetchNeighborhood(unsigned long long leafId,
+                                      const glm::ivec2& additionalNodes)
+{
+    const unsigned long long firstParentId = leafId / 10;
 
     // Each parent level may be root, make sure to propagate it in that case!
     unsigned long long secondParentId = (firstParentId == 8) ? 8 : leafId / 100;
@@ -215,7 +267,7 @@ void OctreeManager::fetchSurroundingNodes(const glm::dvec3& cameraPos,
     int additionalLevelsToFetch = additionalNodes.y;
 
     // Get more descendants when closer to root.
-    if (_parentNodeOfCamera < 80000) {
+    if (firstParentId < 80000) {
         additionalLevelsToFetch++;
     }
 
@@ -273,24 +325,43 @@ void OctreeManager::fetchSurroundingNodes(const glm::dvec3& cameraPos,
             }
         }
     }
+}
 
-    // Check if we should remove any nodes from RAM.
-    long long tenthOfRamBudget = _maxCpuRamBudget / 10;
-    if (_cpuRamBudget < tenthOfRamBudget) {
-        long long bytesToTenthOfRam = tenthOfRamBudget - _cpuRamBudget;
-        size_t nNodesToRemove = static_cast<size_t>(bytesToTenthOfRam / chunkSizeInBytes);
-        std::vector<unsigned long long> nodesToRemove;
-        while (nNodesToRemove > 0) {
-            // Dequeue nodes that were least recently fetched by findAndFetchNeighborNode.
-            nodesToRemove.push_back(_leastRecentlyFetchedNodes.front());
-            _leastRecentlyFetchedNodes.pop();
-            nNodesToRemove--;
-        }
-        // Use asynchronous removal.
-        if (!nodesToRemove.empty()) {
-            std::thread(&OctreeManager::removeNodesFromRam, this, nodesToRemove).detach();
+void OctreeManager::unloadLeastRecentlyUsedNodes() {
+    const long long tenthOfRamBudget = _maxCpuRamBudget / 10;
+    long long bytesToTenthOfRam = tenthOfRamBudget - _cpuRamBudget;
+    if (bytesToTenthOfRam <= 0) {
+        return;
+    }
+
+    // Pick the least recently used nodes until enough memory would be freed. The
+    // nodes are unlinked from the LRU list right away so they're only picked once.
+    std::vector<unsigned long long> nodesToRemove;
+    {
+        std::lock_guard lock(_loadedNodesMutex);
+        while (bytesToTenthOfRam > 0 && !_loadedNodes.empty()) {
+            const auto [id, nBytes] = _loadedNodes.back();
+            nodesToRemove.push_back(id);
+            bytesToTenthOfRam -= static_cast<long long>(nBytes);
+            _loadedNodesLookup.erase(id);
+            _loadedNodes.pop_back();
         }
     }
+
+    // Use asynchronous removal.
+    if (!nodesToRemove.empty()) {
+        _fetchPool->enqueue([this, nodes = std::move(nodesToRemove)]() {
+            removeNodesFromRam(nodes);
+        });
+    }
+}
+
+void OctreeManager::touchLoadedNode(const OctreeNode& node) {
+    std::lock_guard lock(_loadedNodesMutex);
+    auto it = _loadedNodesLookup.find(node.octreePositionIndex);
+    if (it != _loadedNodesLookup.end()) {
+        _loadedNodes.splice(_loadedNodes.begin(), _loadedNodes, it->second);
+    }
 }
 
 void OctreeManager::findAndFetchNeighborNode(unsigned long long firstParentId, int x,
@@ -384,12 +455,10 @@ void OctreeManager::findAndFetchNeighborNode(unsigned long long firstParentId, i
         indexStack.pop();
     }
 
-    // Fetch all children nodes from found parent. Use multithreading to load files
-    // asynchronously! Detach thread from main execution so it can execute independently.
-    // Thread will then be destroyed when it has finished!
-    std::thread([this, node, additionalLevelsToFetch]() {
+    // Fetch all children nodes from found parent asynchronously on the fetch pool.
+    _fetchPool->enqueue([this, node, additionalLevelsToFetch]() {
         fetchChildrenNodes(*node, additionalLevelsToFetch);
-    }).detach();
+    });
 }
 
 std::map<int, std::vector<float>> OctreeManager::traverseData(const glm::dmat4& mvp,
@@ -598,6 +667,10 @@ int OctreeManager::readFromFile(std::ifstream& inFileStream, bool readData,
     _streamOctree = !readData;
     if (_streamOctree) {
         _streamFolderPath = folderPath;
+        _packedFileOffset = PACKED_FILE_HEADER_SIZE;
+        if (!_fetchPool) {
+            _fetchPool = std::make_unique<ThreadPool>(4);
+        }
     }
 
     _valuesPerStar = 0;
@@ -634,9 +707,50 @@ int OctreeManager::readFromFile(std::ifstream& inFileStream, bool readData,
     for (size_t i = 0; i < 8; ++i) {
         nStarsRead += readNodeFromFile(inFileStream, *_root->Children[i], readData);
     }
+
+    if (_streamOctree) {
+        openPackedFile(_packedFileOffset);
+    }
     return nStarsRead;
 }
 
+void OctreeManager::openPackedFile(size_t nBytesExpected) {
+    std::string packedFilePath = _streamFolderPath + PACKED_FILE_NAME;
+    if (!std::filesystem::is_regular_file(packedFilePath)) {
+        LINFO(fmt::format(
+            "No packed node file found in {}, streaming from one file per node",
+            _streamFolderPath
+        ));
+        return;
+    }
+
+    try {
+        auto file = std::make_unique<MemoryMappedFile>(packedFilePath);
+
+        int32_t header[2] = { 0, 0 };
+        if (file->size() >= PACKED_FILE_HEADER_SIZE) {
+            std::memcpy(header, file->data(), PACKED_FILE_HEADER_SIZE);
+        }
+        if (header[0] != PACKED_FILE_VERSION || header[1] != _valuesPerStar ||
+            file->size() != nBytesExpected)
+        {
+            LWARNING(fmt::format(
+                "Packed node file {} doesn't match the Octree structure, streaming "
+                "from one file per node", packedFilePath
+            ));
+            return;
+        }
+
+        LINFO(fmt::format("Streaming nodes from packed file {}", packedFilePath));
+        _packedFile = std::move(file);
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LWARNING(fmt::format(
+            "Could not map packed node file {}: {}", packedFilePath, e.message
+        ));
+    }
+}
+
 int OctreeManager::readNodeFromFile(std::ifstream& inFileStream, OctreeNode& node,
                                     bool readData)
 {
@@ -650,6 +764,12 @@ int OctreeManager::readNodeFromFile(std::ifstream& inFileStream, OctreeNode& nod
     node.isLeaf = isLeaf;
     node.numStars = numStars;
 
+    // Nodes are stored in the packed file in the same order as in the index file.
+    node.dataFileOffset = _packedFileOffset;
+    if (_streamOctree) {
+        _packedFileOffset += numStars * _valuesPerStar * sizeof(float);
+    }
+
     // Read node data if specified.
     if (readData) {
         int32_t nDataSize = 0;
@@ -754,21 +874,100 @@ void OctreeManager::writeNodeToMultipleFiles(const std::string& outFilePrefix,
     }
 }
 
+void OctreeManager::writeToPackedFile(const std::string& outFolderPath) {
+    std::string outPath = outFolderPath + PACKED_FILE_NAME;
+    std::ofstream outFileStream(outPath, std::ofstream::binary);
+    if (!outFileStream.good()) {
+        LERROR(fmt::format("Error opening file: {} as packed node file.", outPath));
+        return;
+    }
+
+    int32_t valuesPerStar = static_cast<int32_t>(_valuesPerStar);
+    outFileStream.write(
+        reinterpret_cast<const char*>(&PACKED_FILE_VERSION),
+        sizeof(int32_t)
+    );
+    outFileStream.write(reinterpret_cast<const char*>(&valuesPerStar), sizeof(int32_t));
+
+    for (size_t i = 0; i < 8; ++i) {
+        std::string inFilePrefix = outFolderPath + std::to_string(i);
+        writeNodeToPackedFile(outFileStream, inFilePrefix, *_root->Children[i]);
+    }
+}
+
+void OctreeManager::writeNodeToPackedFile(std::ofstream& outFileStream,
+                                          const std::string& inFilePrefix,
+                                          const OctreeNode& node)
+{
+    // The node data has already been cleared from memory, so copy it from the node file
+    // that was written by writeNodeToMultipleFiles (without its size prefix).
+    if (node.numStars > 0) {
+        std::string inPath = inFilePrefix + BINARY_SUFFIX;
+        std::ifstream inFileStream(inPath, std::ifstream::binary);
+        int32_t nDataSize = 0;
+        inFileStream.read(reinterpret_cast<char*>(&nDataSize), sizeof(int32_t));
+
+        std::vector<float> nodeData(nDataSize, 0.f);
+        if (nDataSize > 0) {
+            inFileStream.read(
+                reinterpret_cast<char*>(nodeData.data()),
+                nDataSize * sizeof(float)
+            );
+        }
+
+        // Keep the packed file consistent with the index even if a node file is broken
+        if (!inFileStream.good() ||
+            nodeData.size() != node.numStars * static_cast<size_t>(_valuesPerStar))
+        {
+            LERROR(fmt::format("Error reading node data file: {}", inPath));
+            nodeData.assign(node.numStars * _valuesPerStar, 0.f);
+        }
+        outFileStream.write(
+            reinterpret_cast<const char*>(nodeData.data()),
+            nodeData.size() * sizeof(float)
+        );
+    }
+
+    if (!node.isLeaf) {
+        for (size_t i = 0; i < 8; ++i) {
+            std::string newInFilePrefix = inFilePrefix + std::to_string(i);
+            writeNodeToPackedFile(outFileStream, newInFilePrefix, *node.Children[i]);
+        }
+    }
+}
+
 void OctreeManager::fetchChildrenNodes(OctreeNode& parentNode,
                                        int additionalLevelsToFetch)
 {
-    // Lock node to make sure nobody else are trying to load the same children.
-    std::lock_guard lock(parentNode.loadingLock);
+    // Claim the children that should be fetched while holding the parent's lock to make
+    // sure nobody else is trying to load the same children. The lock is not held while
+    // reading, as the render thread would otherwise skip the already loaded parent for
+    // as long as the whole subtree is being fetched
+    std::array<bool, 8> isClaimed = {};
+    {
+        std::lock_guard lock(parentNode.loadingLock);
+        for (int i = 0; i < 8; ++i) {
+            OctreeNode& child = *parentNode.Children[i];
+            // Fetch node data if we're streaming and it doesn't exist in RAM yet.
+            // (As long as there is any RAM budget left and node actually has any data!)
+            if (child.isLoaded) {
+                touchLoadedNode(child);
+            }
+            else if (!child.isFetching && (child.numStars > 0) &&
+                     _cpuRamBudget > static_cast<long long>(child.numStars *
+                     (POS_SIZE + COL_SIZE + VEL_SIZE) * 4))
+            {
+                child.isFetching = true;
+                isClaimed[i] = true;
+            }
+        }
+    }
 
     for (int i = 0; i < 8; ++i) {
-        // Fetch node data if we're streaming and it doesn't exist in RAM yet.
-        // (As long as there is any RAM budget left and node actually has any data!)
-        if (!parentNode.Children[i]->isLoaded &&
-            (parentNode.Children[i]->numStars > 0) &&
-            _cpuRamBudget > static_cast<long long>(parentNode.Children[i]->numStars
-            * (POS_SIZE + COL_SIZE + VEL_SIZE) * 4))
-        {
+        if (isClaimed[i]) {
             fetchNodeDataFromFile(*parentNode.Children[i]);
+            std::lock_guard lock(parentNode.loadingLock);
+            parentNode.Children[i]->isFetching = false;
         }
 
         // Fetch all Children's Children if recursive is set to true!
@@ -779,47 +978,61 @@ void OctreeManager::fetchChildrenNodes(OctreeNode& parentNode,
 }
 
 void OctreeManager::fetchNodeDataFromFile(OctreeNode& node) {
-    // Remove root ID ("8") from index before loading file.
-    std::string posId = std::to_string(node.octreePositionIndex);
-    posId.erase(posId.begin());
+    const size_t nValues = node.numStars * _valuesPerStar;
+    std::vector<float> readData(nValues, 0.f);
+    const size_t nBytes = nValues * sizeof(float);
 
-    std::string inFilePath = _streamFolderPath + posId + BINARY_SUFFIX;
-    std::ifstream inFileStream(inFilePath, std::ifstream::binary);
-    // LINFO("Fetch node data file: " + inFilePath);
+    if (_packedFile) {
+        // Octree knows if we have any data in this node = it exists. The offsets were
+        // validated against the size of the packed file when it was opened.
+        std::memcpy(readData.data(), _packedFile->data() + node.dataFileOffset, nBytes);
+    }
+    else {
+        // Remove root ID ("8") from index before loading file.
+        std::string posId = std::to_string(node.octreePositionIndex);
+        posId.erase(posId.begin());
 
-    if (inFileStream.good()) {
-        // Read node data.
-        int32_t nDataSize = 0;
+        std::string inFilePath = _streamFolderPath + posId + BINARY_SUFFIX;
+        std::ifstream inFileStream(inFilePath, std::ifstream::binary);
 
         // Octree knows if we have any data in this node = it exists.
         // Otherwise don't call this function!
+        int32_t nDataSize = 0;
         inFileStream.read(reinterpret_cast<char*>(&nDataSize), sizeof(int32_t));
-
-        std::vector<float> readData(nDataSize, 0.f);
-        int nBytes = nDataSize * sizeof(readData[0]);
-        if (nDataSize > 0) {
-            inFileStream.read(reinterpret_cast<char*>(&readData[0]), nBytes);
+        if (!inFileStream.good() || static_cast<size_t>(nDataSize) != nValues) {
+            LERROR("Error opening node data file: " + inFilePath);
+            return;
         }
+        inFileStream.read(reinterpret_cast<char*>(readData.data()), nBytes);
+    }
 
-        int starsInNode = static_cast<int>(nDataSize / _valuesPerStar);
-        auto posEnd = readData.begin() + (starsInNode * POS_SIZE);
-        auto colEnd = posEnd + (starsInNode * COL_SIZE);
-        auto velEnd = colEnd + (starsInNode * VEL_SIZE);
-        node.posData = std::vector<float>(readData.begin(), posEnd);
-        node.colData = std::vector<float>(posEnd, colEnd);
-        node.velData = std::vector<float>(colEnd, velEnd);
+    int starsInNode = static_cast<int>(node.numStars);
+    auto posEnd = readData.begin() + (starsInNode * POS_SIZE);
+    auto colEnd = posEnd + (starsInNode * COL_SIZE);
+    auto velEnd = colEnd + (starsInNode * VEL_SIZE);
+    std::vector<float> posData(readData.begin(), posEnd);
+    std::vector<float> colData(posEnd, colEnd);
+    std::vector<float> velData(colEnd, velEnd);
 
-        // Keep track of nodes that are loaded and update CPU RAM budget.
+    {
+        // Swap in the data while holding the lock so that the render thread never
+        // sees a partially loaded node.
+        std::lock_guard lock(node.loadingLock);
+        node.posData = std::move(posData);
+        node.colData = std::move(colData);
+        node.velData = std::move(velData);
         node.isLoaded = true;
-        if (!_datasetFitInMemory) {
-            std::lock_guard g(_leastRecentlyFetchedNodesMutex);
-            _leastRecentlyFetchedNodes.push(node.octreePositionIndex);
-        }
-        _cpuRamBudget -= nBytes;
     }
-    else {
-        LERROR("Error opening node data file: " + inFilePath);
+
+    // Keep track of nodes that are loaded and update CPU RAM budget.
+    if (!_datasetFitInMemory) {
+        std::lock_guard lock(_loadedNodesMutex);
+        _loadedNodes.emplace_front(node.octreePositionIndex, nBytes);
+        _loadedNodesLookup[node.octreePositionIndex] = _loadedNodes.begin();
     }
+    _cpuRamBudget -= static_cast<long long>(nBytes);
+    _nNodesFetched++;
+    _nBytesRead += nBytes;
 }
 
 void OctreeManager::removeNodesFromRam(
@@ -852,9 +1065,12 @@ void OctreeManager::removeNodesFromRam(
 void OctreeManager::removeNode(OctreeNode& node) {
     // Lock node to make sure nobody else is trying to access it while removing.
     std::lock_guard lock(node.loadingLock);
+    if (!node.isLoaded) {
+        return;
+    }
 
-    int nBytes = static_cast<int>(
-        node.numStars * _valuesPerStar * sizeof(node.posData[0])
+    long long nBytes = static_cast<long long>(
+        node.numStars * _valuesPerStar * sizeof(float)
     );
     // Keep track of which nodes that are loaded and update CPU RAM budget.
     node.isLoaded = false;
@@ -941,7 +1157,7 @@ bool OctreeManager::isRebuildOngoing() const {
 }
 
 size_t OctreeManager::getChildIndex(float posX, float posY, float posZ, float origX,
-                                    float origY, float origZ)
+                                    float origY, float origZ) const
 {
     size_t index = 0;
     if (posX < origX) {
@@ -956,16 +1172,15 @@ size_t OctreeManager::getChildIndex(float posX, float posY, float posZ, float or
     return index;
 }
 
-bool OctreeManager::insertInNode(OctreeNode& node, const std::vector<float>& starValues,
-                                 int depth)
-{
+bool OctreeManager::insertInNode(OctreeNode& node, const float* starValues, int depth) {
     if (node.isLeaf && node.numStars < MAX_STARS_PER_NODE) {
         // Node is a leaf and it's not yet full -> insert star.
         storeStarData(node, starValues);
 
-        if (depth > _totalDepth) {
-            _totalDepth = depth;
-        }
+        size_t totalDepth = _totalDepth;
+        while (static_cast<size_t>(depth) > totalDepth &&
+               !_totalDepth.compare_exchange_weak(totalDepth, static_cast<size_t>(depth)))
+        {}
         return true;
     }
     else if (node.isLeaf) {
@@ -974,19 +1189,17 @@ bool OctreeManager::insertInNode(OctreeNode& node, const std::vector<float>& sta
         createNodeChildren(node);
 
         // Distribute stars from parent node into children.
+        std::vector<float> tmpValues(POS_SIZE + COL_SIZE + VEL_SIZE);
         for (size_t n = 0; n < MAX_STARS_PER_NODE; ++n) {
             // Position data.
             auto posBegin = node.posData.begin() + n * POS_SIZE;
-            auto posEnd = posBegin + POS_SIZE;
-            std::vector<float> tmpValues(posBegin, posEnd);
+            auto tmpEnd = std::copy(posBegin, posBegin + POS_SIZE, tmpValues.begin());
             // Color data.
             auto colBegin = node.colData.begin() + n * COL_SIZE;
-            auto colEnd = colBegin + COL_SIZE;
-            tmpValues.insert(tmpValues.end(), colBegin, colEnd);
+            tmpEnd = std::copy(colBegin, colBegin + COL_SIZE, tmpEnd);
             // Velocity data.
             auto velBegin = node.velData.begin() + n * VEL_SIZE;
-            auto velEnd = velBegin + VEL_SIZE;
-            tmpValues.insert(tmpValues.end(), velBegin, velEnd);
+            std::copy(velBegin, velBegin + VEL_SIZE, tmpEnd);
 
             // Find out which child that will inherit the data and store it.
             size_t index = getChildIndex(
@@ -997,7 +1210,7 @@ bool OctreeManager::insertInNode(OctreeNode& node, const std::vector<float>& sta
                 node.originY,
                 node.originZ
             );
-            insertInNode(*node.Children[index], tmpValues, depth);
+            insertInNode(*node.Children[index], tmpValues.data(), depth);
         }
 
         // Sort magnitudes in inner node.
@@ -1056,8 +1269,7 @@ void OctreeManager::sliceNodeLodCache(OctreeNode& node) {
     }
 }
 
-void OctreeManager::storeStarData(OctreeNode& node, const std::vector<float>& starValues)
-{
+void OctreeManager::storeStarData(OctreeNode& node, const float* starValues) {
     // Insert star data at the back of vectors and store a vector with pairs consisting of
     // star magnitude and insert index for later sorting and slicing of LOD cache.
     float mag = starValues[POS_SIZE];
@@ -1071,11 +1283,12 @@ void OctreeManager::storeStarData(OctreeNode& node, const std::vector<float>& st
         node.magOrder.resize(MAX_STARS_PER_NODE);
     }
 
-    auto posEnd = starValues.begin() + POS_SIZE;
-    auto colEnd = posEnd + COL_SIZE;
-    node.posData.insert(node.posData.end(), starValues.begin(), posEnd);
+    const float* posEnd = starValues + POS_SIZE;
+    const float* colEnd = posEnd + COL_SIZE;
+    const float* velEnd = colEnd + VEL_SIZE;
+    node.posData.insert(node.posData.end(), starValues, posEnd);
     node.colData.insert(node.colData.end(), posEnd, colEnd);
-    node.velData.insert(node.velData.end(), colEnd, starValues.end());
+    node.velData.insert(node.velData.end(), colEnd, velEnd);
 }
 
 std::string OctreeManager::printStarsPerNode(const OctreeNode& node,
@@ -1336,14 +1549,17 @@ bool OctreeManager::updateBufferIndex(OctreeNode& node) {
         _removedKeysInPrevCall.insert(node.bufferIndex);
     }
 
-    // Make sure node isn't loading/unloading as we're checking isLoaded flag.
-    std::lock_guard lock(node.loadingLock);
+    // Make sure node isn't loading/unloading as we're checking isLoaded flag. Never
+    // wait for a fetch in progress, the node will be picked up in a later frame.
+    std::unique_lock lock(node.loadingLock, std::try_to_lock);
+    if (_streamOctree && (!lock.owns_lock() || !node.isLoaded) && node.numStars > 0) {
+        _nStalls++;
+        return false;
+    }
 
-    // Return false if there are no more spots in our buffer, or if we're streaming and
-    // node isn't loaded yet, or if node doesn't have any stars.
-    if (_freeSpotsInBuffer.empty() || (_streamOctree && !node.isLoaded) ||
-        node.numStars == 0)
-    {
+    // Return false if there are no more spots in our buffer, or if node doesn't have any
+    // stars.
+    if (_freeSpotsInBuffer.empty() || node.numStars == 0) {
         return false;
     }
 
@@ -26,12 +26,18 @@
 #define __OPENSPACE_MODULE_GAIA___OCTREEMANAGER___H__
 
 #include <modules/gaia/rendering/gaiaoptions.h>
+#include <openspace/util/memorymappedfile.h>
+#include <openspace/util/threadpool.h>
 #include <ghoul/glm.h>
 #include <ghoul/opengl/ghoul_gl.h>
+#include <atomic>
+#include <list>
 #include <map>
+#include <memory>
 #include <mutex>
-#include <queue>
+#include <set>
 #include <stack>
+#include <unordered_map>
 #include <vector>
 
 namespace openspace {
@@ -54,9 +60,19 @@ public:
         bool isLeaf;
         bool isLoaded;
         bool hasLoadedDescendant;
+        // Set while a task fetches the data of this node, guarded by the parent's lock
+        bool isFetching = false;
         std::mutex loadingLock;
         int bufferIndex;
         unsigned long long octreePositionIndex;
+        // Byte offset of the node data in the packed node file (if streaming)
+        size_t dataFileOffset;
+    };
+
+    struct StreamingStatistics {
+        size_t nNodesFetched = 0;
+        size_t nBytesRead = 0;
+        size_t nStalls = 0;
     };
 
     OctreeManager() = default;
@@ -85,6 +101,26 @@ public:
      */
     void insert(const std::vector<float>& starValues);
 
+    /**
+     * Inserts the star pointed to by \p starValues, which has to point to at least
+     * POS_SIZE + COL_SIZE + VEL_SIZE values, into the Octree.
+     */
+    void insert(const float* starValues);
+
+    /**
+     * \returns the index of the top level branch that the star pointed to by
+     * \p starValues belongs to.
+     */
+    size_t branchIndex(const float* starValues) const;
+
+    /**
+     * Inserts a star into the top level branch \p branchIndex, which has to be the
+     * value returned by <code>branchIndex()</code> for the same star. Stars can be
+     * inserted into different branches concurrently, as long as every branch is only
+     * accessed by one thread at a time.
+     */
+    void insertInBranch(size_t branchIndex, const float* starValues);
+
     /**
      * Slices LOD data so only the MAX_STARS_PER_NODE brightest stars are stored in inner
      * nodes. If \p branchIndex is defined then only that branch will be sliced.
@@ -102,13 +138,22 @@ public:
     /**
      * Used while streaming nodes from files. Checks if any nodes need to be loaded or
      * unloaded. If entire dataset fits in RAM then the whole dataset will be loaded
-     * asynchronously. Otherwise only nodes close to the camera will be fetched.
-     * When RAM stars to fill up least-recently used nodes will start to unload.
-     * Calls <code>findAndFetchNeighborNode()</code> and
-     * <code>removeNodesFromRam()</code> internally.
+     * asynchronously. Otherwise only nodes close to the camera, and close to
+     * \p predictedCameraPos where the camera is expected to be shortly, will be
+     * fetched in the background. When RAM starts to fill up the least recently used
+     * nodes will be unloaded.
+     * Calls <code>fetchNeighborhood()</code> and <code>unloadLeastRecentlyUsedNodes()
+     * </code> internally.
+     */
+    void fetchSurroundingNodes(const glm::dvec3& cameraPos,
+        const glm::dvec3& predictedCameraPos, const glm::ivec2& additionalNodes);
+
+    /**
+     * \returns the number of nodes and bytes that were fetched from disk and the number
+     * of visible nodes that could not be rendered because their data was not available
+     * yet, all since the last call of this function.
      */
-    void fetchSurroundingNodes(const glm::dvec3& cameraPos, size_t chunkSizeInBytes,
-        const glm::ivec2& additionalNodes);
+    StreamingStatistics takeStreamingStatistics();
 
     /**
      * Builds render data structure by traversing the Octree and checking for intersection
@@ -158,6 +203,14 @@ public:
      */
     void writeToMultipleFiles(const std::string& outFolderPath, size_t branchIndex);
 
+    /**
+     * Concatenates all node files that were written by <code>writeToMultipleFiles()
+     * </code> into a single packed file in \p outFolderPath, in the same order as the
+     * nodes are stored in the index file. If the packed file exists, it is memory mapped
+     * when streaming instead of opening one file per node.
+     */
+    void writeToPackedFile(const std::string& outFolderPath);
+
     /**
      * Getters.
      */
@@ -198,12 +251,15 @@ private:
 
     const int DEFAULT_INDEX = -1;
     const std::string BINARY_SUFFIX = ".bin";
+    const std::string PACKED_FILE_NAME = "nodes.bin";
+    const int32_t PACKED_FILE_VERSION = 1;
+    const size_t PACKED_FILE_HEADER_SIZE = 2 * sizeof(int32_t);
 
     /**
      * \returns the correct index of child node. Maps [1,1,1] to 0 and [-1,-1,-1] to 7.
      */
     size_t getChildIndex(float posX, float posY, float posZ, float origX = 0.f,
-        float origY = 0.f, float origZ = 0.f);
+        float origY = 0.f, float origZ = 0.f) const;
 
     /**
      * Private help function for <code>insert()</code>. Inserts star into node if leaf and
@@ -212,8 +268,7 @@ private:
      * If node is an inner node, then star is stores in LOD cache if it is among the
      * brightest stars in all children.
      */
-    bool insertInNode(OctreeNode& node, const std::vector<float>& starValues,
-        int depth = 1);
+    bool insertInNode(OctreeNode& node, const float* starValues, int depth = 1);
 
     /**
      * Slices LOD cache data in node to the MAX_STARS_PER_NODE brightest stars. This needs
@@ -226,7 +281,7 @@ private:
      * Private help function for <code>insertInNode()</code>. Stores star data in node and
      * keeps track of the brightest stars all children.
      */
-    void storeStarData(OctreeNode& node, const std::vector<float>& starValues);
+    void storeStarData(OctreeNode& node, const float* starValues);
 
     /**
      * Private help function for <code>printStarsPerNode()</code>. \returns an accumulated
@@ -309,6 +364,40 @@ private:
     void writeNodeToMultipleFiles(const std::string& outFilePrefix, OctreeNode& node,
         bool threadWrites);
 
+    /**
+     * Appends the data in the node file of \p node, and recursively of all its
+     * descendants, to the packed file \p outFileStream.
+     */
+    void writeNodeToPackedFile(std::ofstream& outFileStream,
+        const std::string& inFilePrefix, const OctreeNode& node);
+
+    /**
+     * Memory maps the packed node file in <code>_streamFolderPath</code> if it exists
+     * and matches the node structure with \p nBytesExpected bytes of node data.
+     */
+    void openPackedFile(size_t nBytesExpected);
+
+    /**
+     * Fetches the 3^3 closest nodes around the leaf \p leafId, and the LOD nodes of
+     * their parents, as specified by \p additionalNodes.
+     */
+    void fetchNeighborhood(unsigned long long leafId, const glm::ivec2& additionalNodes);
+
+    /**
+     * \returns the ID of the leaf node that contains \p position.
+     */
+    unsigned long long leafIdAtPosition(const glm::dvec3& position) const;
+
+    /**
+     * Unloads the least recently used nodes until a tenth of the CPU RAM budget is free.
+     */
+    void unloadLeastRecentlyUsedNodes();
+
+    /**
+     * Marks \p node as the most recently used node.
+     */
+    void touchLoadedNode(const OctreeNode& node);
+
     /**
      * Finds the neighboring node on the same level (or a higher level if there is no
      * corresponding level) in the specified direction. Also fetches data from found node
@@ -329,7 +418,7 @@ private:
     void fetchChildrenNodes(OctreeNode& parentNode, int additionalLevelsToFetch);
 
     /**
-     * Fetches data for specified node from file.
+     * Fetches data for specified node from the packed file or from its own file.
      * OBS! Only call if node file exists (i.e. node has any data, node->numStars > 0)
      * and is not already loaded.
      */
@@ -359,12 +448,26 @@ private:
     std::unique_ptr<OctreeCuller> _culler;
     std::stack<int> _freeSpotsInBuffer;
     std::set<int> _removedKeysInPrevCall;
-    std::queue<unsigned long long> _leastRecentlyFetchedNodes;
-    std::mutex _leastRecentlyFetchedNodesMutex;
 
-    size_t _totalDepth = 0;
-    size_t _numLeafNodes = 0;
-    size_t _numInnerNodes = 0;
+    // Loaded nodes (ID and size in bytes) ordered from most to least recently used
+    std::list<std::pair<unsigned long long, size_t>> _loadedNodes;
+    std::unordered_map<
+        unsigned long long,
+        std::list<std::pair<unsigned long long, size_t>>::iterator
+    > _loadedNodesLookup;
+    std::mutex _loadedNodesMutex;
+
+    std::unique_ptr<MemoryMappedFile> _packedFile;
+    size_t _packedFileOffset = 0;
+
+    std::atomic<size_t> _nNodesFetched = 0;
+    std::atomic<size_t> _nBytesRead = 0;
+    std::atomic<size_t> _nStalls = 0;
+
+    // Atomic as the branches can be constructed concurrently
+    std::atomic<size_t> _totalDepth = 0;
+    std::atomic<size_t> _numLeafNodes = 0;
+    std::atomic<size_t> _numInnerNodes = 0;
     size_t _biggestChunkIndexInUse = 0;
     size_t _valuesPerStar = 0;
     float _minTotalPixelsLod = 0.f;
@@ -374,12 +477,17 @@ private:
     bool _useVBO = false;
     bool _streamOctree = false;
     bool _datasetFitInMemory = false;
-    long long _cpuRamBudget = 0;
+    std::atomic<long long> _cpuRamBudget = 0;
     long long _maxCpuRamBudget = 0;
     unsigned long long _parentNodeOfCamera = 8;
+    unsigned long long _parentNodeOfPrediction = 8;
     std::string _streamFolderPath;
     size_t _traversedBranchesInRenderCall = 0;
 
+    // Loads and unloads nodes in the background while streaming. Declared last so that
+    // it is destroyed (and its threads are joined) before anything they access
+    std::unique_ptr<ThreadPool> _fetchPool;
+
 }; // class OctreeManager
 
 }  // namespace openspace
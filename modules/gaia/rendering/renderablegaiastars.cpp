@@ -163,6 +163,14 @@ namespace {
         "that will be fetched from the found parents."
     };
 
+    constexpr openspace::properties::Property::PropertyInfo PrefetchTimeInfo = {
+        "PrefetchTime",
+        "Prefetch Time",
+        "The number of seconds ahead of the camera, extrapolated from its current "
+        "velocity, for which nodes will be fetched from disk in advance. A value of 0 "
+        "only fetches nodes around the current camera position."
+    };
+
     constexpr openspace::properties::Property::PropertyInfo TmPointPxThresholdInfo = {
         "PixelWeightThreshold",
         "Pixel Weight Threshold",
@@ -218,6 +226,25 @@ namespace {
         "files."
     };
 
+    constexpr openspace::properties::Property::PropertyInfo NumFetchedNodesInfo = {
+        "NumFetchedNodes",
+        "Fetched Nodes",
+        "The number of nodes that were fetched from disk in the last frame."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo FetchedBytesInfo = {
+        "FetchedBytes",
+        "Fetched Bytes",
+        "The number of bytes of node data that were fetched from disk in the last frame."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo NumStalledNodesInfo = {
+        "NumStalledNodes",
+        "Stalled Nodes",
+        "The number of visible nodes in the last frame that could not be rendered "
+        "because their data was still being fetched from disk."
+    };
+
     constexpr openspace::properties::Property::PropertyInfo GpuStreamBudgetInfo = {
         "GpuStreamBudget",
         "GPU Stream Budget",
@@ -412,6 +439,12 @@ documentation::Documentation RenderableGaiaStars::Documentation() {
                 Optional::Yes,
                 AdditionalNodesInfo.description
             },
+            {
+                PrefetchTimeInfo.identifier,
+                new DoubleVerifier,
+                Optional::Yes,
+                PrefetchTimeInfo.description
+            },
             {
                 TmPointPxThresholdInfo.identifier,
                 new DoubleVerifier,
@@ -520,6 +553,7 @@ RenderableGaiaStars::RenderableGaiaStars(const ghoul::Dictionary& dictionary)
     , _tmPointFilterSize(TmPointFilterSizeInfo, 7, 1, 19)
     , _tmPointSigma(TmPointSigmaInfo, 0.7f, 0.1f, 3.f)
     , _additionalNodes(AdditionalNodesInfo, glm::ivec2(1), glm::ivec2(0), glm::ivec2(4))
+    , _prefetchTime(PrefetchTimeInfo, 1.f, 0.f, 10.f)
     , _tmPointPixelWeightThreshold(TmPointPxThresholdInfo, 0.001f, 0.000001f, 0.01f)
     , _lodPixelThreshold(LodPixelThresholdInfo, 250.f, 0.f, 5000.f)
     , _maxGpuMemoryPercent(MaxGpuMemoryPercentInfo, 0.45f, 0.f, 1.f)
@@ -535,6 +569,9 @@ RenderableGaiaStars::RenderableGaiaStars(const ghoul::Dictionary& dictionary)
     , _columnNamesList(ColumnNamesInfo)
     , _nRenderedStars(NumRenderedStarsInfo, 0, 0, 2000000000) // 2 Billion stars
     , _cpuRamBudgetProperty(CpuRamBudgetInfo, 0.f, 0.f, 1.f)
+    , _nFetchedNodes(NumFetchedNodesInfo, 0, 0, 2000000000)
+    , _fetchedBytes(FetchedBytesInfo, 0.f, 0.f, 1e12f)
+    , _nStalledNodes(NumStalledNodesInfo, 0, 0, 2000000000)
     , _gpuStreamBudgetProperty(GpuStreamBudgetInfo, 0.f, 0.f, 1.f)
     , _reportGlErrors(ReportGlErrorsInfo, false)
     , _accumulatedIndices(1, 0)
@@ -730,6 +767,12 @@ RenderableGaiaStars::RenderableGaiaStars(const ghoul::Dictionary& dictionary)
         );
     }
 
+    if (dictionary.hasKey(PrefetchTimeInfo.identifier)) {
+        _prefetchTime = static_cast<float>(
+            dictionary.value<double>(PrefetchTimeInfo.identifier)
+        );
+    }
+
     if (dictionary.hasKey(LodPixelThresholdInfo.identifier)) {
         _lodPixelThreshold = static_cast<float>(
             dictionary.value<double>(LodPixelThresholdInfo.identifier)
@@ -855,6 +898,12 @@ RenderableGaiaStars::RenderableGaiaStars(const ghoul::Dictionary& dictionary)
     // Add CPU RAM Budget Property and GPU Stream Budget Property to menu.
     _cpuRamBudgetProperty.setReadOnly(true);
     addProperty(_cpuRamBudgetProperty);
+    _nFetchedNodes.setReadOnly(true);
+    addProperty(_nFetchedNodes);
+    _fetchedBytes.setReadOnly(true);
+    addProperty(_fetchedBytes);
+    _nStalledNodes.setReadOnly(true);
+    addProperty(_nStalledNodes);
     _gpuStreamBudgetProperty.setReadOnly(true);
     addProperty(_gpuStreamBudgetProperty);
 }
@@ -1166,11 +1215,30 @@ void RenderableGaiaStars::render(const RenderData& data, RendererTasks&) {
     // (if streaming)
     if (_fileReaderOption == gaia::FileReaderOption::StreamOctree) {
         glm::dvec3 cameraPos = data.camera.positionVec3();
-        size_t chunkSizeBytes = _chunkSize * sizeof(GLfloat);
-        _octreeManager.fetchSurroundingNodes(cameraPos, chunkSizeBytes, _additionalNodes);
 
-        // Update CPU Budget property.
+        // Extrapolate the camera position from its velocity to fetch nodes before the
+        // camera gets there.
+        glm::dvec3 predictedCameraPos = cameraPos;
+        const double dt = global::windowDelegate.deltaTime();
+        if (_previousCameraPosition.has_value() && dt > 0.0) {
+            const glm::dvec3 velocity = (cameraPos - *_previousCameraPosition) / dt;
+            predictedCameraPos += velocity * static_cast<double>(_prefetchTime);
+        }
+        _previousCameraPosition = cameraPos;
+
+        _octreeManager.fetchSurroundingNodes(
+            cameraPos,
+            predictedCameraPos,
+            _additionalNodes
+        );
+
+        // Update CPU Budget property and streaming statistics.
         _cpuRamBudgetProperty = static_cast<float>(_octreeManager.cpuRamBudget());
+        OctreeManager::StreamingStatistics stats =
+            _octreeManager.takeStreamingStatistics();
+        _nFetchedNodes = static_cast<int>(stats.nNodesFetched);
+        _fetchedBytes = static_cast<float>(stats.nBytesRead);
+        _nStalledNodes = static_cast<int>(stats.nStalls);
     }
 
     // Traverse Octree and build a map with new nodes to render, uses mvp matrix to decide
@@ -1929,6 +1997,13 @@ void RenderableGaiaStars::update(const UpdateData&) {
             removeProperty(_additionalNodes);
         }
 
+        if (!datasetFitInMemory && !hasProperty(&_prefetchTime)) {
+            addProperty(_prefetchTime);
+        }
+        else if (datasetFitInMemory && hasProperty(&_prefetchTime)) {
+            removeProperty(_prefetchTime);
+        }
+
         LDEBUG(fmt::format(
             "Chunk size: {} - Max streaming budget (bytes): {} - Max nodes in stream: {}",
             _chunkSize, _maxStreamingBudgetInBytes, maxNodesInStream
@@ -39,6 +39,7 @@
 #include <ghoul/opengl/bufferbinding.h>
 #include <ghoul/opengl/ghoul_gl.h>
 #include <ghoul/opengl/uniformcache.h>
+#include <optional>
 
 namespace ghoul::filesystem { class File; }
 namespace ghoul::opengl {
@@ -140,6 +141,7 @@ private:
     properties::IntProperty _tmPointFilterSize;
     properties::FloatProperty _tmPointSigma;
     properties::IVec2Property _additionalNodes;
+    properties::FloatProperty _prefetchTime;
     properties::FloatProperty _tmPointPixelWeightThreshold;
     properties::FloatProperty _lodPixelThreshold;
 
@@ -160,6 +162,9 @@ private:
     properties::IntProperty _nRenderedStars;
     // LongLongProperty doesn't show up in menu, use FloatProperty instead.
     properties::FloatProperty _cpuRamBudgetProperty;
+    properties::IntProperty _nFetchedNodes;
+    properties::FloatProperty _fetchedBytes;
+    properties::IntProperty _nStalledNodes;
     properties::FloatProperty _gpuStreamBudgetProperty;
     properties::FloatProperty _maxGpuMemoryPercent;
     properties::FloatProperty _maxCpuMemoryPercent;
@@ -192,6 +197,7 @@ private:
     int _nStarsToRender = 0;
     bool _firstDrawCalls = true;
     glm::dquat _previousCameraRotation;
+    std::optional<glm::dvec3> _previousCameraPosition;
     bool _useVBO = false;
     long long _cpuRamBudgetInBytes = 0;
     long long _totalDatasetSizeInBytes = 0;
@@ -31,9 +31,19 @@
 #include <ghoul/filesystem/directory.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/dictionary.h>
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <fstream>
 #include <thread>
 
+#ifdef WIN32
+#include <Windows.h>
+#include <psapi.h>
+#else // WIN32
+#include <sys/resource.h>
+#endif // WIN32
+
 namespace {
     constexpr const char* KeyInFileOrFolderPath = "InFileOrFolderPath";
     constexpr const char* KeyOutFileOrFolderPath = "OutFileOrFolderPath";
@@ -67,6 +77,27 @@ namespace {
     constexpr const char* KeyFilterRvError = "FilterRvError";
 
     constexpr const char* _loggerCat = "ConstructOctreeTask";
+
+    // Number of stars that are read from a single file at once
+    constexpr const size_t StarsPerChunk = 1 << 19;
+
+    // Returns the largest amount of physical memory that this process has used so far
+    size_t peakResidentSetSize() {
+#ifdef WIN32
+        PROCESS_MEMORY_COUNTERS info;
+        GetProcessMemoryInfo(GetCurrentProcess(), &info, sizeof(info));
+        return static_cast<size_t>(info.PeakWorkingSetSize);
+#else // WIN32
+        rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+#ifdef __APPLE__
+        return static_cast<size_t>(usage.ru_maxrss);
+#else // __APPLE__
+        // Linux reports the value in kilobytes
+        return static_cast<size_t>(usage.ru_maxrss) * 1024;
+#endif // __APPLE__
+#endif // WIN32
+    }
 } // namespace
 
 namespace openspace {
@@ -216,11 +247,10 @@ void ConstructOctreeTask::perform(const Task::ProgressCallback& onProgress) {
 void ConstructOctreeTask::constructOctreeFromSingleFile(
                                            const Task::ProgressCallback& progressCallback)
 {
-    std::vector<float> fullData;
     int32_t nValues = 0;
     int32_t nValuesPerStar = 0;
     size_t nFilteredStars = 0;
-    int nTotalStars = 0;
+    size_t nTotalStars = 0;
 
     _octreeManager->initOctree(0, _maxDist, _maxStarsPerNode);
 
@@ -274,32 +304,82 @@ void ConstructOctreeTask::constructOctreeFromSingleFile(
     if (inFileStream.good()) {
         inFileStream.read(reinterpret_cast<char*>(&nValues), sizeof(int32_t));
         inFileStream.read(reinterpret_cast<char*>(&nValuesPerStar), sizeof(int32_t));
-
-        fullData.resize(nValues);
-        inFileStream.read(
-            reinterpret_cast<char*>(fullData.data()),
-            nValues * sizeof(fullData[0])
-        );
+        if (nValuesPerStar < RENDER_VALUES) {
+            LERROR(fmt::format(
+                "Error reading file '{}': expected at least {} values per star, got {}",
+                _inFileOrFolderPath, RENDER_VALUES, nValuesPerStar
+            ));
+            return;
+        }
         nTotalStars = nValues / nValuesPerStar;
 
-        progressCallback(0.3f);
         LINFO("Constructing Octree.");
 
-        // Insert star into octree. We assume the data already is in correct order.
-        for (size_t i = 0; i < fullData.size(); i += nValuesPerStar) {
-            auto first = fullData.begin() + i;
-            auto last = fullData.begin() + i + nValuesPerStar;
-            std::vector<float> filterValues(first, last);
-            std::vector<float> renderValues(first, first + RENDER_VALUES);
-
-            // Filter data by parameters.
-            if (checkAllFilters(filterValues)) {
-                nFilteredStars++;
-                continue;
+        // The file is streamed in chunks instead of being read at once, which keeps the
+        // memory footprint independent of the size of the dataset. While the eight top
+        // level branches are constructed from one chunk in parallel, the next chunk is
+        // read from disk
+        const size_t valuesPerStar = static_cast<size_t>(nValuesPerStar);
+        std::vector<float> chunks[2];
+        size_t nStarsLeftInFile = nTotalStars;
+        auto readChunk = [&](std::vector<float>& chunk) {
+            const size_t nStars = std::min(StarsPerChunk, nStarsLeftInFile);
+            chunk.resize(nStars * valuesPerStar);
+            inFileStream.read(
+                reinterpret_cast<char*>(chunk.data()),
+                chunk.size() * sizeof(float)
+            );
+            const size_t nStarsRead = static_cast<size_t>(inFileStream.gcount()) /
+                                      (valuesPerStar * sizeof(float));
+            nStarsLeftInFile = inFileStream.good() ? nStarsLeftInFile - nStars : 0;
+            return nStarsRead;
+        };
+
+        const auto startTime = std::chrono::steady_clock::now();
+        size_t nStarsProcessed = 0;
+        size_t currentChunk = 0;
+        size_t nStarsInChunk = readChunk(chunks[currentChunk]);
+        while (nStarsInChunk > 0) {
+            const float* chunkData = chunks[currentChunk].data();
+            std::array<size_t, 8> nFilteredInBranch = {};
+            std::vector<std::thread> branchThreads;
+            branchThreads.reserve(8);
+            for (size_t branch = 0; branch < 8; ++branch) {
+                branchThreads.emplace_back([&, branch, chunkData, nStarsInChunk]() {
+                    nFilteredInBranch[branch] = insertStarsInBranch(
+                        *_octreeManager,
+                        branch,
+                        chunkData,
+                        nStarsInChunk,
+                        valuesPerStar
+                    );
+                });
             }
 
-            // If all filters passed then insert render values into Octree.
-            _octreeManager->insert(renderValues);
+            currentChunk = 1 - currentChunk;
+            const size_t nStarsInNextChunk = readChunk(chunks[currentChunk]);
+
+            for (std::thread& t : branchThreads) {
+                t.join();
+            }
+            for (size_t n : nFilteredInBranch) {
+                nFilteredStars += n;
+            }
+            nStarsProcessed += nStarsInChunk;
+            nStarsInChunk = nStarsInNextChunk;
+
+            const double seconds = std::chrono::duration<double>(
+                std::chrono::steady_clock::now() - startTime
+            ).count();
+            LINFO(fmt::format(
+                "Inserted {} of {} stars ({:.0f} stars/s, peak memory usage {} MB)",
+                nStarsProcessed, nTotalStars, nStarsProcessed / seconds,
+                peakResidentSetSize() / (1024 * 1024)
+            ));
+            // Leave the last 10% of the progress for slicing and writing the Octree
+            progressCallback(
+                0.9f * static_cast<float>(nStarsProcessed) / nTotalStars
+            );
         }
         inFileStream.close();
     }
@@ -311,8 +391,18 @@ void ConstructOctreeTask::constructOctreeFromSingleFile(
     }
     LINFO(fmt::format("{} of {} read stars were filtered", nFilteredStars, nTotalStars));
 
-    // Slice LOD data before writing to files.
-    _octreeManager->sliceLodData();
+    // Slice LOD data before writing to files. The branches are independent, so they
+    // can be sliced in parallel
+    std::vector<std::thread> sliceThreads;
+    sliceThreads.reserve(8);
+    for (size_t branch = 0; branch < 8; ++branch) {
+        sliceThreads.emplace_back([this, branch]() {
+            _octreeManager->sliceLodData(branch);
+        });
+    }
+    for (std::thread& t : sliceThreads) {
+        t.join();
+    }
 
     LINFO("Writing octree to: " + _outFileOrFolderPath);
     std::ofstream outFileStream(_outFileOrFolderPath, std::ofstream::binary);
@@ -384,7 +474,7 @@ void ConstructOctreeTask::constructOctreeFromFolder(
             ))
             {
                 // Filter data by parameters.
-                if (checkAllFilters(filterValues)) {
+                if (checkAllFilters(filterValues.data())) {
                     nFilteredStars++;
                     continue;
                 }
@@ -398,12 +488,7 @@ void ConstructOctreeTask::constructOctreeFromFolder(
                 //}
 
                 // If all filters passed then insert render values into Octree.
-                std::vector<float> renderValues(
-                    filterValues.begin(),
-                    filterValues.begin() + RENDER_VALUES
-                );
-
-                _indexOctreeManager->insert(renderValues);
+                _indexOctreeManager->insert(filterValues.data());
                 nStarsInfile++;
 
                 //float maxVal = fmax(fmax(fabs(renderValues[0]), fabs(renderValues[1])),
@@ -501,9 +586,37 @@ void ConstructOctreeTask::constructOctreeFromFolder(
     for (int i = 0; i < 8; ++i) {
         writeThreads[i].join();
     }
+
+    // Concatenate all node files into one packed file that can be memory mapped when
+    // streaming. The node files are kept as a fallback.
+    LINFO("Writing packed node file!");
+    _indexOctreeManager->writeToPackedFile(_outFileOrFolderPath);
+}
+
+size_t ConstructOctreeTask::insertStarsInBranch(OctreeManager& octreeManager,
+                                                size_t branchIndex, const float* data,
+                                                size_t nStars, size_t valuesPerStar) const
+{
+    size_t nFilteredStars = 0;
+    for (size_t i = 0; i < nStars; ++i) {
+        const float* star = data + i * valuesPerStar;
+        if (octreeManager.branchIndex(star) != branchIndex) {
+            continue;
+        }
+
+        // Filter data by parameters.
+        if (checkAllFilters(star)) {
+            nFilteredStars++;
+            continue;
+        }
+
+        // If all filters passed then insert render values into Octree.
+        octreeManager.insertInBranch(branchIndex, star);
+    }
+    return nFilteredStars;
 }
 
-bool ConstructOctreeTask::checkAllFilters(const std::vector<float>& filterValues) {
+bool ConstructOctreeTask::checkAllFilters(const float* filterValues) const {
     // Return true if star is caught in any filter.
     return (_filterPosX && filterStar(_posX, filterValues[0])) ||
         (_filterPosY && filterStar(_posY, filterValues[1])) ||
@@ -532,7 +645,7 @@ bool ConstructOctreeTask::checkAllFilters(const std::vector<float>& filterValues
 }
 
 bool ConstructOctreeTask::filterStar(const glm::vec2& range, float filterValue,
-                                     float normValue)
+                                     float normValue) const
 {
     // Return true if star should be filtered away, i.e. if min = max = filterValue or
     // if filterValue < min (when min != 0.0) or filterValue > max (when max != 0.0).
@@ -62,13 +62,22 @@ private:
      */
     void constructOctreeFromFolder(const Task::ProgressCallback& progressCallback);
 
+    /**
+     * Filters the \p nStars stars in \p data that belong to the top level branch
+     * \p branchIndex and inserts the remaining ones into that branch of the
+     * \p octreeManager. Can be called concurrently for different branches.
+     * \returns the number of stars in the branch that were filtered away.
+     */
+    size_t insertStarsInBranch(OctreeManager& octreeManager, size_t branchIndex,
+        const float* data, size_t nStars, size_t valuesPerStar) const;
+
     /**
      * Checks all defined filter ranges and \returns true if any of the corresponding
      * <code>filterValues</code> are outside of the defined range.
      * \returns false if value should be inserted into Octree.
      * \param filterValues are all read filter values in binary file.
      */
-    bool checkAllFilters(const std::vector<float>& filterValues);
+    bool checkAllFilters(const float* filterValues) const;
 
     /**
      * \returns true if star should be filtered away and false if all filters passed.
@@ -76,7 +85,8 @@ private:
      * star. Star is filtered either if min = max = filterValue or if filterValue < min
      * (when min != 0.0) or filterValue > max (when max != 0.0).
      */
-    bool filterStar(const glm::vec2& range, float filterValue, float normValue = 0.f);
+    bool filterStar(const glm::vec2& range, float filterValue,
+        float normValue = 0.f) const;
 
     std::string _inFileOrFolderPath;
     std::string _outFileOrFolderPath;
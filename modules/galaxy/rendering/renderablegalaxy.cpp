@@ -306,6 +306,11 @@ void RenderableGalaxy::update(const UpdateData& data) {
     }
 }
 
+bool RenderableGalaxy::isUpdateGLBound() const {
+    // The transformations are computed on the CPU and only stored in the raycaster
+    return false;
+}
+
 void RenderableGalaxy::render(const RenderData& data, RendererTasks& tasks) {
     RaycasterTask task { _raycaster.get(), data };
 
@@ -48,6 +48,7 @@ public:
     bool isReady() const override;
     void render(const RenderData& data, RendererTasks& tasks) override;
     void update(const UpdateData& data) override;
+    bool isUpdateGLBound() const override;
 
 private:
     float safeLength(const glm::vec3& vector) const;
@@ -93,6 +93,15 @@ namespace {
         "property will not affect already created WMS datasets."
     };
 
+    constexpr const openspace::properties::Property::PropertyInfo TileThreadsInfo = {
+        "TileLoadingThreads",
+        "Tile Loading Threads",
+        "The number of threads that each layer uses to load tiles concurrently. Each "
+        "thread reads from its own handle to the layer's dataset, so the total number "
+        "of threads and open datasets grows with the number of layers. Changing the "
+        "value of this property will not affect already created layers."
+    };
+
 
     openspace::GlobeBrowsingModule::Capabilities
     parseSubDatasets(char** subDatasets, int nSubdatasets)
@@ -154,11 +163,13 @@ GlobeBrowsingModule::GlobeBrowsingModule()
     , _offlineMode(OfflineModeInfo, false)
     , _cacheLocation(CacheLocationInfo, "${BASE}/cache_gdal")
     , _cacheSizeMB(CacheSizeInfo, 1024)
+    , _nTileLoadingThreads(TileThreadsInfo, 1, 1, 32)
 {
     addProperty(_cacheEnabled);
     addProperty(_offlineMode);
     addProperty(_cacheLocation);
     addProperty(_cacheSizeMB);
+    addProperty(_nTileLoadingThreads);
 }
 
 void GlobeBrowsingModule::internalInitialize(const ghoul::Dictionary& dict) {
@@ -176,6 +187,11 @@ void GlobeBrowsingModule::internalInitialize(const ghoul::Dictionary& dict) {
     if (dict.hasKeyAndValue<double>(CacheSizeInfo.identifier)) {
         _cacheSizeMB = static_cast<int>(dict.value<double>(CacheSizeInfo.identifier));
     }
+    if (dict.hasKeyAndValue<double>(TileThreadsInfo.identifier)) {
+        _nTileLoadingThreads = static_cast<unsigned int>(
+            dict.value<double>(TileThreadsInfo.identifier)
+        );
+    }
 
     // Sanity check
     const bool noWarning = dict.hasKeyAndValue<bool>("NoWarning") ?
@@ -709,5 +725,9 @@ uint64_t GlobeBrowsingModule::cacheSize() const {
     return size * 1024 * 1024;
 }
 
+unsigned int GlobeBrowsingModule::numberOfTileLoadingThreads() const {
+    return _nTileLoadingThreads;
+}
+
 
 } // namespace openspace
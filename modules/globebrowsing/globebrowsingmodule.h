@@ -89,6 +89,7 @@ public:
     bool isInOfflineMode() const;
     std::string cacheLocation() const;
     uint64_t cacheSize() const; // bytes
+    unsigned int numberOfTileLoadingThreads() const;
 
 protected:
     void internalInitialize(const ghoul::Dictionary&) override;
@@ -117,6 +118,7 @@ private:
     properties::BoolProperty _offlineMode;
     properties::StringProperty _cacheLocation;
     properties::UIntProperty _cacheSizeMB;
+    properties::UIntProperty _nTileLoadingThreads;
 
     std::unique_ptr<globebrowsing::cache::MemoryAwareTileCache> _tileCache;
 
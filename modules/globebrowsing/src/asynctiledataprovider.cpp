@@ -42,10 +42,13 @@ namespace {
 AsyncTileDataProvider::AsyncTileDataProvider(std::string name,
                                     std::unique_ptr<RawTileDataReader> rawTileDataReader)
     : _name(std::move(name))
+    , _globeBrowsingModule(global::moduleEngine.module<GlobeBrowsingModule>())
     , _rawTileDataReader(std::move(rawTileDataReader))
-    , _concurrentJobManager(LRUThreadPool<TileIndex::TileHashKey>(1, 10))
+    , _concurrentJobManager(LRUThreadPool<TileIndex::TileHashKey>(
+        _globeBrowsingModule->numberOfTileLoadingThreads(),
+        10
+    ))
 {
-    _globeBrowsingModule = global::moduleEngine.module<GlobeBrowsingModule>();
     performReset(ResetRawTileDataReader::No);
 }
 
@@ -0,0 +1,212 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <modules/globebrowsing/src/disktilestore.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <iterator>
+#include <limits>
+
+namespace {
+    constexpr const char* _loggerCat = "DiskTileStore";
+} // namespace
+
+namespace openspace::globebrowsing::cache {
+
+DiskTileStore::DiskTileStore(std::string path, size_t budget)
+    : _path(std::move(path))
+    , _budget(budget)
+{
+    _file.open(
+        _path,
+        std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc
+    );
+    if (!_file.good()) {
+        LERROR(fmt::format("Could not open tile store '{}'", _path));
+    }
+}
+
+DiskTileStore::~DiskTileStore() {
+    if (_file.is_open()) {
+        _file.close();
+        // The content is meaningless for the next session, so we can reclaim the space
+        std::remove(_path.c_str());
+    }
+}
+
+bool DiskTileStore::put(const ProviderTileKey& key, const CompressedTile& tile) {
+    const size_t nBytes = tile.data.size();
+    if (!_file.is_open() || nBytes == 0 || nBytes > _budget) {
+        return false;
+    }
+
+    const auto it = _entries.find(key);
+    if (it != _entries.end()) {
+        removeEntry(it);
+    }
+
+    if (_writeOffset + nBytes > _budget) {
+        // Wrap around and start overwriting the oldest tiles from the beginning. The
+        // tiles at the end of the file will be overwritten in the next lap
+        _writeOffset = 0;
+    }
+    invalidateRange(_writeOffset, _writeOffset + nBytes);
+
+    _file.clear();
+    _file.seekp(static_cast<std::streamoff>(_writeOffset));
+    _file.write(
+        reinterpret_cast<const char*>(tile.data.data()),
+        static_cast<std::streamsize>(nBytes)
+    );
+    if (!_file.good()) {
+        LERROR(fmt::format("Error writing to tile store '{}'", _path));
+        _file.clear();
+        return false;
+    }
+
+    Entry e = {
+        _writeOffset,
+        nBytes,
+        tile.initDataKey,
+        tile.uncompressedSize,
+        tile.metaData
+    };
+    _entries.emplace(key, std::move(e));
+    _entriesByOffset.emplace(_writeOffset, key);
+    _writeOffset += nBytes;
+    _nBytesStored += nBytes;
+    return true;
+}
+
+std::optional<CompressedTile> DiskTileStore::take(const ProviderTileKey& key) {
+    const auto it = _entries.find(key);
+    if (it == _entries.end()) {
+        return std::nullopt;
+    }
+
+    CompressedTile tile;
+    tile.initDataKey = it->second.initDataKey;
+    tile.uncompressedSize = it->second.uncompressedSize;
+    tile.metaData = std::move(it->second.metaData);
+    tile.data.resize(it->second.nBytes);
+
+    _file.clear();
+    _file.seekg(static_cast<std::streamoff>(it->second.offset));
+    _file.read(
+        reinterpret_cast<char*>(tile.data.data()),
+        static_cast<std::streamsize>(it->second.nBytes)
+    );
+    const bool success = _file.good();
+    removeEntry(it);
+
+    if (!success) {
+        LERROR(fmt::format("Error reading from tile store '{}'", _path));
+        _file.clear();
+        return std::nullopt;
+    }
+    return tile;
+}
+
+bool DiskTileStore::exist(const ProviderTileKey& key) const {
+    return _entries.find(key) != _entries.end();
+}
+
+void DiskTileStore::clear() {
+    _entries.clear();
+    _entriesByOffset.clear();
+    _writeOffset = 0;
+    _nBytesStored = 0;
+}
+
+void DiskTileStore::setBudget(size_t budget) {
+    if (budget < _budget) {
+        invalidateRange(budget, std::numeric_limits<size_t>::max());
+        _writeOffset = std::min(_writeOffset, budget);
+        shrinkFile(budget);
+    }
+    _budget = budget;
+}
+
+void DiskTileStore::shrinkFile(size_t nBytes) {
+    if (!_file.is_open()) {
+        return;
+    }
+
+    // The file has to be closed to be resized, but it is not truncated when it is
+    // opened again, as the tiles in front of the new end are still valid
+    _file.close();
+    std::error_code ec;
+    const uintmax_t fileSize = std::filesystem::file_size(_path, ec);
+    if (!ec && fileSize > nBytes) {
+        std::filesystem::resize_file(_path, nBytes, ec);
+        if (ec) {
+            LWARNING(fmt::format(
+                "Could not shrink tile store '{}': {}", _path, ec.message()
+            ));
+        }
+    }
+
+    _file.open(_path, std::ios::in | std::ios::out | std::ios::binary);
+    if (!_file.good()) {
+        LERROR(fmt::format("Could not reopen tile store '{}'", _path));
+        clear();
+    }
+}
+
+size_t DiskTileStore::size() const {
+    return _nBytesStored;
+}
+
+void DiskTileStore::invalidateRange(size_t begin, size_t end) {
+    // The entry starting before 'begin' might extend into the range
+    auto it = _entriesByOffset.lower_bound(begin);
+    if (it != _entriesByOffset.begin()) {
+        auto prev = std::prev(it);
+        const auto e = _entries.find(prev->second);
+        if (e->second.offset + e->second.nBytes > begin) {
+            it = prev;
+        }
+    }
+
+    while (it != _entriesByOffset.end() && it->first < end) {
+        const auto e = _entries.find(it->second);
+        ++it;
+        removeEntry(e);
+    }
+}
+
+void DiskTileStore::removeEntry(std::unordered_map<ProviderTileKey, Entry,
+                                                   ProviderTileHasher>::iterator it)
+{
+    _nBytesStored -= it->second.nBytes;
+    _entriesByOffset.erase(it->second.offset);
+    _entries.erase(it);
+}
+
+} // namespace openspace::globebrowsing::cache
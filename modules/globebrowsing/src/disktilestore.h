@@ -0,0 +1,113 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_MODULE_GLOBEBROWSING___DISK_TILE_STORE___H__
+#define __OPENSPACE_MODULE_GLOBEBROWSING___DISK_TILE_STORE___H__
+
+#include <modules/globebrowsing/src/memoryawaretilecache.h>
+#include <fstream>
+#include <map>
+#include <optional>
+#include <string>
+#include <unordered_map>
+
+namespace openspace::globebrowsing::cache {
+
+/**
+ * The last tier of the MemoryAwareTileCache. Compressed tiles that are evicted from the
+ * CPU tier are appended to a single blob file which is used as a ring buffer of at most
+ * \c budget bytes. When the write position wraps around, all tiles whose data is
+ * overwritten are dropped from the store. The index (position, size, and metadata of
+ * each tile) is kept in memory, so a lookup costs exactly one read from the file.
+ *
+ * The content of the file is only valid for the lifetime of the store, as the provider
+ * identifiers that are part of the keys are assigned anew every session.
+ */
+class DiskTileStore {
+public:
+    /**
+     * Creates a store that is backed by the file at \p path, which is truncated if it
+     * exists. If the file cannot be opened, the store stays empty and all calls to #put
+     * fail.
+     */
+    DiskTileStore(std::string path, size_t budget);
+    ~DiskTileStore();
+
+    /**
+     * Writes the \p tile into the blob file, replacing a previous tile with the same
+     * \p key. Returns \c false if the tile could not be stored, which is the case if
+     * it is larger than the budget or if the file could not be written.
+     */
+    bool put(const ProviderTileKey& key, const CompressedTile& tile);
+
+    /**
+     * Reads the tile for the \p key from the blob file and removes it from the store.
+     * Returns \c std::nullopt if no tile for the \p key exists.
+     */
+    std::optional<CompressedTile> take(const ProviderTileKey& key);
+
+    bool exist(const ProviderTileKey& key) const;
+
+    void clear();
+
+    /**
+     * Changes the maximum number of bytes that the blob file can grow to. Reducing the
+     * budget drops all tiles that are stored beyond the new limit and shrinks the file.
+     */
+    void setBudget(size_t budget);
+
+    /// Returns the number of bytes that are occupied by valid tiles
+    size_t size() const;
+
+private:
+    struct Entry {
+        size_t offset;
+        size_t nBytes;
+        TileTextureInitData::HashKey initDataKey;
+        size_t uncompressedSize;
+        std::optional<TileMetaData> metaData;
+    };
+
+    /// Removes all entries that overlap with the range [begin, end)
+    void invalidateRange(size_t begin, size_t end);
+    /// Truncates the blob file to at most \p nBytes
+    void shrinkFile(size_t nBytes);
+    void removeEntry(std::unordered_map<ProviderTileKey, Entry,
+        ProviderTileHasher>::iterator it);
+
+    std::string _path;
+    std::fstream _file;
+    size_t _budget;
+    size_t _writeOffset = 0;
+    size_t _nBytesStored = 0;
+
+    std::unordered_map<ProviderTileKey, Entry, ProviderTileHasher> _entries;
+    /// Maps the offset of every entry in the file to its key, ordered by offset
+    std::map<size_t, ProviderTileKey> _entriesByOffset;
+};
+
+} // namespace openspace::globebrowsing::cache
+
+#endif // __OPENSPACE_MODULE_GLOBEBROWSING___DISK_TILE_STORE___H__
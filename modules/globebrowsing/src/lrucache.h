@@ -25,8 +25,9 @@
 #ifndef __OPENSPACE_MODULE_GLOBEBROWSING___LRU_CACHE___H__
 #define __OPENSPACE_MODULE_GLOBEBROWSING___LRU_CACHE___H__
 
-#include <list>
-#include <unordered_map>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
 #include <vector>
 
 namespace openspace::globebrowsing::cache {
@@ -34,17 +35,26 @@ namespace openspace::globebrowsing::cache {
 /**
  * Templated class implementing a Least-Recently-Used Cache.
  * <code>KeyType</code> needs to be an enumerable type.
+ *
+ * The items are stored in a contiguous node arena that is linked into an intrusive
+ * doubly linked list in the order of their usage. The nodes are found through an open
+ * addressing hash table with linear probing. Nodes that are removed from the cache are
+ * kept on a free list and reused, so after the cache has reached its working size, no
+ * more allocations happen and touching an item is a constant-time relinking of the node.
+ * Both <code>KeyType</code> and <code>ValueType</code> have to be default constructible
+ * and <code>ValueType</code> may be move-only.
  */
 template <typename KeyType, typename ValueType, typename HasherType>
 class LRUCache {
 public:
     using Item = std::pair<KeyType, ValueType>;
-    using Items = std::list<Item>;
 
     /**
      * \param size is the maximum size of the cache given in number of cached items.
+     * \param reservedSize is the number of items for which memory is allocated up front.
+     *        If it is 0, the memory for <code>min(size, 1024)</code> items is allocated
      */
-    LRUCache(size_t size);
+    LRUCache(size_t size, size_t reservedSize = 0);
 
     void put(KeyType key, ValueType value);
     std::vector<Item> putAndFetchPopped(KeyType key, ValueType value);
@@ -57,7 +67,20 @@ public:
      */
     bool touch(const KeyType& key);
     bool isEmpty() const;
-    ValueType get(const KeyType& key);
+
+    /**
+     * Returns the value for the \p key and bumps it to the front of the queue. The
+     * returned reference is valid until the next modification of the cache.
+     * \pre \p key must exist in the cache
+     */
+    ValueType& get(const KeyType& key);
+
+    /**
+     * Returns a pointer to the value for the \p key and bumps it to the front of the
+     * queue, or <code>nullptr</code> if the key does not exist. The returned pointer is
+     * valid until the next modification of the cache.
+     */
+    ValueType* find(const KeyType& key);
 
     /**
      * Pops the front of the queue.
@@ -72,15 +95,41 @@ public:
     size_t maximumCacheSize() const;
 
 private:
+    using Index = uint32_t;
+    static constexpr const Index InvalidIndex = static_cast<Index>(-1);
+
+    struct Node {
+        KeyType key;
+        ValueType value;
+        size_t hash = 0;
+        Index previous = InvalidIndex;
+        Index next = InvalidIndex;
+    };
+
     void putWithoutCleaning(KeyType key, ValueType value);
     void clean();
-
     std::vector<Item> cleanAndFetchPopped();
 
-    Items _itemList;
-    std::unordered_map<KeyType, typename Items::const_iterator, HasherType> _itemMap;
+    size_t hash(const KeyType& key) const;
+    Index findNode(const KeyType& key, size_t hash) const;
+    void insertIntoTable(Index node);
+    void eraseFromTable(Index node);
+    void rehash(size_t nBuckets);
+
+    void unlink(Index node);
+    void linkFront(Index node);
+    Index allocateNode(KeyType key, ValueType value, size_t hash);
+    Item releaseNode(Index node);
+
+    std::vector<Node> _nodes;
+    std::vector<Index> _freeNodes;
+    std::vector<Index> _buckets;
+    Index _mru = InvalidIndex;
+    Index _lru = InvalidIndex;
+    size_t _size = 0;
 
     size_t _maximumCacheSize;
+    HasherType _hasher;
 };
 
 } // namespace openspace::globebrowsing::cache
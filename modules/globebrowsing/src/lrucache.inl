@@ -23,18 +23,37 @@
  ****************************************************************************************/
 
 #include <ghoul/misc/assert.h>
+#include <algorithm>
 
 namespace openspace::globebrowsing::cache {
 
 template<typename KeyType, typename ValueType, typename HasherType>
-LRUCache<KeyType, ValueType, HasherType>::LRUCache(size_t size)
+LRUCache<KeyType, ValueType, HasherType>::LRUCache(size_t size, size_t reservedSize)
     : _maximumCacheSize(size)
-{}
+{
+    constexpr const size_t DefaultReservedSize = 1024;
+    if (reservedSize == 0) {
+        reservedSize = std::min(size, DefaultReservedSize);
+    }
+    _nodes.reserve(reservedSize);
+    _freeNodes.reserve(reservedSize);
+
+    // Keep the load factor of the hash table at or below 0.5
+    size_t nBuckets = 16;
+    while (nBuckets < 2 * reservedSize) {
+        nBuckets *= 2;
+    }
+    _buckets.resize(nBuckets, InvalidIndex);
+}
 
 template<typename KeyType, typename ValueType, typename HasherType>
 void LRUCache<KeyType, ValueType, HasherType>::clear() {
-    _itemList.clear();
-    _itemMap.clear();
+    _nodes.clear();
+    _freeNodes.clear();
+    std::fill(_buckets.begin(), _buckets.end(), InvalidIndex);
+    _mru = InvalidIndex;
+    _lru = InvalidIndex;
+    _size = 0;
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
@@ -53,67 +72,58 @@ LRUCache<KeyType, ValueType, HasherType>::putAndFetchPopped(KeyType key, ValueTy
 
 template<typename KeyType, typename ValueType, typename HasherType>
 bool LRUCache<KeyType, ValueType, HasherType>::exist(const KeyType& key) const {
-    return (_itemMap.count(key) > 0);
+    return findNode(key, hash(key)) != InvalidIndex;
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 bool LRUCache<KeyType, ValueType, HasherType>::touch(const KeyType& key) {
-    const auto it = _itemMap.find(key);
-    if (it != _itemMap.end()) { // Found in cache
-        ValueType value = it->second->second;
-        // Remove from current position
-        _itemList.erase(it->second);
-        _itemMap.erase(it);
-        // Bump to front
-        _itemList.emplace_front(key, value);
-        _itemMap.emplace(key, _itemList.begin());
-
-        return true;
-    } else {
+    const Index node = findNode(key, hash(key));
+    if (node == InvalidIndex) {
         return false;
     }
+    unlink(node);
+    linkFront(node);
+    return true;
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 bool LRUCache<KeyType, ValueType, HasherType>::isEmpty() const {
-    return (_itemMap.size() == 0);
+    return _size == 0;
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
-ValueType LRUCache<KeyType, ValueType, HasherType>::get(const KeyType& key) {
-    //ghoul_assert(exist(key), "Key " << key << " must exist");
-    const auto it = _itemMap.find(key);
-    // Move list iterator pointing to value
-    _itemList.splice(_itemList.begin(), _itemList, it->second);
-    return it->second->second;
+ValueType& LRUCache<KeyType, ValueType, HasherType>::get(const KeyType& key) {
+    ValueType* value = find(key);
+    ghoul_assert(value, "Key must exist in the cache");
+    return *value;
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
-std::pair<KeyType, ValueType> LRUCache<KeyType, ValueType, HasherType>::popMRU() {
-    ghoul_assert(!_itemList.empty(), "Cannot pop LRU cache. Ensure cache is not empty.");
+ValueType* LRUCache<KeyType, ValueType, HasherType>::find(const KeyType& key) {
+    const Index node = findNode(key, hash(key));
+    if (node == InvalidIndex) {
+        return nullptr;
+    }
+    unlink(node);
+    linkFront(node);
+    return &_nodes[node].value;
+}
 
-    auto first_it = _itemList.begin();
-    _itemMap.erase(first_it->first);
-    std::pair<KeyType, ValueType> toReturn = _itemList.front();
-    _itemList.pop_front();
-    return toReturn;
+template<typename KeyType, typename ValueType, typename HasherType>
+std::pair<KeyType, ValueType> LRUCache<KeyType, ValueType, HasherType>::popMRU() {
+    ghoul_assert(_size > 0, "Cannot pop LRU cache. Ensure cache is not empty.");
+    return releaseNode(_mru);
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 std::pair<KeyType, ValueType> LRUCache<KeyType, ValueType, HasherType>::popLRU() {
-    ghoul_assert(!_itemList.empty(), "Cannot pop LRU cache. Ensure cache is not empty.");
-
-    auto lastIt = _itemList.end();
-    lastIt--;
-    _itemMap.erase(lastIt->first);
-    std::pair<KeyType, ValueType> toReturn = _itemList.back();
-    _itemList.pop_back();
-    return toReturn;
+    ghoul_assert(_size > 0, "Cannot pop LRU cache. Ensure cache is not empty.");
+    return releaseNode(_lru);
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 size_t LRUCache<KeyType, ValueType, HasherType>::size() const {
-    return _itemMap.size();
+    return _size;
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
@@ -125,22 +135,28 @@ template<typename KeyType, typename ValueType, typename HasherType>
 void LRUCache<KeyType, ValueType, HasherType>::putWithoutCleaning(KeyType key,
                                                                   ValueType value)
 {
-    const auto it = _itemMap.find(key);
-    if (it != _itemMap.end()) {
-        _itemList.erase(it->second);
-        _itemMap.erase(it);
+    const size_t h = hash(key);
+    const Index existing = findNode(key, h);
+    if (existing != InvalidIndex) {
+        _nodes[existing].value = std::move(value);
+        unlink(existing);
+        linkFront(existing);
+        return;
+    }
+
+    if (2 * (_size + 1) > _buckets.size()) {
+        rehash(2 * _buckets.size());
     }
-    _itemList.emplace_front(key, std::move(value));
-    _itemMap.emplace(std::move(key), _itemList.begin());
+    const Index node = allocateNode(std::move(key), std::move(value), h);
+    insertIntoTable(node);
+    linkFront(node);
+    ++_size;
 }
 
 template<typename KeyType, typename ValueType, typename HasherType>
 void LRUCache<KeyType, ValueType, HasherType>::clean() {
-    while (_itemMap.size() > _maximumCacheSize) {
-        auto lastIt = _itemList.end();
-        lastIt--;
-        _itemMap.erase(lastIt->first);
-        _itemList.pop_back();
+    while (_size > _maximumCacheSize) {
+        releaseNode(_lru);
     }
 }
 
@@ -149,14 +165,155 @@ std::vector<std::pair<KeyType, ValueType>>
 LRUCache<KeyType, ValueType, HasherType>::cleanAndFetchPopped()
 {
     std::vector<std::pair<KeyType, ValueType>> toReturn;
-    while (_itemMap.size() > _maximumCacheSize) {
-        auto lastIt = _itemList.end();
-        lastIt--;
-        _itemMap.erase(lastIt->first);
-        toReturn.push_back(_itemList.back());
-        _itemList.pop_back();
+    while (_size > _maximumCacheSize) {
+        toReturn.push_back(releaseNode(_lru));
     }
     return toReturn;
 }
 
+template<typename KeyType, typename ValueType, typename HasherType>
+size_t LRUCache<KeyType, ValueType, HasherType>::hash(const KeyType& key) const {
+    // The provided hashers are often not well distributed in the lower bits, so we mix
+    // the bits before using them as a bucket index (MurmurHash3 finalizer)
+    uint64_t h = static_cast<uint64_t>(_hasher(key));
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return static_cast<size_t>(h);
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+typename LRUCache<KeyType, ValueType, HasherType>::Index
+LRUCache<KeyType, ValueType, HasherType>::findNode(const KeyType& key, size_t hash) const
+{
+    const size_t mask = _buckets.size() - 1;
+    for (size_t i = hash & mask; _buckets[i] != InvalidIndex; i = (i + 1) & mask) {
+        const Node& node = _nodes[_buckets[i]];
+        if (node.hash == hash && node.key == key) {
+            return _buckets[i];
+        }
+    }
+    return InvalidIndex;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void LRUCache<KeyType, ValueType, HasherType>::insertIntoTable(Index node) {
+    const size_t mask = _buckets.size() - 1;
+    size_t i = _nodes[node].hash & mask;
+    while (_buckets[i] != InvalidIndex) {
+        i = (i + 1) & mask;
+    }
+    _buckets[i] = node;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void LRUCache<KeyType, ValueType, HasherType>::eraseFromTable(Index node) {
+    const size_t mask = _buckets.size() - 1;
+    size_t i = _nodes[node].hash & mask;
+    while (_buckets[i] != node) {
+        i = (i + 1) & mask;
+    }
+
+    // Backward shift deletion: move following entries of the probe sequence into the
+    // hole unless they are already located between their home bucket and the hole
+    _buckets[i] = InvalidIndex;
+    size_t j = i;
+    while (true) {
+        j = (j + 1) & mask;
+        if (_buckets[j] == InvalidIndex) {
+            break;
+        }
+        const size_t home = _nodes[_buckets[j]].hash & mask;
+        const bool isBetween = (i <= j) ?
+            (i < home && home <= j) :
+            (i < home || home <= j);
+        if (!isBetween) {
+            _buckets[i] = _buckets[j];
+            _buckets[j] = InvalidIndex;
+            i = j;
+        }
+    }
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void LRUCache<KeyType, ValueType, HasherType>::rehash(size_t nBuckets) {
+    _buckets.assign(nBuckets, InvalidIndex);
+    for (Index node = _mru; node != InvalidIndex; node = _nodes[node].next) {
+        insertIntoTable(node);
+    }
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void LRUCache<KeyType, ValueType, HasherType>::unlink(Index node) {
+    Node& n = _nodes[node];
+    if (n.previous != InvalidIndex) {
+        _nodes[n.previous].next = n.next;
+    }
+    else {
+        _mru = n.next;
+    }
+    if (n.next != InvalidIndex) {
+        _nodes[n.next].previous = n.previous;
+    }
+    else {
+        _lru = n.previous;
+    }
+    n.previous = InvalidIndex;
+    n.next = InvalidIndex;
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+void LRUCache<KeyType, ValueType, HasherType>::linkFront(Index node) {
+    Node& n = _nodes[node];
+    n.previous = InvalidIndex;
+    n.next = _mru;
+    if (_mru != InvalidIndex) {
+        _nodes[_mru].previous = node;
+    }
+    _mru = node;
+    if (_lru == InvalidIndex) {
+        _lru = node;
+    }
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+typename LRUCache<KeyType, ValueType, HasherType>::Index
+LRUCache<KeyType, ValueType, HasherType>::allocateNode(KeyType key, ValueType value,
+                                                       size_t hash)
+{
+    if (!_freeNodes.empty()) {
+        const Index node = _freeNodes.back();
+        _freeNodes.pop_back();
+        Node& n = _nodes[node];
+        n.key = std::move(key);
+        n.value = std::move(value);
+        n.hash = hash;
+        return node;
+    }
+    else {
+        ghoul_assert(_nodes.size() < InvalidIndex, "Too many items in the cache");
+        _nodes.push_back({ std::move(key), std::move(value), hash });
+        return static_cast<Index>(_nodes.size() - 1);
+    }
+}
+
+template<typename KeyType, typename ValueType, typename HasherType>
+std::pair<KeyType, ValueType>
+LRUCache<KeyType, ValueType, HasherType>::releaseNode(Index node)
+{
+    eraseFromTable(node);
+    unlink(node);
+    --_size;
+
+    Node& n = _nodes[node];
+    std::pair<KeyType, ValueType> item = { std::move(n.key), std::move(n.value) };
+    // Reset the node so that resources held by the value are released immediately
+    n.key = KeyType();
+    n.value = ValueType();
+    _freeNodes.push_back(node);
+    return item;
+}
+
 } // namespace openspace::globebrowsing::cache
@@ -25,11 +25,17 @@
 #include <modules/globebrowsing/src/memoryawaretilecache.h>
 
 #include <modules/globebrowsing/src/basictypes.h>
+#include <modules/globebrowsing/src/disktilestore.h>
 #include <modules/globebrowsing/src/layermanager.h>
 #include <modules/globebrowsing/src/rawtile.h>
+#include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/systemcapabilities/generalcapabilitiescomponent.h>
+#include <ghoul/fmt.h>
+#include <lz4.h>
+#include <limits>
 #include <numeric>
+#include <random>
 
 namespace {
     constexpr const char* _loggerCat = "MemoryAwareTileCache";
@@ -66,6 +72,74 @@ namespace {
         "" // @TODO Missing documentation
     };
 
+    constexpr openspace::properties::Property::PropertyInfo HitsInfo = {
+        "Hits",
+        "Cache hits",
+        "The number of tile requests that were served from the textures of the cache "
+        "since the cache was last cleared."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo MissesInfo = {
+        "Misses",
+        "Cache misses",
+        "The number of tile requests that could not be served from any tier of the "
+        "cache since the cache was last cleared."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo EvictionsInfo = {
+        "Evictions",
+        "Cache evictions",
+        "The number of tiles that lost their texture to make room for new tiles since "
+        "the cache was last cleared."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo PromotionsInfo = {
+        "Promotions",
+        "Cache promotions",
+        "The number of tile requests that were served by uploading a tile from the "
+        "compressed tier or the disk tier since the cache was last cleared."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo CompressedTierSizeInfo = {
+        "CompressedTierSize",
+        "Compressed tier size (MB)",
+        "The maximum amount of RAM (in MB) that is used to keep compressed copies of "
+        "tiles that were evicted from the textures. If this value is 0, evicted tiles "
+        "are moved to the disk tier directly."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo CompressedTierDataInfo = {
+        "CompressedTierData",
+        "Compressed tier data (MB)",
+        "This value denotes the amount of RAM (in MB) that is used by compressed tiles."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo DiskTierSizeInfo = {
+        "DiskTierSize",
+        "Disk tier size (MB)",
+        "The maximum size (in MB) of the file in the cache folder that tiles are "
+        "spilled to when they are evicted from the compressed tier. If this value is 0, "
+        "which is the default, the disk tier is disabled."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo PromotionsPerFrameInfo = {
+        "PromotionsPerFrame",
+        "Promotions per frame",
+        "The maximum number of tiles that are decompressed and uploaded from the "
+        "compressed tier or the disk tier each frame. Requested tiles beyond this "
+        "number are uploaded in the following frames."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo DiskTierDataInfo = {
+        "DiskTierData",
+        "Disk tier data (MB)",
+        "This value denotes the amount of disk space (in MB) that is used by tiles "
+        "stored in the disk tier."
+    };
+
+    constexpr const char* DiskTierFile = "${CACHE}/globebrowsing_tilestore_{:016x}.bin";
+    constexpr const size_t ByteToMegaByte = 1024 * 1024;
+
     GLenum toGlTextureFormat(GLenum glType, ghoul::opengl::Texture::Format format) {
         switch (format) {
             case ghoul::opengl::Texture::Format::Red:
@@ -254,11 +328,21 @@ size_t MemoryAwareTileCache::TextureContainer::size() const {
 MemoryAwareTileCache::MemoryAwareTileCache()
     : PropertyOwner({ "TileCache" })
     , _numTextureBytesAllocatedOnCPU(0)
+    , _compressedTiles(std::numeric_limits<size_t>::max())
     , _cpuAllocatedTileData(CpuAllocatedDataInfo, 1024, 128, 16384, 1)
     , _gpuAllocatedTileData(GpuAllocatedDataInfo, 1024, 128, 16384, 1)
     , _tileCacheSize(TileCacheSizeInfo, 1024, 128, 16384, 1)
     , _applyTileCacheSize(ApplyTileCacheInfo)
     , _clearTileCache(ClearTileCacheInfo)
+    , _hits(HitsInfo, 0, 0, std::numeric_limits<unsigned long long>::max())
+    , _misses(MissesInfo, 0, 0, std::numeric_limits<unsigned long long>::max())
+    , _evictions(EvictionsInfo, 0, 0, std::numeric_limits<unsigned long long>::max())
+    , _promotions(PromotionsInfo, 0, 0, std::numeric_limits<unsigned long long>::max())
+    , _compressedTierSize(CompressedTierSizeInfo, 512, 0, 16384, 1)
+    , _compressedTierData(CompressedTierDataInfo, 0, 0, 16384, 1)
+    , _diskTierSize(DiskTierSizeInfo, 0, 0, 65536, 1)
+    , _diskTierData(DiskTierDataInfo, 0, 0, 65536, 1)
+    , _promotionsPerFrame(PromotionsPerFrameInfo, 8, 1, 256)
 {
     createDefaultTextureContainers();
 
@@ -287,18 +371,53 @@ MemoryAwareTileCache::MemoryAwareTileCache()
     );
     addProperty(_tileCacheSize);
 
+    _hits.setReadOnly(true);
+    addProperty(_hits);
+    _misses.setReadOnly(true);
+    addProperty(_misses);
+    _evictions.setReadOnly(true);
+    addProperty(_evictions);
+    _promotions.setReadOnly(true);
+    addProperty(_promotions);
+
+    _compressedTierSize.onChange([&]() { trimCompressedTier(); });
+    addProperty(_compressedTierSize);
+    _compressedTierData.setReadOnly(true);
+    addProperty(_compressedTierData);
+
+    _diskTierSize.onChange([&]() { resetDiskStore(); });
+    addProperty(_diskTierSize);
+    _diskTierData.setReadOnly(true);
+    addProperty(_diskTierData);
+
+    addProperty(_promotionsPerFrame);
+
     setSizeEstimated(_tileCacheSize * 1024 * 1024);
+    resetDiskStore();
 }
 
+MemoryAwareTileCache::~MemoryAwareTileCache() {} // NOLINT
+
 void MemoryAwareTileCache::clear() {
     LINFO("Clearing tile cache");
     _numTextureBytesAllocatedOnCPU = 0;
+    _nHits = 0;
+    _nMisses = 0;
+    _nEvictions = 0;
+    _nPromotions = 0;
     using K = TileTextureInitData::HashKey;
     using V = TextureContainerTileCache;
     for (std::pair<const K, V>& p : _textureContainerMap) {
         p.second.first->reset();
         p.second.second->clear();
     }
+    _compressedTiles.clear();
+    _numCompressedBytes = 0;
+    _queuedPromotions.clear();
+    _queuedPromotionKeys.clear();
+    if (_diskStore) {
+        _diskStore->clear();
+    }
     LINFO("Tile cache cleared");
 }
 
@@ -376,21 +495,35 @@ bool MemoryAwareTileCache::exist(const ProviderTileKey& key) const {
 }
 
 Tile MemoryAwareTileCache::get(const ProviderTileKey& key) {
-    const TextureContainerMap::const_iterator it = std::find_if(
-        _textureContainerMap.cbegin(),
-        _textureContainerMap.cend(),
-        [&](const std::pair<const TileTextureInitData::HashKey,
-                            TextureContainerTileCache>& p)
-        {
-            return p.second.second->exist(key);
+    for (std::pair<const TileTextureInitData::HashKey, TextureContainerTileCache>& p :
+         _textureContainerMap)
+    {
+        const Tile* tile = p.second.second->find(key);
+        if (tile) {
+            ++_nHits;
+            return *tile;
         }
-    );
-    if (it != _textureContainerMap.cend()) {
-        return it->second.second->get(key);
     }
-    else {
+
+    // Tiles in the lower tiers are uploaded in the next calls to update so that the
+    // decompression and upload of many tiles is spread over several frames
+    if (isPromotionQueued(key)) {
+        return Tile();
+    }
+    const bool isInLowerTier = _compressedTiles.exist(key) ||
+                               (_diskStore && _diskStore->exist(key));
+    if (isInLowerTier) {
+        _queuedPromotions.push_back(key);
+        _queuedPromotionKeys.insert(key);
         return Tile();
     }
+
+    ++_nMisses;
+    return Tile();
+}
+
+bool MemoryAwareTileCache::isPromotionQueued(const ProviderTileKey& key) const {
+    return _queuedPromotionKeys.find(key) != _queuedPromotionKeys.end();
 }
 
 ghoul::opengl::Texture* MemoryAwareTileCache::texture(
@@ -406,9 +539,12 @@ ghoul::opengl::Texture* MemoryAwareTileCache::texture(
         _textureContainerMap[initDataKey].first->getTextureIfFree();
     // Second option. No more textures available. Pop from the LRU cache
     if (!texture) {
-        Tile oldTile = _textureContainerMap[initDataKey].second->popLRU().second;
+        std::pair<ProviderTileKey, Tile> oldTile =
+            _textureContainerMap[initDataKey].second->popLRU();
+        ++_nEvictions;
+        demote(oldTile.first, oldTile.second, initData);
         // Use the old tile's texture
-        texture = oldTile.texture;
+        texture = oldTile.second.texture;
     }
     return texture;
 }
@@ -466,13 +602,32 @@ void MemoryAwareTileCache::put(const ProviderTileKey& key,
 }
 
 void MemoryAwareTileCache::update() {
+    int nPromotions = 0;
+    while (!_queuedPromotions.empty() && nPromotions < _promotionsPerFrame) {
+        const ProviderTileKey key = _queuedPromotions.front();
+        _queuedPromotions.pop_front();
+        _queuedPromotionKeys.erase(key);
+        // The tile might have been loaded from its dataset in the meantime
+        if (!exist(key) && promote(key)) {
+            ++_nPromotions;
+            ++nPromotions;
+        }
+    }
+
     const size_t dataSizeCPU = cpuAllocatedDataSize();
     const size_t dataSizeGPU = gpuAllocatedDataSize();
 
-    const size_t ByteToMegaByte = 1024 * 1024;
-
     _cpuAllocatedTileData = static_cast<int>(dataSizeCPU / ByteToMegaByte);
     _gpuAllocatedTileData = static_cast<int>(dataSizeGPU / ByteToMegaByte);
+    _compressedTierData = static_cast<int>(_numCompressedBytes / ByteToMegaByte);
+    _diskTierData = _diskStore ?
+        static_cast<int>(_diskStore->size() / ByteToMegaByte) :
+        0;
+
+    _hits = _nHits;
+    _misses = _nMisses;
+    _evictions = _nEvictions;
+    _promotions = _nPromotions;
 }
 
 size_t MemoryAwareTileCache::gpuAllocatedDataSize() const {
@@ -507,7 +662,122 @@ size_t MemoryAwareTileCache::cpuAllocatedDataSize() const {
             return s;
         }
     );
-    return dataSize + _numTextureBytesAllocatedOnCPU;
+    return dataSize + _numTextureBytesAllocatedOnCPU + _numCompressedBytes;
+}
+
+void MemoryAwareTileCache::demote(const ProviderTileKey& key, const Tile& tile,
+                                  const TileTextureInitData& initData)
+{
+    // Only tiles that were created from raw tile data carry metadata and keep a copy of
+    // their pixels on the CPU. Tiles that are rendered directly into their texture
+    // cannot be restored and are dropped
+    if (!tile.metaData.has_value() || !tile.texture || !tile.texture->pixelData()) {
+        return;
+    }
+    if (_compressedTierSize == 0 && !_diskStore) {
+        return;
+    }
+
+    const int nBytes = static_cast<int>(initData.totalNumBytes);
+    CompressedTile compressed;
+    compressed.initDataKey = initData.hashKey;
+    compressed.uncompressedSize = initData.totalNumBytes;
+    compressed.metaData = tile.metaData;
+    compressed.data.resize(LZ4_compressBound(nBytes));
+    const int nCompressed = LZ4_compress_default(
+        reinterpret_cast<const char*>(tile.texture->pixelData()),
+        reinterpret_cast<char*>(compressed.data.data()),
+        nBytes,
+        static_cast<int>(compressed.data.size())
+    );
+    if (nCompressed <= 0) {
+        return;
+    }
+    compressed.data.resize(nCompressed);
+    compressed.data.shrink_to_fit();
+
+    const CompressedTile* previous = _compressedTiles.find(key);
+    if (previous) {
+        _numCompressedBytes -= previous->data.size();
+    }
+    _numCompressedBytes += compressed.data.size();
+    _compressedTiles.put(key, std::move(compressed));
+    trimCompressedTier();
+}
+
+bool MemoryAwareTileCache::promote(const ProviderTileKey& key) {
+    std::optional<CompressedTile> compressed;
+    if (_compressedTiles.find(key)) {
+        // find moved the tile to the front, so we can remove it from there
+        compressed = _compressedTiles.popMRU().second;
+        _numCompressedBytes -= compressed->data.size();
+    }
+    else if (_diskStore) {
+        compressed = _diskStore->take(key);
+    }
+    if (!compressed) {
+        return false;
+    }
+
+    const TextureContainerMap::const_iterator it = _textureContainerMap.find(
+        compressed->initDataKey
+    );
+    if (it == _textureContainerMap.cend()) {
+        // The texture type was removed since the tile was demoted
+        return false;
+    }
+
+    RawTile rawTile;
+    rawTile.imageData = std::unique_ptr<std::byte[]>(
+        new std::byte[compressed->uncompressedSize]
+    );
+    const int nDecompressed = LZ4_decompress_safe(
+        reinterpret_cast<const char*>(compressed->data.data()),
+        reinterpret_cast<char*>(rawTile.imageData.get()),
+        static_cast<int>(compressed->data.size()),
+        static_cast<int>(compressed->uncompressedSize)
+    );
+    if (nDecompressed != static_cast<int>(compressed->uncompressedSize)) {
+        LERROR("Error decompressing tile from the tile cache");
+        return false;
+    }
+    rawTile.tileMetaData = std::move(*compressed->metaData);
+    rawTile.textureInitData.emplace(it->second.first->tileTextureInitData());
+    rawTile.tileIndex = key.tileIndex;
+
+    createTileAndPut(key, std::move(rawTile));
+    return true;
+}
+
+void MemoryAwareTileCache::trimCompressedTier() {
+    const size_t budget = static_cast<size_t>(_compressedTierSize) * ByteToMegaByte;
+    while (_numCompressedBytes > budget && !_compressedTiles.isEmpty()) {
+        std::pair<ProviderTileKey, CompressedTile> p = _compressedTiles.popLRU();
+        _numCompressedBytes -= p.second.data.size();
+        if (_diskStore) {
+            _diskStore->put(p.first, p.second);
+        }
+    }
+}
+
+void MemoryAwareTileCache::resetDiskStore() {
+    const size_t budget = static_cast<size_t>(_diskTierSize) * ByteToMegaByte;
+    if (budget == 0) {
+        _diskStore = nullptr;
+    }
+    else if (_diskStore) {
+        _diskStore->setBudget(budget);
+    }
+    else {
+        // Every cache uses its own file, so that several instances of OpenSpace can
+        // share the same cache folder
+        std::random_device rd;
+        const uint64_t id = (static_cast<uint64_t>(rd()) << 32) | rd();
+        _diskStore = std::make_unique<DiskTileStore>(
+            absPath(fmt::format(DiskTierFile, id)),
+            budget
+        );
+    }
 }
 
 } // namespace openspace::globebrowsing::cache
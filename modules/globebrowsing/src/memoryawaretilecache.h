@@ -25,15 +25,21 @@
 #ifndef __OPENSPACE_MODULE_GLOBEBROWSING___MEMORY_AWARE_TILE_CACHE___H__
 #define __OPENSPACE_MODULE_GLOBEBROWSING___MEMORY_AWARE_TILE_CACHE___H__
 
+#include <modules/globebrowsing/src/basictypes.h>
 #include <modules/globebrowsing/src/lrucache.h>
 #include <modules/globebrowsing/src/tileindex.h>
 #include <modules/globebrowsing/src/tiletextureinitdata.h>
 #include <openspace/properties/propertyowner.h>
 #include <openspace/properties/scalar/boolproperty.h>
 #include <openspace/properties/scalar/intproperty.h>
+#include <openspace/properties/scalar/ulonglongproperty.h>
 #include <openspace/properties/triggerproperty.h>
+#include <cstddef>
+#include <deque>
 #include <memory>
+#include <optional>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace openspace::globebrowsing {
@@ -43,6 +49,8 @@ namespace openspace::globebrowsing {
 
 namespace openspace::globebrowsing::cache {
 
+class DiskTileStore;
+
 struct ProviderTileKey {
     TileIndex tileIndex;
     unsigned int providerID;
@@ -83,14 +91,42 @@ struct ProviderTileHasher {
     }
 };
 
+/**
+ * The LZ4 compressed pixel data of a tile that was evicted from the texture tier of the
+ * MemoryAwareTileCache together with everything that is needed to recreate the tile.
+ */
+struct CompressedTile {
+    TileTextureInitData::HashKey initDataKey = 0;
+    size_t uncompressedSize = 0;
+    std::vector<std::byte> data;
+    std::optional<TileMetaData> metaData;
+};
+
+/**
+ * A tile cache with three tiers. The first tier is the pool of textures that are
+ * resident on the GPU. Tiles that are evicted from this tier are compressed and demoted
+ * into a byte-budgeted tier in RAM, and tiles that are evicted from there are spilled to
+ * a DiskTileStore, if the disk tier is enabled. A lookup that misses the texture tier
+ * but finds the tile in one of the lower tiers queues the tile to be promoted back into
+ * a texture in one of the next calls to #update, which is a lot cheaper than reading
+ * the tile from its dataset again.
+ */
 class MemoryAwareTileCache : public properties::PropertyOwner {
 public:
     MemoryAwareTileCache();
+    ~MemoryAwareTileCache();
 
     void clear();
     void setSizeEstimated(size_t estimatedSize);
     bool exist(const ProviderTileKey& key) const;
     Tile get(const ProviderTileKey& key);
+
+    /**
+     * Returns \c true if the tile for the \p key is in one of the lower tiers and will
+     * be uploaded into a texture in one of the next calls to #update. Such a tile does
+     * not have to be read from its dataset.
+     */
+    bool isPromotionQueued(const ProviderTileKey& key) const;
     ghoul::opengl::Texture* texture(const TileTextureInitData& initData);
     void createTileAndPut(ProviderTileKey key, RawTile rawTile);
     void put(const ProviderTileKey& key,
@@ -145,6 +181,23 @@ private:
     void assureTextureContainerExists(const TileTextureInitData& initData);
     void resetTextureContainerSize(size_t numTexturesPerTextureType);
 
+    /**
+     * Compresses the pixel data of the \p tile that is about to lose its texture and
+     * moves it into the compressed tier.
+     */
+    void demote(const ProviderTileKey& key, const Tile& tile,
+        const TileTextureInitData& initData);
+
+    /**
+     * Looks for the \p key in the compressed tier and the disk tier and, if it is
+     * found, uploads the tile into a texture again. Returns \c true on success.
+     */
+    bool promote(const ProviderTileKey& key);
+
+    /// Moves the least recently used compressed tiles to disk until the budget is met
+    void trimCompressedTier();
+    void resetDiskStore();
+
     using TileCache = LRUCache<ProviderTileKey, Tile, ProviderTileHasher>;
     using TextureContainerTileCache = std::pair<
         std::unique_ptr<TextureContainer>,
@@ -158,12 +211,40 @@ private:
     TextureContainerMap _textureContainerMap;
     size_t _numTextureBytesAllocatedOnCPU;
 
+    using CompressedTileCache = LRUCache<
+        ProviderTileKey,
+        CompressedTile,
+        ProviderTileHasher
+    >;
+    CompressedTileCache _compressedTiles;
+    size_t _numCompressedBytes = 0;
+    std::unique_ptr<DiskTileStore> _diskStore;
+
+    // Tiles that were requested from the lower tiers, in the order of the requests
+    std::deque<ProviderTileKey> _queuedPromotions;
+    std::unordered_set<ProviderTileKey, ProviderTileHasher> _queuedPromotionKeys;
+
+    // Statistics that are transferred into the properties once per frame
+    unsigned long long _nHits = 0;
+    unsigned long long _nMisses = 0;
+    unsigned long long _nEvictions = 0;
+    unsigned long long _nPromotions = 0;
+
     // Properties
     properties::IntProperty _cpuAllocatedTileData;
     properties::IntProperty _gpuAllocatedTileData;
     properties::IntProperty _tileCacheSize;
     properties::TriggerProperty _applyTileCacheSize;
     properties::TriggerProperty _clearTileCache;
+    properties::ULongLongProperty _hits;
+    properties::ULongLongProperty _misses;
+    properties::ULongLongProperty _evictions;
+    properties::ULongLongProperty _promotions;
+    properties::IntProperty _compressedTierSize;
+    properties::IntProperty _compressedTierData;
+    properties::IntProperty _diskTierSize;
+    properties::IntProperty _diskTierData;
+    properties::IntProperty _promotionsPerFrame;
 };
 
 } // namespace openspace::globebrowsing::cache
@@ -431,10 +431,7 @@ RawTileDataReader::RawTileDataReader(std::string filePath,
 
 RawTileDataReader::~RawTileDataReader() {
     std::lock_guard lockGuard(_datasetLock);
-    if (_dataset) {
-        GDALClose(_dataset);
-        _dataset = nullptr;
-    }
+    closeDatasets();
 }
 
 void RawTileDataReader::initialize() {
@@ -507,10 +504,15 @@ void RawTileDataReader::initialize() {
         }
     }
 
-    _dataset = static_cast<GDALDataset*>(GDALOpen(content.c_str(), GA_ReadOnly));
+    _datasetOpenString = std::move(content);
+    _dataset = static_cast<GDALDataset*>(
+        GDALOpen(_datasetOpenString.c_str(), GA_ReadOnly)
+    );
     if (!_dataset) {
         throw ghoul::RuntimeError("Failed to load dataset: " + _datasetFilePath);
     }
+    _allDatasets.push_back(_dataset);
+    _availableDatasets.push_back(_dataset);
 
     // Assume all raster bands have the same data type
     _rasterCount = _dataset->GetRasterCount();
@@ -564,14 +566,68 @@ void RawTileDataReader::initialize() {
 void RawTileDataReader::reset() {
     std::lock_guard lockGuard(_datasetLock);
     _maxChunkLevel = -1;
-    if (_dataset) {
-        GDALClose(_dataset);
-        _dataset = nullptr;
-    }
+    closeDatasets();
     initialize();
 }
 
-RawTile::ReadError RawTileDataReader::rasterRead(int rasterBand,
+void RawTileDataReader::closeDatasets() {
+    ghoul_assert(
+        _availableDatasets.size() == _allDatasets.size(),
+        "Datasets must not be in use while closing them"
+    );
+
+    for (GDALDataset* dataset : _allDatasets) {
+        GDALClose(dataset);
+    }
+    _allDatasets.clear();
+    _availableDatasets.clear();
+    _dataset = nullptr;
+}
+
+RawTileDataReader::PooledDataset::PooledDataset(const RawTileDataReader& reader,
+                                                GDALDataset* dataset)
+    : _reader(reader)
+    , _dataset(dataset)
+{}
+
+RawTileDataReader::PooledDataset::~PooledDataset() {
+    _reader.releaseDataset(_dataset);
+}
+
+GDALDataset* RawTileDataReader::PooledDataset::get() const {
+    return _dataset;
+}
+
+RawTileDataReader::PooledDataset RawTileDataReader::acquireDataset() const {
+    {
+        std::lock_guard lockGuard(_datasetLock);
+        if (!_availableDatasets.empty()) {
+            GDALDataset* dataset = _availableDatasets.back();
+            _availableDatasets.pop_back();
+            return PooledDataset(*this, dataset);
+        }
+    }
+
+    // All handles are in use by other threads, so we open a new one. This happens
+    // outside the lock as opening a dataset can be slow for remote datasets
+    GDALDataset* dataset = static_cast<GDALDataset*>(
+        GDALOpen(_datasetOpenString.c_str(), GA_ReadOnly)
+    );
+    if (!dataset) {
+        throw ghoul::RuntimeError("Failed to load dataset: " + _datasetFilePath);
+    }
+
+    std::lock_guard lockGuard(_datasetLock);
+    _allDatasets.push_back(dataset);
+    return PooledDataset(*this, dataset);
+}
+
+void RawTileDataReader::releaseDataset(GDALDataset* dataset) const {
+    std::lock_guard lockGuard(_datasetLock);
+    _availableDatasets.push_back(dataset);
+}
+
+RawTile::ReadError RawTileDataReader::rasterRead(GDALDataset* dataset, int rasterBand,
                                                  const IODescription& io,
                                                  char* dataDestination) const
 {
@@ -598,7 +654,7 @@ RawTile::ReadError RawTileDataReader::rasterRead(int rasterBand,
     dataDest -= io.write.region.start.y * io.write.bytesPerLine;
     dataDest += io.write.region.start.x * _initData.bytesPerPixel;
 
-    GDALRasterBand* gdalRasterBand = _dataset->GetRasterBand(rasterBand);
+    GDALRasterBand* gdalRasterBand = dataset->GetRasterBand(rasterBand);
     CPLErr readError = CE_Failure;
     readError = gdalRasterBand->RasterIO(
         GF_Read,
@@ -634,7 +690,15 @@ RawTile RawTileDataReader::readTileData(TileIndex tileIndex) const {
 
     IODescription io = ioDescription(tileIndex);
     RawTile::ReadError worstError = RawTile::ReadError::None;
-    readImageData(io, worstError, reinterpret_cast<char*>(rawTile.imageData.get()));
+    {
+        const PooledDataset dataset = acquireDataset();
+        readImageData(
+            dataset.get(),
+            io,
+            worstError,
+            reinterpret_cast<char*>(rawTile.imageData.get())
+        );
+    }
 
     for (const MemoryLocation& ml : NoDataAvailableData) {
         std::byte* ptr = rawTile.imageData.get();
@@ -662,7 +726,8 @@ RawTile RawTileDataReader::readTileData(TileIndex tileIndex) const {
     return rawTile;
 }
 
-void RawTileDataReader::readImageData(IODescription& io, RawTile::ReadError& worstError,
+void RawTileDataReader::readImageData(GDALDataset* dataset, IODescription& io,
+                                      RawTile::ReadError& worstError,
                                       char* imageDataDest) const
 {
     // Only read the minimum number of rasters
@@ -671,7 +736,7 @@ void RawTileDataReader::readImageData(IODescription& io, RawTile::ReadError& wor
     switch (_initData.ghoulTextureFormat) {
         case ghoul::opengl::Texture::Format::Red: {
             char* dest = imageDataDest;
-            const RawTile::ReadError err = repeatedRasterRead(1, io, dest);
+            const RawTile::ReadError err = repeatedRasterRead(dataset, 1, io, dest);
             worstError = std::max(worstError, err);
             break;
         }
@@ -683,7 +748,12 @@ void RawTileDataReader::readImageData(IODescription& io, RawTile::ReadError& wor
                     // The final destination pointer is offsetted by one datum byte size
                     // for every raster (or data channel, i.e. R in RGB)
                     char* dest = imageDataDest + (i * _initData.bytesPerDatum);
-                    const RawTile::ReadError err = repeatedRasterRead(1, io, dest);
+                    const RawTile::ReadError err = repeatedRasterRead(
+                        dataset,
+                        1,
+                        io,
+                        dest
+                    );
                     worstError = std::max(worstError, err);
                 }
             }
@@ -692,12 +762,17 @@ void RawTileDataReader::readImageData(IODescription& io, RawTile::ReadError& wor
                     // The final destination pointer is offsetted by one datum byte size
                     // for every raster (or data channel, i.e. R in RGB)
                     char* dest = imageDataDest + (i * _initData.bytesPerDatum);
-                    const RawTile::ReadError err = repeatedRasterRead(1, io, dest);
+                    const RawTile::ReadError err = repeatedRasterRead(
+                        dataset,
+                        1,
+                        io,
+                        dest
+                    );
                     worstError = std::max(worstError, err);
                 }
                 // Last read is the alpha channel
                 char* dest = imageDataDest + (3 * _initData.bytesPerDatum);
-                const RawTile::ReadError err = repeatedRasterRead(2, io, dest);
+                const RawTile::ReadError err = repeatedRasterRead(dataset, 2, io, dest);
                 worstError = std::max(worstError, err);
             }
             else { // Three or more rasters
@@ -705,7 +780,12 @@ void RawTileDataReader::readImageData(IODescription& io, RawTile::ReadError& wor
                     // The final destination pointer is offsetted by one datum byte size
                     // for every raster (or data channel, i.e. R in RGB)
                     char* dest = imageDataDest + (i * _initData.bytesPerDatum);
-                    const RawTile::ReadError err = repeatedRasterRead(i + 1, io, dest);
+                    const RawTile::ReadError err = repeatedRasterRead(
+                        dataset,
+                        i + 1,
+                        io,
+                        dest
+                    );
                     worstError = std::max(worstError, err);
                 }
             }
@@ -718,7 +798,12 @@ void RawTileDataReader::readImageData(IODescription& io, RawTile::ReadError& wor
                     // The final destination pointer is offsetted by one datum byte size
                     // for every raster (or data channel, i.e. R in RGB)
                     char* dest = imageDataDest + (i * _initData.bytesPerDatum);
-                    const RawTile::ReadError err = repeatedRasterRead(1, io, dest);
+                    const RawTile::ReadError err = repeatedRasterRead(
+                        dataset,
+                        1,
+                        io,
+                        dest
+                    );
                     worstError = std::max(worstError, err);
                 }
             }
@@ -727,12 +812,17 @@ void RawTileDataReader::readImageData(IODescription& io, RawTile::ReadError& wor
                     // The final destination pointer is offsetted by one datum byte size
                     // for every raster (or data channel, i.e. R in RGB)
                     char* dest = imageDataDest + (i * _initData.bytesPerDatum);
-                    const RawTile::ReadError err = repeatedRasterRead(1, io, dest);
+                    const RawTile::ReadError err = repeatedRasterRead(
+                        dataset,
+                        1,
+                        io,
+                        dest
+                    );
                     worstError = std::max(worstError, err);
                 }
                 // Last read is the alpha channel
                 char* dest = imageDataDest + (3 * _initData.bytesPerDatum);
-                const RawTile::ReadError err = repeatedRasterRead(2, io, dest);
+                const RawTile::ReadError err = repeatedRasterRead(dataset, 2, io, dest);
                 worstError = std::max(worstError, err);
             }
             else { // Three or more rasters
@@ -740,14 +830,19 @@ void RawTileDataReader::readImageData(IODescription& io, RawTile::ReadError& wor
                     // The final destination pointer is offsetted by one datum byte size
                     // for every raster (or data channel, i.e. R in RGB)
                     char* dest = imageDataDest + (i * _initData.bytesPerDatum);
-                    const RawTile::ReadError err = repeatedRasterRead(3 - i, io, dest);
+                    const RawTile::ReadError err = repeatedRasterRead(
+                        dataset,
+                        3 - i,
+                        io,
+                        dest
+                    );
                     worstError = std::max(worstError, err);
                 }
             }
             if (nRastersToRead > 3) { // Alpha channel exists
                 // Last read is the alpha channel
                 char* dest = imageDataDest + (3 * _initData.bytesPerDatum);
-                const RawTile::ReadError err = repeatedRasterRead(4, io, dest);
+                const RawTile::ReadError err = repeatedRasterRead(dataset, 4, io, dest);
                 worstError = std::max(worstError, err);
             }
             break;
@@ -807,7 +902,8 @@ glm::ivec2 RawTileDataReader::fullPixelSize() const {
     return geodeticToPixel(Geodetic2{ 90.0, 180.0 }, _padfTransform);
 }
 
-RawTile::ReadError RawTileDataReader::repeatedRasterRead(int rasterBand,
+RawTile::ReadError RawTileDataReader::repeatedRasterRead(GDALDataset* dataset,
+                                                         int rasterBand,
                                                          const IODescription& fullIO,
                                                          char* dataDestination,
                                                          int depth) const
@@ -904,6 +1000,7 @@ RawTile::ReadError RawTileDataReader::repeatedRasterRead(int rasterBand,
                 // as we can see in this example, it still has a top part outside the
                 // defined gdal region. This is handled through recursion.
                 const RawTile::ReadError err = repeatedRasterRead(
+                    dataset,
                     rasterBand,
                     cutoff,
                     dataDestination,
@@ -915,7 +1012,12 @@ RawTile::ReadError RawTileDataReader::repeatedRasterRead(int rasterBand,
         }
     }
 
-    const RawTile::ReadError err = rasterRead(rasterBand, io, dataDestination);
+    const RawTile::ReadError err = rasterRead(
+        dataset,
+        rasterBand,
+        io,
+        dataDestination
+    );
 
     // The return error from a repeated rasterRead is ONLY based on the main region,
     // which in the usual case will cover the main area of the patch anyway
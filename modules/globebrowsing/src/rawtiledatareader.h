@@ -31,6 +31,7 @@
 #include <ghoul/misc/boolean.h>
 #include <string>
 #include <mutex>
+#include <vector>
 #include <gdal.h>
 
 class GDALDataset;
@@ -60,6 +61,11 @@ public:
     int maxChunkLevel() const;
     float noDataValueAsFloat() const;
 
+    /**
+     * Reads the tile with the provided \p tileIndex. This function can be called
+     * concurrently from multiple threads as every concurrent read uses its own GDAL
+     * dataset handle.
+     */
     RawTile readTileData(TileIndex tileIndex) const;
     const TileDepthTransform& depthTransform() const;
     glm::ivec2 fullPixelSize() const;
@@ -67,11 +73,36 @@ public:
 private:
     void initialize();
 
-    RawTile::ReadError rasterRead(int rasterBand, const IODescription& io,
-        char* dataDestination) const;
+    /// A dataset handle that is returned to the pool when it goes out of scope
+    class PooledDataset {
+    public:
+        PooledDataset(const RawTileDataReader& reader, GDALDataset* dataset);
+        ~PooledDataset();
+
+        PooledDataset(const PooledDataset&) = delete;
+        PooledDataset& operator=(const PooledDataset&) = delete;
+
+        GDALDataset* get() const;
+
+    private:
+        const RawTileDataReader& _reader;
+        GDALDataset* _dataset;
+    };
 
-    void readImageData(IODescription& io, RawTile::ReadError& worstError,
-        char* imageDataDest) const;
+    /**
+     * Returns a dataset handle that is not used by any other thread, opening a new one if
+     * all existing handles are in use. The handle is returned to the pool when the
+     * returned object is destroyed, also if the read throws an exception.
+     */
+    PooledDataset acquireDataset() const;
+    void releaseDataset(GDALDataset* dataset) const;
+    void closeDatasets();
+
+    RawTile::ReadError rasterRead(GDALDataset* dataset, int rasterBand,
+        const IODescription& io, char* dataDestination) const;
+
+    void readImageData(GDALDataset* dataset, IODescription& io,
+        RawTile::ReadError& worstError, char* imageDataDest) const;
 
     IODescription ioDescription(const TileIndex& tileIndex) const;
 
@@ -79,13 +110,22 @@ private:
      * A recursive function that is able to perform wrapping in case the read region of
      * the given IODescription is outside of the given write region.
      */
-    RawTile::ReadError repeatedRasterRead(int rasterBand, const IODescription& fullIO,
-        char* dataDestination, int depth = 0) const;
+    RawTile::ReadError repeatedRasterRead(GDALDataset* dataset, int rasterBand,
+        const IODescription& fullIO, char* dataDestination, int depth = 0) const;
 
     TileMetaData tileMetaData(RawTile& rawTile, const PixelRegion& region) const;
 
     const std::string _datasetFilePath;
+    /// The string that is passed to GDALOpen, which might be a modified version of the
+    /// file's contents, for example with injected caching information
+    std::string _datasetOpenString;
+
+    /// The dataset that was used to read the metadata. It is also part of the pool
     GDALDataset* _dataset = nullptr;
+    /// All dataset handles that have been opened for this file
+    mutable std::vector<GDALDataset*> _allDatasets;
+    /// The dataset handles that are currently not used by any thread
+    mutable std::vector<GDALDataset*> _availableDatasets;
 
     // Dataset parameters
     int _rasterCount;
@@ -868,7 +868,7 @@ Tile tile(TileProvider& tp, const TileIndex& tileIndex) {
                 const cache::ProviderTileKey key = { tileIndex, t.uniqueIdentifier };
                 const Tile tile = t.tileCache->get(key);
 
-                if (!tile.texture) {
+                if (!tile.texture && !t.tileCache->isPromotionQueued(key)) {
                     t.asyncTextureDataProvider->enqueueTileIO(tileIndex);
                 }
 
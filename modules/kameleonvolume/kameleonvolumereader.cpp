@@ -26,11 +26,17 @@
 
 #include <modules/kameleon/include/kameleonwrapper.h>
 #include <modules/volume/rawvolume.h>
+#include <openspace/engine/globals.h>
+#include <openspace/util/workstealingthreadpool.h>
 #include <ghoul/fmt.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/dictionary.h>
+#include <algorithm>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
 
 #ifdef WIN32
 #pragma warning (push)
@@ -53,6 +59,11 @@
 namespace {
     constexpr const char* _loggerCat = "KameleonVolumeReader";
 
+    // The grid is split into this many slabs per thread, so that threads that finish
+    // early can take over slabs from threads in regions where the interpolation is more
+    // expensive
+    constexpr const size_t SlabsPerThread = 4;
+
     template <typename T>
     T globalAttribute(ccmc::Model&, const std::string&) {
         static_assert(sizeof(T) == 0);
@@ -83,11 +94,6 @@ KameleonVolumeReader::KameleonVolumeReader(std::string path) : _path(std::move(p
         LERROR(fmt::format("Failed to open file '{}' with Kameleon", _path));
         throw ghoul::RuntimeError("Failed to open file: " + _path + " with Kameleon");
     }
-
-    // Possibly use a kameleon interpolator instead of a model interpolator?
-    _interpolator = std::unique_ptr<ccmc::Interpolator>(
-        _kameleon.model->createNewInterpolator()
-    );
 }
 
 std::unique_ptr<volume::RawVolume<float>> KameleonVolumeReader::readFloatVolume(
@@ -115,32 +121,121 @@ std::unique_ptr<volume::RawVolume<float>> KameleonVolumeReader::readFloatVolume(
                                                                           float& minValue,
                                                                     float& maxValue) const
 {
-    minValue = std::numeric_limits<float>::max();
-    maxValue = -std::numeric_limits<float>::max();
+    std::vector<float> minValues;
+    std::vector<float> maxValues;
+    std::vector<std::unique_ptr<volume::RawVolume<float>>> volumes = readFloatVolumes(
+        dimensions,
+        { variable },
+        lowerBound,
+        upperBound,
+        minValues,
+        maxValues
+    );
+    minValue = minValues[0];
+    maxValue = maxValues[0];
+    return std::move(volumes[0]);
+}
 
-    std::unique_ptr<volume::RawVolume<float>> volume =
-        std::make_unique<volume::RawVolume<float>>(dimensions);
+std::vector<std::unique_ptr<volume::RawVolume<float>>>
+KameleonVolumeReader::readFloatVolumes(const glm::uvec3& dimensions,
+                                       const std::vector<std::string>& variables,
+                                       const glm::vec3& lowerBound,
+                                       const glm::vec3& upperBound,
+                                       std::vector<float>& minValues,
+                                       std::vector<float>& maxValues) const
+{
+    const size_t nVariables = variables.size();
+
+    // The Kameleon library is not thread safe, so the variables are loaded and their IDs
+    // are looked up before the resampling starts
+    std::vector<long> variableIds(nVariables);
+    std::vector<std::unique_ptr<volume::RawVolume<float>>> volumes(nVariables);
+    for (size_t i = 0; i < nVariables; ++i) {
+        if (!_kameleon.model->loadVariable(variables[i])) {
+            throw ghoul::RuntimeError(fmt::format(
+                "Failed to load variable '{}' from '{}'", variables[i], _path
+            ));
+        }
+        variableIds[i] = _kameleon.model->getVariableID(variables[i]);
+        volumes[i] = std::make_unique<volume::RawVolume<float>>(dimensions);
+    }
 
-    const glm::vec3 dims = volume->dimensions();
-    const glm::vec3 diff = upperBound - lowerBound;
+    minValues.assign(nVariables, std::numeric_limits<float>::max());
+    maxValues.assign(nVariables, -std::numeric_limits<float>::max());
 
-    auto interpolate = [this](const std::string& var, const glm::vec3& coords) {
-        return _interpolator->interpolate(var, coords[0], coords[1], coords[2]);
-    };
+    WorkStealingThreadPool& pool = global::threadPool;
+    const size_t nSlabs = std::min<size_t>(
+        dimensions.z,
+        pool.numThreads() * SlabsPerThread
+    );
 
-    float* data = volume->data();
-    for (size_t index = 0; index < volume->nCells(); ++index) {
-        const glm::vec3 coords = volume->indexToCoords(index);
-        const glm::vec3 coordsZeroToOne = coords / dims;
-        const glm::vec3 volumeCoords = lowerBound + diff * coordsZeroToOne;
+    // Interpolators can't be shared between threads, so each slab takes one from this
+    // list while it is resampled. The workers and the calling thread can resample at
+    // most one slab each at a time. The interpolators are created up front for the same
+    // reason as above. Another thread that helps the shared pool while waiting for its
+    // own work might pick up a slab as well; it waits until an interpolator is returned
+    std::vector<std::unique_ptr<ccmc::Interpolator>> interpolators(
+        pool.numThreads() + 1
+    );
+    for (std::unique_ptr<ccmc::Interpolator>& interpolator : interpolators) {
+        interpolator = std::unique_ptr<ccmc::Interpolator>(
+            _kameleon.model->createNewInterpolator()
+        );
+    }
 
-        data[index] = interpolate(variable, volumeCoords);
+    const glm::vec3 dims = dimensions;
+    const glm::vec3 diff = upperBound - lowerBound;
+    const size_t sliceSize = static_cast<size_t>(dimensions.x) * dimensions.y;
+
+    std::mutex mutex;
+    std::condition_variable interpolatorReturned;
+    pool.parallelFor(dimensions.z, nSlabs, [&](size_t begin, size_t end) {
+        std::unique_ptr<ccmc::Interpolator> interpolator;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            interpolatorReturned.wait(lock, [&]() { return !interpolators.empty(); });
+            interpolator = std::move(interpolators.back());
+            interpolators.pop_back();
+        }
 
-        minValue = glm::min(minValue, data[index]);
-        maxValue = glm::max(maxValue, data[index]);
-    }
+        std::vector<float> slabMin(nVariables, std::numeric_limits<float>::max());
+        std::vector<float> slabMax(nVariables, -std::numeric_limits<float>::max());
+
+        for (size_t z = begin; z < end; ++z) {
+            for (unsigned int y = 0; y < dimensions.y; ++y) {
+                for (unsigned int x = 0; x < dimensions.x; ++x) {
+                    const glm::vec3 coords = glm::vec3(x, y, z);
+                    const glm::vec3 coordsZeroToOne = coords / dims;
+                    const glm::vec3 volumeCoords = lowerBound + diff * coordsZeroToOne;
+                    const size_t index = z * sliceSize + y * dimensions.x + x;
+
+                    for (size_t i = 0; i < nVariables; ++i) {
+                        const float value = interpolator->interpolate(
+                            variableIds[i],
+                            volumeCoords.x,
+                            volumeCoords.y,
+                            volumeCoords.z
+                        );
+                        volumes[i]->data()[index] = value;
+                        slabMin[i] = glm::min(slabMin[i], value);
+                        slabMax[i] = glm::max(slabMax[i], value);
+                    }
+                }
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            interpolators.push_back(std::move(interpolator));
+            for (size_t i = 0; i < nVariables; ++i) {
+                minValues[i] = glm::min(minValues[i], slabMin[i]);
+                maxValues[i] = glm::max(maxValues[i], slabMax[i]);
+            }
+        }
+        interpolatorReturned.notify_one();
+    });
 
-    return volume;
+    return volumes;
 }
 
 std::vector<std::string> KameleonVolumeReader::variableNames() const {
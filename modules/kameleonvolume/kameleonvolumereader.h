@@ -28,6 +28,7 @@
 #include <ghoul/glm.h>
 #include <memory>
 #include <string>
+#include <vector>
 
 #ifdef WIN32
 #pragma warning (push)
@@ -42,8 +43,6 @@
 #pragma warning (pop)
 #endif // WIN32
 
-namespace ccmc { class Interpolator; }
-
 namespace ghoul { class Dictionary; }
 namespace openspace::volume { template <typename T> class RawVolume; }
 
@@ -62,6 +61,20 @@ public:
         const glm::vec3& lowerBound, const glm::vec3& upperBound, float& minValue,
         float& maxValue) const;
 
+    /**
+     * Resamples all \p variables onto a regular grid with the given \p dimensions that
+     * spans the domain from \p lowerBound to \p upperBound in a single pass over the
+     * grid. The grid is split into slabs along the z axis that are resampled in parallel.
+     * The smallest and largest resampled value of each variable are returned in
+     * \p minValues and \p maxValues.
+     *
+     * \throw ghoul::RuntimeError If one of the \p variables could not be loaded
+     */
+    std::vector<std::unique_ptr<volume::RawVolume<float>>> readFloatVolumes(
+        const glm::uvec3& dimensions, const std::vector<std::string>& variables,
+        const glm::vec3& lowerBound, const glm::vec3& upperBound,
+        std::vector<float>& minValues, std::vector<float>& maxValues) const;
+
     ghoul::Dictionary readMetaData() const;
 
     std::string time() const;
@@ -84,7 +97,6 @@ private:
 
     std::string _path;
     ccmc::Kameleon _kameleon;
-    std::unique_ptr<ccmc::Interpolator> _interpolator;
 };
 
 } // namespace openspace::kameleonvolume
@@ -451,6 +451,11 @@ void RenderableKameleonVolume::update(const UpdateData&) {
     }
 }
 
+bool RenderableKameleonVolume::isUpdateGLBound() const {
+    // The update only passes the current parameters on to the raycaster
+    return false;
+}
+
 void RenderableKameleonVolume::render(const RenderData& data, RendererTasks& tasks) {
     tasks.raycasterTasks.push_back({ _raycaster.get(), data });
 }
@@ -58,6 +58,7 @@ public:
     bool isReady() const override;
     void render(const RenderData& data, RendererTasks& tasks) override;
     void update(const UpdateData& data) override;
+    bool isUpdateGLBound() const override;
     bool isCachingEnabled() const;
 
 private:
@@ -30,6 +30,7 @@
 #include <ghoul/fmt.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/misc/dictionaryluaformatter.h>
+#include <fstream>
 
 namespace {
     constexpr const char* KeyInput = "Input";
@@ -45,6 +46,17 @@ namespace {
     constexpr const char* KeyMaxValue = "MaxValue";
 
     constexpr const char* KeyVisUnit = "VisUnit";
+
+    // Inserts the name of the variable before the extension of the file in the path,
+    // for example 'data/output.rawvolume' => 'data/output_rho.rawvolume'
+    std::string pathForVariable(std::string path, const std::string& variable) {
+        const size_t separator = path.find_last_of("/\\");
+        const size_t dot = path.rfind('.');
+        const bool hasExtension = dot != std::string::npos &&
+            (separator == std::string::npos || dot > separator);
+        path.insert(hasExtension ? dot : path.size(), "_" + variable);
+        return path;
+    }
 } // namespace
 
 namespace openspace::kameleonvolume {
@@ -81,9 +93,16 @@ documentation::Documentation KameleonVolumeToRawTask::documentation() {
             },
             {
                 KeyVariable,
-                new StringAnnotationVerifier("A valid kameleon variable"),
+                new OrVerifier({
+                    new StringAnnotationVerifier("A valid kameleon variable"),
+                    new StringListVerifier("A valid kameleon variable")
+                }),
                 Optional::No,
-                "The variable name to read from the kameleon dataset",
+                "The variable name, or a list of variable names, to read from the "
+                "kameleon dataset. All variables are resampled in a single pass over the "
+                "grid. If there is more than one variable, the name of each variable is "
+                "appended to the file names of the outputs, for example "
+                "'output_rho.rawvolume'",
             },
             {
                 KeyDimensions,
@@ -126,7 +145,18 @@ KameleonVolumeToRawTask::KameleonVolumeToRawTask(const ghoul::Dictionary& dictio
     _inputPath = absPath(dictionary.value<std::string>(KeyInput));
     _rawVolumeOutputPath = absPath(dictionary.value<std::string>(KeyRawVolumeOutput));
     _dictionaryOutputPath = absPath(dictionary.value<std::string>(KeyDictionaryOutput));
-    _variable = dictionary.value<std::string>(KeyVariable);
+    // Due to the documentation check above it must either be one or the other
+    if (dictionary.hasKeyAndValue<std::string>(KeyVariable)) {
+        _variables.push_back(dictionary.value<std::string>(KeyVariable));
+    }
+    else {
+        const ghoul::Dictionary& variables = dictionary.value<ghoul::Dictionary>(
+            KeyVariable
+        );
+        for (size_t i = 1; i <= variables.size(); ++i) {
+            _variables.push_back(variables.value<std::string>(std::to_string(i)));
+        }
+    }
     _dimensions = glm::uvec3(dictionary.value<glm::vec3>(KeyDimensions));
 
     if (!dictionary.getValue<glm::vec3>(KeyLowerDomainBound, _lowerDomainBound)) {
@@ -164,22 +194,21 @@ void KameleonVolumeToRawTask::perform(const Task::ProgressCallback& progressCall
         );
     }
 
-    std::unique_ptr<volume::RawVolume<float>> rawVolume = reader.readFloatVolume(
-        _dimensions,
-        _variable,
-        _lowerDomainBound,
-        _upperDomainBound
-    );
+    std::vector<float> minValues;
+    std::vector<float> maxValues;
+    std::vector<std::unique_ptr<volume::RawVolume<float>>> rawVolumes =
+        reader.readFloatVolumes(
+            _dimensions,
+            _variables,
+            _lowerDomainBound,
+            _upperDomainBound,
+            minValues,
+            maxValues
+        );
 
     progressCallback(0.5f);
 
-    volume::RawVolumeWriter<float> writer(_rawVolumeOutputPath);
-    writer.write(*rawVolume);
-
-    progressCallback(0.9f);
-
     ghoul::Dictionary inputMetadata = reader.readMetaData();
-    ghoul::Dictionary outputMetadata;
 
     std::string time = reader.time();
 
@@ -188,23 +217,47 @@ void KameleonVolumeToRawTask::perform(const Task::ProgressCallback& progressCall
         time.pop_back();
     }
 
-    outputMetadata.setValue(KeyTime, time);
-    outputMetadata.setValue(KeyDimensions, glm::vec3(_dimensions));
-    outputMetadata.setValue(KeyLowerDomainBound, _lowerDomainBound);
-    outputMetadata.setValue(KeyUpperDomainBound, _upperDomainBound);
+    for (size_t i = 0; i < _variables.size(); ++i) {
+        const std::string& variable = _variables[i];
+        const bool hasSeveralVariables = _variables.size() > 1;
+
+        volume::RawVolumeWriter<float> writer(
+            hasSeveralVariables ?
+                pathForVariable(_rawVolumeOutputPath, variable) :
+                _rawVolumeOutputPath
+        );
+        writer.write(*rawVolumes[i]);
+
+        ghoul::Dictionary outputMetadata;
+        outputMetadata.setValue(KeyTime, time);
+        outputMetadata.setValue(KeyDimensions, glm::vec3(_dimensions));
+        outputMetadata.setValue(KeyLowerDomainBound, _lowerDomainBound);
+        outputMetadata.setValue(KeyUpperDomainBound, _upperDomainBound);
 
-    outputMetadata.setValue(KeyMinValue, static_cast<float>(reader.minValue(_variable)));
-    outputMetadata.setValue(KeyMaxValue, static_cast<float>(reader.maxValue(_variable)));
-    outputMetadata.setValue<std::string>(KeyVisUnit, reader.getVisUnit(_variable));
+        outputMetadata.setValue(
+            KeyMinValue,
+            static_cast<float>(reader.minValue(variable))
+        );
+        outputMetadata.setValue(
+            KeyMaxValue,
+            static_cast<float>(reader.maxValue(variable))
+        );
+        outputMetadata.setValue<std::string>(KeyVisUnit, reader.getVisUnit(variable));
 
-    ghoul::DictionaryLuaFormatter formatter;
-    std::string metadataString = formatter.format(outputMetadata);
+        ghoul::DictionaryLuaFormatter formatter;
+        std::string metadataString = formatter.format(outputMetadata);
 
-    std::fstream f(_dictionaryOutputPath, std::ios::out);
-    f << "return " << metadataString;
-    f.close();
+        std::fstream f(
+            hasSeveralVariables ?
+                pathForVariable(_dictionaryOutputPath, variable) :
+                _dictionaryOutputPath,
+            std::ios::out
+        );
+        f << "return " << metadataString;
+        f.close();
 
-    progressCallback(1.0f);
+        progressCallback(0.5f + 0.5f * (i + 1) / _variables.size());
+    }
 }
 
 } // namespace openspace::kameleonvolume
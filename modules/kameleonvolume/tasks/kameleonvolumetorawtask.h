@@ -29,6 +29,7 @@
 
 #include <ghoul/glm.h>
 #include <string>
+#include <vector>
 
 namespace openspace::kameleonvolume {
 
@@ -46,7 +47,7 @@ private:
     std::string _rawVolumeOutputPath;
     std::string _dictionaryOutputPath;
 
-    std::string _variable;
+    std::vector<std::string> _variables;
     std::string _units;
     glm::uvec3 _dimensions;
     bool _autoDomainBounds = false;
@@ -22,17 +22,30 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
+
 #include <modules/multiresvolume/rendering/atlasmanager.h>
 
+#include <modules/multiresvolume/rendering/brickstreamer.h>
 #include <modules/multiresvolume/rendering/tsp.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
 #include <ghoul/opengl/texture.h>
 #include <cstring>
 
+namespace {
+    constexpr const char* _loggerCat = "AtlasManager";
+
+    // The time in nanoseconds that a single wait for the GPU to finish reading a staging
+    // buffer takes at most before the wait is repeated
+    constexpr const GLuint64 FenceTimeout = 100000000;
+} // namespace
+
 namespace openspace {
 
 AtlasManager::AtlasManager(TSP* tsp) : _tsp(tsp) {}
 
+AtlasManager::~AtlasManager() {}
+
 bool AtlasManager::initialize() {
     TSP::Header header = _tsp->header();
 
@@ -63,7 +76,31 @@ bool AtlasManager::initialize() {
     );
     _textureAtlas->uploadTexture();
 
+    // Each staging buffer can hold as many bricks as the atlas, in the order in which
+    // they were requested. They stay mapped so that the streamer can write into them
+    // while the render thread continues
     glGenBuffers(2, _pboHandle);
+    for (int i = 0; i < 2; ++i) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pboHandle[i]);
+        glBufferStorage(
+            GL_PIXEL_UNPACK_BUFFER,
+            _volumeSize,
+            nullptr,
+            GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT
+        );
+        _stagingBuffers[i] = reinterpret_cast<float*>(glMapBufferRange(
+            GL_PIXEL_UNPACK_BUFFER,
+            0,
+            _volumeSize,
+            GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_FLUSH_EXPLICIT_BIT
+        ));
+        if (!_stagingBuffers[i]) {
+            LERROR("Failed to map PBO");
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+            return false;
+        }
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
 
     glGenBuffers(1, &_atlasMapBuffer);
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, _atlasMapBuffer);
@@ -75,9 +112,35 @@ bool AtlasManager::initialize() {
     );
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 
+    _streamer = std::make_unique<BrickStreamer>(*_tsp);
+
     return true;
 }
 
+void AtlasManager::deinitialize() {
+    // The streamer might still be writing into the staging buffers
+    _streamer = nullptr;
+    _hasBatchInFlight = false;
+
+    for (int i = 0; i < 2; ++i) {
+        if (_uploadFences[i]) {
+            glDeleteSync(_uploadFences[i]);
+            _uploadFences[i] = nullptr;
+        }
+        if (_stagingBuffers[i]) {
+            glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pboHandle[i]);
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+            _stagingBuffers[i] = nullptr;
+        }
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    glDeleteBuffers(2, _pboHandle);
+    glDeleteBuffers(1, &_atlasMapBuffer);
+
+    delete _textureAtlas;
+    _textureAtlas = nullptr;
+}
+
 const std::vector<unsigned int>& AtlasManager::atlasMap() const {
     return _atlasMap;
 }
@@ -86,7 +149,7 @@ unsigned int AtlasManager::atlasMapBuffer() const {
     return _atlasMapBuffer;
 }
 
-void AtlasManager::updateAtlas(BufferIndex bufferIndex, std::vector<int>& brickIndices) {
+void AtlasManager::updateAtlas(std::vector<int>& brickIndices) {
     size_t nBrickIndices = brickIndices.size();
 
     _requiredBricks.clear();
@@ -94,57 +157,48 @@ void AtlasManager::updateAtlas(BufferIndex bufferIndex, std::vector<int>& brickI
         _requiredBricks.insert(brickIndices[i]);
     }
 
-    for (unsigned int it : _prevRequiredBricks) {
-        if (!_requiredBricks.count(it)) {
-            removeFromAtlas(it);
+    // Bricks that are no longer required are kept in the atlas as long as possible, as
+    // the selection often returns to them when the time goes back and forth
+    for (unsigned int brick : _prevRequiredBricks) {
+        if (!_requiredBricks.count(brick) && _brickMap.count(brick)) {
+            addToLru(brick);
         }
     }
+    for (unsigned int brick : _requiredBricks) {
+        removeFromLru(brick);
+    }
 
     // Stats
     _nUsedBricks = static_cast<unsigned int>(_requiredBricks.size());
     _nStreamedBricks = 0;
     _nDiskReads = 0;
 
-    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pboHandle[bufferIndex]);
-    glBufferData(GL_PIXEL_UNPACK_BUFFER, _volumeSize, nullptr, GL_STREAM_DRAW);
-    float* mappedBuffer = reinterpret_cast<float*>(
-        glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY)
-    );
-
-    if (!mappedBuffer) {
-        LERRORC("AtlasManager", "Failed to map PBO");
-        return;
+    if (_hasBatchInFlight && !_streamer->isBusy()) {
+        uploadBatch();
     }
-
-    for (auto itStart = _requiredBricks.begin(); itStart != _requiredBricks.end();) {
-        int firstBrick = *itStart;
-        int lastBrick = firstBrick;
-
-        auto itEnd = itStart;
-        for (itEnd++;
-            itEnd != _requiredBricks.end() &&
-            *itEnd == static_cast<unsigned int>(lastBrick) + 1;
-            itEnd++)
-        {
-            lastBrick = *itEnd;
-        }
-
-        addToAtlas(firstBrick, lastBrick, mappedBuffer);
-
-        itStart = itEnd;
+    if (!_hasBatchInFlight) {
+        // Find out which bricks are used in place of missing bricks first, so that they
+        // are not evicted to make room for the requested bricks
+        buildAtlasMap(brickIndices);
+        requestMissingBricks(false);
     }
 
-    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
-    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
-
-    for (size_t i = 0; i < nBrickIndices; i++) {
-        _atlasMap[i] = _brickMap[brickIndices[i]];
+    // If a position can not be filled at all, we have to wait for the streamer. This
+    // only happens if neither the brick nor any of its ancestors have been loaded, for
+    // example in the first frame
+    while (!buildAtlasMap(brickIndices)) {
+        if (_hasBatchInFlight) {
+            _streamer->wait();
+            uploadBatch();
+        }
+        else if (!requestMissingBricks(true)) {
+            LERROR("Not all bricks fit into the atlas");
+            break;
+        }
     }
 
     std::swap(_prevRequiredBricks, _requiredBricks);
 
-    pboToAtlas(bufferIndex);
-
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, _atlasMapBuffer);
     GLint* to = reinterpret_cast<GLint*>(
         glMapBuffer(GL_SHADER_STORAGE_BUFFER, GL_WRITE_ONLY)
@@ -154,103 +208,216 @@ void AtlasManager::updateAtlas(BufferIndex bufferIndex, std::vector<int>& brickI
     glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 }
 
-void AtlasManager::addToAtlas(int firstBrickIndex, int lastBrickIndex,
-                              float* mappedBuffer)
-{
-    while (_brickMap.count(firstBrickIndex) && firstBrickIndex <= lastBrickIndex) {
-        firstBrickIndex++;
+bool AtlasManager::isStagingBufferAvailable(int stagingBuffer, bool wait) {
+    GLsync& fence = _uploadFences[stagingBuffer];
+    if (!fence) {
+        return true;
     }
-    while (_brickMap.count(lastBrickIndex) && lastBrickIndex >= firstBrickIndex) {
-        lastBrickIndex--;
+
+    GLenum status = GL_TIMEOUT_EXPIRED;
+    do {
+        status = glClientWaitSync(
+            fence,
+            GL_SYNC_FLUSH_COMMANDS_BIT,
+            wait ? FenceTimeout : 0
+        );
+    } while (wait && status == GL_TIMEOUT_EXPIRED);
+
+    if (status == GL_TIMEOUT_EXPIRED) {
+        return false;
     }
-    if (lastBrickIndex < firstBrickIndex) {
-        return;
+    if (status == GL_WAIT_FAILED) {
+        // Without the fence, the only way to be sure that the GPU is done with the
+        // buffer is to wait for all commands
+        LERROR("Waiting for the upload of the staging buffer failed");
+        glFinish();
     }
+    glDeleteSync(fence);
+    fence = nullptr;
+    return true;
+}
 
-    int sequenceLength = lastBrickIndex - firstBrickIndex + 1;
-    float* sequenceBuffer = new float[sequenceLength*_nBrickVals];
-    size_t bufferSize = sequenceLength * _brickSize;
+bool AtlasManager::requestMissingBricks(bool waitForStagingBuffer) {
+    // The GPU might still read from the staging buffer from the last time it was used. If
+    // we don't have to wait for it, the bricks are requested in a later frame instead
+    if (!isStagingBufferAvailable(_nextStagingBuffer, waitForStagingBuffer)) {
+        return false;
+    }
 
-    long long offset = TSP::dataPosition() + static_cast<long long>(firstBrickIndex) *
-                       static_cast<long long>(_brickSize);
-    _tsp->file().seekg(offset);
-    _tsp->file().read(reinterpret_cast<char*>(sequenceBuffer), bufferSize);
-    _nDiskReads++;
+    _batch.bricks.clear();
+    _batch.atlasCoords.clear();
 
-    for (int brickIndex = firstBrickIndex; brickIndex <= lastBrickIndex; brickIndex++) {
-        if (!_brickMap.count(brickIndex)) {
-            unsigned int atlasCoords = _freeAtlasCoords.back();
-            _freeAtlasCoords.pop_back();
-            int level = _nOtLevels - static_cast<int>(
-                floor(log((7.0 * (float(brickIndex % _nOtNodes)) + 1.0))/log(8)) - 1
-            );
-            ghoul_assert(atlasCoords <= 0x0FFFFFFF, "@MISSING");
-            unsigned int atlasData = (level << 28) + atlasCoords;
-            _brickMap.emplace(brickIndex, atlasData);
-            _nStreamedBricks++;
-            fillVolume(
-                &sequenceBuffer[_nBrickVals*(brickIndex - firstBrickIndex)],
-                mappedBuffer,
-                atlasCoords
-            );
+    // The required bricks are sorted, so bricks that are next to each other in the file
+    // end up next to each other in the batch
+    for (bool evictFallbacks : { false, true }) {
+        for (unsigned int brick : _requiredBricks) {
+            if (_brickMap.count(brick)) {
+                continue;
+            }
+            const unsigned int atlasCoords = allocateAtlasCoords(evictFallbacks);
+            if (atlasCoords == NotUsedIndex) {
+                break;
+            }
+            _batch.bricks.push_back(brick);
+            _batch.atlasCoords.push_back(atlasCoords);
+        }
+        if (!_batch.bricks.empty()) {
+            break;
         }
     }
 
-    delete[] sequenceBuffer;
+    if (_batch.bricks.empty()) {
+        return false;
+    }
+
+    _batch.stagingBuffer = _nextStagingBuffer;
+    _nextStagingBuffer = 1 - _nextStagingBuffer;
+    _streamer->request(_batch.bricks, _stagingBuffers[_batch.stagingBuffer]);
+    _hasBatchInFlight = true;
+    _nDiskReads++;
+    return true;
 }
 
-void AtlasManager::removeFromAtlas(int brickIndex) {
-    unsigned int atlasData = _brickMap[brickIndex];
-    unsigned int atlasCoords = atlasData & 0x0FFFFFFF;
-    _brickMap.erase(brickIndex);
-    _freeAtlasCoords.push_back(atlasCoords);
+void AtlasManager::uploadBatch() {
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pboHandle[_batch.stagingBuffer]);
+    glFlushMappedBufferRange(
+        GL_PIXEL_UNPACK_BUFFER,
+        0,
+        static_cast<GLsizeiptr>(_batch.bricks.size()) * _brickSize
+    );
+
+    // Each brick is uploaded directly into its slot, so no scattering into the layout
+    // of the atlas is needed on the CPU
+    glBindTexture(GL_TEXTURE_3D, *_textureAtlas);
+    for (size_t i = 0; i < _batch.bricks.size(); ++i) {
+        const unsigned int brick = _batch.bricks[i];
+        const unsigned int atlasCoords = _batch.atlasCoords[i];
+
+        const GLint x = atlasCoords % _nBricksPerDim;
+        const GLint y = (atlasCoords / _nBricksPerDim) % _nBricksPerDim;
+        const GLint z = atlasCoords / _nBricksPerDim / _nBricksPerDim;
+        const GLsizei dim = static_cast<GLsizei>(_paddedBrickDim);
+        glTexSubImage3D(
+            GL_TEXTURE_3D,
+            0,
+            x * dim,
+            y * dim,
+            z * dim,
+            dim,
+            dim,
+            dim,
+            GL_RED,
+            GL_FLOAT,
+            reinterpret_cast<void*>(i * _brickSize)
+        );
+
+        _brickMap.emplace(brick, atlasData(brick, atlasCoords));
+        if (!_requiredBricks.count(brick)) {
+            addToLru(brick);
+        }
+    }
+    glBindTexture(GL_TEXTURE_3D, 0);
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+    _uploadFences[_batch.stagingBuffer] = glFenceSync(
+        GL_SYNC_GPU_COMMANDS_COMPLETE,
+        GL_NONE_BIT
+    );
+
+    _nStreamedBricks += static_cast<unsigned int>(_batch.bricks.size());
+    _hasBatchInFlight = false;
 }
 
-void AtlasManager::fillVolume(float* in, float* out, unsigned int linearAtlasCoords) {
-    int x = linearAtlasCoords % _nBricksPerDim;
-    int y = (linearAtlasCoords / _nBricksPerDim) % _nBricksPerDim;
-    int z = linearAtlasCoords / _nBricksPerDim / _nBricksPerDim;
-
-    unsigned int xMin = x*_paddedBrickDim;
-    unsigned int yMin = y*_paddedBrickDim;
-    unsigned int zMin = z*_paddedBrickDim;
-    unsigned int xMax = xMin + _paddedBrickDim;
-    unsigned int yMax = yMin + _paddedBrickDim;
-    unsigned int zMax = zMin + _paddedBrickDim;
-
-    unsigned int from = 0;
-    for (unsigned int zValCoord = zMin; zValCoord<zMax; ++zValCoord) {
-        for (unsigned int yValCoord = yMin; yValCoord<yMax; ++yValCoord) {
-            for (unsigned int xValCoord = xMin; xValCoord<xMax; ++xValCoord) {
-                unsigned int idx = xValCoord + yValCoord * _atlasDim +
-                                   zValCoord * _atlasDim * _atlasDim;
-
-                out[idx] = in[from];
-                from++;
+bool AtlasManager::buildAtlasMap(const std::vector<int>& brickIndices) {
+    bool isComplete = true;
+    _nMissingBricks = 0;
+    _fallbackBricks.clear();
+    for (size_t i = 0; i < brickIndices.size(); i++) {
+        const unsigned int brick = brickIndices[i];
+        auto it = _brickMap.find(brick);
+        if (it != _brickMap.end()) {
+            _atlasMap[i] = it->second;
+            continue;
+        }
+
+        _nMissingBricks++;
+
+        // Use the closest ancestor that is in the atlas, preferring the ones that have
+        // the higher spatial resolution. The level that is stored with the brick tells
+        // the shader which part of the ancestor covers this position
+        const unsigned int bstNode = brick / _nOtNodes;
+        unsigned int octreeNode = brick % _nOtNodes;
+        it = _brickMap.end();
+        while (it == _brickMap.end()) {
+            unsigned int ancestorBstNode = bstNode;
+            while (true) {
+                it = _brickMap.find(ancestorBstNode * _nOtNodes + octreeNode);
+                if (it != _brickMap.end() || ancestorBstNode == 0) {
+                    break;
+                }
+                ancestorBstNode = (ancestorBstNode - 1) / 2;
             }
+            if (octreeNode == 0) {
+                break;
+            }
+            octreeNode = (octreeNode - 1) / 8;
+        }
+
+        if (it != _brickMap.end()) {
+            _atlasMap[i] = it->second;
+            _fallbackBricks.insert(it->first);
+        }
+        else {
+            _atlasMap[i] = NotUsedIndex;
+            isComplete = false;
         }
     }
+    return isComplete;
 }
 
-void AtlasManager::pboToAtlas(BufferIndex bufferIndex) {
-    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, _pboHandle[bufferIndex]);
-    glm::size3_t dim = _textureAtlas->dimensions();
-    glBindTexture(GL_TEXTURE_3D, *_textureAtlas);
-    glTexSubImage3D(
-        GL_TEXTURE_3D,
-        0,
-        0,
-        0,
-        0,
-        static_cast<GLsizei>(dim[0]),
-        static_cast<GLsizei>(dim[1]),
-        static_cast<GLsizei>(dim[2]),
-        GL_RED,
-        GL_FLOAT,
-        nullptr
+unsigned int AtlasManager::atlasData(unsigned int brickIndex,
+                                     unsigned int atlasCoords) const
+{
+    int level = _nOtLevels - static_cast<int>(
+        floor(log((7.0 * (float(brickIndex % _nOtNodes)) + 1.0))/log(8)) - 1
     );
-    glBindTexture(GL_TEXTURE_3D, 0);
-    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    ghoul_assert(atlasCoords <= 0x0FFFFFFF, "@MISSING");
+    return (level << 28) + atlasCoords;
+}
+
+unsigned int AtlasManager::allocateAtlasCoords(bool evictFallbacks) {
+    if (!_freeAtlasCoords.empty()) {
+        const unsigned int atlasCoords = _freeAtlasCoords.back();
+        _freeAtlasCoords.pop_back();
+        return atlasCoords;
+    }
+
+    // Evict the least recently used brick that is no longer required
+    for (auto it = _lruBricks.rbegin(); it != _lruBricks.rend(); ++it) {
+        const unsigned int brick = *it;
+        if (!evictFallbacks && _fallbackBricks.count(brick)) {
+            continue;
+        }
+        removeFromLru(brick);
+        const unsigned int atlasCoords = _brickMap[brick] & 0x0FFFFFFF;
+        _brickMap.erase(brick);
+        return atlasCoords;
+    }
+    return NotUsedIndex;
+}
+
+void AtlasManager::addToLru(unsigned int brickIndex) {
+    removeFromLru(brickIndex);
+    _lruBricks.push_front(brickIndex);
+    _lruPositions[brickIndex] = _lruBricks.begin();
+}
+
+void AtlasManager::removeFromLru(unsigned int brickIndex) {
+    auto it = _lruPositions.find(brickIndex);
+    if (it != _lruPositions.end()) {
+        _lruBricks.erase(it->second);
+        _lruPositions.erase(it);
+    }
 }
 
 ghoul::opengl::Texture& AtlasManager::textureAtlas() {
@@ -270,6 +437,14 @@ unsigned int AtlasManager::numStreamedBricks() const {
     return _nStreamedBricks;
 }
 
+float AtlasManager::readThroughput() const {
+    return _streamer ? _streamer->throughput() : 0.f;
+}
+
+unsigned int AtlasManager::queueDepth() const {
+    return _nMissingBricks;
+}
+
 glm::size3_t AtlasManager::textureSize() const {
     return _textureAtlas->dimensions();
 }
@@ -26,63 +26,121 @@
 #define __OPENSPACE_MODULE_MULTIRESVOLUME___ATLASMANAGER___H__
 
 #include <ghoul/glm.h>
+#include <ghoul/opengl/ghoul_gl.h>
 #include <glm/gtx/std_based_type.hpp>
-#include <map>
+#include <limits>
+#include <list>
+#include <memory>
 #include <set>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace ghoul::opengl { class Texture; }
 
 namespace openspace {
 
+class BrickStreamer;
 class TSP;
 
+/**
+ * Keeps the bricks selected by a brick selector in a texture atlas. Bricks that are not
+ * in the atlas yet are read by a BrickStreamer on a background thread into one of two
+ * persistently mapped pixel buffers, and the render thread only uploads the finished
+ * bricks into their atlas slots. Until a brick has arrived, its closest ancestor in the
+ * atlas is used in its place. Bricks that are no longer selected stay in the atlas until
+ * their slot is needed, and the least recently used ones are evicted first.
+ */
 class AtlasManager {
 public:
-    enum BufferIndex {
-        EVEN = 0,
-        ODD = 1
-    };
-
     AtlasManager(TSP* tsp);
-    ~AtlasManager() = default;
+    ~AtlasManager();
 
-    void updateAtlas(BufferIndex bufferIndex, std::vector<int>& brickIndices);
-    void addToAtlas(int firstBrickIndex, int lastBrickIndex, float* mappedBuffer);
-    void removeFromAtlas(int brickIndex);
+    void updateAtlas(std::vector<int>& brickIndices);
     bool initialize();
+    void deinitialize();
     const std::vector<unsigned int>& atlasMap() const;
     unsigned int atlasMapBuffer() const;
 
-    void pboToAtlas(BufferIndex bufferIndex);
     ghoul::opengl::Texture& textureAtlas();
 
     unsigned int numDiskReads() const;
     unsigned int numUsedBricks() const;
     unsigned int numStreamedBricks() const;
 
+    /// Returns the rate in MB/s with which the last batch of bricks was read
+    float readThroughput() const;
+
+    /// Returns the number of selected bricks that are not in the atlas yet
+    unsigned int queueDepth() const;
+
     glm::size3_t textureSize() const;
 
 private:
+    struct Batch {
+        std::vector<unsigned int> bricks;
+        std::vector<unsigned int> atlasCoords;
+        int stagingBuffer = 0;
+    };
+
     const unsigned int NotUsedIndex = std::numeric_limits<unsigned int>::max();
 
+    // Requests the selected bricks that are neither in the atlas nor in flight from the
+    // streamer and returns whether any brick was requested. Bricks that are used in place
+    // of missing bricks are only evicted if no other brick can be requested otherwise.
+    // If the GPU is still reading from the next staging buffer, this either waits for it
+    // or returns without requesting anything, depending on \p waitForStagingBuffer
+    bool requestMissingBricks(bool waitForStagingBuffer);
+
+    // Returns whether the GPU has finished reading from the \p stagingBuffer, waiting
+    // until it has if \p wait is true
+    bool isStagingBufferAvailable(int stagingBuffer, bool wait);
+
+    // Uploads the bricks of the batch that the streamer has finished into the atlas
+    void uploadBatch();
+
+    // Fills the atlas map with the bricks, or the closest ancestors, that are in the
+    // atlas and returns whether every position could be filled
+    bool buildAtlasMap(const std::vector<int>& brickIndices);
+
+    unsigned int atlasData(unsigned int brickIndex, unsigned int atlasCoords) const;
+    unsigned int allocateAtlasCoords(bool evictFallbacks);
+    void addToLru(unsigned int brickIndex);
+    void removeFromLru(unsigned int brickIndex);
+
     TSP* _tsp;
-    unsigned int _pboHandle[2];
+    std::unique_ptr<BrickStreamer> _streamer;
+
+    GLuint _pboHandle[2] = { 0, 0 };
+    float* _stagingBuffers[2] = { nullptr, nullptr };
+    GLsync _uploadFences[2] = { nullptr, nullptr };
+    int _nextStagingBuffer = 0;
     unsigned int _atlasMapBuffer;
 
     std::vector<unsigned int> _atlasMap;
-    std::map<unsigned int, unsigned int> _brickMap;
+    std::unordered_map<unsigned int, unsigned int> _brickMap;
     std::vector<unsigned int> _freeAtlasCoords;
     std::set<unsigned int> _requiredBricks;
     std::set<unsigned int> _prevRequiredBricks;
 
+    // Bricks that are in the atlas without being required, most recently used first
+    std::list<unsigned int> _lruBricks;
+    std::unordered_map<unsigned int, std::list<unsigned int>::iterator> _lruPositions;
+
+    // Bricks that are currently rendered in place of bricks that are not loaded yet
+    std::unordered_set<unsigned int> _fallbackBricks;
+
+    Batch _batch;
+    bool _hasBatchInFlight = false;
+
     ghoul::opengl::Texture* _textureAtlas;
 
     // Stats
-    unsigned int _nUsedBricks;
-    unsigned int _nStreamedBricks;
-    unsigned int _nDiskReads;
+    unsigned int _nUsedBricks = 0;
+    unsigned int _nStreamedBricks = 0;
+    unsigned int _nDiskReads = 0;
+    unsigned int _nMissingBricks = 0;
 
     unsigned int _nBricksPerDim;
     unsigned int _nOtLeaves;
@@ -95,8 +153,6 @@ private:
     unsigned int _nBricksInAtlas;
     unsigned int _nBricksInMap;
     unsigned int _atlasDim;
-
-    void fillVolume(float* in, float* out, unsigned int linearAtlasCoords);
 };
 
 } // namespace openspace
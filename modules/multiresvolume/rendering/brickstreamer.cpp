@@ -0,0 +1,132 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <modules/multiresvolume/rendering/brickstreamer.h>
+
+#include <modules/multiresvolume/rendering/tsp.h>
+#include <ghoul/misc/assert.h>
+#include <chrono>
+#include <cstring>
+
+namespace openspace {
+
+BrickStreamer::BrickStreamer(const TSP& tsp)
+    : _tsp(tsp)
+    , _thread([this]() { run(); })
+{}
+
+BrickStreamer::~BrickStreamer() {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _shouldStop = true;
+    }
+    _requestCondition.notify_one();
+    _thread.join();
+}
+
+void BrickStreamer::request(std::vector<unsigned int> bricks, float* destination) {
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        ghoul_assert(!_isBusy, "A request is already in flight");
+
+        _bricks = std::move(bricks);
+        _destination = destination;
+        _numQueuedBricks = static_cast<unsigned int>(_bricks.size());
+        _isBusy = true;
+    }
+    _requestCondition.notify_one();
+}
+
+bool BrickStreamer::isBusy() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _isBusy;
+}
+
+void BrickStreamer::wait() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _finishedCondition.wait(lock, [this]() { return !_isBusy; });
+}
+
+unsigned int BrickStreamer::numQueuedBricks() const {
+    return _numQueuedBricks;
+}
+
+float BrickStreamer::throughput() const {
+    return _throughput;
+}
+
+void BrickStreamer::run() {
+    const size_t dim = _tsp.paddedBrickDim();
+    const size_t numBrickVals = dim * dim * dim;
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    while (true) {
+        _requestCondition.wait(lock, [this]() { return _isBusy || _shouldStop; });
+        if (!_isBusy) {
+            // We only stop once the last request has finished so that the destination
+            // is not written to after the destructor has returned
+            return;
+        }
+
+        // The request is not touched by the render thread while we are busy, so the
+        // lock is not needed while copying
+        lock.unlock();
+
+        using namespace std::chrono;
+        const auto start = high_resolution_clock::now();
+
+        // Consecutive bricks are stored consecutively in the file as well, so runs of
+        // bricks are copied with a single call
+        size_t i = 0;
+        while (i < _bricks.size()) {
+            size_t run = 1;
+            while (i + run < _bricks.size() && _bricks[i + run] == _bricks[i] + run) {
+                ++run;
+            }
+            std::memcpy(
+                _destination + i * numBrickVals,
+                _tsp.brickData(_bricks[i]),
+                run * numBrickVals * sizeof(float)
+            );
+            i += run;
+            _numQueuedBricks -= static_cast<unsigned int>(run);
+        }
+
+        const double seconds = duration<double>(
+            high_resolution_clock::now() - start
+        ).count();
+        const double megabytes = static_cast<double>(_bricks.size()) * numBrickVals *
+                                 sizeof(float) / (1024.0 * 1024.0);
+        if (seconds > 0.0) {
+            _throughput = static_cast<float>(megabytes / seconds);
+        }
+
+        lock.lock();
+        _isBusy = false;
+        _finishedCondition.notify_all();
+    }
+}
+
+} // namespace openspace
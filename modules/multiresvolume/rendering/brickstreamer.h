@@ -0,0 +1,104 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_MODULE_MULTIRESVOLUME___BRICKSTREAMER___H__
+#define __OPENSPACE_MODULE_MULTIRESVOLUME___BRICKSTREAMER___H__
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace openspace {
+
+class TSP;
+
+/**
+ * Copies bricks of a TSP file into a staging buffer on a background thread. The bricks
+ * are read from the memory-mapped file, so any page faults that cause disk access
+ * happen on the streaming thread rather than on the render thread. Only one request can
+ * be in flight at any given time.
+ */
+class BrickStreamer {
+public:
+    /**
+     * Creates the streamer and starts its thread.
+     *
+     * \pre The header of \p tsp must have been read successfully
+     */
+    explicit BrickStreamer(const TSP& tsp);
+
+    /// Stops the streaming thread after it has finished the current request
+    ~BrickStreamer();
+
+    /**
+     * Starts copying the \p bricks to \p destination, where the i-th brick is written
+     * to the paddedBrickDim()^3 floats starting at destination[i * paddedBrickDim()^3].
+     * \p destination must stay valid until the request has finished.
+     *
+     * \pre No other request must be in flight
+     */
+    void request(std::vector<unsigned int> bricks, float* destination);
+
+    /// Returns whether a request is in flight
+    bool isBusy() const;
+
+    /// Blocks until the request in flight, if any, has finished
+    void wait();
+
+    /// Returns the number of bricks of the current request that have not been copied
+    unsigned int numQueuedBricks() const;
+
+    /**
+     * Returns the rate in MB/s with which the bricks of the last finished request were
+     * read, or 0 if no request has finished yet.
+     */
+    float throughput() const;
+
+private:
+    void run();
+
+    const TSP& _tsp;
+
+    mutable std::mutex _mutex;
+    std::condition_variable _requestCondition;
+    std::condition_variable _finishedCondition;
+
+    std::vector<unsigned int> _bricks;
+    float* _destination = nullptr;
+    bool _isBusy = false;
+    bool _shouldStop = false;
+
+    std::atomic<unsigned int> _numQueuedBricks = 0;
+    std::atomic<float> _throughput = 0.f;
+
+    // The thread is started last, after all the members it uses have been initialized
+    std::thread _thread;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_MULTIRESVOLUME___BRICKSTREAMER___H__
@@ -25,19 +25,67 @@
 #include <modules/multiresvolume/rendering/errorhistogrammanager.h>
 
 #include <modules/multiresvolume/rendering/tsp.h>
+#include <openspace/engine/globals.h>
 #include <openspace/util/progressbar.h>
+#include <openspace/util/workstealingthreadpool.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/fmt.h>
+#include <algorithm>
+#include <fstream>
+
+namespace {
+    // The inner nodes close to the roots cover many more leaves than the others, so we
+    // use many small blocks to let the idle threads pick up the remaining work
+    constexpr const size_t BlocksPerThread = 16;
+} // namespace
 
 namespace openspace {
 
+ErrorHistogramManager::LeafRange ErrorHistogramManager::leafRange(unsigned int node,
+                                                                  unsigned int base,
+                                                                  unsigned int nLevels)
+{
+    unsigned int firstInLevel = 0;
+    unsigned int levelSize = 1;
+    unsigned int depth = 0;
+    while (node >= firstInLevel + levelSize) {
+        firstInLevel += levelSize;
+        levelSize *= base;
+        ++depth;
+    }
+
+    LeafRange range = { node - firstInLevel, 1, 0 };
+    for (; depth < nLevels - 1; ++depth) {
+        firstInLevel += levelSize;
+        levelSize *= base;
+        range.first *= base;
+        range.count *= base;
+        ++range.height;
+    }
+    range.first += firstInLevel;
+    return range;
+}
+
+glm::ivec3 ErrorHistogramManager::leafOffset(unsigned int leaf, unsigned int height,
+                                             unsigned int brickDim)
+{
+    glm::ivec3 offset(0);
+    for (unsigned int level = 0; level < height; ++level) {
+        const int octreeChild = (leaf >> (3 * level)) & 7;
+        const int childSize = static_cast<int>((1u << level) * brickDim);
+        offset.x += (octreeChild % 2) * childSize;
+        offset.y += ((octreeChild / 2) % 2) * childSize;
+        offset.z += (octreeChild / 4) * childSize;
+    }
+    return offset;
+}
+
 ErrorHistogramManager::ErrorHistogramManager(TSP* tsp) : _tsp(tsp) {}
 
 bool ErrorHistogramManager::buildHistograms(int numBins) {
     _numBins = numBins;
 
-    _file = &(_tsp->file());
-    if (!_file->is_open()) {
+    if (!_tsp->isMapped()) {
         return false;
     }
     _minBin = 0.f; // Should be calculated from tsp file
@@ -56,126 +104,83 @@ bool ErrorHistogramManager::buildHistograms(int numBins) {
         fmt::format("Build {} histograms with {} bins each", _numInnerNodes, numBins)
     );
 
-    // All TSP Leaves
-    int numOtNodes = _tsp->numOTNodes();
-    int otOffset = static_cast<int>((pow(8, numOtLevels - 1) - 1) / 7);
-
-    int numBstNodes = _tsp->numBSTNodes();
-    int bstOffset = numBstNodes / 2;
-
-    int numberOfLeaves = (numBstNodes - bstOffset) * (numOtNodes - otOffset);
-    ProgressBar pb(numberOfLeaves);
-    int processedLeaves = 0;
-    bool success = true;
-    for (int bst = bstOffset; bst < numBstNodes; bst++) {
-        for (int ot = otOffset; ot < numOtNodes; ot++) {
-            success &= buildFromLeaf(bst, ot);
-            if (!success) {
-                return false;
+    // Every histogram is only written by the task that builds it, so the inner nodes
+    // can be processed independently of each other
+    WorkStealingThreadPool& pool = global::threadPool;
+    ProgressBar pb(static_cast<int>(_numInnerNodes));
+    pool.parallelFor(
+        _numInnerNodes,
+        pool.numThreads() * BlocksPerThread,
+        [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                buildFromInnerNode(static_cast<unsigned int>(i));
             }
-            pb.print(++processedLeaves);
+            pb.advance(static_cast<int>(end - begin));
         }
-    }
+    );
 
-    return success;
+    return true;
 }
 
-bool ErrorHistogramManager::buildFromLeaf(unsigned int bstOffset,
-                                          unsigned int octreeOffset)
-{
-    // Traverse all ancestors of leaf and add errors to their histograms
-
-    unsigned int brickDim = _tsp->brickDim();
-    unsigned int paddedBrickDim = _tsp->paddedBrickDim();
-    unsigned int padding = (paddedBrickDim - brickDim) / 2;
-
-    int numOtNodes = _tsp->numOTNodes();
-    unsigned int leafIndex = bstOffset * numOtNodes + octreeOffset;
-    std::vector<float> leafValues = readValues(leafIndex);
-//    int numVoxels = leafValues.size();
-
-    int bstNode = bstOffset;
-    bool bstRightOnly = true;
-    unsigned int bstLevel = 0;
-
-    do {
-        glm::vec3 leafOffset(0.f); // Leaf offset in leaf sized voxels
-        unsigned int octreeLevel = 0;
-        unsigned int octreeNode = octreeOffset;
-        bool octreeLastOnly = true;
-        do {
-            // Visit ancestor
-            if (bstNode != static_cast<int>(bstOffset) || octreeNode != octreeOffset) {
-                // Is actually an ancestor
-
-                std::vector<float> ancestorVoxels;
-                unsigned int ancestorBrickIndex = bstNode * numOtNodes + octreeNode;
-                unsigned int innerNodeIndex = brickToInnerNodeIndex(ancestorBrickIndex);
-                auto it = _voxelCache.find(innerNodeIndex);
-                if (it == _voxelCache.end()) {
-                    // First visit
-                    _histograms[innerNodeIndex] = Histogram(_minBin, _maxBin, _numBins);
-                    ancestorVoxels = readValues(ancestorBrickIndex);
-                    _voxelCache[innerNodeIndex] = ancestorVoxels;
-                } else {
-                    ancestorVoxels = it->second;
-                }
-
-                float voxelScale = static_cast<float>(pow(2.f, octreeLevel));
-                float invVoxelScale = 1.f / voxelScale;
+void ErrorHistogramManager::buildFromInnerNode(unsigned int innerNodeIndex) {
+    // Add the errors of all leaves covered by the inner node to its histogram
 
-                // Calculate leaf offset in ancestor sized voxels
-                glm::vec3 ancestorOffset = (leafOffset * invVoxelScale) +
-                                           glm::vec3(padding - 0.5f);
+    const unsigned int brickDim = _tsp->brickDim();
+    const unsigned int paddedBrickDim = _tsp->paddedBrickDim();
+    const unsigned int padding = (paddedBrickDim - brickDim) / 2;
 
-                for (int z = 0; z < static_cast<int>(brickDim); z++) {
-                    for (int y = 0; y < static_cast<int>(brickDim); y++) {
-                        for (int x = 0; x < static_cast<int>(brickDim); x++) {
-                            glm::vec3 leafSamplePoint = glm::vec3(x, y, z) +
+    const unsigned int numOtNodes = _tsp->numOTNodes();
+    const unsigned int brickIndex = innerNodeToBrickIndex(innerNodeIndex);
+    const unsigned int bstNode = brickIndex / numOtNodes;
+    const unsigned int octreeNode = brickIndex % numOtNodes;
+
+    const LeafRange bstLeaves = leafRange(bstNode, 2, _tsp->numBSTLevels());
+    const LeafRange octreeLeaves = leafRange(octreeNode, 8, _tsp->numOTLevels());
+
+    Histogram histogram(_minBin, _maxBin, _numBins);
+    const float* ancestorVoxels = _tsp->brickData(brickIndex);
+
+    const float voxelScale = static_cast<float>(pow(2.f, octreeLeaves.height));
+    const float invVoxelScale = 1.f / voxelScale;
+
+    for (unsigned int i = 0; i < bstLeaves.count; ++i) {
+        for (unsigned int j = 0; j < octreeLeaves.count; ++j) {
+            const unsigned int leafIndex = (bstLeaves.first + i) * numOtNodes +
+                                           octreeLeaves.first + j;
+            const float* leafValues = _tsp->brickData(leafIndex);
+
+            // Calculate leaf offset in ancestor sized voxels
+            const glm::vec3 offset = glm::vec3(
+                leafOffset(j, octreeLeaves.height, brickDim)
+            );
+            glm::vec3 ancestorOffset = (offset * invVoxelScale) +
+                                       glm::vec3(padding - 0.5f);
+
+            for (int z = 0; z < static_cast<int>(brickDim); z++) {
+                for (int y = 0; y < static_cast<int>(brickDim); y++) {
+                    for (int x = 0; x < static_cast<int>(brickDim); x++) {
+                        glm::vec3 leafSamplePoint = glm::vec3(x, y, z) +
                                                    glm::vec3(static_cast<float>(padding));
-                            glm::vec3 ancestorSamplePoint = ancestorOffset +
-                                (glm::vec3(x, y, z) + glm::vec3(0.5)) * invVoxelScale;
-                            float leafValue = leafValues[linearCoords(leafSamplePoint)];
-                            float ancestorValue = interpolate(
-                                ancestorSamplePoint,
-                                ancestorVoxels
-                            );
-
-                            _histograms[innerNodeIndex].addRectangle(
-                                leafValue,
-                                ancestorValue,
-                                std::abs(leafValue - ancestorValue)
-                            );
-                        }
+                        glm::vec3 ancestorSamplePoint = ancestorOffset +
+                            (glm::vec3(x, y, z) + glm::vec3(0.5)) * invVoxelScale;
+                        float leafValue = leafValues[linearCoords(leafSamplePoint)];
+                        float ancestorValue = interpolate(
+                            ancestorSamplePoint,
+                            ancestorVoxels
+                        );
+
+                        histogram.addRectangle(
+                            leafValue,
+                            ancestorValue,
+                            std::abs(leafValue - ancestorValue)
+                        );
                     }
                 }
-
-                if (bstRightOnly && octreeLastOnly) {
-                    _voxelCache.erase(innerNodeIndex);
-                }
             }
+        }
+    }
 
-            // Traverse to next octree ancestor
-            int octreeChild = (octreeNode - 1) % 8;
-            octreeLastOnly &= octreeChild == 7;
-            octreeNode = parentOffset(octreeNode, 8);
-
-            int childSize = static_cast<int>(pow(2, octreeLevel) * brickDim);
-            leafOffset.x += (octreeChild % 2) * childSize;
-            leafOffset.y += ((octreeChild / 2) % 2) * childSize;
-            leafOffset.z += (octreeChild / 4) * childSize;
-
-            octreeLevel++;
-        // @TODO(emiax):  This does not make sense? unsigned int check against -1
-        } while (octreeNode != -1);
-
-        bstRightOnly &= (bstNode % 2 == 0);
-        bstNode = parentOffset(bstNode, 2);
-
-        bstLevel++;
-    } while (bstNode != -1);
-
-    return true;
+    _histograms[innerNodeIndex] = std::move(histogram);
 }
 
 bool ErrorHistogramManager::loadFromFile(const std::string& filename) {
@@ -250,7 +255,7 @@ unsigned int ErrorHistogramManager::linearCoords(const glm::ivec3& coords) const
 }
 
 float ErrorHistogramManager::interpolate(const glm::vec3& samplePoint,
-                                         const std::vector<float>& voxels) const
+                                         const float* voxels) const
 {
     const int lowX = static_cast<int>(samplePoint.x);
     const int lowY = static_cast<int>(samplePoint.y);
@@ -294,43 +299,6 @@ const Histogram* ErrorHistogramManager::histogram(unsigned int brickIndex) const
     }
 }
 
-int ErrorHistogramManager::parentOffset(int offset, int base) const {
-    if (offset == 0) {
-        return -1;
-    }
-    const int depth = static_cast<int>(
-        floor(log(((base - 1) * offset + 1.0)) / log(base))
-    );
-    const int firstInLevel = static_cast<int>((pow(base, depth) - 1) / (base - 1));
-    const int inLevelOffset = offset - firstInLevel;
-
-    const int parentDepth = depth - 1;
-    const int firstInParentLevel = static_cast<int>(
-        (pow(base, parentDepth) - 1) / (base - 1)
-    );
-    const int parentInLevelOffset = inLevelOffset / base;
-
-    const int parentOffset = firstInParentLevel + parentInLevelOffset;
-    return parentOffset;
-}
-
-std::vector<float> ErrorHistogramManager::readValues(unsigned int brickIndex) const {
-    const unsigned int paddedBrickDim = _tsp->paddedBrickDim();
-    const unsigned int numBrickVals = paddedBrickDim * paddedBrickDim * paddedBrickDim;
-    std::vector<float> voxelValues(numBrickVals);
-
-    std::streampos offset = _tsp->dataPosition() +
-        static_cast<long long>(brickIndex*numBrickVals*sizeof(float));
-    _file->seekg(offset);
-
-    _file->read(
-        reinterpret_cast<char*>(voxelValues.data()),
-        static_cast<size_t>(numBrickVals)*sizeof(float)
-    );
-
-    return voxelValues;
-}
-
 unsigned int ErrorHistogramManager::brickToInnerNodeIndex(unsigned int brickIndex) const {
     const unsigned int numOtNodes = _tsp->numOTNodes();
     const unsigned int numBstLevels = _tsp->numBSTLevels();
@@ -27,8 +27,8 @@
 
 #include <openspace/util/histogram.h>
 #include <ghoul/glm.h>
-#include <iosfwd>
-#include <map>
+#include <string>
+#include <vector>
 
 namespace openspace {
 
@@ -36,6 +36,30 @@ class TSP;
 
 class ErrorHistogramManager {
 public:
+    struct LeafRange {
+        unsigned int first;
+        unsigned int count;
+        /// The number of levels between the node and its leaves
+        unsigned int height;
+    };
+
+    /**
+     * Returns the range of leaves that are covered by the node with the index \p node in
+     * a complete tree with \p nLevels levels and \p base children per node, with the
+     * nodes in breadth-first order.
+     */
+    static LeafRange leafRange(unsigned int node, unsigned int base,
+        unsigned int nLevels);
+
+    /**
+     * Returns the offset in leaf sized voxels of the \p leaf -th octree leaf covered by
+     * an inner node that is \p height levels above its leaves. The base-8 digits of
+     * \p leaf are the child indices on the path from the inner node to the leaf, lowest
+     * level first.
+     */
+    static glm::ivec3 leafOffset(unsigned int leaf, unsigned int height,
+        unsigned int brickDim);
+
     ErrorHistogramManager(TSP* tsp);
     ~ErrorHistogramManager() = default;
 
@@ -47,7 +71,6 @@ public:
 
 private:
     TSP* _tsp;
-    std::ifstream* _file;
 
     std::vector<Histogram> _histograms;
     unsigned int _numInnerNodes;
@@ -55,12 +78,12 @@ private:
     float _maxBin;
     int _numBins;
 
-    std::map<unsigned int, std::vector<float>> _voxelCache;
-
-    bool buildFromLeaf(unsigned int bstOffset, unsigned int octreeOffset);
-    std::vector<float> readValues(unsigned int brickIndex) const;
-
-    int parentOffset(int offset, int base) const;
+    /**
+     * Builds the histogram of the inner node with the \p innerNodeIndex from the
+     * differences between all leaves that it covers and the inner node itself. The
+     * histograms of different inner nodes can be built concurrently.
+     */
+    void buildFromInnerNode(unsigned int innerNodeIndex);
 
     unsigned int brickToInnerNodeIndex(unsigned int brickIndex) const;
     unsigned int innerNodeToBrickIndex(unsigned int innerNodeIndex) const;
@@ -68,8 +91,7 @@ private:
     unsigned int linearCoords(int x, int y, int z) const;
     unsigned int linearCoords(const glm::ivec3& coords) const;
 
-    float interpolate(const glm::vec3& samplePoint,
-        const std::vector<float>& voxels) const;
+    float interpolate(const glm::vec3& samplePoint, const float* voxels) const;
 };
 
 } // namespace openspace
@@ -33,8 +33,7 @@ namespace openspace {
 bool HistogramManager::buildHistograms(TSP* tsp, int numBins) {
     _numBins = numBins;
 
-    std::ifstream& file = tsp->file();
-    if (!file.is_open()) {
+    if (!tsp->isMapped()) {
         return false;
     }
     _minBin = 0.f; // Should be calculated from tsp file
@@ -58,8 +57,9 @@ bool HistogramManager::buildHistogram(TSP* tsp, unsigned int brickIndex) {
 
     if (isBstLeaf && isOctreeLeaf) {
         // TSP leaf, read from file and build histogram
-        std::vector<float> voxelValues = readValues(tsp, brickIndex);
-        size_t numVoxels = voxelValues.size();
+        const unsigned int paddedBrickDim = tsp->paddedBrickDim();
+        const size_t numVoxels = paddedBrickDim * paddedBrickDim * paddedBrickDim;
+        const float* voxelValues = tsp->brickData(brickIndex);
 
         for (size_t v = 0; v < numVoxels; ++v) {
             histogram.add(voxelValues[v], 1.0);
@@ -101,24 +101,6 @@ bool HistogramManager::buildHistogram(TSP* tsp, unsigned int brickIndex) {
     return true;
 }
 
-std::vector<float> HistogramManager::readValues(TSP* tsp, unsigned int brickIndex) {
-    const unsigned int paddedBrickDim = tsp->paddedBrickDim();
-    const unsigned int numBrickVals = paddedBrickDim * paddedBrickDim * paddedBrickDim;
-    std::vector<float> voxelValues(numBrickVals);
-
-    std::streampos offset = tsp->dataPosition() +
-                            static_cast<long long>(brickIndex*numBrickVals*sizeof(float));
-    std::ifstream& file = tsp->file();
-    file.seekg(offset);
-
-    file.read(
-        reinterpret_cast<char*>(voxelValues.data()),
-        static_cast<size_t>(numBrickVals)*sizeof(float)
-    );
-
-    return voxelValues;
-}
-
 bool HistogramManager::loadFromFile(const std::string& filename) {
     std::ifstream file(filename, std::ios::in | std::ios::binary);
     if (!file.is_open()) {
@@ -25,12 +25,18 @@
 #include <modules/multiresvolume/rendering/localerrorhistogrammanager.h>
 
 #include <modules/multiresvolume/rendering/tsp.h>
+#include <openspace/engine/globals.h>
 #include <openspace/util/progressbar.h>
+#include <openspace/util/workstealingthreadpool.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/fmt.h>
+#include <algorithm>
+#include <fstream>
 
 namespace {
     constexpr const char* _loggerCat = "LocalErrorHistogramManager";
+
+    constexpr const size_t BlocksPerThread = 16;
 } // namespace
 
 namespace openspace {
@@ -41,8 +47,7 @@ bool LocalErrorHistogramManager::buildHistograms(int numBins) {
     LINFO(fmt::format("Build histograms with {} bins each", numBins));
     _numBins = numBins;
 
-    _file = &(_tsp->file());
-    if (!_file->is_open()) {
+    if (!_tsp->isMapped()) {
         return false;
     }
     _minBin = 0.f; // Should be calculated from tsp file
@@ -63,107 +68,52 @@ bool LocalErrorHistogramManager::buildHistograms(int numBins) {
         _temporalHistograms[i] = Histogram(_minBin, _maxBin, numBins);
     }
 
-    // All TSP Leaves
-    const int numOtNodes = _tsp->numOTNodes();
-    const int otOffset = static_cast<int>((pow(8, numOtLevels - 1) - 1) / 7);
-
-    const int numBstNodes = _tsp->numBSTNodes();
-    const int bstOffset = numBstNodes / 2;
-
-    const int numberOfLeaves = numOtLeaves * numBstLeaves;
-
-    LINFO("Building spatial histograms");
-    ProgressBar pb1(numberOfLeaves);
-    int processedLeaves = 0;
-    pb1.print(processedLeaves);
-    bool success = true;
-    for (int bst = bstOffset; bst < numBstNodes; bst++) {
-        for (int ot = otOffset; ot < numOtNodes; ot++) {
-            success &= buildFromOctreeChild(bst, ot);
-            if (!success) {
-                LERROR("Failed in buildFromOctreeChild");
-            }
-            if (!success) {
-                return false;
-            }
-            pb1.print(processedLeaves++);
-        }
-    }
-
-    LINFO("Building temporal histograms");
-    ProgressBar pb2(numberOfLeaves);
-    processedLeaves = 0;
-    pb2.print(processedLeaves);
-    for (int ot = otOffset; ot < numOtNodes; ot++) {
-        for (int bst = bstOffset; bst < numBstNodes; bst++) {
-            success &= buildFromBstChild(bst, ot);
-            if (!success) {
-                LERROR("Failed in buildFromBstChild");
-            }
-            if (!success) {
-                return false;
+    // Each inner node only collects the errors of its direct children, so every task
+    // only writes to the histograms of the inner nodes that it was given
+    WorkStealingThreadPool& pool = global::threadPool;
+    ProgressBar pb(static_cast<int>(_numInnerNodes));
+    pool.parallelFor(
+        _numInnerNodes,
+        pool.numThreads() * BlocksPerThread,
+        [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                const unsigned int innerNodeIndex = static_cast<unsigned int>(i);
+                const unsigned int brickIndex = innerNodeToBrickIndex(innerNodeIndex);
+                if (!_tsp->isOctreeLeaf(brickIndex)) {
+                    buildFromOctreeChildren(brickIndex, innerNodeIndex);
+                }
+                if (!_tsp->isBstLeaf(brickIndex)) {
+                    buildFromBstChildren(brickIndex, innerNodeIndex);
+                }
             }
-            pb2.print(processedLeaves++);
+            pb.advance(static_cast<int>(end - begin));
         }
-    }
+    );
 
-    return success;
+    return true;
 }
 
-bool LocalErrorHistogramManager::buildFromOctreeChild(unsigned int bstOffset,
-                                                      unsigned int octreeOffset)
+void LocalErrorHistogramManager::buildFromOctreeChildren(unsigned int parentIndex,
+                                                         unsigned int innerNodeIndex)
 {
     // Add errors to octree parent histogram
-    const int numOtNodes = _tsp->numOTNodes();
-    const unsigned int childIndex = bstOffset * numOtNodes + octreeOffset;
-    const bool isOctreeLeaf = _tsp->isOctreeLeaf(childIndex);
-
-    if (octreeOffset > 0) {
-        // Not octree root
-        std::vector<float> childValues;
-        std::vector<float> parentValues;
-
-        const int octreeParent = parentOffset(octreeOffset, 8);
-        const unsigned int parentIndex = bstOffset * numOtNodes + octreeParent;
-        const unsigned int parentInnerNodeIndex = brickToInnerNodeIndex(parentIndex);
-
-        if (isOctreeLeaf) {
-            childValues = readValues(childIndex);
-        } else {
-            const unsigned int childInnerNodeIndex = brickToInnerNodeIndex(childIndex);
-            auto it = _voxelCache.find(childInnerNodeIndex);
-            if (it != _voxelCache.end()) {
-                childValues = it->second;
-            } else {
-                LERROR(fmt::format(
-                    "Child {} visited without cache, {}, {}",
-                    childIndex,
-                    bstOffset,
-                    octreeOffset
-                ));
-                return false;
-            }
-        }
+    const unsigned int numOtNodes = _tsp->numOTNodes();
+    const unsigned int bstOffset = parentIndex / numOtNodes;
+    const unsigned int octreeParent = parentIndex % numOtNodes;
 
-        const int octreeChildIndex = (octreeOffset - 1) % 8;
-        if (octreeChildIndex == 0) {
-            parentValues = readValues(parentIndex);
-            _voxelCache[parentInnerNodeIndex] = parentValues;
-        } else {
-            auto it = _voxelCache.find(parentInnerNodeIndex);
-            if (it != _voxelCache.end()) {
-                parentValues = it->second;
-            } else {
-                LERROR(fmt::format("Parent {} visited without cache", parentIndex));
-                return false;
-            }
-        }
+    const float* parentValues = _tsp->brickData(parentIndex);
 
-        // Compare values and add errors to parent histogram
-        const unsigned int paddedBrickDim = _tsp->paddedBrickDim();
-        const int brickDim = static_cast<int>(_tsp->brickDim());
-        const unsigned int padding = (paddedBrickDim - brickDim) / 2;
+    const unsigned int paddedBrickDim = _tsp->paddedBrickDim();
+    const int brickDim = static_cast<int>(_tsp->brickDim());
+    const unsigned int padding = (paddedBrickDim - brickDim) / 2;
+
+    for (int octreeChildIndex = 0; octreeChildIndex < 8; ++octreeChildIndex) {
+        const unsigned int octreeOffset = 8 * octreeParent + 1 + octreeChildIndex;
+        const float* childValues = _tsp->brickData(
+            bstOffset * numOtNodes + octreeOffset
+        );
 
+        // Compare values and add errors to parent histogram
         glm::vec3 parentOffset = glm::vec3(
             octreeChildIndex % 2,
             (octreeChildIndex / 2) % 2,
@@ -182,7 +132,7 @@ bool LocalErrorHistogramManager::buildFromOctreeChild(unsigned int bstOffset,
 
                     // Divide by number of child voxels that will be taken into account
                     float rectangleHeight = std::abs(childValue - parentValue) / 8.f;
-                    _spatialHistograms[parentInnerNodeIndex].addRectangle(
+                    _spatialHistograms[innerNodeIndex].addRectangle(
                         childValue,
                         parentValue,
                         rectangleHeight
@@ -190,77 +140,28 @@ bool LocalErrorHistogramManager::buildFromOctreeChild(unsigned int bstOffset,
                 }
             }
         }
-
-        const bool isLastOctreeChild = octreeOffset > 0 && octreeChildIndex == 7;
-        if (isLastOctreeChild) {
-            buildFromOctreeChild(bstOffset, octreeParent);
-        }
     }
-
-    if (!isOctreeLeaf) {
-        const unsigned int childInnerNodeIndex = brickToInnerNodeIndex(childIndex);
-        _voxelCache.erase(childInnerNodeIndex);
-    }
-
-    const int bstChildIndex = bstOffset % 2;
-    const bool isLastBstChild = bstOffset > 0 && bstChildIndex == 0;
-    if (isOctreeLeaf && isLastBstChild) {
-        const int bstParent = parentOffset(bstOffset, 2);
-        buildFromOctreeChild(bstParent, octreeOffset);
-    }
-
-    return true;
 }
 
-bool LocalErrorHistogramManager::buildFromBstChild(unsigned int bstOffset,
-                                                   unsigned int octreeOffset)
+void LocalErrorHistogramManager::buildFromBstChildren(unsigned int parentIndex,
+                                                      unsigned int innerNodeIndex)
 {
     // Add errors to bst parent histogram
-    const int numOtNodes = _tsp->numOTNodes();
-    const unsigned int childIndex = bstOffset * numOtNodes + octreeOffset;
-    const bool isBstLeaf = _tsp->isBstLeaf(childIndex);
-
-    if (bstOffset > 0) {
-        // Not BST root
-        std::vector<float> childValues;
-        std::vector<float> parentValues;
-
-        const int bstParent = parentOffset(bstOffset, 2);
-        const unsigned int parentIndex = bstParent * numOtNodes + octreeOffset;
-        const unsigned int parentInnerNodeIndex = brickToInnerNodeIndex(parentIndex);
-
-        if (isBstLeaf) {
-            childValues = readValues(childIndex);
-        } else {
-            unsigned int childInnerNodeIndex = brickToInnerNodeIndex(childIndex);
-            auto it = _voxelCache.find(childInnerNodeIndex);
-            if (it != _voxelCache.end()) {
-                childValues = it->second;
-            } else {
-                LERROR(fmt::format("Child {} visited without cache", childIndex));
-                return false;
-            }
-        }
+    const unsigned int numOtNodes = _tsp->numOTNodes();
+    const unsigned int bstParent = parentIndex / numOtNodes;
+    const unsigned int octreeOffset = parentIndex % numOtNodes;
 
-        const int bstChildIndex = bstOffset % 2;
-        if (bstChildIndex == 1) {
-            parentValues = readValues(parentIndex);
-            _voxelCache[parentInnerNodeIndex] = parentValues;
-        } else {
-            auto it = _voxelCache.find(parentInnerNodeIndex);
-            if (it != _voxelCache.end()) {
-                parentValues = it->second;
-            } else {
-                LERROR(fmt::format("Parent {} visited without cache", parentIndex));
-                return false;
-            }
-        }
+    const float* parentValues = _tsp->brickData(parentIndex);
 
-        // Compare values and add errors to parent histogram
-        const unsigned int paddedBrickDim = _tsp->paddedBrickDim();
-        const int brickDim = static_cast<int>(_tsp->brickDim());
-        const unsigned int padding = (paddedBrickDim - brickDim) / 2;
+    const unsigned int paddedBrickDim = _tsp->paddedBrickDim();
+    const int brickDim = static_cast<int>(_tsp->brickDim());
+    const unsigned int padding = (paddedBrickDim - brickDim) / 2;
 
+    for (unsigned int bstChildIndex = 1; bstChildIndex <= 2; ++bstChildIndex) {
+        const unsigned int bstOffset = 2 * bstParent + bstChildIndex;
+        const float* childValues = _tsp->brickData(bstOffset * numOtNodes + octreeOffset);
+
+        // Compare values and add errors to parent histogram
         for (int z = 0; z < brickDim; z++) {
             for (int y = 0; y < brickDim; y++) {
                 for (int x = 0; x < brickDim; x++) {
@@ -271,7 +172,7 @@ bool LocalErrorHistogramManager::buildFromBstChild(unsigned int bstOffset,
 
                     // Divide by number of child voxels that will be taken into account
                     float rectangleHeight = std::abs(childValue - parentValue) / 2.f;
-                    _temporalHistograms[parentInnerNodeIndex].addRectangle(
+                    _temporalHistograms[innerNodeIndex].addRectangle(
                         childValue,
                         parentValue,
                         rectangleHeight
@@ -279,26 +180,7 @@ bool LocalErrorHistogramManager::buildFromBstChild(unsigned int bstOffset,
                 }
             }
         }
-
-        const bool isLastBstChild = bstOffset > 0 && bstChildIndex == 0;
-        if (isLastBstChild) {
-            buildFromBstChild(bstParent, octreeOffset);
-        }
-    }
-
-    if (!isBstLeaf) {
-        const unsigned int childInnerNodeIndex = brickToInnerNodeIndex(childIndex);
-        _voxelCache.erase(childInnerNodeIndex);
     }
-
-    const int octreeChildIndex = (octreeOffset - 1) % 8;
-    const bool isLastOctreeChild = octreeOffset > 0 && octreeChildIndex == 7;
-    if (isBstLeaf && isLastOctreeChild) {
-        const int octreeParent = parentOffset(octreeOffset, 8);
-        buildFromBstChild(bstOffset, octreeParent);
-    }
-
-    return true;
 }
 
 bool LocalErrorHistogramManager::loadFromFile(const std::string& filename) {
@@ -393,7 +275,7 @@ unsigned int LocalErrorHistogramManager::linearCoords(glm::ivec3 coords) const {
 }
 
 float LocalErrorHistogramManager::interpolate(glm::vec3 samplePoint,
-                                              const std::vector<float>& voxels) const
+                                              const float* voxels) const
 {
     const int lowX = static_cast<int>(samplePoint.x);
     const int lowY = static_cast<int>(samplePoint.y);
@@ -449,43 +331,6 @@ const Histogram* LocalErrorHistogramManager::temporalHistogram(
     }
 }
 
-int LocalErrorHistogramManager::parentOffset(int offset, int base) const {
-    if (offset == 0) {
-        return -1;
-    }
-    const int depth = static_cast<int>(
-        floor(log(((base - 1) * offset + 1.0)) / log(base))
-    );
-    const int firstInLevel = static_cast<int>((pow(base, depth) - 1) / (base - 1));
-    const int inLevelOffset = offset - firstInLevel;
-
-    const int parentDepth = depth - 1;
-    const int firstInParentLevel = static_cast<int>(
-        (pow(base, parentDepth) - 1) / (base - 1)
-    );
-    const int parentInLevelOffset = inLevelOffset / base;
-
-    const int parentOffset = firstInParentLevel + parentInLevelOffset;
-    return parentOffset;
-}
-
-std::vector<float> LocalErrorHistogramManager::readValues(unsigned int brickIndex) const {
-    const unsigned int paddedBrickDim = _tsp->paddedBrickDim();
-    const unsigned int numBrickVals = paddedBrickDim * paddedBrickDim * paddedBrickDim;
-    std::vector<float> voxelValues(numBrickVals);
-
-    std::streampos offset = _tsp->dataPosition() +
-                            static_cast<long long>(brickIndex*numBrickVals*sizeof(float));
-    _file->seekg(offset);
-
-    _file->read(
-        reinterpret_cast<char*>(voxelValues.data()),
-        static_cast<size_t>(numBrickVals)*sizeof(float)
-    );
-
-    return voxelValues;
-}
-
 unsigned int LocalErrorHistogramManager::brickToInnerNodeIndex(
                                                             unsigned int brickIndex) const
 {
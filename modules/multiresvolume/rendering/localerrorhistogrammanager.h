@@ -27,8 +27,8 @@
 
 #include <openspace/util/histogram.h>
 #include <ghoul/glm.h>
-#include <iosfwd>
-#include <map>
+#include <string>
+#include <vector>
 
 namespace openspace {
 
@@ -47,7 +47,6 @@ public:
 
 private:
     TSP* _tsp = nullptr;
-    std::ifstream* _file;
 
     std::vector<Histogram> _spatialHistograms;
     std::vector<Histogram> _temporalHistograms;
@@ -56,14 +55,17 @@ private:
     float _maxBin = 0.f;
     int _numBins = 0;
 
-    std::map<unsigned int, std::vector<float>> _voxelCache;
+    /**
+     * Adds the errors of the eight octree children of the brick with the
+     * \p parentIndex to the spatial histogram of the inner node \p innerNodeIndex
+     */
+    void buildFromOctreeChildren(unsigned int parentIndex, unsigned int innerNodeIndex);
 
-    bool buildFromOctreeChild(unsigned int bstOffset, unsigned int octreeOffset);
-    bool buildFromBstChild(unsigned int bstOffset, unsigned int octreeOffset);
-
-    std::vector<float> readValues(unsigned int brickIndex) const;
-
-    int parentOffset(int offset, int base) const;
+    /**
+     * Adds the errors of the two BST children of the brick with the \p parentIndex to
+     * the temporal histogram of the inner node \p innerNodeIndex
+     */
+    void buildFromBstChildren(unsigned int parentIndex, unsigned int innerNodeIndex);
 
     unsigned int brickToInnerNodeIndex(unsigned int brickIndex) const;
     unsigned int innerNodeToBrickIndex(unsigned int innerNodeIndex) const;
@@ -71,7 +73,7 @@ private:
     unsigned int linearCoords(int x, int y, int z) const;
     unsigned int linearCoords(glm::ivec3 coords) const;
 
-    float interpolate(glm::vec3 samplePoint, const std::vector<float>& voxels) const;
+    float interpolate(glm::vec3 samplePoint, const float* voxels) const;
 };
 
 } // namespace openspace
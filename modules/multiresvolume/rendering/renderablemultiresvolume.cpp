@@ -56,6 +56,7 @@
 #include <chrono>
 #include <fstream>
 #include <iterator>
+#include <limits>
 
 namespace {
     constexpr const char* _loggerCat = "RenderableMultiresVolume";
@@ -129,6 +130,20 @@ namespace {
         "" // @TODO Missing documentation
     };
 
+    constexpr openspace::properties::Property::PropertyInfo BrickReadThroughputInfo = {
+        "BrickReadThroughput",
+        "Brick Read Throughput (MB/s)",
+        "The rate with which the last batch of bricks was read from the data file, in "
+        "megabytes per second."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo BrickQueueDepthInfo = {
+        "BrickQueueDepth",
+        "Brick Queue Depth",
+        "The number of selected bricks that have not been streamed to the GPU yet. In "
+        "their place, the closest coarser bricks are rendered."
+    };
+
     constexpr openspace::properties::Property::PropertyInfo ScalingExponentInfo = {
         "ScalingExponent",
         "Scaling Exponent",
@@ -167,6 +182,8 @@ RenderableMultiresVolume::RenderableMultiresVolume(const ghoul::Dictionary& dict
     , _selectorName(SelectorNameInfo, "tf")
     , _statsToFile(StatsToFileInfo, false)
     , _statsToFileName(StatsToFileNameInfo)
+    , _brickReadThroughput(BrickReadThroughputInfo, 0.f, 0.f, 100000.f)
+    , _brickQueueDepth(BrickQueueDepthInfo, 0, 0, std::numeric_limits<int>::max())
     , _scalingExponent(ScalingExponentInfo, 1, -10, 20)
     , _translation(TranslationInfo, glm::vec3(0.f), glm::vec3(0.f), glm::vec3(10.f))
     , _rotation(RotationInfo, glm::vec3(0.f, 0.f, 0.f), glm::vec3(0.f), glm::vec3(6.28f))
@@ -290,6 +307,10 @@ RenderableMultiresVolume::RenderableMultiresVolume(const ghoul::Dictionary& dict
     addProperty(_loop);
     addProperty(_statsToFile);
     addProperty(_statsToFileName);
+    _brickReadThroughput.setReadOnly(true);
+    addProperty(_brickReadThroughput);
+    _brickQueueDepth.setReadOnly(true);
+    addProperty(_brickQueueDepth);
     addProperty(_scaling);
     addProperty(_scalingExponent);
     addProperty(_translation);
@@ -436,6 +457,9 @@ void RenderableMultiresVolume::initializeGL() {
 }
 
 void RenderableMultiresVolume::deinitializeGL() {
+    if (_atlasManager) {
+        _atlasManager->deinitialize();
+    }
     _tsp = nullptr;
     _transferFunction = nullptr;
 }
@@ -700,7 +724,9 @@ void RenderableMultiresVolume::update(const UpdateData& data) {
             uploadStart = selectionEnd;
         }
 
-        _atlasManager->updateAtlas(AtlasManager::EVEN, _brickIndices);
+        _atlasManager->updateAtlas(_brickIndices);
+        _brickReadThroughput = _atlasManager->readThroughput();
+        _brickQueueDepth = static_cast<int>(_atlasManager->queueDepth());
 
         if (_gatheringStats) {
             std::chrono::system_clock::time_point uploadEnd =
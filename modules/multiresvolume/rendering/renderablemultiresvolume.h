@@ -94,6 +94,8 @@ private:
     properties::StringProperty _selectorName;
     properties::BoolProperty _statsToFile;
     properties::StringProperty _statsToFileName;
+    properties::FloatProperty _brickReadThroughput;
+    properties::IntProperty _brickQueueDepth;
     properties::IntProperty _scalingExponent;
     properties::Vec3Property _translation;
     properties::Vec3Property _rotation;
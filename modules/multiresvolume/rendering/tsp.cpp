@@ -24,17 +24,51 @@
 
 #include <modules/multiresvolume/rendering/tsp.h>
 
+#include <openspace/engine/globals.h>
+#include <openspace/util/progressbar.h>
+#include <openspace/util/workstealingthreadpool.h>
 #include <ghoul/fmt.h>
 #include <ghoul/glm.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/logging/logmanager.h>
-#include <numeric>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <cmath>
 #include <queue>
 
 namespace {
     constexpr const char* _loggerCat = "TSP";
+
+    // The bricks are split into this many blocks per thread, as the bricks higher up in
+    // the trees cover many more leaves than the ones further down
+    constexpr const size_t BlocksPerThread = 16;
+
+    // Returns the sum of f(values[i]). The independent accumulators break up the
+    // dependency chain of a serial floating point sum, which lets the compiler
+    // vectorize the loop
+    template <typename Func>
+    double sum(const float* values, size_t n, Func f) {
+        constexpr const size_t Lanes = 8;
+        double lanes[Lanes] = {};
+        size_t i = 0;
+        for (; i + Lanes <= n; i += Lanes) {
+            for (size_t l = 0; l < Lanes; ++l) {
+                lanes[l] += f(values[i + l]);
+            }
+        }
+
+        double result = 0.0;
+        for (; i < n; ++i) {
+            result += f(values[i]);
+        }
+        for (double l : lanes) {
+            result += l;
+        }
+        return result;
+    }
 } // namespace
 
 namespace openspace {
@@ -66,19 +100,17 @@ bool TSP::load() {
             return false;
         }
 
-        if (false) {
-            if (!calculateSpatialError()) {
-                LERROR("Could not calculate spatial error");
-                return false;
-            }
-            if (!calculateTemporalError()) {
-                LERROR("Could not calculate temporal error");
-                return false;
-            }
-            if (!writeCache()) {
-                LERROR("Could not write cache");
-                return false;
-            }
+        if (!calculateSpatialError()) {
+            LERROR("Could not calculate spatial error");
+            return false;
+        }
+        if (!calculateTemporalError()) {
+            LERROR("Could not calculate temporal error");
+            return false;
+        }
+        if (!writeCache()) {
+            LERROR("Could not write cache");
+            return false;
         }
     }
     initalizeSSO();
@@ -127,6 +159,26 @@ bool TSP::readHeader() {
     _data.resize(_numTotalNodes*NUM_DATA);
     LDEBUG(fmt::format("Data size: {}",  _data.size()));
 
+    try {
+        _mappedFile = std::make_unique<MemoryMappedFile>(_filename);
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERRORC(e.component, e.message);
+        return false;
+    }
+
+    const size_t numBrickVals = _paddedBrickDim * _paddedBrickDim * _paddedBrickDim;
+    const size_t expectedSize = dataPosition() +
+                                _numTotalNodes * numBrickVals * sizeof(float);
+    if (_mappedFile->size() < expectedSize) {
+        LERROR(fmt::format(
+            "File '{}' contains {} bytes, but its header requires {}",
+            _filename, _mappedFile->size(), expectedSize
+        ));
+        _mappedFile = nullptr;
+        return false;
+    }
+
     return true;
 }
 
@@ -265,109 +317,97 @@ GLuint TSP::ssbo() const {
     return _dataSSBO;
 }
 
-bool TSP::calculateSpatialError() {
-    unsigned int numBrickVals = _paddedBrickDim*_paddedBrickDim*_paddedBrickDim;
+const float* TSP::brickData(unsigned int brickIndex) const {
+    ghoul_assert(_mappedFile, "The header has not been read");
+    ghoul_assert(brickIndex < _numTotalNodes, "Invalid brick index");
+
+    const size_t numBrickVals = _paddedBrickDim * _paddedBrickDim * _paddedBrickDim;
+    return reinterpret_cast<const float*>(_mappedFile->data() + dataPosition()) +
+           brickIndex * numBrickVals;
+}
 
-    if (!_file.is_open()) {
+bool TSP::isMapped() const {
+    return _mappedFile != nullptr;
+}
+
+bool TSP::calculateSpatialError() {
+    if (!_mappedFile) {
         return false;
     }
 
-    std::vector<float> buffer(numBrickVals);
+    const unsigned int numBrickVals = _paddedBrickDim*_paddedBrickDim*_paddedBrickDim;
+
     std::vector<float> averages(_numTotalNodes);
     std::vector<float> stdDevs(_numTotalNodes);
 
+    WorkStealingThreadPool& pool = global::threadPool;
+    const size_t nBlocks = pool.numThreads() * BlocksPerThread;
+
     // First pass: Calculate average color for each brick
     LDEBUG("Calculating spatial error, first pass");
-    for (unsigned int brick = 0; brick<_numTotalNodes; ++brick) {
-        // Offset in file
-        std::streampos offset = dataPosition() +
-                                static_cast<long long>(brick*numBrickVals*sizeof(float));
-        _file.seekg(offset);
-
-        _file.read(
-            reinterpret_cast<char*>(&buffer[0]),
-            static_cast<size_t>(numBrickVals) * sizeof(float)
-        );
-
-        double average = std::accumulate(
-            buffer.begin(),
-            buffer.end(),
-            0.0,
-            [](double a, float b) { return a + static_cast<double>(b); }
-        );
-        averages[brick] = static_cast<float>(average / static_cast<double>(numBrickVals));
+    {
+        ProgressBar progress(static_cast<int>(_numTotalNodes));
+        pool.parallelFor(_numTotalNodes, nBlocks, [&](size_t begin, size_t end) {
+            for (size_t brick = begin; brick < end; ++brick) {
+                const double average = sum(
+                    brickData(static_cast<unsigned int>(brick)),
+                    numBrickVals,
+                    [](float v) { return static_cast<double>(v); }
+                );
+                averages[brick] = static_cast<float>(average / numBrickVals);
+            }
+            progress.advance(static_cast<int>(end - begin));
+        });
     }
 
-    // Spatial SNR stats
-    float minError = 1e20f;
-    float maxError = 0.f;
-    std::vector<float> medianArray(_numTotalNodes);
-
     // Second pass: For each brick, compare the covered leaf voxels with
     // the brick average
     LDEBUG("Calculating spatial error, second pass");
-    for (unsigned int brick = 0; brick < _numTotalNodes; ++brick) {
-        // Fetch mean intensity
-        float brickAvg = averages[brick];
-
-        // Sum  for std dev computation
-        float stdDev = 0.f;
-
-        // Get a list of leaf bricks that the current brick covers
-        std::list<unsigned int> leafBricksCovered = coveredLeafBricks(brick);
-
-        // If the brick is already a leaf, assign a negative error.
-        // Ad hoc "hack" to distinguish leafs from other nodes that happens
-        // to get a zero error due to rounding errors or other reasons.
-        if (leafBricksCovered.size() == 1) {
-            stdDev = -0.1f;
-        }
-        else {
-
-            // Calculate "standard deviation" corresponding to leaves
-            for (auto lb = leafBricksCovered.begin(); lb != leafBricksCovered.end(); ++lb)
-            {
-                // Read brick
-                std::streampos offset = dataPosition() +
-                                 static_cast<long long>((*lb)*numBrickVals*sizeof(float));
-                _file.seekg(offset);
+    {
+        ProgressBar progress(static_cast<int>(_numTotalNodes));
+        pool.parallelFor(_numTotalNodes, nBlocks, [&](size_t begin, size_t end) {
+            for (size_t brick = begin; brick < end; ++brick) {
+                // Get a list of leaf bricks that the current brick covers
+                const std::list<unsigned int> leafBricksCovered = coveredLeafBricks(
+                    static_cast<unsigned int>(brick)
+                );
 
-                _file.read(reinterpret_cast<char*>(&buffer[0]),
-                    static_cast<size_t>(numBrickVals)*sizeof(float));
+                // If the brick is already a leaf, assign a negative error.
+                // Ad hoc "hack" to distinguish leafs from other nodes that happens
+                // to get a zero error due to rounding errors or other reasons.
+                if (leafBricksCovered.size() == 1) {
+                    stdDevs[brick] = -0.1f;
+                    continue;
+                }
 
-                // Add to sum
-                for (auto v = buffer.begin(); v != buffer.end(); ++v) {
-                    stdDev += pow(*v - brickAvg, 2.f);
+                // Calculate "standard deviation" corresponding to leaves
+                const double brickAvg = averages[brick];
+                double sumSquares = 0.0;
+                for (unsigned int leaf : leafBricksCovered) {
+                    sumSquares += sum(
+                        brickData(leaf),
+                        numBrickVals,
+                        [brickAvg](float v) {
+                            const double d = v - brickAvg;
+                            return d * d;
+                        }
+                    );
                 }
+                const double n = static_cast<double>(leafBricksCovered.size()) *
+                                 numBrickVals;
+                stdDevs[brick] = static_cast<float>(std::sqrt(sumSquares / n));
             }
-
-            stdDev /= static_cast<float>(leafBricksCovered.size()*numBrickVals);
-            stdDev = sqrt(stdDev);
-        } // if not leaf
-
-        if (stdDev < minError) {
-            minError = stdDev;
-        }
-        else if (stdDev > maxError) {
-            maxError = stdDev;
-        }
-
-        stdDevs[brick] = stdDev;
-        medianArray[brick] = stdDev;
+            progress.advance(static_cast<int>(end - begin));
+        });
     }
 
-    std::sort(medianArray.begin(), medianArray.end());
-    //float medError = medianArray[medianArray.size()/2];
-
     // "Normalize" errors
     float minNorm = 1e20f;
     float maxNorm = 0.f;
     for (unsigned int i = 0; i<_numTotalNodes; ++i) {
-        //float normalized = (stdDevs[i]-minError)/(maxError-minError);
         if (stdDevs[i] > 0.f) {
             stdDevs[i] = pow(stdDevs[i], 0.5f);
         }
-        //_data[i*NUM_DATA + SPATIAL_ERR] = *reinterpret_cast<int*>(&stdDevs[i]);
         _data[i*NUM_DATA + SPATIAL_ERR] = glm::floatBitsToInt(stdDevs[i]);
         if (stdDevs[i] < minNorm) {
             minNorm = stdDevs[i];
@@ -392,84 +432,67 @@ bool TSP::calculateSpatialError() {
 }
 
 bool TSP::calculateTemporalError() {
-    if (!_file.is_open()) {
+    if (!_mappedFile) {
         return false;
     }
 
     LDEBUG("Calculating temporal error");
 
-    // Statistics
-    //float minErr = 1e20f;
-    //float maxErr = 0.f;
-    std::vector<float> meanArray(_numTotalNodes);
+    const unsigned int numBrickVals = _paddedBrickDim * _paddedBrickDim * _paddedBrickDim;
 
     // Save errors
     std::vector<float> errors(_numTotalNodes);
 
-    // Calculate temporal error for one brick at a time
-    for (unsigned int brick = 0; brick<_numTotalNodes; ++brick) {
-        unsigned int numBrickVals = _paddedBrickDim * _paddedBrickDim * _paddedBrickDim;
-
-        // Save the individual voxel's average over timesteps. Because the
-        // BSTs are built by averaging leaf nodes, we only need to sample
-        // the brick at the correct coordinate.
-        std::vector<float> voxelAverages(numBrickVals);
-        std::vector<float> voxelStdDevs(numBrickVals);
-
-        // Read the whole brick to fill the averages
-        std::streampos offset = dataPosition() +
-                                static_cast<long long>(brick*numBrickVals*sizeof(float));
-        _file.seekg(offset);
-
-        _file.read(
-            reinterpret_cast<char*>(voxelAverages.data()),
-            static_cast<size_t>(numBrickVals)*sizeof(float)
-        );
-
-        // Build a list of the BST leaf bricks (within the same octree level) that
-        // this brick covers
-        std::list<unsigned int> coveredBricks = coveredBSTLeafBricks(brick);
-
-        // If the brick is at the lowest BST level, automatically set the error
-        // to -0.1 (enables using -1 as a marker for "no error accepted");
-        // Somewhat ad hoc to get around the fact that the error could be
-        // 0.0 higher up in the tree
-        if (coveredBricks.size() == 1) {
-            errors[brick] = -0.1f;
-        } else {
-            // Calculate standard deviation per voxel, average over brick
-            float avgStdDev = 0.f;
-            for (unsigned int voxel = 0; voxel<numBrickVals; ++voxel) {
-                float stdDev = 0.f;
-                for (auto leaf = coveredBricks.begin();
-                    leaf != coveredBricks.end(); ++leaf)
-                {
-                    // Sample the leaves at the corresponding voxel position
-                    _file.seekg(dataPosition() +
-                        static_cast<long long>(
-                            (*leaf * numBrickVals + voxel) * sizeof(float)
-                        )
-                    );
-
-                    float sample;
-                    _file.read(reinterpret_cast<char*>(&sample), sizeof(float));
+    WorkStealingThreadPool& pool = global::threadPool;
+    const size_t nBlocks = pool.numThreads() * BlocksPerThread;
+
+    ProgressBar progress(static_cast<int>(_numTotalNodes));
+    pool.parallelFor(_numTotalNodes, nBlocks, [&](size_t begin, size_t end) {
+        // Sum of the squared deviations of each voxel
+        std::vector<float> deviations(numBrickVals);
+
+        for (size_t brick = begin; brick < end; ++brick) {
+            // Build a list of the BST leaf bricks (within the same octree level) that
+            // this brick covers
+            const std::list<unsigned int> coveredBricks = coveredBSTLeafBricks(
+                static_cast<unsigned int>(brick)
+            );
+
+            // If the brick is at the lowest BST level, automatically set the error
+            // to -0.1 (enables using -1 as a marker for "no error accepted");
+            // Somewhat ad hoc to get around the fact that the error could be
+            // 0.0 higher up in the tree
+            if (coveredBricks.size() == 1) {
+                errors[brick] = -0.1f;
+                continue;
+            }
 
-                    stdDev += pow(sample - voxelAverages[voxel], 2.f);
+            // The individual voxel's average over timesteps. Because the BSTs are built
+            // by averaging leaf nodes, we only need to sample the brick at the correct
+            // coordinate.
+            const float* voxelAverages = brickData(static_cast<unsigned int>(brick));
+
+            // Accumulate one leaf after the other, which reads each leaf sequentially
+            std::fill(deviations.begin(), deviations.end(), 0.f);
+            for (unsigned int leaf : coveredBricks) {
+                const float* samples = brickData(leaf);
+                for (unsigned int voxel = 0; voxel < numBrickVals; ++voxel) {
+                    const float d = samples[voxel] - voxelAverages[voxel];
+                    deviations[voxel] += d * d;
                 }
-                stdDev /= static_cast<float>(coveredBricks.size());
-                stdDev = sqrt(stdDev);
-
-                avgStdDev += stdDev;
-            } // for voxel
+            }
 
-            avgStdDev /= static_cast<float>(numBrickVals);
-            meanArray[brick] = avgStdDev;
-            errors[brick] = avgStdDev;
+            // Calculate standard deviation per voxel, average over brick
+            const float invNumCovered = 1.f / static_cast<float>(coveredBricks.size());
+            const double sumStdDev = sum(
+                deviations.data(),
+                numBrickVals,
+                [invNumCovered](float v) { return std::sqrt(v * invNumCovered); }
+            );
+            errors[brick] = static_cast<float>(sumStdDev / numBrickVals);
         }
-    } // for all bricks
-
-    std::sort(meanArray.begin(), meanArray.end());
-    //float medErr = meanArray[meanArray.size()/2];
+        progress.advance(static_cast<int>(end - begin));
+    });
 
     // Adjust errors using user-provided exponents
     float minNorm = 1e20f;
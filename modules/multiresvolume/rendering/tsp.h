@@ -25,9 +25,12 @@
 #ifndef __OPENSPACE_MODULE_MULTIRESVOLUME___TSP___H__
 #define __OPENSPACE_MODULE_MULTIRESVOLUME___TSP___H__
 
+#include <openspace/util/memorymappedfile.h>
+
 #include <ghoul/opengl/ghoul_gl.h>
 #include <fstream>
 #include <list>
+#include <memory>
 #include <string>
 #include <vector>
 
@@ -82,6 +85,19 @@ public:
     unsigned int numBricksPerAxis() const;
     GLuint ssbo() const;
 
+    /**
+     * Returns the paddedBrickDim()^3 voxels of the brick with the \p brickIndex from the
+     * memory-mapped file. The pointer is valid for the lifetime of this TSP and can be
+     * read from any thread.
+     *
+     * \pre #readHeader must have been successful
+     * \pre \p brickIndex must be smaller than numTotalNodes()
+     */
+    const float* brickData(unsigned int brickIndex) const;
+
+    /// Returns whether the file was mapped into memory, which #brickData requires
+    bool isMapped() const;
+
     bool calculateSpatialError();
     bool calculateTemporalError();
 
@@ -111,6 +127,7 @@ private:
     std::string _filename;
     std::ifstream _file;
     std::streampos _dataOffset;
+    std::unique_ptr<MemoryMappedFile> _mappedFile;
 
     // Holds the actual structure
     std::vector<int> _data;
@@ -28,8 +28,10 @@
 #include <ghoul/misc/templatefactory.h>
 #include <openspace/json.h>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <thread>
+#include <vector>
 
 namespace ghoul::io { class Socket; }
 
@@ -49,9 +51,27 @@ public:
     );
 
     void handleMessage(const std::string& message);
-    void sendMessage(const std::string& message);
     void handleJson(const nlohmann::json& json);
+
+    // Messages are put in the outbound queue of the connection and are written to the
+    // socket by the I/O thread of the ServerModule. A client that does not read its
+    // messages is disconnected once the queue exceeds MaxOutboundBytes
+    void sendMessage(std::string message);
     void sendJson(const nlohmann::json& json);
+
+    // Queues the current state of a subscription. It replaces the update of the same
+    // topic that has not been written yet, as the client only needs the latest state
+    void sendUpdate(TopicId topicId, const nlohmann::json& json);
+
+    bool hasOutboundMessages();
+
+    // Writes the queued messages to the socket. Only called by the I/O thread
+    void writeOutboundMessages();
+
+    // Gives all topics the chance to send updates that they have accumulated during
+    // the frame
+    void sendPendingTopicUpdates();
+
     void setAuthorized(bool status);
 
     bool isAuthorized() const;
@@ -60,7 +80,13 @@ public:
     std::thread& thread();
     void setThread(std::thread&& thread);
 
+    static constexpr const size_t MaxOutboundBytes = 32 * 1024 * 1024;
+
 private:
+    // Drops all queued messages and disconnects the client if the queue has grown
+    // beyond MaxOutboundBytes. Must be called with the outbound mutex locked
+    void checkOutboundLimit();
+
     ghoul::TemplateFactory<Topic> _topicFactory;
     std::map<TopicId, std::unique_ptr<Topic>> _topics;
     std::unique_ptr<ghoul::io::Socket> _socket;
@@ -70,6 +96,13 @@ private:
     bool _isAuthorized = false;
     std::map<TopicId, std::string> _messageQueue;
     std::map<TopicId, std::chrono::system_clock::time_point> _sentMessages;
+
+    std::mutex _outboundMutex;
+    std::vector<std::string> _outboundMessages;
+    std::map<TopicId, std::string> _outboundUpdates;
+    size_t _nOutboundBytes = 0;
+    // Only accessed by the I/O thread, kept to reuse its allocation
+    std::vector<std::string> _sendingMessages;
 };
 
 } // namespace openspace
@@ -27,6 +27,8 @@
 
 #include <modules/server/include/topics/topic.h>
 
+#include <chrono>
+
 namespace openspace::properties { class Property; }
 
 namespace openspace {
@@ -38,9 +40,11 @@ public:
 
     void handleJson(const nlohmann::json& json) override;
     bool isDone() const override;
+    void sendPendingUpdates() override;
 
 private:
     void resetCallbacks();
+    void sendValue();
 
     const int UnsetCallbackHandle = -1;
 
@@ -49,6 +53,13 @@ private:
     int _onChangeHandle = UnsetCallbackHandle;
     int _onDeleteHandle = UnsetCallbackHandle;
     properties::Property* _prop = nullptr;
+
+    // Changes of the property are coalesced and sent at most once per frame, and at
+    // most once per _minUpdateInterval if the client requested a maximum rate
+    bool _hasPendingUpdate = false;
+    std::chrono::steady_clock::duration _minUpdateInterval =
+        std::chrono::steady_clock::duration::zero();
+    std::chrono::steady_clock::time_point _lastUpdateTime;
 };
 
 } // namespace openspace
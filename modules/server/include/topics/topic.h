@@ -43,6 +43,9 @@ public:
     virtual void handleJson(const nlohmann::json& json) = 0;
     virtual bool isDone() const = 0;
 
+    // Called once per frame; topics that coalesce their updates send them here
+    virtual void sendPendingUpdates();
+
 protected:
     size_t _topicId;
     Connection* _connection;
@@ -37,6 +37,7 @@
 #include <ghoul/io/socket/websocketserver.h>
 #include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/templatefactory.h>
+#include <algorithm>
 
 namespace {
     constexpr const char* KeyInterfaces = "Interfaces";
@@ -53,6 +54,8 @@ ServerModule::ServerModule()
 
 ServerModule::~ServerModule() {
     disconnectAll();
+    // The sockets are disconnected, so a write that is in progress fails immediately
+    stopOutboundThread();
     cleanUpFinishedThreads();
 }
 
@@ -102,6 +105,11 @@ void ServerModule::internalInitialize(const ghoul::Dictionary& configuration) {
 
     }
 
+    if (global::windowDelegate.isMaster()) {
+        _isOutboundThreadRunning = true;
+        _outboundThread = std::thread([this]() { handleOutboundMessages(); });
+    }
+
     global::callback::preSync.emplace_back([this]() { preSync(); });
 }
 
@@ -149,6 +157,9 @@ void ServerModule::preSync() {
     // Consume all messages put into the message queue by the socket threads.
     consumeMessages();
 
+    // Send the updates that the topics have coalesced during the last frame.
+    flushPendingMessages();
+
     // Join threads for sockets that disconnected.
     cleanUpFinishedThreads();
 }
@@ -159,6 +170,7 @@ void ServerModule::cleanUpFinishedThreads() {
         if (!connection.socket() || !connection.socket()->isConnected()) {
             if (connection.thread().joinable()) {
                 connection.thread().join();
+                waitUntilNotWritten(connection);
                 connectionData.isMarkedForRemoval = true;
             }
         }
@@ -197,6 +209,89 @@ void ServerModule::handleConnection(std::shared_ptr<Connection> connection) {
     }
 }
 
+void ServerModule::flushPendingMessages() {
+    // The topic updates are queued without holding the lock of the I/O thread
+    std::vector<Connection*> connections;
+    for (ConnectionData& connectionData : _connections) {
+        Connection* connection = connectionData.connection.get();
+        connection->sendPendingTopicUpdates();
+        if (connection->hasOutboundMessages()) {
+            connections.push_back(connection);
+        }
+    }
+    if (connections.empty()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_outboundMutex);
+        for (Connection* connection : connections) {
+            // A connection that is still waiting for the I/O thread will write all of its
+            // messages once it is its turn
+            const auto it = std::find(
+                _connectionsWithOutboundMessages.begin(),
+                _connectionsWithOutboundMessages.end(),
+                connection
+            );
+            if (it == _connectionsWithOutboundMessages.end()) {
+                _connectionsWithOutboundMessages.push_back(connection);
+            }
+        }
+    }
+    _outboundCondition.notify_one();
+}
+
+void ServerModule::handleOutboundMessages() {
+    std::unique_lock<std::mutex> lock(_outboundMutex);
+    while (true) {
+        _outboundCondition.wait(lock, [this]() {
+            return !_connectionsWithOutboundMessages.empty() ||
+                   !_isOutboundThreadRunning;
+        });
+        if (!_isOutboundThreadRunning) {
+            return;
+        }
+
+        Connection* connection = _connectionsWithOutboundMessages.front();
+        _connectionsWithOutboundMessages.pop_front();
+        _writingConnection = connection;
+
+        lock.unlock();
+        connection->writeOutboundMessages();
+        lock.lock();
+
+        _writingConnection = nullptr;
+        // Wake up the main thread if it waits to destroy this connection
+        _outboundCondition.notify_all();
+    }
+}
+
+void ServerModule::waitUntilNotWritten(const Connection& connection) {
+    std::unique_lock<std::mutex> lock(_outboundMutex);
+    _connectionsWithOutboundMessages.erase(
+        std::remove(
+            _connectionsWithOutboundMessages.begin(),
+            _connectionsWithOutboundMessages.end(),
+            &connection
+        ),
+        _connectionsWithOutboundMessages.end()
+    );
+    _outboundCondition.wait(lock, [this, &connection]() {
+        return _writingConnection != &connection;
+    });
+}
+
+void ServerModule::stopOutboundThread() {
+    {
+        std::lock_guard<std::mutex> lock(_outboundMutex);
+        _isOutboundThreadRunning = false;
+    }
+    _outboundCondition.notify_all();
+    if (_outboundThread.joinable()) {
+        _outboundThread.join();
+    }
+}
+
 void ServerModule::consumeMessages() {
     std::lock_guard<std::mutex> lock(_messageQueueMutex);
     while (!_messageQueue.empty()) {
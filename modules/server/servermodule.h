@@ -29,9 +29,11 @@
 
 #include <modules/server/include/serverinterface.h>
 
+#include <condition_variable>
 #include <deque>
 #include <memory>
 #include <mutex>
+#include <thread>
 
 namespace openspace {
 
@@ -69,10 +71,25 @@ private:
     void consumeMessages();
     void disconnectAll();
     void preSync();
+    void flushPendingMessages();
+    void handleOutboundMessages();
+    void stopOutboundThread();
+    void waitUntilNotWritten(const Connection& connection);
 
     std::mutex _messageQueueMutex;
     std::deque<Message> _messageQueue;
 
+    // A single I/O thread writes the outbound queues of all connections. The
+    // connections are only referenced while they are in _connections; a connection is
+    // removed from the pending list, and any write to it is waited for, before it is
+    // destroyed
+    std::thread _outboundThread;
+    std::mutex _outboundMutex;
+    std::condition_variable _outboundCondition;
+    std::deque<Connection*> _connectionsWithOutboundMessages;
+    const Connection* _writingConnection = nullptr;
+    bool _isOutboundThreadRunning = false;
+
     std::vector<ConnectionData> _connections;
     std::vector<std::unique_ptr<ServerInterface>> _interfaces;
     properties::PropertyOwner _interfaceOwner;
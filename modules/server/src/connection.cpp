@@ -187,14 +187,71 @@ void Connection::handleJson(const nlohmann::json& json) {
     }
 }
 
-void Connection::sendMessage(const std::string& message) {
-    _socket->putMessage(message);
+void Connection::sendMessage(std::string message) {
+    std::lock_guard<std::mutex> lock(_outboundMutex);
+    _nOutboundBytes += message.size();
+    _outboundMessages.push_back(std::move(message));
+    checkOutboundLimit();
 }
 
 void Connection::sendJson(const nlohmann::json& json) {
     sendMessage(json.dump());
 }
 
+void Connection::sendUpdate(TopicId topicId, const nlohmann::json& json) {
+    std::string message = json.dump();
+
+    std::lock_guard<std::mutex> lock(_outboundMutex);
+    std::string& update = _outboundUpdates[topicId];
+    _nOutboundBytes = _nOutboundBytes - update.size() + message.size();
+    update = std::move(message);
+    checkOutboundLimit();
+}
+
+bool Connection::hasOutboundMessages() {
+    std::lock_guard<std::mutex> lock(_outboundMutex);
+    return !_outboundMessages.empty() || !_outboundUpdates.empty();
+}
+
+void Connection::checkOutboundLimit() {
+    if (_nOutboundBytes <= MaxOutboundBytes) {
+        return;
+    }
+
+    LWARNING(fmt::format(
+        "Client at {} does not read its messages. Disconnecting", _address
+    ));
+    _outboundMessages.clear();
+    _outboundUpdates.clear();
+    _nOutboundBytes = 0;
+    _socket->disconnect();
+}
+
+void Connection::writeOutboundMessages() {
+    {
+        std::lock_guard<std::mutex> lock(_outboundMutex);
+        std::swap(_sendingMessages, _outboundMessages);
+        for (std::pair<const TopicId, std::string>& update : _outboundUpdates) {
+            _sendingMessages.push_back(std::move(update.second));
+        }
+        _outboundUpdates.clear();
+        _nOutboundBytes = 0;
+    }
+
+    for (const std::string& message : _sendingMessages) {
+        if (!_socket->isConnected() || !_socket->putMessage(message)) {
+            break;
+        }
+    }
+    _sendingMessages.clear();
+}
+
+void Connection::sendPendingTopicUpdates() {
+    for (const std::pair<const TopicId, std::unique_ptr<Topic>>& topic : _topics) {
+        topic.second->sendPendingUpdates();
+    }
+}
+
 bool Connection::isAuthorized() const {
     return _isAuthorized;
 }
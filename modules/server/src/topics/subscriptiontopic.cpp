@@ -36,6 +36,7 @@ namespace {
     constexpr const char* _loggerCat = "SubscriptionTopic";
     constexpr const char* PropertyKey = "property";
     constexpr const char* EventKey = "event";
+    constexpr const char* MaxRateKey = "maxRate";
 
     constexpr const char* StartSubscription = "start_subscription";
     constexpr const char* StopSubscription = "stop_subscription";
@@ -79,19 +80,27 @@ void SubscriptionTopic::handleJson(const nlohmann::json& json) {
         if (_prop) {
             _requestedResourceIsSubscribable = true;
             _isSubscribedTo = true;
-            auto onChange = [this, k = std::move(key)]() {
-                _connection->sendJson(wrappedPayload(_prop));
-            };
 
-            _onChangeHandle = _prop->onChange(onChange);
+            // The optional maximum rate is given in updates per second
+            auto maxRateJson = json.find(MaxRateKey);
+            if (maxRateJson != json.end() && maxRateJson->is_number() &&
+                maxRateJson->get<double>() > 0.0)
+            {
+                _minUpdateInterval = std::chrono::duration_cast<
+                    std::chrono::steady_clock::duration
+                >(std::chrono::duration<double>(1.0 / maxRateJson->get<double>()));
+            }
+
+            _onChangeHandle = _prop->onChange([this]() { _hasPendingUpdate = true; });
             _onDeleteHandle = _prop->onDelete([this]() {
                 _onChangeHandle = UnsetCallbackHandle;
                 _onDeleteHandle = UnsetCallbackHandle;
                 _isSubscribedTo = false;
+                _hasPendingUpdate = false;
             });
 
             // immediately send the value
-            onChange();
+            sendValue();
         }
         else {
             LWARNING(fmt::format("Could not subscribe. Property '{}' not found", key));
@@ -99,6 +108,7 @@ void SubscriptionTopic::handleJson(const nlohmann::json& json) {
     }
     if (event == StopSubscription) {
         _isSubscribedTo = false;
+        _hasPendingUpdate = false;
         if (_prop && _onChangeHandle != UnsetCallbackHandle) {
             _prop->removeOnChange(_onChangeHandle);
             _onChangeHandle = UnsetCallbackHandle;
@@ -110,4 +120,22 @@ void SubscriptionTopic::handleJson(const nlohmann::json& json) {
     }
 }
 
+void SubscriptionTopic::sendPendingUpdates() {
+    if (!_hasPendingUpdate || !_isSubscribedTo) {
+        return;
+    }
+    // A throttled update stays pending, so that the last value of the property is
+    // always sent eventually
+    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    if (now - _lastUpdateTime >= _minUpdateInterval) {
+        sendValue();
+    }
+}
+
+void SubscriptionTopic::sendValue() {
+    _connection->sendUpdate(_topicId, wrappedPayload(_prop));
+    _hasPendingUpdate = false;
+    _lastUpdateTime = std::chrono::steady_clock::now();
+}
+
 } // namespace openspace
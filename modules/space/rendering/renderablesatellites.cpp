@@ -0,0 +1,429 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <modules/space/rendering/renderablesatellites.h>
+
+#include <modules/space/spacemodule.h>
+#include <openspace/documentation/documentation.h>
+#include <openspace/documentation/verifier.h>
+#include <openspace/engine/globals.h>
+#include <openspace/rendering/renderengine.h>
+#include <openspace/util/updatestructures.h>
+#include <openspace/util/workstealingthreadpool.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/opengl/programobject.h>
+#include <algorithm>
+
+namespace {
+    constexpr const char* _loggerCat = "RenderableSatellites";
+    constexpr const char* ProgramName = "SatellitesProgram";
+
+    constexpr const char* KeyPath = "Path";
+    constexpr const char* KeyFileFormat = "FileFormat";
+
+    constexpr const std::array<const char*, 8> UniformNames = {
+        "modelViewTransform", "projectionTransform", "color", "opacity", "pointSize",
+        "trailStep", "nSegments", "renderPhase"
+    };
+
+    // The number of objects that are propagated by one task of the thread pool
+    constexpr const size_t ObjectsPerBlock = 4096;
+
+    // The layout of the per-object buffer that does not change over time
+    struct OrbitVBOLayout {
+        float majorAxis[3];
+        float minorAxis[3];
+        float eccentricity;
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo ColorInfo = {
+        "Color",
+        "Color",
+        "This value determines the RGB color of the objects and their trails."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo PointSizeInfo = {
+        "PointSize",
+        "Point Size",
+        "The size of the points that represent the objects in pixels."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo LineWidthInfo = {
+        "LineWidth",
+        "Line Width",
+        "The line width of the trails. If no trails are shown, this value is ignored."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo TrailLengthInfo = {
+        "TrailLength",
+        "Trail Length",
+        "The fraction of the orbit that is shown as a trail behind each object. If this "
+        "value is 0, no trails are rendered."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo TrailSegmentsInfo = {
+        "TrailSegments",
+        "Trail Segments",
+        "The number of line segments that each trail consists of."
+    };
+} // namespace
+
+namespace openspace {
+
+documentation::Documentation RenderableSatellites::Documentation() {
+    using namespace documentation;
+    return {
+        "RenderableSatellites",
+        "space_renderable_satellites",
+        {
+            {
+                KeyPath,
+                new StringVerifier,
+                Optional::No,
+                "The path to the file that contains the orbits of the objects."
+            },
+            {
+                KeyFileFormat,
+                new StringInListVerifier({ "TLE", "Kepler" }),
+                Optional::Yes,
+                "The format of the file. 'TLE' files contain two-line element sets that "
+                "are optionally preceded by a title line. 'Kepler' files contain the "
+                "eccentricity, semi-major axis (km), inclination, ascending node, "
+                "argument of periapsis, mean anomaly at epoch (all in degrees), epoch "
+                "(seconds past J2000), and period (seconds) of one object per line. The "
+                "default is 'TLE'."
+            },
+            {
+                ColorInfo.identifier,
+                new DoubleVector3Verifier,
+                Optional::Yes,
+                ColorInfo.description
+            },
+            {
+                PointSizeInfo.identifier,
+                new DoubleVerifier,
+                Optional::Yes,
+                PointSizeInfo.description
+            },
+            {
+                LineWidthInfo.identifier,
+                new DoubleVerifier,
+                Optional::Yes,
+                LineWidthInfo.description
+            },
+            {
+                TrailLengthInfo.identifier,
+                new DoubleInRangeVerifier(0.0, 1.0),
+                Optional::Yes,
+                TrailLengthInfo.description
+            },
+            {
+                TrailSegmentsInfo.identifier,
+                new IntVerifier,
+                Optional::Yes,
+                TrailSegmentsInfo.description
+            }
+        }
+    };
+}
+
+RenderableSatellites::RenderableSatellites(const ghoul::Dictionary& dictionary)
+    : Renderable(dictionary)
+    , _color(ColorInfo, glm::vec3(1.f), glm::vec3(0.f), glm::vec3(1.f))
+    , _pointSize(PointSizeInfo, 3.f, 1.f, 32.f)
+    , _lineWidth(LineWidthInfo, 1.f, 1.f, 20.f)
+    , _trailLength(TrailLengthInfo, 0.f, 0.f, 1.f)
+    , _trailSegments(TrailSegmentsInfo, 32, 2, 256)
+{
+    documentation::testSpecificationAndThrow(
+        Documentation(),
+        dictionary,
+        "RenderableSatellites"
+    );
+
+    _path = absPath(dictionary.value<std::string>(KeyPath));
+    if (dictionary.hasKey(KeyFileFormat)) {
+        _isTleFile = (dictionary.value<std::string>(KeyFileFormat) == "TLE");
+    }
+
+    addProperty(_opacity);
+    registerUpdateRenderBinFromOpacity();
+
+    if (dictionary.hasKey(ColorInfo.identifier)) {
+        _color = dictionary.value<glm::vec3>(ColorInfo.identifier);
+    }
+    _color.setViewOption(properties::Property::ViewOptions::Color);
+    addProperty(_color);
+
+    if (dictionary.hasKey(PointSizeInfo.identifier)) {
+        _pointSize = static_cast<float>(
+            dictionary.value<double>(PointSizeInfo.identifier)
+        );
+    }
+    addProperty(_pointSize);
+
+    if (dictionary.hasKey(LineWidthInfo.identifier)) {
+        _lineWidth = static_cast<float>(
+            dictionary.value<double>(LineWidthInfo.identifier)
+        );
+    }
+    addProperty(_lineWidth);
+
+    if (dictionary.hasKey(TrailLengthInfo.identifier)) {
+        _trailLength = static_cast<float>(
+            dictionary.value<double>(TrailLengthInfo.identifier)
+        );
+    }
+    addProperty(_trailLength);
+
+    if (dictionary.hasKey(TrailSegmentsInfo.identifier)) {
+        _trailSegments = static_cast<int>(
+            dictionary.value<double>(TrailSegmentsInfo.identifier)
+        );
+    }
+    addProperty(_trailSegments);
+}
+
+RenderableSatellites::~RenderableSatellites() {}
+
+void RenderableSatellites::initialize() {
+    _catalog = _isTleFile ?
+        KeplerCatalog::loadTleFile(_path) :
+        KeplerCatalog::loadKeplerFile(_path);
+    LINFO(fmt::format("Loaded {} objects from '{}'", _catalog.size(), _path));
+
+    _eccentricAnomalies.resize(_catalog.size());
+}
+
+void RenderableSatellites::initializeGL() {
+    _programObject = SpaceModule::ProgramObjectManager.request(
+        ProgramName,
+        []() -> std::unique_ptr<ghoul::opengl::ProgramObject> {
+            return global::renderEngine.buildRenderProgram(
+                ProgramName,
+                absPath("${MODULE_SPACE}/shaders/satellites_vs.glsl"),
+                absPath("${MODULE_SPACE}/shaders/satellites_fs.glsl")
+            );
+        }
+    );
+
+    ghoul::opengl::updateUniformLocations(*_programObject, _uniformCache, UniformNames);
+
+    uploadOrbits();
+
+    setRenderBin(Renderable::RenderBin::Overlay);
+}
+
+void RenderableSatellites::deinitializeGL() {
+    glDeleteBuffers(1, &_anomalyBuffer);
+    _anomalyBuffer = 0;
+    glDeleteBuffers(1, &_orbitBuffer);
+    _orbitBuffer = 0;
+    glDeleteVertexArrays(1, &_vao);
+    _vao = 0;
+
+    SpaceModule::ProgramObjectManager.release(
+        ProgramName,
+        [](ghoul::opengl::ProgramObject* p) {
+            global::renderEngine.removeRenderProgram(p);
+        }
+    );
+    _programObject = nullptr;
+}
+
+bool RenderableSatellites::isReady() const {
+    return _programObject != nullptr;
+}
+
+void RenderableSatellites::uploadOrbits() {
+    std::vector<OrbitVBOLayout> orbits(_catalog.size());
+    for (size_t i = 0; i < orbits.size(); ++i) {
+        const glm::vec3 major = glm::vec3(_catalog.majorAxis(i));
+        const glm::vec3 minor = glm::vec3(_catalog.minorAxis(i));
+        orbits[i] = {
+            { major.x, major.y, major.z },
+            { minor.x, minor.y, minor.z },
+            static_cast<float>(_catalog.eccentricity(i))
+        };
+    }
+
+    glGenVertexArrays(1, &_vao);
+    glBindVertexArray(_vao);
+
+    glGenBuffers(1, &_orbitBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, _orbitBuffer);
+    glBufferData(
+        GL_ARRAY_BUFFER,
+        orbits.size() * sizeof(OrbitVBOLayout),
+        orbits.data(),
+        GL_STATIC_DRAW
+    );
+
+    // All attributes are per object; the vertices of a trail only differ in gl_VertexID
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(
+        0,
+        3,
+        GL_FLOAT,
+        GL_FALSE,
+        sizeof(OrbitVBOLayout),
+        reinterpret_cast<void*>(offsetof(OrbitVBOLayout, majorAxis))
+    );
+    glVertexAttribDivisor(0, 1);
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(
+        1,
+        3,
+        GL_FLOAT,
+        GL_FALSE,
+        sizeof(OrbitVBOLayout),
+        reinterpret_cast<void*>(offsetof(OrbitVBOLayout, minorAxis))
+    );
+    glVertexAttribDivisor(1, 1);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(
+        2,
+        1,
+        GL_FLOAT,
+        GL_FALSE,
+        sizeof(OrbitVBOLayout),
+        reinterpret_cast<void*>(offsetof(OrbitVBOLayout, eccentricity))
+    );
+    glVertexAttribDivisor(2, 1);
+
+    glGenBuffers(1, &_anomalyBuffer);
+    glBindBuffer(GL_ARRAY_BUFFER, _anomalyBuffer);
+    glBufferData(
+        GL_ARRAY_BUFFER,
+        _eccentricAnomalies.size() * sizeof(float),
+        nullptr,
+        GL_STREAM_DRAW
+    );
+    glEnableVertexAttribArray(3);
+    glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, 0, nullptr);
+    glVertexAttribDivisor(3, 1);
+
+    glBindVertexArray(0);
+}
+
+void RenderableSatellites::update(const UpdateData& data) {
+    const size_t n = _catalog.size();
+    if (n == 0) {
+        return;
+    }
+
+    // The propagation runs on the shared pool, which the main thread helps while waiting
+    WorkStealingThreadPool& pool = global::threadPool;
+    const double time = data.time.j2000Seconds();
+    const size_t nBlocks = std::clamp(
+        n / ObjectsPerBlock,
+        size_t(1),
+        pool.numThreads() * 4
+    );
+    pool.parallelFor(
+        n,
+        nBlocks,
+        [this, time](size_t begin, size_t end) {
+            _catalog.eccentricAnomalies(time, begin, end, _eccentricAnomalies.data());
+        }
+    );
+
+    // Orphan the previous buffer so that we don't have to wait for the draw calls of
+    // the last frame that might still be using it
+    glBindBuffer(GL_ARRAY_BUFFER, _anomalyBuffer);
+    glBufferData(GL_ARRAY_BUFFER, n * sizeof(float), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, n * sizeof(float), _eccentricAnomalies.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void RenderableSatellites::render(const RenderData& data, RendererTasks&) {
+    if (_catalog.size() == 0) {
+        return;
+    }
+
+    // Fragile! Keep in sync with the shaders
+    enum RenderPhase {
+        RenderPhaseLines = 0,
+        RenderPhasePoints
+    };
+
+    _programObject->activate();
+
+    glm::dmat4 modelTransform =
+        glm::translate(glm::dmat4(1.0), data.modelTransform.translation) *
+        glm::dmat4(data.modelTransform.rotation) *
+        glm::scale(glm::dmat4(1.0), glm::dvec3(data.modelTransform.scale));
+
+    // The model view transformation is passed as double as the orbits can be far away
+    // from the camera
+    _programObject->setUniform(
+        _uniformCache.modelView,
+        data.camera.combinedViewMatrix() * modelTransform
+    );
+    _programObject->setUniform(_uniformCache.projection, data.camera.projectionMatrix());
+    _programObject->setUniform(_uniformCache.color, _color);
+    _programObject->setUniform(_uniformCache.opacity, _opacity);
+
+    const bool usingFramebufferRenderer =
+        global::renderEngine.rendererImplementation() ==
+        RenderEngine::RendererImplementation::Framebuffer;
+
+    if (usingFramebufferRenderer) {
+        glDepthMask(false);
+    }
+
+    const GLsizei nObjects = static_cast<GLsizei>(_catalog.size());
+    glBindVertexArray(_vao);
+
+    if (_trailLength > 0.f) {
+        const int nSegments = _trailSegments;
+        _programObject->setUniform(_uniformCache.renderPhase, RenderPhaseLines);
+        _programObject->setUniform(_uniformCache.nSegments, nSegments);
+        _programObject->setUniform(
+            _uniformCache.trailStep,
+            glm::two_pi<float>() * _trailLength / static_cast<float>(nSegments)
+        );
+        glLineWidth(_lineWidth);
+        glDrawArraysInstanced(GL_LINE_STRIP, 0, nSegments + 1, nObjects);
+    }
+
+    _programObject->setUniform(_uniformCache.renderPhase, RenderPhasePoints);
+    _programObject->setUniform(_uniformCache.pointSize, _pointSize);
+    glEnable(GL_PROGRAM_POINT_SIZE);
+    glDrawArraysInstanced(GL_POINTS, 0, 1, nObjects);
+    glDisable(GL_PROGRAM_POINT_SIZE);
+
+    glBindVertexArray(0);
+
+    if (usingFramebufferRenderer) {
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glDepthMask(true);
+    }
+
+    _programObject->deactivate();
+}
+
+} // namespace openspace
@@ -0,0 +1,103 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_MODULE_SPACE___RENDERABLESATELLITES___H__
+#define __OPENSPACE_MODULE_SPACE___RENDERABLESATELLITES___H__
+
+#include <openspace/rendering/renderable.h>
+
+#include <modules/space/util/keplercatalog.h>
+#include <openspace/properties/scalar/floatproperty.h>
+#include <openspace/properties/scalar/intproperty.h>
+#include <openspace/properties/vector/vec3property.h>
+#include <ghoul/opengl/ghoul_gl.h>
+#include <ghoul/opengl/uniformcache.h>
+#include <memory>
+
+namespace ghoul::opengl { class ProgramObject; }
+
+namespace openspace {
+
+namespace documentation { struct Documentation; }
+
+/**
+ * This Renderable shows all objects of a catalog of Keplerian elements, for example a
+ * file of two-line element sets for satellites, as points with optional trails. Instead
+ * of one SceneGraphNode with a KeplerTranslation and a RenderableTrail per object, all
+ * objects are propagated together each frame by solving Kepler's equation for their
+ * eccentric anomalies on a thread pool. Only the eccentric anomalies are uploaded to the
+ * GPU, where the vertex shader computes the positions from the axes of each orbit, and
+ * all objects are drawn with a single instanced draw call. The trail of an object is
+ * the \c TrailLength fraction of its orbit behind it, measured in eccentric anomaly so
+ * that the shader can compute it from the current eccentric anomaly alone.
+ */
+class RenderableSatellites : public Renderable {
+public:
+    RenderableSatellites(const ghoul::Dictionary& dictionary);
+    ~RenderableSatellites();
+
+    void initialize() override;
+    void initializeGL() override;
+    void deinitializeGL() override;
+
+    bool isReady() const override;
+
+    void render(const RenderData& data, RendererTasks& rendererTask) override;
+    void update(const UpdateData& data) override;
+
+    static documentation::Documentation Documentation();
+
+private:
+    /// Creates the VBO with the per-object data that does not change over time
+    void uploadOrbits();
+
+    std::string _path;
+    bool _isTleFile = true;
+
+    properties::Vec3Property _color;
+    properties::FloatProperty _pointSize;
+    properties::FloatProperty _lineWidth;
+    properties::FloatProperty _trailLength;
+    properties::IntProperty _trailSegments;
+
+    KeplerCatalog _catalog;
+    /// The eccentric anomalies of all objects at the current time
+    std::vector<float> _eccentricAnomalies;
+
+    GLuint _vao = 0;
+    /// Contains the axes and eccentricity of each orbit
+    GLuint _orbitBuffer = 0;
+    /// Contains the eccentric anomaly of each object, updated every frame
+    GLuint _anomalyBuffer = 0;
+
+    ghoul::opengl::ProgramObject* _programObject = nullptr;
+
+    UniformCache(modelView, projection, color, opacity, pointSize, trailStep, nSegments,
+        renderPhase) _uniformCache;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_SPACE___RENDERABLESATELLITES___H__
@@ -29,18 +29,24 @@
 #include <openspace/util/updatestructures.h>
 #include <openspace/engine/globals.h>
 #include <openspace/rendering/renderengine.h>
+#include <openspace/util/pointcatalogcache.h>
+#include <openspace/util/speckfile.h>
+#include <openspace/util/workstealingthreadpool.h>
 #include <ghoul/filesystem/cachemanager.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
 #include <ghoul/misc/templatefactory.h>
 #include <ghoul/io/texture/texturereader.h>
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/opengl/texture.h>
 #include <ghoul/opengl/textureunit.h>
+#include <algorithm>
 #include <array>
+#include <cstddef>
 #include <cstdint>
-#include <fstream>
-
+#include <cstring>
+#include <limits>
 #include <type_traits>
 
 namespace {
@@ -56,7 +62,28 @@ namespace {
         "otherDataTexture", "otherDataRange", "filterOutOfRange"
     };
 
-    constexpr int8_t CurrentCacheVersion = 2;
+    constexpr uint32_t CurrentCacheVersion = 3;
+
+    // The data slices are split across the threads of the pool if there are at least
+    // this many stars for each block
+    constexpr const size_t MinimumStarsPerBlock = 32 * 1024;
+
+    // Calls func(begin, end) for contiguous blocks of the range [0, nStars) on the
+    // threads of the shared pool
+    template <typename Func>
+    void forEachBlock(size_t nStars, Func func) {
+        openspace::WorkStealingThreadPool& pool = openspace::global::threadPool;
+        const size_t nBlocks = std::min(
+            nStars / MinimumStarsPerBlock,
+            pool.numThreads() + 1
+        );
+        if (nBlocks <= 1) {
+            func(size_t(0), nStars);
+        }
+        else {
+            pool.parallelFor(nStars, nBlocks, func);
+        }
+    }
 
     struct ColorVBOLayout {
         std::array<float, 4> position; // (x,y,z,e)
@@ -404,15 +431,7 @@ bool RenderableStars::isReady() const {
     return _program != nullptr;
 }
 
-void RenderableStars::initializeGL() {
-    _program = global::renderEngine.buildRenderProgram("Star",
-        absPath("${MODULE_SPACE}/shaders/star_vs.glsl"),
-        absPath("${MODULE_SPACE}/shaders/star_fs.glsl"),
-        absPath("${MODULE_SPACE}/shaders/star_ge.glsl")
-    );
-
-    ghoul::opengl::updateUniformLocations(*_program, _uniformCache, UniformNames);
-
+void RenderableStars::initialize() {
     loadData();
 
     if (!_queuedOtherData.empty()) {
@@ -428,6 +447,16 @@ void RenderableStars::initializeGL() {
     _speckFileIsDirty = false;
 }
 
+void RenderableStars::initializeGL() {
+    _program = global::renderEngine.buildRenderProgram("Star",
+        absPath("${MODULE_SPACE}/shaders/star_vs.glsl"),
+        absPath("${MODULE_SPACE}/shaders/star_fs.glsl"),
+        absPath("${MODULE_SPACE}/shaders/star_ge.glsl")
+    );
+
+    ghoul::opengl::updateUniformLocations(*_program, _uniformCache, UniformNames);
+}
+
 void RenderableStars::deinitializeGL() {
     glDeleteBuffers(1, &_vbo);
     _vbo = 0;
@@ -444,7 +473,7 @@ void RenderableStars::deinitializeGL() {
 }
 
 void RenderableStars::render(const RenderData& data, RendererTasks&) {
-    if (_fullData.empty()) {
+    if (_catalog.nRows() == 0) {
         return;
     }
 
@@ -498,7 +527,7 @@ void RenderableStars::render(const RenderData& data, RendererTasks&) {
     _program->setUniform(_uniformCache.filterOutOfRange, _filterOutOfRange);
 
     glBindVertexArray(_vao);
-    const GLsizei nStars = static_cast<GLsizei>(_fullData.size() / _nValuesPerStar);
+    const GLsizei nStars = static_cast<GLsizei>(_catalog.nRows());
     glDrawArrays(GL_POINTS, 0, nStars);
 
     glBindVertexArray(0);
@@ -514,7 +543,7 @@ void RenderableStars::update(const UpdateData&) {
         _dataIsDirty = true;
     }
 
-    if (_fullData.empty()) {
+    if (_catalog.nRows() == 0) {
         return;
     }
 
@@ -544,7 +573,7 @@ void RenderableStars::update(const UpdateData&) {
         GLint positionAttrib = _program->attributeLocation("in_position");
         GLint brightnessDataAttrib = _program->attributeLocation("in_brightness");
 
-        const size_t nStars = _fullData.size() / _nValuesPerStar;
+        const size_t nStars = _catalog.nRows();
         const size_t nValues = _slicedData.size() / nStars;
 
         GLsizei stride = static_cast<GLsizei>(sizeof(GLfloat) * nValues);
@@ -753,9 +782,9 @@ void RenderableStars::loadData() {
         ghoul::filesystem::CacheManager::Persistent::Yes
     );
 
-    _nValuesPerStar = 0;
+    // Release the mapping first, as the cache file might be replaced below
+    _catalog = PointCatalogCache();
     _slicedData.clear();
-    _fullData.clear();
     _dataNames.clear();
 
     bool hasCachedFile = FileSys.fileExists(cachedFile);
@@ -765,310 +794,178 @@ void RenderableStars::loadData() {
             cachedFile, _file
         ));
 
-        bool success = loadCachedFile(cachedFile);
-        if (success) {
-            return;
+        try {
+            _catalog = PointCatalogCache::load(cachedFile, CurrentCacheVersion);
         }
-        else {
+        catch (const ghoul::RuntimeError& e) {
+            LINFO(fmt::format("Deleting old cache: {}", e.message));
             FileSys.cacheManager()->removeCacheFile(_file);
-            // Intentional fall-through to the 'else' computation to generate the cache
+            // Intentional fall-through to the computation below to generate the cache
             // file for the next run
+            hasCachedFile = false;
         }
     }
     else {
         LINFO(fmt::format("Cache for Speck file '{}' not found", _file));
     }
-    LINFO(fmt::format("Loading Speck file '{}'", _file));
-
-    readSpeckFile();
-
-    LINFO("Saving cache");
-    saveCachedFile(cachedFile);
-}
-
-void RenderableStars::readSpeckFile() {
-    std::string _file = _speckFile;
-    std::ifstream file(_file);
-    if (!file.good()) {
-        LERROR(fmt::format("Failed to open Speck file '{}'", _file));
-        return;
-    }
 
-    // The beginning of the speck file has a header that either contains comments
-    // (signaled by a preceding '#') or information about the structure of the file
-    // (signaled by the keywords 'datavar', 'texturevar', and 'texture')
-    std::string line;
-    while (true) {
-        std::streampos position = file.tellg();
-        std::getline(file, line);
-
-        if (line[0] == '#' || line.empty()) {
-            continue;
-        }
+    if (!hasCachedFile) {
+        LINFO(fmt::format("Loading Speck file '{}'", _file));
+        readSpeckFile();
 
-        if (line.substr(0, 7) != "datavar" &&
-            line.substr(0, 10) != "texturevar" &&
-            line.substr(0, 7) != "texture")
-        {
-            // we read a line that doesn't belong to the header, so we have to jump back
-            // before the beginning of the current line
-            file.seekg(position);
-            break;
+        if (_catalog.nRows() > 0) {
+            LINFO("Saving cache");
+            try {
+                _catalog.save(cachedFile);
+                // Continue with the mapped cache so that the parsed values do not have
+                // to be kept on the heap
+                _catalog = PointCatalogCache::load(cachedFile, CurrentCacheVersion);
+            }
+            catch (const ghoul::RuntimeError& e) {
+                LERROR(fmt::format("Error writing cache: {}", e.message));
+            }
         }
-
-        if (line.substr(0, 7) == "datavar") {
-            // datavar lines are structured as follows:
-            // datavar # description
-            // where # is the index of the data variable; so if we repeatedly overwrite
-            // the 'nValues' variable with the latest index, we will end up with the total
-            // number of values (+3 since X Y Z are not counted in the Speck file index)
-            std::stringstream str(line);
-
-            std::string dummy;
-            str >> dummy;
-            str >> _nValuesPerStar;
-
-            std::string name;
-            str >> name;
-
-            _dataNames.push_back(name);
-            _nValuesPerStar += 1; // We want the number, but the index is 0 based
+        else {
+            LERROR("Error writing cache: No values were loaded");
         }
     }
 
+    // The first three columns are the position of the star
+    for (int i = 3; i < _catalog.nColumns(); ++i) {
+        _dataNames.emplace_back(_catalog.column(i).name);
+    }
     _otherDataOption.clearOptions();
     _otherDataOption.addOptions(_dataNames);
-
-    _nValuesPerStar += 3; // X Y Z are not counted in the Speck file indices
-
-    do {
-        std::vector<float> values(_nValuesPerStar);
-
-        std::getline(file, line);
-        std::stringstream str(line);
-
-        for (int i = 0; i < _nValuesPerStar; ++i) {
-            str >> values[i];
-        }
-        bool nullArray = true;
-        for (float v : values) {
-            if (v != 0.0) {
-                nullArray = false;
-                break;
-            }
-        }
-        if (!nullArray) {
-            _fullData.insert(_fullData.end(), values.begin(), values.end());
-        }
-    } while (!file.eof());
-}
-
-bool RenderableStars::loadCachedFile(const std::string& file) {
-    std::ifstream fileStream(file, std::ifstream::binary);
-    if (fileStream.good()) {
-        int8_t version = 0;
-        fileStream.read(reinterpret_cast<char*>(&version), sizeof(int8_t));
-        if (version != CurrentCacheVersion) {
-            LINFO("The format of the cached file has changed: deleting old cache");
-            fileStream.close();
-            FileSys.deleteFile(file);
-            return false;
-        }
-
-        int32_t nValues = 0;
-        fileStream.read(reinterpret_cast<char*>(&nValues), sizeof(int32_t));
-        fileStream.read(reinterpret_cast<char*>(&_nValuesPerStar), sizeof(int32_t));
-
-        for (int i = 0; i < _nValuesPerStar - 3; ++i) {
-            uint16_t len;
-            fileStream.read(reinterpret_cast<char*>(&len), sizeof(uint16_t));
-            std::vector<char> buffer(len);
-            fileStream.read(buffer.data(), len);
-            std::string value(buffer.begin(), buffer.end());
-            _dataNames.push_back(value);
-        }
-        _otherDataOption.addOptions(_dataNames);
-
-        _fullData.resize(nValues);
-        fileStream.read(reinterpret_cast<char*>(&_fullData[0]),
-            nValues * sizeof(_fullData[0]));
-
-        bool success = fileStream.good();
-        return success;
-    }
-    else {
-        LERROR(fmt::format("Error opening file '{}' for loading cache file", file));
-        return false;
-    }
 }
 
-void RenderableStars::saveCachedFile(const std::string& file) const {
-    std::ofstream fileStream(file, std::ofstream::binary);
-    if (!fileStream.good()) {
-        LERROR(fmt::format("Error opening file '{}' for save cache file", file));
-        return;
-    }
-
-    fileStream.write(reinterpret_cast<const char*>(&CurrentCacheVersion), sizeof(int8_t));
+void RenderableStars::readSpeckFile() {
+    const std::string speckFile = _speckFile;
+    try {
+        SpeckFile file(speckFile);
 
-    int32_t nValues = static_cast<int32_t>(_fullData.size());
-    if (nValues == 0) {
-        throw ghoul::RuntimeError("Error writing cache: No values were loaded");
+        std::vector<float> rows;
+        file.readRows(rows, file.nValuesPerRow(), true);
+        _catalog = PointCatalogCache(rows, file.columnNames(), CurrentCacheVersion);
     }
-    fileStream.write(reinterpret_cast<const char*>(&nValues), sizeof(int32_t));
-
-    int32_t nValuesPerStar = static_cast<int32_t>(_nValuesPerStar);
-    fileStream.write(reinterpret_cast<const char*>(&nValuesPerStar), sizeof(int32_t));
-
-    // -3 as we don't want to save the xyz values that are in the beginning of the file
-    for (int i = 0; i < _nValuesPerStar - 3; ++i) {
-        uint16_t len = _dataNames[i].size();
-        fileStream.write(reinterpret_cast<const char*>(&len), sizeof(uint16_t));
-        fileStream.write(_dataNames[i].c_str(), len);
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(fmt::format("Failed to open Speck file '{}': {}", speckFile, e.message));
     }
-
-    size_t nBytes = nValues * sizeof(_fullData[0]);
-    fileStream.write(reinterpret_cast<const char*>(_fullData.data()), nBytes);
 }
 
 void RenderableStars::createDataSlice(ColorOption option) {
-    _slicedData.clear();
-
-    // This is only temporary until the scalegraph is in place ---abock
-    float minDistance = std::numeric_limits<float>::max();
-    float maxDistance = -std::numeric_limits<float>::max();
-
-    for (size_t i = 0; i < _fullData.size(); i += _nValuesPerStar) {
-        float distLy = _fullData[i + 6];
-        //if (distLy < 20.f) {
-        minDistance = std::min(minDistance, distLy);
-        maxDistance = std::max(maxDistance, distLy);
-        //}
-    }
-
-    _otherDataRange = glm::vec2(
-        std::numeric_limits<float>::max(),
-        -std::numeric_limits<float>::max()
-    );
-
-    for (size_t i = 0; i < _fullData.size(); i += _nValuesPerStar) {
-        glm::vec3 p = glm::vec3(_fullData[i + 0], _fullData[i + 1], _fullData[i + 2]);
-
+    const size_t nStars = _catalog.nRows();
+    const float* xs = _catalog.columnData(0);
+    const float* ys = _catalog.columnData(1);
+    const float* zs = _catalog.columnData(2);
+    auto position = [&](size_t i) -> std::array<float, 4> {
         // Convert parsecs -> meter
-        psc position = psc(glm::vec4(p * 0.308567756f, 17));
+        return {
+            xs[i] * 0.308567756f,
+            ys[i] * 0.308567756f,
+            zs[i] * 0.308567756f,
+            17.f
+        };
+    };
 
-        switch (option) {
-            case ColorOption::Color:
-            {
-                union {
-                    ColorVBOLayout value;
-                    std::array<float, sizeof(ColorVBOLayout)> data;
-                } layout = {};
+    // Every star is written directly into its final location in the presized buffer,
+    // which lets the blocks of stars be processed independently
+    auto slice = [&](auto layoutType, auto fillLayout) {
+        using Layout = decltype(layoutType);
+        constexpr const size_t nValues = sizeof(Layout) / sizeof(float);
+        _slicedData.resize(nStars * nValues);
+        forEachBlock(nStars, [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                Layout layout = {};
+                layout.position = position(i);
+                fillLayout(layout, i);
+                std::memcpy(&_slicedData[i * nValues], &layout, sizeof(Layout));
+            }
+        });
+    };
 
-                layout.value.position = { {
-                        position[0], position[1], position[2], position[3]
-                    } };
+    // These columns are common to all layouts
+    const float* values = _catalog.columnData(3);
+    const float* luminances = _catalog.columnData(4);
+    const float* absoluteMagnitudes = _catalog.columnData(5);
 
+    switch (option) {
+        case ColorOption::Color:
+            slice(ColorVBOLayout(), [&](ColorVBOLayout& layout, size_t i) {
 #ifdef USING_STELLAR_TEST_GRID
-                layout.value.value = _fullData[i + 3];
-                layout.value.luminance = _fullData[i + 3];
-                layout.value.absoluteMagnitude = _fullData[i + 3];
+                layout.value = values[i];
+                layout.luminance = values[i];
+                layout.absoluteMagnitude = values[i];
 #else
-                layout.value.value = _fullData[i + 3];
-                layout.value.luminance = _fullData[i + 4];
-                layout.value.absoluteMagnitude = _fullData[i + 5];
+                layout.value = values[i];
+                layout.luminance = luminances[i];
+                layout.absoluteMagnitude = absoluteMagnitudes[i];
 #endif
+            });
+            break;
+        case ColorOption::Velocity:
+        {
+            const float* vxs = _catalog.columnData(12);
+            const float* vys = _catalog.columnData(13);
+            const float* vzs = _catalog.columnData(14);
+            slice(VelocityVBOLayout(), [&](VelocityVBOLayout& layout, size_t i) {
+                layout.value = values[i];
+                layout.luminance = luminances[i];
+                layout.absoluteMagnitude = absoluteMagnitudes[i];
+
+                layout.vx = vxs[i];
+                layout.vy = vys[i];
+                layout.vz = vzs[i];
+            });
+            break;
+        }
+        case ColorOption::Speed:
+        {
+            const float* speeds = _catalog.columnData(15);
+            slice(SpeedVBOLayout(), [&](SpeedVBOLayout& layout, size_t i) {
+                layout.value = values[i];
+                layout.luminance = luminances[i];
+                layout.absoluteMagnitude = absoluteMagnitudes[i];
+
+                layout.speed = speeds[i];
+            });
+            break;
+        }
+        case ColorOption::OtherData:
+        {
+            const float* otherData = _catalog.columnData(_otherDataOption.value() + 3);
+            const bool hasFilter = _staticFilterValue.has_value();
+            const float filterValue = _staticFilterValue.value_or(0.f);
+            const float replacement = _staticFilterReplacementValue;
+            slice(OtherDataLayout(), [&](OtherDataLayout& layout, size_t i) {
+                layout.value = otherData[i];
+                if (hasFilter && layout.value == filterValue) {
+                    layout.value = replacement;
+                }
 
-                _slicedData.insert(_slicedData.end(),
-                    layout.data.begin(),
-                    layout.data.end());
-
-                break;
-            }
-            case ColorOption::Velocity:
-            {
-                union {
-                    VelocityVBOLayout value;
-                    std::array<float, sizeof(VelocityVBOLayout)> data;
-                } layout = {};
-
-                layout.value.position = { {
-                        position[0], position[1], position[2], position[3]
-                    } };
-
-                layout.value.value = _fullData[i + 3];
-                layout.value.luminance = _fullData[i + 4];
-                layout.value.absoluteMagnitude = _fullData[i + 5];
-
-                layout.value.vx = _fullData[i + 12];
-                layout.value.vy = _fullData[i + 13];
-                layout.value.vz = _fullData[i + 14];
-
-                _slicedData.insert(_slicedData.end(),
-                    layout.data.begin(),
-                    layout.data.end());
-                break;
-            }
-            case ColorOption::Speed:
-            {
-                union {
-                    SpeedVBOLayout value;
-                    std::array<float, sizeof(SpeedVBOLayout)> data;
-                } layout = {};
-
-                layout.value.position = { {
-                        position[0], position[1], position[2], position[3]
-                    } };
-
-                layout.value.value = _fullData[i + 3];
-                layout.value.luminance = _fullData[i + 4];
-                layout.value.absoluteMagnitude = _fullData[i + 5];
-
-                layout.value.speed = _fullData[i + 15];
+                layout.luminance = luminances[i];
+                layout.absoluteMagnitude = absoluteMagnitudes[i];
+            });
 
-                _slicedData.insert(_slicedData.end(),
-                    layout.data.begin(),
-                    layout.data.end());
-                break;
+            // The range is computed from the values that were written, as the static
+            // filter might have replaced some of them
+            glm::vec2 range = glm::vec2(
+                std::numeric_limits<float>::max(),
+                -std::numeric_limits<float>::max()
+            );
+            constexpr const size_t nValues = sizeof(OtherDataLayout) / sizeof(float);
+            constexpr const size_t valueOffset = offsetof(OtherDataLayout, value) /
+                                                 sizeof(float);
+            for (size_t i = 0; i < nStars; ++i) {
+                const float value = _slicedData[i * nValues + valueOffset];
+                range.x = std::min(range.x, value);
+                range.y = std::max(range.y, value);
             }
-            case ColorOption::OtherData:
-            {
-                union {
-                    OtherDataLayout value;
-                    std::array<float, sizeof(OtherDataLayout)> data;
-                } layout = {};
-
-                layout.value.position = {
-                    { position[0], position[1], position[2], position[3] }
-                };
-
-                int index = _otherDataOption.value();
-                layout.value.value = _fullData[i + index + 3];
-
-                if (_staticFilterValue.has_value() &&
-                    layout.value.value == _staticFilterValue)
-                {
-                    layout.value.value = _staticFilterReplacementValue;
-                }
-
-                glm::vec2 range = _otherDataRange.value();
-                range.x = std::min(range.x, layout.value.value);
-                range.y = std::max(range.y, layout.value.value);
-                _otherDataRange = range;
+            _otherDataRange = range;
+            if (nStars > 0) {
                 _otherDataRange.setMinValue(glm::vec2(range.x));
                 _otherDataRange.setMaxValue(glm::vec2(range.y));
-
-                layout.value.luminance = _fullData[i + 4];
-                layout.value.absoluteMagnitude = _fullData[i + 5];
-
-                _slicedData.insert(
-                    _slicedData.end(),
-                    layout.data.begin(),
-                    layout.data.end()
-                );
-
-                break;
             }
+            break;
         }
     }
 }
@@ -31,6 +31,7 @@
 #include <openspace/properties/optionproperty.h>
 #include <openspace/properties/scalar/floatproperty.h>
 #include <openspace/properties/vector/vec2property.h>
+#include <openspace/util/pointcatalogcache.h>
 #include <ghoul/opengl/ghoul_gl.h>
 #include <ghoul/opengl/uniformcache.h>
 #include <optional>
@@ -50,6 +51,7 @@ public:
     explicit RenderableStars(const ghoul::Dictionary& dictionary);
     ~RenderableStars();
 
+    void initialize() override;
     void initializeGL() override;
     void deinitializeGL() override;
 
@@ -72,8 +74,6 @@ private:
 
     void loadData();
     void readSpeckFile();
-    bool loadCachedFile(const std::string& file);
-    void saveCachedFile(const std::string& file) const;
 
     properties::StringProperty _speckFile;
 
@@ -107,8 +107,7 @@ private:
     bool _otherDataColorMapIsDirty = true;
 
     std::vector<float> _slicedData;
-    std::vector<float> _fullData;
-    int _nValuesPerStar = 0;
+    PointCatalogCache _catalog;
     std::string _queuedOtherData;
     std::vector<std::string> _dataNames;
 
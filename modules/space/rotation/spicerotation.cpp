@@ -116,16 +116,32 @@ SpiceRotation::SpiceRotation(const ghoul::Dictionary& dictionary)
     addProperty(_sourceFrame);
     addProperty(_destinationFrame);
 
-    _sourceFrame.onChange([this]() { requireUpdate(); });
-    _destinationFrame.onChange([this]() { requireUpdate(); });
+    _sourceFrame.onChange([this]() {
+        _cache = nullptr;
+        requireUpdate();
+    });
+    _destinationFrame.onChange([this]() {
+        _cache = nullptr;
+        requireUpdate();
+    });
 }
 
 glm::dmat3 SpiceRotation::matrix(const UpdateData& data) const {
-    return SpiceManager::ref().positionTransformMatrix(
-        _sourceFrame,
-        _destinationFrame,
-        data.time.j2000Seconds()
-    );
+    if (!_cache) {
+        _cache = &SpiceManager::ref().positionTransformMatrixCache(
+            _sourceFrame,
+            _destinationFrame
+        );
+    }
+
+    glm::dmat3 matrix;
+    _cache->evaluate(data.time.j2000Seconds(), glm::value_ptr(matrix));
+    return matrix;
+}
+
+bool SpiceRotation::isThreadSafe() const {
+    // The cache is lock-free and the SpiceManager serializes all calls into SPICE
+    return true;
 }
 
 } // namespace openspace
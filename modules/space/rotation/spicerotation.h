@@ -33,18 +33,24 @@ namespace openspace {
 
 namespace documentation { struct Documentation; }
 
+class EphemerisCache;
+
 class SpiceRotation : public Rotation {
 public:
     SpiceRotation(const ghoul::Dictionary& dictionary);
 
     const glm::dmat3& matrix() const;
     glm::dmat3 matrix(const UpdateData& data) const override;
+    bool isThreadSafe() const override;
 
     static documentation::Documentation Documentation();
 
 private:
     properties::StringProperty _sourceFrame;
     properties::StringProperty _destinationFrame;
+
+    /// The cache shared by all rotations with the same frames, reset when they change
+    mutable EphemerisCache* _cache = nullptr;
 };
 
 } // namespace openspace
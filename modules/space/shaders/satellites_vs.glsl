@@ -0,0 +1,72 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#version __CONTEXT__
+
+#include "PowerScaling/powerScaling_vs.hglsl"
+
+layout(location = 0) in vec3 in_majorAxis;
+layout(location = 1) in vec3 in_minorAxis;
+layout(location = 2) in float in_eccentricity;
+layout(location = 3) in float in_eccentricAnomaly;
+
+out vec4 vs_positionScreenSpace;
+out vec4 vs_gPosition;
+out float fade;
+
+uniform dmat4 modelViewTransform;
+uniform mat4 projectionTransform;
+uniform float pointSize;
+uniform float trailStep;
+uniform int nSegments;
+uniform int renderPhase;
+
+// Fragile! Keep in sync with RenderableSatellites::render
+#define RenderPhaseLines 0
+#define RenderPhasePoints 1
+
+
+void main() {
+    // The vertices of a trail walk backwards along the orbit from the current position
+    float eccentricAnomaly = in_eccentricAnomaly;
+    if (renderPhase == RenderPhaseLines) {
+        eccentricAnomaly -= float(gl_VertexID) * trailStep;
+        fade = 1.0 - float(gl_VertexID) / float(nSegments);
+    }
+    else {
+        fade = 1.0;
+    }
+
+    // The majorAxis points from the center of the ellipse to the periapsis, so the focus
+    // that contains the orbited body is offset by the eccentricity
+    vec3 position = in_majorAxis * (cos(eccentricAnomaly) - in_eccentricity) +
+                    in_minorAxis * sin(eccentricAnomaly);
+
+    vs_gPosition = vec4(modelViewTransform * dvec4(position, 1.0));
+    vs_positionScreenSpace = z_normalization(projectionTransform * vs_gPosition);
+
+    gl_PointSize = pointSize;
+    gl_Position = vs_positionScreenSpace;
+}
@@ -27,6 +27,7 @@
 #include <modules/space/rendering/renderableconstellationbounds.h>
 #include <modules/space/rendering/renderableplanet.h>
 #include <modules/space/rendering/renderablerings.h>
+#include <modules/space/rendering/renderablesatellites.h>
 #include <modules/space/rendering/renderablestars.h>
 #include <modules/space/rendering/simplespheregeometry.h>
 #include <modules/space/translation/keplertranslation.h>
@@ -79,6 +80,7 @@ void SpaceModule::internalInitialize(const ghoul::Dictionary&) {
     );
     fRenderable->registerClass<RenderablePlanet>("RenderablePlanet");
     fRenderable->registerClass<RenderableRings>("RenderableRings");
+    fRenderable->registerClass<RenderableSatellites>("RenderableSatellites");
     fRenderable->registerClass<RenderableStars>("RenderableStars");
 
     auto fTranslation = FactoryManager::ref().factory<Translation>();
@@ -108,6 +110,7 @@ std::vector<documentation::Documentation> SpaceModule::documentations() const {
         RenderableConstellationBounds::Documentation(),
         RenderablePlanet::Documentation(),
         RenderableRings::Documentation(),
+        RenderableSatellites::Documentation(),
         RenderableStars::Documentation(),
         SpiceRotation::Documentation(),
         SpiceTranslation::Documentation(),
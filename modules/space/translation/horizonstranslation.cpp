@@ -107,24 +107,29 @@ HorizonsTranslation::HorizonsTranslation(const ghoul::Dictionary& dictionary)
 glm::dvec3 HorizonsTranslation::position(const UpdateData& data) const {
     glm::dvec3 interpolatedPos = glm::dvec3(0.0);
 
-    auto lastBefore = _timeline.lastKeyframeBefore(data.time.j2000Seconds(), true);
-    auto firstAfter = _timeline.firstKeyframeAfter(data.time.j2000Seconds(), false);
-    if (lastBefore && firstAfter) {
+    constexpr const size_t NoKeyframe = FlatTimeline<glm::dvec3>::NoKeyframe;
+    const double now = data.time.j2000Seconds();
+
+    // Both queries start from the cursor, so the second one is answered immediately
+    const size_t lastBefore = _timeline.lastKeyframeBefore(now, _cursor, true);
+    const size_t firstAfter = _timeline.firstKeyframeAfter(now, _cursor, false);
+    if (lastBefore != NoKeyframe && firstAfter != NoKeyframe) {
         // We're inbetween first and last value.
-        double timelineDiff = firstAfter->timestamp - lastBefore->timestamp;
-        double timeDiff = data.time.j2000Seconds() - lastBefore->timestamp;
+        double timelineDiff = _timeline.timestamp(firstAfter) -
+                              _timeline.timestamp(lastBefore);
+        double timeDiff = now - _timeline.timestamp(lastBefore);
         double diff = (timelineDiff > DBL_EPSILON) ? timeDiff / timelineDiff : 0.0;
 
-        glm::dvec3 dir = firstAfter->data - lastBefore->data;
-        interpolatedPos = lastBefore->data + dir * diff;
+        glm::dvec3 dir = _timeline.data(firstAfter) - _timeline.data(lastBefore);
+        interpolatedPos = _timeline.data(lastBefore) + dir * diff;
     }
-    else if (lastBefore) {
+    else if (lastBefore != NoKeyframe) {
         // Requesting a time after last value. Return last known position.
-        interpolatedPos = lastBefore->data;
+        interpolatedPos = _timeline.data(lastBefore);
     }
-    else if (firstAfter) {
+    else if (firstAfter != NoKeyframe) {
         // Requesting a time before first value. Return last known position.
-        interpolatedPos = firstAfter->data;
+        interpolatedPos = _timeline.data(firstAfter);
     }
 
     return interpolatedPos;
@@ -28,7 +28,7 @@
 #include <openspace/scene/translation.h>
 
 #include <openspace/properties/stringproperty.h>
-#include <openspace/util/timeline.h>
+#include <openspace/util/flattimeline.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/lua/luastate.h>
 #include <memory>
@@ -64,7 +64,9 @@ private:
     properties::StringProperty _horizonsTextFile;
     std::unique_ptr<ghoul::filesystem::File> _fileHandle;
     ghoul::lua::LuaState _state;
-    Timeline<glm::dvec3> _timeline;
+    FlatTimeline<glm::dvec3> _timeline;
+    /// The position of the last query, as the time usually changes only slightly
+    mutable FlatTimeline<glm::dvec3>::Cursor _cursor;
 };
 
 } // namespace openspace
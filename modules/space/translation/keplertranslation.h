@@ -67,6 +67,7 @@ public:
     * \param time The time to use when doing the position lookup
     */
     glm::dvec3 position(const UpdateData& data) const override;
+    bool isThreadSafe() const override;
 
     /**
      * Method returning the openspace::Documentation that describes the ghoul::Dictinoary
@@ -157,6 +157,7 @@ SpiceTranslation::SpiceTranslation(const ghoul::Dictionary& dictionary)
     }
 
     auto update = [this](){
+        _cache = nullptr;
         requireUpdate();
         notifyObservers();
     };
@@ -172,15 +173,18 @@ SpiceTranslation::SpiceTranslation(const ghoul::Dictionary& dictionary)
 }
 
 glm::dvec3 SpiceTranslation::position(const UpdateData& data) const {
-    double lightTime = 0.0;
-    return SpiceManager::ref().targetPosition(
-        _target,
-        _observer,
-        _frame,
-        {},
-        data.time.j2000Seconds(),
-        lightTime
-    ) * glm::pow(10.0, 3.0);
+    if (!_cache) {
+        _cache = &SpiceManager::ref().targetPositionCache(_target, _observer, _frame, {});
+    }
+
+    glm::dvec3 position;
+    _cache->evaluate(data.time.j2000Seconds(), glm::value_ptr(position));
+    return position * glm::pow(10.0, 3.0);
+}
+
+bool SpiceTranslation::isThreadSafe() const {
+    // The cache is lock-free and the SpiceManager serializes all calls into SPICE
+    return true;
 }
 
 } // namespace openspace
@@ -31,11 +31,14 @@
 
 namespace openspace {
 
+class EphemerisCache;
+
 class SpiceTranslation : public Translation {
 public:
     SpiceTranslation(const ghoul::Dictionary& dictionary);
 
     glm::dvec3 position(const UpdateData& data) const override;
+    bool isThreadSafe() const override;
 
     static documentation::Documentation Documentation();
 
@@ -44,7 +47,9 @@ private:
     properties::StringProperty _observer;
     properties::StringProperty _frame;
 
-    glm::dvec3 _position;
+    /// The cache shared by all translations with the same parameters, reset when they
+    /// change
+    mutable EphemerisCache* _cache = nullptr;
 };
 
 } // namespace openspace
@@ -0,0 +1,433 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <modules/space/util/keplercatalog.h>
+
+#include <modules/space/util/keplersolver.h>
+#include <ghoul/fmt.h>
+#include <ghoul/misc/exception.h>
+#include <glm/gtx/transform.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace {
+    // The list of leap years only goes until 2056 as we need to touch this file then
+    // again anyway ;)
+    const std::vector<int> LeapYears = {
+        1956, 1960, 1964, 1968, 1972, 1976, 1980, 1984, 1988, 1992, 1996,
+        2000, 2004, 2008, 2012, 2016, 2020, 2024, 2028, 2032, 2036, 2040,
+        2044, 2048, 2052, 2056
+    };
+
+    // Count the number of full days since the beginning of 2000 to the beginning of
+    // the parameter 'year'
+    int countDays(int year) {
+        // Find the position of the current year in the vector, the difference
+        // between its position and the position of 2000 (for J2000) gives the
+        // number of leap years
+        constexpr const int Epoch = 2000;
+        constexpr const int DaysRegularYear = 365;
+        constexpr const int DaysLeapYear = 366;
+
+        if (year == Epoch) {
+            return 0;
+        }
+
+        // Get the position of the most recent leap year
+        const auto lb = std::lower_bound(LeapYears.begin(), LeapYears.end(), year);
+
+        // Get the position of the epoch
+        const auto y2000 = std::find(LeapYears.begin(), LeapYears.end(), Epoch);
+
+        // The distance between the two iterators gives us the number of leap years
+        const int nLeapYears = static_cast<int>(std::abs(std::distance(y2000, lb)));
+
+        const int nYears = std::abs(year - Epoch);
+        const int nRegularYears = nYears - nLeapYears;
+
+        // Get the total number of days as the sum of leap years + non leap years
+        const int result = nRegularYears * DaysRegularYear + nLeapYears * DaysLeapYear;
+        return result;
+    }
+
+    // Returns the number of leap seconds that lie between the {year, dayOfYear}
+    // time point and { 2000, 1 }
+    int countLeapSeconds(int year, int dayOfYear) {
+        // Find the position of the current year in the vector; its position in
+        // the vector gives the number of leap seconds
+        struct LeapSecond {
+            int year;
+            int dayOfYear;
+            bool operator<(const LeapSecond& rhs) const {
+                return std::tie(year, dayOfYear) < std::tie(rhs.year, rhs.dayOfYear);
+            }
+        };
+
+        const LeapSecond Epoch = { 2000, 1 };
+
+        // List taken from: https://www.ietf.org/timezones/data/leap-seconds.list
+        static const std::vector<LeapSecond> LeapSeconds = {
+            { 1972,   1 },
+            { 1972, 183 },
+            { 1973,   1 },
+            { 1974,   1 },
+            { 1975,   1 },
+            { 1976,   1 },
+            { 1977,   1 },
+            { 1978,   1 },
+            { 1979,   1 },
+            { 1980,   1 },
+            { 1981, 182 },
+            { 1982, 182 },
+            { 1983, 182 },
+            { 1985, 182 },
+            { 1988,   1 },
+            { 1990,   1 },
+            { 1991,   1 },
+            { 1992, 183 },
+            { 1993, 182 },
+            { 1994, 182 },
+            { 1996,   1 },
+            { 1997, 182 },
+            { 1999,   1 },
+            { 2006,   1 },
+            { 2009,   1 },
+            { 2012, 183 },
+            { 2015, 182 },
+            { 2017,   1 }
+        };
+
+        // Get the position of the last leap second before the desired date
+        LeapSecond date { year, dayOfYear };
+        const auto it = std::lower_bound(LeapSeconds.begin(), LeapSeconds.end(), date);
+
+        // Get the position of the Epoch
+        const auto y2000 = std::lower_bound(
+            LeapSeconds.begin(),
+            LeapSeconds.end(),
+            Epoch
+        );
+
+        // The distance between the two iterators gives us the number of leap years
+        const int nLeapSeconds = static_cast<int>(std::abs(std::distance(y2000, it)));
+        return nLeapSeconds;
+    }
+
+    double epochFromSubstring(const std::string& epochString) {
+        // The epochString is in the form:
+        // YYDDD.DDDDDDDD
+        // With YY being the last two years of the launch epoch, the first DDD the day
+        // of the year and the remaning a fractional part of the day
+
+        // The main overview of this function:
+        // 1. Reconstruct the full year from the YY part
+        // 2. Calculate the number of seconds since the beginning of the year
+        // 2.a Get the number of full days since the beginning of the year
+        // 2.b If the year is a leap year, modify the number of days
+        // 3. Convert the number of days to a number of seconds
+        // 4. Get the number of leap seconds since January 1st, 2000 and remove them
+        // 5. Adjust for the fact the epoch starts on 1st Januaray at 12:00:00, not
+        // midnight
+
+        // According to https://celestrak.com/columns/v04n03/
+        // Apparently, US Space Command sees no need to change the two-line element
+        // set format yet since no artificial earth satellites existed prior to 1957.
+        // By their reasoning, two-digit years from 57-99 correspond to 1957-1999 and
+        // those from 00-56 correspond to 2000-2056. We'll see each other again in 2057!
+
+        // 1. Get the full year
+        std::string yearPrefix = [y = epochString.substr(0, 2)](){
+            int year = std::atoi(y.c_str());
+            return year >= 57 ? "19" : "20";
+        }();
+        const int year = std::atoi((yearPrefix + epochString.substr(0, 2)).c_str());
+        const int daysSince2000 = countDays(year);
+
+        // 2.
+        // 2.a
+        double daysInYear = std::atof(epochString.substr(2).c_str());
+
+        // 2.b
+        const bool isInLeapYear = std::find(
+            LeapYears.begin(),
+            LeapYears.end(),
+            year
+        ) != LeapYears.end();
+        if (isInLeapYear && daysInYear >= 60) {
+            // We are in a leap year, so we have an effective day more if we are
+            // beyond the end of february (= 31+29 days)
+            --daysInYear;
+        }
+
+        // 3
+        using namespace std::chrono;
+        const int SecondsPerDay = static_cast<int>(seconds(hours(24)).count());
+        //Need to subtract 1 from daysInYear since it is not a zero-based count
+        const double nSecondsSince2000 = (daysSince2000 + daysInYear - 1) * SecondsPerDay;
+
+        // 4
+        // We need to remove additionbal leap seconds past 2000 and add them prior to
+        // 2000 to sync up the time zones
+        const double nLeapSecondsOffset = -countLeapSeconds(
+            year,
+            static_cast<int>(std::floor(daysInYear))
+        );
+
+        // 5
+        const double nSecondsEpochOffset = static_cast<double>(
+            seconds(hours(12)).count()
+        );
+
+        // Combine all of the values
+        const double epoch = nSecondsSince2000 + nLeapSecondsOffset - nSecondsEpochOffset;
+        return epoch;
+    }
+
+    double calculateSemiMajorAxis(double meanMotion) {
+        constexpr const double GravitationalConstant = 6.6740831e-11;
+        constexpr const double MassEarth = 5.9721986e24;
+        constexpr const double muEarth = GravitationalConstant * MassEarth;
+
+        // Use Kepler's 3rd law to calculate semimajor axis
+        // a^3 / P^2 = mu / (2pi)^2
+        // <=> a = ((mu * P^2) / (2pi^2))^(1/3)
+        // with a = semimajor axis
+        // P = period in seconds
+        // mu = G*M_earth
+        double period = std::chrono::seconds(std::chrono::hours(24)).count() / meanMotion;
+
+        const double pisq = glm::pi<double>() * glm::pi<double>();
+        double semiMajorAxis = pow((muEarth * period*period) / (4 * pisq), 1.0 / 3.0);
+
+        // We need the semi major axis in km instead of m
+        return semiMajorAxis / 1000.0;
+    }
+} // namespace
+
+namespace openspace {
+
+KeplerCatalog::Elements KeplerCatalog::elementsFromTle(const std::string& line1,
+                                                      const std::string& line2)
+{
+    if (line1.size() < 32 || line2.size() < 63) {
+        throw ghoul::RuntimeError("Two-line element set is too short", "KeplerCatalog");
+    }
+
+    Elements elements;
+
+    // First line
+    // Field Columns   Content
+    //     1   01-01   Line number
+    //     2   03-07   Satellite number
+    //     3   08-08   Classification (U = Unclassified)
+    //     4   10-11   International Designator (Last two digits of launch year)
+    //     5   12-14   International Designator (Launch number of the year)
+    //     6   15-17   International Designator(piece of the launch)    A
+    //     7   19-20   Epoch Year(last two digits of year)
+    //     8   21-32   Epoch(day of the year and fractional portion of the day)
+    //     9   34-43   First Time Derivative of the Mean Motion divided by two
+    //    10   45-52   Second Time Derivative of Mean Motion divided by six
+    //    11   54-61   BSTAR drag term(decimal point assumed)[10] - 11606 - 4
+    //    12   63-63   The "Ephemeris type"
+    //    13   65-68   Element set  number.Incremented when a new TLE is generated
+    //    14   69-69   Checksum (modulo 10)
+    elements.epoch = epochFromSubstring(line1.substr(18, 14));
+
+    // Second line
+    // Field    Columns   Content
+    //     1      01-01   Line number
+    //     2      03-07   Satellite number
+    //     3      09-16   Inclination (degrees)
+    //     4      18-25   Right ascension of the ascending node (degrees)
+    //     5      27-33   Eccentricity (decimal point assumed)
+    //     6      35-42   Argument of perigee (degrees)
+    //     7      44-51   Mean Anomaly (degrees)
+    //     8      53-63   Mean Motion (revolutions per day)
+    //     9      64-68   Revolution number at epoch (revolutions)
+    //    10      69-69   Checksum (modulo 10)
+    std::stringstream stream;
+    auto parse = [&stream](const std::string& value, double& result) {
+        stream.clear();
+        stream.str(value);
+        stream >> result;
+        if (stream.fail()) {
+            throw ghoul::RuntimeError(
+                fmt::format("Could not parse '{}' in two-line element set", value),
+                "KeplerCatalog"
+            );
+        }
+    };
+
+    double meanMotion = 0.0;
+    parse(line2.substr(8, 8), elements.inclination);
+    parse(line2.substr(17, 8), elements.ascendingNode);
+    parse("0." + line2.substr(26, 7), elements.eccentricity);
+    parse(line2.substr(34, 8), elements.argumentOfPeriapsis);
+    parse(line2.substr(43, 8), elements.meanAnomalyAtEpoch);
+    parse(line2.substr(52, 11), meanMotion);
+
+    // Calculate the semi major axis based on the mean motion using kepler's laws
+    elements.semiMajorAxis = calculateSemiMajorAxis(meanMotion);
+
+    // Converting the mean motion (revolutions per day) to period (seconds per revolution)
+    using namespace std::chrono;
+    elements.period = seconds(hours(24)).count() / meanMotion;
+
+    return elements;
+}
+
+KeplerCatalog KeplerCatalog::loadTleFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.good()) {
+        throw ghoul::RuntimeError(
+            fmt::format("Could not open TLE file '{}'", path),
+            "KeplerCatalog"
+        );
+    }
+
+    KeplerCatalog catalog;
+    std::string previous;
+    std::string line;
+    while (std::getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+
+        if (line[0] == '2' && previous[0] == '1') {
+            catalog.add(elementsFromTle(previous, line));
+            line.clear();
+        }
+        previous = std::move(line);
+    }
+    return catalog;
+}
+
+KeplerCatalog KeplerCatalog::loadKeplerFile(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.good()) {
+        throw ghoul::RuntimeError(
+            fmt::format("Could not open Kepler element file '{}'", path),
+            "KeplerCatalog"
+        );
+    }
+
+    KeplerCatalog catalog;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(file, line)) {
+        ++lineNumber;
+        const size_t first = line.find_first_not_of(" \t\r");
+        if (first == std::string::npos || line[first] == '#') {
+            continue;
+        }
+
+        std::stringstream stream(line);
+        Elements e;
+        stream >> e.eccentricity >> e.semiMajorAxis >> e.inclination >>
+            e.ascendingNode >> e.argumentOfPeriapsis >> e.meanAnomalyAtEpoch >>
+            e.epoch >> e.period;
+        if (stream.fail()) {
+            throw ghoul::RuntimeError(
+                fmt::format(
+                    "Malformed Kepler elements in {} @ line {}", path, lineNumber
+                ),
+                "KeplerCatalog"
+            );
+        }
+        catalog.add(e);
+    }
+    return catalog;
+}
+
+bool KeplerCatalog::add(const Elements& elements) {
+    if (elements.eccentricity < 0.0 || elements.eccentricity >= 1.0 ||
+        elements.period <= 0.0)
+    {
+        return false;
+    }
+
+    _eccentricity.push_back(elements.eccentricity);
+    _meanAnomalyAtEpoch.push_back(glm::radians(elements.meanAnomalyAtEpoch));
+    _meanMotion.push_back(glm::two_pi<double>() / elements.period);
+    _epoch.push_back(elements.epoch);
+
+    // The same rotations as in KeplerTranslation::computeOrbitPlane
+    const double asc = glm::radians(elements.ascendingNode);
+    const double inc = glm::radians(elements.inclination);
+    const double per = glm::radians(elements.argumentOfPeriapsis);
+    const glm::dmat3 orbitPlaneRotation = glm::dmat3(
+        glm::rotate(asc, glm::dvec3(0.0, 0.0, 1.0)) *
+        glm::rotate(inc, glm::dvec3(1.0, 0.0, 0.0)) *
+        glm::rotate(per, glm::dvec3(0.0, 0.0, 1.0))
+    );
+
+    const double e = elements.eccentricity;
+    const double a = elements.semiMajorAxis * 1000.0;
+    const double b = a * std::sqrt(1.0 - e * e);
+    _majorAxis.push_back(orbitPlaneRotation * glm::dvec3(a, 0.0, 0.0));
+    _minorAxis.push_back(orbitPlaneRotation * glm::dvec3(0.0, b, 0.0));
+    return true;
+}
+
+size_t KeplerCatalog::size() const {
+    return _eccentricity.size();
+}
+
+void KeplerCatalog::eccentricAnomalies(double time, size_t begin, size_t end,
+                                       float* result) const
+{
+    solveKeplerEquations(
+        _eccentricity.data(),
+        _meanAnomalyAtEpoch.data(),
+        _meanMotion.data(),
+        _epoch.data(),
+        time,
+        begin,
+        end,
+        result
+    );
+}
+
+double KeplerCatalog::eccentricity(size_t index) const {
+    return _eccentricity[index];
+}
+
+glm::dvec3 KeplerCatalog::majorAxis(size_t index) const {
+    return _majorAxis[index];
+}
+
+glm::dvec3 KeplerCatalog::minorAxis(size_t index) const {
+    return _minorAxis[index];
+}
+
+glm::dvec3 KeplerCatalog::position(size_t index, double eccentricAnomaly) const {
+    return _majorAxis[index] * (std::cos(eccentricAnomaly) - _eccentricity[index]) +
+           _minorAxis[index] * std::sin(eccentricAnomaly);
+}
+
+} // namespace openspace
@@ -0,0 +1,142 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_MODULE_SPACE___KEPLERCATALOG___H__
+#define __OPENSPACE_MODULE_SPACE___KEPLERCATALOG___H__
+
+#include <ghoul/glm.h>
+#include <string>
+#include <vector>
+
+namespace openspace {
+
+/**
+ * The Keplerian elements of a large number of objects orbiting the same body, stored
+ * with one array per quantity so that all objects can be propagated in one vectorizable
+ * loop. The orientation of each orbit is precomputed as the two axes of its ellipse, so
+ * that the position of an object only depends on its eccentric anomaly.
+ */
+class KeplerCatalog {
+public:
+    /// The Keplerian elements of a single object in the units used by KeplerTranslation
+    struct Elements {
+        /// The eccentricity of the orbit in [0, 1)
+        double eccentricity = 0.0;
+        /// The semi-major axis in km
+        double semiMajorAxis = 0.0;
+        /// The inclination of the orbit in degrees
+        double inclination = 0.0;
+        /// The right ascension of the ascending node in degrees
+        double ascendingNode = 0.0;
+        /// The argument of periapsis in degrees
+        double argumentOfPeriapsis = 0.0;
+        /// The mean anomaly at the epoch in degrees
+        double meanAnomalyAtEpoch = 0.0;
+        /// The epoch in seconds relative to the J2000 epoch
+        double epoch = 0.0;
+        /// The period of the orbit in seconds
+        double period = 0.0;
+    };
+
+    /**
+     * Parses the Keplerian elements from the two data lines of a two-line element set as
+     * described in https://celestrak.com/columns/v04n03
+     *
+     * \throw ghoul::RuntimeError If one of the lines is too short or a value can't be
+     *        parsed
+     */
+    static Elements elementsFromTle(const std::string& line1, const std::string& line2);
+
+    /**
+     * Reads all two-line element sets from the file at \p path. Lines that are not
+     * followed by the first and second line of a set are treated as titles and ignored.
+     *
+     * \throw ghoul::RuntimeError If the file can't be opened
+     */
+    static KeplerCatalog loadTleFile(const std::string& path);
+
+    /**
+     * Reads a file with the Keplerian elements of one object per line, given as the
+     * eccentricity, semi-major axis, inclination, ascending node, argument of periapsis,
+     * mean anomaly at epoch, epoch (seconds past J2000), and period, in the units of
+     * Elements. Empty lines and lines starting with # are ignored.
+     *
+     * \throw ghoul::RuntimeError If the file can't be opened or a line is malformed
+     */
+    static KeplerCatalog loadKeplerFile(const std::string& path);
+
+    /**
+     * Adds an object to the catalog.
+     *
+     * \return \c false if the elements describe an orbit that is not closed, in which
+     *         case the object is not added
+     */
+    bool add(const Elements& elements);
+
+    size_t size() const;
+
+    /**
+     * Computes the eccentric anomalies in [-pi, pi) of the objects [\p begin, \p end) at
+     * the \p time in seconds past J2000 and stores them at the same indices of
+     * \p result. The range can be computed concurrently with other, disjoint ranges.
+     */
+    void eccentricAnomalies(double time, size_t begin, size_t end, float* result) const;
+
+    /// Returns the eccentricity of the object at \p index
+    double eccentricity(size_t index) const;
+
+    /**
+     * Returns the vector in meters from the center of the orbit of the object at
+     * \p index to its periapsis
+     */
+    glm::dvec3 majorAxis(size_t index) const;
+
+    /**
+     * Returns the vector in meters that is orthogonal to the majorAxis and has the
+     * length of the semi-minor axis of the orbit of the object at \p index
+     */
+    glm::dvec3 minorAxis(size_t index) const;
+
+    /**
+     * Returns the position in meters relative to the orbited body of the object at
+     * \p index when it is at the \p eccentricAnomaly
+     */
+    glm::dvec3 position(size_t index, double eccentricAnomaly) const;
+
+private:
+    // Used by eccentricAnomalies
+    std::vector<double> _eccentricity;
+    std::vector<double> _meanAnomalyAtEpoch; // radians
+    std::vector<double> _meanMotion; // radians per second
+    std::vector<double> _epoch;
+
+    // Used by majorAxis, minorAxis, and position
+    std::vector<glm::dvec3> _majorAxis;
+    std::vector<glm::dvec3> _minorAxis;
+};
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_SPACE___KEPLERCATALOG___H__
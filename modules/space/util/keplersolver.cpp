@@ -0,0 +1,74 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <modules/space/util/keplersolver.h>
+
+#include <ghoul/glm.h>
+#include <cmath>
+
+namespace {
+    // The Laguerre-Conway iteration converges to double precision for all eccentricities
+    // in [0, 0.999] within this many steps, starting from Danby's initial guess
+    constexpr const int KeplerIterations = 5;
+} // namespace
+
+namespace openspace {
+
+void solveKeplerEquations(const double* eccentricity, const double* meanAnomalyAtEpoch,
+                          const double* meanMotion, const double* epoch, double time,
+                          size_t begin, size_t end, float* result)
+{
+    constexpr const double Pi = glm::pi<double>();
+    constexpr const double TwoPi = glm::two_pi<double>();
+    constexpr const double HalfPi = glm::half_pi<double>();
+
+    // The loop is free of branches and has a fixed number of iterations, so that the
+    // compiler can process several objects at once with vector instructions. The cosine
+    // is expressed as a shifted sine as compilers would otherwise combine the two calls
+    // into a sincos for which no vectorized version is available
+    for (size_t i = begin; i < end; ++i) {
+        const double e = eccentricity[i];
+
+        // The mean anomaly has to be computed in double precision, as the time since the
+        // epoch can be many orbits. Afterwards it is reduced to [-pi, pi)
+        double m = meanAnomalyAtEpoch[i] + (time - epoch[i]) * meanMotion[i];
+        m -= TwoPi * std::floor((m + Pi) / TwoPi);
+
+        // Solve Kepler's equation m = x - e * sin(x) with the same solver that the
+        // KeplerTranslation uses for high eccentricities
+        double x = m + std::copysign(0.85 * e, m);
+        for (int j = 0; j < KeplerIterations; ++j) {
+            const double s = e * std::sin(x);
+            const double c = e * std::sin(x + HalfPi);
+            const double f = x - s - m;
+            const double f1 = 1.0 - c;
+            const double root = std::sqrt(std::abs(16.0 * f1 * f1 - 20.0 * f * s));
+            x -= 5.0 * f / (f1 + std::copysign(root, f1));
+        }
+        result[i] = static_cast<float>(x);
+    }
+}
+
+} // namespace openspace
@@ -0,0 +1,48 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_MODULE_SPACE___KEPLERSOLVER___H__
+#define __OPENSPACE_MODULE_SPACE___KEPLERSOLVER___H__
+
+#include <cstddef>
+
+namespace openspace {
+
+/**
+ * Computes the eccentric anomalies in [-pi, pi) of the objects [\p begin, \p end) at the
+ * \p time in seconds past J2000 from the arrays of their elements and stores them at the
+ * same indices of \p result. The mean anomalies at the epochs are given in radians and
+ * the mean motions in radians per second.
+ *
+ * This is the only function that is compiled with relaxed floating point semantics, so
+ * that the compiler can use vectorized versions of sin and cos.
+ */
+void solveKeplerEquations(const double* eccentricity, const double* meanAnomalyAtEpoch,
+    const double* meanMotion, const double* epoch, double time, size_t begin,
+    size_t end, float* result);
+
+} // namespace openspace
+
+#endif // __OPENSPACE_MODULE_SPACE___KEPLERSOLVER___H__
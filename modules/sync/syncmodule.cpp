@@ -82,7 +82,8 @@ void SyncModule::internalInitialize(const ghoul::Dictionary& configuration) {
             return new HttpSynchronization(
                 dictionary,
                 _synchronizationRoot,
-                _synchronizationRepositories
+                _synchronizationRepositories,
+                _downloadEngine
             );
         }
     );
@@ -138,6 +139,10 @@ std::vector<std::string> SyncModule::httpSynchronizationRepositories() const {
     return _synchronizationRepositories;
 }
 
+DownloadEngine& SyncModule::downloadEngine() {
+    return _downloadEngine;
+}
+
 std::vector<documentation::Documentation> SyncModule::documentations() const {
     return {
         HttpSynchronization::Documentation(),
@@ -27,6 +27,8 @@
 
 #include <openspace/util/openspacemodule.h>
 
+#include <openspace/util/downloadengine.h>
+
 #ifdef SYNC_USE_LIBTORRENT
 #include <modules/sync/torrentclient.h>
 #endif // SYNC_USE_LIBTORRENT
@@ -44,6 +46,8 @@ public:
     void addHttpSynchronizationRepository(std::string repository);
     std::vector<std::string> httpSynchronizationRepositories() const;
 
+    DownloadEngine& downloadEngine();
+
 #ifdef SYNC_USE_LIBTORRENT
     TorrentClient& torrentClient();
 #endif // SYNC_USE_LIBTORRENT
@@ -55,6 +59,9 @@ protected:
     void internalDeinitialize() override;
 
 private:
+    // The engine is shared by all HttpSynchronizations so that they reuse connections
+    // and the number of concurrent downloads is limited across all of them
+    DownloadEngine _downloadEngine;
 #ifdef SYNC_USE_LIBTORRENT
     TorrentClient _torrentClient;
 #endif // SYNC_USE_LIBTORRENT
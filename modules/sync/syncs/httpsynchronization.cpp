@@ -27,13 +27,13 @@
 #include <modules/sync/syncmodule.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
-#include <openspace/util/httprequest.h>
 #include <ghoul/fmt.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
 #include <fstream>
-#include <numeric>
+#include <sstream>
+#include <unordered_set>
 
 namespace {
     constexpr const char* _loggerCat = "HttpSynchronization";
@@ -75,9 +75,11 @@ documentation::Documentation HttpSynchronization::Documentation() {
 
 HttpSynchronization::HttpSynchronization(const ghoul::Dictionary& dict,
                                          std::string synchronizationRoot,
-                                      std::vector<std::string> synchronizationRepositories
-)
+                                     std::vector<std::string> synchronizationRepositories,
+                                                          DownloadEngine& downloadEngine)
     : openspace::ResourceSynchronization(dict)
+    , _downloadEngine(downloadEngine)
+    , _progress(std::make_shared<DownloadEngine::Progress>())
     , _synchronizationRoot(std::move(synchronizationRoot))
     , _synchronizationRepositories(std::move(synchronizationRepositories))
 {
@@ -147,6 +149,12 @@ void HttpSynchronization::start() {
 
 void HttpSynchronization::cancel() {
     _shouldCancel = true;
+    {
+        std::lock_guard<std::mutex> lock(_transferMutex);
+        for (const std::shared_ptr<DownloadEngine::Transfer>& t : _transfers) {
+            t->cancel();
+        }
+    }
     reset();
 }
 
@@ -156,15 +164,15 @@ void HttpSynchronization::clear() {
 }
 
 size_t HttpSynchronization::nSynchronizedBytes() {
-    return _nSynchronizedBytes;
+    return _progress->downloadedBytes;
 }
 
 size_t HttpSynchronization::nTotalBytes() {
-    return _nTotalBytes;
+    return _progress->totalBytes;
 }
 
 bool HttpSynchronization::nTotalBytesIsKnown() {
-    return _nTotalBytesKnown;
+    return _hasEnqueuedAllFiles && _progress->nUnknownSizes == 0;
 }
 
 void HttpSynchronization::createSyncFile() {
@@ -183,119 +191,86 @@ bool HttpSynchronization::hasSyncFile() {
     return FileSys.fileExists(path);
 }
 
+std::shared_ptr<DownloadEngine::Transfer> HttpSynchronization::enqueue(
+                                                          DownloadEngine::Request request)
+{
+    std::shared_ptr<DownloadEngine::Transfer> transfer = _downloadEngine.enqueue(
+        std::move(request)
+    );
+    std::lock_guard<std::mutex> lock(_transferMutex);
+    _transfers.push_back(transfer);
+    // If the synchronization was cancelled before the transfer was added, it would not
+    // have been cancelled with the others
+    if (_shouldCancel) {
+        transfer->cancel();
+    }
+    return transfer;
+}
+
 bool HttpSynchronization::trySyncFromUrl(std::string listUrl) {
-    HttpRequest::RequestOptions opt = {};
-    opt.requestTimeoutSeconds = 0;
+    {
+        std::lock_guard<std::mutex> lock(_transferMutex);
+        _transfers.clear();
+    }
 
-    SyncHttpMemoryDownload fileListDownload(std::move(listUrl));
-    fileListDownload.onProgress([&c = _shouldCancel](HttpRequest::Progress) {
-        return !c;
-    });
-    fileListDownload.download(opt);
+    DownloadEngine::Request listRequest;
+    listRequest.url = std::move(listUrl);
+    std::shared_ptr<DownloadEngine::Transfer> fileList = enqueue(std::move(listRequest));
+    fileList->wait();
 
-    if (!fileListDownload.hasSucceeded()) {
+    if (fileList->state() != DownloadEngine::Transfer::State::Succeeded) {
         return false;
     }
 
-    const std::vector<char>& buffer = fileListDownload.downloadedData();
-    _nSynchronizedBytes = 0;
-    _nTotalBytes = 0;
-    _nTotalBytesKnown = false;
-
-    std::istringstream fileList(std::string(buffer.begin(), buffer.end()));
+    // All transfers of a previous attempt are finished at this point, so nothing else
+    // updates the progress
+    _hasEnqueuedAllFiles = false;
+    _progress->downloadedBytes = 0;
+    _progress->totalBytes = 0;
+    _progress->nUnknownSizes = 0;
 
-    std::string line;
-
-    struct SizeData {
-        bool totalKnown;
-        size_t totalBytes;
-        size_t downloadedBytes;
-    };
-
-    std::unordered_map<std::string, SizeData> sizeData;
-    std::mutex sizeDataMutex;
-
-    std::atomic_bool startedAllDownloads(false);
-
-    std::vector<std::unique_ptr<AsyncHttpFileDownload>> downloads;
+    const std::vector<char>& buffer = fileList->data();
+    std::istringstream fileListStream(std::string(buffer.begin(), buffer.end()));
 
-    while (fileList >> line) {
-        size_t lastSlash = line.find_last_of('/');
-        std::string filename = line.substr(lastSlash + 1);
-
-        std::string fileDestination = directory() +
-            ghoul::filesystem::FileSystem::PathSeparator +
-            filename + TempSuffix;
+    std::unordered_set<std::string> urls;
+    std::vector<std::shared_ptr<DownloadEngine::Transfer>> downloads;
 
-        if (sizeData.find(line) != sizeData.end()) {
+    std::string line;
+    while (fileListStream >> line) {
+        if (urls.find(line) != urls.end()) {
             LWARNING(fmt::format(
                 "{}: Duplicate entries: {}", _identifier, line
             ));
             continue;
         }
+        urls.insert(line);
 
-        downloads.push_back(std::make_unique<AsyncHttpFileDownload>(
-            line,
-            fileDestination,
-            HttpFileDownload::Overwrite::Yes
-        ));
-
-        std::unique_ptr<AsyncHttpFileDownload>& fileDownload = downloads.back();
-
-        sizeData[line] = {
-            false,
-            0,
-            0,
-        };
-
-        fileDownload->onProgress(
-            [this, line, &sizeData, &sizeDataMutex,
-             &startedAllDownloads](HttpRequest::Progress p)
-        {
-            if (!p.totalBytesKnown || !startedAllDownloads) {
-                return !_shouldCancel;
-            }
-
-            std::lock_guard<std::mutex> guard(sizeDataMutex);
-
-            sizeData[line] = {
-                p.totalBytesKnown,
-                p.totalBytes,
-                p.downloadedBytes,
-            };
-
-            SizeData size = std::accumulate(
-                sizeData.begin(),
-                sizeData.end(),
-                SizeData{ true, 0, 0 },
-                [](const SizeData& a, const std::pair<const std::string, SizeData>& b) {
-                    return SizeData {
-                        a.totalKnown && b.second.totalKnown,
-                        a.totalBytes + b.second.totalBytes,
-                        a.downloadedBytes + b.second.downloadedBytes
-                    };
-                }
-            );
-
-            _nTotalBytesKnown = size.totalKnown;
-            _nTotalBytes = size.totalBytes;
-            _nSynchronizedBytes = size.downloadedBytes;
-
-            return !_shouldCancel;
-        });
+        size_t lastSlash = line.find_last_of('/');
+        std::string filename = line.substr(lastSlash + 1);
 
-        fileDownload->start(opt);
+        // The file is downloaded to a temporary file first, so that a download that was
+        // interrupted is never mistaken for a complete file. The next attempt resumes it
+        DownloadEngine::Request request;
+        request.url = line;
+        request.destination = directory() +
+            ghoul::filesystem::FileSystem::PathSeparator +
+            filename + TempSuffix;
+        request.resume = true;
+        request.progress = _progress;
+        downloads.push_back(enqueue(std::move(request)));
     }
-    startedAllDownloads = true;
+    _hasEnqueuedAllFiles = true;
 
     bool failed = false;
-    for (std::unique_ptr<AsyncHttpFileDownload>& d : downloads) {
+    for (const std::shared_ptr<DownloadEngine::Transfer>& d : downloads) {
         d->wait();
-        if (d->hasSucceeded()) {
-            // If we are forcing the override, we download to a temporary file
-            // first, so when we are done here, we need to rename the file to the
-            // original name
+        if (failed) {
+            continue;
+        }
 
+        if (d->state() == DownloadEngine::Transfer::State::Succeeded) {
+            // We downloaded to a temporary file, so when we are done here, we need to
+            // rename the file to the original name
             const std::string& tempName = d->destination();
             std::string originalName = tempName.substr(
                 0,
@@ -317,14 +292,16 @@ bool HttpSynchronization::trySyncFromUrl(std::string listUrl) {
             ));
             failed = true;
         }
+
+        if (failed) {
+            // There is no point in finishing the other downloads, as this attempt has
+            // failed anyway. What they have downloaded so far is resumed next time
+            for (const std::shared_ptr<DownloadEngine::Transfer>& t : downloads) {
+                t->cancel();
+            }
+        }
     }
-    if (!failed) {
-        return true;
-    }
-    for (std::unique_ptr<AsyncHttpFileDownload>& d : downloads) {
-        d->cancel();
-    }
-    return false;
+    return !failed;
 }
 
 } // namespace openspace
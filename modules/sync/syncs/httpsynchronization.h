@@ -27,6 +27,9 @@
 
 #include <openspace/util/resourcesynchronization.h>
 
+#include <openspace/util/downloadengine.h>
+#include <memory>
+#include <mutex>
 #include <thread>
 #include <vector>
 
@@ -35,7 +38,8 @@ namespace openspace {
 class HttpSynchronization : public ResourceSynchronization {
 public:
     HttpSynchronization(const ghoul::Dictionary& dict, std::string synchronizationRoot,
-        std::vector<std::string> synchronizationRepositories);
+        std::vector<std::string> synchronizationRepositories,
+        DownloadEngine& downloadEngine);
 
     virtual ~HttpSynchronization();
 
@@ -55,12 +59,17 @@ private:
     void createSyncFile();
     bool hasSyncFile();
     bool trySyncFromUrl(std::string url);
+    std::shared_ptr<DownloadEngine::Transfer> enqueue(DownloadEngine::Request request);
 
-    std::atomic_bool _nTotalBytesKnown = false;
-    std::atomic_size_t _nTotalBytes = 0;
-    std::atomic_size_t _nSynchronizedBytes = 0;
+    DownloadEngine& _downloadEngine;
+    // The progress of all file downloads of the current attempt
+    const std::shared_ptr<DownloadEngine::Progress> _progress;
+    std::atomic_bool _hasEnqueuedAllFiles = false;
     std::atomic_bool _shouldCancel = false;
 
+    std::mutex _transferMutex;
+    std::vector<std::shared_ptr<DownloadEngine::Transfer>> _transfers;
+
     std::string _identifier;
     int _version = -1;
     std::string _synchronizationRoot;
@@ -170,6 +170,11 @@ void RenderableToyVolume::update(const UpdateData& data) {
     }
 }
 
+bool RenderableToyVolume::isUpdateGLBound() const {
+    // The raycaster only receives new uniform values that are uploaded while rendering
+    return false;
+}
+
 void RenderableToyVolume::render(const RenderData& data, RendererTasks& tasks) {
     RaycasterTask task { _raycaster.get(), data };
     tasks.raycasterTasks.push_back(task);
@@ -47,6 +47,7 @@ public:
     bool isReady() const override;
     void render(const RenderData& data, RendererTasks& tasks) override;
     void update(const UpdateData& data) override;
+    bool isUpdateGLBound() const override;
 
 private:
     properties::Vec3Property _size;
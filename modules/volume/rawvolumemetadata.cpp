@@ -27,6 +27,7 @@
 #include <openspace/documentation/verifier.h>
 
 #include <openspace/util/time.h>
+#include <sstream>
 
 namespace {
     constexpr const char* KeyDimensions = "Dimensions";
@@ -41,6 +42,10 @@ namespace {
     constexpr const char* KeyValueUnit = "ValueUnit";
 
     constexpr const char* KeyGridType = "GridType";
+
+    // The histogram is stored as a string of whitespace-separated bin counts, as a list
+    // of numbers can not be written by the DictionaryLuaFormatter
+    constexpr const char* KeyHistogram = "Histogram";
 } // namespace
 
 namespace openspace::volume {
@@ -64,7 +69,7 @@ RawVolumeMetadata RawVolumeMetadata::createFromDictionary(
         metadata.lowerDomainBound = dictionary.value<glm::vec3>(KeyLowerDomainBound);
         metadata.upperDomainBound = dictionary.value<glm::vec3>(KeyUpperDomainBound);
     }
-    metadata.hasDomainUnit = dictionary.hasValue<float>(KeyDomainUnit);
+    metadata.hasDomainUnit = dictionary.hasValue<std::string>(KeyDomainUnit);
     if (metadata.hasDomainUnit) {
         metadata.domainUnit = dictionary.value<std::string>(KeyDomainUnit);
     }
@@ -76,7 +81,7 @@ RawVolumeMetadata RawVolumeMetadata::createFromDictionary(
         metadata.minValue = dictionary.value<float>(KeyMinValue);
         metadata.maxValue = dictionary.value<float>(KeyMaxValue);
     }
-    metadata.hasValueUnit = dictionary.hasValue<float>(KeyValueUnit);
+    metadata.hasValueUnit = dictionary.hasValue<std::string>(KeyValueUnit);
     if (metadata.hasValueUnit) {
         metadata.valueUnit = dictionary.value<std::string>(KeyValueUnit);
     }
@@ -87,6 +92,21 @@ RawVolumeMetadata RawVolumeMetadata::createFromDictionary(
         metadata.time = Time::convertTime(timeString);
     }
 
+    metadata.gridType = VolumeGridType::Cartesian;
+    if (dictionary.hasValue<std::string>(KeyGridType)) {
+        metadata.gridType = parseGridType(dictionary.value<std::string>(KeyGridType));
+    }
+
+    metadata.hasHistogram = dictionary.hasValue<std::string>(KeyHistogram);
+    if (metadata.hasHistogram) {
+        std::istringstream bins(dictionary.value<std::string>(KeyHistogram));
+        size_t count;
+        while (bins >> count) {
+            metadata.histogram.push_back(count);
+        }
+        metadata.hasHistogram = !metadata.histogram.empty();
+    }
+
     return metadata;
 }
 
@@ -107,7 +127,7 @@ ghoul::Dictionary RawVolumeMetadata::dictionary() {
         dict.setValue<double>(KeyMinValue, minValue);
         dict.setValue<double>(KeyMaxValue, maxValue);
     }
-    if (hasDomainUnit) {
+    if (hasValueUnit) {
         dict.setValue<std::string>(KeyValueUnit, valueUnit);
     }
 
@@ -119,6 +139,17 @@ ghoul::Dictionary RawVolumeMetadata::dictionary() {
         }
         dict.setValue<std::string>(KeyTime, timeString);
     }
+
+    if (hasHistogram) {
+        std::string bins;
+        for (size_t count : histogram) {
+            if (!bins.empty()) {
+                bins += ' ';
+            }
+            bins += std::to_string(count);
+        }
+        dict.setValue<std::string>(KeyHistogram, bins);
+    }
     return dict;
 }
 
@@ -175,6 +206,20 @@ documentation::Documentation RawVolumeMetadata::Documentation() {
                 new DoubleVerifier,
                 Optional::Yes,
                 "Specifies the maximum value stored in the volume"
+            },
+            {
+                KeyGridType,
+                new StringInListVerifier({ "Cartesian", "Spherical" }),
+                Optional::Yes,
+                "Specifies the grid type of the volume. The default is 'Cartesian'"
+            },
+            {
+                KeyHistogram,
+                new StringVerifier,
+                Optional::Yes,
+                "Specifies the number of voxels in each bin of a histogram of the "
+                "values, after they have been normalized to [0, 1] using the value "
+                "range, as a whitespace-separated list"
             }
         }
     };
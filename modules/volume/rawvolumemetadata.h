@@ -29,6 +29,7 @@
 #include <modules/volume/volumegridtype.h>
 
 #include <ghoul/misc/dictionary.h>
+#include <vector>
 
 namespace openspace::volume {
 
@@ -55,6 +56,11 @@ struct RawVolumeMetadata {
     glm::vec3 upperDomainBound;
     bool hasDomainUnit;
     std::string domainUnit;
+
+    // The number of voxels in each bin of the histogram of the voxel values after they
+    // have been normalized to [0, 1] using the value range
+    bool hasHistogram = false;
+    std::vector<size_t> histogram;
 };
 
 } // namespace openspace::volume
@@ -0,0 +1,238 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <modules/volume/rawvolumestreamer.h>
+
+#include <modules/volume/rawvolumereader.h>
+#include <openspace/engine/globals.h>
+#include <openspace/util/workstealingthreadpool.h>
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace {
+    constexpr const char* _loggerCat = "RawVolumeStreamer";
+
+    // Each load is split into this many blocks per thread, which evens out the work
+    // between the threads if other tasks are running on the pool at the same time
+    constexpr const size_t BlocksPerThread = 16;
+
+    // Number of timesteps that are loaded at the same time. One timestep can be read
+    // from disk while the previous one is normalized
+    constexpr const size_t MaxConcurrentLoads = 2;
+} // namespace
+
+namespace openspace::volume {
+
+RawVolumeStreamer::RawVolumeStreamer(std::vector<Source> sources, size_t memoryBudget)
+    : _sources(std::move(sources))
+    , _entries(_sources.size())
+    , _memoryBudget(memoryBudget)
+{}
+
+RawVolumeStreamer::~RawVolumeStreamer() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _shouldStop = true;
+    // The loads that are still running on the pool access this object
+    _loadsFinished.wait(lock, [this]() { return _nLoads == 0; });
+}
+
+void RawVolumeStreamer::request(std::vector<int> indices) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (indices == _requested) {
+        return;
+    }
+
+    ++_nRequests;
+    for (int index : indices) {
+        _entries[index].lastRequest = _nRequests;
+    }
+    _requested = std::move(indices);
+    startLoads();
+}
+
+std::shared_ptr<const RawVolumeStreamer::Volume> RawVolumeStreamer::volume(
+                                                                          int index) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _entries[index].volume;
+}
+
+void RawVolumeStreamer::setMemoryBudget(size_t memoryBudget) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _memoryBudget = memoryBudget;
+    makeRoom(0);
+    startLoads();
+}
+
+size_t RawVolumeStreamer::memoryUsage() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _memoryUsage;
+}
+
+size_t RawVolumeStreamer::volumeSize(int index) const {
+    const glm::uvec3& dims = _sources[index].metadata.dimensions;
+    return static_cast<size_t>(dims.x) * static_cast<size_t>(dims.y) *
+        static_cast<size_t>(dims.z) * sizeof(float);
+}
+
+void RawVolumeStreamer::startLoads() {
+    if (_shouldStop) {
+        return;
+    }
+
+    for (int index : _requested) {
+        if (_nLoads >= MaxConcurrentLoads) {
+            break;
+        }
+
+        Entry& entry = _entries[index];
+        if (entry.volume || entry.isLoading || entry.hasFailed) {
+            continue;
+        }
+
+        // The first requested timestep is the one that is shown, so it is loaded even
+        // if this exceeds the budget
+        const size_t size = volumeSize(index);
+        if (!makeRoom(size) && index != _requested.front()) {
+            break;
+        }
+
+        entry.isLoading = true;
+        _memoryUsage += size;
+        ++_nLoads;
+        global::threadPool.enqueue([this, index]() { load(index); });
+    }
+}
+
+bool RawVolumeStreamer::makeRoom(size_t size) {
+    while (_memoryUsage + size > _memoryBudget) {
+        // Find the loaded timestep that was requested longest ago and is no longer
+        // requested
+        Entry* victim = nullptr;
+        int victimIndex = -1;
+        for (size_t i = 0; i < _entries.size(); ++i) {
+            Entry& e = _entries[i];
+            if (!e.volume || e.lastRequest == _nRequests) {
+                continue;
+            }
+            if (!victim || e.lastRequest < victim->lastRequest) {
+                victim = &e;
+                victimIndex = static_cast<int>(i);
+            }
+        }
+        if (!victim) {
+            return false;
+        }
+
+        victim->volume = nullptr;
+        _memoryUsage -= volumeSize(victimIndex);
+    }
+    return true;
+}
+
+void RawVolumeStreamer::load(int index) {
+    const Source& source = _sources[index];
+    auto volume = std::make_shared<Volume>();
+
+    try {
+        RawVolumeReader<float> reader(source.path, source.metadata.dimensions);
+        volume->rawVolume = reader.read();
+    }
+    catch (const ghoul::RuntimeError& e) {
+        LERROR(fmt::format("Could not load '{}': {}", source.path, e.message));
+        volume = nullptr;
+    }
+
+    if (volume) {
+        const float min = source.metadata.minValue;
+        const float diff = source.metadata.maxValue - source.metadata.minValue;
+        const bool buildHistogram = !source.metadata.hasHistogram;
+        float* data = volume->rawVolume->data();
+
+        std::mutex histogramMutex;
+        std::array<size_t, NumberHistogramBins> histogram = {};
+
+        WorkStealingThreadPool& pool = global::threadPool;
+        pool.parallelFor(
+            volume->rawVolume->nCells(),
+            pool.numThreads() * BlocksPerThread,
+            [&](size_t begin, size_t end) {
+                // Kept free of branches so that it is vectorized
+                for (size_t i = begin; i < end; ++i) {
+                    data[i] = std::min(std::max((data[i] - min) / diff, 0.f), 1.f);
+                }
+
+                if (!buildHistogram) {
+                    return;
+                }
+                std::array<size_t, NumberHistogramBins> counts = {};
+                for (size_t i = begin; i < end; ++i) {
+                    // The bins are computed in the same way as in Histogram::add. The
+                    // comparison excludes NaN values
+                    if (data[i] >= 0.f) {
+                        const float bin = std::floor(data[i] * NumberHistogramBins);
+                        ++counts[static_cast<size_t>(
+                            std::min(bin, NumberHistogramBins - 1.f)
+                        )];
+                    }
+                }
+                std::lock_guard<std::mutex> lock(histogramMutex);
+                for (size_t i = 0; i < counts.size(); ++i) {
+                    histogram[i] += counts[i];
+                }
+            }
+        );
+
+        if (buildHistogram) {
+            volume->histogram.assign(histogram.begin(), histogram.end());
+            volume->isHistogramNew = true;
+        }
+        else {
+            volume->histogram = source.metadata.histogram;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    Entry& entry = _entries[index];
+    entry.isLoading = false;
+    --_nLoads;
+    if (volume) {
+        entry.volume = std::move(volume);
+    }
+    else {
+        entry.hasFailed = true;
+        _memoryUsage -= volumeSize(index);
+    }
+    startLoads();
+    if (_nLoads == 0) {
+        _loadsFinished.notify_all();
+    }
+}
+
+} // namespace openspace::volume
@@ -0,0 +1,134 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#ifndef __OPENSPACE_MODULE_VOLUME___RAWVOLUMESTREAMER___H__
+#define __OPENSPACE_MODULE_VOLUME___RAWVOLUMESTREAMER___H__
+
+#include <modules/volume/rawvolume.h>
+#include <modules/volume/rawvolumemetadata.h>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace openspace::volume {
+
+/**
+ * Loads the timesteps of a volume sequence from .rawvolume files on the shared thread
+ * pool. While a timestep is loaded, its voxel values are normalized to [0, 1] using the
+ * value range of its metadata and, unless the metadata already contains one, a histogram
+ * of the normalized values is built. Both are split up among the threads of the pool.
+ *
+ * Each frame, the owner passes the timesteps it needs in the order in which it needs
+ * them. These are loaded as long as the memory budget allows it; the first timestep is
+ * always loaded. Timesteps that are no longer needed are kept in memory until the space
+ * is needed for another timestep, at which point the one that was needed longest ago is
+ * evicted.
+ */
+class RawVolumeStreamer {
+public:
+    struct Source {
+        // Path to the .rawvolume file
+        std::string path;
+        RawVolumeMetadata metadata;
+    };
+
+    struct Volume {
+        // The voxel values normalized to [0, 1]
+        std::unique_ptr<RawVolume<float>> rawVolume;
+        // The number of voxels in each bin of the histogram of the normalized values
+        std::vector<size_t> histogram;
+        // True if the histogram was built while loading, false if it was provided by
+        // the metadata
+        bool isHistogramNew = false;
+    };
+
+    /**
+     * Creates a streamer for the \p sources, which keeps at most \p memoryBudget bytes of
+     * voxel data in memory.
+     */
+    RawVolumeStreamer(std::vector<Source> sources, size_t memoryBudget);
+
+    /// Stops the loading and waits until the timesteps that are being loaded are finished
+    ~RawVolumeStreamer();
+
+    /**
+     * Sets the timesteps that should be loaded as indices into the sources in the order
+     * in which they are needed. Timesteps that are already loaded are not loaded again.
+     */
+    void request(std::vector<int> indices);
+
+    /// Returns the timestep at \p index if it has been loaded, or nullptr otherwise
+    std::shared_ptr<const Volume> volume(int index) const;
+
+    void setMemoryBudget(size_t memoryBudget);
+
+    /// Returns the number of bytes used by timesteps that are loaded or being loaded
+    size_t memoryUsage() const;
+
+    /// Returns the number of bytes that the voxel data of the timestep at \p index uses
+    size_t volumeSize(int index) const;
+
+    /// Number of bins of the histograms that are built while loading
+    static constexpr const int NumberHistogramBins = 100;
+
+private:
+    struct Entry {
+        std::shared_ptr<const Volume> volume;
+        // The value of _nRequests when this timestep was last requested
+        size_t lastRequest = 0;
+        bool isLoading = false;
+        bool hasFailed = false;
+    };
+
+    // Starts loading the requested timesteps that fit into the budget. Must be called
+    // with the mutex locked
+    void startLoads();
+
+    // Evicts timesteps that are not requested until \p size bytes fit into the budget
+    // and returns whether this succeeded. Must be called with the mutex locked
+    bool makeRoom(size_t size);
+
+    void load(int index);
+
+    const std::vector<Source> _sources;
+    std::vector<Entry> _entries;
+    std::vector<int> _requested;
+    size_t _nRequests = 0;
+    size_t _nLoads = 0;
+
+    size_t _memoryBudget;
+    size_t _memoryUsage = 0;
+
+    mutable std::mutex _mutex;
+    // Notified when the last load that is in progress has finished
+    std::condition_variable _loadsFinished;
+    bool _shouldStop = false;
+};
+
+} // namespace openspace::volume
+
+#endif // __OPENSPACE_MODULE_VOLUME___RAWVOLUMESTREAMER___H__
@@ -28,7 +28,6 @@
 #include <modules/volume/rendering/volumeclipplanes.h>
 #include <modules/volume/transferfunctionhandler.h>
 #include <modules/volume/rawvolume.h>
-#include <modules/volume/rawvolumereader.h>
 #include <modules/volume/volumegridtype.h>
 #include <openspace/documentation/documentation.h>
 #include <openspace/documentation/verifier.h>
@@ -42,7 +41,11 @@
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/dictionaryluaformatter.h>
 #include <ghoul/opengl/texture.h>
+#include <algorithm>
+#include <chrono>
+#include <fstream>
 
 namespace {
     constexpr const char* _loggerCat = "RenderableTimeVaryingVolume";
@@ -58,6 +61,8 @@ namespace {
     const char* KeyClipPlanes = "ClipPlanes";
     const char* KeySecondsBefore = "SecondsBefore";
     const char* KeySecondsAfter = "SecondsAfter";
+    const char* KeyMemoryBudget = "MemoryBudget";
+    const char* KeyPrefetchTimesteps = "PrefetchTimesteps";
 
     const float SecondsInOneDay = 60 * 60 * 24;
     constexpr const float VolumeMaxOpacity = 500;
@@ -116,6 +121,21 @@ namespace {
         "" // @TODO Missing documentation
     };
 
+    constexpr openspace::properties::Property::PropertyInfo MemoryBudgetInfo = {
+        "memoryBudget",
+        "Memory budget (MB)",
+        "The amount of memory in megabytes that the loaded timesteps may use in main "
+        "memory and, separately, on the graphics card. Timesteps that are not needed are "
+        "evicted when the budget is exceeded."
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo PrefetchTimestepsInfo = {
+        "prefetchTimesteps",
+        "Prefetched timesteps",
+        "The number of timesteps following the current one, in the direction in which "
+        "time is moving, that are loaded ahead of time."
+    };
+
     constexpr openspace::properties::Property::PropertyInfo rNormalizationInfo = {
         "rNormalization",
         "Radius normalization",
@@ -127,6 +147,16 @@ namespace {
         "Radius upper bound",
         "" // @TODO Missing documentation
     };
+
+    std::shared_ptr<openspace::Histogram> createHistogram(const std::vector<size_t>& bins)
+    {
+        const int nBins = static_cast<int>(bins.size());
+        auto histogram = std::make_shared<openspace::Histogram>(0.f, 1.f, nBins);
+        for (int i = 0; i < nBins; ++i) {
+            histogram->add((i + 0.5f) / nBins, static_cast<float>(bins[i]));
+        }
+        return histogram;
+    }
 } // namespace
 
 namespace openspace::volume {
@@ -162,6 +192,18 @@ namespace openspace::volume {
                 Optional::No,
                 "Specifies the number of seconds to show the the last timestep after its "
                 "actual time"
+            },
+            {
+                KeyMemoryBudget,
+                new IntVerifier,
+                Optional::Yes,
+                MemoryBudgetInfo.description
+            },
+            {
+                KeyPrefetchTimesteps,
+                new IntVerifier,
+                Optional::Yes,
+                PrefetchTimestepsInfo.description
             }
         }
     };
@@ -181,6 +223,8 @@ RenderableTimeVaryingVolume::RenderableTimeVaryingVolume(
     , _triggerTimeJump(TriggerTimeJumpInfo)
     , _jumpToTimestep(JumpToTimestepInfo, 0, 0, 256)
     , _currentTimestep(CurrentTimeStepInfo, 0, 0, 256)
+    , _memoryBudget(MemoryBudgetInfo, 2048, 64, 65536)
+    , _nPrefetchTimesteps(PrefetchTimestepsInfo, 2, 0, 16)
 {
     documentation::testSpecificationAndThrow(
         Documentation(),
@@ -210,6 +254,15 @@ RenderableTimeVaryingVolume::RenderableTimeVaryingVolume(
     }
     _secondsAfter = dictionary.value<float>(KeySecondsAfter);
 
+    if (dictionary.hasKeyAndValue<double>(KeyMemoryBudget)) {
+        _memoryBudget = static_cast<int>(dictionary.value<double>(KeyMemoryBudget));
+    }
+    if (dictionary.hasKeyAndValue<double>(KeyPrefetchTimesteps)) {
+        _nPrefetchTimesteps = static_cast<int>(
+            dictionary.value<double>(KeyPrefetchTimesteps)
+        );
+    }
+
     ghoul::Dictionary clipPlanesDictionary;
     dictionary.getValue(KeyClipPlanes, clipPlanesDictionary);
     _clipPlanes = std::make_shared<volume::VolumeClipPlanes>(clipPlanesDictionary);
@@ -249,44 +302,22 @@ void RenderableTimeVaryingVolume::initializeGL() {
         }
     }
 
-    // TODO: defer loading of data to later (separate thread or at least not when loading)
-    for (std::pair<const double, Timestep>& p : _volumeTimesteps) {
-        Timestep& t = p.second;
+    // The timesteps are loaded from disk and uploaded when they are needed
+    std::vector<RawVolumeStreamer::Source> sources;
+    sources.reserve(_volumeTimesteps.size());
+    for (const std::pair<const double, Timestep>& p : _volumeTimesteps) {
+        const Timestep& t = p.second;
         std::string path = FileSys.pathByAppendingComponent(
             _sourceDirectory, t.baseName
         ) + ".rawvolume";
-        RawVolumeReader<float> reader(path, t.metadata.dimensions);
-        t.rawVolume = reader.read();
-
-        float min = t.metadata.minValue;
-        float diff = t.metadata.maxValue - t.metadata.minValue;
-        float* data = t.rawVolume->data();
-        for (size_t i = 0; i < t.rawVolume->nCells(); ++i) {
-            data[i] = glm::clamp((data[i] - min) / diff, 0.f, 1.f);
-        }
-
-        t.histogram = std::make_shared<Histogram>(0.f, 1.f, 100);
-        for (size_t i = 0; i < t.rawVolume->nCells(); ++i) {
-            t.histogram->add(data[i]);
-        }
-
-        // TODO: handle normalization properly for different timesteps + transfer function
-
-        t.texture = std::make_shared<ghoul::opengl::Texture>(
-            t.metadata.dimensions,
-            ghoul::opengl::Texture::Format::Red,
-            GL_RED,
-            GL_FLOAT,
-            ghoul::opengl::Texture::FilterMode::Linear,
-            ghoul::opengl::Texture::WrappingMode::Clamp
-        );
-
-        t.texture->setPixelData(
-            reinterpret_cast<void*>(data),
-            ghoul::opengl::Texture::TakeOwnership::No
-        );
-        t.texture->uploadTexture();
+        sources.push_back({ std::move(path), t.metadata });
     }
+    _streamer = std::make_unique<RawVolumeStreamer>(
+        std::move(sources),
+        static_cast<size_t>(_memoryBudget) * 1024 * 1024
+    );
+
+    // TODO: handle normalization properly for different timesteps + transfer function
 
     _clipPlanes->initialize();
 
@@ -328,6 +359,15 @@ void RenderableTimeVaryingVolume::initializeGL() {
     addProperty(_rNormalization);
     addProperty(_rUpperBound);
     addProperty(_gridType);
+    addProperty(_memoryBudget);
+    addProperty(_nPrefetchTimesteps);
+
+    _memoryBudget.onChange([this] {
+        if (_streamer) {
+            const size_t budget = static_cast<size_t>(_memoryBudget) * 1024 * 1024;
+            _streamer->setMemoryBudget(budget);
+        }
+    });
 
     _raycaster->setGridType(static_cast<VolumeGridType>(_gridType.value()));
     _gridType.onChange([this] {
@@ -355,12 +395,146 @@ void RenderableTimeVaryingVolume::loadTimestepMetadata(const std::string& path)
     Timestep t;
     t.metadata = metadata;
     t.baseName = ghoul::filesystem::File(path).baseName();
-    t.inRam = false;
-    t.onGpu = false;
+    t.metadataPath = path;
+    if (t.metadata.hasHistogram) {
+        t.histogram = createHistogram(t.metadata.histogram);
+    }
 
     _volumeTimesteps[t.metadata.time] = std::move(t);
 }
 
+void RenderableTimeVaryingVolume::saveTimestepMetadata(const Timestep& t) {
+    // Finished writes are removed so that the list does not grow without bounds
+    _metadataWrites.erase(
+        std::remove_if(
+            _metadataWrites.begin(),
+            _metadataWrites.end(),
+            [](const std::future<void>& f) {
+                return f.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+            }
+        ),
+        _metadataWrites.end()
+    );
+
+    // Formatting and writing the file is done on a separate thread as this function is
+    // called from the render thread
+    _metadataWrites.push_back(std::async(
+        std::launch::async,
+        [metadata = t.metadata, path = t.metadataPath]() {
+            ghoul::DictionaryLuaFormatter formatter;
+            std::string metadataString = formatter.format(metadata.dictionary());
+
+            std::ofstream file(path);
+            if (!file.good()) {
+                // The data directory might be read-only, in which case the histogram is
+                // just recomputed the next time the timestep is loaded
+                LDEBUG(fmt::format("Could not write metadata to '{}'", path));
+                return;
+            }
+            file << "return " << metadataString;
+        }
+    ));
+}
+
+void RenderableTimeVaryingVolume::updateStreaming() {
+    ++_nUpdates;
+
+    const double deltaTime = global::timeManager.deltaTime();
+    if (deltaTime != 0.0) {
+        _timeDirection = deltaTime > 0.0 ? 1 : -1;
+    }
+
+    std::vector<int> indices;
+    if (_currentTimestep >= 0) {
+        const int nTimesteps = static_cast<int>(_volumeTimesteps.size());
+        for (int i = 0; i <= _nPrefetchTimesteps; ++i) {
+            const int index = _currentTimestep + i * _timeDirection;
+            if (index < 0 || index >= nTimesteps) {
+                break;
+            }
+            indices.push_back(index);
+        }
+    }
+    _streamer->request(indices);
+
+    // The current timestep is uploaded as soon as it is loaded, but only one of the
+    // prefetched timesteps is uploaded per frame to spread out the cost of the uploads
+    bool hasUploadedPrefetched = false;
+    for (int index : indices) {
+        Timestep& t = *timestepFromIndex(index);
+        t.lastRequest = _nUpdates;
+        if (t.texture || (index != _currentTimestep && hasUploadedPrefetched)) {
+            continue;
+        }
+
+        std::shared_ptr<const RawVolumeStreamer::Volume> volume = _streamer->volume(
+            index
+        );
+        if (volume) {
+            uploadTimestep(t, *volume);
+            hasUploadedPrefetched |= (index != _currentTimestep);
+        }
+    }
+
+    evictTextures();
+}
+
+void RenderableTimeVaryingVolume::uploadTimestep(Timestep& t,
+                                              const RawVolumeStreamer::Volume& volume)
+{
+    t.texture = std::make_shared<ghoul::opengl::Texture>(
+        t.metadata.dimensions,
+        ghoul::opengl::Texture::Format::Red,
+        GL_RED,
+        GL_FLOAT,
+        ghoul::opengl::Texture::FilterMode::Linear,
+        ghoul::opengl::Texture::WrappingMode::Clamp
+    );
+
+    t.texture->setPixelData(
+        const_cast<float*>(volume.rawVolume->data()),
+        ghoul::opengl::Texture::TakeOwnership::No
+    );
+    t.texture->uploadTexture();
+    // The voxel data belongs to the streamer and is freed when the timestep is evicted
+    t.texture->setPixelData(nullptr, ghoul::opengl::Texture::TakeOwnership::No);
+    _textureMemory += volume.rawVolume->nCells() * sizeof(float);
+
+    if (!t.histogram) {
+        t.histogram = createHistogram(volume.histogram);
+    }
+    if (volume.isHistogramNew && !t.metadata.hasHistogram) {
+        // Store the histogram so that it does not have to be built the next time
+        t.metadata.hasHistogram = true;
+        t.metadata.histogram = volume.histogram;
+        saveTimestepMetadata(t);
+    }
+}
+
+void RenderableTimeVaryingVolume::evictTextures() {
+    const size_t budget = static_cast<size_t>(_memoryBudget) * 1024 * 1024;
+    while (_textureMemory > budget) {
+        Timestep* victim = nullptr;
+        for (std::pair<const double, Timestep>& p : _volumeTimesteps) {
+            Timestep& t = p.second;
+            if (!t.texture || t.lastRequest == _nUpdates || &t == _shownTimestep) {
+                continue;
+            }
+            if (!victim || t.lastRequest < victim->lastRequest) {
+                victim = &t;
+            }
+        }
+        if (!victim) {
+            return;
+        }
+
+        const glm::uvec3 dims = victim->metadata.dimensions;
+        _textureMemory -= static_cast<size_t>(dims.x) * static_cast<size_t>(dims.y) *
+            static_cast<size_t>(dims.z) * sizeof(float);
+        victim->texture = nullptr;
+    }
+}
+
 RenderableTimeVaryingVolume::Timestep* RenderableTimeVaryingVolume::currentTimestep() {
     if (_volumeTimesteps.empty()) {
         return nullptr;
@@ -434,8 +608,15 @@ void RenderableTimeVaryingVolume::update(const UpdateData&) {
     _transferFunction->update();
 
     if (_raycaster) {
-        Timestep* t = currentTimestep();
-        _currentTimestep = timestepIndex(t);
+        Timestep* current = currentTimestep();
+        _currentTimestep = timestepIndex(current);
+        updateStreaming();
+
+        // Keep showing the previous timestep until the current one has been loaded
+        if (!current || current->texture) {
+            _shownTimestep = current;
+        }
+        Timestep* t = _shownTimestep;
 
         // Set scale and translation matrices:
         // The original data cube is a unit cube centered in 0
@@ -451,7 +632,8 @@ void RenderableTimeVaryingVolume::update(const UpdateData&) {
                 glm::dmat4 scaleMatrix = glm::scale(glm::dmat4(1.0), scale);
                 modelTransform = modelTransform * scaleMatrix;
                 _raycaster->setModelTransform(glm::mat4(modelTransform));
-            } else {
+            }
+            else {
                 // The diameter is two times the maximum radius.
                 // No translation: the sphere is always centered in (0, 0, 0)
                 _raycaster->setModelTransform(
@@ -462,7 +644,8 @@ void RenderableTimeVaryingVolume::update(const UpdateData&) {
                 );
             }
             _raycaster->setVolumeTexture(t->texture);
-        } else {
+        }
+        else {
             _raycaster->setVolumeTexture(nullptr);
         }
         _raycaster->setStepSize(_stepSize);
@@ -487,6 +670,17 @@ void RenderableTimeVaryingVolume::deinitializeGL() {
         global::raycasterManager.detachRaycaster(*_raycaster.get());
         _raycaster = nullptr;
     }
+
+    _streamer = nullptr;
+    for (std::future<void>& f : _metadataWrites) {
+        f.wait();
+    }
+    _metadataWrites.clear();
+    for (std::pair<const double, Timestep>& p : _volumeTimesteps) {
+        p.second.texture = nullptr;
+    }
+    _shownTimestep = nullptr;
+    _textureMemory = 0;
 }
 
 } // namespace openspace::volume
@@ -31,7 +31,8 @@
 #include <openspace/properties/stringproperty.h>
 #include <openspace/properties/triggerproperty.h>
 // #include <modules/volume/rawvolume.h>
- #include <modules/volume/rawvolumemetadata.h>
+#include <modules/volume/rawvolumemetadata.h>
+#include <modules/volume/rawvolumestreamer.h>
 // #include <modules/volume/rendering/basicvolumeraycaster.h>
 // #include <modules/volume/rendering/volumeclipplanes.h>
 
@@ -41,6 +42,8 @@
 // #include <openspace/util/boxgeometry.h>
 // #include <openspace/util/histogram.h>
 // #include <openspace/rendering/transferfunction.h>
+#include <future>
+#include <vector>
 
 namespace openspace {
     class Histogram;
@@ -70,12 +73,15 @@ public:
 private:
     struct Timestep {
         std::string baseName;
-        bool inRam;
-        bool onGpu;
+        // Path to the .dictionary file that contains the metadata
+        std::string metadataPath;
         RawVolumeMetadata metadata;
-        std::shared_ptr<RawVolume<float>> rawVolume;
+        // The texture is only created when the timestep is needed and is destroyed
+        // again when it has not been needed for a while
         std::shared_ptr<ghoul::opengl::Texture> texture;
         std::shared_ptr<Histogram> histogram;
+        // The value of _nUpdates when the timestep was last requested
+        size_t lastRequest = 0;
     };
 
     Timestep* currentTimestep();
@@ -84,6 +90,16 @@ private:
     void jumpToTimestep(int i);
 
     void loadTimestepMetadata(const std::string& path);
+    // Writes the metadata of the timestep to its .dictionary file in the background
+    void saveTimestepMetadata(const Timestep& t);
+
+    // Requests the current and the following timesteps from the streamer and uploads
+    // the ones that have been loaded
+    void updateStreaming();
+    void uploadTimestep(Timestep& t, const RawVolumeStreamer::Volume& volume);
+    // Destroys the textures of the timesteps that are not requested, starting with the
+    // one that was requested longest ago, until the textures fit into the budget
+    void evictTextures();
 
     properties::OptionProperty _gridType;
     std::shared_ptr<VolumeClipPlanes> _clipPlanes;
@@ -99,10 +115,24 @@ private:
     properties::TriggerProperty _triggerTimeJump;
     properties::IntProperty _jumpToTimestep;
     properties::IntProperty _currentTimestep;
+    properties::IntProperty _memoryBudget;
+    properties::IntProperty _nPrefetchTimesteps;
 
     std::map<double, Timestep> _volumeTimesteps;
+    std::unique_ptr<RawVolumeStreamer> _streamer;
+    // The metadata files that are being written in the background
+    std::vector<std::future<void>> _metadataWrites;
     std::unique_ptr<BasicVolumeRaycaster> _raycaster;
 
+    // The timestep whose texture is rendered. This is the previous timestep while the
+    // current one is being loaded
+    Timestep* _shownTimestep = nullptr;
+    // +1 if simulation time runs forward, -1 if it runs backwards
+    int _timeDirection = 1;
+    size_t _nUpdates = 0;
+    // The number of bytes used by the textures of all timesteps
+    size_t _textureMemory = 0;
+
     std::shared_ptr<openspace::TransferFunction> _transferFunction;
 };
 
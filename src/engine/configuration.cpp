@@ -62,6 +62,7 @@ namespace {
     constexpr const char* KeyPerSceneCache = "PerSceneCache";
     constexpr const char* KeyOnScreenTextScaling = "OnScreenTextScaling";
     constexpr const char* KeyRenderingMethod = "RenderingMethod";
+    constexpr const char* KeySyncProtocol = "SyncProtocol";
     constexpr const char* KeyDisableRenderingOnMaster = "DisableRenderingOnMaster";
     constexpr const char* KeyDisableSceneOnMaster = "DisableSceneOnMaster";
     constexpr const char* KeyDisableInGameConsole = "DisableInGameConsole";
@@ -84,6 +85,7 @@ namespace {
     constexpr const char* KeyLogEachOpenGLCall = "LogEachOpenGLCall";
     constexpr const char* KeyUseMultithreadedInitialization =
                                                          "UseMultithreadedInitialization";
+    constexpr const char* KeyStartupTrace = "StartupTrace";
     constexpr const char* KeyLoadingScreen = "LoadingScreen";
     constexpr const char* KeyShowMessage = "ShowMessage";
     constexpr const char* KeyShowNodeNames = "ShowNodeNames";
@@ -281,6 +283,7 @@ void parseLuaState(Configuration& configuration) {
     getValue(s, KeyFonts, c.fonts);
     getValue(s, KeyScriptLog, c.scriptLog);
     getValue(s, KeyUseMultithreadedInitialization, c.useMultithreadedInitialization);
+    getValue(s, KeyStartupTrace, c.startupTrace);
     getValue(s, KeyCheckOpenGLState, c.isCheckingOpenGLState);
     getValue(s, KeyLogEachOpenGLCall, c.isLoggingOpenGLCalls);
     getValue(s, KeyShutdownCountdown, c.shutdownCountdown);
@@ -291,6 +294,7 @@ void parseLuaState(Configuration& configuration) {
     getValue(s, KeyDisableSceneOnMaster, c.isSceneTranslationOnMasterDisabled);
     getValue(s, KeyDisableInGameConsole, c.isConsoleDisabled);
     getValue(s, KeyRenderingMethod, c.renderingMethod);
+    getValue(s, KeySyncProtocol, c.syncProtocol);
 
     getValue(s, KeyLogging, c.logging);
     getValue(s, KeyDocumentation, c.documentation);
@@ -248,6 +248,19 @@ documentation::Documentation Configuration::Documentation = {
             "The renderer that is use after startup. The renderer 'ABuffer' requires "
             "support for at least OpenGL 4.3"
         },
+        {
+            KeySyncProtocol,
+            new StringInListVerifier(
+                // List from OpenSpaceEngine::initialize
+                { "Full", "Delta", "DeltaCompressed" }
+            ),
+            Optional::Yes,
+            "The protocol that the master uses to synchronize the state with the other "
+            "nodes in a cluster. 'Full' sends the entire state every frame, 'Delta' only "
+            "sends the parts that have changed since the previous frame, and "
+            "'DeltaCompressed' additionally compresses each frame. This value defaults "
+            "to 'Full'."
+        },
         {
             KeyDisableRenderingOnMaster,
             new BoolVerifier,
@@ -423,6 +436,17 @@ documentation::Documentation Configuration::Documentation = {
             "initialize in parallel. The only use for this value is to disable it for "
             "debugging support."
         },
+        {
+            KeyStartupTrace,
+            new StringVerifier,
+            Optional::Yes,
+            "If this value is specified, the loading of assets, the synchronizations, and "
+            "the initialization of all scene graph nodes during startup are timed. When "
+            "the scene has finished loading, the timings are written to this file in the "
+            "Chrome trace event format, which can be opened in 'chrome://tracing' or the "
+            "Perfetto UI. Any previous file in this location will be silently "
+            "overwritten."
+        },
         {
             KeyLoadingScreen,
             new TableVerifier({
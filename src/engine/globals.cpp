@@ -48,11 +48,15 @@
 #include <openspace/rendering/screenspacerenderable.h>
 #include <openspace/scripting/scriptengine.h>
 #include <openspace/scripting/scriptscheduler.h>
+#include <openspace/util/startuptrace.h>
 #include <openspace/util/timemanager.h>
+#include <openspace/util/workstealingthreadpool.h>
 #include <ghoul/glm.h>
 #include <ghoul/font/fontmanager.h>
 #include <ghoul/misc/sharedmemory.h>
 #include <ghoul/opengl/texture.h>
+#include <algorithm>
+#include <thread>
 
 namespace openspace::global {
 
@@ -118,6 +122,11 @@ std::vector<std::unique_ptr<ScreenSpaceRenderable>>& gScreenspaceRenderables() {
     return g;
 }
 
+StartupTrace& gStartupTrace() {
+    static StartupTrace g;
+    return g;
+}
+
 SyncEngine& gSyncEngine() {
     static SyncEngine g(4096);
     return g;
@@ -138,6 +147,14 @@ WindowDelegate& gWindowDelegate() {
     return g;
 }
 
+WorkStealingThreadPool& gThreadPool() {
+    // The thread that uses the pool helps with the work while it waits, so one core is
+    // left for it
+    const unsigned int nThreads = std::max(std::thread::hardware_concurrency(), 2u);
+    static WorkStealingThreadPool g(nThreads - 1);
+    return g;
+}
+
 configuration::Configuration& gConfiguration() {
     static configuration::Configuration g;
     return g;
@@ -63,6 +63,7 @@
 #include <openspace/util/camera.h>
 #include <openspace/util/factorymanager.h>
 #include <openspace/util/spicemanager.h>
+#include <openspace/util/startuptrace.h>
 #include <openspace/util/task.h>
 #include <openspace/util/timemanager.h>
 #include <openspace/util/transformationmanager.h>
@@ -185,6 +186,9 @@ void OpenSpaceEngine::initialize() {
 
     global::initialize();
 
+    if (!global::configuration.startupTrace.empty()) {
+        global::startupTrace.setEnabled(true);
+    }
 
     std::string cacheFolder = absPath("${CACHE}");
     if (global::configuration.usePerSceneCache) {
@@ -320,6 +324,13 @@ void OpenSpaceEngine::initialize() {
 
     _shutdown.waitTime = global::configuration.shutdownCountdown;
 
+    if (global::configuration.syncProtocol == "Delta") {
+        global::syncEngine.setProtocol(SyncEngine::Protocol::Delta);
+    }
+    else if (global::configuration.syncProtocol == "DeltaCompressed") {
+        global::syncEngine.setProtocol(SyncEngine::Protocol::DeltaCompressed);
+    }
+
     global::navigationHandler.initialize();
 
     global::renderEngine.initialize();
@@ -336,6 +347,11 @@ void OpenSpaceEngine::initialize() {
 
 void OpenSpaceEngine::initializeGL() {
     LTRACE("OpenSpaceEngine::initializeGL(begin)");
+    StartupTrace::Scope traceScope(
+        global::startupTrace,
+        "Engine",
+        "OpenSpaceEngine::initializeGL"
+    );
 
     glbinding::Binding::initialize(global::windowDelegate.openGLProcedureAddress);
     //glbinding::Binding::useCurrentContext();
@@ -668,7 +684,11 @@ void OpenSpaceEngine::loadSingleAsset(const std::string& assetPath) {
     _loadingScreen->setPhase(LoadingScreen::Phase::Construction);
     _loadingScreen->postMessage("Loading assets");
 
-    _assetManager->update();
+    {
+        StartupTrace::Scope traceScope(global::startupTrace, "Engine", "Load assets");
+        _assetManager->update();
+    }
+    const auto syncBeginTime = StartupTrace::Clock::now();
 
     _loadingScreen->setPhase(LoadingScreen::Phase::Synchronization);
     _loadingScreen->postMessage("Synchronizing assets");
@@ -742,15 +762,36 @@ void OpenSpaceEngine::loadSingleAsset(const std::string& assetPath) {
             }
         }
     }
+    global::startupTrace.addEvent(
+        "Engine",
+        "Synchronize assets",
+        syncBeginTime,
+        StartupTrace::Clock::now()
+    );
 
     _loadingScreen->setPhase(LoadingScreen::Phase::Initialization);
 
     _loadingScreen->postMessage("Initializing scene");
-    while (_scene->isInitializing()) {
-        _loadingScreen->render();
+    {
+        StartupTrace::Scope traceScope(
+            global::startupTrace,
+            "Engine",
+            "Initialize scene"
+        );
+        // The OpenGL initialization of the nodes that have been initialized is
+        // interleaved with the initialization of the remaining nodes on the thread pool
+        while (true) {
+            const bool isInitializing = _scene->isInitializing();
+            _loadingScreen->render();
+            _scene->initializeGLPendingNodes();
+            // If no node was initializing before the pending nodes were taken, all nodes
+            // have been passed on to their OpenGL initialization
+            if (!isInitializing && !_scene->hasPendingGLNodes()) {
+                break;
+            }
+        }
     }
 
-    _loadingScreen->postMessage("Initializing OpenGL");
     _loadingScreen->finalize();
 
     _loadingScreen = nullptr;
@@ -773,6 +814,20 @@ void OpenSpaceEngine::loadSingleAsset(const std::string& assetPath) {
 
     writeSceneDocumentation();
 
+    if (global::startupTrace.isEnabled()) {
+        const std::string path = absPath(global::configuration.startupTrace);
+        try {
+            global::startupTrace.writeToFile(path);
+            LINFO(fmt::format("Wrote startup trace to '{}'", path));
+        }
+        catch (const ghoul::RuntimeError& e) {
+            LERRORC(e.component, e.message);
+        }
+        // Assets that are loaded later are not part of the startup
+        global::startupTrace.setEnabled(false);
+        global::startupTrace.clear();
+    }
+
     LTRACE("OpenSpaceEngine::loadSingleAsset(end)");
 }
 
@@ -1243,13 +1298,25 @@ void OpenSpaceEngine::mouseScrollWheelCallback(double posX, double posY) {
     global::navigationHandler.mouseScrollWheelCallback(posY);
 }
 
-std::vector<char> OpenSpaceEngine::encode() {
-    std::vector<char> buffer = global::syncEngine.encodeSyncables();
+const std::vector<char>& OpenSpaceEngine::encode() {
+    const std::vector<char>& buffer = global::syncEngine.encodeSyncables();
+    if (global::performanceManager.isEnabled()) {
+        global::performanceManager.storeIndividualValue(
+            "OpenSpaceEngine::encode (bytes)",
+            static_cast<float>(buffer.size())
+        );
+    }
     return buffer;
 }
 
-void OpenSpaceEngine::decode(std::vector<char> data) {
-    global::syncEngine.decodeSyncables(std::move(data));
+void OpenSpaceEngine::decode(const std::vector<char>& data) {
+    global::syncEngine.decodeSyncables(data);
+    if (global::performanceManager.isEnabled()) {
+        global::performanceManager.storeIndividualValue(
+            "OpenSpaceEngine::decode (bytes)",
+            static_cast<float>(data.size())
+        );
+    }
 }
 
 void OpenSpaceEngine::toggleShutdownMode() {
@@ -25,8 +25,28 @@
 #include <openspace/engine/syncengine.h>
 
 #include <openspace/util/syncdata.h>
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
 #include <ghoul/misc/assert.h>
 #include <algorithm>
+#include <cstring>
+#include <lz4.h>
+
+namespace {
+    constexpr const char* _loggerCat = "SyncEngine";
+
+    constexpr const uint8_t FlagKeyFrame = 1 << 0;
+    constexpr const uint8_t FlagCompressed = 1 << 1;
+
+    // Frames smaller than this are sent uncompressed even if compression is requested
+    constexpr const size_t MinimumCompressionSize = 256;
+
+    // Layout of a frame: flags (uint8), then the number of Syncables (uint16), a bitmask
+    // of the Syncables that are contained in the frame and finally the Syncables in the
+    // order they were added. If the frame is compressed, the flags are followed by the
+    // uncompressed size (uint32) and the LZ4-compressed remainder of the frame
+    constexpr const size_t CompressedHeaderSize = sizeof(uint8_t) + sizeof(uint32_t);
+} // namespace
 
 namespace openspace {
 
@@ -37,26 +57,152 @@ SyncEngine::SyncEngine(unsigned int syncBufferSize)
 }
 
 // Should be called on sgct master
-std::vector<char> SyncEngine::encodeSyncables() {
-    for (Syncable* syncable : _syncables) {
-        syncable->encode(&_syncBuffer);
+const std::vector<char>& SyncEngine::encodeSyncables() {
+    _syncBuffer.reset();
+
+    const bool isKeyFrame = _protocol == Protocol::Full || _needsKeyFrame ||
+                            _framesSinceKeyFrame + 1 >= _keyFrameInterval;
+    _framesSinceKeyFrame = isKeyFrame ? 0 : _framesSinceKeyFrame + 1;
+    _needsKeyFrame = false;
+
+    _syncBuffer.encode(isKeyFrame ? FlagKeyFrame : uint8_t(0));
+    _syncBuffer.encode(static_cast<uint16_t>(_syncables.size()));
+
+    // Build the bitmask of all Syncables that are part of this frame before encoding
+    // them, as checking for changes has to happen before the encoding resets them
+    std::vector<bool> isIncluded(_syncables.size());
+    for (size_t i = 0; i < _syncables.size(); ++i) {
+        isIncluded[i] = isKeyFrame || _syncables[i]->hasChanged();
+    }
+    for (size_t i = 0; i < _syncables.size(); i += 8) {
+        uint8_t mask = 0;
+        for (size_t j = i; j < std::min(i + 8, _syncables.size()); ++j) {
+            mask |= static_cast<uint8_t>(isIncluded[j] ? 1 << (j - i) : 0);
+        }
+        _syncBuffer.encode(mask);
     }
 
-    std::vector<char> data = _syncBuffer.data();
-    _syncBuffer.reset();
-    return data;
+    for (size_t i = 0; i < _syncables.size(); ++i) {
+        if (isIncluded[i]) {
+            _syncables[i]->encode(&_syncBuffer);
+        }
+    }
+
+    const std::vector<char>& frame = _syncBuffer.data();
+    if (_protocol != Protocol::DeltaCompressed || frame.size() < MinimumCompressionSize)
+    {
+        return frame;
+    }
+
+    // Compress everything but the flags
+    const int srcSize = static_cast<int>(frame.size() - sizeof(uint8_t));
+    _compressionBuffer.resize(CompressedHeaderSize + LZ4_compressBound(srcSize));
+    const int compressedSize = LZ4_compress_default(
+        frame.data() + sizeof(uint8_t),
+        _compressionBuffer.data() + CompressedHeaderSize,
+        srcSize,
+        static_cast<int>(_compressionBuffer.size() - CompressedHeaderSize)
+    );
+    if (compressedSize <= 0 ||
+        CompressedHeaderSize + compressedSize >= frame.size())
+    {
+        // Not worth it
+        return frame;
+    }
+
+    const uint8_t flags = static_cast<uint8_t>(frame[0]) | FlagCompressed;
+    const uint32_t uncompressedSize = static_cast<uint32_t>(srcSize);
+    std::memcpy(_compressionBuffer.data(), &flags, sizeof(uint8_t));
+    std::memcpy(
+        _compressionBuffer.data() + sizeof(uint8_t),
+        &uncompressedSize,
+        sizeof(uint32_t)
+    );
+    _compressionBuffer.resize(CompressedHeaderSize + compressedSize);
+    return _compressionBuffer;
 }
 
 // Should be called on sgct slaves
-void SyncEngine::decodeSyncables(std::vector<char> data) {
-    _syncBuffer.setData(std::move(data));
-    for (Syncable* syncable : _syncables) {
-        syncable->decode(&_syncBuffer);
+void SyncEngine::decodeSyncables(const std::vector<char>& data) {
+    if (data.empty()) {
+        return;
+    }
+
+    uint8_t flags;
+    std::memcpy(&flags, data.data(), sizeof(uint8_t));
+
+    if (flags & FlagCompressed) {
+        uint32_t uncompressedSize;
+        std::memcpy(&uncompressedSize, data.data() + sizeof(uint8_t), sizeof(uint32_t));
+
+        // Restore the flags in front of the decompressed remainder of the frame
+        _compressionBuffer.resize(sizeof(uint8_t) + uncompressedSize);
+        _compressionBuffer[0] = static_cast<char>(flags & ~FlagCompressed);
+        const int res = LZ4_decompress_safe(
+            data.data() + CompressedHeaderSize,
+            _compressionBuffer.data() + sizeof(uint8_t),
+            static_cast<int>(data.size() - CompressedHeaderSize),
+            static_cast<int>(uncompressedSize)
+        );
+        if (res != static_cast<int>(uncompressedSize)) {
+            LERROR("Could not decompress synchronization frame");
+            _hasDecodedKeyFrame = false;
+            return;
+        }
+        _syncBuffer.setData(_compressionBuffer.data(), _compressionBuffer.size());
+    }
+    else {
+        _syncBuffer.setData(data.data(), data.size());
+    }
+
+    _syncBuffer.decode<uint8_t>();
+    const uint16_t nSyncables = _syncBuffer.decode<uint16_t>();
+    if (nSyncables != _syncables.size()) {
+        // The frame can't be parsed as we don't know where each Syncable ends. The
+        // master will send a key frame as soon as its set of Syncables has changed
+        LERROR(fmt::format(
+            "Received {} Syncables, but {} are registered", nSyncables, _syncables.size()
+        ));
+        _hasDecodedKeyFrame = false;
+        _syncBuffer.reset();
+        return;
+    }
+
+    // A delta frame is only meaningful if all previous changes have been applied
+    const bool isKeyFrame = flags & FlagKeyFrame;
+    if (!isKeyFrame && !_hasDecodedKeyFrame) {
+        _syncBuffer.reset();
+        return;
+    }
+    _hasDecodedKeyFrame = true;
+
+    std::vector<bool> isIncluded(_syncables.size());
+    for (size_t i = 0; i < _syncables.size(); i += 8) {
+        const uint8_t mask = _syncBuffer.decode<uint8_t>();
+        for (size_t j = i; j < std::min(i + 8, _syncables.size()); ++j) {
+            isIncluded[j] = ((mask >> (j - i)) & 1) != 0;
+        }
+    }
+
+    for (size_t i = 0; i < _syncables.size(); ++i) {
+        if (isIncluded[i]) {
+            _syncables[i]->decode(&_syncBuffer);
+        }
     }
 
     _syncBuffer.reset();
 }
 
+void SyncEngine::setProtocol(Protocol protocol) {
+    _protocol = protocol;
+    _needsKeyFrame = true;
+}
+
+void SyncEngine::setKeyFrameInterval(unsigned int interval) {
+    ghoul_assert(interval > 0, "interval must be bigger than 0");
+    _keyFrameInterval = interval;
+}
+
 void SyncEngine::preSynchronization(IsMaster isMaster) {
     for (Syncable* syncable : _syncables) {
         syncable->preSync(isMaster);
@@ -73,6 +219,7 @@ void SyncEngine::addSyncable(Syncable* syncable) {
     ghoul_assert(syncable, "Syncable must not be nullptr");
 
     _syncables.push_back(syncable);
+    _needsKeyFrame = true;
 }
 
 void SyncEngine::addSyncables(const std::vector<Syncable*>& syncables) {
@@ -87,6 +234,7 @@ void SyncEngine::removeSyncable(Syncable* syncable) {
         std::remove(_syncables.begin(), _syncables.end(), syncable),
         _syncables.end()
     );
+    _needsKeyFrame = true;
 }
 
 void SyncEngine::removeSyncables(const std::vector<Syncable*>& syncables) {
@@ -48,10 +48,21 @@
 
 #include <openspace/rendering/renderengine.h>
 
+#include <algorithm>
 #include <iterator>
 
 namespace {
     constexpr const char* _loggerCat = "SessionRecording";
+
+    // Number of keyframes between two entries in the index of a binary recording
+    constexpr const uint64_t IndexInterval = 64;
+
+    // The index footer consists of the index entries, followed by the file offset of
+    // the first index entry, the number of entries and this tag
+    constexpr const char IndexFooterTag[] = "OSRECIDX";
+    constexpr const size_t IndexFooterTagLength = sizeof(IndexFooterTag) - 1;
+    constexpr const size_t IndexFooterSize = 2 * sizeof(uint64_t) + IndexFooterTagLength;
+    constexpr const size_t IndexEntrySize = 3 * sizeof(double) + sizeof(uint64_t);
 } // namespace
 
 #include "sessionrecording_lua.inl"
@@ -96,30 +107,119 @@ bool SessionRecording::startRecording(const std::string& filename) {
         ));
         return false;
     }
+    writeFileHeader();
+
+    LINFO("Session recording started");
+    _timestampRecordStarted = global::windowDelegate.applicationTime();
+    return true;
+}
+
+void SessionRecording::writeFileHeader() {
     _recordFile << _fileHeaderTitle;
-    _recordFile.write(_fileHeaderVersion, _fileHeaderVersionLength);
     if (isDataModeBinary()) {
+        _recordFile.write(_fileHeaderVersionIndexed, _fileHeaderVersionLength);
         _recordFile << dataFormatBinaryTag;
     }
     else {
+        _recordFile.write(_fileHeaderVersion, _fileHeaderVersionLength);
         _recordFile << dataFormatAsciiTag;
     }
     _recordFile << '\n';
 
-    LINFO("Session recording started");
-    _timestampRecordStarted = global::windowDelegate.applicationTime();
-    return true;
+    _recordIndex.clear();
+    _nRecordedKeyframes = 0;
 }
 
 void SessionRecording::stopRecording() {
     if (_state == SessionState::Recording) {
         _state = SessionState::Idle;
+        if (isDataModeBinary()) {
+            writeIndexFooter();
+        }
         LINFO("Session recording stopped");
     }
     //Close the recording file
     _recordFile.close();
 }
 
+void SessionRecording::addRecordIndexEntry(double timeOs, double timeRec, double timeSim)
+{
+    if (_nRecordedKeyframes % IndexInterval == 0) {
+        _recordIndex.push_back({
+            timeOs,
+            timeRec,
+            timeSim,
+            static_cast<uint64_t>(_recordFile.tellp())
+        });
+    }
+    _nRecordedKeyframes++;
+}
+
+void SessionRecording::writeIndexFooter() {
+    const uint64_t indexOffset = static_cast<uint64_t>(_recordFile.tellp());
+    for (const IndexEntry& e : _recordIndex) {
+        _recordFile.write(reinterpret_cast<const char*>(&e.timeOs), sizeof(double));
+        _recordFile.write(reinterpret_cast<const char*>(&e.timeRec), sizeof(double));
+        _recordFile.write(reinterpret_cast<const char*>(&e.timeSim), sizeof(double));
+        _recordFile.write(
+            reinterpret_cast<const char*>(&e.fileOffset),
+            sizeof(uint64_t)
+        );
+    }
+    const uint64_t nEntries = _recordIndex.size();
+    _recordFile.write(reinterpret_cast<const char*>(&indexOffset), sizeof(uint64_t));
+    _recordFile.write(reinterpret_cast<const char*>(&nEntries), sizeof(uint64_t));
+    _recordFile.write(IndexFooterTag, IndexFooterTagLength);
+    _recordIndex.clear();
+}
+
+bool SessionRecording::readIndexFooter() {
+    // The playback file is left at the first keyframe, regardless of whether an index
+    // was found or not
+    const std::streampos firstKeyframePosition = _playbackFile.tellg();
+    _playbackIndex.clear();
+    _playbackIndexOffset = 0;
+
+    _playbackFile.clear();
+    _playbackFile.seekg(0, std::ios::end);
+    const uint64_t fileSize = static_cast<uint64_t>(_playbackFile.tellg());
+    if (fileSize < IndexFooterSize) {
+        _playbackFile.seekg(firstKeyframePosition);
+        return false;
+    }
+
+    uint64_t indexOffset = 0;
+    uint64_t nEntries = 0;
+    char tag[IndexFooterTagLength];
+    _playbackFile.seekg(fileSize - IndexFooterSize);
+    _playbackFile.read(reinterpret_cast<char*>(&indexOffset), sizeof(uint64_t));
+    _playbackFile.read(reinterpret_cast<char*>(&nEntries), sizeof(uint64_t));
+    _playbackFile.read(tag, IndexFooterTagLength);
+    const bool isValid = _playbackFile &&
+        std::equal(tag, tag + IndexFooterTagLength, IndexFooterTag) &&
+        indexOffset + nEntries * IndexEntrySize + IndexFooterSize == fileSize;
+    if (!isValid) {
+        // The recording was probably not stopped properly
+        _playbackFile.clear();
+        _playbackFile.seekg(firstKeyframePosition);
+        return false;
+    }
+
+    _playbackIndex.resize(nEntries);
+    _playbackFile.seekg(indexOffset);
+    for (IndexEntry& e : _playbackIndex) {
+        _playbackFile.read(reinterpret_cast<char*>(&e.timeOs), sizeof(double));
+        _playbackFile.read(reinterpret_cast<char*>(&e.timeRec), sizeof(double));
+        _playbackFile.read(reinterpret_cast<char*>(&e.timeSim), sizeof(double));
+        _playbackFile.read(reinterpret_cast<char*>(&e.fileOffset), sizeof(uint64_t));
+    }
+    _playbackIndexOffset = indexOffset;
+    const bool success = static_cast<bool>(_playbackFile);
+    _playbackFile.clear();
+    _playbackFile.seekg(firstKeyframePosition);
+    return success;
+}
+
 bool SessionRecording::startPlayback(const std::string& filename,
                                      KeyframeTimeRef timeMode, bool forceSimTimeAtStart)
 {
@@ -139,14 +239,80 @@ bool SessionRecording::startPlayback(const std::string& filename,
         }
     }
 
-    if (!FileSys.fileExists(absFilename)) {
-        LERROR("Cannot find the specified playback file.");
+    if (!openPlaybackFile(absFilename)) {
+        stopPlayback();
+        cleanUpPlayback();
+        return false;
+    }
+
+    //Set time reference mode
+    double now = global::windowDelegate.applicationTime();
+    _timestampPlaybackStarted_application = now;
+    _timestampPlaybackStarted_simulation = global::timeManager.time().j2000Seconds();
+    _timestampApplicationStarted_simulation = _timestampPlaybackStarted_simulation - now;
+    _playbackTimeReferenceMode = timeMode;
+    _playbackSeekOffset = 0.0;
+
+    //Set playback flags to true for all modes
+    _playbackActive_camera = true;
+    _playbackActive_script = true;
+    if (_usingTimeKeyframes) {
+        _playbackActive_time = true;
+    }
+
+    global::navigationHandler.keyframeNavigator().setTimeReferenceMode(timeMode, now);
+    global::scriptScheduler.setTimeReferenceMode(timeMode);
+
+    _setSimulationTimeWithNextCameraKeyframe = forceSimTimeAtStart;
+
+    // Indexed recordings are streamed during the playback, all others are read into
+    // memory completely before it starts
+    _isStreamingPlayback = !_playbackIndex.empty();
+    if (_isStreamingPlayback) {
+        _nextBlockToStream = 0;
+        streamKeyframes();
+    }
+    else if (!playbackAddEntriesToTimeline()) {
         cleanUpPlayback();
         return false;
     }
 
+    _hasHitEndOfCameraKeyframes = false;
+    findFirstCameraKeyframeInTimeline();
+
+    if (_isStreamingPlayback) {
+        LINFO(fmt::format(
+            "Playback session started: ({:8.3f},0.0,{:13.3f}) streaming {} index "
+            "blocks, forceTime={}",
+            now, _timestampPlaybackStarted_simulation, _playbackIndex.size(),
+            (forceSimTimeAtStart ? 1 : 0)
+        ));
+    }
+    else {
+        LINFO(fmt::format(
+            "Playback session started: ({:8.3f},0.0,{:13.3f}) with {}/{}/{} entries, "
+            "forceTime={}",
+            now, _timestampPlaybackStarted_simulation, _keyframesCamera.size(),
+            _keyframesTime.size(), _keyframesScript.size(), (forceSimTimeAtStart ? 1 : 0)
+        ));
+    }
+
+    global::navigationHandler.triggerPlaybackStart();
+    global::scriptScheduler.triggerPlaybackStart();
+    global::timeManager.triggerPlaybackStart();
+    _state = SessionState::Playback;
+
+    return true;
+}
+
+bool SessionRecording::openPlaybackFile(const std::string& filename) {
+    if (!FileSys.fileExists(filename)) {
+        LERROR("Cannot find the specified playback file.");
+        return false;
+    }
+
     _playbackLineNum = 1;
-    _playbackFilename = absFilename;
+    _playbackFilename = filename;
 
     //Open in ASCII first
     _playbackFile.open(_playbackFilename, std::ifstream::in);
@@ -154,10 +320,9 @@ bool SessionRecording::startPlayback(const std::string& filename,
     std::string readBackHeaderString = readHeaderElement(_fileHeaderTitle.length());
     if (readBackHeaderString != _fileHeaderTitle) {
         LERROR("Specified playback file does not contain expected header.");
-        cleanUpPlayback();
         return false;
     }
-    readHeaderElement(_fileHeaderVersionLength);
+    _playbackFileVersion = readHeaderElement(_fileHeaderVersionLength);
     std::string readDataMode = readHeaderElement(1);
     if (readDataMode[0] == dataFormatAsciiTag) {
         _recordingDataMode = RecordedDataMode::Ascii;
@@ -167,7 +332,7 @@ bool SessionRecording::startPlayback(const std::string& filename,
     }
     else {
         LERROR("Unknown data type in header (should be Ascii or Binary)");
-        cleanUpPlayback();
+        return false;
     }
     std::string throwawayNewlineChar = readHeaderElement(1);
 
@@ -186,64 +351,298 @@ bool SessionRecording::startPlayback(const std::string& filename,
 
     if (!_playbackFile.is_open() || !_playbackFile.good()) {
         LERROR(fmt::format("Unable to open file {} for keyframe playback",
-            absFilename.c_str()));
-        stopPlayback();
-        cleanUpPlayback();
+            filename.c_str()));
         return false;
     }
-    //Set time reference mode
-    double now = global::windowDelegate.applicationTime();
-    _timestampPlaybackStarted_application = now;
-    _timestampPlaybackStarted_simulation = global::timeManager.time().j2000Seconds();
-    _timestampApplicationStarted_simulation = _timestampPlaybackStarted_simulation - now;
-    _playbackTimeReferenceMode = timeMode;
 
-    //Set playback flags to true for all modes
-    _playbackActive_camera = true;
-    _playbackActive_script = true;
-    if (_usingTimeKeyframes) {
-        _playbackActive_time = true;
+    const bool isIndexedVersion = std::equal(
+        _fileHeaderVersionIndexed,
+        _fileHeaderVersionIndexed + _fileHeaderVersionLength,
+        _playbackFileVersion.begin()
+    );
+    if (isDataModeBinary() && isIndexedVersion && !readIndexFooter()) {
+        LWARNING(fmt::format(
+            "No valid index found in {}, the complete file is read instead", filename
+        ));
     }
+    return true;
+}
 
-    global::navigationHandler.keyframeNavigator().setTimeReferenceMode(timeMode, now);
-    global::scriptScheduler.setTimeReferenceMode(timeMode);
+bool SessionRecording::convertToIndexedFormat(const std::string& inFilename,
+                                              const std::string& outFilename)
+{
+    if (_state != SessionState::Idle) {
+        LERROR("Unable to convert recordings while recording or playing back");
+        return false;
+    }
 
-    _setSimulationTimeWithNextCameraKeyframe = forceSimTimeAtStart;
-    if (!playbackAddEntriesToTimeline()) {
-        cleanUpPlayback();
+    const std::string absInFilename = absPath(inFilename);
+    const std::string absOutFilename = absPath(outFilename);
+    if (!openPlaybackFile(absInFilename)) {
+        _playbackFile.close();
         return false;
     }
 
-    _hasHitEndOfCameraKeyframes = false;
-    findFirstCameraKeyframeInTimeline();
+    _recordFile.open(absOutFilename, std::ios::binary);
+    if (!_recordFile.is_open() || !_recordFile.good()) {
+        LERROR(fmt::format("Unable to open file {} for conversion", absOutFilename));
+        _playbackFile.close();
+        return false;
+    }
+
+    // The keyframes are read in the format of the input file, but always written in
+    // the indexed binary format
+    const RecordedDataMode inputDataMode = _recordingDataMode;
+    _recordingDataMode = RecordedDataMode::Binary;
+    writeFileHeader();
+
+    bool parsingErrorsFound = false;
+    size_t nKeyframes = 0;
+    RecordedKeyframe keyframe;
+    while (true) {
+        _recordingDataMode = inputDataMode;
+        ReadResult res = readNextKeyframe(keyframe);
+        _recordingDataMode = RecordedDataMode::Binary;
+
+        if (res == ReadResult::EndOfFile) {
+            break;
+        }
+        else if (res == ReadResult::Error) {
+            parsingErrorsFound = true;
+            break;
+        }
+        else if (res == ReadResult::Keyframe) {
+            saveKeyframeBinary(keyframe);
+            nKeyframes++;
+        }
+    }
+    writeIndexFooter();
+
+    _recordFile.close();
+    _playbackFile.close();
 
     LINFO(fmt::format(
-        "Playback session started: ({:8.3f},0.0,{:13.3f}) with {}/{}/{} entries, "
-        "forceTime={}",
-        now, _timestampPlaybackStarted_simulation, _keyframesCamera.size(),
-        _keyframesTime.size(), _keyframesScript.size(), (forceSimTimeAtStart ? 1 : 0)
+        "Converted {} keyframes from {} to {}", nKeyframes, absInFilename, absOutFilename
     ));
+    return !parsingErrorsFound;
+}
 
-    global::navigationHandler.triggerPlaybackStart();
-    global::scriptScheduler.triggerPlaybackStart();
-    global::timeManager.triggerPlaybackStart();
-    _state = SessionState::Playback;
+bool SessionRecording::seekPlayback(double time) {
+    if (_state != SessionState::Playback) {
+        LERROR("Unable to seek since no playback is in progress");
+        return false;
+    }
+
+    if (_isStreamingPlayback) {
+        // Find the last index block that starts before the requested time and restart
+        // streaming from it
+        auto it = std::upper_bound(
+            _playbackIndex.begin(),
+            _playbackIndex.end(),
+            time,
+            [this](double t, const IndexEntry& e) {
+                return t < appropriateTimestamp(e.timeOs, e.timeRec, e.timeSim);
+            }
+        );
+        clearTimeline();
+        _nextBlockToStream = (it == _playbackIndex.begin()) ?
+            0 :
+            std::distance(_playbackIndex.begin(), it) - 1;
+
+        while (!hasStreamedAllKeyframes() &&
+               (_timeline.empty() || _timeline.back().timestamp <= time))
+        {
+            streamNextBlock();
+        }
+        findFirstCameraKeyframeInTimeline();
+    }
+
+    auto firstAfter = std::upper_bound(
+        _timeline.begin(),
+        _timeline.end(),
+        time,
+        [](double t, const timelineEntry& e) { return t < e.timestamp; }
+    );
+    if (firstAfter == _timeline.end()) {
+        LINFO("Requested time is after the end of the playback");
+        stopPlayback();
+        return true;
+    }
+
+    // Skip all time and script keyframes before the requested time
+    _idxTimeline_nonCamera = static_cast<unsigned int>(
+        std::distance(_timeline.begin(), firstAfter)
+    );
+
+    // Interpolate the camera from the last camera keyframe before the requested time,
+    // or wait for the first one after it
+    _playbackActive_camera = !_keyframesCamera.empty();
+    _playbackActive_script = true;
+    _playbackActive_time = _usingTimeKeyframes;
+    _hasHitEndOfCameraKeyframes = false;
+    unsigned int cameraIdx = _idxTimeline_cameraFirstInTimeline;
+    for (unsigned int i = cameraIdx; i < _idxTimeline_nonCamera; ++i) {
+        if (doesTimelineEntryContainCamera(i)) {
+            cameraIdx = i;
+        }
+    }
+    _idxTimeline_cameraPtrPrev = cameraIdx;
+    _idxTimeline_cameraPtrNext = cameraIdx;
 
+    if (_playbackTimeReferenceMode == KeyframeTimeRef::Absolute_simTimeJ2000) {
+        global::timeManager.setTimeNextFrame(time);
+    }
+    else {
+        _playbackSeekOffset += time - currentTime();
+    }
+
+    LINFO(fmt::format("Playback moved to {:13.3f}", time));
     return true;
 }
 
+void SessionRecording::streamNextBlock() {
+    ghoul_assert(_nextBlockToStream < _playbackIndex.size(), "No blocks left to stream");
+
+    const uint64_t endOffset = (_nextBlockToStream + 1 < _playbackIndex.size()) ?
+        _playbackIndex[_nextBlockToStream + 1].fileOffset :
+        _playbackIndexOffset;
+
+    _playbackFile.clear();
+    _playbackFile.seekg(_playbackIndex[_nextBlockToStream].fileOffset);
+    _nextBlockToStream++;
+
+    RecordedKeyframe keyframe;
+    while (static_cast<uint64_t>(_playbackFile.tellg()) < endOffset) {
+        ReadResult res = readNextKeyframe(keyframe);
+        if (res == ReadResult::Keyframe) {
+            addKeyframeToTimeline(std::move(keyframe));
+        }
+        else if (res != ReadResult::Skipped) {
+            // Without a valid position in the file, the rest of the block is lost
+            break;
+        }
+    }
+}
+
+void SessionRecording::streamKeyframes() {
+    if (!_isStreamingPlayback) {
+        return;
+    }
+
+    // Keep at least one index block of keyframes loaded ahead of the keyframes that are
+    // currently being played back
+    while (!hasStreamedAllKeyframes()) {
+        const unsigned int furthestIdx = std::max(
+            _idxTimeline_cameraPtrNext,
+            _idxTimeline_nonCamera
+        );
+        if (_timeline.size() > furthestIdx + IndexInterval) {
+            break;
+        }
+        streamNextBlock();
+    }
+
+    // Discard keyframes that have been played back, but keep the last index block so
+    // that the camera can still interpolate from its previous keyframe
+    const unsigned int oldestIdx = std::min({
+        _idxTimeline_cameraPtrPrev,
+        _idxTimeline_cameraPtrNext,
+        _idxTimeline_nonCamera
+    });
+    if (oldestIdx > 2 * IndexInterval) {
+        discardTimelineEntries(oldestIdx - IndexInterval);
+    }
+}
+
+bool SessionRecording::hasStreamedAllKeyframes() const {
+    return !_isStreamingPlayback || _nextBlockToStream >= _playbackIndex.size();
+}
+
+void SessionRecording::discardTimelineEntries(unsigned int nEntries) {
+    unsigned int nCamera = 0;
+    unsigned int nTime = 0;
+    unsigned int nScript = 0;
+    for (unsigned int i = 0; i < nEntries; ++i) {
+        switch (_timeline[i].keyframeType) {
+            case RecordedType::Camera:
+                nCamera++;
+                break;
+            case RecordedType::Time:
+                nTime++;
+                break;
+            case RecordedType::Script:
+                nScript++;
+                break;
+            default:
+                break;
+        }
+    }
+
+    // The keyframes of each type are stored in the same order as in the timeline
+    _timeline.erase(_timeline.begin(), _timeline.begin() + nEntries);
+    _keyframesCamera.erase(_keyframesCamera.begin(), _keyframesCamera.begin() + nCamera);
+    _keyframesTime.erase(_keyframesTime.begin(), _keyframesTime.begin() + nTime);
+    _keyframesScript.erase(_keyframesScript.begin(), _keyframesScript.begin() + nScript);
+    for (timelineEntry& e : _timeline) {
+        switch (e.keyframeType) {
+            case RecordedType::Camera:
+                e.idxIntoKeyframeTypeArray -= nCamera;
+                break;
+            case RecordedType::Time:
+                e.idxIntoKeyframeTypeArray -= nTime;
+                break;
+            case RecordedType::Script:
+                e.idxIntoKeyframeTypeArray -= nScript;
+                break;
+            default:
+                break;
+        }
+    }
+
+    _idxTimeline_nonCamera -= nEntries;
+    _idxTimeline_cameraPtrPrev -= nEntries;
+    _idxTimeline_cameraPtrNext -= nEntries;
+    _idxTimeline_cameraFirstInTimeline = (_idxTimeline_cameraFirstInTimeline > nEntries) ?
+        _idxTimeline_cameraFirstInTimeline - nEntries :
+        0;
+    _idxTime = (_idxTime > nTime) ? _idxTime - nTime : 0;
+    _idxScript = (_idxScript > nScript) ? _idxScript - nScript : 0;
+}
+
+void SessionRecording::clearTimeline() {
+    _timeline.clear();
+    _keyframesCamera.clear();
+    _keyframesTime.clear();
+    _keyframesScript.clear();
+    _idxTimeline_nonCamera = 0;
+    _idxTime = 0;
+    _idxScript = 0;
+    _idxTimeline_cameraPtrNext = 0;
+    _idxTimeline_cameraPtrPrev = 0;
+    _idxTimeline_cameraFirstInTimeline = 0;
+    _hasHitEndOfCameraKeyframes = false;
+}
+
 void SessionRecording::findFirstCameraKeyframeInTimeline() {
     bool foundCameraKeyframe = false;
-    for (unsigned int i = 0; i < _timeline.size(); i++) {
-        if (doesTimelineEntryContainCamera(i)) {
-            _idxTimeline_cameraFirstInTimeline = i;
-            _idxTimeline_cameraPtrPrev = _idxTimeline_cameraFirstInTimeline;
-            _idxTimeline_cameraPtrNext = _idxTimeline_cameraFirstInTimeline;
-            _cameraFirstInTimeline_timestamp
-                = _timeline[_idxTimeline_cameraFirstInTimeline].timestamp;
-            foundCameraKeyframe = true;
+    unsigned int i = 0;
+    while (!foundCameraKeyframe) {
+        for (; i < _timeline.size(); i++) {
+            if (doesTimelineEntryContainCamera(i)) {
+                _idxTimeline_cameraFirstInTimeline = i;
+                _idxTimeline_cameraPtrPrev = _idxTimeline_cameraFirstInTimeline;
+                _idxTimeline_cameraPtrNext = _idxTimeline_cameraFirstInTimeline;
+                _cameraFirstInTimeline_timestamp
+                    = _timeline[_idxTimeline_cameraFirstInTimeline].timestamp;
+                foundCameraKeyframe = true;
+                break;
+            }
+        }
+        if (foundCameraKeyframe || hasStreamedAllKeyframes()) {
             break;
         }
+        // The first camera keyframe might not have been streamed yet
+        streamNextBlock();
     }
 
     if (!foundCameraKeyframe) {
@@ -306,16 +705,12 @@ void SessionRecording::cleanUpPlayback() {
     _playbackFile.close();
 
     //Clear all timelines and keyframes
-    _timeline.clear();
-    _keyframesCamera.clear();
-    _keyframesTime.clear();
-    _keyframesScript.clear();
-    _idxTimeline_nonCamera = 0;
-    _idxTime = 0;
-    _idxScript = 0;
-    _idxTimeline_cameraPtrNext = 0;
-    _idxTimeline_cameraPtrPrev = 0;
-    _hasHitEndOfCameraKeyframes = false;
+    clearTimeline();
+    _isStreamingPlayback = false;
+    _playbackIndex.clear();
+    _playbackIndexOffset = 0;
+    _nextBlockToStream = 0;
+    _playbackSeekOffset = 0.0;
 
     _cleanupNeeded = false;
 }
@@ -446,18 +841,13 @@ void SessionRecording::saveCameraKeyframe() {
 
     if (/*hasCameraChangedFromPrev(kf)*/true) {
         if (isDataModeBinary()) {
-            _bufferIndex = 0;
-            _keyframeBuffer[_bufferIndex++] = 'c';
-
-            //Writing to internal buffer, and then to file, for performance reasons
-            writeToFileBuffer(kf._timestamp);
-            writeToFileBuffer(kf._timestamp - _timestampRecordStarted);
-            writeToFileBuffer(global::timeManager.time().j2000Seconds());
-            std::vector<char> kfBuffer;
-            kf.serialize(kfBuffer);
-            writeToFileBuffer(kfBuffer);
-
-            saveKeyframeToFileBinary(_keyframeBuffer, _bufferIndex);
+            RecordedKeyframe keyframe;
+            keyframe.type = RecordedType::Camera;
+            keyframe.timeOs = kf._timestamp;
+            keyframe.timeRec = kf._timestamp - _timestampRecordStarted;
+            keyframe.timeSim = global::timeManager.time().j2000Seconds();
+            keyframe.camera = std::move(kf);
+            saveKeyframeBinary(keyframe);
         } else {
             std::stringstream keyframeLine = std::stringstream();
             // Add simulation timestamp, timestamp relative, simulation time to recording
@@ -500,16 +890,13 @@ void SessionRecording::saveTimeKeyframe() {
     datamessagestructures::TimeKeyframe kf = _externInteract.generateTimeKeyframe();
 
     if (isDataModeBinary()) {
-        _bufferIndex = 0;
-        _keyframeBuffer[_bufferIndex++] = 't';
-        writeToFileBuffer(kf._timestamp);
-        writeToFileBuffer(kf._timestamp - _timestampRecordStarted);
-        writeToFileBuffer(kf._time);
-        writeToFileBuffer(kf._dt);
-        writeToFileBuffer(kf._paused);
-        writeToFileBuffer(kf._requiresTimeJump);
-
-        saveKeyframeToFileBinary(_keyframeBuffer, _bufferIndex);
+        RecordedKeyframe keyframe;
+        keyframe.type = RecordedType::Time;
+        keyframe.timeOs = kf._timestamp;
+        keyframe.timeRec = kf._timestamp - _timestampRecordStarted;
+        keyframe.timeSim = kf._time;
+        keyframe.time = kf;
+        saveKeyframeBinary(keyframe);
     } else {
         std::stringstream keyframeLine = std::stringstream();
         //Add simulation timestamp, timestamp relative, simulation time to recording start
@@ -544,15 +931,13 @@ void SessionRecording::saveScriptKeyframe(std::string scriptToSave) {
     datamessagestructures::ScriptMessage sm
         = _externInteract.generateScriptMessage(scriptToSave);
     if (isDataModeBinary()) {
-        _bufferIndex = 0;
-        _keyframeBuffer[_bufferIndex++] = 's';
-        writeToFileBuffer(sm._timestamp);
-        writeToFileBuffer(sm._timestamp - _timestampRecordStarted);
-        writeToFileBuffer(global::timeManager.time().j2000Seconds());
-        //Write header to file
-        saveKeyframeToFileBinary(_keyframeBuffer, _bufferIndex);
-
-        saveStringToFile(scriptToSave);
+        RecordedKeyframe keyframe;
+        keyframe.type = RecordedType::Script;
+        keyframe.timeOs = sm._timestamp;
+        keyframe.timeRec = sm._timestamp - _timestampRecordStarted;
+        keyframe.timeSim = global::timeManager.time().j2000Seconds();
+        keyframe.script = std::move(scriptToSave);
+        saveKeyframeBinary(keyframe);
     }
     else {
         unsigned int numLinesInScript = static_cast<unsigned int>(
@@ -596,83 +981,114 @@ bool SessionRecording::isPlayingBack() const {
     return (_state == SessionState::Playback);
 }
 
+size_t SessionRecording::nKeyframesInMemory() const {
+    return _timeline.size();
+}
+
+double SessionRecording::nextKeyframeTimestamp() const {
+    return getNextTimestamp();
+}
+
 bool SessionRecording::playbackAddEntriesToTimeline() {
     bool parsingErrorsFound = false;
 
+    RecordedKeyframe keyframe;
+    while (true) {
+        ReadResult res = readNextKeyframe(keyframe);
+        if (res == ReadResult::Keyframe) {
+            addKeyframeToTimeline(std::move(keyframe));
+        }
+        else if (res == ReadResult::EndOfFile) {
+            break;
+        }
+        else if (res == ReadResult::Error) {
+            parsingErrorsFound = true;
+            break;
+        }
+    }
+    LINFO(fmt::format(
+        "Finished parsing {} entries from playback file {}",
+        _playbackLineNum - 1, _playbackFilename.c_str()
+    ));
+
+    return !parsingErrorsFound;
+}
+
+SessionRecording::ReadResult SessionRecording::readNextKeyframe(
+                                                             RecordedKeyframe& keyframe)
+{
+    keyframe = RecordedKeyframe();
+
     if (isDataModeBinary()) {
-        unsigned char frameType;
-        bool fileReadOk = true;
-
-        while (fileReadOk) {
-            readFromPlayback(frameType);
-            //Check if have reached EOF
-            if (!_playbackFile) {
-                LINFO(fmt::format(
-                    "Finished parsing {} entries from playback file {}",
-                    _playbackLineNum - 1, _playbackFilename.c_str()
-                ));
-                fileReadOk = false;
-                break;
-            }
-            if (frameType == 'c') {
-                playbackCamera();
-            }
-            else if (frameType == 't') {
-                playbackTimeChange();
-            }
-            else if (frameType == 's') {
-                playbackScript();
-            }
-            else {
-                LERROR(fmt::format(
-                    "Unknown frame type {} @ index {} of playback file {}",
-                    frameType, _playbackLineNum - 1, _playbackFilename.c_str()
-                ));
-                parsingErrorsFound = true;
-                break;
-            }
+        //Check if have reached the index at the end of the keyframes
+        if (_playbackIndexOffset > 0 &&
+            static_cast<uint64_t>(_playbackFile.tellg()) >= _playbackIndexOffset)
+        {
+            return ReadResult::EndOfFile;
+        }
 
-            _playbackLineNum++;
+        unsigned char frameType;
+        readFromPlayback(frameType);
+        //Check if have reached EOF
+        if (!_playbackFile) {
+            return ReadResult::EndOfFile;
         }
-    } else {
-        while (std::getline(_playbackFile, _playbackLineParsing)) {
-            _playbackLineNum++;
-
-            std::istringstream iss(_playbackLineParsing);
-            std::string entryType;
-            if (!(iss >> entryType)) {
-                LERROR(fmt::format(
-                    "Error reading entry type @ line {} of playback file {}",
-                    _playbackLineNum, _playbackFilename.c_str()
-                ));
-                break;
-            }
+        _playbackLineNum++;
 
-            if (entryType == "camera") {
-                playbackCamera();
-            }
-            else if (entryType == "time") {
-                playbackTimeChange();
-            }
-            else if (entryType == "script") {
-                playbackScript();
-            }
-            else {
-                LERROR(fmt::format(
-                    "Unknown frame type {} @ line {} of playback file {}",
-                    entryType, _playbackLineNum, _playbackFilename.c_str()
-                ));
-                parsingErrorsFound = true;
-                break;
-            }
+        bool success = false;
+        if (frameType == 'c') {
+            success = readCameraKeyframe(keyframe);
         }
-        LINFO(fmt::format(
-            "Finished parsing {} entries from playback file {}",
-            _playbackLineNum, _playbackFilename.c_str()
-        ));
+        else if (frameType == 't') {
+            success = readTimeKeyframe(keyframe);
+        }
+        else if (frameType == 's') {
+            success = readScriptKeyframe(keyframe);
+        }
+        else {
+            LERROR(fmt::format(
+                "Unknown frame type {} @ index {} of playback file {}",
+                frameType, _playbackLineNum - 1, _playbackFilename.c_str()
+            ));
+            return ReadResult::Error;
+        }
+        return success ? ReadResult::Keyframe : ReadResult::Skipped;
     }
+    else {
+        if (!std::getline(_playbackFile, _playbackLineParsing)) {
+            return ReadResult::EndOfFile;
+        }
+        _playbackLineNum++;
 
-    return !parsingErrorsFound;
+        std::istringstream iss(_playbackLineParsing);
+        std::string entryType;
+        if (!(iss >> entryType)) {
+            LERROR(fmt::format(
+                "Error reading entry type @ line {} of playback file {}",
+                _playbackLineNum, _playbackFilename.c_str()
+            ));
+            return ReadResult::EndOfFile;
+        }
+
+        bool success = false;
+        if (entryType == "camera") {
+            success = readCameraKeyframe(keyframe);
+        }
+        else if (entryType == "time") {
+            success = readTimeKeyframe(keyframe);
+        }
+        else if (entryType == "script") {
+            success = readScriptKeyframe(keyframe);
+        }
+        else {
+            LERROR(fmt::format(
+                "Unknown frame type {} @ line {} of playback file {}",
+                entryType, _playbackLineNum, _playbackFilename.c_str()
+            ));
+            return ReadResult::Error;
+        }
+        return success ? ReadResult::Keyframe : ReadResult::Skipped;
+    }
 }
 
 double SessionRecording::appropriateTimestamp(double timeOs, double timeRec,
@@ -720,25 +1136,23 @@ double SessionRecording::equivalentApplicationTime(double timeOs, double timeRec
 double SessionRecording::currentTime() const {
     if (_playbackTimeReferenceMode == KeyframeTimeRef::Relative_recordedStart) {
         return (global::windowDelegate.applicationTime() -
-                _timestampPlaybackStarted_application);
+                _timestampPlaybackStarted_application + _playbackSeekOffset);
     }
     else if (_playbackTimeReferenceMode == KeyframeTimeRef::Absolute_simTimeJ2000) {
         return global::timeManager.time().j2000Seconds();
     }
     else {
-        return global::windowDelegate.applicationTime();
+        return global::windowDelegate.applicationTime() + _playbackSeekOffset;
     }
 }
 
-void SessionRecording::playbackCamera() {
-    double timeOs, timeRec, timeSim;
-    std::string rotationFollowing;
-    interaction::KeyframeNavigator::CameraPose pbFrame;
-    datamessagestructures::CameraKeyframe kf;
+bool SessionRecording::readCameraKeyframe(RecordedKeyframe& keyframe) {
+    keyframe.type = RecordedType::Camera;
+    datamessagestructures::CameraKeyframe& kf = keyframe.camera;
     if (isDataModeBinary()) {
-        readFromPlayback(timeOs);
-        readFromPlayback(timeRec);
-        readFromPlayback(timeSim);
+        readFromPlayback(keyframe.timeOs);
+        readFromPlayback(keyframe.timeRec);
+        readFromPlayback(keyframe.timeSim);
         try {
             kf.read(&_playbackFile);
         }
@@ -747,148 +1161,114 @@ void SessionRecording::playbackCamera() {
                 "Allocation error with camera playback from keyframe entry {}",
                 _playbackLineNum - 1
             ));
-            return;
+            return false;
         }
         catch (std::length_error&) {
             LERROR(fmt::format(
                 "length_error with camera playback from keyframe entry {}",
                 _playbackLineNum - 1
             ));
-            return;
+            return false;
         }
 
-        timeOs = kf._timestamp;
-
-        pbFrame.focusNode = kf._focusNode;
-        pbFrame.position = kf._position;
-        pbFrame.rotation = kf._rotation;
-        pbFrame.scale = kf._scale;
-        pbFrame.followFocusNodeRotation = kf._followNodeRotation;
+        keyframe.timeOs = kf._timestamp;
 
         if (!_playbackFile) {
             LINFO(fmt::format(
                 "Error reading camera playback from keyframe entry {}",
                 _playbackLineNum - 1
             ));
-            return;
+            return false;
         }
     } else {
         std::istringstream iss(_playbackLineParsing);
         std::string entryType;
+        std::string rotationFollowing;
         iss >> entryType;
-        iss >> timeOs >> timeRec >> timeSim;
-        iss >> pbFrame.position.x
-            >> pbFrame.position.y
-            >> pbFrame.position.z
-            >> pbFrame.rotation.x
-            >> pbFrame.rotation.y
-            >> pbFrame.rotation.z
-            >> pbFrame.rotation.w
-            >> pbFrame.scale
+        iss >> keyframe.timeOs >> keyframe.timeRec >> keyframe.timeSim;
+        iss >> kf._position.x
+            >> kf._position.y
+            >> kf._position.z
+            >> kf._rotation.x
+            >> kf._rotation.y
+            >> kf._rotation.z
+            >> kf._rotation.w
+            >> kf._scale
             >> rotationFollowing
-            >> pbFrame.focusNode;
+            >> kf._focusNode;
         if (iss.fail() || !iss.eof()) {
             LERROR(fmt::format(
                 "Error parsing camera line {} of playback file", _playbackLineNum
             ));
-            return;
-        }
-        if (rotationFollowing == "F") {
-            pbFrame.followFocusNodeRotation = true;
-        }
-        else {
-            pbFrame.followFocusNodeRotation = false;
+            return false;
         }
+        kf._followNodeRotation = (rotationFollowing == "F");
+        kf._timestamp = keyframe.timeOs;
     }
-    if (_setSimulationTimeWithNextCameraKeyframe) {
-        global::timeManager.setTimeNextFrame(timeSim);
-        _setSimulationTimeWithNextCameraKeyframe = false;
-    }
-    double timeRef = appropriateTimestamp(timeOs, timeRec, timeSim);
-
-    //global::navigationHandler.keyframeNavigator().addKeyframe(timeRef, pbFrame);
-    addKeyframe(timeRef, pbFrame);
+    return true;
 }
 
-void SessionRecording::playbackTimeChange() {
-    double timeOs, timeRec, timeSim;
-    datamessagestructures::TimeKeyframe pbFrame;
+bool SessionRecording::readTimeKeyframe(RecordedKeyframe& keyframe) {
+    keyframe.type = RecordedType::Time;
+    datamessagestructures::TimeKeyframe& kf = keyframe.time;
     if (isDataModeBinary()) {
-        readFromPlayback(timeOs);
-        readFromPlayback(timeRec);
-        readFromPlayback(timeSim);
-        readFromPlayback(pbFrame._dt);
-        readFromPlayback(pbFrame._paused);
-        readFromPlayback(pbFrame._requiresTimeJump);
+        readFromPlayback(keyframe.timeOs);
+        readFromPlayback(keyframe.timeRec);
+        readFromPlayback(keyframe.timeSim);
+        readFromPlayback(kf._dt);
+        readFromPlayback(kf._paused);
+        readFromPlayback(kf._requiresTimeJump);
         if (!_playbackFile) {
             LERROR(fmt::format(
                 "Error reading time playback from keyframe entry {}",
                 _playbackLineNum - 1
             ));
-            return;
+            return false;
         }
     } else {
         std::istringstream iss(_playbackLineParsing);
         std::string entryType;
-        //double timeRef;
         std::string paused, jump;
         iss >> entryType;
-        iss >> timeOs >> timeRec >> timeSim;
-        iss >> pbFrame._dt
+        iss >> keyframe.timeOs >> keyframe.timeRec >> keyframe.timeSim;
+        iss >> kf._dt
             >> paused
             >> jump;
         if (iss.fail() || !iss.eof()) {
             LERROR(fmt::format(
                 "Error parsing time line {} of playback file", _playbackLineNum
             ));
-            return;
-        }
-        if (paused == "P") {
-            pbFrame._paused = true;
-        }
-        else {
-            pbFrame._paused = false;
-        }
-        if (jump == "J") {
-            pbFrame._requiresTimeJump = true;
-        }
-        else {
-            pbFrame._requiresTimeJump = false;
+            return false;
         }
+        kf._paused = (paused == "P");
+        kf._requiresTimeJump = (jump == "J");
     }
-    pbFrame._timestamp = equivalentApplicationTime(timeOs, timeRec, timeSim);
-
-    pbFrame._time = pbFrame._timestamp + _timestampApplicationStarted_simulation;
-    //global::timeManager.addKeyframe(timeRef, pbFrame._timestamp);
-    //_externInteract.timeInteraction(pbFrame);
-    addKeyframe(pbFrame._timestamp, pbFrame);
+    kf._time = keyframe.timeSim;
+    return true;
 }
 
-void SessionRecording::playbackScript() {
-    double timeOs, timeRec, timeSim;
-    unsigned int numScriptLines;
-    datamessagestructures::ScriptMessage pbFrame;
-
+bool SessionRecording::readScriptKeyframe(RecordedKeyframe& keyframe) {
+    keyframe.type = RecordedType::Script;
     if (isDataModeBinary()) {
-        readFromPlayback(timeOs);
-        readFromPlayback(timeRec);
-        readFromPlayback(timeSim);
+        readFromPlayback(keyframe.timeOs);
+        readFromPlayback(keyframe.timeRec);
+        readFromPlayback(keyframe.timeSim);
         try {
-            readFromPlayback(pbFrame._script);
+            readFromPlayback(keyframe.script);
         }
         catch (std::bad_alloc&) {
             LERROR(fmt::format(
                 "Allocation error with script playback from keyframe entry {}",
                 _playbackLineNum - 1
             ));
-            return;
+            return false;
         }
         catch (std::length_error&) {
             LERROR(fmt::format(
                 "length_error with script playback from keyframe entry {}",
                 _playbackLineNum - 1
             ));
-            return;
+            return false;
         }
 
         if (!_playbackFile) {
@@ -896,53 +1276,109 @@ void SessionRecording::playbackScript() {
                 "Error reading script playback from keyframe entry {}",
                 _playbackLineNum - 1
             ));
-            return;
+            return false;
         }
     } else {
         std::istringstream iss(_playbackLineParsing);
         std::string entryType;
         std::string tmpReadbackScript;
+        unsigned int numScriptLines;
 
         iss >> entryType;
-        iss >> timeOs >> timeRec >> timeSim;
+        iss >> keyframe.timeOs >> keyframe.timeRec >> keyframe.timeSim;
         iss >> numScriptLines;
-        std::getline(iss, tmpReadbackScript); //iss >> tmpReadbackScript;
-        pbFrame._script.append(tmpReadbackScript);
+        std::getline(iss, tmpReadbackScript);
+        keyframe.script.append(tmpReadbackScript);
         if (iss.fail()) {
             LERROR(fmt::format(
                 "Error parsing script line {} of playback file", _playbackLineNum
             ));
-            return;
+            return false;
         } else if (!iss.eof()) {
             LERROR(fmt::format(
                 "Did not find an EOL at line {} of playback file", _playbackLineNum
             ));
-            return;
+            return false;
         }
         if (numScriptLines > 1) {
             //Now loop to read any subsequent lines if is a multi-line script
             for (unsigned int i = 1; i < numScriptLines; ++i) {
-                pbFrame._script.append("\n");
+                keyframe.script.append("\n");
                 std::getline(_playbackFile, tmpReadbackScript);
-                pbFrame._script.append(tmpReadbackScript);
+                keyframe.script.append(tmpReadbackScript);
             }
         }
     }
-    double timeRef = appropriateTimestamp(timeOs, timeRec, timeSim);
-    //timeRef = getEquivalentSimulationTime(timeOs, timeRec, timeSim);
+    return true;
+}
 
-    //Call script scheduler with this new script entry
-    //std::string timeDescription = SpiceManager::ref().dateFromEphemerisTime(
-    //  timeRef,
-    //  "YYYY MON DD HR:MN:SC.###"
-    //);
-    //ghoul::Dictionary scriptDict(ghoul::Dictionary{
-    //  { KeyTime, timeDescription },
-    //  { KeyForwardScript, pbFrame._script}
-    //}
-    //                            );
-    //global::scriptScheduler.loadScripts({ { "1", scriptDict } });
-    addKeyframe(timeRef, pbFrame._script);
+void SessionRecording::addKeyframeToTimeline(RecordedKeyframe keyframe) {
+    const double timeOs = keyframe.timeOs;
+    const double timeRec = keyframe.timeRec;
+    const double timeSim = keyframe.timeSim;
+
+    if (keyframe.type == RecordedType::Camera) {
+        interaction::KeyframeNavigator::CameraPose pbFrame;
+        pbFrame.focusNode = std::move(keyframe.camera._focusNode);
+        pbFrame.position = keyframe.camera._position;
+        pbFrame.rotation = keyframe.camera._rotation;
+        pbFrame.scale = keyframe.camera._scale;
+        pbFrame.followFocusNodeRotation = keyframe.camera._followNodeRotation;
+
+        if (_setSimulationTimeWithNextCameraKeyframe) {
+            global::timeManager.setTimeNextFrame(timeSim);
+            _setSimulationTimeWithNextCameraKeyframe = false;
+        }
+        addKeyframe(appropriateTimestamp(timeOs, timeRec, timeSim), std::move(pbFrame));
+    }
+    else if (keyframe.type == RecordedType::Time) {
+        datamessagestructures::TimeKeyframe& pbFrame = keyframe.time;
+        pbFrame._timestamp = equivalentApplicationTime(timeOs, timeRec, timeSim);
+        pbFrame._time = pbFrame._timestamp + _timestampApplicationStarted_simulation;
+        addKeyframe(pbFrame._timestamp, pbFrame);
+    }
+    else if (keyframe.type == RecordedType::Script) {
+        addKeyframe(
+            appropriateTimestamp(timeOs, timeRec, timeSim),
+            std::move(keyframe.script)
+        );
+    }
+}
+
+void SessionRecording::saveKeyframeBinary(const RecordedKeyframe& keyframe) {
+    addRecordIndexEntry(keyframe.timeOs, keyframe.timeRec, keyframe.timeSim);
+
+    //Writing to internal buffer, and then to file, for performance reasons
+    _bufferIndex = 0;
+    if (keyframe.type == RecordedType::Camera) {
+        _keyframeBuffer[_bufferIndex++] = 'c';
+        writeToFileBuffer(keyframe.timeOs);
+        writeToFileBuffer(keyframe.timeRec);
+        writeToFileBuffer(keyframe.timeSim);
+        std::vector<char> kfBuffer;
+        keyframe.camera.serialize(kfBuffer);
+        writeToFileBuffer(kfBuffer);
+        saveKeyframeToFileBinary(_keyframeBuffer, _bufferIndex);
+    }
+    else if (keyframe.type == RecordedType::Time) {
+        _keyframeBuffer[_bufferIndex++] = 't';
+        writeToFileBuffer(keyframe.timeOs);
+        writeToFileBuffer(keyframe.timeRec);
+        writeToFileBuffer(keyframe.timeSim);
+        writeToFileBuffer(keyframe.time._dt);
+        writeToFileBuffer(keyframe.time._paused);
+        writeToFileBuffer(keyframe.time._requiresTimeJump);
+        saveKeyframeToFileBinary(_keyframeBuffer, _bufferIndex);
+    }
+    else if (keyframe.type == RecordedType::Script) {
+        _keyframeBuffer[_bufferIndex++] = 's';
+        writeToFileBuffer(keyframe.timeOs);
+        writeToFileBuffer(keyframe.timeRec);
+        writeToFileBuffer(keyframe.timeSim);
+        //Write header to file
+        saveKeyframeToFileBinary(_keyframeBuffer, _bufferIndex);
+        saveStringToFile(keyframe.script);
+    }
 }
 
 void SessionRecording::addKeyframe(double timestamp,
@@ -980,6 +1416,7 @@ void SessionRecording::addKeyframe(double timestamp, std::string scriptToQueue)
 }
 
 void SessionRecording::moveAheadInTime() {
+    streamKeyframes();
     double currTime = currentTime();
     lookForNonCameraKeyframesThatHaveComeDue(currTime);
     updateCameraWithOrWithoutNewKeyframes(currTime);
@@ -991,6 +1428,11 @@ void SessionRecording::lookForNonCameraKeyframesThatHaveComeDue(double currTime)
             break;
         }
 
+        while ((_idxTimeline_nonCamera + 1 >= _timeline.size()) &&
+               !hasStreamedAllKeyframes())
+        {
+            streamNextBlock();
+        }
         if (++_idxTimeline_nonCamera >= _timeline.size()) {
             _idxTimeline_nonCamera--;
             if (_playbackActive_time) {
@@ -1031,6 +1473,11 @@ bool SessionRecording::findNextFutureCameraIndex(double currTime) {
     unsigned int seekAheadIndex = _idxTimeline_cameraPtrPrev;
     while (true) {
         seekAheadIndex++;
+        while (seekAheadIndex >= static_cast<unsigned int>(_timeline.size()) &&
+               !hasStreamedAllKeyframes())
+        {
+            streamNextBlock();
+        }
         if (seekAheadIndex >= static_cast<unsigned int>(_timeline.size())) {
             seekAheadIndex = static_cast<unsigned int>(_timeline.size()) - 1;
         }
@@ -1040,7 +1487,9 @@ bool SessionRecording::findNextFutureCameraIndex(double currTime) {
                 _timeline[seekAheadIndex].idxIntoKeyframeTypeArray;
             double seekAheadKeyframeTimestamp = _timeline[seekAheadIndex].timestamp;
 
-            if (indexIntoCameraKeyframes >= (_keyframesCamera.size() - 1)) {
+            if (indexIntoCameraKeyframes >= (_keyframesCamera.size() - 1) &&
+                hasStreamedAllKeyframes())
+            {
                 _hasHitEndOfCameraKeyframes = true;
             }
 
@@ -1185,7 +1634,11 @@ bool SessionRecording::processScriptKeyframe() {
         nextScript = nextKeyframeObj(
             _idxScript,
             _keyframesScript,
-            ([&]() { signalPlaybackFinishedForComponent(RecordedType::Script); })
+            ([&]() {
+                if (hasStreamedAllKeyframes()) {
+                    signalPlaybackFinishedForComponent(RecordedType::Script);
+                }
+            })
         );
         global::scriptEngine.queueScript(
             nextScript,
@@ -1196,7 +1649,7 @@ bool SessionRecording::processScriptKeyframe() {
     return true;
 }
 
-double SessionRecording::getNextTimestamp() {
+double SessionRecording::getNextTimestamp() const {
     if (_timeline.empty()) {
         return 0.0;
     } else if (_idxTimeline_nonCamera < _timeline.size()) {
@@ -1329,6 +1782,16 @@ scripting::LuaLibrary SessionRecording::luaLibrary() {
                 {},
                 "void",
                 "Stops a playback session before playback of all keyframes is complete"
+            },
+            {
+                "seekPlayback",
+                &luascriptfunctions::seekPlayback,
+                {},
+                "number",
+                "Moves the playback session in progress to the specified time, which is "
+                "given in the time reference mode of the playback. Keyframes between "
+                "the current and the new position are skipped. Seeking is fastest for "
+                "recordings that are stored in the indexed binary format"
             }
         }
     };
@@ -142,4 +142,19 @@ int stopPlayback(lua_State* L) {
     return 0;
 }
 
+int seekPlayback(lua_State* L) {
+    ghoul::lua::checkArgumentsAndThrow(L, 1, "lua::seekPlayback");
+
+    const double time = ghoul::lua::value<double>(
+        L,
+        1,
+        ghoul::lua::PopValue::Yes
+    );
+
+    global::sessionRecording.seekPlayback(time);
+
+    ghoul_assert(lua_gettop(L) == 0, "Incorrect number of items left on stack");
+    return 0;
+}
+
 } // namespace openspace::luascriptfunctions
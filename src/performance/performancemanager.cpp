@@ -343,6 +343,12 @@ void PerformanceManager::tick() {
 void PerformanceManager::storeIndividualPerformanceMeasurement(
                                                             const std::string& identifier,
                                                                    long long microseconds)
+{
+    storeIndividualValue(identifier, static_cast<float>(microseconds));
+}
+
+void PerformanceManager::storeIndividualValue(const std::string& identifier,
+                                              float value)
 {
     if (!_performanceMemory) {
         // If someone called the PerfMeasure macro without checking whether we are
@@ -374,7 +380,7 @@ void PerformanceManager::storeIndividualPerformanceMeasurement(
         std::next(std::begin(p->time)),
         std::end(p->time)
     );
-    p->time[PerformanceLayout::NumberValues - 1] = static_cast<float>(microseconds);
+    p->time[PerformanceLayout::NumberValues - 1] = value;
 
     _performanceMemory->releaseLock();
 }
@@ -140,6 +140,10 @@ void Renderable::deinitializeGL() {}
 
 void Renderable::update(const UpdateData&) {}
 
+bool Renderable::isUpdateGLBound() const {
+    return true;
+}
+
 void Renderable::render(const RenderData&, RendererTasks&) {}
 
 void Renderable::setBoundingSphere(float boundingSphere) {
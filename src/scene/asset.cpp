@@ -24,7 +24,9 @@
 
 #include <openspace/scene/asset.h>
 
+#include <openspace/engine/globals.h>
 #include <openspace/scene/assetloader.h>
+#include <openspace/util/startuptrace.h>
 #include <ghoul/fmt.h>
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/filesystem/file.h>
@@ -520,6 +522,11 @@ bool Asset::initialize() {
 
     // 3. Call lua onInitialize
     try {
+        StartupTrace::Scope traceScope(
+            global::startupTrace,
+            "Asset",
+            "Initialize " + id()
+        );
         loader()->callOnInitialize(this);
     } catch (const ghoul::lua::LuaRuntimeException& e) {
         LERROR(fmt::format(
@@ -24,8 +24,10 @@
 
 #include <openspace/scene/assetloader.h>
 
+#include <openspace/engine/globals.h>
 #include <openspace/scene/assetlistener.h>
 #include <openspace/util/resourcesynchronization.h>
+#include <openspace/util/startuptrace.h>
 #include <ghoul/fmt.h>
 #include <ghoul/filesystem/file.h>
 #include <ghoul/filesystem/filesystem.h>
@@ -269,6 +271,11 @@ bool AssetLoader::loadAsset(std::shared_ptr<Asset> asset) {
     }
 
     try {
+        StartupTrace::Scope traceScope(
+            global::startupTrace,
+            "Asset",
+            "Load " + asset->assetFilePath()
+        );
         ghoul::lua::runScriptFile(*_luaState, asset->assetFilePath());
     } catch (const ghoul::lua::LuaRuntimeException& e) {
         LERROR(fmt::format(
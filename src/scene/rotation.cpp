@@ -84,6 +84,10 @@ bool Rotation::initialize() {
     return true;
 }
 
+bool Rotation::isThreadSafe() const {
+    return false;
+}
+
 const glm::dmat3& Rotation::matrix() const {
     return _cachedMatrix;
 }
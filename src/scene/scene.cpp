@@ -33,12 +33,20 @@
 #include <openspace/scene/sceneinitializer.h>
 #include <openspace/scripting/lualibrary.h>
 #include <openspace/util/camera.h>
+#include <openspace/util/startuptrace.h>
+#include <openspace/util/updatestructures.h>
+#include <openspace/util/workstealingthreadpool.h>
 
 #include <ghoul/opengl/programobject.h>
 #include <ghoul/logging/logmanager.h>
 
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
 #include <string>
 #include <stack>
+#include <thread>
 
 #include "scene_lua.inl"
 
@@ -46,6 +54,38 @@ namespace {
     constexpr const char* _loggerCat = "Scene";
     constexpr const char* KeyIdentifier = "Identifier";
     constexpr const char* KeyParent = "Parent";
+
+    constexpr openspace::properties::Property::PropertyInfo ParallelUpdateInfo = {
+        "ParallelUpdate",
+        "Parallel Update",
+        "If this value is enabled, the scene graph nodes are updated concurrently on a "
+        "thread pool. A node is only updated after its parent and all of its "
+        "dependencies have been updated. Nodes whose transformations or renderables are "
+        "not thread-safe are always updated on the main thread.",
+        openspace::properties::Property::Visibility::Developer
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo ParallelUpdateEfficiencyInfo =
+    {
+        "ParallelUpdateEfficiency",
+        "Parallel Update Efficiency",
+        "The fraction of the available thread time that was spent updating scene graph "
+        "nodes in the last frame. A value of 1 means that all threads were busy for the "
+        "entire update, a value close to 1 / (number of threads) means that the update "
+        "did not benefit from the parallelization. This value is only updated if the "
+        "parallel update is enabled.",
+        openspace::properties::Property::Visibility::Developer
+    };
+
+    constexpr openspace::properties::Property::PropertyInfo InitializeGLBudgetInfo = {
+        "InitializeGLBudget",
+        "InitializeGL Budget (in ms)",
+        "The time that is spent per frame on the OpenGL initialization of scene graph "
+        "nodes that have finished their initialization. The remaining nodes are "
+        "initialized in the following frames, so that loading many nodes does not stall "
+        "the rendering. At least one node is initialized per frame.",
+        openspace::properties::Property::Visibility::Developer
+    };
 } // namespace
 
 namespace openspace {
@@ -57,9 +97,17 @@ Scene::InvalidSceneError::InvalidSceneError(std::string msg, std::string comp)
 Scene::Scene(std::unique_ptr<SceneInitializer> initializer)
     : properties::PropertyOwner({"Scene", "Scene"})
     , _initializer(std::move(initializer))
+    , _parallelUpdate(ParallelUpdateInfo, false)
+    , _parallelUpdateEfficiency(ParallelUpdateEfficiencyInfo, 0.f, 0.f, 1.f)
+    , _initializeGLBudget(InitializeGLBudgetInfo, 10.f, 0.f, 100.f)
 {
     _rootDummy.setIdentifier(SceneGraphNode::RootNodeIdentifier);
     _rootDummy.setScene(this);
+
+    addProperty(_parallelUpdate);
+    _parallelUpdateEfficiency.setReadOnly(true);
+    addProperty(_parallelUpdateEfficiency);
+    addProperty(_initializeGLBudget);
 }
 
 Scene::~Scene() {
@@ -112,6 +160,10 @@ void Scene::unregisterNode(SceneGraphNode* node) {
         removePropertyInterpolation(p);
     }
     removePropertySubOwner(node);
+    _pendingGLNodes.erase(
+        std::remove(_pendingGLNodes.begin(), _pendingGLNodes.end(), node),
+        _pendingGLNodes.end()
+    );
     _dirtyNodeRegistry = true;
 }
 
@@ -121,6 +173,7 @@ void Scene::markNodeRegistryDirty() {
 
 void Scene::updateNodeRegistry() {
     sortTopologically();
+    buildUpdateGraph();
     _dirtyNodeRegistry = false;
 }
 
@@ -201,6 +254,42 @@ void Scene::sortTopologically() {
     _topologicallySortedNodes = nodes;
 }
 
+void Scene::buildUpdateGraph() {
+    const size_t nNodes = _topologicallySortedNodes.size();
+
+    _updateGraph.nodes = _topologicallySortedNodes;
+    _updateGraph.children = std::vector<std::vector<size_t>>(nNodes);
+    _updateGraph.dependents = std::vector<std::vector<size_t>>(nNodes);
+    _updateGraph.inDegree = std::vector<int>(nNodes, 0);
+    _updateGraph.remainingInDegree = std::make_unique<std::atomic<int>[]>(nNodes);
+
+    std::unordered_map<const SceneGraphNode*, size_t> indices;
+    indices.reserve(nNodes);
+    for (size_t i = 0; i < nNodes; ++i) {
+        indices[_updateGraph.nodes[i]] = i;
+    }
+
+    // Nodes with circular dependencies are not part of the sorted list and are never
+    // updated, so edges to them are skipped
+    for (size_t i = 0; i < nNodes; ++i) {
+        const SceneGraphNode* node = _updateGraph.nodes[i];
+        for (const SceneGraphNode* child : node->children()) {
+            const auto it = indices.find(child);
+            if (it != indices.end()) {
+                _updateGraph.children[i].push_back(it->second);
+                _updateGraph.inDegree[it->second]++;
+            }
+        }
+        for (const SceneGraphNode* dependent : node->dependentNodes()) {
+            const auto it = indices.find(dependent);
+            if (it != indices.end()) {
+                _updateGraph.dependents[i].push_back(it->second);
+                _updateGraph.inDegree[it->second]++;
+            }
+        }
+    }
+}
+
 void Scene::initializeNode(SceneGraphNode* node) {
     _initializer->initializeNode(node);
 }
@@ -209,6 +298,44 @@ bool Scene::isInitializing() const {
     return _initializer->isInitializing();
 }
 
+void Scene::initializeGLPendingNodes() {
+    using namespace std::chrono;
+
+    std::vector<SceneGraphNode*> initializedNodes = _initializer->takeInitializedNodes();
+    _pendingGLNodes.insert(
+        _pendingGLNodes.end(),
+        initializedNodes.begin(),
+        initializedNodes.end()
+    );
+
+    const auto startTime = steady_clock::now();
+    const auto budget = duration<float, std::milli>(_initializeGLBudget.value());
+    while (!_pendingGLNodes.empty()) {
+        SceneGraphNode* node = _pendingGLNodes.front();
+        _pendingGLNodes.pop_front();
+
+        try {
+            StartupTrace::Scope traceScope(
+                global::startupTrace,
+                "SceneGraphNode",
+                "InitializeGL " + node->identifier()
+            );
+            node->initializeGL();
+        }
+        catch (const ghoul::RuntimeError& e) {
+            LERRORC(e.component, e.message);
+        }
+
+        if (steady_clock::now() - startTime >= budget) {
+            break;
+        }
+    }
+}
+
+bool Scene::hasPendingGLNodes() const {
+    return !_pendingGLNodes.empty();
+}
+
 /*
 void Scene::initialize() {
     bool useMultipleThreads = true;
@@ -279,18 +406,23 @@ void Scene::initializeGL() {
 */
 
 void Scene::update(const UpdateData& data) {
-    std::vector<SceneGraphNode*> initializedNodes = _initializer->takeInitializedNodes();
+    initializeGLPendingNodes();
 
-    for (SceneGraphNode* node : initializedNodes) {
-        try {
-            node->initializeGL();
-        } catch (const ghoul::RuntimeError& e) {
-            LERRORC(e.component, e.message);
-        }
-    }
     if (_dirtyNodeRegistry) {
         updateNodeRegistry();
     }
+
+    // The performance measurement issues glFinish calls, which are only valid on the main
+    // thread, so we have to fall back to the serial update in that case
+    if (_parallelUpdate && !data.doPerformanceMeasurement) {
+        updateParallel(data);
+    }
+    else {
+        updateSerial(data);
+    }
+}
+
+void Scene::updateSerial(const UpdateData& data) {
     for (SceneGraphNode* node : _topologicallySortedNodes) {
         try {
             LTRACE("Scene::update(begin '" + node->identifier() + "')");
@@ -303,6 +435,168 @@ void Scene::update(const UpdateData& data) {
     }
 }
 
+void Scene::updateParallel(const UpdateData& data) {
+    using namespace std::chrono;
+
+    const size_t nNodes = _updateGraph.nodes.size();
+    if (nNodes == 0) {
+        return;
+    }
+
+    if (!_updateThreadPool) {
+        const unsigned int nThreads = std::thread::hardware_concurrency();
+        // The main thread participates in the update, so we leave one core for it
+        _updateThreadPool = std::make_unique<WorkStealingThreadPool>(
+            std::max(nThreads, 2u) - 1
+        );
+    }
+
+    for (size_t i = 0; i < nNodes; ++i) {
+        _updateGraph.remainingInDegree[i] = _updateGraph.inDegree[i];
+    }
+
+    const std::thread::id mainThread = std::this_thread::get_id();
+    const auto startTime = high_resolution_clock::now();
+
+    // Tasks that have to be executed on the main thread are collected in this queue
+    std::mutex mainThreadMutex;
+    std::condition_variable mainThreadCondition;
+    std::deque<std::function<void()>> mainThreadTasks;
+    size_t nFinished = 0;
+    std::atomic<long long> busyTime = 0;
+
+    auto runOnMainThread = [&](std::function<void()> task) {
+        {
+            std::lock_guard<std::mutex> g(mainThreadMutex);
+            mainThreadTasks.push_back(std::move(task));
+        }
+        mainThreadCondition.notify_one();
+    };
+
+    std::function<void(size_t)> release;
+
+    auto finishNode = [&](size_t i) {
+        for (size_t dependent : _updateGraph.dependents[i]) {
+            release(dependent);
+        }
+
+        // The notification has to happen while holding the lock, as the main thread
+        // might otherwise return and destroy the condition variable in between
+        std::lock_guard<std::mutex> g(mainThreadMutex);
+        ++nFinished;
+        if (nFinished == nNodes) {
+            mainThreadCondition.notify_all();
+        }
+    };
+
+    auto updateRenderable = [&](size_t i) {
+        const auto start = high_resolution_clock::now();
+        SceneGraphNode* node = _updateGraph.nodes[i];
+        try {
+            node->updateRenderable(data);
+        }
+        catch (const ghoul::RuntimeError& e) {
+            LERRORC(e.component, e.what());
+        }
+        catch (const std::exception& e) {
+            // An exception must not escape the task, as the update would otherwise wait
+            // for this node forever
+            LERROR(fmt::format(
+                "Error updating renderable of '{}': {}", node->identifier(), e.what()
+            ));
+        }
+        busyTime += (high_resolution_clock::now() - start).count();
+        finishNode(i);
+    };
+
+    auto updateTransforms = [&](size_t i) {
+        const auto start = high_resolution_clock::now();
+        SceneGraphNode* node = _updateGraph.nodes[i];
+        bool isActive = false;
+        try {
+            isActive = node->updateTransforms(data);
+        }
+        catch (const ghoul::RuntimeError& e) {
+            LERRORC(e.component, e.what());
+        }
+        catch (const std::exception& e) {
+            LERROR(fmt::format(
+                "Error updating transformation of '{}': {}", node->identifier(), e.what()
+            ));
+        }
+        busyTime += (high_resolution_clock::now() - start).count();
+
+        // The children only need the world transformation of this node, so they can
+        // start while the renderable is being updated
+        for (size_t child : _updateGraph.children[i]) {
+            release(child);
+        }
+
+        if (!isActive) {
+            finishNode(i);
+        }
+        else if (node->isRenderableUpdateThreadSafe() ||
+                 std::this_thread::get_id() == mainThread)
+        {
+            updateRenderable(i);
+        }
+        else {
+            runOnMainThread([&updateRenderable, i]() { updateRenderable(i); });
+        }
+    };
+
+    release = [&](size_t i) {
+        if (--_updateGraph.remainingInDegree[i] > 0) {
+            return;
+        }
+        if (_updateGraph.nodes[i]->isTransformUpdateThreadSafe()) {
+            _updateThreadPool->enqueue([&updateTransforms, i]() { updateTransforms(i); });
+        }
+        else {
+            runOnMainThread([&updateTransforms, i]() { updateTransforms(i); });
+        }
+    };
+
+    for (size_t i = 0; i < nNodes; ++i) {
+        if (_updateGraph.inDegree[i] == 0) {
+            // Increment the counter first as release will decrement it
+            ++_updateGraph.remainingInDegree[i];
+            release(i);
+        }
+    }
+
+    // The main thread works on its own tasks first and helps the worker threads if there
+    // is nothing else to do
+    std::unique_lock<std::mutex> lock(mainThreadMutex);
+    while (nFinished < nNodes) {
+        if (!mainThreadTasks.empty()) {
+            std::function<void()> task = std::move(mainThreadTasks.front());
+            mainThreadTasks.pop_front();
+            lock.unlock();
+            task();
+            lock.lock();
+            continue;
+        }
+
+        lock.unlock();
+        const bool ranTask = _updateThreadPool->runPendingTask();
+        lock.lock();
+        if (!ranTask) {
+            mainThreadCondition.wait_for(lock, microseconds(50), [&]() {
+                return !mainThreadTasks.empty() || nFinished == nNodes;
+            });
+        }
+    }
+
+    const double wallTime = static_cast<double>(
+        (high_resolution_clock::now() - startTime).count()
+    );
+    const double nThreads = static_cast<double>(_updateThreadPool->numThreads() + 1);
+    _parallelUpdateEfficiency = static_cast<float>(
+        std::min(static_cast<double>(busyTime) / (wallTime * nThreads), 1.0)
+    );
+}
+
 void Scene::render(const RenderData& data, RendererTasks& tasks) {
     for (SceneGraphNode* node : _topologicallySortedNodes) {
         try {
@@ -318,6 +612,7 @@ void Scene::render(const RenderData& data, RendererTasks& tasks) {
 
 void Scene::clear() {
     LINFO("Clearing current scene graph");
+    _pendingGLNodes.clear();
     _rootDummy.clearChildren();
 }
 
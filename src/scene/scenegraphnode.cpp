@@ -317,12 +317,18 @@ void SceneGraphNode::traversePostOrder(const std::function<void(SceneGraphNode*)
 }
 
 void SceneGraphNode::update(const UpdateData& data) {
+    if (updateTransforms(data)) {
+        updateRenderable(data);
+    }
+}
+
+bool SceneGraphNode::updateTransforms(const UpdateData& data) {
     State s = _state;
     if (s != State::Initialized && _state != State::GLInitialized) {
-        return;
+        return false;
     }
     if (!isTimeFrameActive(data.time)) {
-        return;
+        return false;
     }
 
     if (_transform.translation) {
@@ -372,35 +378,75 @@ void SceneGraphNode::update(const UpdateData& data) {
             _transform.scale->update(data);
         }
     }
-    UpdateData newUpdateData = data;
 
-    _worldRotationCached = calculateWorldRotation();
-    _worldScaleCached = calculateWorldScale();
-    // Assumes _worldRotationCached and _worldScaleCached have been calculated for parent
-    _worldPositionCached = calculateWorldPosition();
+    updateWorldTransform();
+    return true;
+}
 
-    newUpdateData.modelTransform.translation = worldPosition();
-    newUpdateData.modelTransform.rotation = worldRotationMatrix();
-    newUpdateData.modelTransform.scale = worldScale();
+bool SceneGraphNode::updateWorldTransform() {
+    const glm::dvec3 position = _transform.translation->position();
+    const glm::dmat3& rotation = _transform.rotation->matrix();
+    const double scale = _transform.scale->scaleValue();
+    const unsigned long long parentVersion = _parent ? _parent->_worldTransformVersion : 0;
 
-    glm::dmat4 translation = glm::translate(
-        glm::dmat4(1.0),
-        newUpdateData.modelTransform.translation
-    );
-    glm::dmat4 rotation = glm::dmat4(newUpdateData.modelTransform.rotation);
-    glm::dmat4 scaling = glm::scale(
-        glm::dmat4(1.0),
-        glm::dvec3(
-            newUpdateData.modelTransform.scale,
-            newUpdateData.modelTransform.scale,
-            newUpdateData.modelTransform.scale
-        )
+    const bool isUnchanged = !_isWorldTransformDirty &&
+                             parentVersion == _parentWorldTransformVersion &&
+                             position == _localPositionCached &&
+                             rotation == _localRotationCached &&
+                             scale == _localScaleCached;
+    if (isUnchanged) {
+        return false;
+    }
+
+    _localPositionCached = position;
+    _localRotationCached = rotation;
+    _localScaleCached = scale;
+    _parentWorldTransformVersion = parentVersion;
+    _isWorldTransformDirty = false;
+
+    // The parent has already been updated this frame as the nodes are updated in
+    // topological order, so its cached values can be used directly
+    if (_parent) {
+        const glm::dmat3& parentRotation = _parent->_worldRotationCached;
+        const double parentScale = _parent->_worldScaleCached;
+
+        _worldPositionCached = _parent->_worldPositionCached +
+                               parentRotation * parentScale * position;
+        _worldRotationCached = parentRotation * rotation;
+        _worldScaleCached = parentScale * scale;
+    }
+    else {
+        _worldPositionCached = position;
+        _worldRotationCached = rotation;
+        _worldScaleCached = scale;
+    }
+
+    // Model transform = T * R * S. Since the rotation is orthonormal and the scale is
+    // uniform, the inverse is S^-1 * R^T * T^-1, which avoids a general 4x4 inversion
+    _modelTransformCached = glm::dmat4(_worldRotationCached * _worldScaleCached);
+    _modelTransformCached[3] = glm::dvec4(_worldPositionCached, 1.0);
+
+    const glm::dmat3 inverseRotationScale =
+        glm::transpose(_worldRotationCached) / _worldScaleCached;
+    _inverseModelTransformCached = glm::dmat4(inverseRotationScale);
+    _inverseModelTransformCached[3] = glm::dvec4(
+        -(inverseRotationScale * _worldPositionCached),
+        1.0
     );
 
-    _modelTransformCached = translation * rotation * scaling;
-    _inverseModelTransformCached = glm::inverse(_modelTransformCached);
+    ++_worldTransformVersion;
+    return true;
+}
+
+void SceneGraphNode::updateRenderable(const UpdateData& data) {
+    // The OpenGL initialization of a node can happen several frames after its
+    // initialization, and the renderable might use its OpenGL objects in the update
+    if (_renderable && _state == State::GLInitialized && _renderable->isReady()) {
+        UpdateData newUpdateData = data;
+        newUpdateData.modelTransform.translation = _worldPositionCached;
+        newUpdateData.modelTransform.rotation = _worldRotationCached;
+        newUpdateData.modelTransform.scale = _worldScaleCached;
 
-    if (_renderable && _renderable->isReady()) {
         if (data.doPerformanceMeasurement) {
             glFinish();
             auto start = std::chrono::high_resolution_clock::now();
@@ -417,6 +463,16 @@ void SceneGraphNode::update(const UpdateData& data) {
     }
 }
 
+bool SceneGraphNode::isTransformUpdateThreadSafe() const {
+    return (!_transform.translation || _transform.translation->isThreadSafe()) &&
+           (!_transform.rotation || _transform.rotation->isThreadSafe()) &&
+           (!_transform.scale || _transform.scale->isThreadSafe());
+}
+
+bool SceneGraphNode::isRenderableUpdateThreadSafe() const {
+    return !_renderable || !_renderable->isUpdateGLBound();
+}
+
 void SceneGraphNode::render(const RenderData& data, RendererTasks& tasks) {
     if (_state != State::GLInitialized) {
         return;
@@ -477,6 +533,7 @@ void SceneGraphNode::attachChild(std::unique_ptr<SceneGraphNode> child) {
 
     // Create link between parent and child
     child->_parent = this;
+    child->_isWorldTransformDirty = true;
     SceneGraphNode* childRaw = child.get();
     _children.push_back(std::move(child));
 
@@ -658,21 +715,6 @@ bool SceneGraphNode::hasGuiHintHidden() const {
     return _guiHidden;
 }
 
-glm::dvec3 SceneGraphNode::calculateWorldPosition() const {
-    // recursive up the hierarchy if there are parents available
-    if (_parent) {
-        const glm::dvec3 wp = _parent->calculateWorldPosition();
-        const glm::dmat3 wrot = _parent->worldRotationMatrix();
-        const double ws = _parent->worldScale();
-        const glm::dvec3 p = position();
-
-        return wp + wrot * ws * p;
-    }
-    else {
-        return position();
-    }
-}
-
 bool SceneGraphNode::isTimeFrameActive(const Time& time) const {
     for (SceneGraphNode* dep : _dependencies) {
         if (!dep->isTimeFrameActive(time)) {
@@ -687,26 +729,6 @@ bool SceneGraphNode::isTimeFrameActive(const Time& time) const {
     return !_timeFrame || _timeFrame->isActive(time);
 }
 
-glm::dmat3 SceneGraphNode::calculateWorldRotation() const {
-    // recursive up the hierarchy if there are parents available
-    if (_parent) {
-        return _parent->calculateWorldRotation() * rotationMatrix();
-    }
-    else {
-        return rotationMatrix();
-    }
-}
-
-double SceneGraphNode::calculateWorldScale() const {
-    // recursive up the hierarchy if there are parents available
-    if (_parent) {
-        return _parent->calculateWorldScale() * scale();
-    }
-    else {
-        return scale();
-    }
-}
-
 SceneGraphNode* SceneGraphNode::parent() const {
     return _parent;
 }
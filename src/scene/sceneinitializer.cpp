@@ -28,12 +28,20 @@
 #include <openspace/engine/openspaceengine.h>
 #include <openspace/rendering/loadingscreen.h>
 #include <openspace/scene/scenegraphnode.h>
+#include <openspace/util/startuptrace.h>
 #include <ghoul/logging/logmanager.h>
 
 namespace openspace {
 
 void SingleThreadedSceneInitializer::initializeNode(SceneGraphNode* node) {
-    node->initialize();
+    {
+        StartupTrace::Scope traceScope(
+            global::startupTrace,
+            "SceneGraphNode",
+            "Initialize " + node->identifier()
+        );
+        node->initialize();
+    }
     _initializedNodes.push_back(node);
 }
 
@@ -65,7 +73,14 @@ void MultiThreadedSceneInitializer::initializeNode(SceneGraphNode* node) {
             );
         }
 
-        node->initialize();
+        {
+            StartupTrace::Scope traceScope(
+                global::startupTrace,
+                "SceneGraphNode",
+                "Initialize " + node->identifier()
+            );
+            node->initialize();
+        }
         std::lock_guard<std::mutex> g(_mutex);
         _initializedNodes.push_back(node);
         _initializingNodes.erase(node);
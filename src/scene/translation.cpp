@@ -91,6 +91,10 @@ void Translation::update(const UpdateData& data) {
     }
 }
 
+bool Translation::isThreadSafe() const {
+    return false;
+}
+
 glm::dvec3 Translation::position() const {
     return _cachedPosition;
 }
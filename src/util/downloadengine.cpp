@@ -0,0 +1,585 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <openspace/util/downloadengine.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/filesystem/file.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/logging/logmanager.h>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <filesystem>
+
+#ifdef OPENSPACE_CURL_ENABLED
+#ifdef WIN32
+#pragma warning (push)
+#pragma warning (disable: 4574) // 'INCL_WINSOCK_API_TYPEDEFS' is defined to be '0'
+#endif // WIN32
+
+#include <curl/curl.h>
+
+#ifdef WIN32
+#pragma warning (pop)
+#endif // WIN32
+#endif
+
+namespace {
+    constexpr const char* _loggerCat = "DownloadEngine";
+
+    constexpr const long StatusCodeOk = 200;
+    constexpr const long StatusCodePartialContent = 206;
+    constexpr const long StatusCodeRangeNotSatisfiable = 416;
+
+    // The longest time the thread waits for network activity before it checks the queue
+    // for new transfers again
+    constexpr const int PollTimeoutMs = 50;
+
+    size_t fileSize(const std::string& path) {
+        std::ifstream file(path, std::ifstream::binary | std::ifstream::ate);
+        if (!file.good()) {
+            return 0;
+        }
+        const std::streamoff size = file.tellg();
+        return size > 0 ? static_cast<size_t>(size) : 0;
+    }
+
+    std::string validatorPath(const std::string& destination) {
+        return destination + openspace::DownloadEngine::ValidatorExtension;
+    }
+
+    // Returns the validator that was stored for the partial file at the destination, or
+    // an empty string if there is none
+    std::string readValidator(const std::string& destination) {
+        std::ifstream file(validatorPath(destination));
+        std::string validator;
+        std::getline(file, validator);
+        return validator;
+    }
+
+    void removeValidator(const std::string& destination) {
+        std::error_code ec;
+        std::filesystem::remove(validatorPath(destination), ec);
+    }
+
+    // Returns the value of the header field with the name, which has to be lowercase, in
+    // the header line, or an empty string if the line contains a different field
+    std::string headerValue(const std::string& line, const std::string& name) {
+        if (line.size() <= name.size() || line[name.size()] != ':') {
+            return "";
+        }
+        for (size_t i = 0; i < name.size(); ++i) {
+            const int c = static_cast<unsigned char>(line[i]);
+            if (std::tolower(c) != name[i]) {
+                return "";
+            }
+        }
+        const size_t begin = line.find_first_not_of(" \t", name.size() + 1);
+        const size_t end = line.find_last_not_of(" \t\r\n");
+        if (begin == std::string::npos || end < begin) {
+            return "";
+        }
+        return line.substr(begin, end - begin + 1);
+    }
+} // namespace
+
+namespace openspace {
+
+DownloadEngine::Transfer::Transfer(Request request)
+    : _request(std::move(request))
+    , _isResumeAllowed(_request.resume)
+{}
+
+const std::string& DownloadEngine::Transfer::url() const {
+    return _request.url;
+}
+
+const std::string& DownloadEngine::Transfer::destination() const {
+    return _request.destination;
+}
+
+DownloadEngine::Transfer::State DownloadEngine::Transfer::state() const {
+    return _state;
+}
+
+bool DownloadEngine::Transfer::isFinished() const {
+    const State s = _state;
+    return s == State::Succeeded || s == State::Failed || s == State::Cancelled;
+}
+
+void DownloadEngine::Transfer::wait() {
+    std::unique_lock<std::mutex> lock(_mutex);
+    _finishCondition.wait(lock, [this]() { return isFinished(); });
+}
+
+void DownloadEngine::Transfer::cancel() {
+    _shouldCancel = true;
+}
+
+const std::vector<char>& DownloadEngine::Transfer::data() const {
+    return _data;
+}
+
+void DownloadEngine::Transfer::finish(State state) {
+    if (_file.is_open()) {
+        _file.close();
+    }
+
+    // A transfer whose size was never reported counts with the bytes it has received,
+    // so that the total of the progress becomes known once all transfers are finished
+    if (_request.progress && !_isSizeKnown) {
+        _isSizeKnown = true;
+        _reportedTotalBytes = _reportedBytes;
+        _request.progress->totalBytes += _reportedBytes;
+        --_request.progress->nUnknownSizes;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _state = state;
+    }
+    _finishCondition.notify_all();
+}
+
+void DownloadEngine::Transfer::reportProgress(size_t downloadedBytes, size_t totalBytes)
+{
+    if (!_request.progress) {
+        return;
+    }
+    Progress& progress = *_request.progress;
+
+    if (!_isSizeKnown && totalBytes > 0) {
+        _isSizeKnown = true;
+        _reportedTotalBytes = totalBytes;
+        progress.totalBytes += totalBytes;
+        --progress.nUnknownSizes;
+    }
+    if (downloadedBytes > _reportedBytes) {
+        progress.downloadedBytes += downloadedBytes - _reportedBytes;
+        _reportedBytes = downloadedBytes;
+    }
+}
+
+void DownloadEngine::Transfer::resetProgress() {
+    if (!_request.progress) {
+        return;
+    }
+    Progress& progress = *_request.progress;
+
+    progress.downloadedBytes -= _reportedBytes;
+    _reportedBytes = 0;
+    if (_isSizeKnown) {
+        progress.totalBytes -= _reportedTotalBytes;
+        ++progress.nUnknownSizes;
+        _isSizeKnown = false;
+        _reportedTotalBytes = 0;
+    }
+}
+
+DownloadEngine::DownloadEngine(int maxConcurrentTransfers)
+    : _maxConcurrentTransfers(std::max(maxConcurrentTransfers, 1))
+{
+    CURLM* multiHandle = curl_multi_init();
+    // The connection cache holds one connection per concurrent transfer, so that every
+    // transfer that is started finds an open connection to the host if there is one
+    const long nConnections = static_cast<long>(_maxConcurrentTransfers);
+    curl_multi_setopt(multiHandle, CURLMOPT_MAX_TOTAL_CONNECTIONS, nConnections);
+    curl_multi_setopt(multiHandle, CURLMOPT_MAXCONNECTS, nConnections);
+    curl_multi_setopt(multiHandle, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    _multiHandle = multiHandle;
+
+    _thread = std::thread([this]() { run(); });
+}
+
+DownloadEngine::~DownloadEngine() {
+    {
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        _shouldStop = true;
+    }
+    _queueCondition.notify_one();
+    _thread.join();
+
+    for (void* handle : _idleHandles) {
+        curl_easy_cleanup(handle);
+    }
+    curl_multi_cleanup(_multiHandle);
+}
+
+std::shared_ptr<DownloadEngine::Transfer> DownloadEngine::enqueue(Request request) {
+    if (request.progress) {
+        ++request.progress->nUnknownSizes;
+    }
+    std::shared_ptr<Transfer> transfer = std::make_shared<Transfer>(std::move(request));
+    {
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        _queue.push_back(transfer);
+    }
+    _queueCondition.notify_one();
+    return transfer;
+}
+
+int DownloadEngine::nOpenedConnections() const {
+    return _nOpenedConnections;
+}
+
+void DownloadEngine::run() {
+    std::vector<std::shared_ptr<Transfer>> newTransfers;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_queueMutex);
+            if (_runningTransfers.empty()) {
+                _queueCondition.wait(
+                    lock,
+                    [this]() { return _shouldStop || !_queue.empty(); }
+                );
+            }
+            if (_shouldStop) {
+                break;
+            }
+
+            const size_t nFree = _maxConcurrentTransfers - _runningTransfers.size();
+            while (newTransfers.size() < nFree && !_queue.empty()) {
+                newTransfers.push_back(std::move(_queue.front()));
+                _queue.pop_front();
+            }
+        }
+
+        // Opening the files happens outside of the lock to not block enqueue
+        for (const std::shared_ptr<Transfer>& transfer : newTransfers) {
+            startTransfer(transfer);
+        }
+        newTransfers.clear();
+
+        int nRunning = 0;
+        curl_multi_perform(_multiHandle, &nRunning);
+
+        int nMessages = 0;
+        while (CURLMsg* msg = curl_multi_info_read(_multiHandle, &nMessages)) {
+            if (msg->msg == CURLMSG_DONE) {
+                finishTransfer(msg->easy_handle, msg->data.result);
+            }
+        }
+
+        if (!_runningTransfers.empty()) {
+            int nFileDescriptors = 0;
+            curl_multi_wait(_multiHandle, nullptr, 0, PollTimeoutMs, &nFileDescriptors);
+            if (nFileDescriptors == 0) {
+                // curl_multi_wait returns immediately if curl has nothing to wait for,
+                // for example while a host name is resolved
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+    }
+
+    for (const std::shared_ptr<Transfer>& transfer : _runningTransfers) {
+        curl_multi_remove_handle(_multiHandle, transfer->_handle);
+        curl_easy_cleanup(transfer->_handle);
+        transfer->_handle = nullptr;
+        curl_slist_free_all(reinterpret_cast<curl_slist*>(transfer->_headers));
+        transfer->_headers = nullptr;
+        transfer->finish(Transfer::State::Cancelled);
+    }
+    _runningTransfers.clear();
+
+    std::lock_guard<std::mutex> lock(_queueMutex);
+    for (const std::shared_ptr<Transfer>& transfer : _queue) {
+        transfer->finish(Transfer::State::Cancelled);
+    }
+    _queue.clear();
+}
+
+bool DownloadEngine::startTransfer(const std::shared_ptr<Transfer>& transfer) {
+    if (transfer->_shouldCancel) {
+        transfer->finish(Transfer::State::Cancelled);
+        return false;
+    }
+
+    const Request& request = transfer->_request;
+    transfer->_resumeOffset = 0;
+    transfer->_hasCheckedResponse = false;
+    transfer->_validator.clear();
+    transfer->_data.clear();
+
+    if (!request.destination.empty()) {
+        ghoul::filesystem::File destination(request.destination);
+        const std::string& directory = destination.directoryName();
+        if (!FileSys.directoryExists(directory)) {
+            FileSys.createDirectory(
+                directory,
+                ghoul::filesystem::FileSystem::Recursive::Yes
+            );
+        }
+
+        // Without a validator there is no way to know whether the existing part still
+        // belongs to the file on the server, so it is only kept if there is one
+        std::string validator;
+        if (transfer->_isResumeAllowed) {
+            validator = readValidator(request.destination);
+            if (!validator.empty()) {
+                transfer->_resumeOffset = fileSize(request.destination);
+            }
+        }
+        if (transfer->_resumeOffset > 0) {
+            transfer->_validator = std::move(validator);
+        }
+        else {
+            removeValidator(request.destination);
+        }
+        const std::ofstream::openmode mode = std::ofstream::binary |
+            (transfer->_resumeOffset > 0 ? std::ofstream::app : std::ofstream::trunc);
+        transfer->_file.open(request.destination, mode);
+        if (!transfer->_file.good()) {
+            LERROR(fmt::format("Cannot open file '{}'", request.destination));
+            transfer->finish(Transfer::State::Failed);
+            return false;
+        }
+    }
+
+    CURL* handle = nullptr;
+    if (_idleHandles.empty()) {
+        handle = curl_easy_init();
+        if (!handle) {
+            LERROR(fmt::format("Cannot create transfer for '{}'", request.url));
+            transfer->finish(Transfer::State::Failed);
+            return false;
+        }
+    }
+    else {
+        // A reset handle keeps its connection and DNS caches
+        handle = _idleHandles.back();
+        _idleHandles.pop_back();
+        curl_easy_reset(handle);
+    }
+
+    curl_easy_setopt(handle, CURLOPT_URL, request.url.c_str()); // NOLINT
+    curl_easy_setopt(handle, CURLOPT_FOLLOWLOCATION, 1L); // NOLINT
+
+    curl_easy_setopt(handle, CURLOPT_HEADERDATA, transfer.get()); // NOLINT
+    curl_easy_setopt(handle, CURLOPT_HEADERFUNCTION, &headerCallback); // NOLINT
+
+    curl_easy_setopt(handle, CURLOPT_WRITEDATA, transfer.get()); // NOLINT
+    curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, &writeCallback); // NOLINT
+
+    curl_easy_setopt(handle, CURLOPT_NOPROGRESS, 0L); // NOLINT
+    curl_easy_setopt(handle, CURLOPT_XFERINFODATA, transfer.get()); // NOLINT
+    curl_easy_setopt(handle, CURLOPT_XFERINFOFUNCTION, &progressCallback); // NOLINT
+
+    if (request.timeoutSeconds > 0) {
+        const long timeout = static_cast<long>(request.timeoutSeconds);
+        curl_easy_setopt(handle, CURLOPT_TIMEOUT, timeout); // NOLINT
+    }
+    if (transfer->_resumeOffset > 0) {
+        const curl_off_t offset = static_cast<curl_off_t>(transfer->_resumeOffset);
+        curl_easy_setopt(handle, CURLOPT_RESUME_FROM_LARGE, offset); // NOLINT
+
+        // The server answers with the whole file instead of the range if the validator
+        // doesn't match, which curl reports as a range error
+        const std::string ifRange = "If-Range: " + transfer->_validator;
+        curl_slist* headers = curl_slist_append(nullptr, ifRange.c_str());
+        curl_easy_setopt(handle, CURLOPT_HTTPHEADER, headers); // NOLINT
+        transfer->_headers = headers;
+        transfer->reportProgress(transfer->_resumeOffset, 0);
+    }
+
+    transfer->_handle = handle;
+    transfer->_state = Transfer::State::Running;
+    curl_multi_add_handle(_multiHandle, handle);
+    _runningTransfers.push_back(transfer);
+    return true;
+}
+
+void DownloadEngine::finishTransfer(void* handle, int result) {
+    auto it = std::find_if(
+        _runningTransfers.begin(),
+        _runningTransfers.end(),
+        [handle](const std::shared_ptr<Transfer>& t) { return t->_handle == handle; }
+    );
+    if (it == _runningTransfers.end()) {
+        return;
+    }
+    std::shared_ptr<Transfer> transfer = std::move(*it);
+    _runningTransfers.erase(it);
+
+    long responseCode = 0;
+    curl_easy_getinfo(handle, CURLINFO_RESPONSE_CODE, &responseCode); // NOLINT
+    long nConnects = 0;
+    curl_easy_getinfo(handle, CURLINFO_NUM_CONNECTS, &nConnects); // NOLINT
+    _nOpenedConnections += static_cast<int>(nConnects);
+
+    curl_multi_remove_handle(_multiHandle, handle);
+    transfer->_handle = nullptr;
+    curl_slist_free_all(reinterpret_cast<curl_slist*>(transfer->_headers));
+    transfer->_headers = nullptr;
+    if (static_cast<int>(_idleHandles.size()) < _maxConcurrentTransfers) {
+        _idleHandles.push_back(handle);
+    }
+    else {
+        curl_easy_cleanup(handle);
+    }
+
+    const CURLcode code = static_cast<CURLcode>(result);
+    const bool isResumed = transfer->_resumeOffset > 0;
+    // curl accepts a full response to a resumed request without an error if the file on
+    // the server has the same size as the existing part, but the contents can differ
+    const bool isFullResponse = responseCode == StatusCodeOk;
+    if (isResumed && !transfer->_shouldCancel &&
+        (code == CURLE_RANGE_ERROR || isFullResponse ||
+         responseCode == StatusCodeRangeNotSatisfiable))
+    {
+        // The server does not support ranges, the file on the server has changed, or
+        // the existing part of the file does not fit it, so we start over with the
+        // whole file
+        LDEBUG(fmt::format("Cannot resume '{}', downloading again", transfer->url()));
+        transfer->_file.close();
+        transfer->resetProgress();
+        transfer->_isResumeAllowed = false;
+        startTransfer(transfer);
+        return;
+    }
+
+    if (transfer->_shouldCancel || code == CURLE_ABORTED_BY_CALLBACK) {
+        transfer->finish(Transfer::State::Cancelled);
+        return;
+    }
+
+    const bool isValidResponse = responseCode == StatusCodeOk ||
+                                 (isResumed && responseCode == StatusCodePartialContent);
+    if (code != CURLE_OK || !isValidResponse) {
+        if (isValidResponse || responseCode == 0) {
+            LWARNING(fmt::format(
+                "Error downloading '{}': {}", transfer->url(), curl_easy_strerror(code)
+            ));
+        }
+        else {
+            LWARNING(fmt::format(
+                "Error downloading '{}': Response code {}", transfer->url(), responseCode
+            ));
+        }
+        transfer->finish(Transfer::State::Failed);
+        return;
+    }
+
+    if (transfer->_file.is_open()) {
+        transfer->_file.close();
+        if (transfer->_file.fail()) {
+            LWARNING(fmt::format("Error writing file '{}'", transfer->destination()));
+            transfer->finish(Transfer::State::Failed);
+            return;
+        }
+        // The file is complete, so there is nothing left to resume
+        removeValidator(transfer->destination());
+    }
+    transfer->finish(Transfer::State::Succeeded);
+}
+
+size_t DownloadEngine::headerCallback(char* buffer, size_t size, size_t nItems,
+                                      void* userData)
+{
+    Transfer& transfer = *reinterpret_cast<Transfer*>(userData);
+    const size_t nBytes = size * nItems;
+    const std::string line(buffer, nBytes);
+
+    if (line.compare(0, 5, "HTTP/") == 0) {
+        // The status line of a new response, for example after a redirect. A resumed
+        // transfer keeps the validator it sent, as a partial response doesn't change it
+        if (transfer._resumeOffset == 0) {
+            transfer._validator.clear();
+        }
+        return nBytes;
+    }
+    if (transfer._resumeOffset > 0) {
+        return nBytes;
+    }
+
+    // If-Range requires a strong comparison, so weak ETags are not usable. An ETag is
+    // preferred over the date, which only has a resolution of seconds
+    const std::string etag = headerValue(line, "etag");
+    if (!etag.empty() && etag.compare(0, 2, "W/") != 0) {
+        transfer._validator = etag;
+    }
+    const std::string lastModified = headerValue(line, "last-modified");
+    if (!lastModified.empty() && transfer._validator.empty()) {
+        transfer._validator = lastModified;
+    }
+    return nBytes;
+}
+
+size_t DownloadEngine::writeCallback(char* ptr, size_t size, size_t nmemb,
+                                     void* userData)
+{
+    Transfer& transfer = *reinterpret_cast<Transfer*>(userData);
+    const size_t nBytes = size * nmemb;
+
+    if (!transfer._hasCheckedResponse) {
+        transfer._hasCheckedResponse = true;
+        long responseCode = 0;
+        // NOLINTNEXTLINE
+        curl_easy_getinfo(transfer._handle, CURLINFO_RESPONSE_CODE, &responseCode);
+        if (responseCode != StatusCodeOk && responseCode != StatusCodePartialContent) {
+            // Returning a different number of bytes aborts the transfer, so that an
+            // error page is never written to the file or appended to a partial file
+            return 0;
+        }
+
+        // The validator is stored before the first byte of a new file is written, so
+        // that any part of the file that is left behind can be resumed
+        if (transfer._file.is_open() && transfer._resumeOffset == 0 &&
+            !transfer._validator.empty())
+        {
+            std::ofstream validator(validatorPath(transfer._request.destination));
+            validator << transfer._validator << '\n';
+        }
+    }
+
+    if (transfer._file.is_open()) {
+        transfer._file.write(ptr, static_cast<std::streamsize>(nBytes));
+        return transfer._file.good() ? nBytes : 0;
+    }
+    else {
+        transfer._data.insert(transfer._data.end(), ptr, ptr + nBytes);
+        return nBytes;
+    }
+}
+
+int DownloadEngine::progressCallback(void* userData, int64_t nTotalDownloadBytes,
+                                     int64_t nDownloadedBytes, int64_t, int64_t)
+{
+    Transfer& transfer = *reinterpret_cast<Transfer*>(userData);
+    if (transfer._shouldCancel) {
+        // A nonzero value aborts the transfer
+        return 1;
+    }
+
+    // The values that curl reports do not include the part that was resumed
+    const size_t offset = transfer._resumeOffset;
+    transfer.reportProgress(
+        offset + static_cast<size_t>(nDownloadedBytes),
+        nTotalDownloadBytes > 0 ? offset + static_cast<size_t>(nTotalDownloadBytes) : 0
+    );
+    return 0;
+}
+
+} // namespace openspace
@@ -0,0 +1,352 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <openspace/util/ephemeriscache.h>
+
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+
+namespace {
+    constexpr const int NumberNodes = openspace::EphemerisCache::Degree + 1;
+
+    // A piece is only fitted once the evaluations that missed it have cost as much as
+    // fitting it would have: one evaluation per node and one per check point. This
+    // keeps sparse, one-off requests, such as the samples of a long trail, from
+    // fitting pieces that would never be used again
+    constexpr const int FitCost = 2 * NumberNodes + 1;
+
+    // The number of pieces for which the misses are counted
+    constexpr const int NumberCandidates = 16;
+
+    struct ChebyshevTables {
+        ChebyshevTables() {
+            const double pi = std::acos(-1.0);
+            for (int j = 0; j < NumberNodes; ++j) {
+                nodes[j] = std::cos(pi * (j + 0.5) / NumberNodes);
+                for (int k = 0; k < NumberNodes; ++k) {
+                    basis[k][j] = std::cos(pi * k * (j + 0.5) / NumberNodes);
+                }
+            }
+            // The extrema of the first omitted polynomial, which lie between the nodes,
+            // and the endpoints of the piece
+            for (int j = 0; j <= NumberNodes; ++j) {
+                checkPoints[j] = std::cos(pi * j / NumberNodes);
+            }
+        }
+
+        std::array<double, NumberNodes> nodes;
+        std::array<std::array<double, NumberNodes>, NumberNodes> basis;
+        std::array<double, NumberNodes + 1> checkPoints;
+    };
+
+    const ChebyshevTables& tables() {
+        static const ChebyshevTables Tables;
+        return Tables;
+    }
+
+    double pieceLength(int level) {
+        return openspace::EphemerisCache::BaseWindowLength /
+               static_cast<double>(int64_t(1) << level);
+    }
+
+    int64_t pieceIndex(double time, int level) {
+        return static_cast<int64_t>(std::floor(time / pieceLength(level)));
+    }
+
+    // Evaluates the Chebyshev series with the coefficients c at x in [-1, 1] using the
+    // Clenshaw recurrence
+    template <typename T>
+    double evaluateSeries(const T* c, double x) {
+        double b1 = 0.0;
+        double b2 = 0.0;
+        for (int k = NumberNodes - 1; k >= 1; --k) {
+            const double b0 = static_cast<double>(c[k]) + 2.0 * x * b1 - b2;
+            b2 = b1;
+            b1 = b0;
+        }
+        return static_cast<double>(c[0]) + x * b1 - b2;
+    }
+} // namespace
+
+namespace openspace {
+
+struct EphemerisCache::Slot {
+    // Odd while the slot is being written
+    std::atomic<uint32_t> sequence = 0;
+    std::atomic<int> level = -1;
+    std::atomic<int64_t> index = 0;
+    std::atomic<uint64_t> generation = 0;
+    std::atomic<bool> isDirect = false;
+    std::unique_ptr<std::atomic<double>[]> coefficients;
+};
+
+struct EphemerisCache::Candidate {
+    int level = -1;
+    int64_t index = 0;
+    uint64_t generation = 0;
+    int nMisses = 0;
+};
+
+EphemerisCache::EphemerisCache(int nComponents, Function function,
+                               double absoluteTolerance, double relativeTolerance)
+    : _nComponents(nComponents)
+    , _function(std::move(function))
+    , _absoluteTolerance(absoluteTolerance)
+    , _relativeTolerance(relativeTolerance)
+    , _slots(std::make_unique<Slot[]>(NumberSlots))
+    , _candidates(NumberCandidates)
+{
+    ghoul_assert(_nComponents > 0, "Number of components must be positive");
+    ghoul_assert(_function, "Function must not be empty");
+
+    for (int i = 0; i < NumberSlots; ++i) {
+        _slots[i].coefficients = std::make_unique<std::atomic<double>[]>(
+            _nComponents * NumberNodes
+        );
+    }
+}
+
+EphemerisCache::~EphemerisCache() {}
+
+void EphemerisCache::evaluate(double time, double* result) {
+    if (!std::isfinite(time)) {
+        ++_nMisses;
+        _function(time, result);
+        return;
+    }
+
+    const uint64_t generation = _generation.load(std::memory_order_acquire);
+    if (lookup(time, generation, result)) {
+        return;
+    }
+
+    ++_nMisses;
+    _function(time, result);
+
+    std::lock_guard<std::mutex> lock(_fitMutex);
+    const int64_t index = pieceIndex(time, _fitLevel);
+    const auto it = std::find_if(
+        _candidates.begin(),
+        _candidates.end(),
+        [&](const Candidate& c) {
+            return c.level == _fitLevel && c.index == index &&
+                   c.generation == generation;
+        }
+    );
+    if (it == _candidates.end()) {
+        _candidates[_nextCandidate] = { _fitLevel, index, generation, 1 };
+        _nextCandidate = (_nextCandidate + 1) % NumberCandidates;
+    }
+    else if (++(it->nMisses) >= FitCost) {
+        *it = Candidate();
+        fit(time, generation);
+    }
+}
+
+void EphemerisCache::invalidate() {
+    _generation.fetch_add(1, std::memory_order_release);
+}
+
+int EphemerisCache::nComponents() const {
+    return _nComponents;
+}
+
+EphemerisCache::Statistics EphemerisCache::statistics() const {
+    Statistics s;
+    s.hits = _nHits.load(std::memory_order_relaxed);
+    s.misses = _nMisses.load(std::memory_order_relaxed);
+    s.directEvaluations = _nDirectEvaluations.load(std::memory_order_relaxed);
+    s.fits = _nFits.load(std::memory_order_relaxed);
+    return s;
+}
+
+EphemerisCache::Slot& EphemerisCache::slot(int level, int64_t index) const {
+    const uint64_t hash = (static_cast<uint64_t>(index) * 31 + level) *
+                          0x9E3779B97F4A7C15ULL;
+    return _slots[(hash >> 32) % NumberSlots];
+}
+
+bool EphemerisCache::lookup(double time, uint64_t generation, double* result) {
+    const int hint = _levelHint.load(std::memory_order_relaxed);
+
+    int level = hint;
+    bool isDirect = false;
+    bool found = evaluateStored(hint, time, generation, result, isDirect);
+    for (int l = 0; !found && l <= MaxLevel; ++l) {
+        if (l != hint) {
+            found = evaluateStored(l, time, generation, result, isDirect);
+            level = l;
+        }
+    }
+    if (!found) {
+        return false;
+    }
+
+    if (level != hint) {
+        _levelHint.store(level, std::memory_order_relaxed);
+    }
+    if (isDirect) {
+        ++_nDirectEvaluations;
+        _function(time, result);
+    }
+    else {
+        ++_nHits;
+    }
+    return true;
+}
+
+bool EphemerisCache::evaluateStored(int level, double time, uint64_t generation,
+                                    double* result, bool& isDirect) const
+{
+    const int64_t index = pieceIndex(time, level);
+    const Slot& s = slot(level, index);
+
+    const uint32_t sequence = s.sequence.load(std::memory_order_acquire);
+    if ((sequence & 1) != 0) {
+        return false;
+    }
+    if (s.level.load(std::memory_order_relaxed) != level ||
+        s.index.load(std::memory_order_relaxed) != index ||
+        s.generation.load(std::memory_order_relaxed) != generation)
+    {
+        return false;
+    }
+
+    isDirect = s.isDirect.load(std::memory_order_relaxed);
+    if (!isDirect) {
+        const double length = pieceLength(level);
+        const double x = 2.0 * (time - index * length) / length - 1.0;
+        for (int c = 0; c < _nComponents; ++c) {
+            double coefficients[NumberNodes];
+            for (int k = 0; k < NumberNodes; ++k) {
+                coefficients[k] = s.coefficients[c * NumberNodes + k].load(
+                    std::memory_order_relaxed
+                );
+            }
+            result[c] = evaluateSeries(coefficients, x);
+        }
+    }
+
+    // If the slot was overwritten while it was read, the result might be torn
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return s.sequence.load(std::memory_order_relaxed) == sequence;
+}
+
+void EphemerisCache::fit(double time, uint64_t generation) {
+    const ChebyshevTables& t = tables();
+
+    std::vector<double> values(NumberNodes * _nComponents);
+    std::vector<double> coefficients(NumberNodes * _nComponents);
+    std::vector<double> exact(_nComponents);
+
+    ++_nFits;
+    const int startLevel = _fitLevel;
+    for (int level = startLevel; level <= MaxLevel; ++level) {
+        const double length = pieceLength(level);
+        const int64_t index = pieceIndex(time, level);
+        const double start = index * length;
+
+        bool isValid = true;
+        try {
+            for (int j = 0; j < NumberNodes; ++j) {
+                const double tj = start + (t.nodes[j] + 1.0) * 0.5 * length;
+                _function(tj, &values[j * _nComponents]);
+            }
+
+            for (int c = 0; c < _nComponents; ++c) {
+                for (int k = 0; k < NumberNodes; ++k) {
+                    double sum = 0.0;
+                    for (int j = 0; j < NumberNodes; ++j) {
+                        sum += values[j * _nComponents + c] * t.basis[k][j];
+                    }
+                    coefficients[c * NumberNodes + k] = 2.0 * sum / NumberNodes;
+                }
+                coefficients[c * NumberNodes] *= 0.5;
+            }
+
+            for (double x : t.checkPoints) {
+                _function(start + (x + 1.0) * 0.5 * length, exact.data());
+                for (int c = 0; c < _nComponents; ++c) {
+                    const double a = evaluateSeries(&coefficients[c * NumberNodes], x);
+                    const double tolerance = _absoluteTolerance +
+                                             _relativeTolerance * std::abs(exact[c]);
+                    if (!(std::abs(a - exact[c]) <= tolerance)) {
+                        isValid = false;
+                        break;
+                    }
+                }
+                if (!isValid) {
+                    break;
+                }
+            }
+        }
+        catch (const ghoul::RuntimeError&) {
+            // The function cannot be evaluated everywhere in this piece, so all
+            // requests in it are passed on to the function, which reports the error
+            store(level, index, generation, true, nullptr);
+            return;
+        }
+
+        if (isValid) {
+            store(level, index, generation, false, coefficients.data());
+            // If the first attempt succeeded, a longer piece might be sufficient for
+            // the next one
+            _fitLevel = (level == startLevel) ? std::max(level - 1, 0) : level;
+            return;
+        }
+        else if (level == MaxLevel) {
+            store(level, index, generation, true, nullptr);
+            return;
+        }
+    }
+}
+
+void EphemerisCache::store(int level, int64_t index, uint64_t generation,
+                           bool isDirect, const double* coefficients)
+{
+    Slot& s = slot(level, index);
+
+    const uint32_t sequence = s.sequence.load(std::memory_order_relaxed);
+    s.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    s.level.store(level, std::memory_order_relaxed);
+    s.index.store(index, std::memory_order_relaxed);
+    s.generation.store(generation, std::memory_order_relaxed);
+    s.isDirect.store(isDirect, std::memory_order_relaxed);
+    if (!isDirect) {
+        for (int i = 0; i < _nComponents * NumberNodes; ++i) {
+            s.coefficients[i].store(coefficients[i], std::memory_order_relaxed);
+        }
+    }
+
+    s.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+} // namespace openspace
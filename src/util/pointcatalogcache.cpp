@@ -0,0 +1,368 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <openspace/util/pointcatalogcache.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/misc/assert.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+
+namespace {
+    constexpr const char* _loggerCat = "PointCatalogCache";
+
+    constexpr const std::array<char, 8> Magic = {
+        'O', 'S', 'P', 'C', 'A', 'T', '\0', '\0'
+    };
+
+    // Version of the container format itself; the version of the content is provided
+    // by the users of the cache
+    constexpr const uint32_t FormatVersion = 1;
+
+    // Column data is aligned to the size of a cache line, which is also sufficient for
+    // all vector instruction sets
+    constexpr const size_t ColumnAlignment = 64;
+
+    size_t aligned(size_t offset, size_t alignment) {
+        return (offset + alignment - 1) / alignment * alignment;
+    }
+} // namespace
+
+namespace openspace {
+
+struct PointCatalogCache::Header {
+    std::array<char, 8> magic;
+    uint32_t formatVersion;
+    uint32_t contentVersion;
+    uint64_t nRows;
+    uint32_t nColumns;
+    uint32_t nLabels;
+    uint64_t labelTableOffset;
+    uint64_t stringTableOffset;
+    uint64_t stringTableSize;
+};
+
+struct PointCatalogCache::ColumnDescriptor {
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    ColumnType type;
+    float minimum;
+    float maximum;
+    uint32_t padding;
+    uint64_t dataOffset;
+};
+
+struct PointCatalogCache::LabelDescriptor {
+    float position[3];
+    uint32_t textOffset;
+    uint32_t textLength;
+    uint32_t padding;
+};
+
+PointCatalogCache::PointCatalogCache(const std::vector<float>& rows,
+                                     const std::vector<std::string>& columnNames,
+                                     uint32_t contentVersion,
+                             const std::vector<std::pair<glm::vec3, std::string>>& labels)
+{
+    // The layout of the file is the memory layout of these structs, so they must not
+    // change without increasing the FormatVersion
+    static_assert(sizeof(Header) == 56, "Header layout changed");
+    static_assert(sizeof(ColumnDescriptor) == 32, "ColumnDescriptor layout changed");
+    static_assert(sizeof(LabelDescriptor) == 24, "LabelDescriptor layout changed");
+
+    const size_t nColumns = columnNames.size();
+    ghoul_assert(
+        nColumns > 0 || rows.empty(),
+        "Rows can only be stored if there is at least one column"
+    );
+    const size_t nRows = nColumns > 0 ? rows.size() / nColumns : 0;
+    ghoul_assert(nRows * nColumns == rows.size(), "Incomplete row");
+
+    // Compute the layout of the file; the string table contains the column names
+    // followed by the label texts
+    std::string strings;
+    for (const std::string& name : columnNames) {
+        strings += name;
+    }
+    for (const std::pair<glm::vec3, std::string>& label : labels) {
+        strings += label.second;
+    }
+
+    const size_t columnTableOffset = sizeof(Header);
+    size_t offset = aligned(
+        columnTableOffset + nColumns * sizeof(ColumnDescriptor),
+        ColumnAlignment
+    );
+    std::vector<size_t> columnOffsets(nColumns);
+    for (size_t i = 0; i < nColumns; ++i) {
+        columnOffsets[i] = offset;
+        offset = aligned(offset + nRows * sizeof(float), ColumnAlignment);
+    }
+    const size_t labelTableOffset = offset;
+    const size_t stringTableOffset = labelTableOffset +
+                                     labels.size() * sizeof(LabelDescriptor);
+    _buffer.resize(stringTableOffset + strings.size());
+
+    Header header = {};
+    header.magic = Magic;
+    header.formatVersion = FormatVersion;
+    header.contentVersion = contentVersion;
+    header.nRows = nRows;
+    header.nColumns = static_cast<uint32_t>(nColumns);
+    header.nLabels = static_cast<uint32_t>(labels.size());
+    header.labelTableOffset = labelTableOffset;
+    header.stringTableOffset = stringTableOffset;
+    header.stringTableSize = strings.size();
+    std::memcpy(_buffer.data(), &header, sizeof(Header));
+
+    // Transpose the rows into the columns and compute the statistics on the way
+    uint32_t stringOffset = 0;
+    for (size_t i = 0; i < nColumns; ++i) {
+        float* data = reinterpret_cast<float*>(_buffer.data() + columnOffsets[i]);
+        float minimum = std::numeric_limits<float>::max();
+        float maximum = -std::numeric_limits<float>::max();
+        for (size_t row = 0; row < nRows; ++row) {
+            const float v = rows[row * nColumns + i];
+            data[row] = v;
+            if (!std::isnan(v)) {
+                minimum = std::min(minimum, v);
+                maximum = std::max(maximum, v);
+            }
+        }
+
+        ColumnDescriptor column = {};
+        column.nameOffset = stringOffset;
+        column.nameLength = static_cast<uint32_t>(columnNames[i].size());
+        column.type = ColumnType::Float32;
+        column.minimum = minimum;
+        column.maximum = maximum;
+        column.dataOffset = columnOffsets[i];
+        std::memcpy(
+            _buffer.data() + columnTableOffset + i * sizeof(ColumnDescriptor),
+            &column,
+            sizeof(ColumnDescriptor)
+        );
+        stringOffset += column.nameLength;
+    }
+
+    for (size_t i = 0; i < labels.size(); ++i) {
+        LabelDescriptor label = {};
+        label.position[0] = labels[i].first.x;
+        label.position[1] = labels[i].first.y;
+        label.position[2] = labels[i].first.z;
+        label.textOffset = stringOffset;
+        label.textLength = static_cast<uint32_t>(labels[i].second.size());
+        std::memcpy(
+            _buffer.data() + labelTableOffset + i * sizeof(LabelDescriptor),
+            &label,
+            sizeof(LabelDescriptor)
+        );
+        stringOffset += label.textLength;
+    }
+
+    std::memcpy(_buffer.data() + stringTableOffset, strings.data(), strings.size());
+
+    _data = _buffer.data();
+    _size = _buffer.size();
+    setPointers();
+}
+
+PointCatalogCache PointCatalogCache::load(std::string path, uint32_t contentVersion) {
+    PointCatalogCache cache;
+    cache._file = std::make_unique<MemoryMappedFile>(std::move(path));
+    cache._data = cache._file->data();
+    cache._size = cache._file->size();
+    cache.validate(contentVersion);
+    cache.setPointers();
+    return cache;
+}
+
+void PointCatalogCache::save(const std::string& path) const {
+    std::ofstream file(path, std::ofstream::binary);
+    if (!file.good()) {
+        throw ghoul::RuntimeError(
+            fmt::format("Error opening file '{}' for saving cache", path),
+            _loggerCat
+        );
+    }
+    file.write(reinterpret_cast<const char*>(_data), _size);
+    if (!file.good()) {
+        throw ghoul::RuntimeError(
+            fmt::format("Error writing cache file '{}'", path),
+            _loggerCat
+        );
+    }
+}
+
+void PointCatalogCache::validate(uint32_t contentVersion) const {
+    auto fail = [this](const std::string& reason) {
+        throw ghoul::RuntimeError(
+            fmt::format("Invalid cache file '{}': {}", _file->path(), reason),
+            _loggerCat
+        );
+    };
+
+    if (_size < sizeof(Header)) {
+        fail("File is too small");
+    }
+    const Header& header = *reinterpret_cast<const Header*>(_data);
+    if (header.magic != Magic) {
+        fail("File is not a point catalog cache");
+    }
+    if (header.formatVersion != FormatVersion) {
+        fail(fmt::format(
+            "Format version {} does not match {}",
+            header.formatVersion, FormatVersion
+        ));
+    }
+    if (header.contentVersion != contentVersion) {
+        fail(fmt::format(
+            "Content version {} does not match {}",
+            header.contentVersion, contentVersion
+        ));
+    }
+
+    // Use the division to check the table sizes as the products might overflow
+    const size_t columnTableEnd = sizeof(Header) +
+                                  header.nColumns * sizeof(ColumnDescriptor);
+    if (columnTableEnd > _size ||
+        header.stringTableOffset > _size ||
+        header.stringTableSize > _size - header.stringTableOffset ||
+        header.labelTableOffset > header.stringTableOffset ||
+        header.nLabels > (header.stringTableOffset - header.labelTableOffset) /
+                         sizeof(LabelDescriptor))
+    {
+        fail("File is truncated");
+    }
+
+    const ColumnDescriptor* columns = reinterpret_cast<const ColumnDescriptor*>(
+        _data + sizeof(Header)
+    );
+    for (uint32_t i = 0; i < header.nColumns; ++i) {
+        const ColumnDescriptor& c = columns[i];
+        if (c.type != ColumnType::Float32) {
+            fail(fmt::format("Column {} has unknown type", i));
+        }
+        if (c.dataOffset % alignof(float) != 0 || c.dataOffset > _size ||
+            header.nRows > (_size - c.dataOffset) / sizeof(float))
+        {
+            fail(fmt::format("Data of column {} is truncated", i));
+        }
+        if (uint64_t(c.nameOffset) + c.nameLength > header.stringTableSize) {
+            fail(fmt::format("Name of column {} is truncated", i));
+        }
+    }
+
+    const LabelDescriptor* labels = reinterpret_cast<const LabelDescriptor*>(
+        _data + header.labelTableOffset
+    );
+    for (uint32_t i = 0; i < header.nLabels; ++i) {
+        if (uint64_t(labels[i].textOffset) + labels[i].textLength >
+            header.stringTableSize)
+        {
+            fail(fmt::format("Text of label {} is truncated", i));
+        }
+    }
+}
+
+void PointCatalogCache::setPointers() {
+    _header = reinterpret_cast<const Header*>(_data);
+    _columns = reinterpret_cast<const ColumnDescriptor*>(_data + sizeof(Header));
+    _labels = reinterpret_cast<const LabelDescriptor*>(
+        _data + _header->labelTableOffset
+    );
+    _strings = reinterpret_cast<const char*>(_data + _header->stringTableOffset);
+
+    _columnData.resize(_header->nColumns);
+    for (uint32_t i = 0; i < _header->nColumns; ++i) {
+        _columnData[i] = reinterpret_cast<const float*>(_data + _columns[i].dataOffset);
+    }
+}
+
+bool PointCatalogCache::isMapped() const {
+    return _file != nullptr;
+}
+
+size_t PointCatalogCache::nRows() const {
+    return _header ? static_cast<size_t>(_header->nRows) : 0;
+}
+
+int PointCatalogCache::nColumns() const {
+    return static_cast<int>(_columnData.size());
+}
+
+PointCatalogCache::Column PointCatalogCache::column(int index) const {
+    ghoul_assert(index >= 0 && index < nColumns(), "Column index out of range");
+    const ColumnDescriptor& c = _columns[index];
+    return {
+        std::string_view(_strings + c.nameOffset, c.nameLength),
+        c.type,
+        c.minimum,
+        c.maximum
+    };
+}
+
+int PointCatalogCache::columnIndex(std::string_view name) const {
+    for (int i = 0; i < nColumns(); ++i) {
+        if (column(i).name == name) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+const float* PointCatalogCache::columnData(int index) const {
+    ghoul_assert(index >= 0 && index < nColumns(), "Column index out of range");
+    return _columnData[index];
+}
+
+float PointCatalogCache::value(size_t row, int column) const {
+    ghoul_assert(column >= 0 && column < nColumns(), "Column index out of range");
+    ghoul_assert(row < nRows(), "Row index out of range");
+    return _columnData[column][row];
+}
+
+size_t PointCatalogCache::nLabels() const {
+    return _header ? static_cast<size_t>(_header->nLabels) : 0;
+}
+
+glm::vec3 PointCatalogCache::labelPosition(size_t index) const {
+    ghoul_assert(index < nLabels(), "Label index out of range");
+    const LabelDescriptor& l = _labels[index];
+    return glm::vec3(l.position[0], l.position[1], l.position[2]);
+}
+
+std::string_view PointCatalogCache::labelText(size_t index) const {
+    ghoul_assert(index < nLabels(), "Label index out of range");
+    const LabelDescriptor& l = _labels[index];
+    return std::string_view(_strings + l.textOffset, l.textLength);
+}
+
+} // namespace openspace
@@ -55,4 +55,10 @@ void ProgressBar::print(int current) {
     _previous = iprogress;
 }
 
+void ProgressBar::advance(int n) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _current += n;
+    print(_current);
+}
+
 } // namespace openspace
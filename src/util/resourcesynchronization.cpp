@@ -25,7 +25,9 @@
 #include <openspace/util/resourcesynchronization.h>
 
 #include <openspace/documentation/verifier.h>
+#include <openspace/engine/globals.h>
 #include <openspace/util/factorymanager.h>
+#include <openspace/util/startuptrace.h>
 #include <ghoul/misc/dictionary.h>
 #include <ghoul/misc/templatefactory.h>
 
@@ -138,6 +140,19 @@ void ResourceSynchronization::begin() {
 }
 
 void ResourceSynchronization::setState(State state) {
+    if (state == State::Syncing) {
+        _syncBeginTime = std::chrono::steady_clock::now();
+    }
+    else if (_state == State::Syncing &&
+             (state == State::Resolved || state == State::Rejected))
+    {
+        global::startupTrace.addAsyncEvent(
+            "Synchronization",
+            state == State::Resolved ? _name : _name + " (rejected)",
+            _syncBeginTime,
+            std::chrono::steady_clock::now()
+        );
+    }
     _state = state;
 
     _callbackMutex.lock();
@@ -0,0 +1,425 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/speckfile.h>
+
+#include <openspace/engine/globals.h>
+#include <openspace/util/workstealingthreadpool.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+
+namespace {
+    // Bodies smaller than this are parsed on the calling thread only, as distributing
+    // the work across the thread pool would take longer than parsing the data
+    constexpr const size_t MinimumChunkSize = 1024 * 1024;
+
+    // The keyword "texture" also matches "texturevar"
+    constexpr const std::array<std::string_view, 5> HeaderKeywords = {
+        "datavar", "texture", "polyorivar", "maxcomment", "textcolor"
+    };
+
+    // Powers of ten that are exactly representable as doubles
+    constexpr const std::array<double, 23> PowersOfTen = {
+        1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14,
+        1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+
+    bool isSpace(char c) {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\v' || c == '\f';
+    }
+
+    bool isDigit(char c) {
+        return c >= '0' && c <= '9';
+    }
+
+    bool startsWith(std::string_view line, std::string_view prefix) {
+        return line.substr(0, prefix.size()) == prefix;
+    }
+
+    std::string_view trimmedLeft(std::string_view line) {
+        size_t first = 0;
+        while (first < line.size() && isSpace(line[first])) {
+            ++first;
+        }
+        return line.substr(first);
+    }
+
+    // Returns the line starting at it without its line ending and advances it to the
+    // beginning of the next line
+    std::string_view nextLine(const char*& it, const char* end) {
+        const char* lineEnd = static_cast<const char*>(
+            std::memchr(it, '\n', static_cast<size_t>(end - it))
+        );
+        if (!lineEnd) {
+            lineEnd = end;
+        }
+        std::string_view line(it, static_cast<size_t>(lineEnd - it));
+        it = (lineEnd == end) ? end : lineEnd + 1;
+
+        // Guard against wrong line endings (copying files from Windows to Mac) causes
+        // lines to have a final \r
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        return line;
+    }
+
+    bool isContentLine(std::string_view line) {
+        line = trimmedLeft(line);
+        return !line.empty() && line[0] != '#';
+    }
+
+    // Parses the floating point number at it, without the overhead of locales and
+    // streams. The significant digits are accumulated in an integer and scaled once,
+    // which is exact for the up to 9 significant digits that are stored in a float
+    bool parseFloat(const char*& it, const char* end, float& result) {
+        const char* p = it;
+        bool isNegative = false;
+        if (p != end && (*p == '-' || *p == '+')) {
+            isNegative = (*p == '-');
+            ++p;
+        }
+
+        uint64_t mantissa = 0;
+        int nSignificantDigits = 0;
+        int exponent = 0;
+        bool hasDigits = false;
+        while (p != end && isDigit(*p)) {
+            if (nSignificantDigits < 19) {
+                mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+                nSignificantDigits += (mantissa != 0) ? 1 : 0;
+            }
+            else {
+                ++exponent;
+            }
+            hasDigits = true;
+            ++p;
+        }
+        if (p != end && *p == '.') {
+            ++p;
+            while (p != end && isDigit(*p)) {
+                if (nSignificantDigits < 19) {
+                    mantissa = mantissa * 10 + static_cast<uint64_t>(*p - '0');
+                    nSignificantDigits += (mantissa != 0) ? 1 : 0;
+                    --exponent;
+                }
+                hasDigits = true;
+                ++p;
+            }
+        }
+        if (!hasDigits) {
+            return false;
+        }
+
+        if (p != end && (*p == 'e' || *p == 'E')) {
+            const char* e = p + 1;
+            bool isExponentNegative = false;
+            if (e != end && (*e == '-' || *e == '+')) {
+                isExponentNegative = (*e == '-');
+                ++e;
+            }
+            int exponentValue = 0;
+            bool hasExponentDigits = false;
+            while (e != end && isDigit(*e)) {
+                if (exponentValue < 10000) {
+                    exponentValue = exponentValue * 10 + (*e - '0');
+                }
+                hasExponentDigits = true;
+                ++e;
+            }
+            if (hasExponentDigits) {
+                exponent += isExponentNegative ? -exponentValue : exponentValue;
+                p = e;
+            }
+        }
+
+        double value = static_cast<double>(mantissa);
+        if (exponent < 0) {
+            value = (exponent >= -22) ?
+                value / PowersOfTen[-exponent] :
+                value * std::pow(10.0, exponent);
+        }
+        else if (exponent > 0) {
+            value = (exponent <= 22) ?
+                value * PowersOfTen[exponent] :
+                value * std::pow(10.0, exponent);
+        }
+        result = static_cast<float>(isNegative ? -value : value);
+        it = p;
+        return true;
+    }
+
+    const char* parseValuesAt(const char* it, const char* end, float* values,
+                              int nValues, int& nParsedValues)
+    {
+        nParsedValues = 0;
+        while (nParsedValues < nValues) {
+            while (it != end && isSpace(*it)) {
+                ++it;
+            }
+            if (it == end || !parseFloat(it, end, values[nParsedValues])) {
+                break;
+            }
+            ++nParsedValues;
+        }
+        return it;
+    }
+
+    // Calls func(i) for all i in [0, nTasks) on the threads of the shared pool
+    template <typename Func>
+    void runInParallel(size_t nTasks, Func func) {
+        if (nTasks == 1) {
+            func(size_t(0));
+            return;
+        }
+        openspace::global::threadPool.parallelFor(
+            nTasks,
+            nTasks,
+            [&func](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i) {
+                    func(i);
+                }
+            }
+        );
+    }
+} // namespace
+
+namespace openspace {
+
+SpeckFile::SpeckFile(std::string path)
+    : _file(std::move(path))
+{
+    const char* begin = reinterpret_cast<const char*>(_file.data());
+    const char* end = begin + _file.size();
+    _bodyOffset = _file.size();
+
+    int lastIndex = -1;
+    const char* it = begin;
+    while (it != end) {
+        const char* lineBegin = it;
+        std::string_view line = trimmedLeft(nextLine(it, end));
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+
+        const bool isHeaderLine = std::any_of(
+            HeaderKeywords.begin(),
+            HeaderKeywords.end(),
+            [line](std::string_view keyword) { return startsWith(line, keyword); }
+        );
+        if (!isHeaderLine) {
+            _bodyOffset = static_cast<size_t>(lineBegin - begin);
+            break;
+        }
+
+        _headerLines.emplace_back(line);
+        if (startsWith(line, "datavar")) {
+            // datavar lines are structured as follows:
+            // datavar # description
+            // where # is the index of the data variable
+            std::istringstream str(_headerLines.back());
+            std::string dummy;
+            DataVariable variable = { 0, "" };
+            str >> dummy >> variable.index >> variable.name;
+            lastIndex = variable.index;
+            _dataVariables.push_back(std::move(variable));
+        }
+    }
+
+    // The index is 0 based and X Y Z are not counted in the Speck file indices
+    _nValuesPerRow = lastIndex + 1 + 3;
+}
+
+const std::string& SpeckFile::path() const {
+    return _file.path();
+}
+
+const std::vector<std::string>& SpeckFile::headerLines() const {
+    return _headerLines;
+}
+
+const std::vector<SpeckFile::DataVariable>& SpeckFile::dataVariables() const {
+    return _dataVariables;
+}
+
+int SpeckFile::nValuesPerRow() const {
+    return _nValuesPerRow;
+}
+
+std::vector<std::string> SpeckFile::columnNames() const {
+    std::vector<std::string> names = { "x", "y", "z" };
+    names.resize(_nValuesPerRow);
+    for (const DataVariable& variable : _dataVariables) {
+        if (variable.index >= 0 && variable.index + 3 < _nValuesPerRow) {
+            names[variable.index + 3] = variable.name;
+        }
+    }
+    return names;
+}
+
+std::vector<std::string_view> SpeckFile::bodyLines() const {
+    const char* it = reinterpret_cast<const char*>(_file.data()) + _bodyOffset;
+    const char* end = reinterpret_cast<const char*>(_file.data()) + _file.size();
+
+    std::vector<std::string_view> lines;
+    while (it != end) {
+        std::string_view line = nextLine(it, end);
+        if (isContentLine(line)) {
+            lines.push_back(line);
+        }
+    }
+    return lines;
+}
+
+size_t SpeckFile::readRows(std::vector<float>& result, int nValuesPerRow,
+                           bool skipNullRows) const
+{
+    const char* begin = reinterpret_cast<const char*>(_file.data()) + _bodyOffset;
+    const char* end = reinterpret_cast<const char*>(_file.data()) + _file.size();
+    const size_t bodySize = static_cast<size_t>(end - begin);
+    const size_t n = static_cast<size_t>(nValuesPerRow);
+
+    // Split the body into chunks that start at the beginning of a line
+    const size_t nThreads = global::threadPool.numThreads() + 1;
+    const size_t nChunks = std::clamp(bodySize / MinimumChunkSize, size_t(1), nThreads);
+    std::vector<const char*> chunkBounds(nChunks + 1);
+    chunkBounds.front() = begin;
+    chunkBounds.back() = end;
+    for (size_t i = 1; i < nChunks; ++i) {
+        const char* p = std::max(begin + i * bodySize / nChunks, chunkBounds[i - 1]);
+        const char* lineEnd = static_cast<const char*>(
+            std::memchr(p, '\n', static_cast<size_t>(end - p))
+        );
+        chunkBounds[i] = lineEnd ? lineEnd + 1 : end;
+    }
+
+    // The first pass counts the rows in each chunk to find where in the result buffer
+    // the chunk starts
+    std::vector<size_t> chunkRowOffsets(nChunks + 1, 0);
+    runInParallel(nChunks, [&](size_t chunk) {
+        const char* it = chunkBounds[chunk];
+        size_t nRows = 0;
+        while (it < chunkBounds[chunk + 1]) {
+            nRows += isContentLine(nextLine(it, chunkBounds[chunk + 1])) ? 1 : 0;
+        }
+        chunkRowOffsets[chunk + 1] = nRows;
+    });
+    for (size_t i = 1; i <= nChunks; ++i) {
+        chunkRowOffsets[i] += chunkRowOffsets[i - 1];
+    }
+
+    // The second pass parses the rows straight into their final location
+    result.assign(chunkRowOffsets.back() * n, 0.f);
+    std::vector<size_t> chunkRowsWritten(nChunks, 0);
+    runInParallel(nChunks, [&](size_t chunk) {
+        float* out = result.data() + chunkRowOffsets[chunk] * n;
+        const char* it = chunkBounds[chunk];
+        size_t nRows = 0;
+        while (it < chunkBounds[chunk + 1]) {
+            std::string_view line = nextLine(it, chunkBounds[chunk + 1]);
+            if (!isContentLine(line)) {
+                continue;
+            }
+
+            float* row = out + nRows * n;
+            int nParsed = 0;
+            parseValuesAt(
+                line.data(),
+                line.data() + line.size(),
+                row,
+                nValuesPerRow,
+                nParsed
+            );
+            const bool isNullRow = std::all_of(row, row + n, [](float v) {
+                return v == 0.f;
+            });
+            // A skipped row only contains zeros, so its slot can be reused directly
+            if (!(skipNullRows && isNullRow)) {
+                ++nRows;
+            }
+        }
+        chunkRowsWritten[chunk] = nRows;
+    });
+
+    // Close the gaps that skipped rows have left at the end of each chunk
+    size_t nRows = chunkRowsWritten[0];
+    for (size_t i = 1; i < nChunks; ++i) {
+        if (chunkRowOffsets[i] != nRows) {
+            std::copy(
+                result.begin() + chunkRowOffsets[i] * n,
+                result.begin() + (chunkRowOffsets[i] + chunkRowsWritten[i]) * n,
+                result.begin() + nRows * n
+            );
+        }
+        nRows += chunkRowsWritten[i];
+    }
+    result.resize(nRows * n);
+    return nRows;
+}
+
+std::vector<std::pair<glm::vec3, std::string>> SpeckFile::readLabels() const {
+    std::vector<std::pair<glm::vec3, std::string>> labels;
+    for (std::string_view line : bodyLines()) {
+        glm::vec3 position = glm::vec3(0.f);
+        int nParsed = 0;
+        const char* it = parseValuesAt(
+            line.data(),
+            line.data() + line.size(),
+            &position[0],
+            3,
+            nParsed
+        );
+
+        // The position is followed by the 'text' keyword and the label, which might be
+        // followed by a comment
+        std::istringstream str(std::string(it, line.data() + line.size()));
+        std::string dummy;
+        str >> dummy; // text keyword
+
+        std::string label;
+        str >> label;
+        dummy.clear();
+        while (str >> dummy) {
+            if (dummy == "#") {
+                break;
+            }
+            label += " " + dummy;
+            dummy.clear();
+        }
+        labels.emplace_back(position, std::move(label));
+    }
+    return labels;
+}
+
+int SpeckFile::parseValues(std::string_view line, float* values, int nValues) {
+    int nParsed = 0;
+    parseValuesAt(line.data(), line.data() + line.size(), values, nValues, nParsed);
+    return nParsed;
+}
+
+} // namespace openspace
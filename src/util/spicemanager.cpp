@@ -42,6 +42,11 @@ namespace {
     // as the maximum message length
     constexpr const unsigned SpiceErrorBufferSize = 1841;
 
+    // The accuracy of the ephemeris caches; the positions are measured in km
+    constexpr const double PositionCacheAbsoluteTolerance = 1e-6;
+    constexpr const double PositionCacheRelativeTolerance = 1e-12;
+    constexpr const double RotationCacheTolerance = 1e-10;
+
     // This method checks if one of the previous SPICE methods has failed. If it has, an
     // exception with the SPICE error message is thrown
     // If an error occurred, true is returned, otherwise, false
@@ -220,6 +225,8 @@ SpiceManager::KernelHandle SpiceManager::loadKernel(std::string filePath) {
         )
     );
 
+    std::lock_guard<std::recursive_mutex> lock(_spiceMutex);
+
     std::string path = absPath(std::move(filePath));
     const auto it = std::find_if(
         _loadedKernels.begin(),
@@ -266,6 +273,7 @@ SpiceManager::KernelHandle SpiceManager::loadKernel(std::string filePath) {
     KernelHandle kernelId = ++_lastAssignedKernel;
     ghoul_assert(kernelId != 0, fmt::format("Kernel Handle wrapped around to 0"));
     _loadedKernels.push_back({std::move(path), kernelId, 1});
+    invalidateEphemerisCaches();
     return kernelId;
 }
 
@@ -273,6 +281,8 @@ void SpiceManager::unloadKernel(KernelHandle kernelId) {
     ghoul_assert(kernelId <= _lastAssignedKernel, "Invalid unassigned kernel");
     ghoul_assert(kernelId != KernelHandle(0), "Invalid zero handle");
 
+    std::lock_guard<std::recursive_mutex> lock(_spiceMutex);
+
     const auto it = std::find_if(
         _loadedKernels.begin(),
         _loadedKernels.end(),
@@ -286,6 +296,7 @@ void SpiceManager::unloadKernel(KernelHandle kernelId) {
             LINFO(fmt::format("Unloading SPICE kernel '{}'", it->path));
             unload_c(it->path.c_str());
             _loadedKernels.erase(it);
+            invalidateEphemerisCaches();
         }
         // Otherwise, we hold on to it, but reduce the reference counter by 1
         else {
@@ -298,6 +309,8 @@ void SpiceManager::unloadKernel(KernelHandle kernelId) {
 void SpiceManager::unloadKernel(std::string filePath) {
     ghoul_assert(!filePath.empty(), "Empty filename");
 
+    std::lock_guard<std::recursive_mutex> lock(_spiceMutex);
+
     std::string path = absPath(std::move(filePath));
 
     const auto it = std::find_if(
@@ -322,6 +335,7 @@ void SpiceManager::unloadKernel(std::string filePath) {
             LINFO(fmt::format("Unloading SPICE kernel '{}'", path));
             unload_c(path.c_str());
             _loadedKernels.erase(it);
+            invalidateEphemerisCaches();
         }
         else {
             // Otherwise, we hold on to it, but reduce the reference counter by 1
@@ -334,6 +348,8 @@ void SpiceManager::unloadKernel(std::string filePath) {
 bool SpiceManager::hasSpkCoverage(const std::string& target, double et) const {
     ghoul_assert(!target.empty(), "Empty target");
 
+    std::lock_guard<std::recursive_mutex> lock(_spiceMutex);
+
     const int id = naifId(target);
     const auto it = _spkIntervals.find(id);
     if (it != _spkIntervals.end()) {
@@ -350,6 +366,8 @@ bool SpiceManager::hasSpkCoverage(const std::string& target, double et) const {
 bool SpiceManager::hasCkCoverage(const std::string& frame, double et) const {
     ghoul_assert(!frame.empty(), "Empty target");
 
+    std::lock_guard<std::recursive_mutex> lock(_spiceMutex);
+
     const int id = frameId(frame);
     const auto it = _ckIntervals.find(id);
     if (it != _ckIntervals.end()) {
@@ -364,6 +382,7 @@ bool SpiceManager::hasCkCoverage(const std::string& frame, double et) const {
 }
 
 bool SpiceManager::hasValue(int naifId, const std::string& item) const {
+    std::lock_guard<std::recursive_mutex> lock(_spiceMutex);
     return bodfnd_c(naifId, item.c_str());
 }
 
@@ -378,6 +397,8 @@ bool SpiceManager::hasValue(const std::string& body, const std::string& item) co
 int SpiceManager::naifId(const std::string& body) const {
     ghoul_assert(!body.empty(), "Empty body");
 
+    std::lock_guard<std::recursive_mutex> lock(_spiceMutex);
+
     SpiceBoolean success;
     SpiceInt id;
     bods2c_c(body.c_str(), &id, &success);
@@ -390,6 +411,8 @@ int SpiceManager::naifId(const std::string& body) const {
 bool SpiceManager::hasNaifId(const std::string& body) const {
     ghoul_assert(!body.empty(), "Empty body");
 
+    std::lock_guard<std::recursive_mutex> lock(_spiceMutex);
+
     SpiceBoolean success;
     SpiceInt id;
     bods2c_c(body.c_str(), &id, &success);
@@ -400,6 +423,8 @@ bool SpiceManager::hasNaifId(const std::string& body) const {
 int SpiceManager::frameId(const std::string& frame) const {
     ghoul_assert(!frame.empty(), "Empty frame");
 
+    std::lock_guard<std::recursive_mutex> lock(_spiceMutex);
+
     SpiceInt id;
     namfrm_c(frame.c_str(), &id);
     if (id == 0 && _useExceptions) {
@@ -411,6 +436,8 @@ int SpiceManager::frameId(const std::string& frame) const {
 bool SpiceManager::hasFrameId(const std::string& frame) const {
     ghoul_assert(!frame.empty(), "Empty frame");
 
+    std::lock_guard<std::recursive_mutex> lock(_spiceMutex);
+
     SpiceInt id;
     namfrm_c(frame.c_str(), &id);
     return id != 0;
@@ -432,24 +459,28 @@ void getValueInternal(const std::string& body, const std::string& value, int siz
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             double& v) const
 {
+    std::lock_guard<std::recursive_mutex> lock(_spiceMutex);
     getValueInternal(body, value, 1, &v);
 }
 
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             glm::dvec2& v) const
 {
+    std::lock_guard<std::recursive_mutex> lock(_spiceMutex);
     getValueInternal(body, value, 2, glm::value_ptr(v));
 }
 
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             glm::dvec3& v) const
 {
+    std::lock_guard<std::recursive_mutex> lock(_spiceMutex);
     getValueInternal(body, value, 3, glm::value_ptr(v));
 }
 
 void SpiceManager::getValue(const std::string& body, const std::string& value,
                             glm::dvec4& v) const
 {
+    std::lock_guard<std::recursive_mutex> lock(_spiceMutex);
     getValueInternal(body, value, 4, glm::value_ptr(v));
 }
 
@@ -458,12 +489,15 @@ void SpiceManager::getValue(const std::string& body, const std::string& value,
 {
     ghoul_assert(!v.empty(), "Array for values has to be preallocaed");
 
+    std::lock_guard<std::recursive_mutex> lock(_spiceMutex);
     getValueInternal(body, value, static_cast<int>(v.size()), v.data());
 }
 
 double SpiceManager::spacecraftClockToET(const std::string& craft, double craftTicks) {
     ghoul_assert(!craft.empty(), "Empty craft");
 
+    std::lock_guard<std::recursive_mutex> lock(_spiceMutex);
+
     int craftId = naifId(craft);
     double et;
     sct2e_c(craftId, craftTicks, &et);
@@ -476,6 +510,8 @@ double SpiceManager::spacecraftClockToET(const std::string& craft, double craftT
 double SpiceManager::ephemerisTimeFromDate(const std::string& timeString) const {
     ghoul_assert(!timeString.empty(), "Empty timeString");
 
+    std::lock_guard<std::recursive_mutex> lock(_spiceMutex);
+
     double et;
     str2et_c(timeString.c_str(), &et);
     throwOnSpiceError(fmt::format("Error converting date '{}'", timeString));
@@ -487,6 +523,8 @@ std::string SpiceManager::dateFromEphemerisTime(double ephemerisTime,
 {
     ghoul_assert(!formatString.empty(), "Format is empty");
 
+    std::lock_guard<std::recursive_mutex> lock(_spiceMutex);
+
     constexpr const int BufferSize = 256;
     SpiceChar buffer[BufferSize];
     timout_c(ephemerisTime, formatString.c_str(), BufferSize - 1, buffer);
@@ -509,6 +547,8 @@ glm::dvec3 SpiceManager::targetPosition(const std::string& target,
     ghoul_assert(!observer.empty(), "Observer is not empty");
     ghoul_assert(!referenceFrame.empty(), "Reference frame is not empty");
 
+    std::lock_guard<std::recursive_mutex> lock(_spiceMutex);
+
     bool targetHasCoverage = hasSpkCoverage(target, ephemerisTime);
     bool observerHasCoverage = hasSpkCoverage(observer, ephemerisTime);
     if (!targetHasCoverage && !observerHasCoverage) {
@@ -582,6 +622,45 @@ glm::dvec3 SpiceManager::targetPosition(const std::string& target,
     );
 }
 
+EphemerisCache& SpiceManager::targetPositionCache(
+                                                                const std::string& target,
+                                                              const std::string& observer,
+                                                        const std::string& referenceFrame,
+                                                AberrationCorrection aberrationCorrection)
+{
+    ghoul_assert(!target.empty(), "Target is not empty");
+    ghoul_assert(!observer.empty(), "Observer is not empty");
+    ghoul_assert(!referenceFrame.empty(), "Reference frame is not empty");
+
+    const std::string key = fmt::format(
+        "Position of '{}' relative to '{}' in '{}' ({})",
+        target, observer, referenceFrame, static_cast<const char*>(aberrationCorrection)
+    );
+
+    std::lock_guard<std::mutex> lock(_ephemerisCacheMutex);
+    std::unique_ptr<EphemerisCache>& cache = _ephemerisCaches[key];
+    if (!cache) {
+        cache = std::make_unique<EphemerisCache>(
+            3,
+            [this, target, observer, referenceFrame, aberrationCorrection](double time,
+                                                                          double* result)
+            {
+                const glm::dvec3 p = targetPosition(
+                    target,
+                    observer,
+                    referenceFrame,
+                    aberrationCorrection,
+                    time
+                );
+                std::copy_n(glm::value_ptr(p), 3, result);
+            },
+            PositionCacheAbsoluteTolerance,
+            PositionCacheRelativeTolerance
+        );
+    }
+    return *cache;
+}
+
 glm::dmat3 SpiceManager::frameTransformationMatrix(const std::string& from,
                                                    const std::string& to,
                                                    double ephemerisTime) const
@@ -589,6 +668,8 @@ glm::dmat3 SpiceManager::frameTransformationMatrix(const std::string& from,
     ghoul_assert(!from.empty(), "From must not be empty");
     ghoul_assert(!to.empty(), "To must not be empty");
 
+    std::lock_guard<std::recursive_mutex> lock(_spiceMutex);
+
     // get rotation matrix from frame A - frame B
     glm::dmat3 transform;
     pxform_c(
@@ -625,6 +706,8 @@ SpiceManager::SurfaceInterceptResult SpiceManager::surfaceIntercept(
     ghoul_assert(!referenceFrame.empty(), "Reference frame must not be empty");
     ghoul_assert(directionVector != glm::dvec3(0.0), "Direction vector must not be zero");
 
+    std::lock_guard<std::recursive_mutex> lock(_spiceMutex);
+
     const std::string ComputationMethod = "ELLIPSOID";
 
     SurfaceInterceptResult result;
@@ -668,6 +751,8 @@ bool SpiceManager::isTargetInFieldOfView(const std::string& target,
     ghoul_assert(!referenceFrame.empty(), "Reference frame must not be empty");
     ghoul_assert(!instrument.empty(), "Instrument must not be empty");
 
+    std::lock_guard<std::recursive_mutex> lock(_spiceMutex);
+
     int visible;
     fovtrg_c(instrument.c_str(),
         target.c_str(),
@@ -715,6 +800,8 @@ SpiceManager::TargetStateResult SpiceManager::targetState(const std::string& tar
     ghoul_assert(!observer.empty(), "Observer must not be empty");
     ghoul_assert(!referenceFrame.empty(), "Reference frame must not be empty");
 
+    std::lock_guard<std::recursive_mutex> lock(_spiceMutex);
+
     TargetStateResult result;
     result.lightTime = 0.0;
 
@@ -749,6 +836,8 @@ SpiceManager::TransformMatrix SpiceManager::stateTransformMatrix(
     ghoul_assert(!sourceFrame.empty(), "sourceFrame must not be empty");
     ghoul_assert(!destinationFrame.empty(), "toFrame must not be empty");
 
+    std::lock_guard<std::recursive_mutex> lock(_spiceMutex);
+
     TransformMatrix m;
     sxform_c(
         sourceFrame.c_str(),
@@ -771,6 +860,8 @@ glm::dmat3 SpiceManager::positionTransformMatrix(const std::string& sourceFrame,
     ghoul_assert(!sourceFrame.empty(), "sourceFrame must not be empty");
     ghoul_assert(!destinationFrame.empty(), "destinationFrame must not be empty");
 
+    std::lock_guard<std::recursive_mutex> lock(_spiceMutex);
+
     glm::dmat3 result;
     pxform_c(
         sourceFrame.c_str(),
@@ -801,6 +892,8 @@ glm::dmat3 SpiceManager::positionTransformMatrix(const std::string& sourceFrame,
     ghoul_assert(!sourceFrame.empty(), "sourceFrame must not be empty");
     ghoul_assert(!destinationFrame.empty(), "destinationFrame must not be empty");
 
+    std::lock_guard<std::recursive_mutex> lock(_spiceMutex);
+
     glm::dmat3 result;
 
     pxfrm2_c(
@@ -818,6 +911,60 @@ glm::dmat3 SpiceManager::positionTransformMatrix(const std::string& sourceFrame,
     return glm::transpose(result);
 }
 
+EphemerisCache& SpiceManager::positionTransformMatrixCache(
+                                                           const std::string& sourceFrame,
+                                                      const std::string& destinationFrame)
+{
+    ghoul_assert(!sourceFrame.empty(), "sourceFrame must not be empty");
+    ghoul_assert(!destinationFrame.empty(), "destinationFrame must not be empty");
+
+    const std::string key = fmt::format(
+        "Rotation from '{}' to '{}'", sourceFrame, destinationFrame
+    );
+
+    std::lock_guard<std::mutex> lock(_ephemerisCacheMutex);
+    std::unique_ptr<EphemerisCache>& cache = _ephemerisCaches[key];
+    if (!cache) {
+        cache = std::make_unique<EphemerisCache>(
+            9,
+            [this, sourceFrame, destinationFrame](double time, double* result) {
+                const glm::dmat3 m = positionTransformMatrix(
+                    sourceFrame,
+                    destinationFrame,
+                    time
+                );
+                std::copy_n(glm::value_ptr(m), 9, result);
+            },
+            RotationCacheTolerance
+        );
+    }
+    return *cache;
+}
+
+std::vector<std::pair<std::string, EphemerisCache::Statistics>>
+SpiceManager::ephemerisCacheStatistics() const
+{
+    std::lock_guard<std::mutex> lock(_ephemerisCacheMutex);
+
+    std::vector<std::pair<std::string, EphemerisCache::Statistics>> result;
+    result.reserve(_ephemerisCaches.size());
+    for (const std::pair<const std::string, std::unique_ptr<EphemerisCache>>& p :
+         _ephemerisCaches)
+    {
+        result.emplace_back(p.first, p.second->statistics());
+    }
+    return result;
+}
+
+void SpiceManager::invalidateEphemerisCaches() {
+    std::lock_guard<std::mutex> lock(_ephemerisCacheMutex);
+    for (const std::pair<const std::string, std::unique_ptr<EphemerisCache>>& p :
+         _ephemerisCaches)
+    {
+        p.second->invalidate();
+    }
+}
+
 SpiceManager::FieldOfViewResult
 SpiceManager::fieldOfView(const std::string& instrument) const
 {
@@ -826,6 +973,8 @@ SpiceManager::fieldOfView(const std::string& instrument) const
 }
 
 SpiceManager::FieldOfViewResult SpiceManager::fieldOfView(int instrument) const {
+    std::lock_guard<std::recursive_mutex> lock(_spiceMutex);
+
     constexpr int MaxBoundsSize = 64;
     constexpr int BufferSize = 128;
 
@@ -887,6 +1036,8 @@ SpiceManager::TerminatorEllipseResult SpiceManager::terminatorEllipse(
     ghoul_assert(!lightSource.empty(), "Light source must not be empty");
     ghoul_assert(numberOfTerminatorPoints >= 1, "Terminator points must be >= 1");
 
+    std::lock_guard<std::recursive_mutex> lock(_spiceMutex);
+
     TerminatorEllipseResult res;
 
     // Warning: This assumes std::vector<glm::dvec3> to have all values memory contiguous
@@ -914,6 +1065,8 @@ SpiceManager::TerminatorEllipseResult SpiceManager::terminatorEllipse(
 }
 
 bool SpiceManager::addFrame(std::string body, std::string frame) {
+    std::lock_guard<std::recursive_mutex> lock(_spiceMutex);
+
     if (body.empty() || frame.empty()) {
         return false;
     }
@@ -924,6 +1077,8 @@ bool SpiceManager::addFrame(std::string body, std::string frame) {
 }
 
 std::string SpiceManager::frameFromBody(const std::string& body) const {
+    std::lock_guard<std::recursive_mutex> lock(_spiceMutex);
+
     for (const std::pair<std::string, std::string>& pair : _frameByBody) {
         if (pair.first == body) {
             return pair.second;
@@ -1258,6 +1413,17 @@ scripting::LuaLibrary SpiceManager::luaLibrary() {
                 "{string, number}",
                 "Unloads the provided SPICE kernel. The name can contain path tokens, "
                 "which are automatically resolved"
+            },
+            {
+                "ephemerisCacheStatistics",
+                &luascriptfunctions::ephemerisCacheStatistics,
+                {},
+                "",
+                "Returns a list of tables with the statistics of all ephemeris caches. "
+                "Each table contains the 'Name' of the cache, the number of evaluations "
+                "that were answered from a fitted polynomial ('Hits'), that missed it "
+                "('Misses'), and that fell into a time range that could not be fitted "
+                "('Direct'), and the number of polynomials that were fitted ('Fits')"
             }
         }
     };
@@ -103,4 +103,40 @@ int unloadKernel(lua_State* L) {
     return 0;
 }
 
+/**
+ * ephemerisCacheStatistics():
+ * Returns a list of tables with the name and the statistics of each ephemeris cache.
+ */
+int ephemerisCacheStatistics(lua_State* L) {
+    ghoul::lua::checkArgumentsAndThrow(L, 0, "lua::ephemerisCacheStatistics");
+
+    using Statistics = std::pair<std::string, EphemerisCache::Statistics>;
+    const std::vector<Statistics> statistics =
+        SpiceManager::ref().ephemerisCacheStatistics();
+
+    lua_createtable(L, static_cast<int>(statistics.size()), 0);
+    int i = 1;
+    for (const Statistics& s : statistics) {
+        lua_pushnumber(L, i);
+
+        lua_createtable(L, 0, 5);
+        ghoul::lua::push(L, "Name", s.first);
+        lua_settable(L, -3);
+        ghoul::lua::push(L, "Hits", static_cast<double>(s.second.hits));
+        lua_settable(L, -3);
+        ghoul::lua::push(L, "Misses", static_cast<double>(s.second.misses));
+        lua_settable(L, -3);
+        ghoul::lua::push(L, "Direct", static_cast<double>(s.second.directEvaluations));
+        lua_settable(L, -3);
+        ghoul::lua::push(L, "Fits", static_cast<double>(s.second.fits));
+        lua_settable(L, -3);
+
+        lua_settable(L, -3);
+        ++i;
+    }
+
+    ghoul_assert(lua_gettop(L) == 1, "Incorrect number of items left on stack");
+    return 1;
+}
+
 } // namespace openspace::luascriptfunctions
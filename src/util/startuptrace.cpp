@@ -0,0 +1,222 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include <openspace/util/startuptrace.h>
+
+#include <openspace/json.h>
+#include <ghoul/fmt.h>
+#include <ghoul/misc/exception.h>
+#include <algorithm>
+#include <fstream>
+
+namespace {
+    constexpr const char* _loggerCat = "StartupTrace";
+
+    // All events belong to the same process
+    constexpr const int ProcessId = 1;
+    constexpr const int MainThreadIndex = 0;
+
+    double microseconds(std::chrono::steady_clock::duration d) {
+        return std::chrono::duration<double, std::micro>(d).count();
+    }
+} // namespace
+
+namespace openspace {
+
+StartupTrace::Scope::Scope(StartupTrace& trace, std::string category, std::string name)
+    : _trace(trace)
+    , _isEnabled(trace.isEnabled())
+{
+    if (_isEnabled) {
+        _category = std::move(category);
+        _name = std::move(name);
+        _begin = Clock::now();
+    }
+}
+
+StartupTrace::Scope::~Scope() {
+    if (_isEnabled) {
+        _trace.addEvent(std::move(_category), std::move(_name), _begin, Clock::now());
+    }
+}
+
+void StartupTrace::setEnabled(bool enabled) {
+    if (enabled && !_isEnabled) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _origin = Clock::now();
+        _mainThread = std::this_thread::get_id();
+        _threadIndices.clear();
+    }
+    _isEnabled = enabled;
+}
+
+bool StartupTrace::isEnabled() const {
+    return _isEnabled;
+}
+
+void StartupTrace::addEvent(std::string category, std::string name,
+                            Clock::time_point begin, Clock::time_point end)
+{
+    if (!_isEnabled) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    const int thread = threadIndex(std::this_thread::get_id());
+    _events.push_back({ std::move(category), std::move(name), begin, end, thread });
+}
+
+void StartupTrace::addAsyncEvent(std::string category, std::string name,
+                                 Clock::time_point begin, Clock::time_point end)
+{
+    if (!_isEnabled) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(_mutex);
+    _events.push_back({ std::move(category), std::move(name), begin, end, -1 });
+}
+
+size_t StartupTrace::nEvents() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _events.size();
+}
+
+std::string StartupTrace::json() const {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    nlohmann::json events = nlohmann::json::array();
+
+    // Metadata events name the rows of the threads in the viewer
+    events.push_back({
+        { "name", "thread_name" },
+        { "ph", "M" },
+        { "pid", ProcessId },
+        { "tid", MainThreadIndex },
+        { "args", { { "name", "Main thread" } } }
+    });
+    for (const std::pair<const std::thread::id, int>& p : _threadIndices) {
+        events.push_back({
+            { "name", "thread_name" },
+            { "ph", "M" },
+            { "pid", ProcessId },
+            { "tid", p.second },
+            { "args", { { "name", fmt::format("Worker thread {}", p.second) } } }
+        });
+    }
+
+    std::vector<const Event*> sortedEvents;
+    sortedEvents.reserve(_events.size());
+    for (const Event& e : _events) {
+        sortedEvents.push_back(&e);
+    }
+    std::stable_sort(
+        sortedEvents.begin(),
+        sortedEvents.end(),
+        [](const Event* lhs, const Event* rhs) { return lhs->begin < rhs->begin; }
+    );
+
+    int asyncId = 0;
+    for (const Event* e : sortedEvents) {
+        const double begin = microseconds(e->begin - _origin);
+        const double end = microseconds(e->end - _origin);
+
+        if (e->thread >= 0) {
+            events.push_back({
+                { "name", e->name },
+                { "cat", e->category },
+                { "ph", "X" },
+                { "ts", begin },
+                { "dur", end - begin },
+                { "pid", ProcessId },
+                { "tid", e->thread }
+            });
+        }
+        else {
+            // Asynchronous events consist of a begin and an end event with the same id,
+            // which the viewer shows on a separate row for each overlapping event
+            ++asyncId;
+            events.push_back({
+                { "name", e->name },
+                { "cat", e->category },
+                { "ph", "b" },
+                { "id", asyncId },
+                { "ts", begin },
+                { "pid", ProcessId },
+                { "tid", MainThreadIndex }
+            });
+            events.push_back({
+                { "name", e->name },
+                { "cat", e->category },
+                { "ph", "e" },
+                { "id", asyncId },
+                { "ts", end },
+                { "pid", ProcessId },
+                { "tid", MainThreadIndex }
+            });
+        }
+    }
+
+    nlohmann::json trace = {
+        { "traceEvents", std::move(events) },
+        { "displayTimeUnit", "ms" }
+    };
+    return trace.dump();
+}
+
+void StartupTrace::writeToFile(const std::string& path) const {
+    std::ofstream file(path);
+    if (!file.good()) {
+        throw ghoul::RuntimeError(
+            fmt::format("Could not open file '{}'", path),
+            _loggerCat
+        );
+    }
+    file << json();
+    if (!file.good()) {
+        throw ghoul::RuntimeError(
+            fmt::format("Could not write file '{}'", path),
+            _loggerCat
+        );
+    }
+}
+
+void StartupTrace::clear() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _events.clear();
+}
+
+int StartupTrace::threadIndex(std::thread::id id) {
+    if (id == _mainThread) {
+        return MainThreadIndex;
+    }
+    auto it = _threadIndices.find(id);
+    if (it != _threadIndices.end()) {
+        return it->second;
+    }
+    const int index = static_cast<int>(_threadIndices.size()) + 1;
+    _threadIndices[id] = index;
+    return index;
+}
+
+} // namespace openspace
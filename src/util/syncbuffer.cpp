@@ -52,15 +52,13 @@ std::string SyncBuffer::decode() {
     int32_t length;
     memcpy(
         reinterpret_cast<char*>(&length),
-        _dataStream.data() + _decodeOffset,
+        _decodeData + _decodeOffset,
         sizeof(int32_t)
     );
-    std::vector<char> tmp(length + 1);
     _decodeOffset += sizeof(int32_t);
-    memcpy(tmp.data(), _dataStream.data() + _decodeOffset, length);
+    ghoul_assert(_decodeOffset + length <= _decodeSize, "");
+    std::string ret(_decodeData + _decodeOffset, length);
     _decodeOffset += length;
-    tmp[length] = '\0';
-    std::string ret(tmp.data());
     return ret;
 }
 
@@ -70,18 +68,32 @@ void SyncBuffer::decode(std::string& s) {
 
 void SyncBuffer::setData(std::vector<char> data) {
     _dataStream = std::move(data);
+    _decodeData = _dataStream.data();
+    _decodeSize = _dataStream.size();
+    _decodeOffset = 0;
 }
 
-std::vector<char> SyncBuffer::data() {
-    _dataStream.resize(_encodeOffset);
+void SyncBuffer::setData(const char* data, size_t size) {
+    _decodeData = data;
+    _decodeSize = size;
+    _decodeOffset = 0;
+}
 
+const std::vector<char>& SyncBuffer::data() {
+    _dataStream.resize(_encodeOffset);
     return _dataStream;
 }
 
+size_t SyncBuffer::encodedSize() const {
+    return _encodeOffset;
+}
+
 void SyncBuffer::reset() {
     _dataStream.resize(_n);
     _encodeOffset = 0;
     _decodeOffset = 0;
+    _decodeData = nullptr;
+    _decodeSize = 0;
 }
 
 } // namespace openspace
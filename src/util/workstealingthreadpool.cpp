@@ -0,0 +1,201 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/util/workstealingthreadpool.h>
+
+#include <ghoul/fmt.h>
+#include <ghoul/logging/logmanager.h>
+#include <ghoul/misc/assert.h>
+#include <algorithm>
+#include <exception>
+
+namespace {
+    constexpr const char* _loggerCat = "WorkStealingThreadPool";
+
+    // The pool and index of the worker that is running on the current thread. These are
+    // used to enqueue tasks that are created by a task into the local queue
+    thread_local const void* CurrentPool = nullptr;
+    thread_local size_t CurrentWorker = 0;
+} // namespace
+
+namespace openspace {
+
+WorkStealingThreadPool::WorkStealingThreadPool(size_t numThreads) {
+    ghoul_assert(numThreads > 0, "Thread pool must have at least one thread");
+
+    _queues.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; ++i) {
+        _queues.push_back(std::make_unique<TaskQueue>());
+    }
+    _workers.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; ++i) {
+        _workers.emplace_back([this, i]() { workerLoop(i); });
+    }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _stop = true;
+    }
+    _condition.notify_all();
+
+    for (std::thread& w : _workers) {
+        w.join();
+    }
+}
+
+void WorkStealingThreadPool::enqueue(std::function<void()> f) {
+    const size_t index = (CurrentPool == this) ?
+        CurrentWorker :
+        _nextQueue++ % _queues.size();
+
+    {
+        // Taking the lock prevents the wakeup from getting lost between a worker checking
+        // the number of pending tasks and going to sleep. The counter is incremented
+        // before the task is visible so that it can never drop below zero
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        ++_nPendingTasks;
+    }
+    {
+        std::lock_guard<std::mutex> lock(_queues[index]->mutex);
+        _queues[index]->tasks.push_back(std::move(f));
+    }
+    _condition.notify_one();
+}
+
+bool WorkStealingThreadPool::runPendingTask() {
+    std::function<void()> task;
+    const size_t start = (CurrentPool == this) ? CurrentWorker : 0;
+    if (!popTask(start, task)) {
+        return false;
+    }
+    runTask(task);
+    return true;
+}
+
+void WorkStealingThreadPool::parallelFor(size_t n, size_t nBlocks,
+                                         const std::function<void(size_t, size_t)>& func)
+{
+    nBlocks = std::min(n, nBlocks);
+    std::atomic<size_t> nRemainingBlocks = nBlocks;
+    std::mutex exceptionMutex;
+    std::exception_ptr exception;
+    for (size_t b = 0; b < nBlocks; ++b) {
+        const size_t begin = n * b / nBlocks;
+        const size_t end = n * (b + 1) / nBlocks;
+        enqueue([&func, &nRemainingBlocks, &exceptionMutex, &exception, begin, end]() {
+            // The block has to be counted as finished even if it throws, as the calling
+            // thread would otherwise wait forever and the captured references dangle
+            try {
+                func(begin, end);
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(exceptionMutex);
+                if (!exception) {
+                    exception = std::current_exception();
+                }
+            }
+            --nRemainingBlocks;
+        });
+    }
+
+    while (nRemainingBlocks > 0) {
+        if (!runPendingTask()) {
+            std::this_thread::yield();
+        }
+    }
+
+    if (exception) {
+        std::rethrow_exception(exception);
+    }
+}
+
+size_t WorkStealingThreadPool::numThreads() const {
+    return _workers.size();
+}
+
+void WorkStealingThreadPool::workerLoop(size_t index) {
+    CurrentPool = this;
+    CurrentWorker = index;
+
+    std::function<void()> task;
+    while (true) {
+        if (popTask(index, task)) {
+            runTask(task);
+            task = nullptr;
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _condition.wait(lock, [this]() { return _stop || _nPendingTasks > 0; });
+        if (_stop) {
+            return;
+        }
+    }
+}
+
+void WorkStealingThreadPool::runTask(std::function<void()>& task) {
+    // An exception escaping a worker would terminate the application, and escaping
+    // runPendingTask it would unwind a parallelFor whose blocks are still running
+    try {
+        task();
+    }
+    catch (const std::exception& e) {
+        LERROR(fmt::format("Exception in task: {}", e.what()));
+    }
+    catch (...) {
+        LERROR("Unknown exception in task");
+    }
+}
+
+bool WorkStealingThreadPool::popTask(size_t index, std::function<void()>& task) {
+    // Our own queue is processed in LIFO order to keep the caches warm, whereas other
+    // queues are stolen from in FIFO order as these are the oldest, and often largest,
+    // tasks
+    {
+        TaskQueue& own = *_queues[index];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.tasks.empty()) {
+            task = std::move(own.tasks.back());
+            own.tasks.pop_back();
+            --_nPendingTasks;
+            return true;
+        }
+    }
+
+    for (size_t i = 1; i < _queues.size(); ++i) {
+        TaskQueue& victim = *_queues[(index + i) % _queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.tasks.empty()) {
+            task = std::move(victim.tasks.front());
+            victim.tasks.pop_front();
+            --_nPendingTasks;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // namespace openspace
@@ -0,0 +1,149 @@
+// Load test for the WebSocket interface of the Server module.
+//
+// Connects a number of simulated GUI clients that all subscribe to the same set of
+// properties, while one additional client drags a "slider" by setting one of these
+// properties as fast as a browser would send the changes. Once per second the number
+// of received messages per client is printed, which should be bounded by the frame rate
+// of OpenSpace (or the requested maximum rate) rather than by the rate of changes.
+//
+// Usage:
+//   npm install ws
+//   node loadtest.js [-clients 100] [-port 4682] [-rate 120] [-maxrate 0] [-time 30]
+//                    [-property RenderEngine.Gamma] ...
+//
+// -clients   Number of simulated GUI clients
+// -port      Port of the WebSocket interface
+// -rate      Number of property changes per second sent by the slider client
+// -maxrate   Maximum number of updates per second requested for each subscription,
+//            0 means that the rate is only limited by the frame rate
+// -time      Duration of the test in seconds
+// -property  Property that is subscribed to, can be given multiple times. The first
+//            property is the one changed by the slider client and has to be numerical
+
+const WebSocket = require('ws');
+
+var NUM_CLIENTS = 100;
+var PORT = 4682;
+var CHANGE_RATE = 120;
+var MAX_RATE = 0;
+var DURATION = 30;
+var PROPERTIES = [];
+
+// Parse optional arguments
+function argIndexOf(param){
+	return process.argv.indexOf(param, 2);
+}
+
+var paramIndex = -1;
+if( (paramIndex = argIndexOf("-clients")) != -1){
+	NUM_CLIENTS = +process.argv[paramIndex + 1];
+}
+if( (paramIndex = argIndexOf("-port")) != -1){
+	PORT = +process.argv[paramIndex + 1];
+}
+if( (paramIndex = argIndexOf("-rate")) != -1){
+	CHANGE_RATE = +process.argv[paramIndex + 1];
+}
+if( (paramIndex = argIndexOf("-maxrate")) != -1){
+	MAX_RATE = +process.argv[paramIndex + 1];
+}
+if( (paramIndex = argIndexOf("-time")) != -1){
+	DURATION = +process.argv[paramIndex + 1];
+}
+for (var i = 2; i < process.argv.length - 1; i++) {
+	if(process.argv[i] == "-property"){
+		PROPERTIES.push(process.argv[i + 1]);
+	}
+}
+if(PROPERTIES.length == 0){
+	PROPERTIES = [
+		"RenderEngine.Gamma",
+		"RenderEngine.HDRExposure",
+		"NavigationHandler.OrbitalNavigator.Friction.RotationalFriction"
+	];
+}
+
+var URL = "ws://localhost:" + PORT;
+var clients = [];
+var receivedMessages = 0;
+var receivedBytes = 0;
+var receivedPerClient = [];
+
+run();
+
+function run(){
+	for (var i = 0; i < NUM_CLIENTS; i++) {
+		connectGuiClient(i);
+	}
+	var slider = new WebSocket(URL);
+	slider.on('open', function() { dragSlider(slider); });
+	slider.on('error', function(err) { console.log("Slider client: " + err.message); });
+
+	var start = Date.now();
+	var interval = setInterval(function() {
+		printStatistics((Date.now() - start) / 1000);
+		if(Date.now() - start > DURATION * 1000){
+			clearInterval(interval);
+			slider.close();
+			clients.forEach(function(c) { c.close(); });
+		}
+	}, 1000);
+}
+
+function connectGuiClient(index){
+	var socket = new WebSocket(URL);
+	receivedPerClient[index] = 0;
+	socket.on('open', function() {
+		PROPERTIES.forEach(function(property, topic) {
+			var payload = { event: "start_subscription", property: property };
+			if(MAX_RATE > 0){
+				payload.maxRate = MAX_RATE;
+			}
+			socket.send(JSON.stringify({
+				topic: topic,
+				type: "subscribe",
+				payload: payload
+			}));
+		});
+	});
+	socket.on('message', function(data) {
+		receivedMessages++;
+		receivedBytes += data.length;
+		receivedPerClient[index]++;
+	});
+	socket.on('error', function(err) {
+		console.log("Client " + index + ": " + err.message);
+	});
+	clients.push(socket);
+}
+
+function dragSlider(socket){
+	var step = 0;
+	setInterval(function() {
+		if(socket.readyState != WebSocket.OPEN){
+			return;
+		}
+		// Move back and forth between 0.5 and 1.5, like a slider being dragged
+		var value = 0.5 + Math.abs(((step++ % 200) - 100) / 100);
+		socket.send(JSON.stringify({
+			topic: step,
+			type: "set",
+			payload: { property: PROPERTIES[0], value: value }
+		}));
+	}, 1000 / CHANGE_RATE);
+}
+
+function printStatistics(seconds){
+	var min = Math.min.apply(null, receivedPerClient);
+	var max = Math.max.apply(null, receivedPerClient);
+	console.log(
+		seconds.toFixed(0) + "s: " + receivedMessages + " messages (" +
+		(receivedBytes / 1024).toFixed(1) + " KiB) to " + NUM_CLIENTS + " clients, " +
+		"per client min " + min + " max " + max
+	);
+	receivedMessages = 0;
+	receivedBytes = 0;
+	for (var i = 0; i < receivedPerClient.length; i++) {
+		receivedPerClient[i] = 0;
+	}
+}
@@ -61,21 +61,46 @@
 #include <ghoul/ghoul.h>
 #include <iostream>
 
+// Benchmarks are registered as DISABLED_ tests so that they are not part of the unit
+// test run. They are run by passing --gtest_also_run_disabled_tests
 #include <test_common.inl>
 #include <test_assetloader.inl>
 #include <test_documentation.inl>
+#include <test_downloadengine.inl>
+#include <test_ephemeriscache.inl>
 #include <test_luaconversions.inl>
 #include <test_optionproperty.inl>
+#include <test_pointcatalogcache.inl>
 #include <test_powerscalecoordinates.inl>
+#include <test_scenegraphnode.inl>
 #include <test_scriptscheduler.inl>
+#include <test_sessionrecording.inl>
 #include <test_spicemanager.inl>
+#include <test_speckfile.inl>
+#include <test_startuptrace.inl>
+#include <test_syncengine.inl>
 #include <test_timeline.inl>
+#include <test_workstealingthreadpool.inl>
+
+#ifdef OPENSPACE_MODULE_BASE_ENABLED
+#include <test_trailorbitsampler.inl>
+#endif
+
+#ifdef OPENSPACE_MODULE_DIGITALUNIVERSE_ENABLED
+#include <test_billboardsdataslice.inl>
+#endif
+
+#ifdef OPENSPACE_MODULE_FIELDLINESSEQUENCE_ENABLED
+#include <test_fieldlinesstateprefetcher.inl>
+#endif
 
 #ifdef OPENSPACE_MODULE_GLOBEBROWSING_ENABLED
 #include <test_angle.inl>
 #include <test_concurrentjobmanager.inl>
 #include <test_concurrentqueue.inl>
+#include <test_disktilestore.inl>
 #include <test_lrucache.inl>
+#include <test_rawtiledatareader.inl>
 #include <test_gdalwms.inl>
 #endif
 
@@ -83,6 +108,14 @@
 #include <test_screenspaceimage.inl>
 #endif
 
+#ifdef OPENSPACE_MODULE_MULTIRESVOLUME_ENABLED
+#include <test_tsp.inl>
+#endif
+
+#ifdef OPENSPACE_MODULE_SPACE_ENABLED
+#include <test_keplercatalog.inl>
+#endif
+
 #ifdef OPENSPACE_MODULE_VOLUME_ENABLED
 #include <test_rawvolumeio.inl>
 #endif
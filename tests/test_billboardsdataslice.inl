@@ -0,0 +1,203 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <modules/digitaluniverse/rendering/billboardsdataslice.h>
+#include <openspace/util/workstealingthreadpool.h>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace {
+    // Enough objects to be split into several blocks
+    constexpr const size_t NumberObjects = 300000;
+
+    std::vector<float> randomValues(size_t n, float min, float max, unsigned int seed) {
+        std::mt19937 random(seed);
+        std::uniform_real_distribution<float> dist(min, max);
+        std::vector<float> values(n);
+        for (float& v : values) {
+            v = dist(random);
+        }
+        return values;
+    }
+
+    // Values on a bin boundary may end up in either of the neighboring bins
+    bool isOnBinBoundary(float value, float binSize) {
+        const float bin = value / binSize;
+        return std::isfinite(bin) && bin != 0.f && std::floor(bin) == bin;
+    }
+
+    // The color lookup that was used before the bins were computed directly, which
+    // searches from the last bin downwards
+    int referenceColorIndex(float value, float binSize, int nColors) {
+        std::vector<float> colorBins;
+        float bin = binSize;
+        for (int i = 0; i < nColors; ++i) {
+            colorBins.push_back(bin);
+            bin += binSize;
+        }
+
+        int c = static_cast<int>(colorBins.size() - 1);
+        while (value < colorBins[c]) {
+            --c;
+            if (c == 0) {
+                break;
+            }
+        }
+        return c == static_cast<int>(colorBins.size() - 1) ? 0 : c + 1;
+    }
+} // namespace
+
+TEST(BillboardsDataSliceTest, ColorBin) {
+    constexpr const int NumberColors = 12;
+    constexpr const float BinSize = 0.37f;
+
+    std::vector<float> values = randomValues(100000, -2.f, 6.f, 1);
+    values.push_back(0.f);
+    values.push_back(-0.f);
+    values.push_back(std::numeric_limits<float>::quiet_NaN());
+    values.push_back(std::numeric_limits<float>::infinity());
+    values.push_back(-std::numeric_limits<float>::infinity());
+
+    for (float v : values) {
+        if (isOnBinBoundary(v, BinSize)) {
+            continue;
+        }
+        EXPECT_EQ(
+            openspace::digitaluniverse::colorBin(v, BinSize, NumberColors),
+            referenceColorIndex(v, BinSize, NumberColors)
+        ) << "Value " << v;
+    }
+}
+
+TEST(BillboardsDataSliceTest, ParallelPositionsMatchSerial) {
+    using namespace openspace;
+
+    const std::vector<float> xs = randomValues(NumberObjects, -1e3f, 1e3f, 2);
+    const std::vector<float> ys = randomValues(NumberObjects, -1e3f, 1e3f, 3);
+    const std::vector<float> zs = randomValues(NumberObjects, -1e3f, 1e3f, 4);
+
+    glm::dmat4 transformation = glm::dmat4(1.0);
+    const std::vector<float> m = randomValues(12, -2.f, 2.f, 5);
+    for (int c = 0; c < 4; ++c) {
+        for (int r = 0; r < 3; ++r) {
+            transformation[c][r] = m[c * 3 + r];
+        }
+    }
+    constexpr const float Unit = 3.5f;
+
+    std::vector<float> serial(4 * NumberObjects);
+    const float serialBiggest = digitaluniverse::slicePositions(
+        xs.data(),
+        ys.data(),
+        zs.data(),
+        NumberObjects,
+        transformation,
+        Unit,
+        serial.data(),
+        nullptr
+    );
+
+    WorkStealingThreadPool pool(4);
+    std::vector<float> parallel(4 * NumberObjects);
+    const float parallelBiggest = digitaluniverse::slicePositions(
+        xs.data(),
+        ys.data(),
+        zs.data(),
+        NumberObjects,
+        transformation,
+        Unit,
+        parallel.data(),
+        &pool
+    );
+
+    EXPECT_EQ(serial, parallel);
+    EXPECT_EQ(serialBiggest, parallelBiggest);
+
+    // Both are equal to the straightforward matrix multiplication
+    float biggest = -1.f;
+    for (size_t i = 0; i < NumberObjects; ++i) {
+        const glm::dvec4 p = transformation * glm::dvec4(xs[i], ys[i], zs[i], 1.0);
+        for (int j = 0; j < 3; ++j) {
+            ASSERT_FLOAT_EQ(serial[4 * i + j], static_cast<float>(p[j]))
+                << "Object " << i;
+            biggest = std::max(biggest, serial[4 * i + j]);
+        }
+        ASSERT_EQ(serial[4 * i + 3], Unit);
+    }
+    EXPECT_EQ(serialBiggest, std::max(biggest, Unit));
+}
+
+TEST(BillboardsDataSliceTest, ParallelColorsMatchSerial) {
+    using namespace openspace;
+
+    std::vector<glm::vec4> colorMap;
+    for (int i = 0; i < 9; ++i) {
+        const float f = static_cast<float>(i);
+        colorMap.emplace_back(f, 0.5f * f, 1.f - 0.1f * f, 1.f);
+    }
+    constexpr const float BinSize = 0.25f;
+    const std::vector<float> values = randomValues(NumberObjects, -1.f, 3.f, 6);
+
+    std::vector<float> serial(4 * NumberObjects);
+    digitaluniverse::sliceColors(
+        values.data(),
+        NumberObjects,
+        BinSize,
+        colorMap,
+        serial.data(),
+        nullptr
+    );
+
+    WorkStealingThreadPool pool(4);
+    std::vector<float> parallel(4 * NumberObjects);
+    digitaluniverse::sliceColors(
+        values.data(),
+        NumberObjects,
+        BinSize,
+        colorMap,
+        parallel.data(),
+        &pool
+    );
+
+    EXPECT_EQ(serial, parallel);
+
+    for (size_t i = 0; i < NumberObjects; ++i) {
+        if (isOnBinBoundary(values[i], BinSize)) {
+            continue;
+        }
+        const glm::vec4& expected = colorMap[referenceColorIndex(
+            values[i],
+            BinSize,
+            static_cast<int>(colorMap.size())
+        )];
+        for (int j = 0; j < 4; ++j) {
+            ASSERT_EQ(serial[4 * i + j], expected[j]) << "Object " << i;
+        }
+    }
+}
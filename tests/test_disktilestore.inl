@@ -0,0 +1,127 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <modules/globebrowsing/src/disktilestore.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <filesystem>
+
+namespace {
+    openspace::globebrowsing::cache::CompressedTile createTile(size_t nBytes, int seed) {
+        openspace::globebrowsing::cache::CompressedTile tile;
+        tile.initDataKey = 42;
+        tile.uncompressedSize = 2 * nBytes;
+        tile.data.resize(nBytes);
+        for (size_t i = 0; i < nBytes; ++i) {
+            tile.data[i] = static_cast<std::byte>((seed + i) % 256);
+        }
+        tile.metaData = openspace::globebrowsing::TileMetaData();
+        tile.metaData->maxValues = { static_cast<float>(seed) };
+        return tile;
+    }
+
+    openspace::globebrowsing::cache::ProviderTileKey key(int x) {
+        return { openspace::globebrowsing::TileIndex(x, 0, 1), 0 };
+    }
+} // namespace
+
+class DiskTileStoreTest : public testing::Test {};
+
+TEST_F(DiskTileStoreTest, PutAndTake) {
+    using namespace openspace::globebrowsing::cache;
+    DiskTileStore store(absPath("${TEMPORARY}/test_disktilestore.bin"), 1024);
+
+    ASSERT_TRUE(store.put(key(1), createTile(100, 1)));
+    ASSERT_TRUE(store.put(key(2), createTile(200, 2)));
+    EXPECT_EQ(store.size(), 300);
+
+    std::optional<CompressedTile> tile = store.take(key(1));
+    ASSERT_TRUE(tile.has_value());
+    EXPECT_EQ(tile->initDataKey, 42);
+    EXPECT_EQ(tile->uncompressedSize, 200);
+    EXPECT_EQ(tile->data, createTile(100, 1).data);
+    ASSERT_TRUE(tile->metaData.has_value());
+    EXPECT_EQ(tile->metaData->maxValues[0], 1.f);
+
+    // Taking a tile removes it from the store
+    EXPECT_FALSE(store.exist(key(1)));
+    EXPECT_FALSE(store.take(key(1)).has_value());
+    EXPECT_EQ(store.size(), 200);
+
+    // Tiles larger than the budget are rejected
+    EXPECT_FALSE(store.put(key(3), createTile(2048, 3)));
+}
+
+TEST_F(DiskTileStoreTest, WrapAround) {
+    using namespace openspace::globebrowsing::cache;
+    DiskTileStore store(absPath("${TEMPORARY}/test_disktilestore.bin"), 1000);
+
+    for (int i = 0; i < 4; ++i) {
+        ASSERT_TRUE(store.put(key(i), createTile(300, i)));
+    }
+
+    // The fourth tile did not fit at the end, so it overwrote the first one
+    EXPECT_FALSE(store.exist(key(0)));
+    EXPECT_TRUE(store.exist(key(1)));
+    EXPECT_TRUE(store.exist(key(2)));
+    EXPECT_TRUE(store.exist(key(3)));
+    EXPECT_EQ(store.size(), 900);
+
+    std::optional<CompressedTile> tile = store.take(key(2));
+    ASSERT_TRUE(tile.has_value());
+    EXPECT_EQ(tile->data, createTile(300, 2).data);
+
+    // Shrinking the budget drops every tile beyond it
+    store.setBudget(400);
+    EXPECT_TRUE(store.exist(key(3)));
+    EXPECT_FALSE(store.exist(key(1)));
+    EXPECT_EQ(store.size(), 300);
+}
+
+TEST_F(DiskTileStoreTest, ShrinkBudget) {
+    using namespace openspace::globebrowsing::cache;
+    const std::string path = absPath("${TEMPORARY}/test_disktilestore.bin");
+    DiskTileStore store(path, 1000);
+
+    for (int i = 0; i < 3; ++i) {
+        ASSERT_TRUE(store.put(key(i), createTile(300, i)));
+    }
+
+    // Reducing the budget shrinks the file, but keeps the tiles that are in front of it
+    store.setBudget(400);
+    EXPECT_LE(std::filesystem::file_size(path), 400u);
+    EXPECT_EQ(store.size(), 300);
+
+    std::optional<CompressedTile> tile = store.take(key(0));
+    ASSERT_TRUE(tile.has_value());
+    EXPECT_EQ(tile->data, createTile(300, 0).data);
+
+    // The store can still be written to after the file was shrunk
+    ASSERT_TRUE(store.put(key(3), createTile(100, 3)));
+    tile = store.take(key(3));
+    ASSERT_TRUE(tile.has_value());
+    EXPECT_EQ(tile->data, createTile(100, 3).data);
+}
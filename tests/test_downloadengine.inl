@@ -0,0 +1,409 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <openspace/util/downloadengine.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/io/socket/tcpsocket.h>
+#include <ghoul/io/socket/tcpsocketserver.h>
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    constexpr const int DownloadTestPort = 28641;
+
+    // The strong ETag that the test server sends for the content
+    std::string etag(const std::string& content) {
+        return '"' + std::to_string(std::hash<std::string>()(content)) + '"';
+    }
+
+    // A minimal HTTP/1.1 server that serves files from memory, keeps connections alive,
+    // and answers requests with a 'Range: bytes=N-' header with the rest of the file. If
+    // the request has an 'If-Range' header that doesn't match the ETag of the file, the
+    // whole file is sent instead
+    class TestHttpServer {
+    public:
+        TestHttpServer(std::map<std::string, std::string> files, bool supportsRanges)
+            : _files(std::move(files))
+            , _supportsRanges(supportsRanges)
+        {
+            _server.listen(DownloadTestPort);
+            _acceptThread = std::thread([this]() {
+                while (!_shouldStop) {
+                    std::unique_ptr<ghoul::io::TcpSocket> socket =
+                        _server.awaitPendingTcpSocket();
+                    if (!socket) {
+                        return;
+                    }
+                    socket->startStreams();
+
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    ghoul::io::TcpSocket* s = socket.get();
+                    _sockets.push_back(std::move(socket));
+                    _threads.emplace_back([this, s]() { handleConnection(*s); });
+                }
+            });
+        }
+
+        ~TestHttpServer() {
+            _shouldStop = true;
+            _server.close();
+            _acceptThread.join();
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            for (std::unique_ptr<ghoul::io::TcpSocket>& socket : _sockets) {
+                socket->disconnect();
+            }
+            for (std::thread& thread : _threads) {
+                thread.join();
+            }
+        }
+
+        std::string url(const std::string& file) const {
+            return "http://127.0.0.1:" + std::to_string(DownloadTestPort) + "/" + file;
+        }
+
+        int nConnections() {
+            std::lock_guard<std::mutex> lock(_mutex);
+            return static_cast<int>(_sockets.size());
+        }
+
+        int nRangeRequests() const {
+            return _nRangeRequests;
+        }
+
+        int nValidatedRequests() const {
+            return _nValidatedRequests;
+        }
+
+    private:
+        void handleConnection(ghoul::io::TcpSocket& socket) {
+            while (!_shouldStop) {
+                std::string header;
+                while (header.size() < 4 ||
+                       header.compare(header.size() - 4, 4, "\r\n\r\n") != 0)
+                {
+                    char c;
+                    if (!socket.get<char>(&c, 1)) {
+                        return;
+                    }
+                    header += c;
+                }
+
+                // GET /<file> HTTP/1.1
+                const size_t begin = header.find('/') + 1;
+                const size_t end = header.find(' ', begin);
+                const std::string file = header.substr(begin, end - begin);
+
+                auto it = _files.find(file);
+
+                size_t offset = 0;
+                const size_t range = header.find("Range: bytes=");
+                if (range != std::string::npos && _supportsRanges) {
+                    offset = std::stoul(header.substr(range + 13));
+                    ++_nRangeRequests;
+                }
+                const size_t ifRange = header.find("If-Range: ");
+                if (ifRange != std::string::npos) {
+                    ++_nValidatedRequests;
+                    const size_t valueBegin = ifRange + 10;
+                    const std::string value = header.substr(
+                        valueBegin,
+                        header.find("\r\n", valueBegin) - valueBegin
+                    );
+                    if (it != _files.end() && value != etag(it->second)) {
+                        offset = 0;
+                    }
+                }
+
+                std::string response;
+                if (it == _files.end()) {
+                    response = "HTTP/1.1 404 Not Found\r\nContent-Length: 9\r\n\r\n"
+                               "Not Found";
+                }
+                else if (offset > 0) {
+                    const std::string& content = it->second;
+                    response = "HTTP/1.1 206 Partial Content\r\nETag: " +
+                        etag(content) + "\r\nContent-Length: " +
+                        std::to_string(content.size() - offset) +
+                        "\r\nContent-Range: bytes " + std::to_string(offset) + "-" +
+                        std::to_string(content.size() - 1) + "/" +
+                        std::to_string(content.size()) + "\r\n\r\n" +
+                        content.substr(offset);
+                }
+                else {
+                    response = "HTTP/1.1 200 OK\r\nETag: " + etag(it->second) +
+                        "\r\nContent-Length: " +
+                        std::to_string(it->second.size()) + "\r\n\r\n" + it->second;
+                }
+
+                if (!socket.put<char>(response.data(), response.size())) {
+                    return;
+                }
+            }
+        }
+
+        const std::map<std::string, std::string> _files;
+        const bool _supportsRanges;
+        std::atomic_bool _shouldStop = false;
+        std::atomic_int _nRangeRequests = 0;
+        std::atomic_int _nValidatedRequests = 0;
+
+        ghoul::io::TcpSocketServer _server;
+        std::mutex _mutex;
+        std::vector<std::unique_ptr<ghoul::io::TcpSocket>> _sockets;
+        std::vector<std::thread> _threads;
+        std::thread _acceptThread;
+    };
+
+    std::string fileContent(int i, size_t size) {
+        std::string content(size, ' ');
+        for (size_t j = 0; j < size; ++j) {
+            content[j] = static_cast<char>('a' + (i + j) % 26);
+        }
+        return content;
+    }
+
+    std::string readFile(const std::string& path) {
+        std::ifstream file(path, std::ifstream::binary);
+        return std::string(std::istreambuf_iterator<char>(file), {});
+    }
+
+    // Creates the state that an interrupted download of the content leaves behind
+    void writePartialFile(const std::string& path, const std::string& content,
+                          size_t size, const std::string& validator)
+    {
+        std::ofstream file(path, std::ofstream::binary);
+        file << content.substr(0, size);
+
+        const std::string validatorPath =
+            path + openspace::DownloadEngine::ValidatorExtension;
+        if (validator.empty()) {
+            std::filesystem::remove(validatorPath);
+        }
+        else {
+            std::ofstream validatorFile(validatorPath);
+            validatorFile << validator << '\n';
+        }
+    }
+
+    bool hasValidator(const std::string& path) {
+        return std::filesystem::exists(
+            path + openspace::DownloadEngine::ValidatorExtension
+        );
+    }
+} // namespace
+
+class DownloadEngineTest : public testing::Test {};
+
+TEST_F(DownloadEngineTest, ManyFiles) {
+    using Transfer = openspace::DownloadEngine::Transfer;
+
+    constexpr const int NumberFiles = 300;
+    constexpr const int MaxConcurrentTransfers = 4;
+
+    std::map<std::string, std::string> files;
+    size_t totalSize = 0;
+    for (int i = 0; i < NumberFiles; ++i) {
+        files["file" + std::to_string(i)] = fileContent(i, 100 + i * 37);
+        totalSize += 100 + i * 37;
+    }
+    TestHttpServer server(files, true);
+
+    auto progress = std::make_shared<openspace::DownloadEngine::Progress>();
+    std::vector<std::shared_ptr<Transfer>> transfers;
+    {
+        openspace::DownloadEngine engine(MaxConcurrentTransfers);
+        for (int i = 0; i < NumberFiles; ++i) {
+            openspace::DownloadEngine::Request request;
+            request.url = server.url("file" + std::to_string(i));
+            request.destination = absPath(
+                "${TEMPORARY}/test_downloadengine/file" + std::to_string(i)
+            );
+            request.progress = progress;
+            transfers.push_back(engine.enqueue(std::move(request)));
+        }
+        for (const std::shared_ptr<Transfer>& transfer : transfers) {
+            transfer->wait();
+        }
+
+        // Every transfer after the first few reuses one of the open connections
+        EXPECT_LE(engine.nOpenedConnections(), MaxConcurrentTransfers);
+    }
+    EXPECT_LE(server.nConnections(), MaxConcurrentTransfers);
+
+    for (int i = 0; i < NumberFiles; ++i) {
+        ASSERT_EQ(transfers[i]->state(), Transfer::State::Succeeded);
+        EXPECT_EQ(
+            readFile(transfers[i]->destination()),
+            files["file" + std::to_string(i)]
+        );
+    }
+    EXPECT_EQ(progress->nUnknownSizes, 0);
+    EXPECT_EQ(progress->totalBytes, totalSize);
+    EXPECT_EQ(progress->downloadedBytes, totalSize);
+}
+
+TEST_F(DownloadEngineTest, Resume) {
+    using Transfer = openspace::DownloadEngine::Transfer;
+
+    const std::string content = fileContent(0, 100000);
+    TestHttpServer server({ { "file", content } }, true);
+
+    const std::string path = absPath("${TEMPORARY}/test_downloadengine_resume");
+    writePartialFile(path, content, 30000, etag(content));
+
+    openspace::DownloadEngine engine;
+    openspace::DownloadEngine::Request request;
+    request.url = server.url("file");
+    request.destination = path;
+    request.resume = true;
+    request.progress = std::make_shared<openspace::DownloadEngine::Progress>();
+    std::shared_ptr<Transfer> transfer = engine.enqueue(request);
+    transfer->wait();
+
+    ASSERT_EQ(transfer->state(), Transfer::State::Succeeded);
+    EXPECT_EQ(server.nRangeRequests(), 1);
+    EXPECT_EQ(server.nValidatedRequests(), 1);
+    EXPECT_EQ(readFile(path), content);
+    EXPECT_FALSE(hasValidator(path));
+    EXPECT_EQ(request.progress->totalBytes, content.size());
+    EXPECT_EQ(request.progress->downloadedBytes, content.size());
+}
+
+TEST_F(DownloadEngineTest, ResumeChangedFile) {
+    using Transfer = openspace::DownloadEngine::Transfer;
+
+    // The partial file belongs to an older version of the file on the server
+    const std::string oldContent = fileContent(3, 100000);
+    const std::string content = fileContent(4, 100000);
+    TestHttpServer server({ { "file", content } }, true);
+
+    const std::string path = absPath("${TEMPORARY}/test_downloadengine_changed");
+    writePartialFile(path, oldContent, 30000, etag(oldContent));
+
+    openspace::DownloadEngine engine;
+    openspace::DownloadEngine::Request request;
+    request.url = server.url("file");
+    request.destination = path;
+    request.resume = true;
+    request.progress = std::make_shared<openspace::DownloadEngine::Progress>();
+    std::shared_ptr<Transfer> transfer = engine.enqueue(request);
+    transfer->wait();
+
+    // The server sends the whole file, which replaces the outdated part
+    ASSERT_EQ(transfer->state(), Transfer::State::Succeeded);
+    EXPECT_EQ(server.nValidatedRequests(), 1);
+    EXPECT_EQ(readFile(path), content);
+    EXPECT_FALSE(hasValidator(path));
+    EXPECT_EQ(request.progress->totalBytes, content.size());
+    EXPECT_EQ(request.progress->downloadedBytes, content.size());
+}
+
+TEST_F(DownloadEngineTest, ResumeWithoutValidator) {
+    using Transfer = openspace::DownloadEngine::Transfer;
+
+    const std::string oldContent = fileContent(5, 100000);
+    const std::string content = fileContent(6, 100000);
+    TestHttpServer server({ { "file", content } }, true);
+
+    const std::string path = absPath("${TEMPORARY}/test_downloadengine_novalidator");
+    writePartialFile(path, oldContent, 30000, "");
+
+    openspace::DownloadEngine engine;
+    openspace::DownloadEngine::Request request;
+    request.url = server.url("file");
+    request.destination = path;
+    request.resume = true;
+    std::shared_ptr<Transfer> transfer = engine.enqueue(request);
+    transfer->wait();
+
+    // Without a validator the existing part can't be trusted and is never resumed
+    ASSERT_EQ(transfer->state(), Transfer::State::Succeeded);
+    EXPECT_EQ(server.nRangeRequests(), 0);
+    EXPECT_EQ(readFile(path), content);
+}
+
+TEST_F(DownloadEngineTest, ResumeWithoutRangeSupport) {
+    using Transfer = openspace::DownloadEngine::Transfer;
+
+    const std::string content = fileContent(1, 100000);
+    TestHttpServer server({ { "file", content } }, false);
+
+    const std::string path = absPath("${TEMPORARY}/test_downloadengine_norange");
+    writePartialFile(path, content, 30000, etag(content));
+
+    openspace::DownloadEngine engine;
+    openspace::DownloadEngine::Request request;
+    request.url = server.url("file");
+    request.destination = path;
+    request.resume = true;
+    request.progress = std::make_shared<openspace::DownloadEngine::Progress>();
+    std::shared_ptr<Transfer> transfer = engine.enqueue(request);
+    transfer->wait();
+
+    // The server sends the whole file, which replaces the existing part
+    ASSERT_EQ(transfer->state(), Transfer::State::Succeeded);
+    EXPECT_EQ(readFile(path), content);
+    EXPECT_EQ(request.progress->totalBytes, content.size());
+    EXPECT_EQ(request.progress->downloadedBytes, content.size());
+}
+
+TEST_F(DownloadEngineTest, MemoryAndFailure) {
+    using Transfer = openspace::DownloadEngine::Transfer;
+
+    const std::string content = fileContent(2, 1000);
+    TestHttpServer server({ { "file", content } }, true);
+
+    openspace::DownloadEngine engine;
+    openspace::DownloadEngine::Request request;
+    request.url = server.url("file");
+    std::shared_ptr<Transfer> memory = engine.enqueue(request);
+
+    request.url = server.url("missing");
+    request.destination = absPath("${TEMPORARY}/test_downloadengine_missing");
+    std::shared_ptr<Transfer> missing = engine.enqueue(request);
+
+    memory->wait();
+    missing->wait();
+
+    ASSERT_EQ(memory->state(), Transfer::State::Succeeded);
+    EXPECT_EQ(std::string(memory->data().begin(), memory->data().end()), content);
+
+    // The error page must not end up in the file
+    EXPECT_EQ(missing->state(), Transfer::State::Failed);
+    EXPECT_TRUE(readFile(request.destination).empty());
+    EXPECT_FALSE(hasValidator(request.destination));
+}
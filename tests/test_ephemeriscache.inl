@@ -0,0 +1,253 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <openspace/util/ephemeriscache.h>
+#include <ghoul/misc/exception.h>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <thread>
+#include <vector>
+
+namespace {
+    constexpr const double OrbitRadius = 7000.0;
+    constexpr const double OrbitPeriod = 5400.0;
+
+    // A low earth orbit, which is the hardest case for the cache as the pieces have to
+    // be short
+    void orbit(double time, double* result) {
+        const double angle = 2.0 * 3.14159265358979323846 * time / OrbitPeriod;
+        result[0] = OrbitRadius * std::cos(angle);
+        result[1] = OrbitRadius * std::sin(angle);
+        result[2] = 0.1 * OrbitRadius * std::sin(0.5 * angle);
+    }
+} // namespace
+
+class EphemerisCacheTest : public testing::Test {};
+
+TEST_F(EphemerisCacheTest, Accuracy) {
+    constexpr const double Tolerance = 1e-6;
+    openspace::EphemerisCache cache(3, orbit, Tolerance);
+
+    // A node that is updated every frame while the time is moving forward
+    for (double time = -3600.0; time < 7200.0; time += 0.25) {
+        double cached[3];
+        cache.evaluate(time, cached);
+        double exact[3];
+        orbit(time, exact);
+        for (int c = 0; c < 3; ++c) {
+            ASSERT_NEAR(cached[c], exact[c], 2.0 * Tolerance) << "at time " << time;
+        }
+    }
+
+    const openspace::EphemerisCache::Statistics stats = cache.statistics();
+    EXPECT_GT(stats.fits, 0);
+    EXPECT_GT(stats.hits, 20 * stats.misses);
+    EXPECT_EQ(stats.directEvaluations, 0);
+}
+
+TEST_F(EphemerisCacheTest, Discontinuity) {
+    constexpr const double Step = 1000.0;
+    int nCalls = 0;
+    openspace::EphemerisCache cache(
+        1,
+        [&nCalls](double time, double* result) {
+            ++nCalls;
+            result[0] = time < Step ? 0.0 : 1.0;
+        },
+        1e-9
+    );
+
+    for (int pass = 0; pass < 100; ++pass) {
+        for (double time = Step - 20.0; time < Step + 20.0; time += 1.0) {
+            double value;
+            cache.evaluate(time, &value);
+            ASSERT_NEAR(value, time < Step ? 0.0 : 1.0, 1e-9) << "at time " << time;
+        }
+    }
+
+    // The pieces that contain the step have to be evaluated directly, all others are
+    // constant and are fitted
+    const openspace::EphemerisCache::Statistics stats = cache.statistics();
+    EXPECT_GT(stats.directEvaluations, 0);
+    EXPECT_GT(stats.hits, 0);
+}
+
+TEST_F(EphemerisCacheTest, Invalidate) {
+    double offset = 0.0;
+    openspace::EphemerisCache cache(
+        3,
+        [&offset](double time, double* result) {
+            orbit(time, result);
+            result[0] += offset;
+        },
+        1e-6
+    );
+
+    double exact[3];
+    orbit(100.0, exact);
+
+    double value[3];
+    for (int i = 0; i < 1000; ++i) {
+        cache.evaluate(100.0, value);
+    }
+    EXPECT_GT(cache.statistics().hits, 0);
+
+    // Without invalidating, the stored pieces still describe the old function
+    offset = 1000.0;
+    cache.evaluate(100.0, value);
+    EXPECT_NEAR(value[0], exact[0], 1e-5);
+
+    cache.invalidate();
+    for (int i = 0; i < 1000; ++i) {
+        cache.evaluate(100.0, value);
+        ASSERT_NEAR(value[0], exact[0] + offset, 1e-5);
+    }
+}
+
+TEST_F(EphemerisCacheTest, Exceptions) {
+    openspace::EphemerisCache cache(
+        3,
+        [](double time, double* result) {
+            if (time < 0.0) {
+                throw ghoul::RuntimeError("No coverage");
+            }
+            orbit(time, result);
+        },
+        1e-6
+    );
+
+    double value[3];
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_THROW(cache.evaluate(-10.0 + i * 0.1, value), ghoul::RuntimeError);
+        EXPECT_NO_THROW(cache.evaluate(1000.0 + i * 0.1, value));
+    }
+}
+
+TEST_F(EphemerisCacheTest, SparseRequests) {
+    int nCalls = 0;
+    openspace::EphemerisCache cache(
+        3,
+        [&nCalls](double time, double* result) {
+            ++nCalls;
+            orbit(time, result);
+        },
+        1e-6
+    );
+
+    // The node itself is updated every frame, which leads to short pieces
+    for (double time = 0.0; time < 1000.0; time += 0.1) {
+        double value[3];
+        cache.evaluate(time, value);
+    }
+    const uint64_t nFits = cache.statistics().fits;
+    EXPECT_GT(nFits, 0);
+
+    // The samples of a long trail fall into different pieces and should not cause any
+    // fits, as they would all be wasted
+    nCalls = 0;
+    constexpr const int NumberSamples = 1000;
+    for (int i = 0; i < NumberSamples; ++i) {
+        double value[3];
+        cache.evaluate(10000.0 + i * 3600.0, value);
+    }
+    EXPECT_EQ(nCalls, NumberSamples);
+    EXPECT_EQ(cache.statistics().fits, nFits);
+}
+
+TEST_F(EphemerisCacheTest, Concurrency) {
+    openspace::EphemerisCache cache(3, orbit, 1e-6);
+
+    std::atomic<int> nErrors = 0;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t) {
+        threads.emplace_back([&cache, &nErrors, t]() {
+            for (int i = 0; i < 200000; ++i) {
+                // Every thread moves through the same range with a different stride
+                const double time = std::fmod(i * (0.1 + 0.05 * t), 20000.0);
+                double cached[3];
+                cache.evaluate(time, cached);
+                double exact[3];
+                orbit(time, exact);
+                for (int c = 0; c < 3; ++c) {
+                    if (std::abs(cached[c] - exact[c]) > 2e-6) {
+                        ++nErrors;
+                    }
+                }
+            }
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+
+    EXPECT_EQ(nErrors, 0);
+    EXPECT_GT(cache.statistics().hits, 0);
+}
+
+TEST_F(EphemerisCacheTest, DISABLED_Benchmark) {
+    using namespace std::chrono;
+
+    // Simulates the cost of a call into SPICE, which is a few microseconds
+    auto expensive = [](double time, double* result) {
+        orbit(time, result);
+        volatile double sink = 0.0;
+        for (int i = 0; i < 2000; ++i) {
+            sink = sink + std::sqrt(static_cast<double>(i));
+        }
+    };
+    openspace::EphemerisCache cache(3, expensive, 1e-6);
+
+    constexpr const int NumberFrames = 100000;
+    double sum = 0.0;
+    auto start = high_resolution_clock::now();
+    for (int i = 0; i < NumberFrames; ++i) {
+        double value[3];
+        expensive(i * 0.5, value);
+        sum += value[0];
+    }
+    const double directMs = duration<double, std::milli>(
+        high_resolution_clock::now() - start
+    ).count();
+
+    start = high_resolution_clock::now();
+    for (int i = 0; i < NumberFrames; ++i) {
+        double value[3];
+        cache.evaluate(i * 0.5, value);
+        sum -= value[0];
+    }
+    const double cachedMs = duration<double, std::milli>(
+        high_resolution_clock::now() - start
+    ).count();
+
+    const openspace::EphemerisCache::Statistics stats = cache.statistics();
+    std::cout << "[ BENCHMARK] " << NumberFrames << " evaluations: direct " << directMs
+              << " ms, cached " << cachedMs << " ms (" << stats.hits << " hits, "
+              << stats.misses << " misses, " << stats.fits << " fits)" << std::endl;
+
+    EXPECT_NEAR(sum, 0.0, 1e-3);
+}
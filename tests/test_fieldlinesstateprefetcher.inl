@@ -0,0 +1,233 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <modules/fieldlinessequence/util/fieldlinesstateprefetcher.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <limits>
+#include <thread>
+
+namespace {
+    constexpr const int NumberOfFiles = 10;
+
+    // Writes an empty version 0 .osfls state whose trigger time is its index, which is
+    // enough to identify which file a loaded state came from
+    std::string writeState(int index) {
+        const std::string path = absPath(
+            "${TEMPORARY}/test_fieldlinesstateprefetcher_" + std::to_string(index) +
+            ".osfls"
+        );
+        std::ofstream file(path, std::ofstream::binary | std::ofstream::trunc);
+        const int version = 0;
+        const double triggerTime = static_cast<double>(index);
+        const int32_t model = 0;
+        const bool isMorphable = false;
+        const uint64_t zero = 0;
+        file.write(reinterpret_cast<const char*>(&version), sizeof(int));
+        file.write(reinterpret_cast<const char*>(&triggerTime), sizeof(double));
+        file.write(reinterpret_cast<const char*>(&model), sizeof(int32_t));
+        file.write(reinterpret_cast<const char*>(&isMorphable), sizeof(bool));
+        // Number of lines, points, extra quantities, and bytes of the quantity names
+        for (int i = 0; i < 4; ++i) {
+            file.write(reinterpret_cast<const char*>(&zero), sizeof(uint64_t));
+        }
+        return path;
+    }
+
+    std::vector<std::string> writeStates() {
+        std::vector<std::string> files;
+        for (int i = 0; i < NumberOfFiles; ++i) {
+            files.push_back(writeState(i));
+        }
+        return files;
+    }
+
+    void removeStates(const std::vector<std::string>& files) {
+        for (const std::string& file : files) {
+            std::filesystem::remove(file);
+        }
+    }
+
+    // Waits until the state at the index has been loaded by the background thread
+    using StatePointer = std::shared_ptr<const openspace::FieldlinesState>;
+
+    StatePointer waitForState(const openspace::FieldlinesStatePrefetcher& prefetcher,
+                              int index)
+    {
+        using namespace std::chrono;
+        const steady_clock::time_point timeout = steady_clock::now() + seconds(10);
+        while (steady_clock::now() < timeout) {
+            StatePointer s = prefetcher.state(index);
+            if (s) {
+                return s;
+            }
+            std::this_thread::sleep_for(milliseconds(1));
+        }
+        return nullptr;
+    }
+
+    // Waits until the state at the index has been evicted from the ring
+    bool waitForEviction(const openspace::FieldlinesStatePrefetcher& prefetcher,
+                         int index)
+    {
+        using namespace std::chrono;
+        const steady_clock::time_point timeout = steady_clock::now() + seconds(10);
+        while (steady_clock::now() < timeout) {
+            if (!prefetcher.state(index)) {
+                return true;
+            }
+            std::this_thread::sleep_for(milliseconds(1));
+        }
+        return false;
+    }
+} // namespace
+
+class FieldlinesStatePrefetcherTest : public testing::Test {};
+
+TEST_F(FieldlinesStatePrefetcherTest, LoadsWindow) {
+    const std::vector<std::string> files = writeStates();
+    {
+        openspace::FieldlinesStatePrefetcher prefetcher(files, 4);
+        ASSERT_EQ(prefetcher.capacity(), 4);
+
+        prefetcher.prefetch(2, 1, 2);
+        for (int i = 2; i <= 4; ++i) {
+            StatePointer s = waitForState(prefetcher, i);
+            ASSERT_NE(s, nullptr) << "State " << i;
+            EXPECT_EQ(s->triggerTime(), static_cast<double>(i));
+        }
+        EXPECT_EQ(prefetcher.state(1), nullptr);
+        EXPECT_EQ(prefetcher.state(5), nullptr);
+        EXPECT_GE(prefetcher.averageLoadTime(), 0.0);
+    }
+    removeStates(files);
+}
+
+TEST_F(FieldlinesStatePrefetcherTest, RefillWhenTimeReverses) {
+    const std::vector<std::string> files = writeStates();
+    {
+        openspace::FieldlinesStatePrefetcher prefetcher(files, 3);
+
+        prefetcher.prefetch(4, 1, 2);
+        StatePointer current = waitForState(prefetcher, 4);
+        ASSERT_NE(current, nullptr);
+        ASSERT_NE(waitForState(prefetcher, 5), nullptr);
+        ASSERT_NE(waitForState(prefetcher, 6), nullptr);
+
+        // Moving backwards from the same state has to replace the states that are now
+        // behind the current one with the states that are ahead of it
+        prefetcher.prefetch(4, -1, 2);
+        for (int i = 2; i <= 3; ++i) {
+            StatePointer s = waitForState(prefetcher, i);
+            ASSERT_NE(s, nullptr) << "State " << i;
+            EXPECT_EQ(s->triggerTime(), static_cast<double>(i));
+        }
+        EXPECT_EQ(prefetcher.state(5), nullptr);
+        EXPECT_EQ(prefetcher.state(6), nullptr);
+
+        // The current state is part of both windows and must not have been reloaded
+        EXPECT_EQ(prefetcher.state(4), current);
+    }
+    removeStates(files);
+}
+
+TEST_F(FieldlinesStatePrefetcherTest, RefillAfterJump) {
+    const std::vector<std::string> files = writeStates();
+    {
+        openspace::FieldlinesStatePrefetcher prefetcher(files, 3);
+
+        prefetcher.prefetch(0, 1, 2);
+        for (int i = 0; i <= 2; ++i) {
+            ASSERT_NE(waitForState(prefetcher, i), nullptr) << "State " << i;
+        }
+
+        // A jump to the end of the sequence only needs the states that exist
+        prefetcher.prefetch(8, 1, 2);
+        for (int i = 8; i <= 9; ++i) {
+            StatePointer s = waitForState(prefetcher, i);
+            ASSERT_NE(s, nullptr) << "State " << i;
+            EXPECT_EQ(s->triggerTime(), static_cast<double>(i));
+        }
+
+        // Jumping backwards past the start of the sequence after a reversal
+        prefetcher.prefetch(1, -1, 2);
+        for (int i = 0; i <= 1; ++i) {
+            ASSERT_NE(waitForState(prefetcher, i), nullptr) << "State " << i;
+        }
+    }
+    removeStates(files);
+}
+
+TEST_F(FieldlinesStatePrefetcherTest, Eviction) {
+    const std::vector<std::string> files = writeStates();
+    {
+        openspace::FieldlinesStatePrefetcher prefetcher(files, 3);
+
+        prefetcher.prefetch(0, 1, 2);
+        StatePointer held = waitForState(prefetcher, 0);
+        ASSERT_NE(held, nullptr);
+        ASSERT_NE(waitForState(prefetcher, 1), nullptr);
+        ASSERT_NE(waitForState(prefetcher, 2), nullptr);
+
+        prefetcher.prefetch(5, 1, 2);
+        for (int i = 5; i <= 7; ++i) {
+            ASSERT_NE(waitForState(prefetcher, i), nullptr) << "State " << i;
+        }
+
+        // All slots were needed for the new window, so every old state was evicted
+        for (int i = 0; i <= 2; ++i) {
+            EXPECT_TRUE(waitForEviction(prefetcher, i)) << "State " << i;
+        }
+
+        // A state that is still in use outlives its slot
+        EXPECT_EQ(held->triggerTime(), 0.0);
+    }
+    removeStates(files);
+}
+
+TEST_F(FieldlinesStatePrefetcherTest, WindowIsClampedToCapacity) {
+    const std::vector<std::string> files = writeStates();
+    {
+        openspace::FieldlinesStatePrefetcher prefetcher(files, 3);
+
+        // A window that is larger than the ring only loads as many states as fit, and
+        // they are never evicted by each other
+        prefetcher.prefetch(0, 1, std::numeric_limits<int>::max());
+        for (int i = 0; i <= 2; ++i) {
+            ASSERT_NE(waitForState(prefetcher, i), nullptr) << "State " << i;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        for (int i = 0; i <= 2; ++i) {
+            EXPECT_NE(prefetcher.state(i), nullptr) << "State " << i;
+        }
+        EXPECT_EQ(prefetcher.state(3), nullptr);
+    }
+    removeStates(files);
+}
@@ -0,0 +1,215 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <modules/space/util/keplercatalog.h>
+#include <openspace/util/workstealingthreadpool.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <chrono>
+#include <fstream>
+#include <random>
+#include <thread>
+
+namespace {
+    constexpr const char* IssLine1 =
+        "1 25544U 98067A   08264.51782528 -.00002182  00000-0 -11606-4 0  2927";
+    constexpr const char* IssLine2 =
+        "2 25544  51.6416 247.4627 0006703 130.5360 325.0288 15.72125391563537";
+
+    openspace::KeplerCatalog randomCatalog(size_t n,
+                  std::vector<openspace::KeplerCatalog::Elements>* allElements = nullptr)
+    {
+        std::mt19937 random(1337);
+        std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+        openspace::KeplerCatalog catalog;
+        for (size_t i = 0; i < n; ++i) {
+            openspace::KeplerCatalog::Elements elements;
+            elements.eccentricity = 0.99 * unit(random);
+            elements.semiMajorAxis = 7000.0 + 40000.0 * unit(random);
+            elements.inclination = 180.0 * unit(random);
+            elements.ascendingNode = 360.0 * unit(random);
+            elements.argumentOfPeriapsis = 360.0 * unit(random);
+            elements.meanAnomalyAtEpoch = 360.0 * unit(random);
+            elements.epoch = 1e8 * unit(random);
+            elements.period = 5000.0 + 80000.0 * unit(random);
+            catalog.add(elements);
+            if (allElements) {
+                allElements->push_back(elements);
+            }
+        }
+        return catalog;
+    }
+} // namespace
+
+class KeplerCatalogTest : public testing::Test {};
+
+TEST_F(KeplerCatalogTest, TwoLineElements) {
+    using Elements = openspace::KeplerCatalog::Elements;
+    const Elements elements = openspace::KeplerCatalog::elementsFromTle(
+        IssLine1,
+        IssLine2
+    );
+
+    EXPECT_DOUBLE_EQ(elements.inclination, 51.6416);
+    EXPECT_DOUBLE_EQ(elements.ascendingNode, 247.4627);
+    EXPECT_DOUBLE_EQ(elements.eccentricity, 0.0006703);
+    EXPECT_DOUBLE_EQ(elements.argumentOfPeriapsis, 130.5360);
+    EXPECT_DOUBLE_EQ(elements.meanAnomalyAtEpoch, 325.0288);
+    EXPECT_NEAR(elements.period, 86400.0 / 15.72125391, 1e-3);
+    EXPECT_NEAR(elements.semiMajorAxis, 6730.9, 0.1);
+
+    EXPECT_THROW(
+        openspace::KeplerCatalog::elementsFromTle(IssLine1, "2 25544  51.6416"),
+        ghoul::RuntimeError
+    );
+}
+
+TEST_F(KeplerCatalogTest, LoadFiles) {
+    const std::string tlePath = absPath("${TEMPORARY}/test_keplercatalog.tle");
+    {
+        std::ofstream file(tlePath);
+        file << "ISS (ZARYA)\n" << IssLine1 << '\n' << IssLine2 << '\n';
+        file << IssLine1 << "\r\n" << IssLine2 << "\r\n";
+    }
+    EXPECT_EQ(openspace::KeplerCatalog::loadTleFile(tlePath).size(), 2);
+
+    const std::string keplerPath = absPath("${TEMPORARY}/test_keplercatalog.txt");
+    {
+        std::ofstream file(keplerPath);
+        file << "# e a i node periapsis M epoch period\n";
+        file << "0.1 7000 10 20 30 40 0 6000\n";
+        file << "\n";
+        file << "1.5 7000 10 20 30 40 0 6000\n";
+    }
+    // The hyperbolic orbit in the last line is ignored
+    EXPECT_EQ(openspace::KeplerCatalog::loadKeplerFile(keplerPath).size(), 1);
+}
+
+TEST_F(KeplerCatalogTest, KeplerEquation) {
+    constexpr const size_t NumberObjects = 10000;
+    constexpr const double Time = 6e8;
+    std::vector<openspace::KeplerCatalog::Elements> elements;
+    const openspace::KeplerCatalog catalog = randomCatalog(NumberObjects, &elements);
+
+    std::vector<float> anomalies(NumberObjects);
+    catalog.eccentricAnomalies(Time, 0, NumberObjects, anomalies.data());
+
+    for (size_t i = 0; i < NumberObjects; ++i) {
+        const openspace::KeplerCatalog::Elements& el = elements[i];
+        const double m = glm::radians(el.meanAnomalyAtEpoch) +
+                         (Time - el.epoch) * glm::two_pi<double>() / el.period;
+
+        // The error of the eccentric anomaly is the residual of Kepler's equation
+        // divided by its derivative
+        const double e = el.eccentricity;
+        const double x = anomalies[i];
+        EXPECT_GE(x, -glm::pi<double>());
+        EXPECT_LE(x, glm::pi<double>());
+        const double residual = std::remainder(
+            x - e * std::sin(x) - m,
+            glm::two_pi<double>()
+        );
+        EXPECT_LT(std::abs(residual) / (1.0 - e * std::cos(x)), 1e-6);
+    }
+}
+
+TEST_F(KeplerCatalogTest, Position) {
+    openspace::KeplerCatalog catalog;
+    openspace::KeplerCatalog::Elements elements;
+    elements.eccentricity = 0.5;
+    elements.semiMajorAxis = 10000.0;
+    elements.period = 10000.0;
+    ASSERT_TRUE(catalog.add(elements));
+
+    // Without any rotation, the periapsis is on the x axis
+    const glm::dvec3 periapsis = catalog.position(0, 0.0);
+    EXPECT_NEAR(periapsis.x, 5e6, 1e-6);
+    EXPECT_NEAR(periapsis.y, 0.0, 1e-6);
+    EXPECT_NEAR(periapsis.z, 0.0, 1e-6);
+
+    const glm::dvec3 apoapsis = catalog.position(0, glm::pi<double>());
+    EXPECT_NEAR(apoapsis.x, -1.5e7, 1e-6);
+
+    elements.eccentricity = 1.0;
+    EXPECT_FALSE(catalog.add(elements));
+    EXPECT_EQ(catalog.size(), 1);
+}
+
+TEST_F(KeplerCatalogTest, ParallelPropagation) {
+    // Splitting the catalog into blocks must not change the result for any object
+    constexpr const size_t NumberObjects = 1000;
+    const openspace::KeplerCatalog catalog = randomCatalog(NumberObjects);
+    std::vector<float> serial(NumberObjects);
+    catalog.eccentricAnomalies(6e8, 0, NumberObjects, serial.data());
+
+    openspace::WorkStealingThreadPool pool(3);
+    std::vector<float> parallel(NumberObjects);
+    pool.parallelFor(NumberObjects, 7, [&](size_t begin, size_t end) {
+        catalog.eccentricAnomalies(6e8, begin, end, parallel.data());
+    });
+    EXPECT_EQ(serial, parallel);
+}
+
+TEST_F(KeplerCatalogTest, DISABLED_PropagationBenchmark) {
+    using namespace std::chrono;
+
+    constexpr const size_t NumberObjects = 100000;
+    constexpr const int NumberFrames = 20;
+    const openspace::KeplerCatalog catalog = randomCatalog(NumberObjects);
+    std::vector<float> serial(NumberObjects);
+    std::vector<float> parallel(NumberObjects);
+
+    auto start = high_resolution_clock::now();
+    for (int i = 0; i < NumberFrames; ++i) {
+        catalog.eccentricAnomalies(6e8 + i, 0, NumberObjects, serial.data());
+    }
+    const double serialMs = duration<double, std::milli>(
+        high_resolution_clock::now() - start
+    ).count() / NumberFrames;
+
+    const unsigned int nThreads = std::thread::hardware_concurrency();
+    openspace::WorkStealingThreadPool pool(std::max(nThreads, 2u) - 1);
+    start = high_resolution_clock::now();
+    for (int i = 0; i < NumberFrames; ++i) {
+        pool.parallelFor(
+            NumberObjects,
+            pool.numThreads() * 4,
+            [&](size_t begin, size_t end) {
+                catalog.eccentricAnomalies(6e8 + i, begin, end, parallel.data());
+            }
+        );
+    }
+    const double parallelMs = duration<double, std::milli>(
+        high_resolution_clock::now() - start
+    ).count() / NumberFrames;
+
+    std::cout << "[ BENCHMARK] " << NumberObjects << " objects per frame: single thread "
+              << serialMs << " ms, " << pool.numThreads() + 1 << " threads "
+              << parallelMs << " ms" << std::endl;
+
+    EXPECT_EQ(serial, parallel);
+}
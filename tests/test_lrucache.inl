@@ -27,6 +27,11 @@
 #define _USE_MATH_DEFINES
 #include <math.h>
 #include <glm/glm.hpp>
+#include <chrono>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <unordered_map>
 
 class LRUCacheTest : public testing::Test {};
 
@@ -95,3 +100,184 @@ TEST_F(LRUCacheTest, StructKey) {
     ASSERT_EQ(lru.get(key1), val2);
     ASSERT_EQ(lru.get(key2), val2);
 }
+
+TEST_F(LRUCacheTest, EvictionOrder) {
+    openspace::globebrowsing::cache::LRUCache<int, int, DefaultHasher> lru(3);
+    lru.put(1, 10);
+    lru.put(2, 20);
+    lru.put(3, 30);
+
+    // Touching 1 makes 2 the least recently used item
+    ASSERT_TRUE(lru.touch(1));
+    ASSERT_FALSE(lru.touch(4));
+
+    std::vector<std::pair<int, int>> popped = lru.putAndFetchPopped(4, 40);
+    ASSERT_EQ(popped.size(), 1);
+    EXPECT_EQ(popped[0].first, 2);
+    EXPECT_EQ(popped[0].second, 20);
+
+    EXPECT_EQ(lru.popLRU().first, 3);
+    EXPECT_EQ(lru.popMRU().first, 4);
+    EXPECT_EQ(lru.popMRU().first, 1);
+    EXPECT_TRUE(lru.isEmpty());
+}
+
+TEST_F(LRUCacheTest, FindAndReuse) {
+    openspace::globebrowsing::cache::LRUCache<int, std::unique_ptr<int>, DefaultHasher>
+        lru(64);
+
+    // Repeatedly fill and drain the cache to exercise the node free list and the
+    // backward-shift deletion of the hash table
+    for (int round = 0; round < 16; ++round) {
+        for (int i = 0; i < 200; ++i) {
+            lru.put(round * 1000 + i, std::make_unique<int>(i));
+        }
+        ASSERT_EQ(lru.size(), 64);
+        for (int i = 0; i < 136; ++i) {
+            EXPECT_EQ(lru.find(round * 1000 + i), nullptr);
+        }
+        for (int i = 136; i < 200; ++i) {
+            std::unique_ptr<int>* v = lru.find(round * 1000 + i);
+            ASSERT_NE(v, nullptr);
+            EXPECT_EQ(**v, i);
+        }
+        lru.clear();
+        EXPECT_TRUE(lru.isEmpty());
+    }
+}
+
+namespace {
+
+// The list-based implementation that was used before the flat LRU cache. Kept here as
+// the reference for the benchmark below
+template <typename KeyType, typename ValueType, typename HasherType>
+class ListLRUCache {
+public:
+    explicit ListLRUCache(size_t size) : _maximumCacheSize(size) {}
+
+    bool exist(const KeyType& key) const {
+        return _itemMap.count(key) > 0;
+    }
+
+    ValueType get(const KeyType& key) {
+        const auto it = _itemMap.find(key);
+        _itemList.splice(_itemList.begin(), _itemList, it->second);
+        return it->second->second;
+    }
+
+    void put(KeyType key, ValueType value) {
+        const auto it = _itemMap.find(key);
+        if (it != _itemMap.end()) {
+            _itemList.erase(it->second);
+            _itemMap.erase(it);
+        }
+        _itemList.emplace_front(key, std::move(value));
+        _itemMap.emplace(std::move(key), _itemList.begin());
+        while (_itemMap.size() > _maximumCacheSize) {
+            _itemMap.erase(_itemList.back().first);
+            _itemList.pop_back();
+        }
+    }
+
+private:
+    using Item = std::pair<KeyType, ValueType>;
+    std::list<Item> _itemList;
+    std::unordered_map<KeyType, typename std::list<Item>::iterator, HasherType> _itemMap;
+    size_t _maximumCacheSize;
+};
+
+struct TileKey {
+    int x;
+    int y;
+    int level;
+};
+
+bool operator==(const TileKey& a, const TileKey& b) {
+    return a.x == b.x && a.y == b.y && a.level == b.level;
+}
+
+struct TileKeyHasher {
+    unsigned long long operator()(const TileKey& k) const {
+        return static_cast<unsigned long long>(k.x) |
+               (static_cast<unsigned long long>(k.y) << 24) |
+               (static_cast<unsigned long long>(k.level) << 48);
+    }
+};
+
+struct TileValue {
+    // Roughly the footprint of a globebrowsing Tile
+    void* texture = nullptr;
+    float metaData[6] = { 0.f };
+    int status = 0;
+};
+
+// Simulates a camera panning over a tiled globe; each frame requests the tiles of a
+// 24x24 window on three levels, moving the window by one tile every fourth frame
+std::vector<TileKey> createTileTrace(int nFrames) {
+    std::vector<TileKey> trace;
+    trace.reserve(static_cast<size_t>(nFrames) * 24 * 24 * 3);
+    for (int frame = 0; frame < nFrames; ++frame) {
+        const int offset = frame / 4;
+        for (int level = 0; level < 3; ++level) {
+            const int base = (offset >> level);
+            for (int y = 0; y < 24; ++y) {
+                for (int x = 0; x < 24; ++x) {
+                    trace.push_back({ base + x, y, 10 + level });
+                }
+            }
+        }
+    }
+    return trace;
+}
+
+} // namespace
+
+TEST_F(LRUCacheTest, DISABLED_BenchmarkTileTrace) {
+    using namespace std::chrono;
+
+    constexpr const size_t Capacity = 1024;
+    const std::vector<TileKey> trace = createTileTrace(400);
+
+    ListLRUCache<TileKey, TileValue, TileKeyHasher> reference(Capacity);
+    size_t referenceMisses = 0;
+    auto start = high_resolution_clock::now();
+    for (const TileKey& k : trace) {
+        if (reference.exist(k)) {
+            TileValue v = reference.get(k);
+            v.status++;
+        }
+        else {
+            ++referenceMisses;
+            reference.put(k, TileValue());
+        }
+    }
+    const double referenceMs = duration_cast<duration<double, std::milli>>(
+        high_resolution_clock::now() - start
+    ).count();
+
+    openspace::globebrowsing::cache::LRUCache<TileKey, TileValue, TileKeyHasher> lru(
+        Capacity
+    );
+    size_t misses = 0;
+    start = high_resolution_clock::now();
+    for (const TileKey& k : trace) {
+        TileValue* v = lru.find(k);
+        if (v) {
+            v->status++;
+        }
+        else {
+            ++misses;
+            lru.put(k, TileValue());
+        }
+    }
+    const double flatMs = duration_cast<duration<double, std::milli>>(
+        high_resolution_clock::now() - start
+    ).count();
+
+    // Both caches implement the same policy, so they have to agree on every miss
+    ASSERT_EQ(misses, referenceMisses);
+
+    std::cout << "[ BENCHMARK] " << trace.size() << " tile requests, " << misses
+              << " misses: list-based " << referenceMs << " ms, flat " << flatMs
+              << " ms" << std::endl;
+}
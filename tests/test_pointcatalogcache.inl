@@ -0,0 +1,110 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/util/pointcatalogcache.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <ghoul/misc/exception.h>
+#include <cstdint>
+#include <fstream>
+
+class PointCatalogCacheTest : public testing::Test {};
+
+TEST_F(PointCatalogCacheTest, RoundTrip) {
+    using namespace openspace;
+
+    const std::vector<float> rows = {
+        1.f, 2.f, 3.f, 4.f,
+        5.f, 6.f, 7.f, 8.f,
+        -1.f, 0.f, 9.f, 100.f
+    };
+    const std::vector<std::pair<glm::vec3, std::string>> labels = {
+        { glm::vec3(1.f, 2.f, 3.f), "Sol" },
+        { glm::vec3(4.f, 5.f, 6.f), "Alpha Centauri" }
+    };
+    PointCatalogCache catalog(rows, { "x", "y", "z", "lum" }, 3, labels);
+    EXPECT_FALSE(catalog.isMapped());
+
+    const std::string path = absPath("${TEMPORARY}/test_pointcatalogcache.cache");
+    catalog.save(path);
+    PointCatalogCache loaded = PointCatalogCache::load(path, 3);
+    EXPECT_TRUE(loaded.isMapped());
+
+    ASSERT_EQ(loaded.nRows(), 3);
+    ASSERT_EQ(loaded.nColumns(), 4);
+    for (size_t row = 0; row < loaded.nRows(); ++row) {
+        for (int column = 0; column < loaded.nColumns(); ++column) {
+            EXPECT_EQ(loaded.value(row, column), rows[row * 4 + column]);
+        }
+    }
+
+    EXPECT_EQ(loaded.column(0).name, "x");
+    EXPECT_EQ(loaded.column(0).minimum, -1.f);
+    EXPECT_EQ(loaded.column(0).maximum, 5.f);
+    EXPECT_EQ(loaded.column(3).name, "lum");
+    EXPECT_EQ(loaded.column(3).maximum, 100.f);
+    EXPECT_EQ(loaded.columnIndex("lum"), 3);
+    EXPECT_EQ(loaded.columnIndex("missing"), -1);
+
+    // The columns are aligned for vectorized access
+    for (int column = 0; column < loaded.nColumns(); ++column) {
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(loaded.columnData(column)) % 64, 0);
+    }
+
+    ASSERT_EQ(loaded.nLabels(), 2);
+    EXPECT_EQ(loaded.labelPosition(1), glm::vec3(4.f, 5.f, 6.f));
+    EXPECT_EQ(loaded.labelText(0), "Sol");
+    EXPECT_EQ(loaded.labelText(1), "Alpha Centauri");
+}
+
+TEST_F(PointCatalogCacheTest, InvalidFiles) {
+    using namespace openspace;
+
+    const std::string path = absPath("${TEMPORARY}/test_pointcatalogcache_invalid.cache");
+    PointCatalogCache({ 1.f, 2.f, 3.f }, { "x", "y", "z" }, 1).save(path);
+
+    // Mismatching content version
+    EXPECT_THROW(PointCatalogCache::load(path, 2), ghoul::RuntimeError);
+
+    // Truncated file
+    {
+        std::ifstream in(path, std::ifstream::binary);
+        std::string content(
+            (std::istreambuf_iterator<char>(in)),
+            std::istreambuf_iterator<char>()
+        );
+        in.close();
+        std::ofstream out(path, std::ofstream::binary);
+        out.write(content.data(), content.size() - 8);
+    }
+    EXPECT_THROW(PointCatalogCache::load(path, 1), ghoul::RuntimeError);
+
+    // Not a cache file at all
+    {
+        std::ofstream out(path, std::ofstream::binary);
+        out << "datavar 0 lum\n1 2 3 4\n";
+    }
+    EXPECT_THROW(PointCatalogCache::load(path, 1), ghoul::RuntimeError);
+}
@@ -0,0 +1,253 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <modules/globebrowsing/globebrowsingmodule.h>
+#include <modules/globebrowsing/src/rawtiledatareader.h>
+#include <modules/globebrowsing/src/tileindex.h>
+#include <openspace/engine/globals.h>
+#include <openspace/engine/moduleengine.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include <gdal_priv.h>
+
+class RawTileDataReaderTest : public testing::Test {
+protected:
+    // The test GeoTIFF is about 100 MB, so it is removed after each test. This happens
+    // after the test body has destroyed the reader that keeps the file open
+    void TearDown() override {
+        if (!_path.empty()) {
+            FileSys.deleteFile(_path);
+        }
+    }
+
+    std::string _path;
+};
+
+namespace {
+    // Creates a three-band GeoTIFF covering the whole globe with a gradient pattern
+    std::string createTestGeoTiff(int width, int height) {
+        GDALAllRegister();
+        const std::string path = absPath("${TEMPORARY}/rawtiledatareadertest.tif");
+
+        GDALDriver* driver = GetGDALDriverManager()->GetDriverByName("GTiff");
+        char** options = nullptr;
+        options = CSLSetNameValue(options, "TILED", "YES");
+        GDALDataset* dataset = driver->Create(
+            path.c_str(),
+            width,
+            height,
+            3,
+            GDT_Byte,
+            options
+        );
+        CSLDestroy(options);
+
+        std::array<double, 6> transform = {
+            -180.0, 360.0 / width, 0.0, 90.0, 0.0, -180.0 / height
+        };
+        dataset->SetGeoTransform(transform.data());
+
+        std::vector<unsigned char> line(width);
+        for (int band = 1; band <= 3; ++band) {
+            GDALRasterBand* raster = dataset->GetRasterBand(band);
+            for (int y = 0; y < height; ++y) {
+                for (int x = 0; x < width; ++x) {
+                    line[x] = static_cast<unsigned char>((x * band + y) % 255);
+                }
+                raster->RasterIO(
+                    GF_Write,
+                    0, y, width, 1,
+                    line.data(), width, 1,
+                    GDT_Byte,
+                    0, 0
+                );
+            }
+        }
+        GDALClose(dataset);
+        return path;
+    }
+
+    // A FNV-1a hash of the image data, so that the tiles of different runs can be
+    // compared without keeping all of them in memory
+    uint64_t checksum(const openspace::globebrowsing::RawTile& tile, size_t nBytes) {
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < nBytes; ++i) {
+            hash ^= static_cast<uint64_t>(tile.imageData[i]);
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+} // namespace
+
+TEST_F(RawTileDataReaderTest, ParallelReadsMatchSerial) {
+    using namespace openspace::globebrowsing;
+
+    if (!openspace::global::moduleEngine.module<openspace::GlobeBrowsingModule>()) {
+        GTEST_SKIP() << "GlobeBrowsing module is not loaded";
+    }
+
+    _path = createTestGeoTiff(1024, 512);
+    const TileTextureInitData initData(
+        256,
+        256,
+        GL_UNSIGNED_BYTE,
+        ghoul::opengl::Texture::Format::RGB,
+        TileTextureInitData::PadTiles::No
+    );
+    RawTileDataReader reader(_path, initData);
+
+    std::vector<TileIndex> tiles;
+    for (int y = 0; y < (1 << 2); ++y) {
+        for (int x = 0; x < (1 << 3); ++x) {
+            tiles.emplace_back(x, y, 2);
+        }
+    }
+
+    std::vector<uint64_t> serialChecksums(tiles.size());
+    for (size_t t = 0; t < tiles.size(); ++t) {
+        RawTile tile = reader.readTileData(tiles[t]);
+        ASSERT_EQ(tile.error, RawTile::ReadError::None);
+        serialChecksums[t] = checksum(tile, initData.totalNumBytes);
+    }
+
+    // Concurrent reads use separate dataset handles and must produce the same tiles
+    std::atomic<size_t> nextTile = 0;
+    std::atomic<int> nErrors = 0;
+    std::atomic<int> nMismatches = 0;
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; ++i) {
+        threads.emplace_back([&]() {
+            for (size_t t = nextTile++; t < tiles.size(); t = nextTile++) {
+                RawTile tile = reader.readTileData(tiles[t]);
+                if (tile.error != RawTile::ReadError::None) {
+                    ++nErrors;
+                }
+                if (checksum(tile, initData.totalNumBytes) != serialChecksums[t]) {
+                    ++nMismatches;
+                }
+            }
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    EXPECT_EQ(nErrors, 0);
+    EXPECT_EQ(nMismatches, 0);
+}
+
+TEST_F(RawTileDataReaderTest, DISABLED_ParallelReadThroughput) {
+    using namespace openspace::globebrowsing;
+    using namespace std::chrono;
+
+    if (!openspace::global::moduleEngine.module<openspace::GlobeBrowsingModule>()) {
+        GTEST_SKIP() << "GlobeBrowsing module is not loaded";
+    }
+
+    _path = createTestGeoTiff(8192, 4096);
+    const TileTextureInitData initData(
+        256,
+        256,
+        GL_UNSIGNED_BYTE,
+        ghoul::opengl::Texture::Format::RGB,
+        TileTextureInitData::PadTiles::No
+    );
+    RawTileDataReader reader(_path, initData);
+
+    // All tiles on level 5 that are covered by the dataset
+    std::vector<TileIndex> tiles;
+    for (int y = 0; y < (1 << 5); ++y) {
+        for (int x = 0; x < (1 << 6); ++x) {
+            tiles.emplace_back(x, y, 5);
+        }
+    }
+
+    // The baseline reads all tiles on this thread, which is what all readers were limited
+    // to when every read had to lock the single dataset of the reader
+    std::vector<uint64_t> serialChecksums(tiles.size());
+    double serialTilesPerSecond = 0.0;
+    {
+        int nErrors = 0;
+        const auto start = high_resolution_clock::now();
+        for (size_t t = 0; t < tiles.size(); ++t) {
+            RawTile tile = reader.readTileData(tiles[t]);
+            if (tile.error != RawTile::ReadError::None) {
+                ++nErrors;
+            }
+            serialChecksums[t] = checksum(tile, initData.totalNumBytes);
+        }
+        const double seconds = duration<double>(high_resolution_clock::now() - start)
+            .count();
+        serialTilesPerSecond = tiles.size() / seconds;
+
+        std::cout << "[ BENCHMARK] serial: " << serialTilesPerSecond << " tiles/s"
+                  << std::endl;
+        EXPECT_EQ(nErrors, 0);
+    }
+
+    const unsigned int maxThreads = std::max(std::thread::hardware_concurrency(), 1u);
+    for (unsigned int nThreads = 1; nThreads <= maxThreads; nThreads *= 2) {
+        std::atomic<size_t> nextTile = 0;
+        std::atomic<int> nErrors = 0;
+        std::atomic<int> nMismatches = 0;
+
+        const auto start = high_resolution_clock::now();
+        std::vector<std::thread> threads;
+        for (unsigned int i = 0; i < nThreads; ++i) {
+            threads.emplace_back([&]() {
+                for (size_t t = nextTile++; t < tiles.size(); t = nextTile++) {
+                    RawTile tile = reader.readTileData(tiles[t]);
+                    if (tile.error != RawTile::ReadError::None) {
+                        ++nErrors;
+                    }
+                    if (checksum(tile, initData.totalNumBytes) != serialChecksums[t]) {
+                        ++nMismatches;
+                    }
+                }
+            });
+        }
+        for (std::thread& t : threads) {
+            t.join();
+        }
+        const double seconds = duration<double>(high_resolution_clock::now() - start)
+            .count();
+
+        const double tilesPerSecond = tiles.size() / seconds;
+
+        std::cout << "[ BENCHMARK] " << nThreads << " threads: " << tilesPerSecond
+                  << " tiles/s, " << tilesPerSecond / serialTilesPerSecond
+                  << "x serial" << std::endl;
+        EXPECT_EQ(nErrors, 0);
+        // Reads on separate dataset handles must produce the same tiles as serial reads
+        EXPECT_EQ(nMismatches, 0);
+    }
+}
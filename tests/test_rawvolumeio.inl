@@ -28,13 +28,35 @@
 #include <openspace/util/time.h>
 
 #include <modules/volume/rawvolume.h>
+#include <modules/volume/rawvolumemetadata.h>
 #include <modules/volume/rawvolumereader.h>
+#include <modules/volume/rawvolumestreamer.h>
 #include <modules/volume/rawvolumewriter.h>
+#include <openspace/util/histogram.h>
 
 #include <ghoul/filesystem/filesystem.h>
 #include <ghoul/glm.h>
-
-class RawVolumeIoTest : public testing::Test {};
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+class RawVolumeIoTest : public testing::Test {
+protected:
+    // Files that are written to the temporary folder and removed after each test
+    std::string temporaryFile(const std::string& name) {
+        _files.push_back(absPath("${TEMPORARY}/" + name));
+        return _files.back();
+    }
+
+    void TearDown() override {
+        for (const std::string& file : _files) {
+            FileSys.deleteFile(file);
+        }
+    }
+
+    std::vector<std::string> _files;
+};
 
 TEST_F(RawVolumeIoTest, TinyInputOutput) {
     using namespace openspace::volume;
@@ -85,3 +107,118 @@ TEST_F(RawVolumeIoTest, BasicInputOutput) {
         ASSERT_EQ(v, value(x));
     });
 }
+
+TEST_F(RawVolumeIoTest, MetadataHistogram) {
+    using namespace openspace::volume;
+
+    ghoul::Dictionary dictionary;
+    dictionary.setValue<glm::vec3>("Dimensions", glm::vec3(2.f, 2.f, 2.f));
+    dictionary.setValue<double>("MinValue", -1.0);
+    dictionary.setValue<double>("MaxValue", 1.0);
+    // The last count can't be represented exactly by a float
+    dictionary.setValue<std::string>("Histogram", "3 0 5 16777217");
+
+    RawVolumeMetadata metadata = RawVolumeMetadata::createFromDictionary(dictionary);
+    ASSERT_TRUE(metadata.hasHistogram);
+    EXPECT_EQ(metadata.histogram, std::vector<size_t>({ 3, 0, 5, 16777217 }));
+    EXPECT_EQ(metadata.gridType, VolumeGridType::Cartesian);
+
+    RawVolumeMetadata stored = RawVolumeMetadata::createFromDictionary(
+        metadata.dictionary()
+    );
+    EXPECT_EQ(stored.histogram, metadata.histogram);
+}
+
+TEST_F(RawVolumeIoTest, Streamer) {
+    using namespace openspace::volume;
+
+    const glm::uvec3 dims{ 16, 16, 16 };
+    std::vector<RawVolumeStreamer::Source> sources;
+    for (int i = 0; i < 3; ++i) {
+        RawVolume<float> vol(dims);
+        for (size_t j = 0; j < vol.nCells(); ++j) {
+            vol.set(j, static_cast<float>(j % 1000) - 100.f + i);
+        }
+        std::string path = temporaryFile(
+            "streamervolume" + std::to_string(i) + ".rawvolume"
+        );
+        RawVolumeWriter<float> writer(path);
+        writer.write(vol);
+
+        RawVolumeMetadata metadata = RawVolumeMetadata();
+        metadata.dimensions = dims;
+        metadata.minValue = 0.f;
+        metadata.maxValue = 800.f;
+        sources.push_back({ path, metadata });
+    }
+
+    // Only two of the volumes fit into the budget
+    const size_t volumeSize = 16 * 16 * 16 * sizeof(float);
+    RawVolumeStreamer streamer(sources, 2 * volumeSize);
+
+    auto waitFor = [&streamer](int index) {
+        for (int i = 0; i < 1000 && !streamer.volume(index); ++i) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+        return streamer.volume(index);
+    };
+
+    streamer.request({ 0, 1, 2 });
+    std::shared_ptr<const RawVolumeStreamer::Volume> volume = waitFor(0);
+    ASSERT_NE(volume, nullptr);
+    ASSERT_NE(waitFor(1), nullptr);
+    EXPECT_EQ(streamer.volume(2), nullptr);
+    EXPECT_EQ(streamer.memoryUsage(), 2 * volumeSize);
+
+    // The values are normalized and histogrammed in the same way as they were when all
+    // timesteps were loaded up front
+    RawVolumeReader<float> reader(sources[0].path, dims);
+    std::unique_ptr<RawVolume<float>> reference = reader.read();
+    openspace::Histogram histogram(0.f, 1.f, RawVolumeStreamer::NumberHistogramBins);
+    for (size_t i = 0; i < reference->nCells(); ++i) {
+        const float value = glm::clamp((reference->get(i) - 0.f) / 800.f, 0.f, 1.f);
+        ASSERT_EQ(volume->rawVolume->get(i), value);
+        histogram.add(value);
+    }
+    ASSERT_TRUE(volume->isHistogramNew);
+    ASSERT_EQ(volume->histogram.size(), RawVolumeStreamer::NumberHistogramBins);
+    for (int i = 0; i < RawVolumeStreamer::NumberHistogramBins; ++i) {
+        EXPECT_EQ(static_cast<float>(volume->histogram[i]), histogram.sample(i));
+    }
+
+    // Requesting the third volume evicts one of the others to stay within the budget
+    streamer.request({ 2 });
+    ASSERT_NE(waitFor(2), nullptr);
+    EXPECT_EQ(streamer.memoryUsage(), 2 * volumeSize);
+    EXPECT_NE(streamer.volume(0) == nullptr, streamer.volume(1) == nullptr);
+}
+
+TEST_F(RawVolumeIoTest, StreamerDestroyedWhileLoading) {
+    using namespace openspace::volume;
+
+    // Large enough that the streamer is destroyed while the load is still running
+    const glm::uvec3 dims{ 128, 128, 128 };
+    RawVolume<float> vol(dims);
+    for (size_t j = 0; j < vol.nCells(); ++j) {
+        vol.set(j, static_cast<float>(j % 1000));
+    }
+    const std::string path = temporaryFile("streamervolumelarge.rawvolume");
+    RawVolumeWriter<float> writer(path);
+    writer.write(vol);
+
+    RawVolumeMetadata metadata = RawVolumeMetadata();
+    metadata.dimensions = dims;
+    metadata.minValue = 0.f;
+    metadata.maxValue = 1000.f;
+
+    for (int i = 0; i < 10; ++i) {
+        auto streamer = std::make_unique<RawVolumeStreamer>(
+            std::vector<RawVolumeStreamer::Source>{ { path, metadata } },
+            vol.nCells() * sizeof(float)
+        );
+        streamer->request({ 0 });
+        EXPECT_GT(streamer->memoryUsage(), 0);
+        // The destructor has to wait for the load that is running on the shared pool
+        streamer = nullptr;
+    }
+}
@@ -0,0 +1,462 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/scene/scenegraphnode.h>
+#include <openspace/rendering/renderable.h>
+#include <openspace/scene/scene.h>
+#include <openspace/scene/sceneinitializer.h>
+#include <openspace/util/time.h>
+#include <openspace/util/updatestructures.h>
+#include <ghoul/misc/dictionary.h>
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+    // Records when and where it was updated and which world position it received
+    class RecordingRenderable : public openspace::Renderable {
+    public:
+        RecordingRenderable(std::atomic<int>& clock, bool isGLBound)
+            : openspace::Renderable(ghoul::Dictionary())
+            , _clock(clock)
+            , _isGLBound(isGLBound)
+        {}
+
+        bool isReady() const override { return true; }
+        bool isUpdateGLBound() const override { return _isGLBound; }
+
+        void update(const openspace::UpdateData& data) override {
+            start = _clock++;
+            thread = std::this_thread::get_id();
+            position = data.modelTransform.translation;
+            // Give the other tasks a chance to overtake this one if the ordering is
+            // broken
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+            finish = _clock++;
+        }
+
+        int start = -1;
+        int finish = -1;
+        std::thread::id thread;
+        glm::dvec3 position = glm::dvec3(0.0);
+
+    private:
+        std::atomic<int>& _clock;
+        const bool _isGLBound;
+    };
+} // namespace
+
+class SceneGraphNodeTest : public testing::Test {
+protected:
+    // Creates a synthetic scene consisting of nSubtrees chains that are nDepth nodes
+    // deep and that are all attached to the returned root node. The nodes are returned
+    // in topological order
+    std::vector<openspace::SceneGraphNode*> createScene(int nSubtrees, int nDepth) {
+        using namespace openspace;
+
+        std::vector<SceneGraphNode*> nodes;
+        _root = std::make_unique<SceneGraphNode>();
+        _root->initialize();
+        nodes.push_back(_root.get());
+
+        for (int i = 0; i < nSubtrees; ++i) {
+            SceneGraphNode* parent = _root.get();
+            for (int j = 0; j < nDepth; ++j) {
+                const double d = static_cast<double>(i * nDepth + j);
+                ghoul::Dictionary translation = {
+                    { "Type", std::string("StaticTranslation") },
+                    { "Position", glm::dvec3(d, 2.0 * d, -d) }
+                };
+                ghoul::Dictionary rotation = {
+                    { "Type", std::string("StaticRotation") },
+                    { "Rotation", glm::dvec3(0.01 * d, 0.0, 0.02 * d) }
+                };
+                ghoul::Dictionary scale = {
+                    { "Type", std::string("StaticScale") },
+                    { "Scale", 1.0 + 0.001 * (j % 3) }
+                };
+                ghoul::Dictionary transform = {
+                    { "Translation", translation },
+                    { "Rotation", rotation },
+                    { "Scale", scale }
+                };
+                ghoul::Dictionary dictionary = {
+                    {
+                        "Identifier",
+                        "Node_" + std::to_string(i) + "_" + std::to_string(j)
+                    },
+                    { "Transform", transform }
+                };
+
+                std::unique_ptr<SceneGraphNode> node =
+                    SceneGraphNode::createFromDictionary(dictionary);
+                node->initialize();
+                SceneGraphNode* n = node.get();
+                parent->attachChild(std::move(node));
+                nodes.push_back(n);
+                parent = n;
+            }
+        }
+        return nodes;
+    }
+
+    // Creates a node with a static transform that is not attached to any parent
+    static std::unique_ptr<openspace::SceneGraphNode> createNode(std::string identifier,
+                                                                 glm::dvec3 position)
+    {
+        ghoul::Dictionary translation = {
+            { "Type", std::string("StaticTranslation") },
+            { "Position", position }
+        };
+        ghoul::Dictionary rotation = {
+            { "Type", std::string("StaticRotation") },
+            { "Rotation", glm::dvec3(0.0) }
+        };
+        ghoul::Dictionary scale = {
+            { "Type", std::string("StaticScale") },
+            { "Scale", 1.0 }
+        };
+        ghoul::Dictionary transform = {
+            { "Translation", translation },
+            { "Rotation", rotation },
+            { "Scale", scale }
+        };
+        ghoul::Dictionary dictionary = {
+            { "Identifier", identifier },
+            { "Transform", transform }
+        };
+        return openspace::SceneGraphNode::createFromDictionary(dictionary);
+    }
+
+    // This is the recursive computation that was used before the transform propagation
+    // was introduced; it serves as a reference for the correctness and the benchmark
+    static glm::dvec3 referenceWorldPosition(const openspace::SceneGraphNode* node) {
+        if (node->parent()) {
+            const openspace::SceneGraphNode* p = node->parent();
+            return referenceWorldPosition(p) +
+                   referenceWorldRotation(p) * referenceWorldScale(p) * node->position();
+        }
+        return node->position();
+    }
+
+    static glm::dmat3 referenceWorldRotation(const openspace::SceneGraphNode* node) {
+        if (node->parent()) {
+            return referenceWorldRotation(node->parent()) * node->rotationMatrix();
+        }
+        return node->rotationMatrix();
+    }
+
+    static double referenceWorldScale(const openspace::SceneGraphNode* node) {
+        if (node->parent()) {
+            return referenceWorldScale(node->parent()) * node->scale();
+        }
+        return node->scale();
+    }
+
+    std::unique_ptr<openspace::SceneGraphNode> _root;
+};
+
+TEST_F(SceneGraphNodeTest, WorldTransformPropagation) {
+    std::vector<openspace::SceneGraphNode*> nodes = createScene(4, 8);
+
+    const openspace::UpdateData data = {
+        openspace::TransformData{ glm::dvec3(0.0), glm::dmat3(1.0), 1.0 },
+        openspace::Time(0.0),
+        openspace::Time(0.0),
+        false
+    };
+    for (openspace::SceneGraphNode* node : nodes) {
+        node->update(data);
+    }
+
+    for (const openspace::SceneGraphNode* node : nodes) {
+        const glm::dvec3 expected = referenceWorldPosition(node);
+        EXPECT_NEAR(glm::distance(node->worldPosition(), expected), 0.0, 1e-6);
+
+        const glm::dmat4 identity =
+            node->modelTransform() * node->inverseModelTransform();
+        for (int c = 0; c < 4; ++c) {
+            for (int r = 0; r < 4; ++r) {
+                EXPECT_NEAR(identity[c][r], c == r ? 1.0 : 0.0, 1e-9);
+            }
+        }
+    }
+}
+
+TEST_F(SceneGraphNodeTest, ParentChangeUpdatesDescendants) {
+    using namespace openspace;
+
+    constexpr const int NumberChains = 2;
+    constexpr const int Depth = 5;
+    std::vector<SceneGraphNode*> nodes = createScene(NumberChains, Depth);
+    // The nodes of chain i at depth j, as createScene returns them in topological order
+    auto node = [&nodes](int i, int j) { return nodes[1 + i * Depth + j]; };
+
+    const UpdateData data = {
+        TransformData{ glm::dvec3(0.0), glm::dmat3(1.0), 1.0 },
+        Time(0.0),
+        Time(0.0),
+        false
+    };
+    auto updateAll = [&]() {
+        for (SceneGraphNode* n : nodes) {
+            n->update(data);
+        }
+    };
+    auto worldPositions = [&]() {
+        std::vector<glm::dvec3> positions;
+        for (const SceneGraphNode* n : nodes) {
+            positions.push_back(n->worldPosition());
+        }
+        return positions;
+    };
+
+    updateAll();
+    const std::vector<glm::dvec3> before = worldPositions();
+
+    // Without any change, another frame keeps the cached transformations
+    updateAll();
+    EXPECT_EQ(worldPositions(), before);
+
+    // Changing the translation, rotation, and scale of the second node in the first
+    // chain has to move all of its descendants, but neither the node above it nor the
+    // other chain
+    SceneGraphNode* changed = node(0, 1);
+    changed->property("Translation.Position")->set(glm::dvec3(10.0, -20.0, 30.0));
+    changed->property("Rotation.Rotation")->set(
+        glm::dmat3(0.0, 1.0, 0.0, -1.0, 0.0, 0.0, 0.0, 0.0, 1.0)
+    );
+    changed->property("Scale.Scale")->set(2.f);
+    updateAll();
+
+    for (int i = 0; i < NumberChains; ++i) {
+        for (int j = 0; j < Depth; ++j) {
+            const SceneGraphNode* n = node(i, j);
+            const size_t index = 1 + i * Depth + j;
+
+            const glm::dvec3 expected = referenceWorldPosition(n);
+            EXPECT_NEAR(glm::distance(n->worldPosition(), expected), 0.0, 1e-9)
+                << "Node " << i << " " << j;
+
+            // The model transform is cached together with the world position
+            const glm::dvec3 modelPosition = glm::dvec3(n->modelTransform()[3]);
+            EXPECT_NEAR(glm::distance(modelPosition, expected), 0.0, 1e-9)
+                << "Node " << i << " " << j;
+
+            if (i == 0 && j >= 1) {
+                EXPECT_GT(glm::distance(n->worldPosition(), before[index]), 1.0)
+                    << "Node " << i << " " << j << " did not move";
+            }
+            else {
+                EXPECT_EQ(n->worldPosition(), before[index])
+                    << "Node " << i << " " << j << " moved";
+            }
+        }
+    }
+
+    // The same holds for a change that is several levels above the deepest node
+    const std::vector<glm::dvec3> afterChange = worldPositions();
+    node(0, 0)->property("Translation.Position")->set(glm::dvec3(-5.0, 0.0, 5.0));
+    updateAll();
+    for (int j = 0; j < Depth; ++j) {
+        const SceneGraphNode* n = node(0, j);
+        EXPECT_NEAR(
+            glm::distance(n->worldPosition(), referenceWorldPosition(n)),
+            0.0,
+            1e-9
+        ) << "Node 0 " << j;
+        EXPECT_NE(n->worldPosition(), afterChange[1 + j]) << "Node 0 " << j;
+    }
+
+    // Moving a subtree to a different parent changes its world transformations as well
+    node(0, 3)->setParent(*node(1, 4));
+    updateAll();
+    for (int j = 3; j < Depth; ++j) {
+        const SceneGraphNode* n = node(0, j);
+        EXPECT_EQ(n->parent() == node(1, 4), j == 3);
+        EXPECT_NEAR(
+            glm::distance(n->worldPosition(), referenceWorldPosition(n)),
+            0.0,
+            1e-9
+        ) << "Node 0 " << j;
+    }
+}
+
+TEST_F(SceneGraphNodeTest, DISABLED_WorldTransformPropagationBenchmark) {
+    using namespace std::chrono;
+
+    // 100 chains of 100 nodes each result in a 10k node scene that is 100 levels deep
+    std::vector<openspace::SceneGraphNode*> nodes = createScene(100, 100);
+
+    const openspace::UpdateData data = {
+        openspace::TransformData{ glm::dvec3(0.0), glm::dmat3(1.0), 1.0 },
+        openspace::Time(0.0),
+        openspace::Time(0.0),
+        false
+    };
+
+    constexpr const int NumberFrames = 10;
+
+    auto start = high_resolution_clock::now();
+    glm::dvec3 sum = glm::dvec3(0.0);
+    for (int frame = 0; frame < NumberFrames; ++frame) {
+        for (const openspace::SceneGraphNode* node : nodes) {
+            sum += referenceWorldPosition(node);
+            glm::dmat4 model = glm::translate(
+                glm::dmat4(1.0),
+                referenceWorldPosition(node)
+            );
+            model *= glm::dmat4(referenceWorldRotation(node));
+            model = glm::scale(model, glm::dvec3(referenceWorldScale(node)));
+            sum += glm::dvec3(glm::inverse(model)[3]);
+        }
+    }
+    const double recursiveMs = duration<double, std::milli>(
+        high_resolution_clock::now() - start
+    ).count() / NumberFrames;
+
+    start = high_resolution_clock::now();
+    for (openspace::SceneGraphNode* node : nodes) {
+        node->update(data);
+    }
+    const double firstFrameMs = duration<double, std::milli>(
+        high_resolution_clock::now() - start
+    ).count();
+
+    start = high_resolution_clock::now();
+    for (int frame = 0; frame < NumberFrames; ++frame) {
+        for (openspace::SceneGraphNode* node : nodes) {
+            node->update(data);
+        }
+    }
+    const double staticFrameMs = duration<double, std::milli>(
+        high_resolution_clock::now() - start
+    ).count() / NumberFrames;
+
+    std::cout << "[ BENCHMARK] " << nodes.size() << " nodes: recursive " << recursiveMs
+              << " ms/frame, propagated (dirty) " << firstFrameMs
+              << " ms/frame, propagated (static) " << staticFrameMs << " ms/frame"
+              << " (" << sum.x << ")" << std::endl;
+
+    EXPECT_NEAR(
+        glm::distance(
+            nodes.back()->worldPosition(),
+            referenceWorldPosition(nodes.back())
+        ),
+        0.0,
+        1e-3
+    );
+}
+
+TEST_F(SceneGraphNodeTest, ParallelUpdateOrder) {
+    using namespace openspace;
+
+    constexpr const int NumberChains = 4;
+    constexpr const int Depth = 6;
+
+    Scene scene(std::make_unique<SingleThreadedSceneInitializer>());
+    scene.property("ParallelUpdate")->set(true);
+    scene.root()->initialize();
+
+    // The scene consists of chains of nodes below the root. Every node depends on the
+    // node at the same depth in the next chain, and every third renderable has to be
+    // updated on the main thread
+    std::atomic<int> clock = 0;
+    std::vector<std::vector<SceneGraphNode*>> chains(NumberChains);
+    std::vector<std::vector<RecordingRenderable*>> renderables(NumberChains);
+    for (int i = 0; i < NumberChains; ++i) {
+        SceneGraphNode* parent = scene.root();
+        for (int j = 0; j < Depth; ++j) {
+            const double d = static_cast<double>(i * Depth + j + 1);
+            std::unique_ptr<SceneGraphNode> node = createNode(
+                "Node_" + std::to_string(i) + "_" + std::to_string(j),
+                glm::dvec3(d, -d, 0.5 * d)
+            );
+            auto renderable = std::make_unique<RecordingRenderable>(
+                clock,
+                (i * Depth + j) % 3 == 0
+            );
+            renderables[i].push_back(renderable.get());
+            node->setRenderable(std::move(renderable));
+            node->initialize();
+            node->initializeGL();
+
+            SceneGraphNode* n = node.get();
+            parent->attachChild(std::move(node));
+            chains[i].push_back(n);
+            parent = n;
+        }
+    }
+    for (int i = 0; i < NumberChains - 1; ++i) {
+        for (int j = 0; j < Depth; ++j) {
+            chains[i][j]->addDependency(*chains[i + 1][j]);
+        }
+    }
+
+    const openspace::UpdateData data = {
+        openspace::TransformData{ glm::dvec3(0.0), glm::dmat3(1.0), 1.0 },
+        openspace::Time(0.0),
+        openspace::Time(0.0),
+        false
+    };
+
+    for (int frame = 0; frame < 5; ++frame) {
+        clock = 0;
+        scene.update(data);
+
+        for (int i = 0; i < NumberChains; ++i) {
+            for (int j = 0; j < Depth; ++j) {
+                const RecordingRenderable* r = renderables[i][j];
+                ASSERT_GE(r->start, 0) << "Node " << i << " " << j << " not updated";
+                ASSERT_GT(r->finish, r->start);
+
+                // The transformation of the parent was finished before this node was
+                // updated, so the world position is already complete
+                const glm::dvec3 expected = referenceWorldPosition(chains[i][j]);
+                EXPECT_NEAR(glm::distance(r->position, expected), 0.0, 1e-9);
+
+                // Dependencies are fully updated, including their renderable
+                if (i < NumberChains - 1) {
+                    EXPECT_GT(r->start, renderables[i + 1][j]->finish);
+                }
+
+                if (r->isUpdateGLBound()) {
+                    EXPECT_EQ(r->thread, std::this_thread::get_id());
+                }
+            }
+        }
+    }
+
+    for (std::vector<SceneGraphNode*>& chain : chains) {
+        for (SceneGraphNode* node : chain) {
+            node->clearDependencies();
+        }
+    }
+}
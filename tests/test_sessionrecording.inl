@@ -0,0 +1,284 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/interaction/sessionrecording.h>
+
+#include <openspace/engine/globals.h>
+#include <openspace/engine/windowdelegate.h>
+#include <openspace/interaction/navigationhandler.h>
+#include <openspace/scene/scene.h>
+#include <openspace/scene/sceneinitializer.h>
+#include <openspace/scripting/scriptscheduler.h>
+#include <openspace/util/camera.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+
+class SessionRecordingTest : public testing::Test {
+protected:
+    void SetUp() override {
+        using namespace openspace;
+
+        // Camera keyframes are applied to the camera of the navigation handler. Their
+        // focus node does not exist, so the camera is never moved
+        _scene = std::make_unique<Scene>(
+            std::make_unique<SingleThreadedSceneInitializer>()
+        );
+        _camera.setParent(_scene->root());
+        _previousCamera = global::navigationHandler.camera();
+        global::navigationHandler.setCamera(&_camera);
+
+        _previousApplicationTime = global::windowDelegate.applicationTime;
+        ApplicationTime = 0.0;
+        global::windowDelegate.applicationTime = []() { return ApplicationTime; };
+    }
+
+    void TearDown() override {
+        using namespace openspace;
+
+        global::navigationHandler.stopPlayback();
+        global::scriptScheduler.stopPlayback();
+        global::navigationHandler.setCamera(_previousCamera);
+        global::windowDelegate.applicationTime = _previousApplicationTime;
+    }
+
+    // Writes an ASCII recording with keyframes whose recorded timestamps start at 10 s
+    // and are 0.25 s apart. Every fourth keyframe is a script, the rest are camera
+    // keyframes, of which some are replaced by time keyframes if requested
+    static void writeAsciiRecording(const std::string& path, int nKeyframes,
+                                    bool hasTimeKeyframes)
+    {
+        std::ofstream file(path);
+        file << "OpenSpace_record/playback00.85A\n";
+        for (int i = 0; i < nKeyframes; ++i) {
+            const double timeRec = 10.0 + 0.25 * i;
+            std::ostringstream times;
+            times << std::fixed << std::setprecision(3)
+                  << 1000.0 + timeRec << ' ' << timeRec << ' ' << 5e8 + timeRec;
+
+            if (i % 4 == 3) {
+                file << "script " << times.str() << " 1 openspace.printInfo('" << i
+                     << "')\n";
+            }
+            else if (hasTimeKeyframes && i % 8 == 1) {
+                file << "time " << times.str() << " 1.000 R -\n";
+            }
+            else {
+                file << "camera " << times.str() << " 0.0 0.0 " << 1e7 + i
+                     << " 0.0 0.0 0.0 1.0 1.0 - NoSuchNode\n";
+            }
+        }
+    }
+
+    static std::vector<char> readFile(const std::string& path) {
+        std::ifstream file(path, std::ios::binary);
+        return std::vector<char>(
+            std::istreambuf_iterator<char>(file),
+            std::istreambuf_iterator<char>()
+        );
+    }
+
+    static double ApplicationTime;
+
+    std::unique_ptr<openspace::Scene> _scene;
+    openspace::Camera _camera;
+    openspace::Camera* _previousCamera = nullptr;
+    double (*_previousApplicationTime)() = nullptr;
+};
+
+double SessionRecordingTest::ApplicationTime = 0.0;
+
+TEST_F(SessionRecordingTest, ConvertAsciiAndBinaryToIndexed) {
+    using namespace openspace::interaction;
+
+    const std::string asciiPath = absPath("${TESTDIR}/recording_ascii.osrec");
+    const std::string indexedPath = absPath("${TESTDIR}/recording_indexed.osrec");
+    const std::string binaryPath = absPath("${TESTDIR}/recording_binary.osrec");
+    const std::string fromBinaryPath = absPath("${TESTDIR}/recording_frombinary.osrec");
+    const std::string fromIndexedPath = absPath("${TESTDIR}/recording_fromindexed.osrec");
+
+    constexpr const int NKeyframes = 200;
+    writeAsciiRecording(asciiPath, NKeyframes, true);
+
+    SessionRecording recording;
+    ASSERT_TRUE(recording.convertToIndexedFormat(asciiPath, indexedPath));
+    const std::vector<char> indexed = readFile(indexedPath);
+
+    // The footer consists of the offset of the index, the number of index entries and
+    // a tag. Every 64th keyframe is listed in the index
+    constexpr const size_t TagLength = 8;
+    ASSERT_GT(indexed.size(), 2 * sizeof(uint64_t) + TagLength);
+    EXPECT_EQ(std::string(indexed.end() - TagLength, indexed.end()), "OSRECIDX");
+    uint64_t indexOffset = 0;
+    uint64_t nEntries = 0;
+    std::memcpy(
+        &indexOffset,
+        indexed.data() + indexed.size() - TagLength - 2 * sizeof(uint64_t),
+        sizeof(uint64_t)
+    );
+    std::memcpy(
+        &nEntries,
+        indexed.data() + indexed.size() - TagLength - sizeof(uint64_t),
+        sizeof(uint64_t)
+    );
+    EXPECT_EQ(nEntries, (NKeyframes + 63) / 64);
+    ASSERT_LT(indexOffset, indexed.size());
+
+    // Without the index and with the legacy version, the file is a binary recording in
+    // the format that was used before the index was introduced
+    std::vector<char> binary(indexed.begin(), indexed.begin() + indexOffset);
+    const std::string title = "OpenSpace_record/playback";
+    ASSERT_EQ(std::string(binary.begin(), binary.begin() + title.size()), title);
+    std::string legacyVersion = "00.85";
+    std::copy(legacyVersion.begin(), legacyVersion.end(), binary.begin() + title.size());
+    {
+        std::ofstream file(binaryPath, std::ios::binary);
+        file.write(binary.data(), binary.size());
+    }
+
+    ASSERT_TRUE(recording.convertToIndexedFormat(binaryPath, fromBinaryPath));
+    EXPECT_EQ(readFile(fromBinaryPath), indexed);
+
+    ASSERT_TRUE(recording.convertToIndexedFormat(indexedPath, fromIndexedPath));
+    EXPECT_EQ(readFile(fromIndexedPath), indexed);
+
+    for (const std::string& path :
+         { asciiPath, indexedPath, binaryPath, fromBinaryPath, fromIndexedPath })
+    {
+        FileSys.deleteFile(path);
+    }
+}
+
+TEST_F(SessionRecordingTest, Seek) {
+    using namespace openspace::interaction;
+
+    const std::string asciiPath = absPath("${TESTDIR}/recording_seek_ascii.osrec");
+    const std::string indexedPath = absPath("${TESTDIR}/recording_seek_indexed.osrec");
+
+    constexpr const int NKeyframes = 2000;
+    const double lastTimestamp = 10.0 + 0.25 * (NKeyframes - 1);
+    writeAsciiRecording(asciiPath, NKeyframes, false);
+
+    {
+        SessionRecording recording;
+        ASSERT_TRUE(recording.convertToIndexedFormat(asciiPath, indexedPath));
+    }
+
+    for (const std::string& path : { asciiPath, indexedPath }) {
+        SessionRecording recording;
+        ASSERT_TRUE(recording.startPlayback(
+            path,
+            KeyframeTimeRef::Relative_recordedStart,
+            false
+        ));
+        const bool isIndexed = (path == indexedPath);
+
+        // Before the first keyframe
+        ASSERT_TRUE(recording.seekPlayback(5.0));
+        EXPECT_TRUE(recording.isPlayingBack());
+        EXPECT_EQ(recording.nextKeyframeTimestamp(), 10.0);
+
+        // Between keyframes
+        ASSERT_TRUE(recording.seekPlayback(100.1));
+        EXPECT_TRUE(recording.isPlayingBack());
+        EXPECT_EQ(recording.nextKeyframeTimestamp(), 100.25);
+        if (isIndexed) {
+            // Only the index blocks around the requested time are read
+            EXPECT_LE(recording.nKeyframesInMemory(), 3 * 64u);
+        }
+        else {
+            EXPECT_EQ(recording.nKeyframesInMemory(), static_cast<size_t>(NKeyframes));
+        }
+
+        // Backwards, onto a keyframe
+        ASSERT_TRUE(recording.seekPlayback(20.0));
+        EXPECT_EQ(recording.nextKeyframeTimestamp(), 20.25);
+
+        // Last keyframe
+        ASSERT_TRUE(recording.seekPlayback(lastTimestamp - 0.1));
+        EXPECT_TRUE(recording.isPlayingBack());
+        EXPECT_EQ(recording.nextKeyframeTimestamp(), lastTimestamp);
+
+        // After the last keyframe the playback is stopped
+        ASSERT_TRUE(recording.seekPlayback(lastTimestamp + 10.0));
+        EXPECT_FALSE(recording.isPlayingBack());
+        EXPECT_FALSE(recording.seekPlayback(20.0));
+
+        recording.preSynchronization();
+        EXPECT_EQ(recording.nKeyframesInMemory(), 0u);
+    }
+
+    FileSys.deleteFile(asciiPath);
+    FileSys.deleteFile(indexedPath);
+}
+
+TEST_F(SessionRecordingTest, StreamingPlayback) {
+    using namespace openspace::interaction;
+
+    const std::string asciiPath = absPath("${TESTDIR}/recording_stream_ascii.osrec");
+    const std::string indexedPath = absPath("${TESTDIR}/recording_stream_indexed.osrec");
+
+    constexpr const int NKeyframes = 2000;
+    const double lastTimestamp = 10.0 + 0.25 * (NKeyframes - 1);
+    writeAsciiRecording(asciiPath, NKeyframes, false);
+
+    SessionRecording recording;
+    ASSERT_TRUE(recording.convertToIndexedFormat(asciiPath, indexedPath));
+    ASSERT_TRUE(recording.startPlayback(
+        indexedPath,
+        KeyframeTimeRef::Relative_recordedStart,
+        false
+    ));
+
+    // The playback advances by 0.1 s per frame, so every keyframe is reached
+    size_t maxKeyframesInMemory = 0;
+    double previousTimestamp = 0.0;
+    for (int frame = 0; frame < 10000 && recording.isPlayingBack(); ++frame) {
+        ApplicationTime = 0.1 * frame;
+        recording.preSynchronization();
+
+        maxKeyframesInMemory = std::max(
+            maxKeyframesInMemory,
+            recording.nKeyframesInMemory()
+        );
+        EXPECT_GE(recording.nextKeyframeTimestamp(), previousTimestamp);
+        previousTimestamp = recording.nextKeyframeTimestamp();
+    }
+
+    EXPECT_FALSE(recording.isPlayingBack());
+    EXPECT_EQ(previousTimestamp, lastTimestamp);
+    // Only a few index blocks of 64 keyframes each are kept in memory at any time
+    EXPECT_GT(maxKeyframesInMemory, 0u);
+    EXPECT_LE(maxKeyframesInMemory, 6 * 64u);
+
+    recording.preSynchronization();
+    EXPECT_EQ(recording.nKeyframesInMemory(), 0u);
+
+    FileSys.deleteFile(asciiPath);
+    FileSys.deleteFile(indexedPath);
+}
@@ -0,0 +1,179 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include "gtest/gtest.h"
+
+#include <openspace/util/speckfile.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace {
+    std::string writeFile(const std::string& name, const std::string& content) {
+        const std::string path = absPath("${TEMPORARY}/" + name);
+        std::ofstream file(path, std::ofstream::binary);
+        file << content;
+        return path;
+    }
+
+    // This is the parsing that every renderable used before the SpeckFile was
+    // introduced; it serves as a reference for the correctness and the benchmark
+    std::vector<float> referenceParse(const std::string& path, int nValuesPerRow) {
+        std::ifstream file(path);
+        std::string line;
+        std::vector<float> result;
+        while (std::getline(file, line)) {
+            if (line.empty() || line[0] == '#' || line.substr(0, 7) == "datavar") {
+                continue;
+            }
+            std::vector<float> values(nValuesPerRow);
+            std::stringstream str(line);
+            for (int i = 0; i < nValuesPerRow; ++i) {
+                str >> values[i];
+            }
+            result.insert(result.end(), values.begin(), values.end());
+        }
+        return result;
+    }
+} // namespace
+
+class SpeckFileTest : public testing::Test {};
+
+TEST_F(SpeckFileTest, Header) {
+    const std::string path = writeFile(
+        "test_speckfile_header.speck",
+        "# A comment\n"
+        "datavar 0 lum\r\n"
+        "datavar 1 colorb_v\n"
+        "texturevar 1\n"
+        "texture -M 1 point.sgi\n"
+        "\n"
+        "1 2 3 4 5\n"
+    );
+    openspace::SpeckFile file(path);
+
+    ASSERT_EQ(file.headerLines().size(), 4);
+    EXPECT_EQ(file.headerLines()[1], "datavar 1 colorb_v");
+    ASSERT_EQ(file.dataVariables().size(), 2);
+    EXPECT_EQ(file.dataVariables()[0].index, 0);
+    EXPECT_EQ(file.dataVariables()[0].name, "lum");
+    EXPECT_EQ(file.dataVariables()[1].name, "colorb_v");
+    EXPECT_EQ(file.nValuesPerRow(), 5);
+}
+
+TEST_F(SpeckFileTest, Rows) {
+    const std::string path = writeFile(
+        "test_speckfile_rows.speck",
+        "datavar 0 lum\n"
+        "1.5 -2e3 3.25 0.001\r\n"
+        "# A comment between the rows\n"
+        "0 0 0 0\n"
+        "   \n"
+        "4 5 6 # the value is missing\n"
+        "-.5 1E-2 +7 123456.789 ignored values"
+    );
+    openspace::SpeckFile file(path);
+
+    std::vector<float> data;
+    ASSERT_EQ(file.readRows(data, file.nValuesPerRow()), 4);
+    const std::vector<float> expected = {
+        1.5f, -2000.f, 3.25f, 0.001f,
+        0.f, 0.f, 0.f, 0.f,
+        4.f, 5.f, 6.f, 0.f,
+        -0.5f, 0.01f, 7.f, 123456.789f
+    };
+    EXPECT_EQ(data, expected);
+
+    ASSERT_EQ(file.readRows(data, file.nValuesPerRow(), true), 3);
+    EXPECT_EQ(data[4], 4.f);
+}
+
+TEST_F(SpeckFileTest, Labels) {
+    const std::string path = writeFile(
+        "test_speckfile_labels.label",
+        "textcolor 1\n"
+        "1 2 3 text Alpha Centauri\n"
+        "4 5 6 text Sol # our sun\n"
+    );
+    openspace::SpeckFile file(path);
+
+    std::vector<std::pair<glm::vec3, std::string>> labels = file.readLabels();
+    ASSERT_EQ(labels.size(), 2);
+    EXPECT_EQ(labels[0].first, glm::vec3(1.f, 2.f, 3.f));
+    EXPECT_EQ(labels[0].second, "Alpha Centauri");
+    EXPECT_EQ(labels[1].second, "Sol");
+}
+
+TEST_F(SpeckFileTest, DISABLED_ParseBenchmark) {
+    using namespace std::chrono;
+
+    constexpr const int NumberRows = 2000000;
+    constexpr const int NumberValues = 8;
+
+    const std::string path = absPath("${TEMPORARY}/test_speckfile_benchmark.speck");
+    {
+        std::ofstream file(path);
+        for (int i = 0; i < NumberValues - 3; ++i) {
+            file << "datavar " << i << " value" << i << '\n';
+        }
+        char buffer[256];
+        for (int i = 0; i < NumberRows; ++i) {
+            std::snprintf(
+                buffer,
+                sizeof(buffer),
+                "%.6f %.6f %.6f %.4f %.4f %d %.3e %d\n",
+                i * 0.001, -i * 1.5, i / 7.0, (i % 13) * 0.1, 0.5, i % 9, i * 3.7, i
+            );
+            file << buffer;
+        }
+    }
+
+    auto start = high_resolution_clock::now();
+    const std::vector<float> reference = referenceParse(path, NumberValues);
+    const double referenceMs = duration<double, std::milli>(
+        high_resolution_clock::now() - start
+    ).count();
+
+    start = high_resolution_clock::now();
+    std::vector<float> data;
+    {
+        openspace::SpeckFile file(path);
+        file.readRows(data, file.nValuesPerRow());
+    }
+    const double speckFileMs = duration<double, std::milli>(
+        high_resolution_clock::now() - start
+    ).count();
+
+    // The file is about 120 MB, so it is removed before the checks that might return.
+    // The SpeckFile is destroyed first as a mapped file can't be deleted on Windows
+    FileSys.deleteFile(path);
+
+    std::cout << "[ BENCHMARK] " << NumberRows << " rows: stringstream " << referenceMs
+              << " ms, SpeckFile " << speckFileMs << " ms" << std::endl;
+
+    ASSERT_EQ(data.size(), reference.size());
+    EXPECT_EQ(data, reference);
+}
@@ -439,6 +439,69 @@ TEST_F(SpiceManagerTest, getPositionTransformMatrix) {
     }
 }
 
+TEST_F(SpiceManagerTest, getTargetPositionCache) {
+    using openspace::SpiceManager;
+    loadMetaKernel();
+
+    double et;
+    str2et_c("2004 jun 11 19:32:00", &et);
+
+    openspace::EphemerisCache& cache = SpiceManager::ref().targetPositionCache(
+        "EARTH", "CASSINI", "J2000", {}
+    );
+    EXPECT_EQ(
+        &cache,
+        &SpiceManager::ref().targetPositionCache("EARTH", "CASSINI", "J2000", {})
+    );
+
+    for (double t = et; t < et + 600.0; t += 0.5) {
+        glm::dvec3 cached;
+        cache.evaluate(t, glm::value_ptr(cached));
+        const glm::dvec3 exact = SpiceManager::ref().targetPosition(
+            "EARTH", "CASSINI", "J2000", {}, t
+        );
+        for (int i = 0; i < 3; ++i) {
+            ASSERT_NEAR(cached[i], exact[i], 1e-6 + 1e-12 * std::abs(exact[i]));
+        }
+    }
+
+    const openspace::EphemerisCache::Statistics stats = cache.statistics();
+    EXPECT_GT(stats.fits, 0);
+    EXPECT_GT(stats.hits, stats.misses);
+
+    // Unloading a kernel invalidates all stored pieces
+    SpiceManager::ref().unloadKernel(PCK);
+    glm::dvec3 cached;
+    cache.evaluate(et, glm::value_ptr(cached));
+    EXPECT_EQ(cache.statistics().misses, stats.misses + 1);
+}
+
+TEST_F(SpiceManagerTest, getPositionTransformMatrixCache) {
+    using openspace::SpiceManager;
+    loadMetaKernel();
+
+    double et;
+    str2et_c("2004 jun 11 19:32:00", &et);
+
+    openspace::EphemerisCache& cache = SpiceManager::ref().positionTransformMatrixCache(
+        "IAU_EARTH", "J2000"
+    );
+
+    for (double t = et; t < et + 600.0; t += 0.5) {
+        glm::dmat3 cached;
+        cache.evaluate(t, glm::value_ptr(cached));
+        const glm::dmat3 exact = SpiceManager::ref().positionTransformMatrix(
+            "IAU_EARTH", "J2000", t
+        );
+        for (int i = 0; i < 3; ++i) {
+            for (int j = 0; j < 3; ++j) {
+                ASSERT_NEAR(cached[i][j], exact[i][j], 1e-10);
+            }
+        }
+    }
+    EXPECT_GT(cache.statistics().hits, cache.statistics().misses);
+}
+
 // Try to get boresight vector and instrument field of view boundary vectors
 TEST_F(SpiceManagerTest, getFieldOfView) {
     using openspace::SpiceManager;
@@ -0,0 +1,116 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <openspace/json.h>
+#include <openspace/util/startuptrace.h>
+#include <thread>
+
+class StartupTraceTest : public testing::Test {};
+
+TEST_F(StartupTraceTest, Disabled) {
+    openspace::StartupTrace trace;
+    {
+        openspace::StartupTrace::Scope scope(trace, "Test", "Disabled");
+    }
+    const auto now = openspace::StartupTrace::Clock::now();
+    trace.addAsyncEvent("Test", "Disabled", now, now);
+    EXPECT_EQ(trace.nEvents(), 0);
+
+    // A scope that started while the trace was disabled is not recorded
+    auto scope = std::make_unique<openspace::StartupTrace::Scope>(trace, "Test", "Late");
+    trace.setEnabled(true);
+    scope = nullptr;
+    EXPECT_EQ(trace.nEvents(), 0);
+}
+
+TEST_F(StartupTraceTest, Events) {
+    using Clock = openspace::StartupTrace::Clock;
+
+    openspace::StartupTrace trace;
+    trace.setEnabled(true);
+    {
+        openspace::StartupTrace::Scope outer(trace, "Asset", "Load \"base\\scene\"");
+        openspace::StartupTrace::Scope inner(trace, "SceneGraphNode", "Initialize Earth");
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    std::thread worker([&trace]() {
+        openspace::StartupTrace::Scope scope(trace, "SceneGraphNode", "Initialize Moon");
+    });
+    worker.join();
+    const Clock::time_point begin = Clock::now();
+    const Clock::time_point end = begin + std::chrono::seconds(1);
+    trace.addAsyncEvent("Synchronization", "Stars", begin, end);
+    ASSERT_EQ(trace.nEvents(), 4);
+
+    const nlohmann::json json = nlohmann::json::parse(trace.json());
+    const nlohmann::json& events = json["traceEvents"];
+    ASSERT_TRUE(events.is_array());
+
+    int nThreadNames = 0;
+    int nComplete = 0;
+    for (const nlohmann::json& e : events) {
+        const std::string phase = e["ph"];
+        if (phase == "M") {
+            ++nThreadNames;
+        }
+        else if (phase == "X") {
+            ++nComplete;
+            const std::string name = e["name"];
+            if (name == "Initialize Moon") {
+                EXPECT_NE(e["tid"], 0);
+            }
+            else {
+                // The events of the thread that enabled the trace are on the main thread
+                EXPECT_EQ(e["tid"], 0);
+            }
+            if (name == "Initialize Earth") {
+                EXPECT_GE(e["dur"].get<double>(), 2000.0);
+            }
+        }
+        else if (phase == "b") {
+            EXPECT_EQ(e["name"], "Stars");
+            EXPECT_EQ(e["cat"], "Synchronization");
+        }
+        else if (phase == "e") {
+            EXPECT_EQ(e["name"], "Stars");
+        }
+    }
+    EXPECT_EQ(nThreadNames, 2);
+    EXPECT_EQ(nComplete, 3);
+
+    // The events are sorted by their start, so the enclosing scope comes first
+    const auto first = std::find_if(
+        events.begin(),
+        events.end(),
+        [](const nlohmann::json& e) { return e["ph"] == "X"; }
+    );
+    ASSERT_NE(first, events.end());
+    EXPECT_EQ((*first)["name"], "Load \"base\\scene\"");
+
+    trace.clear();
+    EXPECT_EQ(trace.nEvents(), 0);
+}
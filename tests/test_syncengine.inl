@@ -0,0 +1,137 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+#include <openspace/engine/syncengine.h>
+#include <openspace/util/syncdata.h>
+
+class SyncEngineTest : public testing::Test {};
+
+TEST_F(SyncEngineTest, FullProtocol) {
+    using namespace openspace;
+
+    SyncData<double> masterValue = 1.0;
+    SyncData<double> slaveValue = 0.0;
+    SyncEngine master(4096);
+    SyncEngine slave(4096);
+    master.addSyncable(&masterValue);
+    slave.addSyncable(&slaveValue);
+
+    std::vector<char> frame = master.encodeSyncables();
+    slave.decodeSyncables(frame);
+    slave.postSynchronization(SyncEngine::IsMaster::No);
+    ASSERT_EQ(slaveValue.data(), 1.0);
+
+    // Unchanged values are still sent every frame
+    const size_t fullSize = frame.size();
+    frame = master.encodeSyncables();
+    ASSERT_EQ(frame.size(), fullSize);
+}
+
+TEST_F(SyncEngineTest, DeltaProtocol) {
+    using namespace openspace;
+
+    SyncData<double> masterA = 1.0;
+    SyncData<double> masterB = 2.0;
+    SyncData<double> slaveA = 0.0;
+    SyncData<double> slaveB = 0.0;
+    SyncEngine master(4096);
+    SyncEngine slave(4096);
+    master.setProtocol(SyncEngine::Protocol::Delta);
+    master.setKeyFrameInterval(100);
+    master.addSyncables({ &masterA, &masterB });
+    slave.addSyncables({ &slaveA, &slaveB });
+
+    // The first frame is a key frame
+    std::vector<char> frame = master.encodeSyncables();
+    const size_t keyFrameSize = frame.size();
+    slave.decodeSyncables(frame);
+    slave.postSynchronization(SyncEngine::IsMaster::No);
+    ASSERT_EQ(slaveA.data(), 1.0);
+    ASSERT_EQ(slaveB.data(), 2.0);
+
+    // Only the changed value is sent
+    masterB = 3.0;
+    frame = master.encodeSyncables();
+    ASSERT_EQ(frame.size(), keyFrameSize - sizeof(double));
+    slave.decodeSyncables(frame);
+    slave.postSynchronization(SyncEngine::IsMaster::No);
+    ASSERT_EQ(slaveA.data(), 1.0);
+    ASSERT_EQ(slaveB.data(), 3.0);
+
+    // Nothing has changed
+    frame = master.encodeSyncables();
+    ASSERT_EQ(frame.size(), keyFrameSize - 2 * sizeof(double));
+    slave.decodeSyncables(frame);
+    slave.postSynchronization(SyncEngine::IsMaster::No);
+    ASSERT_EQ(slaveA.data(), 1.0);
+    ASSERT_EQ(slaveB.data(), 3.0);
+}
+
+TEST_F(SyncEngineTest, DeltaWaitsForKeyFrame) {
+    using namespace openspace;
+
+    SyncData<double> masterValue = 1.0;
+    SyncData<double> slaveValue = 0.0;
+    SyncEngine master(4096);
+    SyncEngine slave(4096);
+    master.setProtocol(SyncEngine::Protocol::Delta);
+    master.setKeyFrameInterval(2);
+    master.addSyncable(&masterValue);
+    slave.addSyncable(&slaveValue);
+
+    // The slave missed the initial key frame and ignores the following delta frame
+    master.encodeSyncables();
+    masterValue = 2.0;
+    std::vector<char> frame = master.encodeSyncables();
+    slave.decodeSyncables(frame);
+    slave.postSynchronization(SyncEngine::IsMaster::No);
+    ASSERT_EQ(slaveValue.data(), 0.0);
+
+    frame = master.encodeSyncables();
+    slave.decodeSyncables(frame);
+    slave.postSynchronization(SyncEngine::IsMaster::No);
+    ASSERT_EQ(slaveValue.data(), 2.0);
+}
+
+TEST_F(SyncEngineTest, DeltaCompressedProtocol) {
+    using namespace openspace;
+
+    std::vector<SyncData<double>> masterValues(128, SyncData<double>(4.0));
+    std::vector<SyncData<double>> slaveValues(128, SyncData<double>(0.0));
+    SyncEngine master(4096);
+    SyncEngine slave(4096);
+    master.setProtocol(SyncEngine::Protocol::DeltaCompressed);
+    for (size_t i = 0; i < masterValues.size(); ++i) {
+        master.addSyncable(&masterValues[i]);
+        slave.addSyncable(&slaveValues[i]);
+    }
+
+    std::vector<char> frame = master.encodeSyncables();
+    ASSERT_LT(frame.size(), masterValues.size() * sizeof(double));
+    slave.decodeSyncables(frame);
+    slave.postSynchronization(SyncEngine::IsMaster::No);
+    for (const SyncData<double>& v : slaveValues) {
+        ASSERT_EQ(v.data(), 4.0);
+    }
+}
@@ -22,8 +22,11 @@
  * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
  ****************************************************************************************/
 
+#include <openspace/util/flattimeline.h>
 #include <openspace/util/timeline.h>
 #include <openspace/util/time.h>
+#include <chrono>
+#include <random>
 
 class TimelineTest : public testing::Test {};
 
@@ -94,3 +97,139 @@ TEST_F(TimelineTest, RemoveKeyframesInRange) {
     timeline.removeKeyframesBetween(-1.0, 4.0);
     ASSERT_EQ(timeline.nKeyframes(), 0);
 }
+
+TEST_F(TimelineTest, FlatTimelineQueryKeyframes) {
+    openspace::FlatTimeline<float> timeline;
+    timeline.addKeyframe(1.0, 1.f);
+    timeline.addKeyframe(0.0, 0.f);
+    timeline.addKeyframe(1.0, 2.f);
+
+    ASSERT_EQ(timeline.nKeyframes(), 3);
+    EXPECT_EQ(timeline.data(0), 0.f);
+    EXPECT_EQ(timeline.data(1), 1.f);
+    EXPECT_EQ(timeline.data(2), 2.f);
+
+    EXPECT_EQ(timeline.firstKeyframeAfter(0.0), 1);
+    EXPECT_EQ(timeline.firstKeyframeAfter(0.0, true), 0);
+    constexpr const size_t NoKeyframe = openspace::FlatTimeline<float>::NoKeyframe;
+    EXPECT_EQ(timeline.firstKeyframeAfter(1.0), NoKeyframe);
+    EXPECT_EQ(timeline.firstKeyframeAfter(1.0, true), 1);
+
+    EXPECT_EQ(timeline.lastKeyframeBefore(1.0), 0);
+    EXPECT_EQ(timeline.lastKeyframeBefore(1.0, true), 2);
+    EXPECT_EQ(timeline.lastKeyframeBefore(0.0), NoKeyframe);
+    EXPECT_EQ(timeline.lastKeyframeBefore(0.0, true), 0);
+
+    using Range = std::pair<size_t, size_t>;
+    EXPECT_EQ(timeline.keyframesBetween(0.0, 1.0), Range(0, 3));
+    EXPECT_EQ(timeline.keyframesBetween(0.0, 1.0, false, true), Range(1, 3));
+    EXPECT_EQ(timeline.keyframesBetween(0.0, 1.0, true, false), Range(0, 1));
+    EXPECT_EQ(timeline.keyframesBetween(0.5, 0.7), Range(1, 1));
+    EXPECT_EQ(timeline.keyframesBetween(2.0, -1.0), Range(3, 3));
+}
+
+TEST_F(TimelineTest, FlatTimelineCursorMatchesTimeline) {
+    std::mt19937 random(42);
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+
+    openspace::Timeline<int> reference;
+    openspace::FlatTimeline<int> timeline;
+    double t = 0.0;
+    for (int i = 0; i < 1000; ++i) {
+        // Duplicated timestamps have to be handled as well
+        t += (i % 10 == 0) ? 0.0 : unit(random);
+        reference.addKeyframe(t, i);
+        timeline.addKeyframe(t, i);
+    }
+
+    openspace::FlatTimeline<int>::Cursor cursor;
+    double time = -1.0;
+    for (int i = 0; i < 10000; ++i) {
+        // Mostly small steps forwards and backwards with occasional jumps
+        if (i % 100 == 0) {
+            time = unit(random) * (t + 2.0) - 1.0;
+        }
+        else {
+            time += unit(random) - 0.4;
+        }
+
+        for (bool inclusive : { false, true }) {
+            const openspace::Keyframe<int>* after =
+                reference.firstKeyframeAfter(time, inclusive);
+            const size_t flatAfter = timeline.firstKeyframeAfter(time, cursor, inclusive);
+            if (after) {
+                ASSERT_NE(flatAfter, openspace::FlatTimeline<int>::NoKeyframe);
+                EXPECT_EQ(timeline.timestamp(flatAfter), after->timestamp);
+            }
+            else {
+                EXPECT_EQ(flatAfter, openspace::FlatTimeline<int>::NoKeyframe);
+            }
+
+            const openspace::Keyframe<int>* before =
+                reference.lastKeyframeBefore(time, inclusive);
+            const size_t flatBefore =
+                timeline.lastKeyframeBefore(time, cursor, inclusive);
+            if (before) {
+                ASSERT_NE(flatBefore, openspace::FlatTimeline<int>::NoKeyframe);
+                EXPECT_EQ(timeline.data(flatBefore), before->data);
+            }
+            else {
+                EXPECT_EQ(flatBefore, openspace::FlatTimeline<int>::NoKeyframe);
+            }
+        }
+    }
+}
+
+TEST_F(TimelineTest, DISABLED_FlatTimelineBenchmark) {
+    using namespace std::chrono;
+
+    constexpr const int NumberKeyframes = 500000;
+    constexpr const int NumberQueries = 1000000;
+
+    openspace::Timeline<double> reference;
+    openspace::FlatTimeline<double> timeline;
+    timeline.reserve(NumberKeyframes);
+    for (int i = 0; i < NumberKeyframes; ++i) {
+        reference.addKeyframe(i * 60.0, i);
+        timeline.addKeyframe(i * 60.0, i);
+    }
+
+    // The time advances by a few seconds per frame, as for a HorizonsTranslation
+    const double step = NumberKeyframes * 60.0 / NumberQueries;
+
+    double sum = 0.0;
+    auto start = high_resolution_clock::now();
+    for (int i = 0; i < NumberQueries; ++i) {
+        const double time = i * step;
+        const openspace::Keyframe<double>* before =
+            reference.lastKeyframeBefore(time, true);
+        const openspace::Keyframe<double>* after =
+            reference.firstKeyframeAfter(time);
+        sum += (before ? before->data : 0.0) + (after ? after->data : 0.0);
+    }
+    const double referenceMs = duration<double, std::milli>(
+        high_resolution_clock::now() - start
+    ).count();
+
+    double flatSum = 0.0;
+    openspace::FlatTimeline<double>::Cursor cursor;
+    start = high_resolution_clock::now();
+    for (int i = 0; i < NumberQueries; ++i) {
+        const double time = i * step;
+        const size_t before = timeline.lastKeyframeBefore(time, cursor, true);
+        const size_t after = timeline.firstKeyframeAfter(time, cursor);
+        flatSum += (before != openspace::FlatTimeline<double>::NoKeyframe ?
+            timeline.data(before) : 0.0);
+        flatSum += (after != openspace::FlatTimeline<double>::NoKeyframe ?
+            timeline.data(after) : 0.0);
+    }
+    const double flatMs = duration<double, std::milli>(
+        high_resolution_clock::now() - start
+    ).count();
+
+    std::cout << "[ BENCHMARK] " << NumberQueries << " queries into " << NumberKeyframes
+              << " keyframes: Timeline " << referenceMs << " ms, FlatTimeline with "
+              << "cursor " << flatMs << " ms" << std::endl;
+
+    EXPECT_EQ(sum, flatSum);
+}
@@ -0,0 +1,221 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <modules/base/rendering/trailorbitsampler.h>
+#include <vector>
+
+namespace {
+    // With a period of 100 s and 11 points, the fixed points are 10 s apart
+    constexpr const double Period = 100.0;
+    constexpr const int Resolution = 11;
+    constexpr const double SecondsPerPoint = Period / (Resolution - 1);
+
+    using Clock = openspace::TrailOrbitSampler::Clock;
+
+    openspace::TrailOrbitSampler createSampler(int* nEvaluations = nullptr) {
+        openspace::TrailOrbitSampler sampler([nEvaluations](double time) {
+            if (nEvaluations) {
+                ++(*nEvaluations);
+            }
+            return glm::vec3(static_cast<float>(time), 0.f, 0.f);
+        });
+        sampler.setPeriod(Period);
+        sampler.setResolution(Resolution);
+        return sampler;
+    }
+
+    Clock::time_point noDeadline() {
+        return Clock::now() + std::chrono::hours(1);
+    }
+
+    Clock::time_point passedDeadline() {
+        return Clock::now() - std::chrono::hours(1);
+    }
+
+    // Mirrors what the renderable does with the vertex buffer: only the reported ranges
+    // are copied from the sampler
+    void applyReport(const openspace::TrailOrbitSampler& sampler,
+                     const openspace::TrailOrbitSampler::UpdateReport& report,
+                     std::vector<glm::vec3>& buffer)
+    {
+        buffer.resize(sampler.points().size());
+        for (int i = 0; i < report.nRanges; ++i) {
+            const openspace::TrailOrbitSampler::Range& r = report.ranges[i];
+            ASSERT_GE(r.begin, 0);
+            ASSERT_GT(r.length, 0);
+            ASSERT_LE(r.begin + r.length, sampler.count());
+            for (int j = r.begin; j < r.begin + r.length; ++j) {
+                buffer[j] = sampler.points()[j];
+            }
+        }
+    }
+
+    // Checks that the buffer contains the floating point at the current time followed by
+    // the fixed points in descending temporal order, wrapping around the ring buffer
+    void checkTrail(const openspace::TrailOrbitSampler& sampler,
+                    const std::vector<glm::vec3>& buffer, double time)
+    {
+        ASSERT_FALSE(sampler.isSweeping());
+        ASSERT_EQ(sampler.count(), Resolution);
+
+        EXPECT_NEAR(buffer[sampler.first()].x, time, 1e-3);
+        for (int k = 1; k < sampler.count(); ++k) {
+            const int i = (sampler.first() + k) % sampler.count();
+            const double t = sampler.lastPointTime() - (k - 1) * SecondsPerPoint;
+            EXPECT_NEAR(buffer[i].x, t, 1e-3) << "time " << time << " index " << i;
+        }
+        EXPECT_NEAR(
+            sampler.firstPointTime(),
+            sampler.lastPointTime() - (Resolution - 2) * SecondsPerPoint,
+            1e-6
+        );
+    }
+} // namespace
+
+class TrailOrbitSamplerTest : public testing::Test {};
+
+TEST_F(TrailOrbitSamplerTest, SweepWithPassedDeadline) {
+    openspace::TrailOrbitSampler sampler = createSampler();
+    std::vector<glm::vec3> buffer;
+
+    // Each call has to compute at least one point, so the sweep finishes after one call
+    // per fixed point even if the deadline has always passed
+    for (int i = 1; i < Resolution; ++i) {
+        const auto report = sampler.update(0.0, passedDeadline());
+        applyReport(sampler, report, buffer);
+        EXPECT_EQ(sampler.count(), i + 1);
+        EXPECT_EQ(sampler.first(), 0);
+        EXPECT_EQ(sampler.isSweeping(), i < Resolution - 1);
+    }
+    checkTrail(sampler, buffer, 0.0);
+    EXPECT_DOUBLE_EQ(sampler.lastPointTime(), 0.0);
+    EXPECT_DOUBLE_EQ(sampler.firstPointTime(), -90.0);
+
+    // Nothing changes while the time stands still
+    const auto report = sampler.update(0.0, passedDeadline());
+    EXPECT_EQ(report.nRanges, 0);
+}
+
+TEST_F(TrailOrbitSamplerTest, IncrementalUpdates) {
+    int nEvaluations = 0;
+    openspace::TrailOrbitSampler sampler = createSampler(&nEvaluations);
+    std::vector<glm::vec3> buffer;
+
+    applyReport(sampler, sampler.update(0.0, noDeadline()), buffer);
+    checkTrail(sampler, buffer, 0.0);
+
+    // Moving forwards wraps the floating point around the beginning of the array
+    // multiple times and sometimes adds more than one point per step
+    double time = 0.0;
+    for (double step : { 3.7, 12.3, 0.4, 25.1 }) {
+        for (int i = 0; i < 20; ++i) {
+            time += step;
+            nEvaluations = 0;
+            const auto report = sampler.update(time, noDeadline());
+            applyReport(sampler, report, buffer);
+            checkTrail(sampler, buffer, time);
+
+            // Only the new points and the floating point are computed
+            const int nNew = static_cast<int>(step / SecondsPerPoint) + 1;
+            EXPECT_LE(nEvaluations, nNew + 1);
+            EXPECT_LE(report.nRanges, 2);
+        }
+    }
+
+    // Moving backwards wraps around the end of the array
+    for (double step : { 3.7, 12.3, 0.4, 25.1 }) {
+        for (int i = 0; i < 20; ++i) {
+            time -= step;
+            nEvaluations = 0;
+            const auto report = sampler.update(time, noDeadline());
+            applyReport(sampler, report, buffer);
+            checkTrail(sampler, buffer, time);
+
+            const int nNew = static_cast<int>(step / SecondsPerPoint) + 1;
+            EXPECT_LE(nEvaluations, nNew + 1);
+            EXPECT_LE(report.nRanges, 2);
+        }
+    }
+}
+
+TEST_F(TrailOrbitSamplerTest, DeadlineLimitedCatchUp) {
+    openspace::TrailOrbitSampler sampler = createSampler();
+    std::vector<glm::vec3> buffer;
+
+    applyReport(sampler, sampler.update(0.0, noDeadline()), buffer);
+
+    // Five new points are needed, but only one can be computed per call; the remaining
+    // ones are added in the following calls even though the time does not change
+    for (int i = 1; i <= 5; ++i) {
+        const auto report = sampler.update(55.0, passedDeadline());
+        applyReport(sampler, report, buffer);
+        EXPECT_DOUBLE_EQ(sampler.lastPointTime(), i * SecondsPerPoint);
+        checkTrail(sampler, buffer, 55.0);
+    }
+
+    const auto report = sampler.update(55.0, passedDeadline());
+    EXPECT_EQ(report.nRanges, 0);
+
+    // The same applies when moving backwards
+    for (int i = 1; i <= 8; ++i) {
+        applyReport(sampler, sampler.update(-25.0, passedDeadline()), buffer);
+        EXPECT_DOUBLE_EQ(sampler.lastPointTime(), 50.0 - i * SecondsPerPoint);
+        checkTrail(sampler, buffer, -25.0);
+    }
+    EXPECT_EQ(sampler.update(-25.0, passedDeadline()).nRanges, 0);
+}
+
+TEST_F(TrailOrbitSamplerTest, LargeJumpStartsSweep) {
+    openspace::TrailOrbitSampler sampler = createSampler();
+    std::vector<glm::vec3> buffer;
+
+    applyReport(sampler, sampler.update(0.0, noDeadline()), buffer);
+
+    // Jumping by more than the period replaces all points
+    applyReport(sampler, sampler.update(1000.0, passedDeadline()), buffer);
+    EXPECT_TRUE(sampler.isSweeping());
+    EXPECT_EQ(sampler.first(), 0);
+    EXPECT_EQ(sampler.count(), 2);
+
+    applyReport(sampler, sampler.update(1000.0, noDeadline()), buffer);
+    checkTrail(sampler, buffer, 1000.0);
+    EXPECT_DOUBLE_EQ(sampler.lastPointTime(), 1000.0);
+    EXPECT_DOUBLE_EQ(sampler.firstPointTime(), 910.0);
+
+    // Jumping away while the sweep is in progress restarts it at the new time
+    applyReport(sampler, sampler.update(0.0, passedDeadline()), buffer);
+    applyReport(sampler, sampler.update(-500.0, passedDeadline()), buffer);
+    EXPECT_EQ(sampler.count(), 2);
+    applyReport(sampler, sampler.update(-500.0, noDeadline()), buffer);
+    checkTrail(sampler, buffer, -500.0);
+    EXPECT_DOUBLE_EQ(sampler.lastPointTime(), -500.0);
+
+    // Changing the resolution or invalidating the sampler also starts a new sweep
+    sampler.invalidate();
+    sampler.update(-500.0, passedDeadline());
+    EXPECT_TRUE(sampler.isSweeping());
+}
@@ -0,0 +1,501 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <modules/multiresvolume/rendering/brickstreamer.h>
+#include <modules/multiresvolume/rendering/errorhistogrammanager.h>
+#include <modules/multiresvolume/rendering/localerrorhistogrammanager.h>
+#include <modules/multiresvolume/rendering/tsp.h>
+#include <ghoul/filesystem/filesystem.h>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <random>
+#include <set>
+#include <tuple>
+
+namespace {
+    // Writes a TSP file with random values, 4x4x4 bricks of 6x6x6 voxels (including the
+    // padding) and 8 timesteps
+    std::string writeTsp(const std::string& name) {
+        openspace::TSP::Header header = { 0, 8, 8, 4, 4, 4, 4, 4, 4 };
+
+        // 73 octree nodes for each of the 15 BST nodes
+        std::vector<float> values(73 * 15 * 6 * 6 * 6);
+        std::mt19937 generator(1337);
+        std::uniform_real_distribution<float> distribution(0.f, 1.f);
+        for (float& v : values) {
+            v = distribution(generator);
+        }
+
+        const std::string path = absPath("${TEMPORARY}/" + name);
+        std::ofstream file(path, std::ofstream::binary);
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(
+            reinterpret_cast<const char*>(values.data()),
+            values.size() * sizeof(float)
+        );
+        return path;
+    }
+
+    void octreeLeaves(const openspace::TSP& tsp, unsigned int brick,
+                      std::vector<unsigned int>& leaves)
+    {
+        if (tsp.isOctreeLeaf(brick)) {
+            leaves.push_back(brick);
+            return;
+        }
+        const unsigned int child = tsp.firstOctreeChild(brick);
+        for (unsigned int i = 0; i < 8; ++i) {
+            octreeLeaves(tsp, child + i, leaves);
+        }
+    }
+
+    void bstLeaves(const openspace::TSP& tsp, unsigned int brick,
+                   std::vector<unsigned int>& leaves)
+    {
+        if (tsp.isBstLeaf(brick)) {
+            leaves.push_back(brick);
+            return;
+        }
+        bstLeaves(tsp, tsp.bstLeft(brick), leaves);
+        bstLeaves(tsp, tsp.bstRight(brick), leaves);
+    }
+
+    // A port of the walk from every leaf to all of its ancestors, with which the error
+    // histograms were built before they were built per inner node
+    class ReferenceErrorHistograms {
+    public:
+        ReferenceErrorHistograms(const openspace::TSP& tsp, int numBins)
+            : _tsp(tsp)
+            , _numBins(numBins)
+        {
+            const int numOtNodes = _tsp.numOTNodes();
+            const int otOffset = static_cast<int>(
+                (std::pow(8, _tsp.numOTLevels() - 1) - 1) / 7
+            );
+            const int numBstNodes = _tsp.numBSTNodes();
+            const int bstOffset = numBstNodes / 2;
+
+            for (int bst = bstOffset; bst < numBstNodes; bst++) {
+                for (int ot = otOffset; ot < numOtNodes; ot++) {
+                    buildFromLeaf(bst, ot);
+                }
+            }
+        }
+
+        const openspace::Histogram* histogram(unsigned int brickIndex) const {
+            auto it = _histograms.find(brickIndex);
+            return it != _histograms.end() ? &it->second : nullptr;
+        }
+
+    private:
+        void buildFromLeaf(int bstOffset, int octreeOffset) {
+            const unsigned int brickDim = _tsp.brickDim();
+            const unsigned int paddedBrickDim = _tsp.paddedBrickDim();
+            const unsigned int padding = (paddedBrickDim - brickDim) / 2;
+
+            const int numOtNodes = _tsp.numOTNodes();
+            const float* leafValues = _tsp.brickData(
+                bstOffset * numOtNodes + octreeOffset
+            );
+
+            int bstNode = bstOffset;
+            do {
+                glm::vec3 leafOffset(0.f); // Leaf offset in leaf sized voxels
+                unsigned int octreeLevel = 0;
+                int octreeNode = octreeOffset;
+                do {
+                    if (bstNode != bstOffset || octreeNode != octreeOffset) {
+                        // Is actually an ancestor
+                        const unsigned int ancestor = bstNode * numOtNodes + octreeNode;
+                        const float* ancestorVoxels = _tsp.brickData(ancestor);
+                        if (_histograms.find(ancestor) == _histograms.end()) {
+                            _histograms[ancestor] = openspace::Histogram(
+                                0.f,
+                                1.f,
+                                _numBins
+                            );
+                        }
+                        openspace::Histogram& histogram = _histograms[ancestor];
+
+                        const float invVoxelScale = 1.f / std::pow(2.f, octreeLevel);
+                        const glm::vec3 ancestorOffset = (leafOffset * invVoxelScale) +
+                                                         glm::vec3(padding - 0.5f);
+
+                        for (int z = 0; z < static_cast<int>(brickDim); z++) {
+                            for (int y = 0; y < static_cast<int>(brickDim); y++) {
+                                for (int x = 0; x < static_cast<int>(brickDim); x++) {
+                                    const glm::vec3 leafSamplePoint = glm::vec3(x, y, z) +
+                                        glm::vec3(static_cast<float>(padding));
+                                    const glm::vec3 ancestorSamplePoint = ancestorOffset +
+                                        (glm::vec3(x, y, z) + glm::vec3(0.5)) *
+                                        invVoxelScale;
+                                    const float leafValue =
+                                        leafValues[linearCoords(leafSamplePoint)];
+                                    const float ancestorValue = interpolate(
+                                        ancestorSamplePoint,
+                                        ancestorVoxels
+                                    );
+                                    histogram.addRectangle(
+                                        leafValue,
+                                        ancestorValue,
+                                        std::abs(leafValue - ancestorValue)
+                                    );
+                                }
+                            }
+                        }
+                    }
+
+                    // Traverse to next octree ancestor
+                    const int octreeChild = (octreeNode - 1) % 8;
+                    octreeNode = parentOffset(octreeNode, 8);
+
+                    const int childSize = static_cast<int>(
+                        std::pow(2, octreeLevel) * brickDim
+                    );
+                    leafOffset.x += (octreeChild % 2) * childSize;
+                    leafOffset.y += ((octreeChild / 2) % 2) * childSize;
+                    leafOffset.z += (octreeChild / 4) * childSize;
+
+                    octreeLevel++;
+                } while (octreeNode != -1);
+
+                bstNode = parentOffset(bstNode, 2);
+            } while (bstNode != -1);
+        }
+
+        static int parentOffset(int offset, int base) {
+            if (offset == 0) {
+                return -1;
+            }
+            const int depth = static_cast<int>(
+                std::floor(std::log(((base - 1) * offset + 1.0)) / std::log(base))
+            );
+            const int firstInLevel = static_cast<int>(
+                (std::pow(base, depth) - 1) / (base - 1)
+            );
+            const int inLevelOffset = offset - firstInLevel;
+
+            const int parentDepth = depth - 1;
+            const int firstInParentLevel = static_cast<int>(
+                (std::pow(base, parentDepth) - 1) / (base - 1)
+            );
+            return firstInParentLevel + inLevelOffset / base;
+        }
+
+        unsigned int linearCoords(const glm::vec3& coords) const {
+            return linearCoords(glm::ivec3(coords));
+        }
+
+        unsigned int linearCoords(const glm::ivec3& coords) const {
+            const unsigned int paddedBrickDim = _tsp.paddedBrickDim();
+            return coords.z * paddedBrickDim * paddedBrickDim +
+                   coords.y * paddedBrickDim + coords.x;
+        }
+
+        float interpolate(const glm::vec3& samplePoint, const float* voxels) const {
+            const glm::ivec3 low = glm::ivec3(samplePoint);
+            const glm::ivec3 high = glm::ivec3(glm::ceil(samplePoint));
+            const glm::vec3 t = 1.f - (samplePoint - glm::vec3(low));
+
+            auto v = [&](int x, int y, int z) {
+                return voxels[linearCoords(glm::ivec3(x, y, z))];
+            };
+            const float v00 = t.z * v(low.x, low.y, low.z) +
+                              (1.f - t.z) * v(low.x, low.y, high.z);
+            const float v01 = t.z * v(low.x, high.y, low.z) +
+                              (1.f - t.z) * v(low.x, high.y, high.z);
+            const float v10 = t.z * v(high.x, low.y, low.z) +
+                              (1.f - t.z) * v(high.x, low.y, high.z);
+            const float v11 = t.z * v(high.x, high.y, low.z) +
+                              (1.f - t.z) * v(high.x, high.y, high.z);
+
+            const float v0 = t.y * v00 + (1.f - t.y) * v01;
+            const float v1 = t.y * v10 + (1.f - t.y) * v11;
+            return t.x * v0 + (1.f - t.x) * v1;
+        }
+
+        const openspace::TSP& _tsp;
+        const int _numBins;
+        std::map<unsigned int, openspace::Histogram> _histograms;
+    };
+} // namespace
+
+class TspTest : public testing::Test {};
+
+TEST_F(TspTest, Errors) {
+    openspace::TSP tsp(writeTsp("test_tsp_errors.tsp"));
+    ASSERT_TRUE(tsp.readHeader());
+    ASSERT_TRUE(tsp.construct());
+    ASSERT_TRUE(tsp.calculateSpatialError());
+    ASSERT_TRUE(tsp.calculateTemporalError());
+
+    const unsigned int dim = tsp.paddedBrickDim();
+    const unsigned int nValues = dim * dim * dim;
+
+    for (unsigned int brick = 0; brick < tsp.numTotalNodes(); ++brick) {
+        const float* values = tsp.brickData(brick);
+
+        // The spatial error is the standard deviation of the covered leaves from the
+        // brick's average
+        std::vector<unsigned int> leaves;
+        octreeLeaves(tsp, brick, leaves);
+        if (leaves.size() == 1) {
+            EXPECT_EQ(tsp.spatialError(brick), -0.1f);
+        }
+        else {
+            double average = 0.0;
+            for (unsigned int i = 0; i < nValues; ++i) {
+                average += values[i];
+            }
+            average /= nValues;
+
+            double sumSquares = 0.0;
+            for (unsigned int leaf : leaves) {
+                for (unsigned int i = 0; i < nValues; ++i) {
+                    sumSquares += std::pow(tsp.brickData(leaf)[i] - average, 2.0);
+                }
+            }
+            const double expected = std::pow(
+                std::sqrt(sumSquares / (leaves.size() * nValues)),
+                0.5
+            );
+            EXPECT_NEAR(tsp.spatialError(brick), expected, 1e-5);
+        }
+
+        // The temporal error is the average of the voxels' standard deviations over
+        // the covered timesteps
+        leaves.clear();
+        bstLeaves(tsp, brick, leaves);
+        if (leaves.size() == 1) {
+            EXPECT_EQ(tsp.temporalError(brick), -0.1f);
+        }
+        else {
+            double sumStdDev = 0.0;
+            for (unsigned int i = 0; i < nValues; ++i) {
+                double sumSquares = 0.0;
+                for (unsigned int leaf : leaves) {
+                    sumSquares += std::pow(tsp.brickData(leaf)[i] - values[i], 2.0);
+                }
+                sumStdDev += std::sqrt(sumSquares / leaves.size());
+            }
+            const double expected = std::pow(sumStdDev / nValues, 0.25);
+            EXPECT_NEAR(tsp.temporalError(brick), expected, 1e-5);
+        }
+    }
+}
+
+TEST_F(TspTest, ErrorHistograms) {
+    openspace::TSP tsp(writeTsp("test_tsp_histograms.tsp"));
+    ASSERT_TRUE(tsp.readHeader());
+    ASSERT_TRUE(tsp.construct());
+
+    openspace::ErrorHistogramManager errorHistograms(&tsp);
+    ASSERT_TRUE(errorHistograms.buildHistograms(50));
+    openspace::LocalErrorHistogramManager localHistograms(&tsp);
+    ASSERT_TRUE(localHistograms.buildHistograms(50));
+
+    for (unsigned int brick = 0; brick < tsp.numTotalNodes(); ++brick) {
+        const bool isLeaf = tsp.isOctreeLeaf(brick) && tsp.isBstLeaf(brick);
+
+        const openspace::Histogram* histogram = errorHistograms.histogram(brick);
+        const openspace::Histogram* spatial = localHistograms.spatialHistogram(brick);
+        const openspace::Histogram* temporal = localHistograms.temporalHistogram(brick);
+        if (isLeaf) {
+            EXPECT_EQ(histogram, nullptr);
+            EXPECT_EQ(spatial, nullptr);
+            EXPECT_EQ(temporal, nullptr);
+            continue;
+        }
+
+        ASSERT_NE(histogram, nullptr);
+        ASSERT_TRUE(histogram->isValid());
+        ASSERT_NE(spatial, nullptr);
+        ASSERT_NE(temporal, nullptr);
+
+        // Random leaves always differ from their ancestors, so every inner node has to
+        // have collected errors in the histograms that apply to it
+        auto total = [](const openspace::Histogram* h) {
+            double sum = 0.0;
+            for (int i = 0; i < h->numBins(); ++i) {
+                sum += h->data()[i];
+            }
+            return sum;
+        };
+        EXPECT_GT(total(histogram), 0.0);
+        EXPECT_EQ(total(spatial) > 0.0, !tsp.isOctreeLeaf(brick));
+        EXPECT_EQ(total(temporal) > 0.0, !tsp.isBstLeaf(brick));
+    }
+}
+
+TEST_F(TspTest, ErrorHistogramsMatchLeafWalk) {
+    constexpr const int NumBins = 50;
+
+    openspace::TSP tsp(writeTsp("test_tsp_leafwalk.tsp"));
+    ASSERT_TRUE(tsp.readHeader());
+    ASSERT_TRUE(tsp.construct());
+
+    openspace::ErrorHistogramManager errorHistograms(&tsp);
+    ASSERT_TRUE(errorHistograms.buildHistograms(NumBins));
+    const ReferenceErrorHistograms reference(tsp, NumBins);
+
+    for (unsigned int brick = 0; brick < tsp.numTotalNodes(); ++brick) {
+        const openspace::Histogram* histogram = errorHistograms.histogram(brick);
+        const openspace::Histogram* expected = reference.histogram(brick);
+        ASSERT_EQ(histogram == nullptr, expected == nullptr) << "Brick " << brick;
+        if (!expected) {
+            continue;
+        }
+
+        ASSERT_EQ(histogram->numBins(), NumBins);
+        for (int i = 0; i < NumBins; ++i) {
+            // The leaves are added in a different order, so the sums can differ in
+            // their rounding
+            const float e = expected->data()[i];
+            EXPECT_NEAR(histogram->data()[i], e, 1e-5f * std::max(1.f, std::abs(e)))
+                << "Brick " << brick << ", bin " << i;
+        }
+    }
+}
+
+TEST_F(TspTest, LeafRange) {
+    using Manager = openspace::ErrorHistogramManager;
+
+    // A binary tree with 4 levels has the nodes 0, 1-2, 3-6, and 7-14
+    Manager::LeafRange r = Manager::leafRange(0, 2, 4);
+    EXPECT_EQ(r.first, 7);
+    EXPECT_EQ(r.count, 8);
+    EXPECT_EQ(r.height, 3);
+
+    r = Manager::leafRange(2, 2, 4);
+    EXPECT_EQ(r.first, 11);
+    EXPECT_EQ(r.count, 4);
+    EXPECT_EQ(r.height, 2);
+
+    r = Manager::leafRange(5, 2, 4);
+    EXPECT_EQ(r.first, 11);
+    EXPECT_EQ(r.count, 2);
+    EXPECT_EQ(r.height, 1);
+
+    r = Manager::leafRange(12, 2, 4);
+    EXPECT_EQ(r.first, 12);
+    EXPECT_EQ(r.count, 1);
+    EXPECT_EQ(r.height, 0);
+
+    // An octree with 3 levels has the nodes 0, 1-8, and 9-72
+    r = Manager::leafRange(0, 8, 3);
+    EXPECT_EQ(r.first, 9);
+    EXPECT_EQ(r.count, 64);
+    EXPECT_EQ(r.height, 2);
+
+    r = Manager::leafRange(3, 8, 3);
+    EXPECT_EQ(r.first, 25);
+    EXPECT_EQ(r.count, 8);
+    EXPECT_EQ(r.height, 1);
+
+    // The leaves of every node are the children of its children
+    openspace::TSP tsp(writeTsp("test_tsp_leafrange.tsp"));
+    ASSERT_TRUE(tsp.readHeader());
+    ASSERT_TRUE(tsp.construct());
+    for (unsigned int node = 0; node < tsp.numOTNodes(); ++node) {
+        std::vector<unsigned int> leaves;
+        octreeLeaves(tsp, node, leaves);
+        r = Manager::leafRange(node, 8, tsp.numOTLevels());
+        ASSERT_EQ(r.count, leaves.size());
+        for (unsigned int i = 0; i < r.count; ++i) {
+            EXPECT_EQ(leaves[i], r.first + i) << "Node " << node;
+        }
+    }
+}
+
+TEST_F(TspTest, LeafOffset) {
+    using Manager = openspace::ErrorHistogramManager;
+    constexpr const unsigned int BrickDim = 4;
+
+    // Directly below the inner node, the digit is the octant of the child
+    EXPECT_EQ(Manager::leafOffset(0, 1, BrickDim), glm::ivec3(0, 0, 0));
+    EXPECT_EQ(Manager::leafOffset(1, 1, BrickDim), glm::ivec3(4, 0, 0));
+    EXPECT_EQ(Manager::leafOffset(2, 1, BrickDim), glm::ivec3(0, 4, 0));
+    EXPECT_EQ(Manager::leafOffset(4, 1, BrickDim), glm::ivec3(0, 0, 4));
+    EXPECT_EQ(Manager::leafOffset(7, 1, BrickDim), glm::ivec3(4, 4, 4));
+
+    // Two levels below, the higher digit selects the octant of the child, which is
+    // twice as large, and the lower digit the octant within it: 0o52 is the child 5 of
+    // the inner node (x and z) and its child 2 (y)
+    EXPECT_EQ(Manager::leafOffset(052, 2, BrickDim), glm::ivec3(8, 4, 8));
+    EXPECT_EQ(Manager::leafOffset(077, 2, BrickDim), glm::ivec3(12, 12, 12));
+
+    // Every leaf below an inner node has a different offset inside the inner node
+    std::set<std::tuple<int, int, int>> offsets;
+    for (unsigned int leaf = 0; leaf < 8 * 8 * 8; ++leaf) {
+        const glm::ivec3 o = Manager::leafOffset(leaf, 3, BrickDim);
+        EXPECT_GE(glm::min(o.x, glm::min(o.y, o.z)), 0);
+        EXPECT_LT(glm::max(o.x, glm::max(o.y, o.z)), static_cast<int>(8 * BrickDim));
+        EXPECT_EQ(o % static_cast<int>(BrickDim), glm::ivec3(0));
+        offsets.emplace(o.x, o.y, o.z);
+    }
+    EXPECT_EQ(offsets.size(), 8 * 8 * 8);
+}
+
+TEST_F(TspTest, BrickStreamer) {
+    openspace::TSP tsp(writeTsp("test_tsp_streamer.tsp"));
+    ASSERT_TRUE(tsp.readHeader());
+
+    const unsigned int dim = tsp.paddedBrickDim();
+    const size_t nValues = dim * dim * dim;
+
+    openspace::BrickStreamer streamer(tsp);
+    EXPECT_FALSE(streamer.isBusy());
+
+    // Runs of consecutive bricks and single bricks, in the order they are requested
+    const std::vector<unsigned int> bricks = { 0, 1, 2, 7, 40, 41, 100, 1094 };
+    std::vector<float> destination(bricks.size() * nValues, -1.f);
+    streamer.request(bricks, destination.data());
+    streamer.wait();
+
+    EXPECT_FALSE(streamer.isBusy());
+    EXPECT_EQ(streamer.numQueuedBricks(), 0);
+    for (size_t i = 0; i < bricks.size(); ++i) {
+        EXPECT_EQ(
+            std::memcmp(
+                destination.data() + i * nValues,
+                tsp.brickData(bricks[i]),
+                nValues * sizeof(float)
+            ),
+            0
+        );
+    }
+
+    // The streamer can be reused once the request has finished
+    streamer.request({ 3 }, destination.data());
+    streamer.wait();
+    EXPECT_EQ(
+        std::memcmp(destination.data(), tsp.brickData(3), nValues * sizeof(float)),
+        0
+    );
+}
@@ -0,0 +1,200 @@
+/*****************************************************************************************
+ *                                                                                       *
+ * OpenSpace                                                                             *
+ *                                                                                       *
+ * Copyright (c) 2014-2019                                                               *
+ *                                                                                       *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of this  *
+ * software and associated documentation files (the "Software"), to deal in the Software *
+ * without restriction, including without limitation the rights to use, copy, modify,    *
+ * merge, publish, distribute, sublicense, and/or sell copies of the Software, and to    *
+ * permit persons to whom the Software is furnished to do so, subject to the following   *
+ * conditions:                                                                           *
+ *                                                                                       *
+ * The above copyright notice and this permission notice shall be included in all copies *
+ * or substantial portions of the Software.                                              *
+ *                                                                                       *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED,   *
+ * INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS FOR A         *
+ * PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT    *
+ * HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF  *
+ * CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE SOFTWARE  *
+ * OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                                         *
+ ****************************************************************************************/
+
+
+#include "gtest/gtest.h"
+
+#include <openspace/util/workstealingthreadpool.h>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+    // Waits until the predicate is fulfilled or a generous timeout has passed, so that a
+    // broken pool fails the test instead of hanging it
+    template <typename Predicate>
+    bool waitFor(Predicate predicate) {
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(10);
+        while (!predicate()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::yield();
+        }
+        return true;
+    }
+} // namespace
+
+TEST(WorkStealingThreadPoolTest, Enqueue) {
+    openspace::WorkStealingThreadPool pool(4);
+    EXPECT_EQ(pool.numThreads(), 4u);
+
+    constexpr const int NumberTasks = 10000;
+    std::vector<std::atomic<int>> counters(NumberTasks);
+    std::atomic<int> nFinished = 0;
+    for (int i = 0; i < NumberTasks; ++i) {
+        pool.enqueue([&counters, &nFinished, i]() {
+            ++counters[i];
+            ++nFinished;
+        });
+    }
+
+    ASSERT_TRUE(waitFor([&]() { return nFinished == NumberTasks; }));
+    for (int i = 0; i < NumberTasks; ++i) {
+        EXPECT_EQ(counters[i], 1) << "Task " << i;
+    }
+
+    // Nothing is left for the calling thread
+    EXPECT_FALSE(pool.runPendingTask());
+}
+
+TEST(WorkStealingThreadPoolTest, Stealing) {
+    openspace::WorkStealingThreadPool pool(4);
+
+    constexpr const int NumberTasks = 200;
+    std::atomic<int> nFinished = 0;
+    std::atomic<bool> isBlocking = true;
+    std::mutex mutex;
+    std::set<std::thread::id> executingThreads;
+    std::thread::id spawningThread;
+
+    // All tasks that are enqueued from inside a task end up in the queue of the worker
+    // that runs it. That worker is blocked until all tasks are finished, so they can only
+    // be executed if the other workers steal them
+    pool.enqueue([&]() {
+        spawningThread = std::this_thread::get_id();
+        for (int i = 0; i < NumberTasks; ++i) {
+            pool.enqueue([&]() {
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    executingThreads.insert(std::this_thread::get_id());
+                }
+                ++nFinished;
+            });
+        }
+        waitFor([&]() { return nFinished == NumberTasks; });
+        isBlocking = false;
+    });
+
+    ASSERT_TRUE(waitFor([&]() { return !isBlocking; }));
+    EXPECT_EQ(nFinished, NumberTasks);
+    EXPECT_FALSE(executingThreads.empty());
+    EXPECT_EQ(executingThreads.count(spawningThread), 0);
+}
+
+TEST(WorkStealingThreadPoolTest, ParallelFor) {
+    openspace::WorkStealingThreadPool pool(3);
+
+    constexpr const size_t N = 100003;
+    std::vector<int> values(N, 0);
+    pool.parallelFor(N, 16, [&values](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            values[i] += static_cast<int>(i % 7);
+        }
+    });
+    for (size_t i = 0; i < N; ++i) {
+        ASSERT_EQ(values[i], static_cast<int>(i % 7)) << "Index " << i;
+    }
+
+    // More blocks than elements and empty ranges
+    std::atomic<int> nCalls = 0;
+    pool.parallelFor(3, 10, [&nCalls](size_t begin, size_t end) {
+        EXPECT_EQ(end - begin, 1u);
+        ++nCalls;
+    });
+    EXPECT_EQ(nCalls, 3);
+    pool.parallelFor(0, 4, [](size_t, size_t) { FAIL() << "No block expected"; });
+}
+
+TEST(WorkStealingThreadPoolTest, ParallelForInsideTask) {
+    // With a single worker thread, the nested parallelFor only finishes if the task that
+    // is waiting for it executes the blocks itself
+    for (size_t nThreads : { 1, 4 }) {
+        openspace::WorkStealingThreadPool pool(nThreads);
+
+        constexpr const int NumberOuterTasks = 8;
+        constexpr const size_t N = 1000;
+        std::vector<std::atomic<long long>> sums(NumberOuterTasks);
+        std::atomic<int> nFinished = 0;
+        for (int t = 0; t < NumberOuterTasks; ++t) {
+            pool.enqueue([&, t]() {
+                pool.parallelFor(N, 8, [&sums, t](size_t begin, size_t end) {
+                    long long sum = 0;
+                    for (size_t i = begin; i < end; ++i) {
+                        sum += static_cast<long long>(i);
+                    }
+                    sums[t] += sum;
+                });
+                ++nFinished;
+            });
+        }
+
+        ASSERT_TRUE(waitFor([&]() { return nFinished == NumberOuterTasks; }))
+            << nThreads << " threads";
+        for (int t = 0; t < NumberOuterTasks; ++t) {
+            EXPECT_EQ(sums[t], static_cast<long long>(N * (N - 1) / 2));
+        }
+    }
+}
+
+TEST(WorkStealingThreadPoolTest, ParallelForException) {
+    openspace::WorkStealingThreadPool pool(4);
+
+    // All blocks run even though some of them throw, and the caller gets the exception
+    constexpr const size_t NumberBlocks = 32;
+    std::atomic<size_t> nBlocks = 0;
+    EXPECT_THROW(
+        pool.parallelFor(NumberBlocks, NumberBlocks, [&nBlocks](size_t begin, size_t) {
+            ++nBlocks;
+            if (begin % 3 == 0) {
+                throw std::runtime_error("Block failed");
+            }
+        }),
+        std::runtime_error
+    );
+    EXPECT_EQ(nBlocks, NumberBlocks);
+
+    // The pool is still usable afterwards
+    std::atomic<size_t> nCalls = 0;
+    pool.parallelFor(8, 8, [&nCalls](size_t, size_t) { ++nCalls; });
+    EXPECT_EQ(nCalls, 8u);
+}
+
+TEST(WorkStealingThreadPoolTest, TaskException) {
+    openspace::WorkStealingThreadPool pool(2);
+
+    // A throwing task must neither terminate the worker nor escape into the thread that
+    // runs it while helping out
+    std::atomic<int> nFinished = 0;
+    for (int i = 0; i < 10; ++i) {
+        pool.enqueue([]() { throw std::runtime_error("Task failed"); });
+        pool.enqueue([&nFinished]() { ++nFinished; });
+    }
+    while (pool.runPendingTask()) {}
+    ASSERT_TRUE(waitFor([&]() { return nFinished == 10; }));
+}